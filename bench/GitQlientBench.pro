@@ -0,0 +1,33 @@
+# Headless benchmark of the loading pipeline: qmake bench/GitQlientBench.pro && make
+CONFIG += warn_on c++17 console
+CONFIG -= app_bundle
+
+greaterThan(QT_MINOR_VERSION, 12) {
+!msvc:QMAKE_CXXFLAGS += -Werror
+}
+
+TARGET = gitqlient-bench
+QT = core
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD
+
+HEADERS += $$PWD/MicroBenchmarks.h
+
+SOURCES += \
+    $$PWD/MicroBenchmarks.cpp \
+    $$PWD/main.cpp
+
+include(../src/git/Git.pri)
+include(../src/cache/Cache.pri)
+include(../QLogger/QLogger.pri)
+
+INCLUDEPATH += ../QLogger
+
+VERSION = 1.1.0
+
+GQ_SHA = $$system(git rev-parse HEAD)
+
+DEFINES += \
+    VER=\\\"$$VERSION\\\" \
+    SHA_VER=\\\"$$GQ_SHA\\\"
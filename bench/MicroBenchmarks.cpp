@@ -0,0 +1,319 @@
+#include "MicroBenchmarks.h"
+
+#include <AGitProcess.h>
+#include <CommitInfo.h>
+#include <RevisionsCache.h>
+#include <lanes.h>
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+namespace
+{
+/*!
+ \brief The minimum time a benchmark repeats its work, so the short ones are measured over many iterations.
+*/
+constexpr qint64 MIN_DURATION_NS = 200 * 1000 * 1000;
+constexpr int DISTINCT_RECORDS = 1000;
+
+QString shaOf(int index)
+{
+   return QString("%1").arg(index + 1, 40, 16, QChar('0'));
+}
+
+/*!
+ \brief Runs the work until MIN_DURATION_NS passes and returns the result for the size given.
+
+ \param prepare Called before every iteration, out of the measure.
+ \param work The work measured.
+*/
+QJsonObject measure(const QString &name, const QString &shape, int items, const std::function<void()> &prepare,
+                    const std::function<void()> &work)
+{
+   QElapsedTimer timer;
+   qint64 elapsedNs = 0;
+   auto iterations = 0;
+
+   do
+   {
+      prepare();
+
+      timer.start();
+      work();
+      elapsedNs += timer.nsecsElapsed();
+
+      ++iterations;
+   } while (elapsedNs < MIN_DURATION_NS);
+
+   const auto nsPerIteration = elapsedNs / iterations;
+
+   return { { "name", name },
+            { "shape", shape },
+            { "items", items },
+            { "iterations", iterations },
+            { "nsPerIteration", nsPerIteration },
+            { "nsPerItem", static_cast<double>(nsPerIteration) / qMax(1, items) } };
+}
+
+/*!
+ \brief The history, newest first, of \p width branches that fork from the same root, are worked on at the same time
+ and are merged by an octopus at the top. Every branch has the same number of commits.
+*/
+QVector<CommitInfo> braid(int commits, int width)
+{
+   QVector<CommitInfo> history;
+   history.reserve(commits + 2);
+
+   const auto rows = commits / width;
+   const auto root = rows * width + 1;
+   const auto shaAt = [width, rows, root](int row, int branch) {
+      return row >= rows ? shaOf(root) : shaOf(1 + row * width + branch);
+   };
+
+   QStringList heads;
+
+   for (auto branch = 0; branch < width; ++branch)
+      heads.append(shaAt(0, branch));
+
+   history.append(CommitInfo(shaOf(0), heads, "Author <author@example.com>", 0, "Merge", QString()));
+
+   for (auto row = 0; row < rows; ++row)
+      for (auto branch = 0; branch < width; ++branch)
+         history.append(CommitInfo(shaAt(row, branch), { shaAt(row + 1, branch) }, "Author <author@example.com>", 0,
+                                   "Commit", QString()));
+
+   history.append(CommitInfo(shaOf(root), {}, "Author <author@example.com>", 0, "Root", QString()));
+
+   return history;
+}
+
+QJsonArray lanesBenchmarks()
+{
+   QJsonArray results;
+
+   for (const auto width : { 1, 8, 64 })
+   {
+      for (const auto commits : { 1000, 10000, 100000 })
+      {
+         const auto history = braid(commits, width);
+         Lanes lanes;
+
+         results.append(measure(
+             "lanes", QString("%1 branches").arg(width), history.count(),
+             [&lanes, &history]() { lanes.init(history.constFirst().id()); },
+             [&lanes, &history]() {
+                for (const auto &commit : history)
+                   lanes.calculateLanes(commit);
+             }));
+      }
+   }
+
+   return results;
+}
+
+/*!
+ \brief A record of git log in GIT_LOG_FORMAT, like the RevisionsBuilder receives it.
+*/
+QByteArray logRecord(int index, int parents, int longLogLines)
+{
+   QByteArray record;
+   record.append(shaOf(index).toLatin1()).append('X');
+
+   for (auto i = 0; i < parents; ++i)
+      record.append(shaOf(index + 1 + i).toLatin1()).append(' ');
+
+   record.append("\nCommitter <committer@example.com>\nAuthor <author@example.com>\n1500000000\nShort log\n");
+
+   for (auto i = 0; i < longLogLines; ++i)
+      record.append("A line of the long log, long enough to look like a real one.\n");
+
+   return "log size " + QByteArray::number(record.size() + 1) + "\n>" + record;
+}
+
+QJsonArray commitParsingBenchmarks()
+{
+   QJsonArray results;
+
+   for (const auto shape : { QPair<int, int>(1, 0), QPair<int, int>(2, 10), QPair<int, int>(30, 1000) })
+   {
+      for (const auto commits : { 1000, 10000, 100000 })
+      {
+         // The records are reused, so the long logs don't take gigabytes with the biggest sizes.
+         QVector<QByteArray> records;
+         records.reserve(DISTINCT_RECORDS);
+
+         for (auto i = 0; i < DISTINCT_RECORDS; ++i)
+            records.append(logRecord(i * (shape.first + 1), shape.first, shape.second));
+
+         const auto name = QString("%1 parents, %2 lines of log").arg(shape.first).arg(shape.second);
+
+         results.append(measure(
+             "commitParsing", name, commits, []() {},
+             [&records, commits]() {
+                for (auto i = 0; i < commits; ++i)
+                   CommitInfo commit(records.at(i % DISTINCT_RECORDS));
+             }));
+      }
+   }
+
+   return results;
+}
+
+/*!
+ \brief The files of a commit as git log --raw lists them. The merges list the files once for every parent.
+*/
+QString rawDiff(int files, int parents)
+{
+   QString diff;
+
+   for (auto parent = 0; parent < parents; ++parent)
+   {
+      if (parent > 0)
+         diff.append(shaOf(parent)).append('\n');
+
+      for (auto i = 0; i < files; ++i)
+         diff.append(QString(":100644 100644 %1 %2 M\tsrc/dir%3/file%4.cpp\n")
+                         .arg(shaOf(i), shaOf(i + 1))
+                         .arg(i / 100)
+                         .arg(i));
+   }
+
+   return diff;
+}
+
+QJsonArray revisionFilesBenchmarks()
+{
+   QJsonArray results;
+
+   for (const auto parents : { 1, 2 })
+   {
+      for (const auto files : { 100, 4000, 40000 })
+      {
+         const auto diff = rawDiff(files, parents);
+         RevisionsCache cache;
+
+         results.append(measure(
+             "revisionFiles", QString("%1 parents").arg(parents), files * parents, []() {},
+             [&cache, &diff]() { cache.parseDiff(diff); }));
+      }
+   }
+
+   return results;
+}
+
+/*!
+ \brief The output of git status --porcelain=v2 -z with changed and untracked files.
+*/
+QByteArray wipStatus(int files, int untrackedFiles)
+{
+   QByteArray status;
+
+   for (auto i = 0; i < files; ++i)
+   {
+      status.append("1 .M N... 100644 100644 100644 " + shaOf(i).toLatin1() + " " + shaOf(i).toLatin1() + " src/dir"
+                    + QByteArray::number(i / 100) + "/file" + QByteArray::number(i) + ".cpp");
+      status.append('\0');
+   }
+
+   for (auto i = 0; i < untrackedFiles; ++i)
+   {
+      status.append("? build/dir" + QByteArray::number(i / 100) + "/object" + QByteArray::number(i) + ".o");
+      status.append('\0');
+   }
+
+   return status;
+}
+
+QJsonArray wipBenchmarks()
+{
+   QJsonArray results;
+
+   for (const auto untrackedRatio : { 0, 10 })
+   {
+      for (const auto files : { 100, 10000, 100000 })
+      {
+         const auto untracked = files * untrackedRatio;
+         const auto status = wipStatus(files, untracked);
+         RevisionsCache cache;
+         cache.setMaxUntrackedFiles(untracked);
+
+         results.append(measure(
+             "wipStatus", QString("%1 untracked files per changed file").arg(untrackedRatio), files + untracked,
+             []() {}, [&cache, &status]() { cache.updateWipCommit(shaOf(0), status); }));
+      }
+   }
+
+   return results;
+}
+
+QJsonArray splitArgListBenchmarks()
+{
+   QJsonArray results;
+
+   for (const auto quoted : { false, true })
+   {
+      for (const auto arguments : { 10, 1000, 100000 })
+      {
+         QString command("git log");
+
+         for (auto i = 0; i < arguments; ++i)
+            command.append(quoted ? QString(" \"--grep=word %1\"").arg(i) : QString(" path/file%1").arg(i));
+
+         results.append(measure(
+             "splitArgList", quoted ? QString("quoted arguments") : QString("plain arguments"), arguments, []() {},
+             [&command]() { AGitProcess::splitArgList(command); }));
+      }
+   }
+
+   return results;
+}
+
+/*!
+ \brief Adds how much the time per item grows from the previous size of the same benchmark and shape.
+*/
+void addGrowth(QJsonArray &results)
+{
+   for (auto i = 1; i < results.count(); ++i)
+   {
+      const auto previous = results.at(i - 1).toObject();
+      auto current = results.at(i).toObject();
+
+      if (previous.value("name") == current.value("name") && previous.value("shape") == current.value("shape")
+          && previous.value("nsPerItem").toDouble() > 0)
+      {
+         current.insert("growth", current.value("nsPerItem").toDouble() / previous.value("nsPerItem").toDouble());
+         results.replace(i, current);
+      }
+   }
+}
+}
+
+QJsonArray runMicroBenchmarks(const QString &filter)
+{
+   const QVector<QPair<QString, std::function<QJsonArray()>>> benchmarks {
+      { "lanes", lanesBenchmarks },
+      { "commitParsing", commitParsingBenchmarks },
+      { "revisionFiles", revisionFilesBenchmarks },
+      { "wipStatus", wipBenchmarks },
+      { "splitArgList", splitArgListBenchmarks },
+   };
+
+   QJsonArray results;
+
+   for (const auto &benchmark : benchmarks)
+   {
+      if (!benchmark.first.contains(filter))
+         continue;
+
+      for (const auto &result : benchmark.second())
+         results.append(result);
+   }
+
+   addGrowth(results);
+
+   return results;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QJsonArray>
+#include <QString>
+
+/*!
+ \brief Runs the micro benchmarks of the primitives of the loading pipeline: the lanes, the parsing of the commits, the
+ files of a commit, the WIP status and the splitting of the commands. Every one runs with inputs of several sizes and
+ reports the time per item, so a cost that grows faster than the input shows as a growth above 1 from one size to the
+ next.
+
+ \param filter Only the benchmarks whose name contains it run. All of them if it's empty.
+ \return One object for every benchmark and size.
+*/
+QJsonArray runMicroBenchmarks(const QString &filter);
@@ -0,0 +1,284 @@
+#include <GitBase.h>
+#include <GitRecorder.h>
+#include <GitRepoLoader.h>
+#include <MicroBenchmarks.h>
+#include <RevisionsCache.h>
+#include <WorkerPool.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#   include <sys/resource.h>
+#endif
+
+namespace
+{
+/*!
+ \brief The memory of the process, in KB. The peak is -1 if the platform doesn't report it.
+*/
+struct Memory
+{
+   qint64 peakKb = -1;
+   qint64 residentKb = -1;
+};
+
+Memory readMemory()
+{
+   Memory memory;
+
+#ifdef Q_OS_LINUX
+   QFile status("/proc/self/status");
+
+   if (status.open(QIODevice::ReadOnly))
+   {
+      for (const auto &line : status.readAll().split('\n'))
+      {
+         const auto fields = line.simplified().split(' ');
+
+         if (fields.count() >= 2 && fields.first() == "VmHWM:")
+            memory.peakKb = fields.at(1).toLongLong();
+         else if (fields.count() >= 2 && fields.first() == "VmRSS:")
+            memory.residentKb = fields.at(1).toLongLong();
+      }
+   }
+#elif defined(Q_OS_UNIX)
+   rusage usage {};
+
+   // macOS reports the maximum resident size in bytes, the rest of systems in KB.
+   if (getrusage(RUSAGE_SELF, &usage) == 0)
+#   ifdef Q_OS_MACOS
+      memory.peakKb = usage.ru_maxrss / 1024;
+#   else
+      memory.peakKb = usage.ru_maxrss;
+#   endif
+#endif
+
+   return memory;
+}
+
+/*!
+ \brief Starts measuring the peak of memory of a phase. Only Linux can reset it: elsewhere the peak is the one of the
+ whole process so far.
+*/
+void resetPeakMemory()
+{
+#ifdef Q_OS_LINUX
+   QFile clearRefs("/proc/self/clear_refs");
+
+   if (clearRefs.open(QIODevice::WriteOnly))
+      clearRefs.write("5");
+#endif
+}
+
+QJsonObject phase(qint64 wallMs, const Memory &memory)
+{
+   return { { "wallMs", wallMs }, { "peakMemoryKb", memory.peakKb }, { "residentMemoryKb", memory.residentKb } };
+}
+
+QJsonObject toJson(const LoadingTimings &timings)
+{
+   return { { "spawnMs", timings.spawnMs },
+            { "firstByteMs", timings.firstByteMs },
+            { "logReadMs", timings.readMs },
+            { "parseMs", timings.parseMs },
+            { "lanesMs", timings.lanesMs },
+            { "referencesMs", timings.referencesMs },
+            { "totalMs", timings.totalMs } };
+}
+
+QJsonObject toJson(const RevisionsCache::MemoryUsage &usage)
+{
+   return { { "commitsKb", usage.commits / 1024 },
+            { "lanesKb", usage.lanes / 1024 },
+            { "revisionFilesKb", usage.revisionFiles / 1024 },
+            { "indexesKb", usage.indexes / 1024 },
+            { "totalKb", usage.total() / 1024 } };
+}
+
+/*!
+ \brief Loads the repository once, from a new cache, and measures every phase.
+*/
+QJsonObject runOnce(const QString &repository, bool diskCache, int timeoutSecs)
+{
+   QJsonObject run;
+
+   const QSharedPointer<GitBase> git(new GitBase(repository));
+   const QSharedPointer<RevisionsCache> cache(new RevisionsCache());
+   const QSharedPointer<GitRepoLoader> loader(new GitRepoLoader(git, cache));
+   loader->setDiskCacheEnabled(diskCache);
+
+   // Like the repository of the current tab, so its work has no quota.
+   WorkerPool::instance().setForegroundRepository(cache.data());
+
+   QElapsedTimer timer;
+
+   resetPeakMemory();
+   timer.start();
+
+   if (!loader->configureRepository())
+   {
+      run.insert("error", QString("%1 is not a Git repository").arg(repository));
+      return run;
+   }
+
+   run.insert("configure", phase(timer.elapsed(), readMemory()));
+
+   // The history is parsed in the WorkerPool: the event loop runs until the loader reports that it finished.
+   LoadingTimings timings;
+   QEventLoop loop;
+   QTimer timeout;
+   timeout.setSingleShot(true);
+
+   QObject::connect(loader.data(), &GitRepoLoader::signalLoadingTimings,
+                    [&timings](const LoadingTimings &loaded) { timings = loaded; });
+   QObject::connect(loader.data(), &GitRepoLoader::signalLoadingFinished, &loop, &QEventLoop::quit);
+   QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+   resetPeakMemory();
+   timer.restart();
+
+   if (!loader->loadRevisions())
+   {
+      run.insert("error", QString("The load of the history didn't start"));
+      return run;
+   }
+
+   timeout.start(timeoutSecs * 1000);
+   loop.exec();
+
+   if (!timeout.isActive())
+   {
+      run.insert("error", QString("The load of the history didn't finish in %1 s").arg(timeoutSecs));
+      return run;
+   }
+
+   timeout.stop();
+
+   auto history = phase(timer.elapsed(), readMemory());
+   history.insert("phases", toJson(timings));
+   history.insert("commits", cache->count() - 1);
+   run.insert("history", history);
+
+   resetPeakMemory();
+   timer.restart();
+
+   loader->updateWipRevision();
+
+   run.insert("wip", phase(timer.elapsed(), readMemory()));
+   run.insert("cacheMemory", toJson(cache->memoryUsage()));
+   run.insert("memoryReport", cache->memoryReport().toJson());
+
+   return run;
+}
+}
+
+int main(int argc, char *argv[])
+{
+   QCoreApplication app(argc, argv);
+   QCoreApplication::setApplicationName("gitqlient-bench");
+   QCoreApplication::setApplicationVersion(VER);
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription("Measures the load of the history of a repository without the UI of GitQlient.");
+   parser.addHelpOption();
+   parser.addVersionOption();
+   parser.addPositionalArgument("repository", "The path of the repository.");
+
+   const QCommandLineOption runsOption("runs", "The number of loads, every one from a new cache.", "runs", "3");
+   const QCommandLineOption diskCacheOption("disk-cache", "Load the history from the cache on disk when possible.");
+   const QCommandLineOption timeoutOption("timeout", "The seconds a load can take.", "seconds", "600");
+   const QCommandLineOption outputOption("output", "The file the JSON report is written to.", "file");
+   const QCommandLineOption microOption("micro", "Run the micro benchmarks of the primitives instead of a load.");
+   const QCommandLineOption filterOption("filter", "Run only the micro benchmarks whose name contains it.", "name");
+   const QCommandLineOption recordOption("record", "Record the git commands and their output in the file.", "file");
+   const QCommandLineOption hashPathsOption("hash-paths", "Write the directories as hashes in the recording.");
+   const QCommandLineOption replayOption("replay", "Answer the git commands from a recording instead of git.", "file");
+   const QCommandLineOption replaySpeedOption("replay-speed", "How much faster than recorded the answers arrive.",
+                                              "factor", "1");
+   parser.addOptions({ runsOption, diskCacheOption, timeoutOption, outputOption, microOption, filterOption,
+                       recordOption, hashPathsOption, replayOption, replaySpeedOption });
+
+   parser.process(app);
+
+   const auto micro = parser.isSet(microOption);
+
+   if (parser.positionalArguments().count() != (micro ? 0 : 1))
+      parser.showHelp(1);
+
+   QJsonObject report { { "version", VER }, { "sha", SHA_VER } };
+   auto failed = false;
+
+   if (micro)
+      report.insert("benchmarks", runMicroBenchmarks(parser.value(filterOption)));
+   else
+   {
+      const auto repository = parser.positionalArguments().constFirst();
+      const auto runs = qMax(1, parser.value(runsOption).toInt());
+      const auto diskCache = parser.isSet(diskCacheOption);
+      const auto timeoutSecs = qMax(1, parser.value(timeoutOption).toInt());
+      auto &recorder = GitRecorder::instance();
+
+      // With a replay the repository doesn't need to exist: its path only replaces the one of the recording.
+      if (parser.isSet(replayOption)
+          && !recorder.startReplay(parser.value(replayOption), parser.value(replaySpeedOption).toDouble()))
+      {
+         QTextStream(stderr) << "Can't replay " << parser.value(replayOption) << "\n";
+         return 1;
+      }
+      else if (parser.isSet(recordOption)
+               && !recorder.startRecording(parser.value(recordOption), parser.isSet(hashPathsOption)))
+      {
+         QTextStream(stderr) << "Can't record in " << parser.value(recordOption) << "\n";
+         return 1;
+      }
+
+      QJsonArray results;
+
+      for (auto i = 0; i < runs && !failed; ++i)
+      {
+         const auto run = runOnce(repository, diskCache, timeoutSecs);
+
+         failed = run.contains("error");
+         results.append(run);
+      }
+
+      report.insert("repository", repository);
+      report.insert("diskCache", diskCache);
+      report.insert("runs", results);
+
+      if (recorder.isActive())
+      {
+         report.insert(recorder.isReplaying() ? "replay" : "record",
+                       QJsonObject { { "file", parser.value(recorder.isReplaying() ? replayOption : recordOption) },
+                                     { "commands", recorder.count() },
+                                     { "misses", recorder.misses() } });
+         recorder.stop();
+      }
+   }
+
+   const auto json = QJsonDocument(report).toJson();
+
+   if (parser.isSet(outputOption))
+   {
+      QFile output(parser.value(outputOption));
+
+      if (!output.open(QIODevice::WriteOnly) || output.write(json) != json.size())
+      {
+         QTextStream(stderr) << "Can't write " << parser.value(outputOption) << "\n";
+         return 1;
+      }
+   }
+   else
+      QTextStream(stdout) << json;
+
+   return failed ? 1 : 0;
+}
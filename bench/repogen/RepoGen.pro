@@ -0,0 +1,13 @@
+# Generator of synthetic repositories for the benchmarks: qmake bench/repogen/RepoGen.pro && make
+CONFIG += warn_on c++17 console
+CONFIG -= app_bundle
+
+greaterThan(QT_MINOR_VERSION, 12) {
+!msvc:QMAKE_CXXFLAGS += -Werror
+}
+
+TARGET = gitqlient-repogen
+QT = core
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += $$PWD/main.cpp
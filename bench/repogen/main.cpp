@@ -0,0 +1,413 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QProcess>
+#include <QTextStream>
+#include <QVector>
+
+namespace
+{
+/*!
+ \brief The shape of the repository generated. Every part is optional and they are generated in this order, on top of
+ the trunk.
+*/
+struct Topology
+{
+   int linearCommits = 0;
+   int filesPerDirectory = 100;
+   int directories = 10;
+   int branches = 0;
+   int branchCommits = 10;
+   int octopusParents = 0;
+   int mergeFiles = 0;
+   int tags = 0;
+   bool annotatedTags = false;
+};
+
+const QMap<QString, Topology> &presets()
+{
+   static const QMap<QString, Topology> presets = []() {
+      QMap<QString, Topology> presets;
+
+      Topology linear;
+      linear.linearCommits = 1000000;
+      presets.insert("linear-1m", linear);
+
+      Topology branches;
+      branches.linearCommits = 20000;
+      branches.branches = 500;
+      branches.branchCommits = 20;
+      presets.insert("branches-500", branches);
+
+      Topology octopus;
+      octopus.linearCommits = 1000;
+      octopus.octopusParents = 30;
+      presets.insert("octopus-30", octopus);
+
+      Topology wideMerge;
+      wideMerge.linearCommits = 1000;
+      wideMerge.mergeFiles = 40000;
+      presets.insert("merge-40k-files", wideMerge);
+
+      Topology tags;
+      tags.linearCommits = 100000;
+      tags.tags = 100000;
+      presets.insert("tags-100k", tags);
+
+      return presets;
+   }();
+
+   return presets;
+}
+
+/*!
+ \brief Writes the commands of git fast-import to the process. The commits get consecutive marks and their dates one
+ minute after the previous one, so the same topology always gives the same SHAs.
+*/
+class FastImportStream
+{
+public:
+   static constexpr int AUTHORS = 50;
+   static constexpr qint64 FIRST_DATE = 1500000000;
+   static constexpr int FLUSH_SIZE = 1024 * 1024;
+
+   explicit FastImportStream(QProcess &process)
+      : mProcess(process)
+   {
+   }
+
+   ~FastImportStream() { flush(); }
+
+   /*!
+    \brief Writes a blob and returns its mark.
+   */
+   int blob(const QByteArray &contents)
+   {
+      const auto mark = ++mLastMark;
+
+      mBuffer.append("blob\nmark :" + QByteArray::number(mark) + "\n");
+      data(contents);
+
+      return mark;
+   }
+
+   /*!
+    \brief Writes a commit and returns its mark.
+
+    \param ref The reference the commit is added to.
+    \param parents The marks of the parents, the first one first. A commit without parents starts the reference.
+    \param files The modifications, as lines of the fast-import format.
+    \param message The message.
+   */
+   int commit(const QByteArray &ref, const QVector<int> &parents, const QByteArray &files, const QByteArray &message)
+   {
+      const auto mark = ++mLastMark;
+      const auto author = mCommits % AUTHORS;
+      const auto identity = QByteArray("Author %1 <author%1@example.com> ").replace("%1", QByteArray::number(author));
+      const auto date = QByteArray::number(FIRST_DATE + mCommits * 60) + " +0000\n";
+
+      ++mCommits;
+
+      mBuffer.append("commit " + ref + "\nmark :" + QByteArray::number(mark) + "\n");
+      mBuffer.append("author " + identity + date);
+      mBuffer.append("committer " + identity + date);
+      data(message);
+
+      for (auto i = 0; i < parents.count(); ++i)
+         mBuffer.append((i == 0 ? "from :" : "merge :") + QByteArray::number(parents.at(i)) + "\n");
+
+      mBuffer.append(files);
+      mBuffer.append("\n");
+
+      flushIfFull();
+
+      return mark;
+   }
+
+   /*!
+    \brief Points a tag to a commit. Annotated tags have their own object and message.
+   */
+   void tag(const QByteArray &name, int commit, bool annotated)
+   {
+      if (annotated)
+      {
+         mBuffer.append("tag " + name + "\nfrom :" + QByteArray::number(commit) + "\n");
+         mBuffer.append("tagger Tagger <tagger@example.com> " + QByteArray::number(FIRST_DATE + mCommits * 60)
+                        + " +0000\n");
+         data("Release " + name + "\n");
+      }
+      else
+         mBuffer.append("reset refs/tags/" + name + "\nfrom :" + QByteArray::number(commit) + "\n\n");
+
+      flushIfFull();
+   }
+
+   int commits() const { return mCommits; }
+
+   void flush()
+   {
+      if (mBuffer.isEmpty())
+         return;
+
+      mProcess.write(mBuffer);
+      mBuffer.clear();
+
+      // The pipe doesn't grow without limit: fast-import reads what was written before more is added.
+      while (mProcess.bytesToWrite() > 0 && mProcess.state() == QProcess::Running)
+         mProcess.waitForBytesWritten(-1);
+   }
+
+private:
+   QProcess &mProcess;
+   QByteArray mBuffer;
+   int mLastMark = 0;
+   int mCommits = 0;
+
+   void data(const QByteArray &contents)
+   {
+      mBuffer.append("data " + QByteArray::number(contents.size()) + "\n" + contents + "\n");
+   }
+
+   void flushIfFull()
+   {
+      if (mBuffer.size() >= FLUSH_SIZE)
+         flush();
+   }
+};
+
+QByteArray inlineFile(const QByteArray &path, const QByteArray &contents)
+{
+   return "M 100644 inline " + path + "\ndata " + QByteArray::number(contents.size()) + "\n" + contents + "\n";
+}
+
+QByteArray trunkFile(const Topology &topology, int commit)
+{
+   const auto file = commit % (topology.filesPerDirectory * topology.directories);
+
+   return "src/dir" + QByteArray::number(file / topology.filesPerDirectory) + "/file"
+       + QByteArray::number(file % topology.filesPerDirectory) + ".txt";
+}
+
+/*!
+ \brief Writes the whole topology. The trunk is master, the branches are under feature/ and the commit a tag points to
+ is spread evenly along the trunk.
+*/
+void generate(FastImportStream &stream, const Topology &topology)
+{
+   const QByteArray master("refs/heads/master");
+   QVector<int> trunk;
+   trunk.reserve(topology.linearCommits + 2);
+
+   // Every commit of the trunk changes one file of the tree, so the tree grows up to all the files and then they
+   // change in turn.
+   for (auto i = 0; i < qMax(1, topology.linearCommits); ++i)
+   {
+      const auto parents = trunk.isEmpty() ? QVector<int>() : QVector<int> { trunk.constLast() };
+      const auto number = QByteArray::number(i);
+
+      trunk.append(stream.commit(master, parents, inlineFile(trunkFile(topology, i), "Revision " + number + "\n"),
+                                 "Trunk commit " + number + "\n"));
+   }
+
+   // The commits of the branches are interleaved, so all of them are open at the same time in the graph.
+   QVector<int> branchTips;
+
+   for (auto branch = 0; branch < topology.branches; ++branch)
+      branchTips.append(trunk.at(static_cast<int>(static_cast<qint64>(trunk.count() - 1) * branch
+                                                  / qMax(1, topology.branches))));
+
+   for (auto commit = 0; commit < topology.branchCommits && topology.branches > 0; ++commit)
+   {
+      for (auto branch = 0; branch < topology.branches; ++branch)
+      {
+         const auto name = "feature/b" + QByteArray::number(branch);
+         const auto path = "features/b" + QByteArray::number(branch) + ".txt";
+
+         branchTips[branch] = stream.commit("refs/heads/" + name, { branchTips.at(branch) },
+                                            inlineFile(path, "Revision " + QByteArray::number(commit) + "\n"),
+                                            "Commit " + QByteArray::number(commit) + " of " + name + "\n");
+      }
+   }
+
+   if (topology.octopusParents > 0)
+   {
+      QVector<int> parents { trunk.constLast() };
+
+      for (auto i = 0; i < topology.octopusParents; ++i)
+      {
+         const auto name = "octopus/o" + QByteArray::number(i);
+
+         const auto file = inlineFile(name + ".txt", name + "\n");
+
+         parents.append(stream.commit("refs/heads/" + name, { trunk.constLast() }, file, "Start " + name + "\n"));
+      }
+
+      trunk.append(stream.commit(master, parents, QByteArray(),
+                                 "Octopus merge of " + QByteArray::number(topology.octopusParents) + " branches\n"));
+   }
+
+   if (topology.mergeFiles > 0)
+   {
+      // The files are added in a branch and the merge brings all of them to master at once.
+      QByteArray files;
+
+      for (auto i = 0; i < topology.mergeFiles; ++i)
+      {
+         const auto mark = stream.blob("Generated file " + QByteArray::number(i) + "\n");
+
+         files.append("M 100644 :" + QByteArray::number(mark) + " generated/dir" + QByteArray::number(i / 1000)
+                      + "/file" + QByteArray::number(i) + ".txt\n");
+      }
+
+      const auto wide = stream.commit("refs/heads/wide", { trunk.constLast() }, files,
+                                      "Add " + QByteArray::number(topology.mergeFiles) + " files\n");
+
+      trunk.append(stream.commit(master, { trunk.constLast(), wide }, files, "Merge the wide branch\n"));
+   }
+
+   for (auto i = 0; i < topology.tags; ++i)
+   {
+      const auto commit = trunk.at(static_cast<int>(static_cast<qint64>(trunk.count() - 1) * i / topology.tags));
+
+      stream.tag("v" + QByteArray::number(i), commit, topology.annotatedTags);
+   }
+
+   stream.flush();
+}
+
+bool runGit(const QString &directory, const QStringList &arguments)
+{
+   QProcess git;
+   git.setWorkingDirectory(directory);
+   git.start("git", arguments);
+
+   return git.waitForFinished(-1) && git.exitStatus() == QProcess::NormalExit && git.exitCode() == 0;
+}
+}
+
+int main(int argc, char *argv[])
+{
+   QCoreApplication app(argc, argv);
+   QCoreApplication::setApplicationName("gitqlient-repogen");
+
+   QTextStream out(stdout);
+   QTextStream err(stderr);
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription(
+       "Generates a synthetic repository with git fast-import. The same parameters always give the same commits.");
+   parser.addHelpOption();
+   parser.addPositionalArgument("directory", "The directory of the new repository. It must not exist.");
+
+   const QCommandLineOption presetOption(
+       "preset", QString("A predefined topology: %1.").arg(presets().keys().join(", ")), "name");
+   const QCommandLineOption linearOption("linear", "The number of commits of master.", "commits");
+   const QCommandLineOption directoriesOption("directories", "The number of directories of the tree.", "count");
+   const QCommandLineOption filesOption("files", "The number of files of every directory of the tree.", "count");
+   const QCommandLineOption branchesOption("branches", "The number of branches open at the same time.", "count");
+   const QCommandLineOption branchCommitsOption("branch-commits", "The number of commits of every branch.", "commits");
+   const QCommandLineOption octopusOption("octopus", "The number of branches merged by an octopus merge.", "count");
+   const QCommandLineOption mergeFilesOption("merge-files", "The number of files added by a merge commit.", "count");
+   const QCommandLineOption tagsOption("tags", "The number of tags.", "count");
+   const QCommandLineOption annotatedOption("annotated-tags", "Create annotated tags instead of lightweight ones.");
+   const QCommandLineOption noCheckoutOption("no-checkout", "Don't check out master after the import.");
+   parser.addOptions({ presetOption, linearOption, directoriesOption, filesOption, branchesOption, branchCommitsOption,
+                       octopusOption, mergeFilesOption, tagsOption, annotatedOption, noCheckoutOption });
+
+   parser.process(app);
+
+   if (parser.positionalArguments().count() != 1)
+      parser.showHelp(1);
+
+   Topology topology;
+
+   if (parser.isSet(presetOption))
+   {
+      if (!presets().contains(parser.value(presetOption)))
+      {
+         err << "Unknown preset " << parser.value(presetOption) << "\n";
+         return 1;
+      }
+
+      topology = presets().value(parser.value(presetOption));
+   }
+
+   // The options given change the preset.
+   const auto setIfGiven = [&parser](const QCommandLineOption &option, int &value) {
+      if (parser.isSet(option))
+         value = qMax(0, parser.value(option).toInt());
+   };
+
+   setIfGiven(linearOption, topology.linearCommits);
+   setIfGiven(directoriesOption, topology.directories);
+   setIfGiven(filesOption, topology.filesPerDirectory);
+   setIfGiven(branchesOption, topology.branches);
+   setIfGiven(branchCommitsOption, topology.branchCommits);
+   setIfGiven(octopusOption, topology.octopusParents);
+   setIfGiven(mergeFilesOption, topology.mergeFiles);
+   setIfGiven(tagsOption, topology.tags);
+   topology.annotatedTags = topology.annotatedTags || parser.isSet(annotatedOption);
+   topology.directories = qMax(1, topology.directories);
+   topology.filesPerDirectory = qMax(1, topology.filesPerDirectory);
+
+   const auto directory = QDir(parser.positionalArguments().constFirst()).absolutePath();
+
+   if (QDir(directory).exists())
+   {
+      err << directory << " already exists\n";
+      return 1;
+   }
+
+   if (!QDir().mkpath(directory) || !runGit(directory, { "init", "-q" })
+       || !runGit(directory, { "symbolic-ref", "HEAD", "refs/heads/master" }))
+   {
+      err << "Can't create the repository in " << directory << "\n";
+      return 1;
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+
+   QProcess fastImport;
+   fastImport.setWorkingDirectory(directory);
+   fastImport.setProcessChannelMode(QProcess::ForwardedChannels);
+   fastImport.start("git", { "fast-import", "--quiet" });
+
+   if (!fastImport.waitForStarted(-1))
+   {
+      err << "Can't start git fast-import\n";
+      return 1;
+   }
+
+   auto commits = 0;
+
+   {
+      FastImportStream stream(fastImport);
+      generate(stream, topology);
+      commits = stream.commits();
+   }
+
+   fastImport.closeWriteChannel();
+
+   if (!fastImport.waitForFinished(-1) || fastImport.exitStatus() != QProcess::NormalExit
+       || fastImport.exitCode() != 0)
+   {
+      err << "git fast-import failed\n";
+      return 1;
+   }
+
+   const auto importMs = timer.elapsed();
+
+   if (!parser.isSet(noCheckoutOption) && !runGit(directory, { "reset", "-q", "--hard", "master" }))
+   {
+      err << "Can't check out master\n";
+      return 1;
+   }
+
+   out << "Generated " << commits << " commits and " << topology.tags << " tags in " << directory << " ("
+       << importMs << " ms to import, " << timer.elapsed() << " ms in total)\n";
+
+   return 0;
+}
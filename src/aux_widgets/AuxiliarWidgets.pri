@@ -11,15 +11,19 @@ HEADERS += \
     $$PWD/ClickableFrame.h \
     $$PWD/ConflictButton.h \
     $$PWD/CreateRepoDlg.h \
+    $$PWD/GitCommandStatsDlg.h \
     $$PWD/ProgressDlg.h \
     $$PWD/PullDlg.h \
-    $$PWD/RepoConfigDlg.h
+    $$PWD/RepoConfigDlg.h \
+    $$PWD/RepositoriesSearchDlg.h
 
 SOURCES += \
     $$PWD/BranchDlg.cpp \
     $$PWD/ClickableFrame.cpp \
     $$PWD/ConflictButton.cpp \
     $$PWD/CreateRepoDlg.cpp \
+    $$PWD/GitCommandStatsDlg.cpp \
     $$PWD/ProgressDlg.cpp \
     $$PWD/PullDlg.cpp \
-    $$PWD/RepoConfigDlg.cpp
+    $$PWD/RepoConfigDlg.cpp \
+    $$PWD/RepositoriesSearchDlg.cpp
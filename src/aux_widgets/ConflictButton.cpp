@@ -20,6 +20,7 @@ ConflictButton::ConflictButton(const QString &filename, bool inConflict, const Q
    , mEdit(new QPushButton())
    , mResolve(new QPushButton())
    , mUpdate(new QPushButton())
+   , mNextConflict(new QPushButton())
 {
    mFile->setCheckable(true);
    mFile->setChecked(inConflict);
@@ -30,11 +31,16 @@ ConflictButton::ConflictButton(const QString &filename, bool inConflict, const Q
    mResolve->setFixedSize(30, 30);
    mUpdate->setIcon(QIcon(":/icons/refresh"));
    mUpdate->setFixedSize(30, 30);
+   mNextConflict->setIcon(QIcon(":/icons/go_down"));
+   mNextConflict->setFixedSize(30, 30);
+   mNextConflict->setToolTip(tr("Go to the next conflict"));
+   mNextConflict->setVisible(false);
 
    const auto layout = new QHBoxLayout(this);
    layout->setSpacing(0);
    layout->setContentsMargins(QMargins());
    layout->addWidget(mFile);
+   layout->addWidget(mNextConflict);
    layout->addWidget(mEdit);
    layout->addWidget(mUpdate);
    layout->addWidget(mResolve);
@@ -46,6 +52,7 @@ ConflictButton::ConflictButton(const QString &filename, bool inConflict, const Q
    connect(mEdit, &QPushButton::clicked, this, &ConflictButton::openFileEditor);
    connect(mResolve, &QPushButton::clicked, this, &ConflictButton::resolveConflict);
    connect(mUpdate, &QPushButton::clicked, this, [this]() { emit updateRequested(); });
+   connect(mNextConflict, &QPushButton::clicked, this, &ConflictButton::goToNextConflict);
 }
 
 void ConflictButton::setChecked(bool checked)
@@ -53,10 +60,38 @@ void ConflictButton::setChecked(bool checked)
    mFile->setChecked(checked);
 }
 
+void ConflictButton::setConflicts(const QVector<ConflictIndex::Region> &regions)
+{
+   mConflicts = regions;
+   mCurrentConflict = -1;
+
+   QStringList lines;
+
+   for (const auto &region : regions)
+      lines.append(tr("Lines %1-%2").arg(region.start).arg(region.end));
+
+   mFile->setText(regions.isEmpty() ? mFileName : tr("%1 (%2)").arg(mFileName).arg(regions.count()));
+   mFile->setToolTip(lines.join('\n'));
+   mNextConflict->setVisible(mResolve->isVisible() && !regions.isEmpty());
+}
+
 void ConflictButton::setInConflict(bool inConflict)
 {
    mUpdate->setVisible(inConflict);
    mResolve->setVisible(inConflict);
+   mNextConflict->setVisible(inConflict && !mConflicts.isEmpty());
+}
+
+void ConflictButton::goToNextConflict()
+{
+   if (mConflicts.isEmpty())
+      return;
+
+   mCurrentConflict = (mCurrentConflict + 1) % mConflicts.count();
+
+   mFile->setChecked(true);
+
+   emit conflictRequested(mCurrentConflict, mConflicts.at(mCurrentConflict));
 }
 
 void ConflictButton::resolveConflict()
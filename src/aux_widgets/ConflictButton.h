@@ -23,6 +23,8 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ConflictIndex.h>
+
 #include <QFrame>
 
 class GitBase;
@@ -57,6 +59,13 @@ signals:
     *
     */
    void updateRequested();
+   /**
+    * @brief Signal triggered when the user goes to the next conflict of the file.
+    *
+    * @param conflict The index of the conflict region.
+    * @param region The lines of the region.
+    */
+   void conflictRequested(int conflict, const ConflictIndex::Region &region);
 
    /**
     * @brief signalEditFile Signal triggered when the user wants to edit a file and is running GitQlient from QtCreator.
@@ -84,6 +93,16 @@ public:
     * @param checked The new check state.
     */
    void setChecked(bool checked);
+   /**
+    * @brief Returns the file name of the button.
+    */
+   QString fileName() const { return mFileName; }
+   /**
+    * @brief Shows the conflicts found in the file. The navigation starts again from the first one.
+    *
+    * @param regions The conflict regions.
+    */
+   void setConflicts(const QVector<ConflictIndex::Region> &regions);
 
 private:
    QSharedPointer<GitBase> mGit;
@@ -92,6 +111,9 @@ private:
    QPushButton *mEdit = nullptr;
    QPushButton *mResolve = nullptr;
    QPushButton *mUpdate = nullptr;
+   QPushButton *mNextConflict = nullptr;
+   QVector<ConflictIndex::Region> mConflicts;
+   int mCurrentConflict = -1;
 
    /**
     * @brief Sets the button and the file as merge conflict.
@@ -104,6 +126,11 @@ private:
     *
     */
    void resolveConflict();
+   /**
+    * @brief Goes to the conflict after the current one, back to the first after the last one.
+    *
+    */
+   void goToNextConflict();
 
    /**
     * @brief openFileEditor Opens the external file editor.
@@ -23,7 +23,10 @@ CreateRepoDlg::CreateRepoDlg(CreateRepoDlgType type, QSharedPointer<GitConfig> g
    ui->setupUi(this);
 
    if (mType == CreateRepoDlgType::INIT)
+   {
       ui->leURL->setHidden(true);
+      ui->gbCloneOptions->setHidden(true);
+   }
 
    const auto operation = mType == CreateRepoDlgType::INIT ? QString("init") : QString("clone");
    const auto checkText = ui->chbOpen->text().arg(operation);
@@ -116,7 +119,14 @@ void CreateRepoDlg::accept()
             if (!dir.exists())
                dir.mkpath(fullPath);
 
-            ret = mGit->clone(url, fullPath);
+            GitCloneOptions options;
+            options.blobless = ui->chbBlobless->isChecked();
+            options.depth = ui->sbDepth->value();
+            options.shallowSince = ui->leShallowSince->text().trimmed();
+            options.singleBranch = ui->chbSingleBranch->isChecked();
+            options.branch = ui->leBranch->text().trimmed();
+
+            ret = mGit->clone(url, fullPath, options);
          }
          else
          {
@@ -0,0 +1,146 @@
+#include "GitCommandStatsDlg.h"
+
+#include <GitCommandStats.h>
+#include <GitQlientStyles.h>
+
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+namespace
+{
+enum Column
+{
+   Command,
+   Runs,
+   Failures,
+   MeanMs,
+   MaxMs,
+   MeanSpawnMs,
+   MeanFirstByteMs,
+   OutputKb,
+   Histogram,
+   Count
+};
+
+QTableWidgetItem *numberItem(qint64 value)
+{
+   const auto item = new QTableWidgetItem();
+   item->setData(Qt::DisplayRole, value);
+   item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+
+   return item;
+}
+}
+
+GitCommandStatsDlg::GitCommandStatsDlg(QWidget *parent)
+   : QDialog(parent)
+   , mTable(new QTableWidget(0, Column::Count))
+{
+   setWindowTitle(tr("Git commands"));
+   setStyleSheet(GitQlientStyles::getStyles());
+   resize(1000, 500);
+
+   mTable->setHorizontalHeaderLabels({ tr("Command"), tr("Runs"), tr("Failures"), tr("Mean (ms)"), tr("Max (ms)"),
+                                       tr("Mean spawn (ms)"), tr("Mean first byte (ms)"), tr("Output (KB)"),
+                                       tr("Wall time histogram") });
+   mTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+   mTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+   mTable->verticalHeader()->hide();
+   mTable->horizontalHeader()->setSectionResizeMode(Column::Command, QHeaderView::ResizeToContents);
+   mTable->horizontalHeader()->setStretchLastSection(true);
+
+   const auto refreshBtn = new QPushButton(tr("Refresh"));
+   connect(refreshBtn, &QPushButton::clicked, this, &GitCommandStatsDlg::refresh);
+
+   const auto clearBtn = new QPushButton(tr("Clear"));
+   connect(clearBtn, &QPushButton::clicked, this, [this]() {
+      GitCommandStats::instance().clear();
+      refresh();
+   });
+
+   const auto csvBtn = new QPushButton(tr("Export CSV"));
+   connect(csvBtn, &QPushButton::clicked, this, [this]() { exportStats(false); });
+
+   const auto jsonBtn = new QPushButton(tr("Export JSON"));
+   connect(jsonBtn, &QPushButton::clicked, this, [this]() { exportStats(true); });
+
+   const auto closeBtn = new QPushButton(tr("Close"));
+   connect(closeBtn, &QPushButton::clicked, this, &GitCommandStatsDlg::close);
+
+   const auto buttonsLayout = new QHBoxLayout();
+   buttonsLayout->setContentsMargins(QMargins());
+   buttonsLayout->setSpacing(10);
+   buttonsLayout->addWidget(refreshBtn);
+   buttonsLayout->addWidget(clearBtn);
+   buttonsLayout->addStretch();
+   buttonsLayout->addWidget(csvBtn);
+   buttonsLayout->addWidget(jsonBtn);
+   buttonsLayout->addWidget(closeBtn);
+
+   const auto layout = new QVBoxLayout(this);
+   layout->setContentsMargins(10, 10, 10, 10);
+   layout->setSpacing(10);
+   layout->addWidget(mTable);
+   layout->addLayout(buttonsLayout);
+
+   refresh();
+}
+
+void GitCommandStatsDlg::refresh()
+{
+   const auto entries = GitCommandStats::instance().entries();
+
+   mTable->setSortingEnabled(false);
+   mTable->setRowCount(entries.count());
+
+   auto row = 0;
+
+   for (const auto &entry : entries)
+   {
+      QStringList histogram;
+
+      for (auto i = 0; i < GitCommandStats::HISTOGRAM_BUCKETS; ++i)
+      {
+         if (entry.histogram.at(i) > 0)
+            histogram.append(QString("%1: %2").arg(GitCommandStats::bucketLabel(i)).arg(entry.histogram.at(i)));
+      }
+
+      const auto firstByteMean = entry.firstByteCount > 0 ? entry.totalFirstByteMs / entry.firstByteCount : 0;
+
+      mTable->setItem(row, Column::Command, new QTableWidgetItem(entry.command));
+      mTable->setItem(row, Column::Runs, numberItem(entry.count));
+      mTable->setItem(row, Column::Failures, numberItem(entry.failures));
+      mTable->setItem(row, Column::MeanMs, numberItem(entry.totalWallMs / entry.count));
+      mTable->setItem(row, Column::MaxMs, numberItem(entry.maxWallMs));
+      mTable->setItem(row, Column::MeanSpawnMs, numberItem(entry.totalSpawnMs / entry.count));
+      mTable->setItem(row, Column::MeanFirstByteMs, numberItem(firstByteMean));
+      mTable->setItem(row, Column::OutputKb, numberItem(entry.totalOutputBytes / 1024));
+      mTable->setItem(row, Column::Histogram, new QTableWidgetItem(histogram.join(", ")));
+
+      ++row;
+   }
+
+   mTable->setSortingEnabled(true);
+}
+
+void GitCommandStatsDlg::exportStats(bool json)
+{
+   const auto fileName = QFileDialog::getSaveFileName(this, tr("Export the statistics"), QString(),
+                                                      json ? tr("JSON (*.json)") : tr("CSV (*.csv)"));
+
+   if (fileName.isEmpty())
+      return;
+
+   QFile file(fileName);
+
+   if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+       || file.write(json ? GitCommandStats::instance().toJson() : GitCommandStats::instance().toCsv().toUtf8())
+           == -1)
+      QMessageBox::warning(this, tr("Export failed"), tr("The statistics couldn't be written to %1.").arg(fileName));
+}
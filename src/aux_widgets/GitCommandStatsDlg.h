@@ -1,5 +1,7 @@
 #pragma once
 
+#pragma once
+
 /****************************************************************************************
  ** GitQlient is an application to manage and operate one or several Git repositories. With
  ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
@@ -23,29 +25,31 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QFrame>
-#include <QIcon>
+#include <QDialog>
+
+class QTableWidget;
 
-class QPushButton;
-class QLabel;
+/*!
+ \brief The GitCommandStatsDlg shows the statistics of the git commands run by GitQlient (see GitCommandStats) and
+ exports them as CSV or JSON.
 
-class FileWidget : public QFrame
+ \class GitCommandStatsDlg GitCommandStatsDlg.h "GitCommandStatsDlg.h"
+*/
+class GitCommandStatsDlg : public QDialog
 {
    Q_OBJECT
 
-signals:
-   void clicked();
-
 public:
-   explicit FileWidget(const QIcon &icon, const QString &text, QWidget *parent = nullptr);
-   explicit FileWidget(const QString &icon, const QString &text, QWidget *parent = nullptr);
-   QString text() const;
-   void setText(const QString &text);
-   QSize sizeHint() const override;
-   void setTextColor(const QColor &color) const;
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit GitCommandStatsDlg(QWidget *parent = nullptr);
 
 private:
-   QIcon mIcon;
-   QPushButton *mButton = nullptr;
-   QLabel *mText = nullptr;
+   QTableWidget *mTable = nullptr;
+
+   void refresh();
+   void exportStats(bool json);
 };
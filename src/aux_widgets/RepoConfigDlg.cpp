@@ -1,13 +1,21 @@
 #include "RepoConfigDlg.h"
 #include "ui_RepoConfigDlg.h"
 
+#include <GitBase.h>
 #include <GitConfig.h>
+#include <GitQlientSettings.h>
 #include <GitQlientStyles.h>
 
+#include <QCheckBox>
+#include <QComboBox>
+#include <QHash>
 #include <QLabel>
 #include <QLineEdit>
+#include <QSpinBox>
 #include <QStyle>
 
+#include <limits>
+
 RepoConfigDlg::RepoConfigDlg(const QSharedPointer<GitBase> &git, QWidget *parent)
    : QDialog(parent)
    , ui(new Ui::RepoConfigDlg)
@@ -46,10 +54,14 @@ RepoConfigDlg::RepoConfigDlg(const QSharedPointer<GitBase> &git, QWidget *parent
       addUserConfig(elements, layout);
    }
 
+   const auto performanceTab = createPerformanceConfig();
+   ui->tabWidget->addTab(performanceTab, tr("Performance"));
+
    QString color = GitQlientStyles::getTabColor().name();
 
    ui->tab->setStyleSheet(QString("background-color: %1;").arg(color));
    ui->tab_2->setStyleSheet(QString("background-color: %1;").arg(color));
+   performanceTab->setStyleSheet(QString("background-color: %1;").arg(color));
 
    style()->unpolish(this);
    setStyleSheet(GitQlientStyles::getStyles());
@@ -85,6 +97,87 @@ void RepoConfigDlg::addUserConfig(const QStringList &elements, QGridLayout *layo
    layout->addItem(new QSpacerItem(1, 1, QSizePolicy::Fixed, QSizePolicy::Expanding), row, 0);
 }
 
+QWidget *RepoConfigDlg::createPerformanceConfig()
+{
+   const auto workingDir = mGit->getWorkingDir();
+   const auto tab = new QWidget();
+   const auto layout = new QGridLayout(tab);
+   layout->setContentsMargins(10, 10, 10, 10);
+   layout->setSpacing(10);
+
+   GitQlientSettings settings;
+
+   const auto profile = new QCheckBox(tr("Use the profile for large repositories"));
+   profile->setChecked(settings.repositoryValue(workingDir, GitQlientSettings::LargeRepositoryKey, false).toBool());
+   connect(profile, &QCheckBox::toggled, this, [workingDir](bool checked) {
+      GitQlientSettings().setRepositoryValue(workingDir, GitQlientSettings::LargeRepositoryKey, checked);
+   });
+   layout->addWidget(profile, 0, 0, 1, 2);
+
+   const QHash<QString, QString> labels {
+      { GitQlientSettings::HistoryPageSizeKey, tr("Commits of every page of the history") },
+      { GitQlientSettings::CommitGraphLoadingKey, tr("Load the history from the commit-graph") },
+      { GitQlientSettings::LazyCommitDetailsKey, tr("Read the details of the commits when they are shown") },
+      { "graphMaxLanes", tr("Maximum lanes of the graph") },
+      { GitQlientSettings::MaxUntrackedFilesKey, tr("Maximum untracked files") },
+      { GitQlientSettings::CollapseUntrackedDirsKey, tr("List the untracked directories instead of their files") },
+      { GitQlientSettings::PollingFactorKey, tr("Factor of the auto-fetch and auto-update intervals") },
+   };
+
+   // Every setting takes the value of the profile, or of the application, until the repository has its own.
+   auto row = 1;
+
+   for (const auto &key : GitQlientSettings::largeRepositoryKeys())
+   {
+      layout->addWidget(new QLabel(labels.value(key, key)), row, 0);
+
+      if (GitQlientSettings::largeRepositoryValue(key).type() == QVariant::Bool)
+      {
+         const auto comboBox = new QComboBox();
+         comboBox->addItems({ tr("Default"), tr("Enabled"), tr("Disabled") });
+
+         if (settings.hasRepositoryValue(workingDir, key))
+            comboBox->setCurrentIndex(settings.repositoryValue(workingDir, key).toBool() ? 1 : 2);
+
+         connect(comboBox, qOverload<int>(&QComboBox::currentIndexChanged), this, [workingDir, key](int index) {
+            GitQlientSettings settings;
+
+            if (index == 0)
+               settings.removeRepositoryValue(workingDir, key);
+            else
+               settings.setRepositoryValue(workingDir, key, index == 1);
+         });
+
+         layout->addWidget(comboBox, row++, 1);
+      }
+      else
+      {
+         const auto spinBox = new QSpinBox();
+         spinBox->setRange(-1, std::numeric_limits<int>::max());
+         spinBox->setSpecialValueText(tr("Default"));
+         spinBox->setValue(settings.hasRepositoryValue(workingDir, key)
+                               ? settings.repositoryValue(workingDir, key).toInt()
+                               : -1);
+
+         connect(spinBox, qOverload<int>(&QSpinBox::valueChanged), this, [workingDir, key](int value) {
+            GitQlientSettings settings;
+
+            if (value < 0)
+               settings.removeRepositoryValue(workingDir, key);
+            else
+               settings.setRepositoryValue(workingDir, key, value);
+         });
+
+         layout->addWidget(spinBox, row++, 1);
+      }
+   }
+
+   layout->addWidget(new QLabel(tr("The changes are applied the next time the repository is opened.")), row++, 0, 1, 2);
+   layout->addItem(new QSpacerItem(1, 1, QSizePolicy::Fixed, QSizePolicy::Expanding), row, 0);
+
+   return tab;
+}
+
 void RepoConfigDlg::setConfig()
 {
    const auto lineEdit = qobject_cast<QLineEdit *>(sender());
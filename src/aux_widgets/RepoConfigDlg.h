@@ -27,6 +27,7 @@ private:
    QMap<QLineEdit *, QString> mLineeditKeyMap;
 
    void addUserConfig(const QStringList &elements, QGridLayout *layout);
+   QWidget *createPerformanceConfig();
    void setConfig();
 };
 
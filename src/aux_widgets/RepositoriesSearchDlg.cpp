@@ -0,0 +1,136 @@
+#include "RepositoriesSearchDlg.h"
+
+#include <DateFormatter.h>
+#include <GitQlientStyles.h>
+
+#include <QDir>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace
+{
+enum Column
+{
+   Repository,
+   Match,
+   Commit,
+   Date,
+   Count
+};
+
+QString typeName(RepositoriesSearch::MatchType type)
+{
+   switch (type)
+   {
+      case RepositoriesSearch::MatchType::Sha:
+         return QObject::tr("SHA");
+      case RepositoriesSearch::MatchType::Reference:
+         return QObject::tr("Reference");
+      case RepositoriesSearch::MatchType::ShortLog:
+         break;
+   }
+
+   return QObject::tr("Message");
+}
+}
+
+RepositoriesSearchDlg::RepositoriesSearchDlg(const QVector<RepositoriesSearch::Source> &sources, QWidget *parent)
+   : QDialog(parent)
+   , mSources(sources)
+   , mSearch(new RepositoriesSearch(this))
+   , mText(new QLineEdit())
+   , mTable(new QTableWidget(0, Column::Count))
+   , mStatus(new QLabel())
+   , mDelay(new QTimer(this))
+{
+   setWindowTitle(tr("Search in all the repositories"));
+   setStyleSheet(GitQlientStyles::getStyles());
+   resize(900, 500);
+
+   mText->setPlaceholderText(tr("SHA, branch, tag or message"));
+
+   mTable->setHorizontalHeaderLabels({ tr("Repository"), tr("Match"), tr("Commit"), tr("Date") });
+   mTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+   mTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+   mTable->setSelectionMode(QAbstractItemView::SingleSelection);
+   mTable->verticalHeader()->hide();
+   mTable->horizontalHeader()->setSectionResizeMode(Column::Repository, QHeaderView::ResizeToContents);
+   mTable->horizontalHeader()->setSectionResizeMode(Column::Match, QHeaderView::Stretch);
+   mTable->horizontalHeader()->setSectionResizeMode(Column::Commit, QHeaderView::ResizeToContents);
+   mTable->horizontalHeader()->setSectionResizeMode(Column::Date, QHeaderView::ResizeToContents);
+
+   mStatus->setText(tr("Searching in %1 repositories.").arg(mSources.count()));
+
+   // The search starts when the user stops typing.
+   mDelay->setSingleShot(true);
+   mDelay->setInterval(SEARCH_DELAY_MS);
+
+   connect(mDelay, &QTimer::timeout, this, &RepositoriesSearchDlg::startSearch);
+   connect(mText, &QLineEdit::textChanged, mDelay, qOverload<>(&QTimer::start));
+   connect(mText, &QLineEdit::returnPressed, this, [this]() {
+      if (mTable->rowCount() > 0)
+         goToMatch(std::max(0, mTable->currentRow()));
+   });
+   connect(mSearch, &RepositoriesSearch::signalMatchesFound, this, &RepositoriesSearchDlg::showMatches);
+   connect(mTable, &QTableWidget::cellActivated, this, [this](int row) { goToMatch(row); });
+
+   const auto layout = new QVBoxLayout(this);
+   layout->setContentsMargins(10, 10, 10, 10);
+   layout->setSpacing(10);
+   layout->addWidget(mText);
+   layout->addWidget(mTable);
+   layout->addWidget(mStatus);
+}
+
+void RepositoriesSearchDlg::startSearch()
+{
+   mStatus->setText(tr("Searching..."));
+   mSearch->search(mSources, mText->text());
+}
+
+void RepositoriesSearchDlg::showMatches(const QVector<RepositoriesSearch::Match> &matches, bool finished)
+{
+   mTable->setRowCount(matches.count());
+
+   for (auto row = 0; row < matches.count(); ++row)
+   {
+      const auto &match = matches.at(row);
+      const auto text = match.text.isEmpty() ? typeName(match.type)
+                                             : QString("%1: %2").arg(typeName(match.type), match.text);
+      const auto repositoryItem = new QTableWidgetItem(QDir(match.repository).dirName());
+      repositoryItem->setToolTip(match.repository);
+
+      mTable->setItem(row, Column::Repository, repositoryItem);
+      mTable->setItem(row, Column::Match, new QTableWidgetItem(text));
+      mTable->setItem(row, Column::Commit, new QTableWidgetItem(match.sha.left(8)));
+      mTable->setItem(row, Column::Date,
+                        new QTableWidgetItem(match.secsSinceEpoch > 0 ? DateFormatter::format(match.secsSinceEpoch)
+                                                                      : QString()));
+   }
+
+   if (finished)
+      mStatus->setText(tr("%1 matches in %2 repositories.").arg(matches.count()).arg(mSources.count()));
+
+   if (mTable->currentRow() < 0 && !matches.isEmpty())
+      mTable->selectRow(0);
+
+   mMatches = matches;
+}
+
+void RepositoriesSearchDlg::goToMatch(int row)
+{
+   if (row < 0 || row >= mMatches.count())
+      return;
+
+   const auto &match = mMatches.at(row);
+
+   emit signalGoToCommit(match.repository, match.sha);
+
+   accept();
+}
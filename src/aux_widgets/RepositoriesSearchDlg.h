@@ -0,0 +1,77 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RepositoriesSearch.h>
+
+#include <QDialog>
+
+class QLabel;
+class QLineEdit;
+class QTableWidget;
+class QTimer;
+
+/*!
+ \brief The RepositoriesSearchDlg searches a text in all the repositories open, see RepositoriesSearch, and lists the
+ matches while they are found. Activating a match takes the user to its commit in the history of its repository.
+
+ \class RepositoriesSearchDlg RepositoriesSearchDlg.h "RepositoriesSearchDlg.h"
+*/
+class RepositoriesSearchDlg : public QDialog
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the user wants to see the commit of a match.
+
+    \param repository The working directory of the repository.
+    \param sha The SHA of the commit.
+   */
+   void signalGoToCommit(const QString &repository, const QString &sha);
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param sources The repositories to search in, with their history as it was when the dialog was opened.
+    \param parent The parent widget if needed.
+   */
+   explicit RepositoriesSearchDlg(const QVector<RepositoriesSearch::Source> &sources, QWidget *parent = nullptr);
+
+private:
+   static constexpr int SEARCH_DELAY_MS = 250;
+
+   QVector<RepositoriesSearch::Source> mSources;
+   RepositoriesSearch *mSearch = nullptr;
+   QLineEdit *mText = nullptr;
+   QTableWidget *mTable = nullptr;
+   QVector<RepositoriesSearch::Match> mMatches;
+   QLabel *mStatus = nullptr;
+   QTimer *mDelay = nullptr;
+
+   void startSearch();
+   void showMatches(const QVector<RepositoriesSearch::Match> &matches, bool finished);
+   void goToMatch(int row);
+};
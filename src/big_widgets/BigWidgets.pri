@@ -9,7 +9,10 @@ HEADERS += \
     $$PWD/GitQlientSettings.h \
     $$PWD/GitQlientStyles.h \
     $$PWD/HistoryWidget.h \
-    $$PWD/MergeWidget.h
+    $$PWD/MergeWidget.h \
+    $$PWD/PerformanceMetrics.h \
+    $$PWD/RepoLoadScheduler.h \
+    $$PWD/SettingsStore.h
 
 SOURCES += \
     $$PWD/BlameWidget.cpp \
@@ -20,4 +23,7 @@ SOURCES += \
     $$PWD/GitQlientSettings.cpp \
     $$PWD/GitQlientStyles.cpp \
     $$PWD/HistoryWidget.cpp \
-    $$PWD/MergeWidget.cpp
+    $$PWD/MergeWidget.cpp \
+    $$PWD/PerformanceMetrics.cpp \
+    $$PWD/RepoLoadScheduler.cpp \
+    $$PWD/SettingsStore.cpp
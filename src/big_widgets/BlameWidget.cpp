@@ -2,14 +2,20 @@
 
 #include <GitHistory.h>
 #include <FileBlameWidget.h>
+#include <FileBlameLoader.h>
+#include <BlameCache.h>
 #include <BranchesViewDelegate.h>
 #include <RepositoryViewDelegate.h>
 #include <CommitHistoryModel.h>
 #include <CommitHistoryView.h>
 #include <CommitHistoryColumns.h>
 #include <CommitInfo.h>
+#include <PathHistoryIndex.h>
+#include <BlameFileTreeModel.h>
+#include <GitBase.h>
+
+#include <QLogger.h>
 
-#include <QFileSystemModel>
 #include <QTreeView>
 #include <QGridLayout>
 #include <QHeaderView>
@@ -17,18 +23,25 @@
 #include <QApplication>
 #include <QClipboard>
 #include <QTabWidget>
+#include <QDir>
+
+using namespace QLogger;
 
 BlameWidget::BlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                          QWidget *parent)
    : QFrame(parent)
    , mCache(cache)
    , mGit(git)
-   , fileSystemModel(new QFileSystemModel())
+   , mPathIndex(new PathHistoryIndex(mCache, this))
+   , fileTreeModel(new BlameFileTreeModel(mCache, mGit, mPathIndex))
    , mRepoModel(new CommitHistoryModel(mCache, mGit))
    , mRepoView(new CommitHistoryView(mCache, mGit))
    , fileSystemView(new QTreeView())
    , mTabWidget(new QTabWidget())
+   , mPrefetchLoader(new FileBlameLoader(mGit, this))
 {
+   connect(mPrefetchLoader, &FileBlameLoader::signalLoaded, this, &BlameWidget::prefetchNextBlame);
+
    mTabWidget->setObjectName("HistoryTab");
    mRepoView->setObjectName("blameGraphView");
    mRepoView->setModel(mRepoModel);
@@ -47,13 +60,8 @@ BlameWidget::BlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSha
    connect(mRepoView, &CommitHistoryView::clicked, this, &BlameWidget::reloadBlame);
    connect(mRepoView, &CommitHistoryView::doubleClicked, this, &BlameWidget::openDiff);
 
-   fileSystemModel->setFilter(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot);
-
-   fileSystemView->setModel(fileSystemModel);
+   fileSystemView->setModel(fileTreeModel);
    fileSystemView->setMaximumWidth(450);
-   fileSystemView->header()->setSectionHidden(1, true);
-   fileSystemView->header()->setSectionHidden(2, true);
-   fileSystemView->header()->setSectionHidden(3, true);
    fileSystemView->setContextMenuPolicy(Qt::CustomContextMenu);
    connect(fileSystemView, &QTreeView::clicked, this, &BlameWidget::showFileHistoryByIndex);
 
@@ -90,35 +98,34 @@ BlameWidget::~BlameWidget()
 {
    delete mRepoModel;
    delete mItemDelegate;
-   delete fileSystemModel;
+   delete fileTreeModel;
 }
 
 void BlameWidget::init(const QString &workingDirectory)
 {
    mWorkingDirectory = workingDirectory;
-   fileSystemModel->setRootPath(workingDirectory);
-   fileSystemView->setRootIndex(fileSystemModel->index(workingDirectory));
+   fileTreeModel->init(workingDirectory);
 }
 
 void BlameWidget::showFileHistory(const QString &filePath)
 {
    if (!mTabsMap.contains(filePath))
    {
-      QScopedPointer<GitHistory> git(new GitHistory(mGit));
-      const auto ret = git->history(filePath);
+      const auto shaHistory = getFileHistory(filePath);
 
-      if (ret.success)
+      if (!shaHistory.isEmpty())
       {
-         const auto shaHistory = ret.output.toString().split("\n", QString::SkipEmptyParts);
          mRepoView->blockSignals(true);
          mRepoView->filterBySha(shaHistory);
          mRepoView->blockSignals(false);
 
          const auto previousSha = shaHistory.count() > 1 ? shaHistory.at(1) : QString(tr("No info"));
-         const auto fileBlameWidget = new FileBlameWidget(mCache, mGit);
+         const auto fileBlameWidget = new FileBlameWidget(mGit);
 
          fileBlameWidget->setup(filePath, shaHistory.constFirst(), previousSha);
          connect(fileBlameWidget, &FileBlameWidget::signalCommitSelected, mRepoView, &CommitHistoryView::focusOnCommit);
+         connect(fileBlameWidget, &FileBlameWidget::signalBlameLoaded, this,
+                 [this, fileBlameWidget]() { prefetchNeighbourBlames(fileBlameWidget); });
 
          const auto index = mTabWidget->addTab(fileBlameWidget, filePath.split("/").last());
          mTabWidget->setTabsClosable(true);
@@ -137,6 +144,14 @@ void BlameWidget::showFileHistory(const QString &filePath)
 void BlameWidget::onNewRevisions(int totalCommits)
 {
    mRepoModel->onNewRevisions(totalCommits);
+
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+   git->loadPathHistoryIndex(mPathIndex);
+}
+
+void BlameWidget::onRevisionsChunkLoaded(int totalCommits)
+{
+   mRepoModel->onRevisionsChunkLoaded(totalCommits);
 }
 
 void BlameWidget::reloadBlame(const QModelIndex &index)
@@ -146,6 +161,8 @@ void BlameWidget::reloadBlame(const QModelIndex &index)
 
    if (blameWidget)
    {
+      cancelPrefetch();
+
       const auto sha
           = mRepoView->model()->index(index.row(), static_cast<int>(CommitHistoryColumns::SHA)).data().toString();
       const auto previousSha
@@ -164,27 +181,20 @@ void BlameWidget::reloadHistory(int tabIndex)
       const auto sha = blameWidget->getCurrentSha();
       const auto file = blameWidget->getCurrentFile();
 
-      QScopedPointer<GitHistory> git(new GitHistory(mGit));
-      const auto ret = git->history(file);
+      const auto shaHistory = getFileHistory(file);
 
-      if (ret.success)
+      if (!shaHistory.isEmpty())
       {
-         const auto shaHistory = ret.output.toString().split("\n", QString::SkipEmptyParts);
          mRepoView->blockSignals(true);
          mRepoView->filterBySha(shaHistory);
 
-         const auto repoModel = mRepoView->model();
-         const auto totalRows = repoModel->rowCount();
-         for (auto i = 0; i < totalRows; ++i)
+         // The row of the revision comes from the index of the cache instead of looking for it in the filtered rows.
+         if (const auto row = mRepoModel->rowFromSource(mCache->getCommitPos(sha)); row != -1)
          {
-            const auto index = mRepoView->model()->index(i, static_cast<int>(CommitHistoryColumns::SHA));
-
-            if (index.data().toString().startsWith(sha))
-            {
-               mRepoView->setCurrentIndex(index);
-               mRepoView->selectionModel()->select(index,
-                                                   QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
-            }
+            const auto index = mRepoModel->index(row, static_cast<int>(CommitHistoryColumns::SHA));
+
+            mRepoView->setCurrentIndex(index);
+            mRepoView->selectionModel()->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
          }
 
          mRepoView->blockSignals(false);
@@ -192,12 +202,99 @@ void BlameWidget::reloadHistory(int tabIndex)
    }
 }
 
+void BlameWidget::prefetchNeighbourBlames(FileBlameWidget *blameWidget)
+{
+   if (blameWidget != mTabWidget->currentWidget())
+      return;
+
+   cancelPrefetch();
+
+   const auto sha = blameWidget->getCurrentSha();
+   const auto file = QDir(mGit->getWorkingDir()).relativeFilePath(blameWidget->getCurrentFile());
+   const auto shaColumn = static_cast<int>(CommitHistoryColumns::SHA);
+   const auto repoModel = mRepoView->model();
+   const auto totalRows = repoModel->rowCount();
+   auto row = 0;
+
+   while (row < totalRows && !repoModel->index(row, shaColumn).data().toString().startsWith(sha))
+      ++row;
+
+   if (sha.isEmpty() || row == totalRows)
+      return;
+
+   // The older revision goes first: stepping back through the history is the usual way to look for a change.
+   for (const auto neighbour : { row + 1, row - 1 })
+   {
+      const auto neighbourSha = repoModel->index(neighbour, shaColumn).data().toString();
+
+      if (!neighbourSha.isEmpty() && neighbourSha != CommitInfo::ZERO_SHA
+          && !BlameCache::contains(FileBlameLoader::cacheKey(mGit->getRepositoryId(), file, neighbourSha)))
+      {
+         mPrefetchQueue.append(neighbourSha);
+      }
+   }
+
+   mPrefetchFile = file;
+   mPrefetchBaseSha = sha;
+
+   prefetchNextBlame();
+}
+
+void BlameWidget::prefetchNextBlame()
+{
+   if (!mPrefetchQueue.isEmpty())
+   {
+      const auto sha = mPrefetchQueue.takeFirst();
+
+      QLog_Debug("Git", QString("Prefetching the blame of {%1} in {%2}.").arg(mPrefetchFile, sha));
+
+      mPrefetchLoader->load(mPrefetchFile, sha, mPrefetchBaseSha);
+   }
+}
+
+void BlameWidget::cancelPrefetch()
+{
+   mPrefetchQueue.clear();
+   mPrefetchLoader->cancel();
+}
+
 void BlameWidget::showFileHistoryByIndex(const QModelIndex &index)
 {
-   auto item = fileSystemModel->fileInfo(index);
+   if (fileTreeModel->isFile(index))
+      showFileHistory(fileTreeModel->filePath(index));
+}
+
+QStringList BlameWidget::getFileHistory(const QString &filePath)
+{
+   // A new generation of the cache can have new commits for the file.
+   if (mFileHistoriesGeneration != mCache->generation())
+   {
+      mFileHistories.clear();
+      mFileHistoriesGeneration = mCache->generation();
+   }
+
+   if (const auto iter = mFileHistories.constFind(filePath); iter != mFileHistories.constEnd())
+      return iter.value();
+
+   QStringList history;
+
+   if (mPathIndex->isReady())
+      history = mPathIndex->history(QDir(mGit->getWorkingDir()).relativeFilePath(filePath));
+   else
+   {
+      QScopedPointer<GitHistory> git(new GitHistory(mGit));
+      const auto ret = git->history(filePath);
+
+      // A failure is not kept, so it's tried again the next time.
+      if (!ret.success)
+         return QStringList();
+
+      history = ret.output.toString().split("\n", QString::SkipEmptyParts);
+   }
+
+   mFileHistories.insert(filePath, history);
 
-   if (item.isFile())
-      showFileHistory(item.filePath());
+   return history;
 }
 
 void BlameWidget::showRepoViewMenu(const QPoint &pos)
@@ -24,11 +24,12 @@
  ***************************************************************************************/
 
 #include <QFrame>
+#include <QHash>
 #include <QMap>
 
 class RevisionsCache;
 class GitBase;
-class QFileSystemModel;
+class BlameFileTreeModel;
 class FileBlameWidget;
 class QTreeView;
 class CommitHistoryModel;
@@ -36,6 +37,8 @@ class CommitHistoryView;
 class QTabWidget;
 class QModelIndex;
 class RepositoryViewDelegate;
+class PathHistoryIndex;
+class FileBlameLoader;
 
 /**
  * @brief The BlameWidget class creates the layout that contains all the widgets that are part of the blame and history
@@ -47,7 +50,7 @@ class RepositoryViewDelegate;
  * method. Once it's done, it can open files requested by other widgets by using the @p showFileHistory method, that
  * takes the file path.
  *
- * Internally the class also opens files but by taking the index from the QFileSystemModel.
+ * Internally the class also opens files but by taking the index from the tree of the files tracked by git.
  *
  */
 class BlameWidget : public QFrame
@@ -106,11 +109,18 @@ public:
     * @param totalCommits The total of commits loaded.
     */
    void onNewRevisions(int totalCommits);
+   /**
+    * @brief Updates the repository model while git is still loading the repository.
+    *
+    * @param totalCommits The total of commits loaded so far.
+    */
+   void onRevisionsChunkLoaded(int totalCommits);
 
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
-   QFileSystemModel *fileSystemModel = nullptr;
+   PathHistoryIndex *mPathIndex = nullptr;
+   BlameFileTreeModel *fileTreeModel = nullptr;
    CommitHistoryModel *mRepoModel = nullptr;
    CommitHistoryView *mRepoView = nullptr;
    QTreeView *fileSystemView = nullptr;
@@ -120,6 +130,12 @@ private:
    RepositoryViewDelegate *mItemDelegate = nullptr;
    int mSelectedRow = -1;
    int mLastTabIndex = 0;
+   FileBlameLoader *mPrefetchLoader = nullptr;
+   QString mPrefetchFile;
+   QString mPrefetchBaseSha;
+   QStringList mPrefetchQueue;
+   QHash<QString, QStringList> mFileHistories;
+   int mFileHistoriesGeneration = -1;
 
    /**
     * @brief Opens the blame for a given index from the file system model. This method configures both the history view,
@@ -129,6 +145,15 @@ private:
     * @param index The index from the file system model.
     */
    void showFileHistoryByIndex(const QModelIndex &index);
+   /**
+    * @brief Gets the SHAs of the commits that changed the file, from the newest to the oldest. They come from the path
+    * history index once it's built and from git meanwhile. They are kept until the cache loads a new generation, so
+    * switching between the tabs doesn't read them again.
+    *
+    * @param filePath The path of the file.
+    * @return The list of SHAs. It is empty if there is no history for the file.
+    */
+   QStringList getFileHistory(const QString &filePath);
    /**
     * @brief Shows the context menu for the history view.
     *
@@ -150,6 +175,21 @@ private:
     * @param tabIndex The new tab index selected.
     */
    void reloadHistory(int tabIndex);
+   /*!
+    \brief Once the blame of a revision is loaded, the blames of the revisions next to it in the history view are loaded
+    in the background so they are in the cache when the user steps through the history.
+
+    \param blameWidget The blame widget whose blame has been loaded.
+   */
+   void prefetchNeighbourBlames(FileBlameWidget *blameWidget);
+   /*!
+    \brief Loads the next blame in the prefetch queue, one at a time.
+   */
+   void prefetchNextBlame();
+   /*!
+    \brief Stops the prefetch so it doesn't compete with the blame the user asked for.
+   */
+   void cancelPrefetch();
 
    /*!
      \brief Retrieves the SHA from the QModelIndex and triggers the \ref signalOpenDiff signal.
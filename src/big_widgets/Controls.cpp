@@ -4,6 +4,7 @@
 #include <GitStashes.h>
 #include <GitQlientStyles.h>
 #include <GitRemote.h>
+#include <GitRemotesFetch.h>
 #include <BranchDlg.h>
 #include <RepoConfigDlg.h>
 
@@ -14,6 +15,10 @@
 #include <QMessageBox>
 #include <QPushButton>
 
+#include <QLogger.h>
+
+using namespace QLogger;
+
 Controls::Controls(const QSharedPointer<GitBase> &git, QWidget *parent)
    : QFrame(parent)
    , mGit(git)
@@ -160,10 +165,35 @@ Controls::Controls(const QSharedPointer<GitBase> &git, QWidget *parent)
    connect(mRefreshBtn, &QToolButton::clicked, this, &Controls::signalRepositoryUpdated);
    connect(mConfigBtn, &QToolButton::clicked, this, &Controls::showConfigDlg);
    connect(mMergeWarning, &QPushButton::clicked, this, &Controls::signalGoMerge);
+   connect(mGit->getScheduler(), &GitProcessScheduler::signalProgress, this, &Controls::showRemoteProgress);
+
+   mRemotesFetch = new GitRemotesFetch(mGit, this);
+   connect(mRemotesFetch, &GitRemotesFetch::signalRemoteProgress, this, &Controls::showFetchProgress);
+   connect(mRemotesFetch, &GitRemotesFetch::signalRemoteFetched, this, &Controls::onRemoteFetched);
+   connect(mRemotesFetch, &GitRemotesFetch::signalFinished, this, [this](const QStringList &failedRemotes) {
+      finishRemoteRequest();
+
+      if (!failedRemotes.isEmpty())
+         QLog_Info("UI", QString("The remotes {%1} couldn't be fetched.").arg(failedRemotes.join(", ")));
+   });
 
    enableButtons(false);
 }
 
+Controls::~Controls()
+{
+   if (mRemoteRequest != 0 || mRemotesFetch->isRunning())
+   {
+      if (mRemoteRequest != 0)
+         mGit->cancel(mRemoteRequest);
+
+      mRemotesFetch->cancel();
+
+      if (mRemoteWaitCursor)
+         QApplication::restoreOverrideCursor();
+   }
+}
+
 void Controls::toggleButton(ControlsMainViews view)
 {
    switch (view)
@@ -198,36 +228,87 @@ void Controls::enableButtons(bool enabled)
 
 void Controls::pullCurrentBranch()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-   QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->pull();
-   QApplication::restoreOverrideCursor();
+   if (!startRemoteRequest())
+      return;
 
-   if (ret.success)
-      emit signalRepositoryUpdated();
-   else
-   {
-      const auto errorMsg = ret.output.toString();
+   const auto head = mGit->getLastCommit();
+   const auto previousHeadSha = head.success ? head.output.toString().trimmed() : QString();
+
+   QScopedPointer<GitRemote> git(new GitRemote(mGit));
+   mRemoteRequest = git->pull(this, [this, previousHeadSha](const GitExecResult &ret) {
+      finishRemoteRequest();
 
-      if (errorMsg.contains("error: could not apply", Qt::CaseInsensitive)
-          && errorMsg.contains("causing a conflict", Qt::CaseInsensitive))
+      if (ret.success)
+         emit signalPulled(previousHeadSha);
+      else
       {
-         emit signalPullConflict();
+         const auto errorMsg = ret.output.toString();
+
+         if (errorMsg.contains("error: could not apply", Qt::CaseInsensitive)
+             && errorMsg.contains("causing a conflict", Qt::CaseInsensitive))
+         {
+            emit signalPullConflict();
+         }
+         else
+            QMessageBox::critical(this, tr("Error while pulling"), errorMsg);
       }
-      else
-         QMessageBox::critical(this, tr("Error while pulling"), errorMsg);
-   }
+   });
 }
 
 void Controls::fetchAll()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-   QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->fetch();
-   QApplication::restoreOverrideCursor();
+   if (startRemoteRequest())
+      fetch();
+}
+
+void Controls::autoFetch()
+{
+   // Nobody waits for the automatic fetch, so it doesn't show the wait cursor.
+   if (startRemoteRequest(false))
+      fetch();
+}
+
+void Controls::fetch()
+{
+   const auto references = mGit->getReferences(false);
+
+   mFetchedReferences = references.success ? references.output.toByteArray() : QByteArray();
+   mFetchProgress.clear();
+
+   if (!mRemotesFetch->start())
+      finishRemoteRequest();
+}
+
+void Controls::onRemoteFetched(const QString &remote, const GitExecResult &result)
+{
+   mFetchProgress.remove(remote);
+
+   if (!result.success)
+      return;
+
+   const auto references = mGit->getReferences(false);
 
-   if (ret)
+   // The repository is only reloaded if a reference moved: then the loader only adds the new commits.
+   if (!references.success || references.output.toByteArray() != mFetchedReferences)
+   {
+      mFetchedReferences = references.success ? references.output.toByteArray() : QByteArray();
       emit signalRepositoryUpdated();
+   }
+   else
+      QLog_Debug("UI", QString("The fetch of {%1} didn't change any reference.").arg(remote));
+}
+
+void Controls::showFetchProgress(const QString &remote, const QString &stepDescription, int value)
+{
+   mFetchProgress.insert(remote, tr("%1: %2 %3%").arg(remote, stepDescription).arg(value));
+
+   mRemoteBtn->setToolTip(mFetchProgress.values().join('\n'));
+}
+
+void Controls::showRemoteProgress(int request, const QString &stepDescription, int value)
+{
+   if (request == mRemoteRequest)
+      mRemoteBtn->setToolTip(tr("%1: %2%").arg(stepDescription).arg(value));
 }
 
 void Controls::activateMergeWarning()
@@ -257,24 +338,29 @@ ControlsMainViews Controls::getCurrentSelectedButton() const
 
 void Controls::pushCurrentBranch()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+   if (!startRemoteRequest())
+      return;
+
+   mRemoteBtn = mPushBtn;
+
    QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->push();
-   QApplication::restoreOverrideCursor();
+   mRemoteRequest = git->push(false, this, [this](const GitExecResult &ret) {
+      finishRemoteRequest();
 
-   if (ret.output.toString().contains("has no upstream branch"))
-   {
-      const auto currentBranch = mGit->getCurrentBranch();
-      BranchDlg dlg({ currentBranch, BranchDlgMode::PUSH_UPSTREAM, mGit });
-      const auto dlgRet = dlg.exec();
+      if (ret.output.toString().contains("has no upstream branch"))
+      {
+         const auto currentBranch = mGit->getCurrentBranch();
+         BranchDlg dlg({ currentBranch, BranchDlgMode::PUSH_UPSTREAM, mGit });
+         const auto dlgRet = dlg.exec();
 
-      if (dlgRet == QDialog::Accepted)
-         emit signalRepositoryUpdated();
-   }
-   else if (ret.success)
-      emit signalRepositoryUpdated();
-   else
-      QMessageBox::critical(this, tr("Error while pushing"), ret.output.toString());
+         if (dlgRet == QDialog::Accepted)
+            emit signalPushed();
+      }
+      else if (ret.success)
+         emit signalPushed();
+      else
+         QMessageBox::critical(this, tr("Error while pushing"), ret.output.toString());
+   });
 }
 
 void Controls::stashCurrentWork()
@@ -299,13 +385,16 @@ void Controls::popStashedWork()
 
 void Controls::pruneBranches()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+   if (!startRemoteRequest())
+      return;
+
    QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->prune();
-   QApplication::restoreOverrideCursor();
+   mRemoteRequest = git->prune(this, [this](const GitExecResult &ret) {
+      finishRemoteRequest();
 
-   if (ret.success)
-      emit signalRepositoryUpdated();
+      if (ret.success)
+         emit signalRepositoryUpdated();
+   });
 }
 
 void Controls::showConfigDlg()
@@ -313,3 +402,26 @@ void Controls::showConfigDlg()
    const auto configDlg = new RepoConfigDlg(mGit, this);
    configDlg->exec();
 }
+
+bool Controls::startRemoteRequest(bool showWaitCursor)
+{
+   if (mRemoteRequest != 0 || mRemotesFetch->isRunning())
+      return false;
+
+   mRemoteWaitCursor = showWaitCursor;
+   mRemoteBtn = mPullBtn;
+
+   if (mRemoteWaitCursor)
+      QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+   return true;
+}
+
+void Controls::finishRemoteRequest()
+{
+   mRemoteRequest = 0;
+   mRemoteBtn->setToolTip(QString());
+
+   if (mRemoteWaitCursor)
+      QApplication::restoreOverrideCursor();
+}
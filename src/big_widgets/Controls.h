@@ -24,10 +24,13 @@
  ***************************************************************************************/
 
 #include <QFrame>
+#include <QMap>
 
 class QToolButton;
 class QPushButton;
 class GitBase;
+class GitRemotesFetch;
+struct GitExecResult;
 
 /*!
  \brief Enum used to configure the different views handled by the Controls widget.
@@ -76,6 +79,16 @@ signals:
 
    */
    void signalRepositoryUpdated();
+   /*!
+    \brief Signal triggered when the pull of the current branch succeeds.
+
+    \param previousHeadSha The SHA of HEAD before the pull, to know if it was a fast-forward.
+   */
+   void signalPulled(const QString &previousHeadSha);
+   /*!
+    \brief Signal triggered when the current branch is pushed. Only the remote references moved.
+   */
+   void signalPushed();
    /*!
     * \brief Signal triggered when trying to pull and a conflict happens.
     */
@@ -89,6 +102,10 @@ public:
     \param parent The parent widget if needed.
    */
    explicit Controls(const QSharedPointer<GitBase> &git, QWidget *parent = nullptr);
+   /*!
+    \brief Destructor. It cancels the remote operation in progress, if any.
+   */
+   ~Controls() override;
    /*!
     \brief Process the toggled button and triggers its corresponding action.
 
@@ -112,6 +129,11 @@ public:
 
    */
    void fetchAll();
+   /*!
+    \brief Fetches in the background, without the wait cursor. It's used by the timer of the automatic fetch and it
+    does nothing if another remote operation is in progress.
+   */
+   void autoFetch();
    /*!
     \brief Activates the merge warning frame.
 
@@ -151,6 +173,14 @@ private:
    QToolButton *mRefreshBtn = nullptr;
    QToolButton *mConfigBtn = nullptr;
    QPushButton *mMergeWarning = nullptr;
+   int mRemoteRequest = 0;
+   // The button that shows the progress of the remote request.
+   QToolButton *mRemoteBtn = nullptr;
+   bool mRemoteWaitCursor = false;
+   GitRemotesFetch *mRemotesFetch = nullptr;
+   // The progress of every remote being fetched and the references after the last one that changed them.
+   QMap<QString, QString> mFetchProgress;
+   QByteArray mFetchedReferences;
 
    /*!
     \brief Pulls the current branch.
@@ -181,4 +211,40 @@ private:
     * \brief Shows the config dialog for both Local and Global user data.
     */
    void showConfigDlg();
+   /*!
+    \brief Tells if a remote operation (pull, push, fetch or prune) can start. They run in the background one at a
+    time, while the wait cursor is shown.
+
+    \param showWaitCursor False to run it without the wait cursor.
+    \return True if no remote operation is in progress.
+   */
+   bool startRemoteRequest(bool showWaitCursor = true);
+   /*!
+    \brief Ends the remote operation in progress once its result arrives.
+   */
+   void finishRemoteRequest();
+   /*!
+    \brief Fetches all the remotes at the same time. The repository is updated every time the fetch of a remote moves
+    any reference, without waiting for the rest.
+   */
+   void fetch();
+   /*!
+    \brief Updates the repository if the fetch of a remote moved any reference.
+
+    \param remote The remote.
+    \param result The result of git.
+   */
+   void onRemoteFetched(const QString &remote, const GitExecResult &result);
+   /*!
+    \brief Shows the progress of the remotes being fetched in the tooltip of the pull button.
+   */
+   void showFetchProgress(const QString &remote, const QString &stepDescription, int value);
+   /*!
+    \brief Shows the progress of the remote operation in progress in the tooltip of the pull button.
+
+    \param request The request that reports the progress.
+    \param stepDescription The step git is doing.
+    \param value The percentage of the step.
+   */
+   void showRemoteProgress(int request, const QString &stepDescription, int value);
 };
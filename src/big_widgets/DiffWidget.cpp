@@ -11,18 +11,40 @@
 #include <QMessageBox>
 #include <QHBoxLayout>
 #include <QScrollArea>
+#include <QTimer>
 
 using namespace QLogger;
 
+namespace
+{
+qint64 pageMemoryUsage(QWidget *page)
+{
+   if (const auto fileDiff = dynamic_cast<FileDiffWidget *>(page))
+      return fileDiff->memoryUsage();
+
+   if (const auto fullDiff = dynamic_cast<FullDiffWidget *>(page))
+      return fullDiff->memoryUsage();
+
+   return 0;
+}
+}
+
 DiffWidget::DiffWidget(const QSharedPointer<GitBase> git, QSharedPointer<RevisionsCache> cache, QWidget *parent)
    : QFrame(parent)
    , mGit(git)
    , mCache(cache)
    , centerStackedWidget(new QStackedWidget())
    , mCommitDiffWidget(new CommitDiffWidget(mGit, mCache))
+   , mHibernationTimer(new QTimer(this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
+   mClock.start();
+
+   mHibernationTimer->setInterval(HIBERNATE_CHECK_MS);
+   connect(mHibernationTimer, &QTimer::timeout, this, &DiffWidget::hibernate);
+   mHibernationTimer->start();
+
    centerStackedWidget->setCurrentIndex(0);
    centerStackedWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
    connect(centerStackedWidget, &QStackedWidget::currentChanged, this, &DiffWidget::changeSelection);
@@ -58,6 +80,7 @@ DiffWidget::DiffWidget(const QSharedPointer<GitBase> git, QSharedPointer<Revisio
    connect(mCommitDiffWidget, &CommitDiffWidget::signalOpenFileCommit, this, &DiffWidget::loadFileDiff);
    connect(mCommitDiffWidget, &CommitDiffWidget::signalShowFileHistory, this, &DiffWidget::signalShowFileHistory);
    connect(mCommitDiffWidget, &CommitDiffWidget::signalEditFile, this, &DiffWidget::signalEditFile);
+   connect(mCommitDiffWidget, &CommitDiffWidget::signalHighlightCommits, this, &DiffWidget::signalHighlightCommits);
 }
 
 DiffWidget::~DiffWidget()
@@ -93,6 +116,10 @@ bool DiffWidget::loadFileDiff(const QString &currentSha, const QString &previous
           QString("Requested diff for file {%1} on between commits {%2} and {%3}").arg(file, currentSha, previousSha));
 
       const auto fileDiffWidget = new FileDiffWidget(mGit, mCache);
+      fileDiffWidget->setStagingEnabled(true);
+
+      connect(fileDiffWidget, &FileDiffWidget::signalUpdateWipPaths, this, &DiffWidget::signalUpdateWipPaths);
+
       const auto fileWithModifications = fileDiffWidget->configure(currentSha, previousSha, file);
 
       if (fileWithModifications)
@@ -113,6 +140,7 @@ bool DiffWidget::loadFileDiff(const QString &currentSha, const QString &previous
          });
          connect(diffButton, &DiffButton::destroyed, this, [this, id, fileDiffWidget]() {
             centerStackedWidget->removeWidget(fileDiffWidget);
+            mHiddenSince.remove(fileDiffWidget);
             delete fileDiffWidget;
             mDiffButtons.remove(id);
 
@@ -183,6 +211,7 @@ void DiffWidget::loadCommitDiff(const QString &sha, const QString &parentSha)
       });
       connect(diffButton, &DiffButton::destroyed, this, [this, id, fullDiffWidget]() {
          centerStackedWidget->removeWidget(fullDiffWidget);
+         mHiddenSince.remove(fullDiffWidget);
          delete fullDiffWidget;
          mDiffButtons.remove(id);
 
@@ -214,10 +243,50 @@ void DiffWidget::loadCommitDiff(const QString &sha, const QString &parentSha)
    }
 }
 
+qint64 DiffWidget::memoryUsage() const
+{
+   qint64 bytes = 0;
+
+   for (const auto &buttons : qAsConst(mDiffButtons))
+      bytes += pageMemoryUsage(buttons.first);
+
+   return bytes;
+}
+
+int DiffWidget::compact()
+{
+   auto freed = 0;
+
+   for (const auto &buttons : qAsConst(mDiffButtons))
+   {
+      if (buttons.first == centerStackedWidget->currentWidget())
+         continue;
+
+      if (const auto fileDiff = dynamic_cast<FileDiffWidget *>(buttons.first); fileDiff && fileDiff->compact())
+         ++freed;
+      else if (const auto fullDiff = dynamic_cast<FullDiffWidget *>(buttons.first); fullDiff && fullDiff->compact())
+         ++freed;
+   }
+
+   return freed;
+}
+
 void DiffWidget::changeSelection(int index)
 {
    const auto widget = centerStackedWidget->widget(index);
 
+   if (mShownPage && mShownPage != widget)
+      mHiddenSince.insert(mShownPage, mClock.elapsed());
+
+   mHiddenSince.remove(widget);
+   mShownPage = widget;
+
+   // The diffs freed by compact are loaded again when they are seen.
+   if (const auto fileDiff = dynamic_cast<FileDiffWidget *>(widget))
+      fileDiff->restore();
+   else if (const auto fullDiff = dynamic_cast<FullDiffWidget *>(widget))
+      fullDiff->restore();
+
    for (const auto &buttons : qAsConst(mDiffButtons))
    {
       if (buttons.first == widget)
@@ -226,3 +295,25 @@ void DiffWidget::changeSelection(int index)
          buttons.second->setUnselected();
    }
 }
+
+void DiffWidget::hibernate()
+{
+   const auto now = mClock.elapsed();
+   auto hibernated = 0;
+
+   for (const auto &buttons : qAsConst(mDiffButtons))
+   {
+      const auto hiddenSince = mHiddenSince.value(buttons.first, -1);
+
+      if (hiddenSince < 0 || now - hiddenSince < HIBERNATE_AFTER_MS)
+         continue;
+
+      if (const auto fileDiff = dynamic_cast<FileDiffWidget *>(buttons.first); fileDiff && fileDiff->hibernate())
+         ++hibernated;
+      else if (const auto fullDiff = dynamic_cast<FullDiffWidget *>(buttons.first); fullDiff && fullDiff->hibernate())
+         ++hibernated;
+   }
+
+   if (hibernated > 0)
+      QLog_Debug("UI", QString("Hibernated {%1} diffs hidden for a while").arg(hibernated));
+}
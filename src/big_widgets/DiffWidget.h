@@ -23,7 +23,9 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <QElapsedTimer>
 #include <QFrame>
+#include <QHash>
 #include <QMap>
 
 class GitBase;
@@ -32,6 +34,7 @@ class DiffButton;
 class QVBoxLayout;
 class CommitDiffWidget;
 class RevisionsCache;
+class QTimer;
 
 /*!
  \brief The DiffWidget class creates the layout to display the dif information for both files and commits.
@@ -54,6 +57,18 @@ signals:
 
    */
    void signalDiffEmpty();
+   /*!
+    \brief Signal triggered when the user wants to see the commits of the compared range in the history.
+
+    \param rows The rows of the commits, sorted.
+   */
+   void signalHighlightCommits(const QVector<int> &rows);
+   /*!
+    \brief Signal triggered when some changes of a file of the work in progress are staged from its diff.
+
+    \param paths The files whose entries of the work in progress must be updated.
+   */
+   void signalUpdateWipPaths(const QStringList &paths);
 
    /**
     * @brief signalEditFile Signal triggered when the user wants to edit a file and is running GitQlient from QtCreator.
@@ -106,6 +121,26 @@ public:
     \param parentSha The SHA to compare to.
    */
    void loadCommitDiff(const QString &sha, const QString &parentSha);
+   /*!
+    \brief Returns an approximation of the memory used by the diffs opened, in bytes.
+   */
+   qint64 memoryUsage() const;
+   /*!
+    \brief Frees the diffs opened except the current one. The buttons stay and every diff is loaded again when it's
+    selected.
+
+    \return The number of diffs freed.
+   */
+   int compact();
+
+   /*!
+    \brief The time that a diff stays hidden before it hibernates: it keeps only a compressed copy of its text.
+   */
+   static constexpr int HIBERNATE_AFTER_MS = 5 * 60 * 1000;
+   /*!
+    \brief The interval between the checks of the diffs that have to hibernate.
+   */
+   static constexpr int HIBERNATE_CHECK_MS = 60 * 1000;
 
 private:
    QSharedPointer<GitBase> mGit;
@@ -114,6 +149,10 @@ private:
    QMap<QString, QPair<QFrame *, DiffButton *>> mDiffButtons;
    QVBoxLayout *mDiffButtonsContainer = nullptr;
    CommitDiffWidget *mCommitDiffWidget = nullptr;
+   QTimer *mHibernationTimer = nullptr;
+   QElapsedTimer mClock;
+   QHash<QWidget *, qint64> mHiddenSince;
+   QWidget *mShownPage = nullptr;
 
    /*!
     \brief When the user selectes a different diff from a different tab, it triggers an actionto change the current
@@ -122,4 +161,8 @@ private:
     \param index The new selected index.
    */
    void changeSelection(int index);
+   /*!
+    \brief Hibernates the diffs that are hidden for more than \ref HIBERNATE_AFTER_MS.
+   */
+   void hibernate();
 };
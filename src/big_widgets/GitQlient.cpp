@@ -1,7 +1,14 @@
 #include "GitQlient.h"
 
 #include <ConfigWidget.h>
+#include <GitQlientSettings.h>
 #include <GitQlientStyles.h>
+#include <GitRecorder.h>
+#include <LazyLog.h>
+#include <RepositoriesSearchDlg.h>
+#include <ResourceBudget.h>
+#include <RevisionsCache.h>
+#include <TraceRecorder.h>
 
 #include <QProcess>
 #include <QTabWidget>
@@ -11,6 +18,8 @@
 #include <QPushButton>
 #include <QFile>
 #include <QFileDialog>
+#include <QSignalBlocker>
+#include <QShortcut>
 
 #include <QLogger.h>
 
@@ -28,6 +37,29 @@ GitQlient::GitQlient(const QStringList &arguments, QWidget *parent)
 {
    const auto repos = parseArguments(arguments);
 
+   GitQlientSettings settings;
+
+   if (settings.value(GitQlientSettings::AsyncLogsKey, GitQlientSettings::AsyncLogsValue).toBool())
+   {
+      const auto overflow
+          = settings.value(GitQlientSettings::LogsOverflowKey, GitQlientSettings::LogsOverflowValue).toString();
+
+      LazyLog::SinkOptions options;
+      options.overflow = overflow == "drop" ? LazyLog::OverflowPolicy::Drop : LazyLog::OverflowPolicy::Count;
+      options.maxMessagesPerSecond
+          = settings.value(GitQlientSettings::LogsRateLimitKey, GitQlientSettings::LogsRateLimitValue).toInt();
+
+      LazyLog::startAsyncSink(options);
+   }
+
+   TraceRecorder::instance().setEnabled(
+       settings.value(GitQlientSettings::TraceEventsKey, GitQlientSettings::TraceEventsValue).toBool());
+
+   ResourceBudget::instance().setMemoryBudget(
+       settings.value(GitQlientSettings::MemoryBudgetMbKey, GitQlientSettings::MemoryBudgetMbValue).toInt());
+   ResourceBudget::instance().setMaxConcurrency(
+       settings.value(GitQlientSettings::MaxConcurrentTasksKey, GitQlientSettings::MaxConcurrentTasksValue).toInt());
+
    QLog_Info("UI", "*******************************************");
    QLog_Info("UI", "*          GitQlient has started          *");
    QLog_Info("UI", QString("*                  %1                  *").arg(VER));
@@ -46,6 +78,7 @@ GitQlient::GitQlient(const QStringList &arguments, QWidget *parent)
    mRepos->setCornerWidget(addTab, Qt::TopRightCorner);
    mRepos->setTabsClosable(true);
    connect(mRepos, &QTabWidget::tabCloseRequested, this, &GitQlient::closeTab);
+   connect(mRepos, &QTabWidget::currentChanged, this, &GitQlient::onCurrentTabChanged);
 
    const auto vLayout = new QVBoxLayout(this);
    vLayout->setContentsMargins(QMargins());
@@ -56,11 +89,17 @@ GitQlient::GitQlient(const QStringList &arguments, QWidget *parent)
 
    connect(mConfigWidget, &ConfigWidget::signalOpenRepo, this, &GitQlient::addRepoTab);
 
+   const auto searchShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_F), this);
+   searchShortcut->setContext(Qt::ApplicationShortcut);
+   connect(searchShortcut, &QShortcut::activated, this, &GitQlient::searchRepositories);
+
    setRepositories(repos);
 }
 
 GitQlient::~GitQlient()
 {
+   LazyLog::stopAsyncSink();
+
    QLog_Info("UI", "*            Closing GitQlient            *\n\n");
 }
 
@@ -79,8 +118,37 @@ void GitQlient::setRepositories(const QStringList &repositories)
 {
    QLog_Info("UI", QString("Adding {%1} repositories").arg(repositories.count()));
 
-   for (const auto &repo : repositories)
-      addRepoTab(repo);
+   if (repositories.isEmpty())
+      return;
+
+   // Only the repository shown, the last one, and the one used most recently are loaded. The rest of the tabs load
+   // their repository when they are shown for the first time.
+   QString preloaded;
+
+   for (const auto &project : GitQlientSettings().getRecentProjects())
+   {
+      if (project != repositories.last() && repositories.contains(project) && !mCurrentRepos.contains(project))
+      {
+         preloaded = project;
+         break;
+      }
+   }
+
+   for (auto i = 0; i < repositories.count() - 1; ++i)
+   {
+      const auto &repo = repositories.at(i);
+
+      if (repo != preloaded)
+         addPlaceholderTab(repo);
+      else
+      {
+         // It's loaded hidden, so the RepoLoadScheduler loads it in the background.
+         createRepoTab(repo, mRepos->count());
+         mCurrentRepos.insert(repo);
+      }
+   }
+
+   addRepoTab(repositories.last());
 }
 
 void GitQlient::setArgumentsPostInit(const QStringList &arguments)
@@ -101,9 +169,13 @@ QStringList GitQlient::parseArguments(const QStringList &arguments)
 
    const auto manager = QLoggerManager::getInstance();
    manager->addDestination("GitQlient.log", { "UI", "Git" }, logLevel);
+   LazyLog::setLevel(logLevel);
 
    if (arguments.contains("-noLog"))
+   {
       QLoggerManager::getInstance()->pause();
+      LazyLog::setPaused(true);
+   }
 
    QLog_Info("UI", QString("Getting arguments {%1}").arg(arguments.join(", ")));
 
@@ -128,8 +200,19 @@ QStringList GitQlient::parseArguments(const QStringList &arguments)
             {
                const auto logger = QLoggerManager::getInstance();
                logger->overwriteLogLevel(static_cast<LogLevel>(logLevel));
+               LazyLog::setLevel(static_cast<LogLevel>(logLevel));
             }
          }
+         else if (arguments.at(i) == "-record" && i + 1 < argSize)
+            GitRecorder::instance().startRecording(arguments.at(++i), arguments.contains("-hashPaths"));
+         else if (arguments.at(i) == "-replay" && i + 1 < argSize)
+         {
+            const auto speedIndex = arguments.indexOf("-replaySpeed");
+            const auto speed
+                = speedIndex != -1 && speedIndex + 1 < argSize ? arguments.at(speedIndex + 1).toDouble() : 1.0;
+
+            GitRecorder::instance().startReplay(arguments.at(++i), speed);
+         }
 
          ++i;
       }
@@ -142,60 +225,115 @@ void GitQlient::addRepoTab(const QString &repoPath)
 {
    if (!mCurrentRepos.contains(repoPath))
    {
-      const auto newRepo = new GitQlientRepo(repoPath);
-      connect(newRepo, &GitQlientRepo::signalEditFile, this, &GitQlient::signalEditDocument);
-      connect(newRepo, &GitQlientRepo::signalOpenSubmodule, this, [this](const QString &repoName) {
-         const auto currentDir = dynamic_cast<GitQlientRepo *>(sender())->currentDir();
+      const auto index = createRepoTab(repoPath, mRepos->count());
 
-         auto submoduleDir = QString("%1/%2").arg(currentDir, repoName);
+      mRepos->setCurrentIndex(index);
 
-         QLog_Info("UI", QString("Adding a new tab for the submodule {%1} in {%2}").arg(repoName, currentDir));
+      mCurrentRepos.insert(repoPath);
+   }
+   else
+      QLog_Warning("UI", QString("Repository at {%1} already opened. Skip adding it again.").arg(repoPath));
+}
 
-         addRepoTab(submoduleDir);
-      });
+void GitQlient::addPlaceholderTab(const QString &repoPath)
+{
+   if (!mCurrentRepos.contains(repoPath))
+   {
+      const auto placeholder = new QWidget();
 
-      mConfigWidget->onRepoOpened();
+      mPlaceholders.insert(placeholder, repoPath);
+      mRepos->addTab(placeholder, QIcon(":/icons/local"), QDir(repoPath).dirName());
 
-      const auto repoName = newRepo->currentDir().contains("/") ? newRepo->currentDir().split("/").last() : "No repo";
-      const auto index = mRepos->addTab(newRepo, repoName);
+      mCurrentRepos.insert(repoPath);
+   }
+   else
+      QLog_Warning("UI", QString("Repository at {%1} already opened. Skip adding it again.").arg(repoPath));
+}
 
-      if (!repoPath.isEmpty())
-      {
-         QProcess p;
-         p.setWorkingDirectory(repoPath);
-         p.start("git rev-parse --show-superproject-working-tree");
-         p.waitForFinished(5000);
+int GitQlient::createRepoTab(const QString &repoPath, int index)
+{
+   const auto newRepo = new GitQlientRepo(repoPath);
+   connect(newRepo, &GitQlientRepo::signalEditFile, this, &GitQlient::signalEditDocument);
+   connect(newRepo, &GitQlientRepo::signalOpenSubmodule, this, [this](const QString &repoName) {
+      const auto currentDir = dynamic_cast<GitQlientRepo *>(sender())->currentDir();
 
-         const auto output = p.readAll().trimmed();
-         const auto isSubmodule = !output.isEmpty();
+      auto submoduleDir = QString("%1/%2").arg(currentDir, repoName);
 
-         mRepos->setTabIcon(index, QIcon(isSubmodule ? QString(":/icons/submodules") : QString(":/icons/local")));
+      QLog_Info("UI", QString("Adding a new tab for the submodule {%1} in {%2}").arg(repoName, currentDir));
 
-         QLog_Info("UI", "Attaching repository to a new tab");
+      addRepoTab(submoduleDir);
+   });
 
-         if (isSubmodule)
-         {
-            const auto parentRepo = QString::fromUtf8(output.split('/').last());
+   mConfigWidget->onRepoOpened();
 
-            mRepos->setTabText(index, QString("%1 \u2192 %2").arg(parentRepo, repoName));
+   const auto repoName = newRepo->currentDir().contains("/") ? newRepo->currentDir().split("/").last() : "No repo";
+   index = mRepos->insertTab(index, newRepo, repoName);
 
-            QLog_Info("UI",
-                      QString("Opening the submodule {%1} from the repo {%2} on tab index {%3}")
-                          .arg(repoName, parentRepo)
-                          .arg(index));
-         }
+   if (!repoPath.isEmpty())
+   {
+      QProcess p;
+      p.setWorkingDirectory(repoPath);
+      p.start("git rev-parse --show-superproject-working-tree");
+      p.waitForFinished(5000);
+
+      const auto output = p.readAll().trimmed();
+      const auto isSubmodule = !output.isEmpty();
+
+      mRepos->setTabIcon(index, QIcon(isSubmodule ? QString(":/icons/submodules") : QString(":/icons/local")));
+
+      QLog_Info("UI", "Attaching repository to a new tab");
+
+      if (isSubmodule)
+      {
+         const auto parentRepo = QString::fromUtf8(output.split('/').last());
+
+         mRepos->setTabText(index, QString("%1 \u2192 %2").arg(parentRepo, repoName));
+
+         QLog_Info("UI",
+                   QString("Opening the submodule {%1} from the repo {%2} on tab index {%3}")
+                       .arg(repoName, parentRepo)
+                       .arg(index));
       }
+   }
 
-      mRepos->setCurrentIndex(index);
+   return index;
+}
 
-      mCurrentRepos.insert(repoPath);
+void GitQlient::onCurrentTabChanged(int index)
+{
+   const auto placeholder = mRepos->widget(index);
+   const auto iter = mPlaceholders.find(placeholder);
+
+   if (iter == mPlaceholders.end())
+      return;
+
+   const auto repoPath = iter.value();
+   mPlaceholders.erase(iter);
+
+   QLog_Info("UI", QString("Loading the repository {%1}, shown for the first time").arg(repoPath));
+
+   {
+      // Removing the placeholder would show another tab, and maybe load it.
+      const QSignalBlocker blocker(mRepos);
+
+      mRepos->removeTab(index);
+      createRepoTab(repoPath, index);
+      mRepos->setCurrentIndex(index);
    }
-   else
-      QLog_Warning("UI", QString("Repository at {%1} already opened. Skip adding it again.").arg(repoPath));
+
+   placeholder->deleteLater();
 }
 
 void GitQlient::closeTab(int tabIndex)
 {
+   if (const auto placeholder = mRepos->widget(tabIndex); mPlaceholders.contains(placeholder))
+   {
+      mCurrentRepos.remove(mPlaceholders.take(placeholder));
+      mRepos->removeTab(tabIndex);
+      placeholder->deleteLater();
+      return;
+   }
+
    auto repoToRemove = dynamic_cast<GitQlientRepo *>(mRepos->widget(tabIndex));
 
    QLog_Info("UI", QString("Removing repository {%1}").arg(repoToRemove->currentDir()));
@@ -204,3 +342,46 @@ void GitQlient::closeTab(int tabIndex)
    mRepos->removeTab(tabIndex);
    repoToRemove->close();
 }
+
+void GitQlient::searchRepositories()
+{
+   QVector<RepositoriesSearch::Source> sources;
+
+   for (auto i = 0; i < mRepos->count(); ++i)
+   {
+      const auto repo = dynamic_cast<GitQlientRepo *>(mRepos->widget(i));
+
+      if (!repo)
+         continue;
+
+      const auto cache = repo->getCache();
+
+      RepositoriesSearch::Source source;
+      source.repository = repo->currentDir();
+      source.cache = cache.data();
+      source.snapshot = cache->snapshot();
+      source.references = cache->getBranches(References::Type::LocalBranch)
+          + cache->getBranches(References::Type::RemoteBranches) + cache->getTags();
+
+      sources.append(source);
+   }
+
+   QLog_Info("UI", QString("Searching in {%1} repositories").arg(sources.count()));
+
+   RepositoriesSearchDlg dlg(sources, this);
+   connect(&dlg, &RepositoriesSearchDlg::signalGoToCommit, this, [this](const QString &repository, const QString &sha) {
+      for (auto i = 0; i < mRepos->count(); ++i)
+      {
+         const auto repo = dynamic_cast<GitQlientRepo *>(mRepos->widget(i));
+
+         if (repo && repo->currentDir() == repository)
+         {
+            mRepos->setCurrentIndex(i);
+            repo->showCommit(sha);
+            break;
+         }
+      }
+   });
+
+   dlg.exec();
+}
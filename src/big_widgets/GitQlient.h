@@ -24,6 +24,7 @@
  ***************************************************************************************/
 
 #include <QWidget>
+#include <QHash>
 #include <QSet>
 
 class QTabWidget;
@@ -78,6 +79,7 @@ private:
    QTabWidget *mRepos = nullptr;
    ConfigWidget *mConfigWidget = nullptr;
    QSet<QString> mCurrentRepos;
+   QHash<QWidget *, QString> mPlaceholders;
 
    /*!
     \brief This method parses all the arguments and configures GitQlient settings with them. Part of the arguments can
@@ -99,6 +101,27 @@ private:
     \param repoPath The full path of the repository to be opened.
    */
    void addRepoTab(const QString &repoPath = "");
+   /*!
+    \brief Adds a tab for a repository without loading it. The repository is loaded when the tab is shown for the
+    first time.
+
+    \param repoPath The full path of the repository.
+   */
+   void addPlaceholderTab(const QString &repoPath);
+   /*!
+    \brief Creates the GitQlientRepo of a repository in a new tab.
+
+    \param repoPath The full path of the repository.
+    \param index The position of the tab.
+    \return The index of the tab.
+   */
+   int createRepoTab(const QString &repoPath, int index);
+   /*!
+    \brief Loads the repository of a placeholder tab when it's shown.
+
+    \param index The index of the tab shown.
+   */
+   void onCurrentTabChanged(int index);
    /*!
     \brief Closes a tab. This implies to close all child widgets and remove cache and configuration for that repository
     until it's opened again.
@@ -106,4 +129,9 @@ private:
     \param tabIndex The tab index that triggered the close action.
    */
    void closeTab(int tabIndex);
+   /*!
+    \brief Opens the search in all the repositories loaded. The tabs not loaded yet are not searched. The matches
+    chosen are shown in the history of their tab.
+   */
+   void searchRepositories();
 };
@@ -8,21 +8,27 @@
 #include <QLogger.h>
 #include <BlameWidget.h>
 #include <CommitInfo.h>
-#include <ProgressDlg.h>
 #include <GitConfigDlg.h>
 #include <Controls.h>
 #include <HistoryWidget.h>
 #include <DiffWidget.h>
+#include <DiffDiskCache.h>
 #include <MergeWidget.h>
+#include <PerformanceMetrics.h>
 #include <RevisionsCache.h>
 #include <GitRepoLoader.h>
 #include <GitConfig.h>
 #include <GitBase.h>
 #include <GitHistory.h>
+#include <GitMaintenance.h>
+#include <GitRepositoryReader.h>
+#include <GitWatcher.h>
+#include <FrameStatistics.h>
+#include <RepoLoadScheduler.h>
+#include <TraceRecorder.h>
+#include <WorkerPool.h>
 
 #include <QTimer>
-#include <QDirIterator>
-#include <QFileSystemWatcher>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QStackedWidget>
@@ -40,12 +46,13 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    , mHistoryWidget(new HistoryWidget(mGitQlientCache, mGitBase))
    , mStackedLayout(new QStackedLayout())
    , mControls(new Controls(mGitBase))
-   , mDiffWidget(new DiffWidget(mGitBase, mGitQlientCache))
-   , mBlameWidget(new BlameWidget(mGitQlientCache, mGitBase))
-   , mMergeWidget(new MergeWidget(mGitQlientCache, mGitBase))
    , mAutoFetch(new QTimer())
    , mAutoFilesUpdate(new QTimer())
+   , mCompactTimer(new QTimer())
+   , mStartupWorker(new WorkerQueue(mGitQlientCache.data(), WorkerPool::Priority::Background))
 {
+   mOpenTimer.start();
+
    setAttribute(Qt::WA_DeleteOnClose);
 
    QLog_Info("UI", QString("Initializing GitQlient"));
@@ -53,10 +60,40 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    setObjectName("mainWindow");
    setWindowTitle("GitQlient");
 
+   GitQlientSettings settings;
+   mGitQlientCache->setRevisionFilesBudget(
+       settings.value(GitQlientSettings::RevisionFilesCacheKey, GitQlientSettings::RevisionFilesCacheValue).toInt());
+   mGitQlientCache->setPathTable(PathTable::forRepositoryGroup(mGitBase->getRepositoryGroup()));
+   mGitQlientCache->setRevisionFilesStore(RevisionFilesStore::forRepository(mGitBase->getRepositoryId()));
+   mGitBase->getScheduler()->setMaxConcurrentProcesses(
+       settings.value(GitQlientSettings::MaxGitProcessesKey, GitQlientSettings::MaxGitProcessesValue).toInt());
+   mMaintenance = new GitMaintenance(mGitBase, this);
+   mCompactTimer->setSingleShot(true);
+   mCompactTimer->setInterval(
+       settings.value(GitQlientSettings::InactiveCompactMinutesKey, GitQlientSettings::InactiveCompactMinutesValue)
+           .toInt()
+       * 60 * 1000);
+   mGitLoader->setHistoryOrder(GitRepoLoader::historyOrderFromString(
+       settings.value(GitQlientSettings::HistoryOrderKey, GitQlientSettings::HistoryOrderValue).toString()));
+
+   applyRepositorySettings();
+
+   const auto diffDiskCacheMb
+       = settings.value(GitQlientSettings::DiffDiskCacheSizeMbKey, GitQlientSettings::DiffDiskCacheSizeMbValue)
+             .toLongLong();
+   DiffDiskCache::configure(
+       settings.value(GitQlientSettings::DiffDiskCacheKey, GitQlientSettings::DiffDiskCacheValue).toBool(),
+       diffDiskCacheMb * 1024 * 1024);
+
+   const auto builtinReads
+       = settings.value(GitQlientSettings::BuiltinGitReadsKey, GitQlientSettings::BuiltinGitReadsValue).toBool();
+
+   for (const auto operation :
+        { GitBase::ReadOperation::Head, GitBase::ReadOperation::References, GitBase::ReadOperation::GitDirectory })
+      mGitBase->setBuiltinRead(operation, builtinReads);
+
+   // The rest of the views are created the first time they are used.
    mStackedLayout->addWidget(mHistoryWidget);
-   mStackedLayout->addWidget(mDiffWidget);
-   mStackedLayout->addWidget(mBlameWidget);
-   mStackedLayout->addWidget(mMergeWidget);
    showHistoryView();
 
    const auto mainLayout = new QVBoxLayout(this);
@@ -65,17 +102,20 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    mainLayout->addWidget(mControls);
    mainLayout->addLayout(mStackedLayout);
 
-   mAutoFetch->setInterval(mConfig.mAutoFetchSecs * 1000);
-   mAutoFilesUpdate->setInterval(mConfig.mAutoFileUpdateSecs * 1000);
+   updateTimersInterval();
 
-   connect(mAutoFetch, &QTimer::timeout, mControls, &Controls::fetchAll);
-   connect(mAutoFilesUpdate, &QTimer::timeout, this, &GitQlientRepo::updateUiFromWatcher);
+   connect(mAutoFetch, &QTimer::timeout, this, &GitQlientRepo::onAutoFetch);
+   connect(mAutoFilesUpdate, &QTimer::timeout, this, &GitQlientRepo::onAutoFilesUpdate);
+   connect(mCompactTimer, &QTimer::timeout, this, &GitQlientRepo::compactCaches);
+   connect(qApp, &QGuiApplication::applicationStateChanged, this, &GitQlientRepo::onApplicationStateChanged);
 
    connect(mControls, &Controls::signalGoRepo, this, &GitQlientRepo::showHistoryView);
    connect(mControls, &Controls::signalGoBlame, this, &GitQlientRepo::showBlameView);
    connect(mControls, &Controls::signalGoDiff, this, &GitQlientRepo::showDiffView);
    connect(mControls, &Controls::signalGoMerge, this, &GitQlientRepo::showMergeView);
    connect(mControls, &Controls::signalRepositoryUpdated, this, &GitQlientRepo::updateCache);
+   connect(mControls, &Controls::signalPulled, this, &GitQlientRepo::onPulled);
+   connect(mControls, &Controls::signalPushed, this, &GitQlientRepo::onPushed);
    connect(mControls, &Controls::signalPullConflict, mControls, &Controls::activateMergeWarning);
    connect(mControls, &Controls::signalPullConflict, this, &GitQlientRepo::showPullConflict);
 
@@ -85,6 +125,7 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    connect(mHistoryWidget, &HistoryWidget::signalUpdateCache, this, &GitQlientRepo::updateCache);
    connect(mHistoryWidget, &HistoryWidget::signalOpenSubmodule, this, &GitQlientRepo::signalOpenSubmodule);
    connect(mHistoryWidget, &HistoryWidget::signalViewUpdated, this, &GitQlientRepo::updateCache);
+   connect(mHistoryWidget, &HistoryWidget::signalCheckedOut, this, &GitQlientRepo::onCheckedOut);
    connect(mHistoryWidget, &HistoryWidget::signalOpenDiff, this, &GitQlientRepo::openCommitDiff);
    connect(mHistoryWidget, &HistoryWidget::signalOpenCompareDiff, this, &GitQlientRepo::openCommitCompareDiff);
    connect(mHistoryWidget, &HistoryWidget::signalShowDiff, this, &GitQlientRepo::loadFileDiff);
@@ -98,37 +139,56 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    connect(mHistoryWidget, &HistoryWidget::signalPullConflict, mControls, &Controls::activateMergeWarning);
    connect(mHistoryWidget, &HistoryWidget::signalPullConflict, this, &GitQlientRepo::showPullConflict);
    connect(mHistoryWidget, &HistoryWidget::signalUpdateWip, this, &GitQlientRepo::updateWip);
+   connect(mHistoryWidget, &HistoryWidget::signalUpdateWipPaths, this, &GitQlientRepo::updateWipPaths);
 
-   connect(mDiffWidget, &DiffWidget::signalShowFileHistory, this, &GitQlientRepo::showFileHistory);
-   connect(mDiffWidget, &DiffWidget::signalDiffEmpty, mControls, &Controls::disableDiff);
-   connect(mDiffWidget, &DiffWidget::signalDiffEmpty, this, &GitQlientRepo::showPreviousView);
-   connect(mDiffWidget, &DiffWidget::signalEditFile, this, &GitQlientRepo::signalEditFile);
-
-   connect(mBlameWidget, &BlameWidget::showFileDiff, this, &GitQlientRepo::loadFileDiff);
-   connect(mBlameWidget, &BlameWidget::signalOpenDiff, this, &GitQlientRepo::openCommitCompareDiff);
-
-   connect(mMergeWidget, &MergeWidget::signalMergeFinished, this, &GitQlientRepo::showHistoryView);
-   connect(mMergeWidget, &MergeWidget::signalMergeFinished, this, &GitQlientRepo::updateCache);
-   connect(mMergeWidget, &MergeWidget::signalMergeFinished, mControls, &Controls::disableMergeWarning);
-   connect(mMergeWidget, &MergeWidget::signalEditFile, this, &GitQlientRepo::signalEditFile);
-
-   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::createProgressDialog,
-           Qt::DirectConnection);
-   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStep, this, &GitQlientRepo::updateProgressDialog,
-           Qt::DirectConnection);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsChunkLoaded, this,
+           &GitQlientRepo::onRevisionsChunkLoaded, Qt::DirectConnection);
+   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingFinished, this,
+           [this]() { RepoLoadScheduler::instance().loadFinished(this); });
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingFinished, this, &GitQlientRepo::onRepoLoadFinished,
            Qt::DirectConnection);
+   connect(mGitLoader.data(), &GitRepoLoader::signalPageLoaded, this, [this](bool moreRevisions) {
+      mHistoryWidget->onPageLoaded(mGitQlientCache->count(), moreRevisions);
+
+      if (mBlameWidget)
+         mBlameWidget->onNewRevisions(mGitQlientCache->count());
+   });
+   connect(mHistoryWidget, &HistoryWidget::signalMoreRevisionsRequested, this, &GitQlientRepo::loadMoreRevisions);
+   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingProgress, mHistoryWidget,
+           &HistoryWidget::onLoadingProgress);
+   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingTimings, mHistoryWidget,
+           &HistoryWidget::onLoadingTimings);
+   connect(mGitLoader.data(), &GitRepoLoader::signalUntrackedFilesLoaded, mHistoryWidget,
+           &HistoryWidget::updateUiFromWatcher);
+   connect(mGitLoader.data(), &GitRepoLoader::signalReferencesUpdated, mHistoryWidget,
+           &HistoryWidget::onReferencesUpdated);
+   connect(mGitLoader.data(), &GitRepoLoader::signalHeadMoved, this, [this]() {
+      mHistoryWidget->onHeadMoved();
+
+      if (mDiffWidget)
+         mDiffWidget->reload();
+   });
 
    GitQlientSettings settings;
    mGitLoader->setShowAll(settings.value("ShowAllBranches", true).toBool());
 
    setRepository(repoPath);
+
+   mMetricsId = PerformanceMetrics::instance().addRepository([this]() { return metrics(); });
+
+   QLog_Debug("UI", QString("Repository tab created in {%1} ms").arg(mOpenTimer.elapsed()));
 }
 
 GitQlientRepo::~GitQlientRepo()
 {
+   PerformanceMetrics::instance().removeRepository(mMetricsId);
+
+   // The check of the configuration that is running uses the repository.
+   mStartupWorker.reset();
+
    delete mAutoFetch;
    delete mAutoFilesUpdate;
+   delete mCompactTimer;
    delete mGitWatcher;
 }
 
@@ -139,11 +199,11 @@ void GitQlientRepo::setConfig(const GitQlientRepoConfig &config)
    mConfig = config;
 
    mAutoFetch->stop();
-   mAutoFetch->setInterval(mConfig.mAutoFetchSecs);
-   mAutoFetch->start();
-
    mAutoFilesUpdate->stop();
-   mAutoFilesUpdate->setInterval(mConfig.mAutoFileUpdateSecs);
+
+   updateTimersInterval();
+
+   mAutoFetch->start();
    mAutoFilesUpdate->start();
 }
 
@@ -153,21 +213,171 @@ void GitQlientRepo::updateCache()
    {
       QLog_Debug("UI", QString("Updating the GitQlient UI"));
 
-      mGitLoader->loadRepository();
+      requestLoad(true);
 
-      mDiffWidget->reload();
+      if (mDiffWidget)
+         mDiffWidget->reload();
    }
 }
 
+void GitQlientRepo::requestLoad(bool configure)
+{
+   RepoLoadScheduler::instance().requestLoad(this, [this, configure]() {
+      if (configure)
+         mGitLoader->loadRepository();
+      else
+         mGitLoader->loadRevisions();
+
+      // The scheduler waits for the end of the load, unless it didn't start.
+      if (!mGitLoader->isLoading())
+         RepoLoadScheduler::instance().loadFinished(this);
+   });
+}
+
 void GitQlientRepo::updateUiFromWatcher()
 {
+   TraceSpan span("watcher", "GitQlientRepo::updateUiFromWatcher");
+
    QLog_Info("UI", QString("Updating the GitQlient UI from watcher"));
 
    mGitLoader->updateWipRevision();
 
    mHistoryWidget->updateUiFromWatcher();
 
-   mDiffWidget->reload();
+   if (mDiffWidget)
+      mDiffWidget->reload();
+}
+
+void GitQlientRepo::updateWipPaths(const QStringList &paths)
+{
+   TraceSpan span("watcher", "GitQlientRepo::updateWipPaths");
+
+   if (!mGitLoader->updateWipRevision(paths))
+   {
+      updateUiFromWatcher();
+      return;
+   }
+
+   QLog_Info("UI", QString("Updating {%1} paths of the GitQlient UI from watcher").arg(paths.count()));
+
+   mHistoryWidget->updateWipPaths(paths);
+
+   if (mDiffWidget)
+      mDiffWidget->reload();
+}
+
+bool GitQlientRepo::isSeen() const
+{
+   return isVisible() && !window()->isMinimized();
+}
+
+void GitQlientRepo::updateTimersInterval()
+{
+   const auto factor
+       = (QApplication::applicationState() == Qt::ApplicationActive ? 1 : INACTIVE_INTERVAL_FACTOR) * mPollingFactor;
+
+   mAutoFetch->setInterval(RepoLoadScheduler::instance().spreadInterval(mConfig.mAutoFetchSecs * 1000 * factor));
+   mAutoFilesUpdate->setInterval(mConfig.mAutoFileUpdateSecs * 1000 * factor);
+}
+
+void GitQlientRepo::onAutoFetch()
+{
+   // Every repository fetches at slightly different times, so the fetches of the tabs don't happen in sync.
+   const auto factor
+       = (QApplication::applicationState() == Qt::ApplicationActive ? 1 : INACTIVE_INTERVAL_FACTOR) * mPollingFactor;
+   mAutoFetch->setInterval(RepoLoadScheduler::instance().spreadInterval(mConfig.mAutoFetchSecs * 1000 * factor));
+
+   if (isSeen())
+      mControls->autoFetch();
+   else
+      mPendingFetch = true;
+}
+
+void GitQlientRepo::onAutoFilesUpdate()
+{
+   if (isSeen())
+      updateUiFromWatcher();
+   else
+      mPendingWipUpdate = true;
+}
+
+void GitQlientRepo::onWorkingTreeChanged(const QStringList &paths)
+{
+   if (isSeen())
+      updateWipPaths(paths);
+   else
+   {
+      // No need to know which paths changed, the catch up updates the whole WIP.
+      mGitWatcher->setPaused(true);
+      mPendingWipUpdate = true;
+   }
+}
+
+void GitQlientRepo::onRepositoryStateChanged()
+{
+   // Many changes (a fetch without new commits, a new branch or tag...) only add, remove or move references.
+   if (!isSeen())
+      mPendingCacheUpdate = true;
+   else if (!mGitLoader->updateReferences())
+      updateCache();
+}
+
+void GitQlientRepo::onCheckedOut()
+{
+   // With all the branches shown, checking out a commit of the history only moves HEAD and the current branch.
+   if (!mGitLoader->updateReferences())
+      updateCache();
+}
+
+void GitQlientRepo::onPulled(const QString &previousHeadSha)
+{
+   RepoLoadScheduler::instance().requestLoad(this, [this, previousHeadSha]() {
+      if (!mGitLoader->loadPulledRevisions(previousHeadSha))
+         mGitLoader->loadRepository();
+
+      if (!mGitLoader->isLoading())
+         RepoLoadScheduler::instance().loadFinished(this);
+   });
+
+   if (mDiffWidget)
+      mDiffWidget->reload();
+}
+
+void GitQlientRepo::onPushed()
+{
+   if (!mGitLoader->updateReferences())
+      updateCache();
+}
+
+void GitQlientRepo::onApplicationStateChanged(Qt::ApplicationState state)
+{
+   updateTimersInterval();
+
+   // Restoring a minimized window doesn't show its widgets again, but it activates the application.
+   if (state == Qt::ApplicationActive && isSeen())
+      catchUp();
+}
+
+void GitQlientRepo::catchUp()
+{
+   if (mGitWatcher)
+      mGitWatcher->setPaused(false);
+
+   if (mPendingFetch || mPendingCacheUpdate || mPendingWipUpdate)
+      QLog_Debug("UI", QString("Catching up with the changes of {%1} while it was hidden").arg(mCurrentDir));
+
+   // The fetch updates the cache by itself if the references change.
+   if (mPendingFetch)
+      mControls->autoFetch();
+
+   if (mPendingCacheUpdate && !mGitLoader->updateReferences())
+      updateCache();
+   else if (mPendingWipUpdate)
+      updateUiFromWatcher();
+
+   mPendingFetch = false;
+   mPendingCacheUpdate = false;
+   mPendingWipUpdate = false;
 }
 
 void GitQlientRepo::setRepository(const QString &newDir)
@@ -178,35 +388,41 @@ void GitQlientRepo::setRepository(const QString &newDir)
 
       mGitLoader->cancelAll();
 
-      const auto ok = mGitLoader->loadRepository();
+      const auto ok = mGitLoader->configureRepository();
 
       if (ok)
       {
+         mStartupTimer.start();
+         mStartup = StartupTimings();
+         mStartupStarted = false;
+
+         const auto generation = ++mStartupGeneration;
+
+         // The rows stored the last time are shown at once, and the history is loaded when the scheduler allows it:
+         // opening many repositories doesn't load all at once.
+         mGitLoader->loadWarmStart();
+         requestLoad(false);
+
          GitQlientSettings settings;
          settings.setProjectOpened(newDir);
 
          mCurrentDir = mGitBase->getWorkingDir();
          setWidgetsEnabled(true);
 
-         setWatcher();
-
-         mBlameWidget->init(newDir);
-
          mControls->enableButtons(true);
 
          mAutoFilesUpdate->start();
 
-         QScopedPointer<GitConfig> git(new GitConfig(mGitBase));
-
-         if (!git->getGlobalUserInfo().isValid() && !git->getLocalUserInfo().isValid())
+         // The watcher, the blame tree and the checks of the configuration wait for the history, so they don't delay
+         // it. If the load waits in the scheduler, they start after STARTUP_FALLBACK_MS anyway.
+         if (mStartup.historyMs >= 0)
+            startBackgroundStartup();
+         else
          {
-            QLog_Info("UI", QString("Configuring Git..."));
-
-            GitConfigDlg configDlg(mGitBase);
-
-            configDlg.exec();
-
-            QLog_Info("UI", QString("... Git configured!"));
+            QTimer::singleShot(STARTUP_FALLBACK_MS, this, [this, generation]() {
+               if (generation == mStartupGeneration)
+                  startBackgroundStartup();
+            });
          }
 
          QLog_Info("UI", "... repository loaded successfully");
@@ -230,26 +446,253 @@ void GitQlientRepo::setRepository(const QString &newDir)
    }
 }
 
-void GitQlientRepo::setWatcher()
+void GitQlientRepo::startBackgroundStartup()
 {
-   mGitWatcher = new QFileSystemWatcher(this);
-   connect(mGitWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path) {
-      if (!path.endsWith(".autosave") && !path.endsWith(".tmp") && !path.endsWith(".user"))
-         updateUiFromWatcher();
-   });
+   if (mStartupStarted)
+      return;
+
+   mStartupStarted = true;
+
+   const auto generation = mStartupGeneration;
+
+   QTimer::singleShot(0, this, [this, generation]() { runStartupStage(StartupStage::Watcher, generation); });
+}
+
+void GitQlientRepo::runStartupStage(StartupStage stage, int generation)
+{
+   if (generation != mStartupGeneration || mCurrentDir.isEmpty())
+      return;
+
+   switch (stage)
+   {
+      case StartupStage::Watcher:
+         setWatcher();
+         finishStartupStage(mStartup.watcherMs, "watcher");
+
+         QTimer::singleShot(0, this, [this, generation]() { runStartupStage(StartupStage::Blame, generation); });
+         break;
+      case StartupStage::Blame:
+         // The blame view is created with the tree the first time it's opened, this only updates the one that exists.
+         if (mBlameWidget)
+            mBlameWidget->init(mCurrentDir);
+
+         finishStartupStage(mStartup.blameMs, "blame");
+
+         QTimer::singleShot(0, this, [this, generation]() { runStartupStage(StartupStage::Config, generation); });
+         break;
+      case StartupStage::Config:
+         // Reading the configuration can take a while with many included files, it's read outside of the GUI thread.
+         mStartupWorker->post([this, generation]() {
+            GitConfig git(mGitBase);
+            const auto hasUserInfo = git.getGlobalUserInfo().isValid() || git.getLocalUserInfo().isValid();
+
+            QMetaObject::invokeMethod(
+                this, [this, generation, hasUserInfo]() { onConfigChecked(generation, hasUserInfo); },
+                Qt::QueuedConnection);
+         });
+         break;
+   }
+}
+
+void GitQlientRepo::onConfigChecked(int generation, bool hasUserInfo)
+{
+   if (generation != mStartupGeneration || mCurrentDir.isEmpty())
+      return;
+
+   // The time the user takes in the dialog is not part of the startup.
+   finishStartupStage(mStartup.configMs, "config");
+
+   if (!hasUserInfo)
+   {
+      QLog_Info("UI", QString("Configuring Git..."));
+
+      GitConfigDlg configDlg(mGitBase);
+
+      configDlg.exec();
+
+      QLog_Info("UI", QString("... Git configured!"));
+   }
+
+   offerFsmonitor();
+}
 
-   QLog_Info("UI", QString("Setting the file watcher for dir {%1}").arg(mCurrentDir));
+void GitQlientRepo::finishStartupStage(qint64 &stageMs, const QString &stage)
+{
+   stageMs = mStartupTimer.elapsed();
 
-   mGitWatcher->addPath(mCurrentDir);
+   QLog_Debug("UI", QString("Startup stage {%1} ready {%2} ms after opening the repository").arg(stage).arg(stageMs));
 
-   QDirIterator it(mCurrentDir, QDirIterator::Subdirectories);
-   while (it.hasNext())
+   if (mStartup.interactiveMs() >= 0)
    {
-      const auto dir = it.next();
+      QLog_Info("UI",
+                QString("Repository {%1} interactive {%2} ms after opening it (%3)")
+                    .arg(mCurrentDir)
+                    .arg(mStartup.interactiveMs())
+                    .arg(mStartup.toString()));
+   }
+}
 
-      if (it.fileInfo().isDir() && !dir.endsWith(".") && !dir.endsWith(".."))
-         mGitWatcher->addPath(dir);
+void GitQlientRepo::setWatcher()
+{
+   if (!mGitWatcher)
+   {
+      mGitWatcher = new GitWatcher(mGitBase, this);
+      connect(mGitWatcher, &GitWatcher::signalWorkingTreeChanged, this, &GitQlientRepo::onWorkingTreeChanged);
+      connect(mGitWatcher, &GitWatcher::signalRepositoryStateChanged, this,
+              &GitQlientRepo::onRepositoryStateChanged);
    }
+
+   mGitWatcher->start();
+}
+
+void GitQlientRepo::offerFsmonitor()
+{
+   const auto entries = GitRepositoryReader(mCurrentDir).indexEntries();
+   const auto declinedKey = QString("FsmonitorDeclined/%1").arg(QString::fromUtf8(mCurrentDir.toUtf8().toHex()));
+   GitQlientSettings settings;
+   QScopedPointer<GitConfig> git(new GitConfig(mGitBase));
+
+   if (entries < FSMONITOR_SUGGESTED_ENTRIES || settings.value(declinedKey, false).toBool()
+       || git->isFsmonitorEnabled())
+      return;
+
+   const auto answer = QMessageBox::question(
+       this, tr("Large repository"),
+       tr("The repository has %1 files. A file system monitor lets git check only the files that change instead of "
+          "the whole repository. Do you want to enable it?")
+           .arg(entries));
+
+   if (answer != QMessageBox::Yes)
+      settings.setValue(declinedKey, true);
+   else if (!git->enableFsmonitor())
+      QMessageBox::warning(this, tr("Large repository"),
+                           tr("The version of git installed doesn't have a file system monitor and Watchman was not "
+                              "found."));
+}
+
+void GitQlientRepo::adviseMaintenance()
+{
+   GitQlientSettings settings;
+   const auto mode = settings
+                         .repositoryValue(mCurrentDir, GitQlientSettings::MaintenanceKey,
+                                          GitQlientSettings::MaintenanceValue)
+                         .toString();
+
+   if (mode == QString("never") || mMaintenance->isRunning())
+      return;
+
+   const auto advice = mMaintenance->check();
+
+   if (advice.isEmpty())
+      return;
+
+   QLog_Info("UI", QString("The repository {%1} needs maintenance: %2").arg(mCurrentDir, advice.reasons.join(' ')));
+
+   if (mode != QString("background"))
+   {
+      // A structure out of date still covers most of the history: the user is only asked when one is missing.
+      if (advice.onlyStale)
+         return;
+
+      QMessageBox box(QMessageBox::Question, tr("Repository maintenance"),
+                      tr("Git can read this repository faster:\n\n%1\n\nDo you want to fix it in the background?")
+                          .arg(advice.reasons.join('\n')),
+                      QMessageBox::NoButton, this);
+      const auto runNow = box.addButton(tr("Fix it now"), QMessageBox::AcceptRole);
+      const auto always = box.addButton(tr("Always in the background"), QMessageBox::AcceptRole);
+      box.addButton(tr("Not for this repository"), QMessageBox::RejectRole);
+      box.exec();
+
+      if (box.clickedButton() == always)
+         settings.setValue(GitQlientSettings::MaintenanceKey, QString("background"));
+      else if (box.clickedButton() != runNow)
+      {
+         settings.setRepositoryValue(mCurrentDir, GitQlientSettings::MaintenanceKey, QString("never"));
+         return;
+      }
+   }
+
+   mMaintenance->start(advice);
+}
+
+void GitQlientRepo::applyRepositorySettings()
+{
+   GitQlientSettings settings;
+   const auto workingDir = mGitBase->getWorkingDir();
+   const auto value = [&settings, &workingDir](const QString &key, const QVariant &defaultValue) {
+      return settings.repositoryValue(workingDir, key, defaultValue);
+   };
+
+   mGitQlientCache->setMaxUntrackedFiles(
+       value(GitQlientSettings::MaxUntrackedFilesKey, GitQlientSettings::MaxUntrackedFilesValue).toInt());
+   mGitLoader->setCollapseUntrackedDirs(
+       value(GitQlientSettings::CollapseUntrackedDirsKey, GitQlientSettings::CollapseUntrackedDirsValue).toBool());
+   mGitLoader->setCommitGraphLoading(
+       value(GitQlientSettings::CommitGraphLoadingKey, GitQlientSettings::CommitGraphLoadingValue).toBool());
+   mGitLoader->setLazyCommitDetails(
+       value(GitQlientSettings::LazyCommitDetailsKey, GitQlientSettings::LazyCommitDetailsValue).toBool());
+   mGitLoader->setHistoryPageSize(
+       value(GitQlientSettings::HistoryPageSizeKey, GitQlientSettings::HistoryPageSizeValue).toInt());
+   mPollingFactor
+       = std::max(1, value(GitQlientSettings::PollingFactorKey, GitQlientSettings::PollingFactorValue).toInt());
+}
+
+void GitQlientRepo::suggestLargeRepositoryProfile()
+{
+   GitQlientSettings settings;
+
+   if (settings.hasRepositoryValue(mCurrentDir, GitQlientSettings::LargeRepositoryKey))
+      return;
+
+   // The commits are counted in the background: with the history loaded by pages the cache doesn't have all of them.
+   mGitBase->runAsync(
+       { "rev-list", "--count", "--all" }, this,
+       [this](const GitExecResult &ret) {
+          if (!ret.success)
+             return;
+
+          GitRepositoryReader reader(mCurrentDir);
+          QVector<GitRepositoryReader::Reference> references;
+          reader.readReferences(false, references);
+
+          const auto commits = ret.output.toString().trimmed().toInt();
+          const auto files = reader.indexEntries();
+
+          QLog_Info("UI",
+                    QString("The repository {%1} has {%2} commits, {%3} references and {%4} files.")
+                        .arg(mCurrentDir, QString::number(commits), QString::number(references.count()),
+                             QString::number(files)));
+
+          if (!GitQlientSettings::isLargeRepository(commits, references.count(), files))
+             return;
+
+          const auto answer = QMessageBox::question(
+              this, tr("Large repository"),
+              tr("The repository has %1 commits, %2 references and %3 files. GitQlient can use a profile for large "
+                 "repositories: the history is loaded by pages, the graph shows fewer lanes, the untracked files are "
+                 "limited and the repository is checked less often. Do you want to use it? It can be changed in the "
+                 "configuration of the repository.")
+                  .arg(commits)
+                  .arg(references.count())
+                  .arg(files));
+
+          GitQlientSettings settings;
+          settings.setRepositoryValue(mCurrentDir, GitQlientSettings::LargeRepositoryKey,
+                                      answer == QMessageBox::Yes);
+
+          if (answer != QMessageBox::Yes)
+             return;
+
+          QScopedPointer<GitConfig> git(new GitConfig(mGitBase));
+
+          if (!git->isFsmonitorEnabled() && !git->enableFsmonitor())
+             QLog_Warning("UI", QString("The file system monitor couldn't be enabled in {%1}.").arg(mCurrentDir));
+
+          applyRepositorySettings();
+          updateTimersInterval();
+          updateCache();
+       },
+       GitBase::Priority::Background);
 }
 
 void GitQlientRepo::clearWindow()
@@ -257,7 +700,9 @@ void GitQlientRepo::clearWindow()
    blockSignals(true);
 
    mHistoryWidget->clear();
-   mDiffWidget->clear();
+
+   if (mDiffWidget)
+      mDiffWidget->clear();
 
    blockSignals(false);
 }
@@ -266,53 +711,142 @@ void GitQlientRepo::setWidgetsEnabled(bool enabled)
 {
    mControls->enableButtons(enabled);
    mHistoryWidget->setEnabled(enabled);
-   mDiffWidget->setEnabled(enabled);
+
+   if (mDiffWidget)
+      mDiffWidget->setEnabled(enabled);
 }
 
 void GitQlientRepo::showFileHistory(const QString &fileName)
 {
-   mBlameWidget->showFileHistory(fileName);
+   blameWidget()->showFileHistory(fileName);
 
    showBlameView();
 }
 
-void GitQlientRepo::createProgressDialog(int total)
+void GitQlientRepo::onRevisionsChunkLoaded(int totalCommits)
+{
+   logFirstHistory();
+
+   mHistoryWidget->onRevisionsChunkLoaded(totalCommits);
+
+   if (mBlameWidget)
+      mBlameWidget->onRevisionsChunkLoaded(totalCommits);
+}
+
+void GitQlientRepo::onRepoLoadFinished()
 {
-   if (!mProgressDlg)
+   const auto totalCommits = mGitQlientCache->count();
+
+   logFirstHistory();
+
+   if (!mProfileChecked)
+   {
+      mProfileChecked = true;
+      suggestLargeRepositoryProfile();
+      adviseMaintenance();
+   }
+
+   mHistoryWidget->loadBranches();
+   mHistoryWidget->onNewRevisions(totalCommits);
+   mHistoryWidget->setHasMoreRevisions(mGitLoader->hasMoreRevisions());
+
+   if (mBlameWidget)
+      mBlameWidget->onNewRevisions(totalCommits);
+}
+
+void GitQlientRepo::loadMoreRevisions()
+{
+   // The page doesn't wait in the scheduler: the repository is the one shown and a load waiting there would be
+   // replaced. When another load is running, the view asks again once it finishes.
+   if (!mGitLoader->loadNextPage())
+      mHistoryWidget->setHasMoreRevisions(mGitLoader->hasMoreRevisions());
+}
+
+void GitQlientRepo::logFirstHistory()
+{
+   if (mOpenTimer.isValid())
+   {
+      QLog_Info("UI", QString("History shown {%1} ms after opening the repository").arg(mOpenTimer.elapsed()));
+
+      mOpenTimer.invalidate();
+   }
+
+   if (mStartupTimer.isValid() && mStartup.historyMs < 0)
    {
-      mProgressDlg = new ProgressDlg(tr("Loading repository..."), QString(), 0, total, false, true);
-      connect(mProgressDlg, &ProgressDlg::destroyed, this, [this]() { mProgressDlg = nullptr; });
+      finishStartupStage(mStartup.historyMs, "history");
 
-      mProgressDlg->show();
+      // Before the repository is set, the stages start at the end of the set.
+      if (!mCurrentDir.isEmpty())
+         startBackgroundStartup();
+   }
+}
 
-      QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+DiffWidget *GitQlientRepo::diffWidget()
+{
+   if (!mDiffWidget)
+   {
+      mDiffWidget = new DiffWidget(mGitBase, mGitQlientCache);
+      mDiffWidget->setEnabled(!mCurrentDir.isEmpty());
+      mStackedLayout->addWidget(mDiffWidget);
+
+      connect(mDiffWidget, &DiffWidget::signalShowFileHistory, this, &GitQlientRepo::showFileHistory);
+      connect(mDiffWidget, &DiffWidget::signalDiffEmpty, mControls, &Controls::disableDiff);
+      connect(mDiffWidget, &DiffWidget::signalDiffEmpty, this, &GitQlientRepo::showPreviousView);
+      connect(mDiffWidget, &DiffWidget::signalEditFile, this, &GitQlientRepo::signalEditFile);
+      connect(mDiffWidget, &DiffWidget::signalUpdateWipPaths, this, &GitQlientRepo::updateWipPaths);
+      connect(mDiffWidget, &DiffWidget::signalHighlightCommits, this, [this](const QVector<int> &rows) {
+         mHistoryWidget->highlightCommits(rows);
+         showHistoryView();
+      });
    }
+
+   return mDiffWidget;
 }
 
-void GitQlientRepo::updateProgressDialog(int step)
+BlameWidget *GitQlientRepo::blameWidget()
 {
-   if (mProgressDlg)
+   if (!mBlameWidget)
    {
-      mProgressDlg->setValue(step);
+      mBlameWidget = new BlameWidget(mGitQlientCache, mGitBase);
+      mStackedLayout->addWidget(mBlameWidget);
+
+      connect(mBlameWidget, &BlameWidget::showFileDiff, this, &GitQlientRepo::loadFileDiff);
+      connect(mBlameWidget, &BlameWidget::signalOpenDiff, this, &GitQlientRepo::openCommitCompareDiff);
+
+      if (!mCurrentDir.isEmpty())
+      {
+         mBlameWidget->init(mCurrentDir);
 
-      QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+         // The history loaded so far is given now, the rest comes with the end of the load.
+         if (mGitLoader->isLoading())
+            mBlameWidget->onRevisionsChunkLoaded(mGitQlientCache->count());
+         else
+            mBlameWidget->onNewRevisions(mGitQlientCache->count());
+      }
    }
+
+   return mBlameWidget;
 }
 
-void GitQlientRepo::onRepoLoadFinished()
+MergeWidget *GitQlientRepo::mergeWidget()
 {
-   mProgressDlg->close();
+   if (!mMergeWidget)
+   {
+      mMergeWidget = new MergeWidget(mGitQlientCache, mGitBase);
+      mStackedLayout->addWidget(mMergeWidget);
 
-   const auto totalCommits = mGitQlientCache->count();
+      connect(mMergeWidget, &MergeWidget::signalMergeFinished, this, &GitQlientRepo::showHistoryView);
+      connect(mMergeWidget, &MergeWidget::signalMergeFinished, this, &GitQlientRepo::updateCache);
+      connect(mMergeWidget, &MergeWidget::signalMergeFinished, mControls, &Controls::disableMergeWarning);
+      connect(mMergeWidget, &MergeWidget::signalEditFile, this, &GitQlientRepo::signalEditFile);
+   }
 
-   mHistoryWidget->loadBranches();
-   mHistoryWidget->onNewRevisions(totalCommits);
-   mBlameWidget->onNewRevisions(totalCommits);
+   return mMergeWidget;
 }
 
 void GitQlientRepo::loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file)
 {
-   const auto loaded = mDiffWidget->loadFileDiff(currentSha, previousSha, file);
+   const auto loaded = diffWidget()->loadFileDiff(currentSha, previousSha, file);
 
    if (loaded)
    {
@@ -329,11 +863,19 @@ void GitQlientRepo::showHistoryView()
    mControls->toggleButton(ControlsMainViews::HISTORY);
 }
 
+void GitQlientRepo::showCommit(const QString &sha)
+{
+   showHistoryView();
+
+   mHistoryWidget->focusOnCommit(sha);
+   mHistoryWidget->onCommitSelected(sha);
+}
+
 void GitQlientRepo::showBlameView()
 {
    mPreviousView = qMakePair(mControls->getCurrentSelectedButton(), mStackedLayout->currentWidget());
 
-   mStackedLayout->setCurrentWidget(mBlameWidget);
+   mStackedLayout->setCurrentWidget(blameWidget());
    mControls->toggleButton(ControlsMainViews::BLAME);
 }
 
@@ -341,7 +883,7 @@ void GitQlientRepo::showDiffView()
 {
    mPreviousView = qMakePair(mControls->getCurrentSelectedButton(), mStackedLayout->currentWidget());
 
-   mStackedLayout->setCurrentWidget(mDiffWidget);
+   mStackedLayout->setCurrentWidget(diffWidget());
    mControls->toggleButton(ControlsMainViews::DIFF);
 }
 
@@ -356,7 +898,7 @@ void GitQlientRepo::showWarningMerge()
 
    const auto file = mGitQlientCache->getRevisionFile(CommitInfo::ZERO_SHA, wipCommit.parent(0));
 
-   mMergeWidget->configure(file, MergeWidget::ConflictReason::Merge);
+   mergeWidget()->configure(file, MergeWidget::ConflictReason::Merge);
 }
 
 void GitQlientRepo::showCherryPickConflict()
@@ -370,7 +912,7 @@ void GitQlientRepo::showCherryPickConflict()
 
    const auto files = mGitQlientCache->getRevisionFile(CommitInfo::ZERO_SHA, wipCommit.parent(0));
 
-   mMergeWidget->configure(files, MergeWidget::ConflictReason::CherryPick);
+   mergeWidget()->configure(files, MergeWidget::ConflictReason::CherryPick);
 }
 
 void GitQlientRepo::showPullConflict()
@@ -384,12 +926,12 @@ void GitQlientRepo::showPullConflict()
 
    const auto files = mGitQlientCache->getRevisionFile(CommitInfo::ZERO_SHA, wipCommit.parent(0));
 
-   mMergeWidget->configure(files, MergeWidget::ConflictReason::Pull);
+   mergeWidget()->configure(files, MergeWidget::ConflictReason::Pull);
 }
 
 void GitQlientRepo::showMergeView()
 {
-   mStackedLayout->setCurrentWidget(mMergeWidget);
+   mStackedLayout->setCurrentWidget(mergeWidget());
    mControls->toggleButton(ControlsMainViews::MERGE);
 }
 
@@ -410,7 +952,7 @@ void GitQlientRepo::openCommitDiff(const QString currentSha)
 {
    const auto rev = mGitQlientCache->getCommitInfo(currentSha);
 
-   mDiffWidget->loadCommitDiff(currentSha, rev.parent(0));
+   diffWidget()->loadCommitDiff(currentSha, rev.parent(0));
    mControls->enableDiff();
 
    showDiffView();
@@ -418,7 +960,7 @@ void GitQlientRepo::openCommitDiff(const QString currentSha)
 
 void GitQlientRepo::openCommitCompareDiff(const QStringList &shas)
 {
-   mDiffWidget->loadCommitDiff(shas.last(), shas.first());
+   diffWidget()->loadCommitDiff(shas.last(), shas.first());
    mControls->enableDiff();
    showDiffView();
 }
@@ -427,7 +969,19 @@ void GitQlientRepo::changesCommitted(bool ok)
 {
    if (ok)
    {
-      updateCache();
+      // The new commit is added on top of the history, or replaces the one amended. The history is only loaded again
+      // when that's not possible.
+      RepoLoadScheduler::instance().requestLoad(this, [this]() {
+         if (!mGitLoader->loadCommittedRevision() && !mGitLoader->loadAmendedRevision())
+            mGitLoader->loadRepository();
+
+         if (!mGitLoader->isLoading())
+            RepoLoadScheduler::instance().loadFinished(this);
+      });
+
+      if (mDiffWidget)
+         mDiffWidget->reload();
+
       showHistoryView();
    }
    else
@@ -440,10 +994,108 @@ void GitQlientRepo::closeEvent(QCloseEvent *ce)
 
    mGitLoader->cancelAll();
 
+   RepoLoadScheduler::instance().cancel(this);
+
    QWidget::closeEvent(ce);
 }
 
-void GitRepoLoader::cancelAll()
+void GitQlientRepo::showEvent(QShowEvent *se)
+{
+   QFrame::showEvent(se);
+
+   mCompactTimer->stop();
+
+   // The caches freed are rebuilt while the repository is used.
+   if (mCachesCompacted)
+   {
+      mCachesCompacted = false;
+      logMemoryUsage("when shown again");
+   }
+
+   RepoLoadScheduler::instance().repositoryShown();
+
+   // The work of the repository shown goes before the one of the rest.
+   WorkerPool::instance().setForegroundRepository(mGitQlientCache.data());
+
+   catchUp();
+}
+
+void GitQlientRepo::hideEvent(QHideEvent *he)
+{
+   if (mGitWatcher)
+      mGitWatcher->setPaused(true);
+
+   // The caches of a repository that stays hidden are freed after a while.
+   if (mCompactTimer->interval() > 0)
+      mCompactTimer->start();
+
+   QFrame::hideEvent(he);
+}
+
+void GitQlientRepo::compactCaches()
+{
+   if (isVisible())
+      return;
+
+   logMemoryUsage("before freeing the caches");
+
+   if (!mGitQlientCache->compact())
+   {
+      QLog_Debug("UI", QString("The history of {%1} is being loaded: the caches are not freed.").arg(mCurrentDir));
+      return;
+   }
+
+   mCachesCompacted = true;
+
+   const auto freedDiffs = mDiffWidget ? mDiffWidget->compact() : 0;
+
+   QLog_Info("UI", QString("Freed the caches of {%1} and {%2} diffs after being hidden for {%3} minutes.")
+                       .arg(mCurrentDir, QString::number(freedDiffs),
+                            QString::number(mCompactTimer->interval() / 60000)));
+
+   logMemoryUsage("after freeing the caches");
+}
+
+RepositoryMetrics GitQlientRepo::metrics() const
+{
+   RepositoryMetrics metrics;
+   metrics.repository = mCurrentDir;
+   metrics.revisionFilesHits = mGitQlientCache->revisionFilesHits();
+   metrics.revisionFilesMisses = mGitQlientCache->revisionFilesMisses();
+   metrics.loading = mGitLoader->timings();
+   metrics.startup = mStartup;
+   metrics.memory = mGitQlientCache->memoryUsage();
+   metrics.memoryByStructure = mGitQlientCache->memoryReport();
+   metrics.diffsMemory = mDiffWidget ? mDiffWidget->memoryUsage() : 0;
+
+   if (const auto scheduler = mGitBase->getScheduler())
+   {
+      metrics.runningProcesses = scheduler->runningCount();
+      metrics.waitingProcesses = scheduler->queueDepth(GitBase::Priority::Interactive)
+          + scheduler->queueDepth(GitBase::Priority::Refresh) + scheduler->queueDepth(GitBase::Priority::Background);
+   }
+
+   if (const auto frames = mHistoryWidget->frameStatistics())
+      metrics.frameTimes = frames->frameTimes();
+
+   if (mGitWatcher)
+   {
+      metrics.watcherEvents = mGitWatcher->eventCount();
+      metrics.watchCount = mGitWatcher->watchCount();
+   }
+
+   return metrics;
+}
+
+void GitQlientRepo::logMemoryUsage(const QString &reason) const
 {
-   emit cancelAllProcesses(QPrivateSignal());
+   const auto usage = mGitQlientCache->memoryUsage();
+   const auto diffs = mDiffWidget ? mDiffWidget->memoryUsage() : 0;
+   const auto toKb = [](qint64 bytes) { return QString::number(bytes / 1024); };
+
+   QLog_Info("UI",
+             QString("Memory of {%1} %2: {%3} KB of commits, {%4} KB of lanes, {%5} KB of revisions files, {%6} KB of "
+                     "indexes and {%7} KB of diffs.")
+                 .arg(mCurrentDir, reason, toKb(usage.commits), toKb(usage.lanes), toKb(usage.revisionFiles),
+                      toKb(usage.indexes), toKb(diffs)));
 }
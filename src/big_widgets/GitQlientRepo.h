@@ -23,13 +23,20 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <PerformanceMetrics.h>
+
+#include <QElapsedTimer>
 #include <QFrame>
+#include <QScopedPointer>
 
 class GitBase;
 class RevisionsCache;
 class GitRepoLoader;
 class QCloseEvent;
-class QFileSystemWatcher;
+class QShowEvent;
+class QHideEvent;
+class GitWatcher;
+class GitMaintenance;
 class QStackedLayout;
 class Controls;
 class HistoryWidget;
@@ -37,7 +44,7 @@ class DiffWidget;
 class BlameWidget;
 class MergeWidget;
 class QTimer;
-class ProgressDlg;
+class WorkerQueue;
 
 enum class ControlsMainViews;
 
@@ -114,6 +121,16 @@ public:
     \param newDir The new repository to be opened.
    */
    void setRepository(const QString &newDir);
+   /*!
+    \brief Returns the cache of the history of the repository.
+   */
+   QSharedPointer<RevisionsCache> getCache() const { return mGitQlientCache; }
+   /*!
+    \brief Shows the history view with a commit selected.
+
+    \param sha The SHA of the commit.
+   */
+   void showCommit(const QString &sha);
 
 protected:
    /*!
@@ -122,8 +139,43 @@ protected:
     \param ce The close event.
    */
    void closeEvent(QCloseEvent *ce) override;
+   /*!
+    \brief Overload of the show event to resume the polling and catch up with the changes missed while hidden.
+
+    \param se The show event.
+   */
+   void showEvent(QShowEvent *se) override;
+   /*!
+    \brief Overload of the hide event to suspend the polling while the repository is not seen.
+
+    \param he The hide event.
+   */
+   void hideEvent(QHideEvent *he) override;
 
 private:
+   /*!
+    \brief The number of files of the index from which a file system monitor is offered.
+   */
+   static constexpr int FSMONITOR_SUGGESTED_ENTRIES = 100000;
+   /*!
+    \brief The times the intervals of the timers are multiplied by while GitQlient is not the active application.
+   */
+   static constexpr int INACTIVE_INTERVAL_FACTOR = 4;
+   /*!
+    \brief The time the startup stages that come after the history wait for it before they start anyway.
+   */
+   static constexpr int STARTUP_FALLBACK_MS = 1000;
+
+   /*!
+    \brief The stages of the startup that come after the history, in the order they run.
+   */
+   enum class StartupStage
+   {
+      Watcher,
+      Blame,
+      Config
+   };
+
    QString mCurrentDir;
    GitQlientRepoConfig mConfig;
    QSharedPointer<RevisionsCache> mGitQlientCache;
@@ -138,9 +190,85 @@ private:
    MergeWidget *mMergeWidget = nullptr;
    QTimer *mAutoFetch = nullptr;
    QTimer *mAutoFilesUpdate = nullptr;
-   ProgressDlg *mProgressDlg = nullptr;
-   QFileSystemWatcher *mGitWatcher = nullptr;
+   QTimer *mCompactTimer = nullptr;
+   GitWatcher *mGitWatcher = nullptr;
+   GitMaintenance *mMaintenance = nullptr;
+   bool mPendingFetch = false;
+   bool mPendingWipUpdate = false;
+   bool mPendingCacheUpdate = false;
+   bool mCachesCompacted = false;
+   bool mProfileChecked = false;
+   int mPollingFactor = 1;
    QPair<ControlsMainViews, QWidget *> mPreviousView;
+   QElapsedTimer mOpenTimer;
+   QElapsedTimer mStartupTimer;
+   StartupTimings mStartup;
+   int mStartupGeneration = 0;
+   bool mStartupStarted = false;
+   QScopedPointer<WorkerQueue> mStartupWorker;
+   int mMetricsId = 0;
+
+   /*!
+    \brief Returns the diff view, creating it the first time it's used.
+   */
+   DiffWidget *diffWidget();
+   /*!
+    \brief Returns the blame view, creating it the first time it's used. It's created with the history loaded so far.
+   */
+   BlameWidget *blameWidget();
+   /*!
+    \brief Returns the merge view, creating it the first time it's used.
+   */
+   MergeWidget *mergeWidget();
+   /*!
+    \brief Logs the time from the creation of the tab until the history is shown for the first time. It's also the end
+    of the history stage of the startup.
+   */
+   void logFirstHistory();
+   /*!
+    \brief Starts the stages that come after the history: the watcher, the blame tree and the checks of the
+    configuration. Every stage runs in its own turn of the event loop, so the history is painted and the user can use
+    it in between. It's called when the history is shown, or after STARTUP_FALLBACK_MS if it's not shown yet.
+   */
+   void startBackgroundStartup();
+   /*!
+    \brief Runs a stage of the startup and posts the next one.
+
+    \param stage The stage to run.
+    \param generation The startup the stage belongs to. It's ignored if the repository was set again since.
+   */
+   void runStartupStage(StartupStage stage, int generation);
+   /*!
+    \brief Ends the check of the configuration, read by the startup worker: it asks the user info if there is none and
+    offers the file system monitor.
+
+    \param generation The startup the check belongs to.
+    \param hasUserInfo True if the global or the local configuration has the user info.
+   */
+   void onConfigChecked(int generation, bool hasUserInfo);
+   /*!
+    \brief Stores the time a stage of the startup took since the repository was set, and logs the time until the
+    repository was interactive once all of them are done.
+
+    \param stageMs The timing of the stage.
+    \param stage The name of the stage.
+   */
+   void finishStartupStage(qint64 &stageMs, const QString &stage);
+   /*!
+    \brief Frees the memory of the caches that is rebuilt when it's needed again. It's called when the repository has
+    been hidden for the time configured.
+   */
+   void compactCaches();
+   /*!
+    \brief Logs the memory used by the caches of the repository.
+
+    \param reason Why the memory is logged.
+   */
+   void logMemoryUsage(const QString &reason) const;
+   /*!
+    \brief Reads the metrics of the repository for the performance page of the configuration.
+   */
+   RepositoryMetrics metrics() const;
 
    /*!
     \brief Updates the UI cache and refreshes the subwidgets.
@@ -148,10 +276,85 @@ private:
    */
    void updateCache();
    /*!
-    \brief Performs a light UI update triggered by the QFileSystemWatcher.
+    \brief Asks the RepoLoadScheduler to load the history of the repository.
+
+    \param configure True to find the repository and its current branch again before loading, otherwise false.
+   */
+   void requestLoad(bool configure);
+   /*!
+    \brief Performs a light UI update triggered by the GitWatcher.
 
    */
    void updateUiFromWatcher();
+   /*!
+    \brief Performs the UI update for the changes of some paths reported by the GitWatcher. Only those paths are asked
+    to git and updated in the WIP. If they can't be updated alone, the whole UI update is done.
+
+    \param paths The files or directories changed, relative to the root of the repository.
+   */
+   void updateWipPaths(const QStringList &paths);
+   /*!
+    \brief Tells if the repository is seen: the tab is the current one and the window is not minimized. The timers and
+    the watcher only record what changed when it's not.
+
+    \return True if the repository is seen, otherwise false.
+   */
+   bool isSeen() const;
+   /*!
+    \brief Sets the intervals of the timers from the configuration, slowing them down while the application is not
+    active.
+   */
+   void updateTimersInterval();
+   /*!
+    \brief Method called when the auto-fetch timer times out. The fetch is postponed if the repository is not seen.
+   */
+   void onAutoFetch();
+   /*!
+    \brief Method called when the files update timer times out. The update is postponed if the repository is not seen.
+   */
+   void onAutoFilesUpdate();
+   /*!
+    \brief Method called when the GitWatcher detects changes in the work tree. The update is postponed if the
+    repository is not seen.
+
+    \param paths The files or directories changed, relative to the root of the repository.
+   */
+   void onWorkingTreeChanged(const QStringList &paths);
+   /*!
+    \brief Method called when the GitWatcher detects changes in the references or the state of the repository. The
+    update is postponed if the repository is not seen. The cache is only updated completely if the history changed,
+    otherwise only the references are updated.
+   */
+   void onRepositoryStateChanged();
+   /*!
+    \brief Method called when a branch or a commit is checked out. Only the references and the WIP are updated when
+    the history doesn't change, otherwise the cache is updated.
+   */
+   void onCheckedOut();
+   /*!
+    \brief Method called when the current branch is pulled. A fast-forward only adds the new commits to the history,
+    otherwise the cache is updated.
+
+    \param previousHeadSha The SHA of HEAD before the pull.
+   */
+   void onPulled(const QString &previousHeadSha);
+   /*!
+    \brief Method called when the current branch is pushed. The commits pushed are already in the history, so only
+    the references that moved are updated in the graph and the branches. The cache is updated if that's not possible.
+   */
+   void onPushed();
+   /*!
+    \brief Method called when the application becomes active or inactive. It adapts the timers and catches up with
+    the postponed updates.
+
+    \param state The new state of the application.
+   */
+   void onApplicationStateChanged(Qt::ApplicationState state);
+   /*!
+    \brief Runs once the updates postponed while the repository was not seen. A pending update of the cache includes
+    the one of the WIP.
+   */
+   void catchUp();
    /*!
     \brief Opens the diff view with the selected commit from the repository view.
     \param currentSha The current selected commit SHA.
@@ -174,6 +377,25 @@ private:
 
    */
    void setWatcher();
+   /*!
+    \brief Offers to enable a file system monitor in the repositories with a big index, once per repository.
+   */
+   void offerFsmonitor();
+   /*!
+    \brief Looks for the commit-graph, the multi-pack-index and the untracked cache the repository is missing and,
+    depending on GitQlientSettings::MaintenanceKey, asks to write them or writes them in the background.
+   */
+   void adviseMaintenance();
+   /*!
+    \brief Reads the settings that a repository can change, with the large repository profile or its own values, and
+    gives them to the loader and the cache.
+   */
+   void applyRepositorySettings();
+   /*!
+    \brief Measures the repository after its first load and suggests the large repository profile if it has many
+    commits, references or files. It's suggested once per repository.
+   */
+   void suggestLargeRepositoryProfile();
    /*!
     \brief Clears the views and its subwidgets.
 
@@ -193,21 +415,19 @@ private:
    void showFileHistory(const QString &fileName);
 
    /*!
-    \brief Updates the progess dialog when loading a really huge repository.
-    \param total Total number of steps
+    \brief Updates the views while the repository is being loaded so the history is shown as soon as possible.
+    \param totalCommits Number of commits loaded so far.
    */
-   void createProgressDialog(int total);
-
-   /*!
-    \brief Updates the progess dialog when loading a really huge repository.
-    \param step Number of step
-   */
-   void updateProgressDialog(int step);
+   void onRevisionsChunkLoaded(int totalCommits);
    /*!
     \brief When the loading finishes this method closes and destroyes the dialog.
 
    */
    void onRepoLoadFinished();
+   /*!
+    \brief Loads the next page of a partial history when the graph view gets near its end.
+   */
+   void loadMoreRevisions();
    /*!
     \brief Loads the view to show the diff of a specific file.
 
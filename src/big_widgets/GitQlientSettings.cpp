@@ -1,17 +1,144 @@
 #include "GitQlientSettings.h"
 
+#include <SettingsStore.h>
+
+#include <QHash>
 #include <QVector>
 
 const QString GitQlientSettings::ExternalEditorKey = "externalEditor";
 const QString GitQlientSettings::ExternalEditorValue = "gedit";
+const QString GitQlientSettings::RevisionFilesCacheKey = "revisionFilesCacheMB";
+const int GitQlientSettings::RevisionFilesCacheValue = 64;
+const QString GitQlientSettings::MaxGitProcessesKey = "maxGitProcesses";
+const int GitQlientSettings::MaxGitProcessesValue = 4;
+const QString GitQlientSettings::BuiltinGitReadsKey = "builtinGitReads";
+const bool GitQlientSettings::BuiltinGitReadsValue = true;
+const QString GitQlientSettings::MaxUntrackedFilesKey = "maxUntrackedFiles";
+const int GitQlientSettings::MaxUntrackedFilesValue = 10000;
+const QString GitQlientSettings::CollapseUntrackedDirsKey = "collapseUntrackedDirs";
+const bool GitQlientSettings::CollapseUntrackedDirsValue = false;
+const QString GitQlientSettings::InactiveCompactMinutesKey = "inactiveCompactMinutes";
+const int GitQlientSettings::InactiveCompactMinutesValue = 10;
+const QString GitQlientSettings::HistoryOrderKey = "historyOrder";
+const QString GitQlientSettings::HistoryOrderValue = "date";
+const QString GitQlientSettings::CommitGraphLoadingKey = "commitGraphLoading";
+const bool GitQlientSettings::CommitGraphLoadingValue = false;
+const QString GitQlientSettings::LazyCommitDetailsKey = "lazyCommitDetails";
+const bool GitQlientSettings::LazyCommitDetailsValue = false;
+const QString GitQlientSettings::DiffDiskCacheKey = "diffDiskCache";
+const bool GitQlientSettings::DiffDiskCacheValue = false;
+const QString GitQlientSettings::DiffDiskCacheSizeMbKey = "diffDiskCacheSizeMb";
+const int GitQlientSettings::DiffDiskCacheSizeMbValue = 256;
+const QString GitQlientSettings::HistoryPageSizeKey = "historyPageSize";
+const int GitQlientSettings::HistoryPageSizeValue = 0;
+const QString GitQlientSettings::AsyncLogsKey = "asyncLogs";
+const bool GitQlientSettings::AsyncLogsValue = true;
+const QString GitQlientSettings::LogsOverflowKey = "logsOverflow";
+const QString GitQlientSettings::LogsOverflowValue = "count";
+const QString GitQlientSettings::LogsRateLimitKey = "logsRateLimit";
+const int GitQlientSettings::LogsRateLimitValue = 200;
+const QString GitQlientSettings::TraceEventsKey = "traceEvents";
+const bool GitQlientSettings::TraceEventsValue = false;
+const QString GitQlientSettings::LargeRepositoryKey = "largeRepository";
+const QString GitQlientSettings::PollingFactorKey = "pollingFactor";
+const int GitQlientSettings::PollingFactorValue = 1;
+const QString GitQlientSettings::MaintenanceKey = "repositoryMaintenance";
+const QString GitQlientSettings::MaintenanceValue = "ask";
+const QString GitQlientSettings::MemoryBudgetMbKey = "memoryBudgetMb";
+const int GitQlientSettings::MemoryBudgetMbValue = 0;
+const QString GitQlientSettings::MaxConcurrentTasksKey = "maxConcurrentTasks";
+const int GitQlientSettings::MaxConcurrentTasksValue = 0;
+
+namespace
+{
+QString repositoryKey(const QString &workingDir, const QString &key)
+{
+   return QString("Repositories/%1/%2").arg(QString::fromUtf8(workingDir.toUtf8().toHex()), key);
+}
+
+const QHash<QString, QVariant> &largeRepositoryProfile()
+{
+   // The history is loaded by pages and in two phases, the graph has a maximum of lanes and the WIP lists the
+   // untracked directories instead of their files.
+   static const QHash<QString, QVariant> profile {
+      { GitQlientSettings::HistoryPageSizeKey, 20000 },
+      { GitQlientSettings::CommitGraphLoadingKey, true },
+      { GitQlientSettings::LazyCommitDetailsKey, true },
+      { "graphMaxLanes", 40 },
+      { GitQlientSettings::MaxUntrackedFilesKey, 2000 },
+      { GitQlientSettings::CollapseUntrackedDirsKey, true },
+      { GitQlientSettings::PollingFactorKey, 4 },
+   };
+
+   return profile;
+}
+}
+
+QVariant GitQlientSettings::value(const QString &key, const QVariant &defaultValue) const
+{
+   return SettingsStore::instance().value(key, defaultValue);
+}
 
 void GitQlientSettings::setValue(const QString &key, const QVariant &value)
 {
-   QSettings::setValue(key, value);
+   SettingsStore::instance().setValue(key, value);
 
    emit valueChanged(key, value);
 }
 
+void GitQlientSettings::remove(const QString &key)
+{
+   SettingsStore::instance().remove(key);
+}
+
+QVariant GitQlientSettings::repositoryValue(const QString &workingDir, const QString &key,
+                                           const QVariant &defaultValue) const
+{
+   if (const auto ownValue = value(repositoryKey(workingDir, key)); ownValue.isValid())
+      return ownValue;
+
+   if (key != LargeRepositoryKey && value(repositoryKey(workingDir, LargeRepositoryKey), false).toBool())
+   {
+      if (const auto profileValue = largeRepositoryValue(key); profileValue.isValid())
+         return profileValue;
+   }
+
+   return value(key, defaultValue);
+}
+
+bool GitQlientSettings::hasRepositoryValue(const QString &workingDir, const QString &key) const
+{
+   return value(repositoryKey(workingDir, key)).isValid();
+}
+
+void GitQlientSettings::setRepositoryValue(const QString &workingDir, const QString &key, const QVariant &value)
+{
+   setValue(repositoryKey(workingDir, key), value);
+}
+
+void GitQlientSettings::removeRepositoryValue(const QString &workingDir, const QString &key)
+{
+   remove(repositoryKey(workingDir, key));
+}
+
+QStringList GitQlientSettings::largeRepositoryKeys()
+{
+   // The order of the configuration of the repositories.
+   return { HistoryPageSizeKey,   CommitGraphLoadingKey,    LazyCommitDetailsKey, "graphMaxLanes",
+            MaxUntrackedFilesKey, CollapseUntrackedDirsKey, PollingFactorKey };
+}
+
+QVariant GitQlientSettings::largeRepositoryValue(const QString &key)
+{
+   return largeRepositoryProfile().value(key);
+}
+
+bool GitQlientSettings::isLargeRepository(int commits, int references, int files)
+{
+   return commits >= LARGE_REPOSITORY_COMMITS || references >= LARGE_REPOSITORY_REFERENCES
+       || files >= LARGE_REPOSITORY_FILES;
+}
+
 void GitQlientSettings::setProjectOpened(const QString &projectPath)
 {
    saveMostUsedProjects(projectPath);
@@ -21,7 +148,7 @@ void GitQlientSettings::setProjectOpened(const QString &projectPath)
 
 QStringList GitQlientSettings::getRecentProjects() const
 {
-   auto projects = QSettings::value("Config/RecentProjects", QStringList()).toStringList();
+   auto projects = value("Config/RecentProjects", QStringList()).toStringList();
 
    QStringList recentProjects;
    const auto end = std::min(projects.count(), 5);
@@ -34,7 +161,7 @@ QStringList GitQlientSettings::getRecentProjects() const
 
 void GitQlientSettings::saveRecentProjects(const QString &projectPath)
 {
-   auto usedProjects = QSettings::value("Config/RecentProjects", QStringList()).toStringList();
+   auto usedProjects = value("Config/RecentProjects", QStringList()).toStringList();
 
    if (usedProjects.contains(projectPath))
    {
@@ -57,8 +184,8 @@ void GitQlientSettings::clearRecentProjects()
 
 void GitQlientSettings::saveMostUsedProjects(const QString &projectPath)
 {
-   auto projects = QSettings::value("Config/UsedProjects", QStringList()).toStringList();
-   auto timesUsed = QSettings::value("Config/UsedProjectsCount", QList<QVariant>()).toList();
+   auto projects = value("Config/UsedProjects", QStringList()).toStringList();
+   auto timesUsed = value("Config/UsedProjectsCount", QList<QVariant>()).toList();
 
    if (projects.contains(projectPath))
    {
@@ -83,8 +210,8 @@ void GitQlientSettings::clearMostUsedProjects()
 
 QStringList GitQlientSettings::getMostUsedProjects() const
 {
-   const auto projects = QSettings::value("Config/UsedProjects", QStringList()).toStringList();
-   const auto timesUsed = QSettings::value("Config/UsedProjectsCount", QString()).toList();
+   const auto projects = value("Config/UsedProjects", QStringList()).toStringList();
+   const auto timesUsed = value("Config/UsedProjectsCount", QString()).toList();
 
    QMultiMap<int, QString> projectOrderedByUse;
 
@@ -23,15 +23,17 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QSettings>
+#include <QObject>
+#include <QVariant>
 #include <QVector>
 
 /*!
- \brief The GitQlientSettings is an overloaded implementation of the QSettings that tries to help the user when a config
- parameter is modified by triggering a signal to notify the UI.
+ \brief The GitQlientSettings gives access to the settings of the application, that are kept in the SettingsStore, and
+ tries to help the user when a config parameter is modified by triggering a signal to notify the UI. The changes are
+ written to disk in the background.
 
 */
-class GitQlientSettings : public QSettings
+class GitQlientSettings : public QObject
 {
    Q_OBJECT
 
@@ -52,6 +54,14 @@ public:
    */
    GitQlientSettings() = default;
 
+   /*!
+    \brief Returns the value for a given \p key.
+
+    \param key The key.
+    \param defaultValue The value returned if the key doesn't exist.
+    \return QVariant The value.
+   */
+   QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
    /*!
     \brief Sets a value for a given \p key.
 
@@ -59,6 +69,12 @@ public:
     \param value The new value for the key.
    */
    void setValue(const QString &key, const QVariant &value);
+   /*!
+    \brief Removes a given \p key and the keys under it.
+
+    \param key The key.
+   */
+   void remove(const QString &key);
    /*!
     \brief Stores that a project is opened. This is used to recalculate which projects are the most used.
 
@@ -98,6 +114,74 @@ public:
     */
    QStringList getMostUsedProjects() const;
 
+   /*!
+    \brief Returns the value of a setting for a repository: the value set for the repository if there is one. If not
+    and the repository uses the large repository profile, the value of the profile when it changes the key. Otherwise
+    the value of the application.
+
+    \param workingDir The working directory of the repository.
+    \param key The key.
+    \param defaultValue The value returned if the key doesn't exist.
+    \return QVariant The value.
+   */
+   QVariant repositoryValue(const QString &workingDir, const QString &key,
+                            const QVariant &defaultValue = QVariant()) const;
+   /*!
+    \brief Tells if a repository has its own value for a given \p key.
+
+    \param workingDir The working directory of the repository.
+    \param key The key.
+   */
+   bool hasRepositoryValue(const QString &workingDir, const QString &key) const;
+   /*!
+    \brief Sets the value of a given \p key only for a repository.
+
+    \param workingDir The working directory of the repository.
+    \param key The key.
+    \param value The new value for the key.
+   */
+   void setRepositoryValue(const QString &workingDir, const QString &key, const QVariant &value);
+   /*!
+    \brief Removes the value of a given \p key of a repository, so it takes again the one of the profile or of the
+    application.
+
+    \param workingDir The working directory of the repository.
+    \param key The key.
+   */
+   void removeRepositoryValue(const QString &workingDir, const QString &key);
+   /*!
+    \brief Returns the keys that the large repository profile changes.
+   */
+   static QStringList largeRepositoryKeys();
+   /*!
+    \brief Returns the value of a key in the large repository profile.
+
+    \param key The key.
+    \return The value, or an invalid QVariant if the profile doesn't change the key.
+   */
+   static QVariant largeRepositoryValue(const QString &key);
+   /*!
+    \brief Tells if a repository is large enough to suggest the large repository profile.
+
+    \param commits The number of commits of the repository.
+    \param references The number of references.
+    \param files The number of files of the index.
+   */
+   static bool isLargeRepository(int commits, int references, int files);
+
+   /*!
+    \brief The number of commits from which a repository is large.
+   */
+   static constexpr int LARGE_REPOSITORY_COMMITS = 200000;
+   /*!
+    \brief The number of references from which a repository is large.
+   */
+   static constexpr int LARGE_REPOSITORY_REFERENCES = 10000;
+   /*!
+    \brief The number of files of the index from which a repository is large.
+   */
+   static constexpr int LARGE_REPOSITORY_FILES = 100000;
+
    /**
     * @brief ExternalEditorKey The key for the external editor settings.
     */
@@ -106,4 +190,185 @@ public:
     * @brief ExternalEditorValue The value for the external editor settings key.
     */
    static const QString ExternalEditorValue;
+   /**
+    * @brief RevisionFilesCacheKey The key for the memory budget, in MB, of the files cached for every repository.
+    */
+   static const QString RevisionFilesCacheKey;
+   /**
+    * @brief RevisionFilesCacheValue The default value for the memory budget of the files cache.
+    */
+   static const int RevisionFilesCacheValue;
+   /**
+    * @brief MaxGitProcessesKey The key for the maximum number of asynchronous git processes running at the same time
+    * for every repository.
+    */
+   static const QString MaxGitProcessesKey;
+   /**
+    * @brief MaxGitProcessesValue The default value for the maximum number of asynchronous git processes.
+    */
+   static const int MaxGitProcessesValue;
+   /**
+    * @brief BuiltinGitReadsKey The key to read HEAD and the references from the repository files instead of starting
+    * git.
+    */
+   static const QString BuiltinGitReadsKey;
+   /**
+    * @brief BuiltinGitReadsValue The default value for the built-in reads.
+    */
+   static const bool BuiltinGitReadsValue;
+   /**
+    * @brief MaxUntrackedFilesKey The key for the maximum number of untracked files listed in the WIP.
+    */
+   static const QString MaxUntrackedFilesKey;
+   /**
+    * @brief MaxUntrackedFilesValue The default value for the maximum number of untracked files.
+    */
+   static const int MaxUntrackedFilesValue;
+   /**
+    * @brief CollapseUntrackedDirsKey The key to list the untracked directories as a whole instead of their files.
+    */
+   static const QString CollapseUntrackedDirsKey;
+   /**
+    * @brief CollapseUntrackedDirsValue The default value for the collapse of the untracked directories.
+    */
+   static const bool CollapseUntrackedDirsValue;
+   /**
+    * @brief InactiveCompactMinutesKey The key for the minutes a repository has to be hidden before the memory of its
+    * caches that can be rebuilt is freed. Zero disables it.
+    */
+   static const QString InactiveCompactMinutesKey;
+   /**
+    * @brief InactiveCompactMinutesValue The default value for the minutes before the caches of a hidden repository are
+    * freed.
+    */
+   static const int InactiveCompactMinutesValue;
+   /**
+    * @brief HistoryOrderKey The key for the order of the history: "date", "topo" or "first-parent".
+    */
+   static const QString HistoryOrderKey;
+   /**
+    * @brief HistoryOrderValue The default value for the order of the history.
+    */
+   static const QString HistoryOrderValue;
+   /**
+    * @brief CommitGraphLoadingKey The key to load the topology of the history from the commit-graph of git, when the
+    * repository has one, and to read the authors and the logs only for the rows shown.
+    */
+   static const QString CommitGraphLoadingKey;
+   /**
+    * @brief CommitGraphLoadingValue The default value for the load from the commit-graph.
+    */
+   static const bool CommitGraphLoadingValue;
+   /**
+    * @brief LazyCommitDetailsKey The key to read only the topology and the short logs of the history with git log, and
+    * the authors and the long logs only for the rows shown.
+    */
+   static const QString LazyCommitDetailsKey;
+   /**
+    * @brief LazyCommitDetailsValue The default value for the lazy read of the details of the commits.
+    */
+   static const bool LazyCommitDetailsValue;
+   /**
+    * @brief DiffDiskCacheKey The key to store the diffs between two commits in the git directory of the repositories,
+    * so they are not run again in the next sessions.
+    */
+   static const QString DiffDiskCacheKey;
+   /**
+    * @brief DiffDiskCacheValue The default value for the disk cache of the diffs.
+    */
+   static const bool DiffDiskCacheValue;
+   /**
+    * @brief DiffDiskCacheSizeMbKey The key for the size, in MB, the diffs stored of a repository can take.
+    */
+   static const QString DiffDiskCacheSizeMbKey;
+   /**
+    * @brief DiffDiskCacheSizeMbValue The default value for the size of the disk cache of the diffs.
+    */
+   static const int DiffDiskCacheSizeMbValue;
+   /**
+    * @brief HistoryPageSizeKey The key for the number of commits the history loads at first and every time the view
+    * scrolls near its end. 0 loads the whole history.
+    */
+   static const QString HistoryPageSizeKey;
+   /**
+    * @brief HistoryPageSizeValue The default value for the commits of every page of the history.
+    */
+   static const int HistoryPageSizeValue;
+   /**
+    * @brief AsyncLogsKey The key to give the log messages of the hot paths to a background writer.
+    */
+   static const QString AsyncLogsKey;
+   /**
+    * @brief AsyncLogsValue The default value for the background writer of the log.
+    */
+   static const bool AsyncLogsValue;
+   /**
+    * @brief LogsOverflowKey The key for what is done with the messages when the writer falls behind: "drop" loses
+    * them silently and "count" logs how many were lost.
+    */
+   static const QString LogsOverflowKey;
+   /**
+    * @brief LogsOverflowValue The default value for the overflow of the messages.
+    */
+   static const QString LogsOverflowValue;
+   /**
+    * @brief LogsRateLimitKey The key for the maximum number of messages of a module the writer logs per second. 0
+    * doesn't limit them.
+    */
+   static const QString LogsRateLimitKey;
+   /**
+    * @brief LogsRateLimitValue The default value for the messages per second.
+    */
+   static const int LogsRateLimitValue;
+   /**
+    * @brief TraceEventsKey The key to record the timeline of the loads and refreshes from the start, so the first load
+    * of the repositories can be exported from the performance page.
+    */
+   static const QString TraceEventsKey;
+   /**
+    * @brief TraceEventsValue The default value for the recording of the timeline.
+    */
+   static const bool TraceEventsValue;
+   /**
+    * @brief LargeRepositoryKey The key, set only for the repositories, that tells if a repository uses the large
+    * repository profile. It doesn't exist until the profile is suggested or set in the configuration of the
+    * repository.
+    */
+   static const QString LargeRepositoryKey;
+   /**
+    * @brief PollingFactorKey The key for the times the intervals of the auto-fetch and the auto-update of the WIP are
+    * multiplied by.
+    */
+   static const QString PollingFactorKey;
+   /**
+    * @brief PollingFactorValue The default value for the factor of the polling intervals.
+    */
+   static const int PollingFactorValue;
+   /**
+    * @brief MaintenanceKey The key for what is done when a repository needs a commit-graph, a multi-pack-index or the
+    * untracked cache: "ask", "background" to write them without asking, or "never".
+    */
+   static const QString MaintenanceKey;
+   /**
+    * @brief MaintenanceValue The default value for the maintenance of the repositories.
+    */
+   static const QString MaintenanceValue;
+   /**
+    * @brief MemoryBudgetMbKey The key for the memory, in MB, all the caches of GitQlient can use together. 0 only
+    * limits every cache with its own budget.
+    */
+   static const QString MemoryBudgetMbKey;
+   /**
+    * @brief MemoryBudgetMbValue The default value for the global memory budget.
+    */
+   static const int MemoryBudgetMbValue;
+   /**
+    * @brief MaxConcurrentTasksKey The key for the number of background tasks that run at the same time. 0 runs one
+    * per core.
+    */
+   static const QString MaxConcurrentTasksKey;
+   /**
+    * @brief MaxConcurrentTasksValue The default value for the number of tasks that run at the same time.
+    */
+   static const int MaxConcurrentTasksValue;
 };
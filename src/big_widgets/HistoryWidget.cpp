@@ -8,12 +8,18 @@
 #include <AmendWidget.h>
 #include <CommitInfoWidget.h>
 #include <CommitInfo.h>
+#include <RevisionsCache.h>
+#include <RevisionsSearchIndex.h>
+#include <RevisionsSearcher.h>
+#include <RevisionsSnapshot.h>
 #include <GitQlientSettings.h>
 #include <GitBase.h>
 #include <GitBranches.h>
 #include <GitRepoLoader.h>
 #include <GitRemote.h>
 #include <GitMerge.h>
+#include <GitPickaxeSearch.h>
+#include <GitFilesPrefetch.h>
 
 #include <QLogger.h>
 
@@ -21,11 +27,24 @@
 #include <QLineEdit>
 #include <QStackedWidget>
 #include <QCheckBox>
+#include <QLabel>
+#include <QTimer>
 #include <QMessageBox>
 #include <QApplication>
+#include <QRegularExpression>
+#include <QDateTime>
+
+#include <algorithm>
 
 using namespace QLogger;
 
+namespace
+{
+const int LOADING_STATUS_TIMEOUT_MS = 5000;
+// The details of a commit are shown once the selection stops moving through the rows.
+const int SELECTION_DELAY_MS = 150;
+}
+
 HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> git,
                              QWidget *parent)
    : QFrame(parent)
@@ -40,9 +59,22 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    , mAmendWidget(new AmendWidget(mCache, git))
    , mCommitInfoWidget(new CommitInfoWidget(mCache, git))
    , mChShowAllBranches(new QCheckBox(tr("Show all branches")))
+   , mLoadingStatus(new QLabel())
+   , mSearchIndex(new RevisionsSearchIndex(mCache, this))
+   , mSearcher(new RevisionsSearcher(mCache.data(), this))
+   , mContentSearch(new GitPickaxeSearch(git, this))
+   , mFilesPrefetch(new GitFilesPrefetch(git, mCache, this))
+   , mSelectionTimer(new QTimer(this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
+   mSelectionTimer->setSingleShot(true);
+   mSelectionTimer->setInterval(SELECTION_DELAY_MS);
+   connect(mSelectionTimer, &QTimer::timeout, this, [this]() {
+      if (const auto index = mRepositoryView->currentIndex(); index.isValid())
+         commitSelected(index);
+   });
+
    mCommitStackedWidget->setCurrentIndex(0);
    mCommitStackedWidget->addWidget(mCommitInfoWidget);
    mCommitStackedWidget->addWidget(mWipWidget);
@@ -55,6 +87,7 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    connect(mWipWidget, &WipWidget::signalCheckoutPerformed, this, &HistoryWidget::signalUpdateUi);
    connect(mWipWidget, &WipWidget::signalShowFileHistory, this, &HistoryWidget::signalShowFileHistory);
    connect(mWipWidget, &WipWidget::signalUpdateWip, this, &HistoryWidget::signalUpdateWip);
+   connect(mWipWidget, &WipWidget::signalUpdateWipPaths, this, &HistoryWidget::signalUpdateWipPaths);
    connect(mWipWidget, &WipWidget::signalCancelAmend, this, &HistoryWidget::onCommitSelected);
 
    connect(mAmendWidget, &AmendWidget::signalEditFile, this, &HistoryWidget::signalEditFile);
@@ -63,16 +96,29 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    connect(mAmendWidget, &AmendWidget::signalCheckoutPerformed, this, &HistoryWidget::signalUpdateUi);
    connect(mAmendWidget, &AmendWidget::signalShowFileHistory, this, &HistoryWidget::signalShowFileHistory);
    connect(mAmendWidget, &AmendWidget::signalUpdateWip, this, &HistoryWidget::signalUpdateWip);
+   connect(mAmendWidget, &AmendWidget::signalUpdateWipPaths, this, &HistoryWidget::signalUpdateWipPaths);
    connect(mAmendWidget, &AmendWidget::signalCancelAmend, this, &HistoryWidget::onCommitSelected);
 
    connect(mCommitInfoWidget, &CommitInfoWidget::signalOpenFileCommit, this, &HistoryWidget::signalShowDiff);
    connect(mCommitInfoWidget, &CommitInfoWidget::signalShowFileHistory, this, &HistoryWidget::signalShowFileHistory);
    connect(mCommitInfoWidget, &CommitInfoWidget::signalEditFile, this, &HistoryWidget::signalEditFile);
 
-   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or log message..."));
+   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA, log message or date..."));
+   mSearchInput->setToolTip(tr("<p>Search by:</p><ul><li>SHA (or the beginning of it)</li><li>Log message</li>"
+                               "<li>Date: <b>yyyy-mm-dd</b></li><li>Regular expression in the log: <b>/expression/</b>"
+                               "</li><li>Content added or removed: <b>-S text</b></li>"
+                               "<li>Content changed, as regular expression: <b>-G expression</b></li></ul>"));
    connect(mSearchInput, &QLineEdit::returnPressed, this, &HistoryWidget::search);
+   connect(mSearcher, &RevisionsSearcher::signalNextMatch, this, &HistoryWidget::onSearchNextMatch);
+   connect(mSearcher, &RevisionsSearcher::signalMatchesFound, this, &HistoryWidget::onSearchMatchesFound);
+   connect(mContentSearch, &GitPickaxeSearch::signalMatchesFound, this, &HistoryWidget::onContentMatchesFound);
+   connect(mContentSearch, &GitPickaxeSearch::signalFinished, this, [this]() {
+      mLoadingStatus->setText(tr("Content search: %1 commits").arg(mContentMatches.count()));
+      QTimer::singleShot(LOADING_STATUS_TIMEOUT_MS, mLoadingStatus, &QLabel::hide);
+   });
 
    connect(mRepositoryView, &CommitHistoryView::signalViewUpdated, this, &HistoryWidget::signalViewUpdated);
+   connect(mRepositoryView, &CommitHistoryView::signalCheckedOut, this, &HistoryWidget::signalCheckedOut);
    connect(mRepositoryView, &CommitHistoryView::signalOpenDiff, this, &HistoryWidget::signalOpenDiff);
    connect(mRepositoryView, &CommitHistoryView::signalOpenCompareDiff, this, &HistoryWidget::signalOpenCompareDiff);
    connect(mRepositoryView, &CommitHistoryView::clicked, this, &HistoryWidget::commitSelected);
@@ -89,6 +135,16 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
 
    mRepositoryView->setObjectName("historyGraphView");
    mRepositoryView->setModel(mRepositoryModel);
+
+   // The keys move the current row: the files of the commits around it are read before they are selected.
+   connect(mRepositoryView->selectionModel(), &QItemSelectionModel::currentRowChanged, this,
+           [this](const QModelIndex &current) {
+              prefetchFilesAround(current.row());
+              mSelectionTimer->start();
+           });
+
+   connect(mRepositoryModel, &CommitHistoryModel::signalMoreRevisionsRequested, this,
+           &HistoryWidget::signalMoreRevisionsRequested);
    mRepositoryView->setItemDelegate(mItemDelegate = new RepositoryViewDelegate(cache, git, mRepositoryView));
    mRepositoryView->setEnabled(true);
 
@@ -110,8 +166,11 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    graphOptionsLayout->setContentsMargins(QMargins());
    graphOptionsLayout->setSpacing(10);
    graphOptionsLayout->addWidget(mSearchInput);
+   graphOptionsLayout->addWidget(mLoadingStatus);
    graphOptionsLayout->addWidget(mChShowAllBranches);
 
+   mLoadingStatus->setVisible(false);
+
    const auto viewLayout = new QVBoxLayout();
    viewLayout->setContentsMargins(QMargins());
    viewLayout->setSpacing(5);
@@ -165,11 +224,36 @@ void HistoryWidget::updateUiFromWatcher()
       mAmendWidget->reload();
 }
 
+void HistoryWidget::updateWipPaths(const QStringList &paths)
+{
+   const auto commitStackedIndex = mCommitStackedWidget->currentIndex();
+
+   if (commitStackedIndex == 1)
+      mWipWidget->updatePaths(paths);
+   else if (commitStackedIndex == 2)
+      mAmendWidget->reload();
+}
+
+FrameStatistics *HistoryWidget::frameStatistics() const
+{
+   return mRepositoryView->frameStatistics();
+}
+
 void HistoryWidget::focusOnCommit(const QString &sha)
 {
    mRepositoryView->focusOnCommit(sha);
 }
 
+void HistoryWidget::highlightCommits(const QVector<int> &rows)
+{
+   mContentSearchText.clear();
+   mContentMatches = rows;
+   mRepositoryView->setHighlightedRows(mContentMatches);
+
+   if (!rows.isEmpty())
+      goToSha(mCache->getCommitInfoByRow(rows.constFirst()).sha());
+}
+
 QString HistoryWidget::getCurrentSha() const
 {
    return mRepositoryView->getCurrentSha();
@@ -178,6 +262,8 @@ QString HistoryWidget::getCurrentSha() const
 void HistoryWidget::onNewRevisions(int totalCommits)
 {
    mRepositoryModel->onNewRevisions(totalCommits);
+   mSearchIndex->rebuild();
+   mRepositoryView->updateDateMarkers();
 
    onCommitSelected(CommitInfo::ZERO_SHA);
 
@@ -186,6 +272,53 @@ void HistoryWidget::onNewRevisions(int totalCommits)
        QItemSelectionModel::Select);
 }
 
+void HistoryWidget::onReferencesUpdated(const QStringList &shas)
+{
+   mRepositoryModel->onReferencesUpdated(shas);
+   mRepositoryView->updateOverview();
+   mBranchesWidget->showBranches();
+}
+
+void HistoryWidget::onHeadMoved()
+{
+   mRepositoryModel->onLanesChanged();
+   updateUiFromWatcher();
+}
+
+void HistoryWidget::setHasMoreRevisions(bool moreRevisions)
+{
+   mRepositoryModel->setHasMoreRevisions(moreRevisions);
+}
+
+void HistoryWidget::onPageLoaded(int totalCommits, bool moreRevisions)
+{
+   mRepositoryModel->onNewRevisions(totalCommits);
+   mRepositoryModel->setHasMoreRevisions(moreRevisions);
+   mSearchIndex->rebuild();
+   mRepositoryView->updateDateMarkers();
+}
+
+void HistoryWidget::onRevisionsChunkLoaded(int totalCommits)
+{
+   mRepositoryModel->onRevisionsChunkLoaded(totalCommits);
+}
+
+void HistoryWidget::onLoadingProgress(int loadedCommits)
+{
+   mLoadingStatus->setText(tr("Loading history: %1 commits").arg(loadedCommits));
+   mLoadingStatus->setToolTip(QString());
+   mLoadingStatus->setVisible(true);
+}
+
+void HistoryWidget::onLoadingTimings(const LoadingTimings &timings)
+{
+   mLoadingStatus->setText(tr("History loaded in %1 ms").arg(timings.totalMs));
+   mLoadingStatus->setToolTip(timings.toString());
+   mLoadingStatus->setVisible(true);
+
+   QTimer::singleShot(LOADING_STATUS_TIMEOUT_MS, mLoadingStatus, &QLabel::hide);
+}
+
 void HistoryWidget::search()
 {
    const auto text = mSearchInput->text();
@@ -205,15 +338,143 @@ void HistoryWidget::search()
          {
             std::sort(selectedItems.begin(), selectedItems.end(),
                       [](const QModelIndex index1, const QModelIndex index2) { return index1.row() <= index2.row(); });
-            startingRow = selectedItems.constFirst().row();
+            startingRow = mRepositoryView->sourceRow(selectedItems.constFirst().row());
          }
 
-         commitInfo = mCache->getCommitInfoByField(CommitInfo::Field::SHORT_LOG, text, startingRow + 1);
+         const auto date = QDate::fromString(text, Qt::ISODate);
+
+         // A date goes to the newest commit done until the end of that day.
+         if (date.isValid())
+         {
+            const auto row = mCache->findRowByDate(QDateTime(date.addDays(1), QTime(0, 0)).toSecsSinceEpoch() - 1);
+            commitInfo = mCache->getCommitInfoByRow(row);
 
-         if (commitInfo.isValid())
-            goToSha(commitInfo.sha());
+            if (commitInfo.isValid())
+               goToSha(commitInfo.sha());
+         }
+         // The content searches are done by git, so they go to the first match when it arrives.
+         else if (text.startsWith("-S ") || text.startsWith("-G "))
+            searchContent(text, startingRow);
+         // A text between slashes is a regular expression that is matched against the full log message.
+         else if (text.size() > 2 && text.startsWith('/') && text.endsWith('/'))
+         {
+            const QRegularExpression regExp(text.mid(1, text.size() - 2),
+                                            QRegularExpression::CaseInsensitiveOption);
+
+            if (!regExp.isValid())
+            {
+               QLog_Warning("UI", QString("Invalid regular expression {%1}: %2").arg(text, regExp.errorString()));
+               return;
+            }
+
+            mSearcher->search(mCache->snapshot(),
+                              [regExp](const CommitInfo &commit) {
+                                 return regExp.match(commit.shortLog()).hasMatch()
+                                     || regExp.match(commit.longLog()).hasMatch();
+                              },
+                              startingRow + 1);
+         }
+         // The index answers the search once it's built. Meanwhile, or for short texts, the history is scanned in
+         // parallel.
+         else if (const auto row = mSearchIndex->findRow(CommitInfo::Field::SHORT_LOG, text, startingRow + 1);
+                  row != RevisionsSearchIndex::NOT_READY)
+         {
+            commitInfo = mCache->getCommitInfoByRow(row);
+
+            if (commitInfo.isValid())
+               goToSha(commitInfo.sha());
+         }
+         else
+         {
+            mSearcher->search(mCache->snapshot(),
+                              [text](const CommitInfo &commit) {
+                                 return commit.shortLog().contains(text, Qt::CaseInsensitive);
+                              },
+                              startingRow + 1);
+         }
+      }
+   }
+}
+
+void HistoryWidget::searchContent(const QString &text, int startingRow)
+{
+   // Searching the same content again goes to the next commit already found.
+   if (text == mContentSearchText && mContentSearchGeneration == mCache->generation())
+   {
+      if (!mContentMatches.isEmpty())
+      {
+         const auto next = std::upper_bound(mContentMatches.cbegin(), mContentMatches.cend(), startingRow);
+         const auto row = next != mContentMatches.cend() ? *next : mContentMatches.constFirst();
+
+         goToSha(mCache->getCommitInfoByRow(row).sha());
+      }
+
+      return;
+   }
+
+   mContentSearchText = text;
+   mContentSearchGeneration = mCache->generation();
+   mContentMatches.clear();
+   mRepositoryView->setHighlightedRows(mContentMatches);
+
+   const auto mode = text.startsWith("-S") ? GitPickaxeSearch::Mode::Text : GitPickaxeSearch::Mode::RegExp;
+
+   if (mContentSearch->start(text.mid(3).trimmed(), mode))
+   {
+      mLoadingStatus->setText(tr("Content search: searching..."));
+      mLoadingStatus->setToolTip(QString());
+      mLoadingStatus->setVisible(true);
+   }
+   else
+      mContentSearchText.clear();
+}
+
+void HistoryWidget::onContentMatchesFound(const QStringList &shas)
+{
+   if (mContentSearchGeneration != mCache->generation())
+      return;
+
+   const auto goToFirst = mContentMatches.isEmpty();
+   auto first = -1;
+
+   for (const auto &sha : shas)
+   {
+      if (const auto row = mCache->getCommitPos(sha); row > 0)
+      {
+         if (first == -1)
+            first = row;
+
+         mContentMatches.insert(std::lower_bound(mContentMatches.begin(), mContentMatches.end(), row), row);
       }
    }
+
+   if (goToFirst && first != -1)
+      goToSha(mCache->getCommitInfoByRow(first).sha());
+
+   mRepositoryView->setHighlightedRows(mContentMatches);
+
+   mLoadingStatus->setText(tr("Content search: %1 commits so far").arg(mContentMatches.count()));
+}
+
+void HistoryWidget::onSearchNextMatch(int generation, int row)
+{
+   // The matches of a history that has been reloaded during the search don't point to the same commits.
+   if (row == -1 || generation != mCache->generation())
+      return;
+
+   if (const auto commitInfo = mCache->getCommitInfoByRow(row); commitInfo.isValid())
+      goToSha(commitInfo.sha());
+}
+
+void HistoryWidget::onSearchMatchesFound(int matches, bool finished)
+{
+   mLoadingStatus->setText(finished ? tr("Search: %1 matches").arg(matches)
+                                    : tr("Searching: %1 matches so far").arg(matches));
+   mLoadingStatus->setToolTip(QString());
+   mLoadingStatus->setVisible(true);
+
+   if (finished)
+      QTimer::singleShot(LOADING_STATUS_TIMEOUT_MS, mLoadingStatus, &QLabel::hide);
 }
 
 void HistoryWidget::goToSha(const QString &sha)
@@ -230,6 +491,24 @@ void HistoryWidget::commitSelected(const QModelIndex &index)
    onCommitSelected(sha);
 }
 
+void HistoryWidget::prefetchFilesAround(int row)
+{
+   QVector<QPair<QString, QString>> diffs;
+   const auto first = std::max(0, row - GitFilesPrefetch::NEIGHBOUR_ROWS);
+   const auto last = std::min(mRepositoryModel->rowCount() - 1, row + GitFilesPrefetch::NEIGHBOUR_ROWS);
+
+   for (auto i = first; row >= 0 && i <= last; ++i)
+   {
+      const auto commit = mCache->getCommitInfo(mRepositoryModel->sha(i));
+
+      // The files of the WIP change all the time and a root commit has nothing to compare to.
+      if (i != row && commit.isValid() && !commit.isWip() && commit.parentsCount() > 0)
+         diffs.append(qMakePair(commit.sha(), commit.parent(0)));
+   }
+
+   mFilesPrefetch->prefetch(diffs);
+}
+
 void HistoryWidget::openDiff(const QModelIndex &index)
 {
    const auto sha = mRepositoryModel->sha(index.row());
@@ -253,7 +532,7 @@ void HistoryWidget::onBranchCheckout()
    if (mChShowAllBranches->isChecked())
       mRepositoryView->focusOnCommit(ret.output.toString());
 
-   emit signalUpdateCache();
+   emit signalCheckedOut();
 }
 
 void HistoryWidget::mergeBranch(const QString &current, const QString &branchToMerge)
@@ -292,6 +571,9 @@ void HistoryWidget::mergeBranch(const QString &current, const QString &branchToM
 
 void HistoryWidget::onCommitSelected(const QString &goToSha)
 {
+   // The commit is shown now, so the delayed selection is not needed.
+   mSelectionTimer->stop();
+
    const auto isWip = goToSha == CommitInfo::ZERO_SHA;
    mCommitStackedWidget->setCurrentIndex(isWip);
 
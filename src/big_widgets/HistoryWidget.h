@@ -24,6 +24,7 @@
  ***************************************************************************************/
 
 #include <QFrame>
+#include <QVector>
 
 class RevisionsCache;
 class GitBase;
@@ -36,7 +37,15 @@ class WipWidget;
 class AmendWidget;
 class CommitInfoWidget;
 class QCheckBox;
+class QLabel;
+class QTimer;
+struct LoadingTimings;
 class RepositoryViewDelegate;
+class RevisionsSearchIndex;
+class RevisionsSearcher;
+class GitPickaxeSearch;
+class GitFilesPrefetch;
+class FrameStatistics;
 
 /*!
  \brief The HistoryWidget is the responsible fro showing the history of the repository. It is the first widget shown
@@ -63,6 +72,10 @@ signals:
 
    */
    void signalViewUpdated();
+   /*!
+    \brief Signal triggered when a branch or a commit is checked out.
+   */
+   void signalCheckedOut();
    /*!
     \brief Signal triggered when GitQlientRepo needs to update the UI for the current repo.
 
@@ -143,6 +156,16 @@ signals:
     \brief Signal triggered  when the WIP needs to be updated.
    */
    void signalUpdateWip();
+   /*!
+    \brief Signal triggered when only some paths of the WIP need to be updated.
+
+    \param paths The paths that changed.
+   */
+   void signalUpdateWipPaths(const QStringList &paths);
+   /*!
+    \brief Signal triggered when the graph view gets near the end of a partial history and needs its next commits.
+   */
+   void signalMoreRevisionsRequested();
 
 public:
    /*!
@@ -180,12 +203,29 @@ public:
 
    */
    void updateUiFromWatcher();
+   /*!
+    \brief If the current view is the WIP widget, updates the files of some paths. The amend widget is reloaded.
+
+    \param paths The files or directories changed, relative to the root of the repository.
+   */
+   void updateWipPaths(const QStringList &paths);
+   /*!
+    \brief Returns the paint statistics of the history view, or nullptr if they are not collected.
+   */
+   FrameStatistics *frameStatistics() const;
    /*!
     \brief Focuses on the given commit.
 
     \param sha The commit SHA to focus the view in.
    */
    void focusOnCommit(const QString &sha);
+   /*!
+    \brief Highlights commits in the overview of the history, e.g. the ones of a range compared, and focuses on the
+    first one. They replace the matches of the content search.
+
+    \param rows The rows of the commits, sorted.
+   */
+   void highlightCommits(const QVector<int> &rows);
    /*!
     \brief Configures the CommitInfoWidget or the WorkInProgress widget depending on the given SHA. It sets the
     configured widget to visible.
@@ -211,6 +251,48 @@ public:
     \param totalCommits The new total of commits to show in the graph.
    */
    void onNewRevisions(int totalCommits);
+   /*!
+    \brief Updates the references shown in the graph and in the branches widget when they change without a new
+    history.
+
+    \param shas The commits whose references changed.
+   */
+   void onReferencesUpdated(const QStringList &shas);
+   /*!
+    \brief Updates the graph and the WIP when HEAD moves to another commit of the history without a new history.
+   */
+   void onHeadMoved();
+   /*!
+    \brief Tells the graph view if the history loaded is partial and it can ask for more commits.
+
+    \param moreRevisions True if there are more commits to load.
+   */
+   void setHasMoreRevisions(bool moreRevisions);
+   /*!
+    \brief Adds the rows of the page of commits loaded below the history, keeping the selection and the scroll.
+
+    \param totalCommits The new total of commits to show in the graph.
+    \param moreRevisions True if there are more commits to load after them.
+   */
+   void onPageLoaded(int totalCommits, bool moreRevisions);
+   /*!
+    \brief Updates the history model of the repository graph view while the loading process is still running.
+
+    \param totalCommits The total of commits loaded so far.
+   */
+   void onRevisionsChunkLoaded(int totalCommits);
+   /*!
+    \brief Shows the progress of the history load.
+
+    \param loadedCommits The number of commits loaded so far.
+   */
+   void onLoadingProgress(int loadedCommits);
+   /*!
+    \brief Shows the time spent in every phase of the history load once it finishes.
+
+    \param timings The timings of the load.
+   */
+   void onLoadingTimings(const LoadingTimings &timings);
 
 private:
    QSharedPointer<GitBase> mGit;
@@ -224,13 +306,50 @@ private:
    AmendWidget *mAmendWidget = nullptr;
    CommitInfoWidget *mCommitInfoWidget = nullptr;
    QCheckBox *mChShowAllBranches = nullptr;
+   QLabel *mLoadingStatus = nullptr;
    RepositoryViewDelegate *mItemDelegate = nullptr;
+   RevisionsSearchIndex *mSearchIndex = nullptr;
+   RevisionsSearcher *mSearcher = nullptr;
+   GitPickaxeSearch *mContentSearch = nullptr;
+   GitFilesPrefetch *mFilesPrefetch = nullptr;
+   QTimer *mSelectionTimer = nullptr;
+   QString mContentSearchText;
+   int mContentSearchGeneration = -1;
+   QVector<int> mContentMatches;
 
    /*!
     \brief Performs a search based on the input of the search QLineEdit with the users input.
 
    */
    void search();
+   /*!
+    \brief Goes to the next match of a search run by the RevisionsSearcher.
+
+    \param generation The generation of the cache the search ran on.
+    \param row The row of the match or -1 if nothing matches.
+   */
+   void onSearchNextMatch(int generation, int row);
+   /*!
+    \brief Searches the commits that added or removed some content (-S) or whose diff matches a regular expression
+    (-G). Repeating the search goes to the next commit found.
+
+    \param text The text of the search input, with the -S or -G prefix.
+    \param startingRow The row the next match is looked for from.
+   */
+   void searchContent(const QString &text, int startingRow);
+   /*!
+    \brief Adds the commits found by the content search and goes to the first one.
+
+    \param shas The SHAs of the commits found.
+   */
+   void onContentMatchesFound(const QStringList &shas);
+   /*!
+    \brief Shows the progress of a search run by the RevisionsSearcher.
+
+    \param matches The number of matches found so far.
+    \param finished True when the search has finished.
+   */
+   void onSearchMatchesFound(int matches, bool finished);
    /*!
     \brief Goes to the selected SHA.
 
@@ -244,6 +363,13 @@ private:
     \param index The index from the model.
    */
    void commitSelected(const QModelIndex &index);
+   /*!
+    \brief Reads in the background the files of the commits around a row, so they are shown at once when the selection
+    moves to them.
+
+    \param row The current row of the history.
+   */
+   void prefetchFilesAround(int row);
    /*!
     \brief Retrieves the SHA from the QModelIndex and triggers the \ref signalOpenDiff signal.
 
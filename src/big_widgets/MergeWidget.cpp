@@ -8,6 +8,7 @@
 #include <CommitInfo.h>
 #include <RevisionFiles.h>
 #include <ConflictButton.h>
+#include <ConflictIndex.h>
 
 #include <QPushButton>
 #include <QLineEdit>
@@ -29,6 +30,7 @@ MergeWidget::MergeWidget(const QSharedPointer<RevisionsCache> &gitQlientCache, c
    , mDescription(new QTextEdit())
    , mMergeBtn(new QPushButton(tr("Merge && Commit")))
    , mAbortBtn(new QPushButton(tr("Abort merge")))
+   , mConflictIndex(new ConflictIndex(gitQlientCache.data(), this))
 {
    mCenterStackedWidget->setCurrentIndex(0);
    mCenterStackedWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -112,6 +114,7 @@ MergeWidget::MergeWidget(const QSharedPointer<RevisionsCache> &gitQlientCache, c
 
    connect(mAbortBtn, &QPushButton::clicked, this, &MergeWidget::abort);
    connect(mMergeBtn, &QPushButton::clicked, this, &MergeWidget::commit);
+   connect(mConflictIndex, &ConflictIndex::signalFileIndexed, this, &MergeWidget::onFileIndexed);
 }
 
 void MergeWidget::configure(const RevisionFiles &files, ConflictReason reason)
@@ -134,6 +137,8 @@ void MergeWidget::configure(const RevisionFiles &files, ConflictReason reason)
 
 void MergeWidget::fillButtonFileList(const RevisionFiles &files)
 {
+   QStringList conflicts;
+
    for (auto i = 0; i < files.count(); ++i)
    {
       const auto fileInConflict = files.statusCmp(i, RevisionFiles::CONFLICT);
@@ -145,6 +150,7 @@ void MergeWidget::fillButtonFileList(const RevisionFiles &files)
       connect(fileBtn, &ConflictButton::updateRequested, this, &MergeWidget::onUpdateRequested);
       connect(fileBtn, &ConflictButton::resolved, this, &MergeWidget::onConflictResolved);
       connect(fileBtn, &ConflictButton::signalEditFile, this, &MergeWidget::signalEditFile);
+      connect(fileBtn, &ConflictButton::conflictRequested, this, &MergeWidget::onConflictRequested);
 
       const auto wip = mGitQlientCache->getCommitInfo(CommitInfo::ZERO_SHA);
       const auto fileDiffWidget = new FileDiffWidget(mGit, mGitQlientCache);
@@ -156,6 +162,7 @@ void MergeWidget::fillButtonFileList(const RevisionFiles &files)
 
       if (fileInConflict)
       {
+         conflicts.append(fileName);
          mConflictBtnContainer->addWidget(fileBtn);
 
          if (mCenterStackedWidget->count() == 0)
@@ -164,6 +171,9 @@ void MergeWidget::fillButtonFileList(const RevisionFiles &files)
       else
          mAutoMergedBtnContainer->addWidget(fileBtn);
    }
+
+   // The conflicts are found in the background, the buttons show them as soon as every file is scanned.
+   mConflictIndex->scan(mGit->getWorkingDir(), conflicts);
 }
 
 void MergeWidget::changeDiffView(bool fileBtnChecked)
@@ -265,6 +275,7 @@ void MergeWidget::removeMergeComponents()
    }
 
    mConflictButtons.clear();
+   mConflictIndex->clear();
    mCommitTitle->clear();
    mDescription->clear();
 }
@@ -275,10 +286,36 @@ void MergeWidget::onConflictResolved()
    mAutoMergedBtnContainer->addWidget(conflictButton);
 
    mConflictButtons.value(conflictButton)->reload();
+   mConflictIndex->rescan(conflictButton->fileName());
 }
 
 void MergeWidget::onUpdateRequested()
 {
    const auto conflictButton = qobject_cast<ConflictButton *>(sender());
    mConflictButtons.value(conflictButton)->reload();
+   mConflictIndex->rescan(conflictButton->fileName());
+}
+
+void MergeWidget::onFileIndexed(const QString &file)
+{
+   const auto end = mConflictButtons.constEnd();
+
+   for (auto iter = mConflictButtons.constBegin(); iter != end; ++iter)
+   {
+      if (iter.key()->fileName() == file)
+      {
+         iter.key()->setConflicts(mConflictIndex->regions(file));
+         break;
+      }
+   }
+}
+
+void MergeWidget::onConflictRequested(int conflict, const ConflictIndex::Region &region)
+{
+   const auto conflictButton = qobject_cast<ConflictButton *>(sender());
+   const auto fileDiffWidget = mConflictButtons.value(conflictButton);
+
+   // When the diff doesn't show the conflict, the editor opens the file at its first line.
+   if (fileDiffWidget && !fileDiffWidget->goToConflict(conflict))
+      emit signalEditFile(mGit->getWorkingDir() + "/" + conflictButton->fileName(), region.start, 0);
 }
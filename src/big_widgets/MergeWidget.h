@@ -23,6 +23,8 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ConflictIndex.h>
+
 #include <QFrame>
 #include <QMap>
 
@@ -102,6 +104,7 @@ private:
    QPushButton *mMergeBtn = nullptr;
    QPushButton *mAbortBtn = nullptr;
    QMap<ConflictButton *, FileDiffWidget *> mConflictButtons;
+   ConflictIndex *mConflictIndex = nullptr;
    ConflictReason mReason = ConflictReason::Merge;
 
    /**
@@ -142,4 +145,17 @@ private:
     *
     */
    void onUpdateRequested();
+   /**
+    * @brief Shows the conflicts of a file in its ConflictButton when the ConflictIndex finds them.
+    *
+    * @param file The file.
+    */
+   void onFileIndexed(const QString &file);
+   /**
+    * @brief Shows a conflict of a file. This action is triggered by a ConflictButton.
+    *
+    * @param conflict The index of the conflict in the file.
+    * @param region The lines of the conflict.
+    */
+   void onConflictRequested(int conflict, const ConflictIndex::Region &region);
 };
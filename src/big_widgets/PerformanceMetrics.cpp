@@ -0,0 +1,59 @@
+#include "PerformanceMetrics.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+qint64 StartupTimings::interactiveMs() const
+{
+   if (historyMs < 0 || watcherMs < 0 || blameMs < 0 || configMs < 0)
+      return -1;
+
+   return std::max({ historyMs, watcherMs, blameMs, configMs });
+}
+
+QString StartupTimings::toString() const
+{
+   QStringList stages;
+
+   const auto addStage = [&stages](const QString &name, qint64 value) {
+      stages.append(value >= 0 ? QString("%1: %2 ms").arg(name).arg(value) : QString("%1: pending").arg(name));
+   };
+
+   addStage("history", historyMs);
+   addStage("watcher", watcherMs);
+   addStage("blame", blameMs);
+   addStage("config", configMs);
+   addStage("interactive", interactiveMs());
+
+   return stages.join(", ");
+}
+
+PerformanceMetrics &PerformanceMetrics::instance()
+{
+   static PerformanceMetrics metrics;
+   return metrics;
+}
+
+int PerformanceMetrics::addRepository(const Provider &provider)
+{
+   mProviders.insert(++mNextId, provider);
+
+   return mNextId;
+}
+
+void PerformanceMetrics::removeRepository(int id)
+{
+   mProviders.remove(id);
+}
+
+QVector<RepositoryMetrics> PerformanceMetrics::repositories() const
+{
+   QVector<RepositoryMetrics> metrics;
+   metrics.reserve(mProviders.count());
+
+   for (const auto &provider : mProviders)
+      metrics.append(provider());
+
+   return metrics;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitRepoLoader.h>
+#include <RevisionsCache.h>
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/*!
+ \brief The time from the opening of a repository until every stage of its startup was ready, in milliseconds. The
+ stages that didn't finish yet are -1.
+*/
+struct StartupTimings
+{
+   qint64 historyMs = -1;
+   qint64 watcherMs = -1;
+   qint64 blameMs = -1;
+   qint64 configMs = -1;
+
+   /*!
+    \brief Returns the time until the last stage was ready, or -1 while any of them is missing.
+   */
+   qint64 interactiveMs() const;
+   QString toString() const;
+};
+
+/*!
+ \brief The metrics of an open repository, as they are at the moment they are read.
+*/
+struct RepositoryMetrics
+{
+   QString repository;
+   int runningProcesses = 0;
+   int waitingProcesses = 0;
+   int revisionFilesHits = 0;
+   int revisionFilesMisses = 0;
+   LoadingTimings loading;
+   StartupTimings startup;
+   QString frameTimes;
+   qint64 watcherEvents = 0;
+   int watchCount = 0;
+   RevisionsCache::MemoryUsage memory;
+   MemoryReport memoryByStructure;
+   qint64 diffsMemory = 0;
+};
+
+/*!
+ \brief The PerformanceMetrics keeps the open repositories that can be measured, so the performance page of the
+ configuration reads their metrics without knowing the tabs. Every repository registers a function that fills its
+ metrics, it's only called from the GUI thread when the page is refreshed.
+
+ \class PerformanceMetrics PerformanceMetrics.h "PerformanceMetrics.h"
+*/
+class PerformanceMetrics
+{
+public:
+   using Provider = std::function<RepositoryMetrics()>;
+
+   /*!
+    \brief Returns the metrics of the application.
+   */
+   static PerformanceMetrics &instance();
+
+   /*!
+    \brief Adds a repository to the metrics.
+
+    \param provider The function that reads the metrics of the repository.
+    \return The id to remove the repository with.
+   */
+   int addRepository(const Provider &provider);
+   /*!
+    \brief Removes a repository from the metrics.
+
+    \param id The id returned by \ref addRepository.
+   */
+   void removeRepository(int id);
+   /*!
+    \brief Reads the metrics of all the repositories, in the order they were added.
+   */
+   QVector<RepositoryMetrics> repositories() const;
+
+private:
+   QMap<int, Provider> mProviders;
+   int mNextId = 0;
+
+   PerformanceMetrics() = default;
+};
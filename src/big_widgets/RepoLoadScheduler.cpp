@@ -0,0 +1,130 @@
+#include "RepoLoadScheduler.h"
+
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QWidget>
+
+#include <QLogger.h>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+RepoLoadScheduler &RepoLoadScheduler::instance()
+{
+   static RepoLoadScheduler scheduler;
+
+   return scheduler;
+}
+
+RepoLoadScheduler::RepoLoadScheduler()
+   : mWatchdog(new QTimer(this))
+{
+   mClock.start();
+
+   mWatchdog->setSingleShot(true);
+   mWatchdog->setInterval(LOAD_TIMEOUT_MS);
+
+   connect(mWatchdog, &QTimer::timeout, this, &RepoLoadScheduler::schedule);
+}
+
+void RepoLoadScheduler::requestLoad(QWidget *repo, const std::function<void()> &load)
+{
+   connect(repo, &QObject::destroyed, this, &RepoLoadScheduler::cancel, Qt::UniqueConnection);
+
+   const auto iter = std::find_if(mWaiting.begin(), mWaiting.end(),
+                                  [repo](const Request &request) { return request.repo == repo; });
+
+   if (iter != mWaiting.end())
+      iter->load = load;
+   else
+      mWaiting.append({ repo, load });
+
+   schedule();
+}
+
+void RepoLoadScheduler::loadFinished(QWidget *repo)
+{
+   if (mRunning.remove(repo) > 0)
+      schedule();
+}
+
+void RepoLoadScheduler::repositoryShown()
+{
+   schedule();
+}
+
+void RepoLoadScheduler::cancel(QObject *repo)
+{
+   mRunning.remove(repo);
+
+   const auto isRepo = [repo](const Request &request) { return request.repo.isNull() || request.repo == repo; };
+
+   mWaiting.erase(std::remove_if(mWaiting.begin(), mWaiting.end(), isRepo), mWaiting.end());
+
+   schedule();
+}
+
+int RepoLoadScheduler::spreadInterval(int intervalMs) const
+{
+   const auto variation = intervalMs / 10;
+
+   return variation > 0 ? intervalMs - variation + QRandomGenerator::global()->bounded(2 * variation + 1) : intervalMs;
+}
+
+void RepoLoadScheduler::schedule()
+{
+   // A load can finish as soon as it starts: the loop that is already running picks the next one.
+   if (mScheduling)
+      return;
+
+   mScheduling = true;
+
+   for (auto iter = mRunning.begin(); iter != mRunning.end();)
+   {
+      if (mClock.elapsed() - iter.value() < LOAD_TIMEOUT_MS)
+         ++iter;
+      else
+      {
+         QLog_Warning("UI", QString("A repository didn't report the end of its load. It doesn't block the rest."));
+         iter = mRunning.erase(iter);
+      }
+   }
+
+   for (auto index = nextRequest(); index != -1; index = nextRequest())
+   {
+      const auto request = mWaiting.takeAt(index);
+
+      mRunning.insert(request.repo.data(), mClock.elapsed());
+
+      request.load();
+   }
+
+   if (mRunning.isEmpty())
+      mWatchdog->stop();
+   else
+      mWatchdog->start();
+
+   mScheduling = false;
+}
+
+int RepoLoadScheduler::nextRequest()
+{
+   mWaiting.erase(std::remove_if(mWaiting.begin(), mWaiting.end(),
+                                 [](const Request &request) { return request.repo.isNull(); }),
+                  mWaiting.end());
+
+   // The repositories that are seen don't wait for the others.
+   for (auto i = 0; i < mWaiting.count(); ++i)
+   {
+      if (isSeen(mWaiting.at(i).repo))
+         return i;
+   }
+
+   return mWaiting.isEmpty() || mRunning.count() >= MAX_BACKGROUND_LOADS ? -1 : 0;
+}
+
+bool RepoLoadScheduler::isSeen(QWidget *repo)
+{
+   return repo->isVisible() && !repo->window()->isMinimized();
+}
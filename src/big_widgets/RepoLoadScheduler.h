@@ -0,0 +1,111 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+#include <functional>
+
+class QTimer;
+class QWidget;
+
+/*!
+ \brief The RepoLoadScheduler decides when the repositories opened in the tabs load their history, so opening many of
+ them at once doesn't start all the loads at the same time. The repositories that are seen start their load right away.
+ The rest wait until no other load is running, one after the other.
+
+ A load is running from the moment it's started until the repository reports that it finished. A repository that
+ never reports it stops counting after LOAD_TIMEOUT_MS.
+
+ It also spreads the automatic fetches of the repositories, so they don't happen in sync.
+
+ \class RepoLoadScheduler RepoLoadScheduler.h "RepoLoadScheduler.h"
+*/
+class RepoLoadScheduler : public QObject
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief Returns the scheduler of the application.
+   */
+   static RepoLoadScheduler &instance();
+
+   /*!
+    \brief Queues a load of a repository. A load of the same repository that is still waiting is replaced.
+
+    \param repo The widget of the repository. It's seen if it's visible and its window is not minimized.
+    \param load The function that starts the load. It's called from this object, maybe before returning.
+   */
+   void requestLoad(QWidget *repo, const std::function<void()> &load);
+   /*!
+    \brief Tells that the load of a repository has finished, so the next one can start.
+
+    \param repo The widget of the repository.
+   */
+   void loadFinished(QWidget *repo);
+   /*!
+    \brief Starts the loads of the repositories that were waiting and are seen now.
+   */
+   void repositoryShown();
+   /*!
+    \brief Removes the load of a repository, waiting or running.
+
+    \param repo The widget of the repository.
+   */
+   void cancel(QObject *repo);
+   /*!
+    \brief Returns the next interval of a periodic task, with a random variation of up to a tenth of it.
+
+    \param intervalMs The interval configured.
+    \return The interval to use for the next run.
+   */
+   int spreadInterval(int intervalMs) const;
+
+private:
+   static constexpr int MAX_BACKGROUND_LOADS = 1;
+   static constexpr int LOAD_TIMEOUT_MS = 120000;
+
+   struct Request
+   {
+      QPointer<QWidget> repo;
+      std::function<void()> load;
+   };
+
+   QVector<Request> mWaiting;
+   QHash<QObject *, qint64> mRunning;
+   QElapsedTimer mClock;
+   QTimer *mWatchdog = nullptr;
+   bool mScheduling = false;
+
+   RepoLoadScheduler();
+
+   void schedule();
+   int nextRequest();
+   static bool isSeen(QWidget *repo);
+};
@@ -0,0 +1,136 @@
+#include "SettingsStore.h"
+
+#include <WorkerPool.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QTimer>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+bool isUnder(const QString &key, const QString &group)
+{
+   return group.isEmpty() || key == group || key.startsWith(group + '/');
+}
+}
+
+SettingsStore &SettingsStore::instance()
+{
+   static SettingsStore store;
+
+   return store;
+}
+
+SettingsStore::SettingsStore()
+   : mFlushTimer(new QTimer(this))
+   , mWorker(new WorkerQueue(this, WorkerPool::Priority::Background))
+{
+   QSettings settings;
+
+   for (const auto &key : settings.allKeys())
+      mValues.insert(key, settings.value(key));
+
+   mFlushTimer->setSingleShot(true);
+   mFlushTimer->setInterval(FLUSH_DELAY_MS);
+
+   connect(mFlushTimer, &QTimer::timeout, this, [this]() { mWorker->post([this]() { writePending(); }); });
+
+   if (const auto app = QCoreApplication::instance())
+      connect(app, &QCoreApplication::aboutToQuit, this, &SettingsStore::flush);
+}
+
+SettingsStore::~SettingsStore()
+{
+   flush();
+
+   mWorker.reset();
+}
+
+QVariant SettingsStore::value(const QString &key, const QVariant &defaultValue) const
+{
+   return mValues.value(key, defaultValue);
+}
+
+void SettingsStore::setValue(const QString &key, const QVariant &value)
+{
+   mValues.insert(key, value);
+
+   {
+      QMutexLocker locker(&mPendingMutex);
+      mPendingValues.insert(key, value);
+   }
+
+   scheduleFlush();
+}
+
+void SettingsStore::remove(const QString &key)
+{
+   for (auto iter = mValues.begin(); iter != mValues.end();)
+      iter = isUnder(iter.key(), key) ? mValues.erase(iter) : ++iter;
+
+   {
+      QMutexLocker locker(&mPendingMutex);
+
+      // The removals are written before the values, so a value set before the removal must not be written.
+      for (auto iter = mPendingValues.begin(); iter != mPendingValues.end();)
+         iter = isUnder(iter.key(), key) ? mPendingValues.erase(iter) : ++iter;
+
+      mPendingRemovals.insert(key);
+   }
+
+   scheduleFlush();
+}
+
+void SettingsStore::flush()
+{
+   mFlushTimer->stop();
+
+   writePending();
+}
+
+void SettingsStore::scheduleFlush()
+{
+   // Every change delays the write, so a burst of changes is written at once.
+   mFlushTimer->start();
+}
+
+void SettingsStore::writePending()
+{
+   // The batches are written one at a time, so an older batch never overwrites a newer one.
+   QMutexLocker writeLocker(&mWriteMutex);
+
+   QMap<QString, QVariant> values;
+   QSet<QString> removals;
+
+   {
+      QMutexLocker locker(&mPendingMutex);
+      values.swap(mPendingValues);
+      removals.swap(mPendingRemovals);
+   }
+
+   if (values.isEmpty() && removals.isEmpty())
+      return;
+
+   QElapsedTimer timer;
+   timer.start();
+
+   QSettings settings;
+
+   for (const auto &key : qAsConst(removals))
+      settings.remove(key);
+
+   for (auto iter = values.cbegin(); iter != values.cend(); ++iter)
+      settings.setValue(iter.key(), iter.value());
+
+   settings.sync();
+
+   QLog_Debug("UI",
+              QString("Settings written: {%1} keys changed and {%2} removed in {%3} ms.")
+                  .arg(QString::number(values.count()), QString::number(removals.count()),
+                       QString::number(timer.elapsed())));
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QScopedPointer>
+#include <QSet>
+#include <QVariant>
+
+class QTimer;
+class WorkerQueue;
+
+/*!
+ \brief The SettingsStore keeps the settings of the application in memory, so reading or changing them never touches
+ the disk. The keys changed are written in a batch in the WorkerPool once no other change comes for
+ FLUSH_DELAY_MS, so the writes don't stall the UI on slow file systems. The pending changes are written right away
+ when the application quits.
+
+ \class SettingsStore SettingsStore.h "SettingsStore.h"
+*/
+class SettingsStore : public QObject
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief Returns the store of the application. The settings are read the first time it's used.
+   */
+   static SettingsStore &instance();
+
+   /*!
+    \brief Returns the value of a key.
+
+    \param key The key.
+    \param defaultValue The value returned if the key doesn't exist.
+    \return The value.
+   */
+   QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
+   /*!
+    \brief Sets the value of a key. It's written to disk with the next batch.
+
+    \param key The key.
+    \param value The new value.
+   */
+   void setValue(const QString &key, const QVariant &value);
+   /*!
+    \brief Removes a key and the keys under it, like QSettings::remove. It's written to disk with the next batch.
+
+    \param key The key.
+   */
+   void remove(const QString &key);
+   /*!
+    \brief Writes the pending changes in the calling thread. It's done when the application quits.
+   */
+   void flush();
+
+private:
+   static constexpr int FLUSH_DELAY_MS = 1000;
+
+   QHash<QString, QVariant> mValues;
+   QMutex mPendingMutex;
+   QMap<QString, QVariant> mPendingValues;
+   QSet<QString> mPendingRemovals;
+   QMutex mWriteMutex;
+   QTimer *mFlushTimer = nullptr;
+   QScopedPointer<WorkerQueue> mWorker;
+
+   SettingsStore();
+   ~SettingsStore() override;
+
+   void scheduleFlush();
+   void writePending();
+};
@@ -0,0 +1,497 @@
+#include "BranchTreeModel.h"
+
+#include <GitQlientBranchItemRole.h>
+
+#include <QIcon>
+#include <QSet>
+
+using namespace GitQlient;
+
+BranchTreeModel::BranchTreeModel(bool isLocal, QObject *parent)
+   : QAbstractItemModel(parent)
+   , mIsLocal(isLocal)
+   , mRoot(new Entry())
+{
+   mRoot->fetched = true;
+}
+
+void BranchTreeModel::setBranches(const QVector<Branch> &branches, const QString &currentBranch)
+{
+   beginResetModel();
+
+   mCurrentBranch = currentBranch;
+   mBranches.clear();
+   mRoot.reset(new Entry());
+   mRoot->pending = branches;
+   mRoot->branchCount = branches.count();
+
+   fetch(mRoot.data(), false);
+
+   endResetModel();
+
+   setNames(branches);
+}
+
+void BranchTreeModel::updateBranches(const QVector<Branch> &branches, const QString &currentBranch)
+{
+   if (mRoot->branchCount == 0)
+   {
+      setBranches(branches, currentBranch);
+      return;
+   }
+
+   mCurrentBranch = currentBranch;
+
+   QSet<QString> names;
+   QHash<Entry *, QVector<Branch>> pending;
+
+   names.reserve(branches.count());
+
+   for (const auto &branch : branches)
+   {
+      names.insert(branch.fullName);
+
+      // The branch goes to the first folder of its path that is not populated, if there is one.
+      const auto parts = branch.fullName.split('/');
+      auto folder = mRoot.data();
+      auto depth = 0;
+
+      while (folder->fetched && depth < parts.count() - 1)
+      {
+         const auto child = folder->folders.value(parts.at(depth));
+
+         if (!child)
+            break;
+
+         folder = child;
+         ++depth;
+      }
+
+      if (!folder->fetched)
+         pending[folder].append(branch);
+      else if (const auto item = mBranches.value(branch.fullName); !item)
+         insertBranch(branch, folder, depth);
+      else
+      {
+         const auto isCurrent = branch.fullName == currentBranch;
+
+         if (item->sha != branch.sha || item->masterDistance != branch.masterDistance
+             || item->originDistance != branch.originDistance || item->isCurrent != isCurrent)
+         {
+            item->sha = branch.sha;
+            item->masterDistance = branch.masterDistance;
+            item->originDistance = branch.originDistance;
+            item->isCurrent = isCurrent;
+
+            const auto first = indexOf(item);
+
+            emit dataChanged(first, first.sibling(first.row(), columnCount() - 1));
+         }
+      }
+   }
+
+   for (const auto item : mBranches.values())
+   {
+      if (!names.contains(item->fullName))
+         removeEntry(item);
+   }
+
+   QVector<Entry *> unfetched;
+   collectUnfetched(mRoot.data(), unfetched);
+
+   for (const auto folder : qAsConst(unfetched))
+   {
+      folder->pending = pending.value(folder);
+
+      if (folder->pending.isEmpty())
+         removeEntry(folder);
+   }
+
+   updateCounts(mRoot.data());
+   setNames(branches);
+}
+
+void BranchTreeModel::clear()
+{
+   beginResetModel();
+   mCurrentBranch.clear();
+   mBranches.clear();
+   mRoot.reset(new Entry());
+   mRoot->fetched = true;
+   mNames.clear();
+   mIndex.clear();
+   mIndexOutdated = true;
+   mVisiblePaths.clear();
+   endResetModel();
+}
+
+QModelIndex BranchTreeModel::fetchBranch(const QString &fullName)
+{
+   const auto parts = fullName.split('/');
+   auto folder = mRoot.data();
+
+   for (auto depth = 0; folder && depth < parts.count() - 1; ++depth)
+   {
+      if (!folder->fetched)
+         fetch(folder, true);
+
+      folder = folder->folders.value(parts.at(depth));
+   }
+
+   if (folder && !folder->fetched)
+      fetch(folder, true);
+
+   const auto item = mBranches.value(fullName);
+
+   return item ? indexOf(item) : QModelIndex();
+}
+
+void BranchTreeModel::setFilter(const QString &text)
+{
+   if (text == mFilter)
+      return;
+
+   mFilter = text;
+
+   applyFilter();
+}
+
+QModelIndex BranchTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+   const auto folder = parent.isValid() ? entry(parent) : mRoot.data();
+
+   if (!folder || row < 0 || row >= folder->children.count() || column < 0 || column >= columnCount())
+      return QModelIndex();
+
+   return createIndex(row, column, folder->children.at(row));
+}
+
+QModelIndex BranchTreeModel::parent(const QModelIndex &index) const
+{
+   const auto item = entry(index);
+
+   if (!item || item->parent == mRoot.data())
+      return QModelIndex();
+
+   return createIndex(item->parent->row, static_cast<int>(Column::Name), item->parent);
+}
+
+int BranchTreeModel::rowCount(const QModelIndex &parent) const
+{
+   if (parent.column() > 0)
+      return 0;
+
+   const auto folder = parent.isValid() ? entry(parent) : mRoot.data();
+
+   return folder ? folder->children.count() : 0;
+}
+
+int BranchTreeModel::columnCount(const QModelIndex &) const
+{
+   return mIsLocal ? static_cast<int>(Column::OriginDistance) + 1 : 1;
+}
+
+bool BranchTreeModel::hasChildren(const QModelIndex &parent) const
+{
+   if (parent.column() > 0)
+      return false;
+
+   const auto folder = parent.isValid() ? entry(parent) : mRoot.data();
+
+   // The folders not populated yet show the expand arrow: there are no empty folders.
+   return folder && !folder->isLeaf && (!folder->fetched || !folder->children.isEmpty());
+}
+
+bool BranchTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+   const auto folder = parent.isValid() ? entry(parent) : mRoot.data();
+
+   return folder && !folder->isLeaf && !folder->fetched;
+}
+
+void BranchTreeModel::fetchMore(const QModelIndex &parent)
+{
+   if (canFetchMore(parent))
+      fetch(parent.isValid() ? entry(parent) : mRoot.data(), true);
+}
+
+QVariant BranchTreeModel::data(const QModelIndex &index, int role) const
+{
+   const auto item = entry(index);
+
+   if (!item)
+      return QVariant();
+
+   switch (role)
+   {
+      case Qt::DisplayRole:
+         switch (static_cast<Column>(index.column()))
+         {
+            case Column::Name:
+               return item->name;
+            case Column::MasterDistance:
+               return item->masterDistance;
+            case Column::OriginDistance:
+               return item->originDistance;
+         }
+         break;
+      case Qt::ToolTipRole:
+         return item->isLeaf ? item->fullName : tr("%1 branches").arg(item->branchCount);
+      case IsCurrentBranchRole:
+         return item->isCurrent;
+      case FullNameRole:
+         return item->fullName;
+      case LocalBranchRole:
+         return mIsLocal;
+      case ShaRole:
+         return item->sha;
+      case IsLeaf:
+         return item->isLeaf;
+      case BranchCountRole:
+         return item->branchCount;
+      case MatchesFilterRole:
+         return mFilter.isEmpty() || mVisiblePaths.contains(item->path);
+      default:
+         break;
+   }
+
+   return QVariant();
+}
+
+QVariant BranchTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+   if (orientation != Qt::Horizontal)
+      return QVariant();
+
+   if (role == Qt::DecorationRole && section == static_cast<int>(Column::Name))
+      return QIcon(mIsLocal ? ":/icons/local" : ":/icons/server");
+
+   if (role != Qt::DisplayRole)
+      return QVariant();
+
+   switch (static_cast<Column>(section))
+   {
+      case Column::Name:
+         return QString("   %1").arg(mIsLocal ? tr("Local") : tr("Remote"));
+      case Column::MasterDistance:
+         return tr("Master");
+      case Column::OriginDistance:
+         return tr("Origin");
+   }
+
+   return QVariant();
+}
+
+BranchTreeModel::Entry *BranchTreeModel::entry(const QModelIndex &index) const
+{
+   return index.isValid() ? static_cast<Entry *>(index.internalPointer()) : nullptr;
+}
+
+QModelIndex BranchTreeModel::indexOf(Entry *entry) const
+{
+   return entry == mRoot.data() ? QModelIndex() : createIndex(entry->row, static_cast<int>(Column::Name), entry);
+}
+
+BranchTreeModel::Entry *BranchTreeModel::createChild(Entry *parent, const QString &name, int row) const
+{
+   const auto child = new Entry();
+   child->name = name;
+   child->path = parent->path.isEmpty() ? name : QString("%1/%2").arg(parent->path, name);
+   child->parent = parent;
+   child->depth = parent->depth + 1;
+   child->row = row;
+
+   return child;
+}
+
+void BranchTreeModel::initLeaf(Entry *item, const Branch &branch)
+{
+   item->fullName = branch.fullName;
+   item->sha = branch.sha;
+   item->masterDistance = branch.masterDistance;
+   item->originDistance = branch.originDistance;
+   item->isLeaf = true;
+   item->isCurrent = branch.fullName == mCurrentBranch;
+   item->fetched = true;
+
+   mBranches.insert(branch.fullName, item);
+}
+
+void BranchTreeModel::fetch(Entry *folder, bool notify)
+{
+   QVector<Entry *> children;
+   const auto pending = std::move(folder->pending);
+
+   folder->pending.clear();
+   folder->fetched = true;
+
+   // Only the first level of the folder is built. The subfolders keep their branches until they are populated too.
+   for (const auto &branch : pending)
+   {
+      const auto parts = branch.fullName.split('/');
+
+      if (parts.count() == folder->depth + 1)
+      {
+         const auto item = createChild(folder, parts.constLast(), children.count());
+         initLeaf(item, branch);
+         children.append(item);
+         continue;
+      }
+
+      const auto &name = parts.at(folder->depth);
+      auto child = folder->folders.value(name);
+
+      if (!child)
+      {
+         child = createChild(folder, name, children.count());
+         children.append(child);
+         folder->folders.insert(name, child);
+      }
+
+      child->pending.append(branch);
+      ++child->branchCount;
+   }
+
+   if (children.isEmpty())
+      return;
+
+   if (notify)
+      beginInsertRows(indexOf(folder), 0, children.count() - 1);
+
+   folder->children = children;
+
+   if (notify)
+      endInsertRows();
+}
+
+void BranchTreeModel::insertBranch(const Branch &branch, Entry *parent, int depth)
+{
+   const auto parts = branch.fullName.split('/');
+
+   // The folders created for a new branch are populated: the branch is all they have.
+   for (; depth < parts.count() - 1; ++depth)
+   {
+      const auto row = parent->children.count();
+
+      beginInsertRows(indexOf(parent), row, row);
+
+      const auto child = createChild(parent, parts.at(depth), row);
+      child->fetched = true;
+      parent->children.append(child);
+      parent->folders.insert(child->name, child);
+
+      endInsertRows();
+
+      parent = child;
+   }
+
+   const auto row = parent->children.count();
+
+   beginInsertRows(indexOf(parent), row, row);
+
+   const auto item = createChild(parent, parts.constLast(), row);
+   initLeaf(item, branch);
+   parent->children.append(item);
+
+   endInsertRows();
+}
+
+void BranchTreeModel::removeEntry(Entry *item)
+{
+   if (item->isLeaf)
+      mBranches.remove(item->fullName);
+
+   // The folders that are left empty are removed too.
+   while (item->parent != mRoot.data() && item->parent->children.count() == 1)
+      item = item->parent;
+
+   const auto parent = item->parent;
+
+   beginRemoveRows(indexOf(parent), item->row, item->row);
+
+   parent->children.removeAt(item->row);
+
+   if (!item->isLeaf)
+      parent->folders.remove(item->name);
+
+   for (auto row = item->row; row < parent->children.count(); ++row)
+      parent->children.at(row)->row = row;
+
+   delete item;
+
+   endRemoveRows();
+}
+
+void BranchTreeModel::collectUnfetched(Entry *folder, QVector<Entry *> &folders) const
+{
+   for (const auto child : qAsConst(folder->children))
+   {
+      if (child->isLeaf)
+         continue;
+
+      if (child->fetched)
+         collectUnfetched(child, folders);
+      else
+         folders.append(child);
+   }
+}
+
+int BranchTreeModel::updateCounts(Entry *folder)
+{
+   auto count = folder->pending.count();
+
+   for (const auto child : qAsConst(folder->children))
+      count += child->isLeaf ? 1 : updateCounts(child);
+
+   if (count != folder->branchCount)
+   {
+      folder->branchCount = count;
+
+      if (folder != mRoot.data())
+         emit dataChanged(indexOf(folder), indexOf(folder), { Qt::ToolTipRole, BranchCountRole });
+   }
+
+   return count;
+}
+
+void BranchTreeModel::setNames(const QVector<Branch> &branches)
+{
+   mNames.clear();
+   mNames.reserve(branches.count());
+
+   for (const auto &branch : branches)
+      mNames.append(branch.fullName);
+
+   // The index is only built again when there is something to filter.
+   mIndexOutdated = true;
+
+   if (!mFilter.isEmpty())
+      applyFilter();
+}
+
+void BranchTreeModel::applyFilter()
+{
+   mVisiblePaths.clear();
+
+   if (!mFilter.isEmpty())
+   {
+      if (mIndexOutdated)
+      {
+         mIndex.setNames(mNames);
+         mIndexOutdated = false;
+      }
+
+      // The folders that contain a branch that matches are shown as well.
+      for (const auto id : mIndex.find(mFilter))
+      {
+         const auto &name = mIndex.name(id);
+
+         mVisiblePaths.insert(name);
+
+         for (auto slash = name.indexOf('/'); slash != -1; slash = name.indexOf('/', slash + 1))
+            mVisiblePaths.insert(name.left(slash));
+      }
+   }
+
+   emit signalFilterChanged();
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RefNameIndex.h>
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QScopedPointer>
+#include <QSet>
+#include <QVector>
+
+/*!
+ \brief The BranchTreeModel is the tree of the local or the remote branches. The names of the branches are split by the
+ slashes and every part but the last one is a folder. Every folder finds its subfolders through a hash instead of
+ looking through the items that already exist.
+
+ The folders are populated when they are expanded, through canFetchMore and fetchMore: until then a folder only keeps
+ the list of its branches. So loading thousands of remote branches only builds the first level of the tree. Every
+ folder knows how many branches it contains, populated or not.
+
+ The filter doesn't remove any row: it only tells through MatchesFilterRole if a row has to be shown, so the view hides
+ the others. The folders that contain a branch that matches are shown too, populated or not.
+
+ \class BranchTreeModel BranchTreeModel.h "BranchTreeModel.h"
+*/
+class BranchTreeModel : public QAbstractItemModel
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the rows that match the filter change, so the view can show and hide them.
+   */
+   void signalFilterChanged();
+
+public:
+   /*!
+    \brief The columns of the model. The remote branches only have the name.
+   */
+   enum class Column
+   {
+      Name,
+      MasterDistance,
+      OriginDistance
+   };
+
+   /*!
+    \brief A branch to show in the tree.
+   */
+   struct Branch
+   {
+      QString fullName;
+      QString sha;
+      QString masterDistance; /*!< The text of the distance to master. Only for local branches. */
+      QString originDistance; /*!< The text of the distance to the remote branch. Only for local branches. */
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param isLocal True if the model shows local branches, otherwise false.
+    \param parent The parent object if needed.
+   */
+   explicit BranchTreeModel(bool isLocal, QObject *parent = nullptr);
+
+   /*!
+    \brief Replaces the branches of the model. The folders keep the order in which they first appear.
+
+    \param branches The branches.
+    \param currentBranch The name of the branch checked out.
+   */
+   void setBranches(const QVector<Branch> &branches, const QString &currentBranch);
+   /*!
+    \brief Updates the branches of the model with the differences with the ones it has: the branches removed, the
+    new ones and the ones that changed are notified one by one, so the view keeps its expanded folders and selection.
+
+    \param branches The branches.
+    \param currentBranch The name of the branch checked out.
+   */
+   void updateBranches(const QVector<Branch> &branches, const QString &currentBranch);
+   /*!
+    \brief Removes all the branches.
+   */
+   void clear();
+   /*!
+    \brief Returns the index of the name of a branch. The folders that contain it are populated if they were not.
+
+    \param fullName The full name of the branch.
+    \return The index, invalid if the branch is not in the model.
+   */
+   QModelIndex fetchBranch(const QString &fullName);
+   /*!
+    \brief Sets the text that the names of the branches have to contain to be shown.
+
+    \param text The text to look for. All the branches are shown when it's empty.
+   */
+   void setFilter(const QString &text);
+   /*!
+    \brief Returns the number of branches of the model, without the folders.
+
+    \return The number of branches.
+   */
+   int branchCount() const { return mRoot->branchCount; }
+
+   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex parent(const QModelIndex &index) const override;
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+   bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+   bool canFetchMore(const QModelIndex &parent) const override;
+   void fetchMore(const QModelIndex &parent) override;
+   QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+   struct Entry
+   {
+      ~Entry() { qDeleteAll(children); }
+
+      QString name;
+      QString path; /*!< The name with the folders that contain the entry. */
+      QString fullName;
+      QString sha;
+      QString masterDistance;
+      QString originDistance;
+      bool isLeaf = false;
+      bool isCurrent = false;
+      bool fetched = false;
+      int depth = 0; /*!< The number of parts of the name of the folder. */
+      int branchCount = 0;
+      Entry *parent = nullptr;
+      int row = 0;
+      QVector<Entry *> children;
+      QHash<QString, Entry *> folders;
+      QVector<Branch> pending; /*!< The branches of the folder while it's not populated. */
+   };
+
+   bool mIsLocal = false;
+   QString mCurrentBranch;
+   QScopedPointer<Entry> mRoot;
+   QHash<QString, Entry *> mBranches;
+   QStringList mNames;
+   RefNameIndex mIndex;
+   bool mIndexOutdated = true;
+   QString mFilter;
+   QSet<QString> mVisiblePaths;
+
+   Entry *entry(const QModelIndex &index) const;
+   QModelIndex indexOf(Entry *entry) const;
+   Entry *createChild(Entry *parent, const QString &name, int row) const;
+   void initLeaf(Entry *item, const Branch &branch);
+   void fetch(Entry *folder, bool notify);
+   void insertBranch(const Branch &branch, Entry *parent, int depth);
+   void removeEntry(Entry *item);
+   void collectUnfetched(Entry *folder, QVector<Entry *> &folders) const;
+   int updateCounts(Entry *folder);
+   void setNames(const QVector<Branch> &branches);
+   void applyFilter();
+};
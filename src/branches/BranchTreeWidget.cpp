@@ -12,29 +12,51 @@
 using namespace GitQlient;
 
 BranchTreeWidget::BranchTreeWidget(const QSharedPointer<GitBase> &git, QWidget *parent)
-   : QTreeWidget(parent)
+   : QTreeView(parent)
    , mGit(git)
 {
    setContextMenuPolicy(Qt::CustomContextMenu);
    setAttribute(Qt::WA_DeleteOnClose);
 
    connect(this, &BranchTreeWidget::customContextMenuRequested, this, &BranchTreeWidget::showBranchesContextMenu);
-   connect(this, &BranchTreeWidget::itemClicked, this, &BranchTreeWidget::selectCommit);
-   connect(this, &BranchTreeWidget::itemDoubleClicked, this, &BranchTreeWidget::checkoutBranch);
+   connect(this, &BranchTreeWidget::clicked, this, &BranchTreeWidget::selectCommit);
+   connect(this, &BranchTreeWidget::doubleClicked, this, &BranchTreeWidget::checkoutBranch);
+}
+
+void BranchTreeWidget::applyFilter()
+{
+   if (const auto rows = model() ? model()->rowCount() : 0; rows > 0)
+      filterRows(QModelIndex(), 0, rows - 1);
+}
+
+void BranchTreeWidget::filterRows(const QModelIndex &parent, int first, int last)
+{
+   for (auto row = first; row <= last; ++row)
+   {
+      const auto index = model()->index(row, 0, parent);
+      const auto hidden = !index.data(MatchesFilterRole).toBool();
+
+      if (isRowHidden(row, parent) != hidden)
+         setRowHidden(row, parent, hidden);
+
+      // Only the rows that exist are filtered: the folders not populated yet are filtered when they are.
+      if (const auto rows = model()->rowCount(index); !hidden && rows > 0)
+         filterRows(index, 0, rows - 1);
+   }
 }
 
 void BranchTreeWidget::showBranchesContextMenu(const QPoint &pos)
 {
-   const auto item = itemAt(pos);
+   const auto index = indexAt(pos);
 
-   if (item)
+   if (index.isValid())
    {
       auto currentBranch = mGit->getCurrentBranch();
-      auto selectedBranch = item->data(0, FullNameRole).toString();
+      auto selectedBranch = index.data(FullNameRole).toString();
 
       const auto menu = new BranchContextMenu({ currentBranch, selectedBranch, mLocal, mGit }, this);
       connect(menu, &BranchContextMenu::signalBranchesUpdated, this, &BranchTreeWidget::signalBranchesUpdated);
-      connect(menu, &BranchContextMenu::signalCheckoutBranch, this, [this, item]() { checkoutBranch(item); });
+      connect(menu, &BranchContextMenu::signalCheckoutBranch, this, [this, index]() { checkoutBranch(index); });
       connect(menu, &BranchContextMenu::signalMergeRequired, this, &BranchTreeWidget::signalMergeRequired);
       connect(menu, &BranchContextMenu::signalPullConflict, this, &BranchTreeWidget::signalPullConflict);
 
@@ -42,15 +64,15 @@ void BranchTreeWidget::showBranchesContextMenu(const QPoint &pos)
    }
 }
 
-void BranchTreeWidget::checkoutBranch(QTreeWidgetItem *item)
+void BranchTreeWidget::checkoutBranch(const QModelIndex &index)
 {
-   if (item)
+   if (index.isValid())
    {
-      auto branchName = item->data(0, FullNameRole).toString();
+      auto branchName = index.data(FullNameRole).toString();
 
       if (!branchName.isEmpty())
       {
-         const auto isLocal = item->data(0, LocalBranchRole).toBool();
+         const auto isLocal = index.data(LocalBranchRole).toBool();
          QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
          QScopedPointer<GitBranches> git(new GitBranches(mGit));
          const auto ret
@@ -88,8 +110,8 @@ void BranchTreeWidget::checkoutBranch(QTreeWidgetItem *item)
    }
 }
 
-void BranchTreeWidget::selectCommit(QTreeWidgetItem *item)
+void BranchTreeWidget::selectCommit(const QModelIndex &index)
 {
-   if (item)
-      emit signalSelectCommit(item->data(0, Qt::UserRole + 3).toString());
+   if (index.isValid())
+      emit signalSelectCommit(index.data(ShaRole).toString());
 }
@@ -23,7 +23,7 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QTreeWidget>
+#include <QTreeView>
 
 class GitBase;
 
@@ -32,7 +32,7 @@ class GitBase;
  its remote branch.
 
 */
-class BranchTreeWidget : public QTreeWidget
+class BranchTreeWidget : public QTreeView
 {
    Q_OBJECT
 
@@ -79,6 +79,18 @@ public:
     \param isLocal True if the current widget shows local branches, otherwise false.
    */
    void setLocalRepo(const bool isLocal) { mLocal = isLocal; }
+   /*!
+    \brief Shows the rows that match the filter of the model and hides the others.
+   */
+   void applyFilter();
+   /*!
+    \brief Shows or hides some rows, and the rows they contain, depending on if they match the filter of the model.
+
+    \param parent The parent of the rows.
+    \param first The first row.
+    \param last The last row.
+   */
+   void filterRows(const QModelIndex &parent, int first, int last);
 
 private:
    bool mLocal = false;
@@ -91,15 +103,15 @@ private:
    */
    void showBranchesContextMenu(const QPoint &pos);
    /*!
-    \brief Checks out the branch selected by the \p item.
+    \brief Checks out the branch selected by the \p index.
 
-    \param item The item that contains the data of the branch.
+    \param index The index that contains the data of the branch.
    */
-   void checkoutBranch(QTreeWidgetItem *item);
+   void checkoutBranch(const QModelIndex &index);
    /*!
-    \brief Selects the commit of the given \p item branch.
+    \brief Selects the commit of the given \p index branch.
 
-    \param item The item that contains the data of the branch selected to extract the commit SHA.
+    \param index The index that contains the data of the branch selected to extract the commit SHA.
    */
-   void selectCommit(QTreeWidgetItem *item);
+   void selectCommit(const QModelIndex &index);
 };
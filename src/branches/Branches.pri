@@ -7,18 +7,22 @@ FORMS += \
 HEADERS += \
     $$PWD/AddSubmoduleDlg.h \
     $$PWD/BranchContextMenu.h \
+    $$PWD/BranchTreeModel.h \
     $$PWD/BranchTreeWidget.h \
     $$PWD/BranchesViewDelegate.h \
     $$PWD/BranchesWidget.h \
     $$PWD/GitQlientBranchItemRole.h \
+    $$PWD/RefNameIndex.h \
     $$PWD/StashesContextMenu.h \
     $$PWD/TagDlg.h
 
 SOURCES += \
     $$PWD/AddSubmoduleDlg.cpp \
     $$PWD/BranchContextMenu.cpp \
+    $$PWD/BranchTreeModel.cpp \
     $$PWD/BranchTreeWidget.cpp \
     $$PWD/BranchesViewDelegate.cpp \
     $$PWD/BranchesWidget.cpp \
+    $$PWD/RefNameIndex.cpp \
     $$PWD/StashesContextMenu.cpp \
     $$PWD/TagDlg.cpp
@@ -1,10 +1,13 @@
 #include "BranchesWidget.h"
 
 #include <BranchTreeWidget.h>
+#include <BranchTreeModel.h>
 #include <GitBase.h>
 #include <GitTags.h>
 #include <GitSubmodules.h>
+#include <GitSubmodulesStatus.h>
 #include <GitStashes.h>
+#include <GitHistory.h>
 #include <BranchesViewDelegate.h>
 #include <ClickableFrame.h>
 #include <AddSubmoduleDlg.h>
@@ -16,41 +19,30 @@
 #include <QVBoxLayout>
 #include <QHeaderView>
 #include <QListWidget>
+#include <QLineEdit>
 #include <QLabel>
 #include <QMenu>
 #include <QHeaderView>
 
 #include <QLogger.h>
 
+#include <algorithm>
+
 using namespace QLogger;
 using namespace GitQlient;
 
-namespace
-{
-QTreeWidgetItem *getChild(QTreeWidgetItem *parent, const QString &childName)
-{
-   QTreeWidgetItem *child = nullptr;
-
-   if (parent)
-   {
-      const auto childrenCount = parent->childCount();
-
-      for (auto i = 0; i < childrenCount; ++i)
-         if (parent->child(i)->text(0) == childName)
-            child = parent->child(i);
-   }
-
-   return child;
-}
-}
+static const qint64 REMOTE_TAGS_TTL_MS = 5 * 60 * 1000;
 
 BranchesWidget::BranchesWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                                QWidget *parent)
    : QFrame(parent)
    , mCache(cache)
    , mGit(git)
+   , mFilter(new QLineEdit())
    , mLocalBranchesTree(new BranchTreeWidget(mGit))
    , mRemoteBranchesTree(new BranchTreeWidget(mGit))
+   , mLocalBranchesModel(new BranchTreeModel(true, this))
+   , mRemoteBranchesModel(new BranchTreeModel(false, this))
    , mTagsList(new QListWidget())
    , mStashesList(new QListWidget())
    , mSubmodulesList(new QListWidget())
@@ -59,27 +51,23 @@ BranchesWidget::BranchesWidget(const QSharedPointer<RevisionsCache> &cache, cons
    , mStashesArrow(new QLabel())
    , mSubmodulesCount(new QLabel("(0)"))
    , mSubmodulesArrow(new QLabel())
+   , mSubmodulesStatus(new GitSubmodulesStatus(mGit, this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
+   mFilter->setPlaceholderText(tr("Filter branches, tags, stashes and submodules..."));
+   mFilter->setClearButtonEnabled(true);
+
    mLocalBranchesTree->setLocalRepo(true);
    mLocalBranchesTree->setMouseTracking(true);
    mLocalBranchesTree->setItemDelegate(new BranchesViewDelegate());
-   mLocalBranchesTree->setColumnCount(3);
-
-   const auto localHeader = mLocalBranchesTree->headerItem();
-   localHeader->setText(0, QString("   %1").arg(tr("Local")));
-   localHeader->setIcon(0, QIcon(":/icons/local"));
-   localHeader->setText(1, tr("Master"));
-   localHeader->setText(2, tr("Origin"));
+   mLocalBranchesTree->setModel(mLocalBranchesModel);
+   mLocalBranchesTree->setUniformRowHeights(true);
 
-   mRemoteBranchesTree->setColumnCount(1);
    mRemoteBranchesTree->setMouseTracking(true);
    mRemoteBranchesTree->setItemDelegate(new BranchesViewDelegate());
-
-   const auto remoteHeader = mRemoteBranchesTree->headerItem();
-   remoteHeader->setText(0, QString("   %1").arg(tr("Remote")));
-   remoteHeader->setIcon(0, QIcon(":/icons/server"));
+   mRemoteBranchesTree->setModel(mRemoteBranchesModel);
+   mRemoteBranchesTree->setUniformRowHeights(true);
 
    /* TAGS */
 
@@ -164,7 +152,8 @@ BranchesWidget::BranchesWidget(const QSharedPointer<RevisionsCache> &cache, cons
    mSubmodulesList->setMouseTracking(true);
    mSubmodulesList->setContextMenuPolicy(Qt::CustomContextMenu);
    connect(mSubmodulesList, &QListWidget::itemDoubleClicked, this,
-           [this](QListWidgetItem *item) { emit signalOpenSubmodule(item->text()); });
+           [this](QListWidgetItem *item) { emit signalOpenSubmodule(item->data(Qt::UserRole).toString()); });
+   connect(mSubmodulesStatus, &GitSubmodulesStatus::signalStatusChanged, this, &BranchesWidget::showSubmoduleStatus);
 
    const auto submoduleLayout = new QVBoxLayout();
    submoduleLayout->setContentsMargins(QMargins());
@@ -178,6 +167,7 @@ BranchesWidget::BranchesWidget(const QSharedPointer<RevisionsCache> &cache, cons
 
    const auto vLayout = new QVBoxLayout(this);
    vLayout->setContentsMargins(QMargins());
+   vLayout->addWidget(mFilter);
    vLayout->addWidget(mLocalBranchesTree);
    vLayout->addWidget(mRemoteBranchesTree);
    vLayout->addLayout(tagLayout);
@@ -186,6 +176,13 @@ BranchesWidget::BranchesWidget(const QSharedPointer<RevisionsCache> &cache, cons
 
    setLayout(vLayout);
 
+   connect(mFilter, &QLineEdit::textChanged, this, &BranchesWidget::applyFilter);
+   connect(mLocalBranchesModel, &BranchTreeModel::signalFilterChanged, mLocalBranchesTree,
+           &BranchTreeWidget::applyFilter);
+   connect(mLocalBranchesModel, &BranchTreeModel::rowsInserted, mLocalBranchesTree, &BranchTreeWidget::filterRows);
+   connect(mRemoteBranchesModel, &BranchTreeModel::signalFilterChanged, mRemoteBranchesTree,
+           &BranchTreeWidget::applyFilter);
+   connect(mRemoteBranchesModel, &BranchTreeModel::rowsInserted, mRemoteBranchesTree, &BranchTreeWidget::filterRows);
    connect(mLocalBranchesTree, &BranchTreeWidget::signalSelectCommit, this, &BranchesWidget::signalSelectCommit);
    connect(mLocalBranchesTree, &BranchTreeWidget::signalSelectCommit, mRemoteBranchesTree,
            &BranchTreeWidget::clearSelection);
@@ -216,44 +213,16 @@ void BranchesWidget::showBranches()
 {
    QLog_Info("UI", QString("Loading branches data"));
 
-   clear();
+   // The branch trees are updated with the differences, so they keep their folders expanded and their selection. The
+   // stashes and the submodules keep their lists until the new ones arrive.
+   blockSignals(true);
+   mTagsList->clear();
+   blockSignals(false);
 
    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-   auto branches = mCache->getBranches(References::Type::LocalBranch);
-
-   if (!branches.empty())
-   {
-      QLog_Info("UI", QString("Fetched {%1} local branches").arg(branches.count()));
-      QLog_Info("UI", QString("Processing local branches..."));
-
-      for (const auto &pair : branches)
-      {
-         for (const auto &branch : pair.second)
-            if (!branch.contains("HEAD->"))
-               processLocalBranch(pair.first, branch);
-      }
-
-      QLog_Info("UI", QString("... local branches processed"));
-   }
-
-   branches = mCache->getBranches(References::Type::RemoteBranches);
-
-   if (!branches.empty())
-   {
-      QLog_Info("UI", QString("Fetched {%1} remote branches").arg(branches.count()));
-      QLog_Info("UI", QString("Processing remote branches..."));
-
-      for (const auto &pair : branches)
-      {
-         for (const auto &branch : pair.second)
-            if (!branch.contains("HEAD->"))
-               processRemoteBranch(pair.first, branch);
-      }
-
-      QLog_Info("UI", QString("... rmote branches processed"));
-   }
-
+   processLocalBranches();
+   processRemoteBranches();
    processTags();
    processStashes();
    processSubmodules();
@@ -261,234 +230,419 @@ void BranchesWidget::showBranches()
    QApplication::restoreOverrideCursor();
 
    adjustBranchesTree(mLocalBranchesTree);
+
+   // The branch trees keep their filter, but the list of tags is filled again.
+   filterList(mTagsList, mTagsIndex);
 }
 
 void BranchesWidget::clear()
 {
+   cancelRequests();
+
+   mSubmodulesStatus->cancel();
+   mRemoteTags.clear();
+   mRemoteTagsAge.invalidate();
+
    blockSignals(true);
-   mLocalBranchesTree->clear();
-   mRemoteBranchesTree->clear();
+   mLocalBranchesModel->clear();
+   mRemoteBranchesModel->clear();
+   mCurrentBranch.clear();
    mTagsList->clear();
    mStashesList->clear();
    mSubmodulesList->clear();
+   mTagsIndex.clear();
+   mStashesIndex.clear();
+   mSubmodulesIndex.clear();
    blockSignals(false);
 }
 
-void BranchesWidget::processLocalBranch(const QString &sha, QString branch)
+void BranchesWidget::processLocalBranches()
 {
-   QLog_Debug("UI", QString("Adding local branch {%1}").arg(branch));
-
-   auto isCurrentBranch = false;
+   const auto branches = mCache->getBranches(References::Type::LocalBranch);
+   QVector<BranchTreeModel::Branch> items;
 
-   if (branch == mGit->getCurrentBranch())
-      isCurrentBranch = true;
+   QLog_Info("UI", QString("Processing {%1} local branches...").arg(branches.count()));
 
-   const auto fullBranchName = branch;
-
-   QVector<QTreeWidgetItem *> parents;
-   QTreeWidgetItem *parent = nullptr;
-   auto folders = branch.split("/");
-   branch = folders.takeLast();
-
-   for (const auto &folder : qAsConst(folders))
+   for (const auto &pair : branches)
    {
-      QTreeWidgetItem *child = nullptr;
-
-      if (parent)
-      {
-         child = getChild(parent, folder);
-         parents.append(child);
-      }
-      else
+      for (const auto &branch : pair.second)
       {
-         for (auto i = 0; i < mLocalBranchesTree->topLevelItemCount(); ++i)
-         {
-            if (mLocalBranchesTree->topLevelItem(i)->text(0) == folder)
-            {
-               child = mLocalBranchesTree->topLevelItem(i);
-               parents.append(child);
-            }
-         }
-      }
+         if (branch.contains("HEAD->"))
+            continue;
 
-      if (!child)
-      {
-         const auto item = parent ? new QTreeWidgetItem(parent) : new QTreeWidgetItem();
-         item->setText(0, folder);
+         BranchTreeModel::Branch item { branch, pair.first, QString(), QString() };
 
-         if (!parent)
-            mLocalBranchesTree->addTopLevelItem(item);
+         if (branch != "detached")
+         {
+            const auto distances = mCache->getLocalBranchDistances(branch);
 
-         parent = item;
-         parents.append(parent);
-      }
-      else
-      {
-         parent = child;
-         parents.append(child);
-      }
-   }
+            const auto distanceText = QString("%1 \u2193 - %2 \u2191");
 
-   auto item = new QTreeWidgetItem(parent);
-   item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
-   item->setText(0, branch);
-   item->setData(0, GitQlient::IsCurrentBranchRole, isCurrentBranch);
-   item->setData(0, GitQlient::FullNameRole, fullBranchName);
-   item->setData(0, GitQlient::LocalBranchRole, true);
-   item->setData(0, GitQlient::ShaRole, sha);
-   item->setData(0, Qt::ToolTipRole, fullBranchName);
-   item->setData(0, GitQlient::IsLeaf, true);
-
-   if (isCurrentBranch)
-   {
-      item->setSelected(true);
+            item.masterDistance = distanceText.arg(distances.behindMaster).arg(distances.aheadMaster);
+            item.originDistance = distanceText.arg(distances.behindOrigin).arg(distances.aheadOrigin);
+         }
 
-      for (const auto parent : parents)
-      {
-         mLocalBranchesTree->setCurrentItem(item);
-         mLocalBranchesTree->expandItem(parent);
-         const auto indexToScroll = mLocalBranchesTree->currentIndex();
-         mLocalBranchesTree->scrollTo(indexToScroll);
+         items.append(item);
       }
    }
 
-   QLog_Debug("UI", QString("Calculating distances..."));
+   const auto currentBranch = mGit->getCurrentBranch();
+   const auto branchChanged = currentBranch != mCurrentBranch;
+
+   mCurrentBranch = currentBranch;
+   mLocalBranchesModel->updateBranches(items, currentBranch);
 
-   if (fullBranchName != "detached")
+   // The current branch is only selected when it changes, otherwise the selection of the user is kept.
+   if (const auto index = branchChanged ? mLocalBranchesModel->fetchBranch(currentBranch) : QModelIndex();
+       index.isValid())
    {
-      const auto distances = mCache->getLocalBranchDistances(fullBranchName);
+      mLocalBranchesTree->setCurrentIndex(index);
 
-      item->setText(1, QString("%1 \u2193 - %2 \u2191").arg(distances.behindMaster).arg(distances.aheadMaster));
-      item->setText(2, QString("%1 \u2193 - %2 \u2191").arg(distances.behindOrigin).arg(distances.aheadOrigin));
-   }
+      for (auto parent = index.parent(); parent.isValid(); parent = parent.parent())
+         mLocalBranchesTree->expand(parent);
 
-   mLocalBranchesTree->addTopLevelItem(item);
+      mLocalBranchesTree->scrollTo(index);
+   }
 
-   QLog_Debug("UI", QString("Finish gathering local branch information"));
+   QLog_Info("UI", QString("... local branches processed"));
 }
 
-void BranchesWidget::processRemoteBranch(const QString &sha, QString branch)
+void BranchesWidget::processRemoteBranches()
 {
-   const auto fullBranchName = branch;
-   auto folders = branch.split("/");
-   branch = folders.takeLast();
+   const auto branches = mCache->getBranches(References::Type::RemoteBranches);
+   QVector<BranchTreeModel::Branch> items;
 
-   QTreeWidgetItem *parent = nullptr;
+   QLog_Info("UI", QString("Processing {%1} remote branches...").arg(branches.count()));
 
-   for (const auto &folder : qAsConst(folders))
+   for (const auto &pair : branches)
    {
-      QTreeWidgetItem *child = nullptr;
-
-      if (parent)
-         child = getChild(parent, folder);
-      else
+      for (const auto &branch : pair.second)
       {
-         for (auto i = 0; i < mRemoteBranchesTree->topLevelItemCount(); ++i)
-         {
-            if (mRemoteBranchesTree->topLevelItem(i)->text(0) == folder)
-               child = mRemoteBranchesTree->topLevelItem(i);
-         }
-      }
-
-      if (!child)
-      {
-         const auto item = parent ? new QTreeWidgetItem(parent) : new QTreeWidgetItem();
-         item->setText(0, folder);
-
-         if (!parent)
-            mRemoteBranchesTree->addTopLevelItem(item);
-
-         parent = item;
+         if (!branch.contains("HEAD->"))
+            items.append({ branch, pair.first, QString(), QString() });
       }
-      else
-         parent = child;
    }
 
-   QLog_Debug("UI", QString("Adding remote branch {%1}").arg(branch));
+   mRemoteBranchesModel->updateBranches(items, QString());
 
-   const auto item = new QTreeWidgetItem(parent);
-   item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
-   item->setText(0, branch);
-   item->setData(0, GitQlient::FullNameRole, fullBranchName);
-   item->setData(0, GitQlient::LocalBranchRole, false);
-   item->setData(0, GitQlient::ShaRole, sha);
-   item->setData(0, Qt::ToolTipRole, fullBranchName);
-   item->setData(0, GitQlient::IsLeaf, true);
+   QLog_Info("UI", QString("... remote branches processed"));
 }
 
 void BranchesWidget::processTags()
 {
-   QVector<QString> localTags;
+   QStringList names;
    const auto tags = mCache->getTags();
 
    QLog_Info("UI", QString("Fetching {%1} tags").arg(tags.count()));
 
    for (const auto &tag : tags)
    {
-      for (auto tagName : tag.second)
+      for (const auto &tagName : tag.second)
       {
-         const auto item = new QListWidgetItem();
+         const auto item = new QListWidgetItem(tagName);
          item->setData(Qt::UserRole, tagName);
          item->setData(Qt::UserRole + 1, true);
          item->setData(Qt::UserRole + 2, tag.first);
 
-         if (localTags.contains(tagName))
-         {
-            tagName += " (local)";
-            item->setData(Qt::UserRole + 1, false);
-         }
-
-         item->setText(tagName);
          mTagsList->addItem(item);
+         names.append(tagName);
       }
    }
 
+   mTagsIndex.setNames(names);
    mTagsCount->setText(QString("(%1)").arg(tags.count()));
+
+   markLocalTags();
+   requestRemoteTags();
+}
+
+void BranchesWidget::markLocalTags()
+{
+   if (!mRemoteTagsAge.isValid())
+      return;
+
+   for (auto row = 0; row < mTagsList->count(); ++row)
+   {
+      const auto item = mTagsList->item(row);
+      const auto tagName = item->data(Qt::UserRole).toString();
+      const auto isRemote = mRemoteTags.contains(tagName);
+
+      if (item->data(Qt::UserRole + 1).toBool() != isRemote)
+      {
+         item->setData(Qt::UserRole + 1, isRemote);
+         item->setText(isRemote ? tagName : QString("%1 (local)").arg(tagName));
+      }
+   }
+}
+
+void BranchesWidget::requestRemoteTags()
+{
+   if (mRemoteTagsRequest != -1 || (mRemoteTagsAge.isValid() && !mRemoteTagsAge.hasExpired(REMOTE_TAGS_TTL_MS)))
+      return;
+
+   QScopedPointer<GitTags> git(new GitTags(mGit));
+
+   mRemoteTagsRequest = git->getRemoteTags(this, [this](const GitExecResult &result) {
+      mRemoteTagsRequest = -1;
+
+      // A remote that can't be reached is not asked again until the list gets old: the tags keep their last state.
+      if (result.success)
+         mRemoteTags = GitTags::parseRemoteTags(result.output.toString());
+      else
+         QLog_Info("UI", QString("The tags of origin couldn't be listed"));
+
+      if (result.success || !mRemoteTagsAge.isValid())
+         mRemoteTagsAge.start();
+
+      markLocalTags();
+   });
 }
 
 void BranchesWidget::processStashes()
 {
+   if (mStashesRequest != -1)
+      mGit->cancel(mStashesRequest);
+
    QScopedPointer<GitStashes> git(new GitStashes(mGit));
-   const auto stashes = git->getStashes();
 
-   QLog_Info("UI", QString("Fetching {%1} stashes").arg(stashes.count()));
+   mStashesRequest = git->getStashes(this, [this](const GitExecResult &result) {
+      mStashesRequest = -1;
 
-   for (const auto &stash : stashes)
+      const auto stashes = result.success ? GitStashes::parseStashes(result.output.toString()) : QVector<QString>();
+      QStringList names;
+      QVector<QString> stashIds;
+
+      QLog_Info("UI", QString("Fetching {%1} stashes").arg(stashes.count()));
+
+      mStashesList->clear();
+
+      for (const auto &stash : stashes)
+      {
+         const auto stashId = stash.split(":").first();
+         const auto stashDesc = stash.split("}: ").last();
+         const auto item = new QListWidgetItem(stashDesc);
+         item->setData(Qt::UserRole, stashId);
+         mStashesList->addItem(item);
+         names.append(stashDesc);
+         stashIds.append(stashId);
+      }
+
+      mStashesIndex.setNames(names);
+      filterList(mStashesList, mStashesIndex);
+
+      mStashesCount->setText(QString("(%1)").arg(stashes.count()));
+
+      if (result.success)
+         prefetchStashes(stashIds);
+   });
+}
+
+void BranchesWidget::prefetchStashes(const QVector<QString> &stashIds)
+{
+   for (auto request : { &mStashCommitsRequest, &mStashFilesRequest })
    {
-      const auto stashId = stash.split(":").first();
-      const auto stashDesc = stash.split("}: ").last();
-      const auto item = new QListWidgetItem(stashDesc);
-      item->setData(Qt::UserRole, stashId);
-      mStashesList->addItem(item);
+      if (*request != -1)
+         mGit->cancel(*request);
+
+      *request = -1;
+   }
+
+   if (stashIds.isEmpty())
+   {
+      mStashCommits.clear();
+      mCache->retainStashRevisionFiles({});
+      return;
    }
 
-   mStashesCount->setText(QString("(%1)").arg(stashes.count()));
+   QScopedPointer<GitStashes> git(new GitStashes(mGit));
+
+   mStashCommitsRequest = git->getStashCommits(stashIds, this, [this, stashIds](const GitExecResult &result) {
+      mStashCommitsRequest = -1;
+
+      if (!result.success)
+         return;
+
+      const auto commits = GitStashes::parseStashCommits(result.output.toString());
+      const auto count = std::min(commits.count(), stashIds.count());
+      QVector<QString> shas;
+      QVector<QPair<QString, QString>> missingDiffs;
+
+      mStashCommits.clear();
+
+      for (auto i = 0; i < count; ++i)
+      {
+         const auto &commit = commits.at(i);
+
+         mStashCommits.insert(stashIds.at(i), commit.first);
+         shas.append(commit.first);
+
+         if (commit.second.isEmpty())
+            continue;
+
+         // The files shown in the history before are moved out of the budget instead of being read again.
+         if (mCache->containsRevisionFile(commit.first, commit.second))
+            mCache->insertStashRevisionFile(commit.first, commit.second,
+                                            mCache->getRevisionFile(commit.first, commit.second));
+         else
+            missingDiffs.append(commit);
+      }
+
+      mCache->retainStashRevisionFiles(shas);
+
+      if (missingDiffs.isEmpty())
+         return;
+
+      QLog_Debug("UI", QString("Prefetching the files of {%1} stashes").arg(missingDiffs.count()));
+
+      mStashFilesRequest = mGit->runAsync(
+          GitHistory::diffFilesBatchArguments(), this,
+          [this, missingDiffs](const GitExecResult &result) {
+             mStashFilesRequest = -1;
+
+             if (!result.success)
+                return;
+
+             const auto parsedDiffs = mCache->parseDiffs(result.output.toString());
+             auto parsed = parsedDiffs.constBegin();
+
+             for (const auto &diff : missingDiffs)
+             {
+                if (parsed == parsedDiffs.constEnd() || parsed->first != diff.first)
+                   continue;
+
+                mCache->insertStashRevisionFile(diff.first, diff.second, parsed->second);
+
+                ++parsed;
+             }
+          },
+          GitBase::Priority::Background, GitHistory::diffFilesBatchInput(missingDiffs));
+   });
 }
 
 void BranchesWidget::processSubmodules()
 {
+   if (mSubmodulesRequest != -1)
+      mGit->cancel(mSubmodulesRequest);
+
    QScopedPointer<GitSubmodules> git(new GitSubmodules(mGit));
-   const auto submodules = git->getSubmodules();
 
-   QLog_Info("UI", QString("Fetching {%1} submodules").arg(submodules.count()));
+   mSubmodulesRequest = git->getSubmodules(this, [this](const GitExecResult &result) {
+      mSubmodulesRequest = -1;
+
+      // Without .gitmodules git fails: there are no submodules.
+      const auto submodules
+          = result.success ? GitSubmodules::parseSubmodules(result.output.toString()) : QVector<QString>();
+
+      QLog_Info("UI", QString("Fetching {%1} submodules").arg(submodules.count()));
+
+      mSubmodulesList->clear();
+
+      for (const auto &submodule : submodules)
+      {
+         const auto item = new QListWidgetItem(submodule);
+         item->setData(Qt::UserRole, submodule);
+         mSubmodulesList->addItem(item);
+
+         showSubmoduleStatus(submodule);
+      }
+
+      mSubmodulesIndex.setNames(QStringList(submodules.toList()));
+      filterList(mSubmodulesList, mSubmodulesIndex);
 
-   for (const auto &submodule : submodules)
-      mSubmodulesList->addItem(submodule);
+      mSubmodulesCount->setText(QString("(%1)").arg(submodules.count()));
+
+      mSubmodulesStatus->scan(submodules);
+   });
+}
+
+void BranchesWidget::showSubmoduleStatus(const QString &submodule)
+{
+   GitSubmodulesStatus::Status status;
+
+   if (!mSubmodulesStatus->status(submodule, status))
+      return;
+
+   QStringList states;
+
+   if (!status.initialized)
+      states.append(tr("not initialized"));
+
+   if (status.modified)
+      states.append(tr("modified"));
+
+   if (status.outOfDate)
+      states.append(tr("out of date"));
+
+   const auto text = states.isEmpty() ? submodule : QString("%1 (%2)").arg(submodule, states.join(", "));
+
+   for (auto row = 0; row < mSubmodulesList->count(); ++row)
+   {
+      if (const auto item = mSubmodulesList->item(row); item->data(Qt::UserRole).toString() == submodule)
+      {
+         item->setText(text);
+         break;
+      }
+   }
+}
+
+void BranchesWidget::cancelRequests()
+{
+   for (auto request :
+        { &mRemoteTagsRequest, &mStashesRequest, &mSubmodulesRequest, &mStashCommitsRequest, &mStashFilesRequest })
+   {
+      if (*request != -1)
+         mGit->cancel(*request);
+
+      *request = -1;
+   }
 }
 
 void BranchesWidget::adjustBranchesTree(BranchTreeWidget *treeWidget)
 {
-   for (auto i = 1; i < treeWidget->columnCount(); ++i)
+   const auto columnCount = treeWidget->model()->columnCount();
+
+   for (auto i = 1; i < columnCount; ++i)
       treeWidget->resizeColumnToContents(i);
 
    treeWidget->header()->setSectionResizeMode(0, QHeaderView::Stretch);
 
-   for (auto i = 1; i < treeWidget->columnCount(); ++i)
+   for (auto i = 1; i < columnCount; ++i)
       treeWidget->header()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
 
    treeWidget->header()->setStretchLastSection(false);
 }
 
+void BranchesWidget::applyFilter()
+{
+   const auto text = mFilter->text();
+
+   mLocalBranchesModel->setFilter(text);
+   mRemoteBranchesModel->setFilter(text);
+
+   filterList(mTagsList, mTagsIndex);
+   filterList(mStashesList, mStashesIndex);
+   filterList(mSubmodulesList, mSubmodulesIndex);
+}
+
+void BranchesWidget::filterList(QListWidget *list, const RefNameIndex &index)
+{
+   const auto text = mFilter->text();
+   QVector<bool> visible(list->count(), text.isEmpty());
+
+   for (const auto id : index.find(text))
+   {
+      if (id < visible.count())
+         visible[id] = true;
+   }
+
+   // Only the rows that change are hidden or shown.
+   for (auto row = 0; row < list->count(); ++row)
+   {
+      if (list->isRowHidden(row) == visible.at(row))
+         list->setRowHidden(row, !visible.at(row));
+   }
+}
+
 void BranchesWidget::showTagsContextMenu(const QPoint &p)
 {
    QModelIndex index = mTagsList->indexAt(p);
@@ -507,7 +661,10 @@ void BranchesWidget::showTagsContextMenu(const QPoint &p)
       QApplication::restoreOverrideCursor();
 
       if (ret.success)
+      {
+         mRemoteTagsAge.invalidate();
          emit signalBranchesUpdated();
+      }
    });
 
    const auto pushTagAction = menu->addAction(tr("Push tag"));
@@ -519,7 +676,10 @@ void BranchesWidget::showTagsContextMenu(const QPoint &p)
       QApplication::restoreOverrideCursor();
 
       if (ret.success)
+      {
+         mRemoteTagsAge.invalidate();
          emit signalBranchesUpdated();
+      }
    });
 
    menu->exec(mTagsList->viewport()->mapToGlobal(p));
@@ -560,7 +720,7 @@ void BranchesWidget::showSubmodulesContextMenu(const QPoint &p)
    }
    else
    {
-      const auto submoduleName = index.data().toString();
+      const auto submoduleName = index.data(Qt::UserRole).toString();
       const auto updateSubmoduleAction = menu->addAction(tr("Update"));
       connect(updateSubmoduleAction, &QAction::triggered, this, [this, submoduleName]() {
          QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
@@ -616,8 +776,15 @@ void BranchesWidget::onTagClicked(QListWidgetItem *item)
 
 void BranchesWidget::onStashClicked(QListWidgetItem *item)
 {
-   QScopedPointer<GitTags> git(new GitTags(mGit));
-   const auto sha = git->getTagCommit(item->data(Qt::UserRole).toString()).output.toString();
+   const auto stashId = item->data(Qt::UserRole).toString();
+   auto sha = mStashCommits.value(stashId);
+
+   // The commits of the stashes are resolved in the background after they are listed.
+   if (sha.isEmpty())
+   {
+      QScopedPointer<GitTags> git(new GitTags(mGit));
+      sha = git->getTagCommit(stashId).output.toString();
+   }
 
    emit signalSelectCommit(sha);
 }
@@ -23,14 +23,22 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <RefNameIndex.h>
+
+#include <QElapsedTimer>
 #include <QFrame>
+#include <QHash>
+#include <QSet>
 
 class BranchTreeWidget;
+class BranchTreeModel;
 class QListWidget;
 class QListWidgetItem;
 class QLabel;
+class QLineEdit;
 class GitBase;
 class RevisionsCache;
+class GitSubmodulesStatus;
 
 /*!
  \brief BranchesWidget is the widget that creates the layout that contains all the widgets related with the display of
@@ -102,8 +110,12 @@ public:
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
+   QLineEdit *mFilter = nullptr;
    BranchTreeWidget *mLocalBranchesTree = nullptr;
    BranchTreeWidget *mRemoteBranchesTree = nullptr;
+   BranchTreeModel *mLocalBranchesModel = nullptr;
+   BranchTreeModel *mRemoteBranchesModel = nullptr;
+   QString mCurrentBranch;
    QListWidget *mTagsList = nullptr;
    QListWidget *mStashesList = nullptr;
    QListWidget *mSubmodulesList = nullptr;
@@ -113,36 +125,72 @@ private:
    QLabel *mStashesArrow = nullptr;
    QLabel *mSubmodulesCount = nullptr;
    QLabel *mSubmodulesArrow = nullptr;
+   RefNameIndex mTagsIndex;
+   QSet<QString> mRemoteTags;
+   QElapsedTimer mRemoteTagsAge;
+   int mRemoteTagsRequest = -1;
+   int mStashesRequest = -1;
+   int mSubmodulesRequest = -1;
+   int mStashCommitsRequest = -1;
+   int mStashFilesRequest = -1;
+   QHash<QString, QString> mStashCommits;
+   GitSubmodulesStatus *mSubmodulesStatus = nullptr;
+   RefNameIndex mStashesIndex;
+   RefNameIndex mSubmodulesIndex;
 
    /*!
-    \brief Method that for a given \p branch process all the informatio and creates the item that will be stored in the
-    local branches BranchTreeWidget.
-
-    \param branch The branch to be added in the tree widget.
+    \brief Builds the tree of the local branches with their distances to master and to origin, and selects the current
+    branch.
    */
-   void processLocalBranch(const QString &sha, QString branch);
+   void processLocalBranches();
    /*!
-    \brief Method that for a given \p branch process al the information and creates the item that will be sotred in the
-    remote branches BranchTreeWidget.
-
-    \param branch The remote branch to be added in the tree widget.
+    \brief Builds the tree of the remote branches.
    */
-   void processRemoteBranch(const QString &sha, QString branch);
+   void processRemoteBranches();
    /*!
     \brief Process all the tags and adds them into the QListWidget.
 
    */
    void processTags();
    /*!
-    \brief Process all the stashes and adds them into the QListWidget.
+    \brief Marks the tags that are not in origin as local. The tags of origin are the ones that were last listed: until
+    they are listed the first time, all the tags are considered remote.
+   */
+   void markLocalTags();
+   /*!
+    \brief Lists the tags of origin in the background if they were never listed or the list is too old. The tags are
+    marked again when the list arrives.
+   */
+   void requestRemoteTags();
+   /*!
+    \brief Lists the stashes in the background and fills the QListWidget when they arrive. The request of a previous
+    refresh that didn't finish is cancelled.
 
    */
    void processStashes();
    /*!
-    \brief Process all the submodules and adds them into QListWidget.
+    \brief Resolves the commits of the stashes and reads in the background the files of the ones that are not cached.
+    They are kept in the RevisionsCache until the stash is dropped, so clicking a stash doesn't run git.
+
+    \param stashIds The ids of the stashes, like stash@{0}.
+   */
+   void prefetchStashes(const QVector<QString> &stashIds);
+   /*!
+    \brief Lists the submodules in the background and fills the QListWidget when they arrive. The request of a
+    previous refresh that didn't finish is cancelled.
 
    */
    void processSubmodules();
+   /*!
+    \brief Shows the state of a submodule in its item of the list: not initialized, modified or out of date.
+
+    \param submodule The path of the submodule.
+   */
+   void showSubmoduleStatus(const QString &submodule);
+   /*!
+    \brief Cancels the requests of the stashes, the submodules and the tags of origin that didn't finish.
+   */
+   void cancelRequests();
    /*!
     \brief Once all the items have been added to the conrresponding BranchTreeWidget, the columns are adjusted to show
     the data correctly from a UI point of view.
@@ -150,6 +198,17 @@ private:
     \param treeWidget
    */
    void adjustBranchesTree(BranchTreeWidget *treeWidget);
+   /*!
+    \brief Filters the branches, tags, stashes and submodules with the text of the filter.
+   */
+   void applyFilter();
+   /*!
+    \brief Shows the rows of a list that match the filter and hides the others.
+
+    \param list The list.
+    \param index The index of the names of the rows of the list.
+   */
+   void filterList(QListWidget *list, const RefNameIndex &index);
    /*!
     \brief Shows the tags context menu.
 
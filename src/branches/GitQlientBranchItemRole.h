@@ -33,6 +33,8 @@ enum GitQlientBranchItemRole
    FullNameRole,
    LocalBranchRole,
    ShaRole,
-   IsLeaf
+   IsLeaf,
+   BranchCountRole,
+   MatchesFilterRole
 };
 }
@@ -0,0 +1,110 @@
+#include "RefNameIndex.h"
+
+#include <algorithm>
+
+static const int TRIGRAM_SIZE = 3;
+
+namespace
+{
+bool isPartSeparator(QChar c)
+{
+   return c == '/' || c == '-' || c == '_' || c == '.';
+}
+}
+
+void RefNameIndex::setNames(const QStringList &names)
+{
+   clear();
+
+   mNames = names;
+   mLowerNames.reserve(names.count());
+
+   for (auto id = 0; id < names.count(); ++id)
+   {
+      const auto lower = names.at(id).toLower();
+
+      mLowerNames.append(lower);
+      mParts.append({ id, 0 });
+
+      for (auto i = 1; i < lower.count(); ++i)
+      {
+         if (isPartSeparator(lower.at(i - 1)) && !isPartSeparator(lower.at(i)))
+            mParts.append({ id, i });
+      }
+
+      for (auto i = 0; i + TRIGRAM_SIZE <= lower.count(); ++i)
+      {
+         auto &ids = mTrigrams[trigram(lower.constData() + i)];
+
+         // The ids are added in order, so a trigram that repeats in a name only has to be compared with the last one.
+         if (ids.isEmpty() || ids.constLast() != id)
+            ids.append(id);
+      }
+   }
+
+   std::sort(mParts.begin(), mParts.end(),
+             [this](const Part &left, const Part &right) { return partText(left) < partText(right); });
+}
+
+void RefNameIndex::clear()
+{
+   mNames.clear();
+   mLowerNames.clear();
+   mParts.clear();
+   mTrigrams.clear();
+}
+
+QVector<int> RefNameIndex::find(const QString &text) const
+{
+   const auto lower = text.toLower();
+   QVector<int> ids;
+
+   if (lower.isEmpty())
+      return ids;
+
+   if (lower.count() < TRIGRAM_SIZE)
+   {
+      const auto isBefore = [this](const Part &part, const QString &text) { return partText(part).compare(text) < 0; };
+      auto part = std::lower_bound(mParts.cbegin(), mParts.cend(), lower, isBefore);
+
+      for (; part != mParts.cend() && partText(*part).startsWith(lower); ++part)
+         ids.append(part->id);
+
+      std::sort(ids.begin(), ids.end());
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+      return ids;
+   }
+
+   const QVector<int> *candidates = nullptr;
+
+   for (auto i = 0; i + TRIGRAM_SIZE <= lower.count(); ++i)
+   {
+      const auto iter = mTrigrams.constFind(trigram(lower.constData() + i));
+
+      if (iter == mTrigrams.cend())
+         return ids;
+
+      if (!candidates || iter->count() < candidates->count())
+         candidates = &iter.value();
+   }
+
+   for (const auto id : *candidates)
+   {
+      if (mLowerNames.at(id).contains(lower))
+         ids.append(id);
+   }
+
+   return ids;
+}
+
+QStringRef RefNameIndex::partText(const Part &part) const
+{
+   return mLowerNames.at(part.id).midRef(part.offset);
+}
+
+quint64 RefNameIndex::trigram(const QChar *text)
+{
+   return (static_cast<quint64>(text[0].unicode()) << 32) | (static_cast<quint64>(text[1].unicode()) << 16)
+       | text[2].unicode();
+}
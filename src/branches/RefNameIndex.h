@@ -0,0 +1,89 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ \brief The RefNameIndex class finds the names of references that contain a text without going through all of them. The
+ texts of three characters or more are looked up through the trigrams of the names: only the names that have the rarest
+ trigram of the text are compared. Shorter texts are looked up in a sorted list of the parts of the names, so they match
+ the names that have a part that starts with them.
+
+ The search doesn't take the case into account.
+
+ \class RefNameIndex RefNameIndex.h "RefNameIndex.h"
+*/
+class RefNameIndex
+{
+public:
+   /*!
+    \brief Builds the index of the names. The id of a name is its position in the list.
+
+    \param names The names.
+   */
+   void setNames(const QStringList &names);
+   /*!
+    \brief Removes all the names of the index.
+   */
+   void clear();
+   /*!
+    \brief Finds the names that match the \p text.
+
+    \param text The text to look for.
+    \return The ids of the names, sorted. Empty if the text is empty.
+   */
+   QVector<int> find(const QString &text) const;
+   /*!
+    \brief Returns the name of an id.
+
+    \param id The id of the name.
+    \return The name as it was given.
+   */
+   const QString &name(int id) const { return mNames.at(id); }
+   /*!
+    \brief Returns the number of names of the index.
+
+    \return The number of names.
+   */
+   int count() const { return mNames.count(); }
+
+private:
+   struct Part
+   {
+      int id;
+      int offset;
+   };
+
+   QStringList mNames;
+   QStringList mLowerNames;
+   QVector<Part> mParts;
+   QHash<quint64, QVector<int>> mTrigrams;
+
+   QStringRef partText(const Part &part) const;
+   static quint64 trigram(const QChar *text);
+};
@@ -0,0 +1,118 @@
+#include "BlameCache.h"
+
+#include <CommitInfo.h>
+#include <ResourceBudget.h>
+
+#include <climits>
+
+BlameCache::BlameCache()
+   : mBlames(MAX_COST)
+{
+   // The cost is measured in bytes: the limit can't exceed an int.
+   ResourceBudget::instance().addCache(
+       QString("Blames"), MAX_COST,
+       [this]() {
+          QMutexLocker locker(&mMutex);
+          return static_cast<qint64>(mBlames.totalCost());
+       },
+       [this](qint64 bytes) {
+          QMutexLocker locker(&mMutex);
+          mBlames.setMaxCost(static_cast<int>(qMin(bytes, static_cast<qint64>(INT_MAX))));
+       });
+}
+
+BlameCache &BlameCache::instance()
+{
+   static BlameCache cache;
+   return cache;
+}
+
+QString BlameCache::toString(const Key &key)
+{
+   return QString("%1\n%2\n%3").arg(key.repository, key.file, key.sha);
+}
+
+bool BlameCache::isCacheable(const Key &key)
+{
+   return !key.sha.isEmpty() && key.sha != CommitInfo::ZERO_SHA;
+}
+
+bool BlameCache::find(const Key &key, Blame &blame)
+{
+   if (!isCacheable(key))
+      return false;
+
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   if (const auto stored = cache.mBlames.object(toString(key)))
+   {
+      blame = *stored;
+      ++cache.mHits;
+      return true;
+   }
+
+   ++cache.mMisses;
+   return false;
+}
+
+bool BlameCache::contains(const Key &key)
+{
+   if (!isCacheable(key))
+      return false;
+
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   return cache.mBlames.contains(toString(key));
+}
+
+void BlameCache::insert(const Key &key, const Blame &blame)
+{
+   if (!isCacheable(key))
+      return;
+
+   // The commits are small next to the text and the lines, so they are counted with a rough size.
+   const auto cost = blame.text.size() * static_cast<int>(sizeof(QChar))
+       + blame.lineCommits.size() * static_cast<int>(sizeof(int)) + blame.commits.size() * 128;
+
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   // QCache deletes the blame by itself when it doesn't fit in the budget.
+   cache.mBlames.insert(toString(key), new Blame(blame), qMax(1, cost));
+}
+
+BlameCache::Statistics BlameCache::statistics()
+{
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   Statistics statistics;
+   statistics.hits = cache.mHits;
+   statistics.misses = cache.mMisses;
+   statistics.entries = cache.mBlames.count();
+   statistics.cost = cache.mBlames.totalCost();
+
+   return statistics;
+}
+
+MemoryReport BlameCache::memoryReport()
+{
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   // QCache keeps every entry in a hash node with the key and a node of its own with the links of the LRU list: about
+   // nine pointers with the bucket. The cost of the entries is already an estimation of their heap memory.
+   auto keys = qint64(cache.mBlames.count()) * qint64(sizeof(void *) * 9 + sizeof(QString));
+
+   for (const auto &key : cache.mBlames.keys())
+      keys += MemoryReport::bytes(key);
+
+   MemoryReport report;
+   report.add("Blame cache blames", cache.mBlames.count(),
+              cache.mBlames.totalCost() + cache.mBlames.count() * qint64(sizeof(Blame)));
+   report.add("Blame cache keys", cache.mBlames.count(), keys);
+
+   return report;
+}
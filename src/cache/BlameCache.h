@@ -0,0 +1,142 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <MemoryReport.h>
+
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/*!
+ \brief The BlameCache class keeps the blames of the files that have already been loaded. The blame of a file in a
+ commit can never change, so once it is stored it is only dropped to stay within the memory budget. The blames of the
+ work in progress are never stored.
+
+ Every blame keeps its commits once and, for every line, the index of its commit, so it can be shown again or used as
+ the base of the blame of another revision of the same file without running Git.
+
+ \class BlameCache BlameCache.h "BlameCache.h"
+*/
+class BlameCache
+{
+public:
+   /*!
+    \brief Identifies a blame: the repository (see GitBase::getRepositoryId), the file and the commit it was blamed
+    from.
+   */
+   struct Key
+   {
+      QString repository;
+      QString file;
+      QString sha;
+   };
+
+   /*!
+    \brief A commit of a blame, with the information that Git gives for it.
+   */
+   struct Commit
+   {
+      QString sha;
+      QString author;
+      QDateTime dateTime;
+      QString summary;
+   };
+
+   /*!
+    \brief The blame of a file: its commits, the commit of every line (-1 if it's unknown) and the text of the file.
+   */
+   struct Blame
+   {
+      QVector<Commit> commits;
+      QVector<int> lineCommits;
+      QString text;
+   };
+
+   /*!
+    \brief The memory, in bytes, that the stored blames can use.
+   */
+   static constexpr int MAX_COST = 32 * 1024 * 1024;
+
+   /*!
+    \brief Tells if the blame of the key can be stored. Only the blames of commits can.
+
+    \param key The blame.
+    \return True if the blame can't change.
+   */
+   static bool isCacheable(const Key &key);
+   /*!
+    \brief Looks for a blame that has already been stored.
+
+    \param key The blame.
+    \param blame The blame, if it is found.
+    \return True if the blame was in the cache.
+   */
+   static bool find(const Key &key, Blame &blame);
+   /*!
+    \brief Tells if a blame is stored, without copying it.
+
+    \param key The blame.
+    \return True if the blame is in the cache.
+   */
+   static bool contains(const Key &key);
+   /*!
+    \brief Stores a blame. Blames that are not cacheable, or that are bigger than the whole budget, are ignored.
+
+    \param key The blame.
+    \param blame The blame.
+   */
+   static void insert(const Key &key, const Blame &blame);
+   /*!
+    \brief The use of the cache since the application started.
+   */
+   struct Statistics
+   {
+      qint64 hits = 0;
+      qint64 misses = 0;
+      int entries = 0;
+      int cost = 0;
+   };
+   /*!
+    \brief Returns how many blames were found and not found, and the blames stored with the memory they use.
+   */
+   static Statistics statistics();
+   /*!
+    \brief Returns the memory held by the blames stored and by the keys and nodes of the cache.
+   */
+   static MemoryReport memoryReport();
+
+private:
+   BlameCache();
+
+   static BlameCache &instance();
+   static QString toString(const Key &key);
+
+   QMutex mMutex;
+   QCache<QString, Blame> mBlames;
+   qint64 mHits = 0;
+   qint64 mMisses = 0;
+};
@@ -1,18 +1,69 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/BlameCache.h \
+    $$PWD/CommitGraph.h \
     $$PWD/CommitInfo.h \
+    $$PWD/CommitView.h \
+    $$PWD/ConflictIndex.h \
+    $$PWD/DateFormatter.h \
+    $$PWD/DiffCache.h \
+    $$PWD/DiffDiskCache.h \
+    $$PWD/HistoryFilter.h \
+    $$PWD/IdentityTable.h \
     $$PWD/Lane.h \
     $$PWD/LaneType.h \
+    $$PWD/LazyLog.h \
+    $$PWD/MemoryReport.h \
+    $$PWD/ObjectId.h \
+    $$PWD/PathHistoryIndex.h \
+    $$PWD/PathTable.h \
     $$PWD/References.h \
+    $$PWD/RepositoriesSearch.h \
+    $$PWD/ResourceBudget.h \
     $$PWD/RevisionFiles.h \
+    $$PWD/RevisionFilesStore.h \
+    $$PWD/RevisionsBuilder.h \
     $$PWD/RevisionsCache.h \
+    $$PWD/RevisionsDiskCache.h \
+    $$PWD/RevisionsSearchIndex.h \
+    $$PWD/RevisionsSearcher.h \
+    $$PWD/RevisionsSnapshot.h \
+    $$PWD/SubgraphLanes.h \
+    $$PWD/TraceRecorder.h \
+    $$PWD/WarmStartSnapshot.h \
+    $$PWD/WorkerPool.h \
     $$PWD/lanes.h
 
 SOURCES += \
+    $$PWD/BlameCache.cpp \
+    $$PWD/CommitGraph.cpp \
     $$PWD/CommitInfo.cpp \
+    $$PWD/ConflictIndex.cpp \
+    $$PWD/DateFormatter.cpp \
+    $$PWD/DiffCache.cpp \
+    $$PWD/DiffDiskCache.cpp \
+    $$PWD/HistoryFilter.cpp \
+    $$PWD/IdentityTable.cpp \
     $$PWD/Lane.cpp \
+    $$PWD/LazyLog.cpp \
+    $$PWD/MemoryReport.cpp \
+    $$PWD/ObjectId.cpp \
+    $$PWD/PathHistoryIndex.cpp \
+    $$PWD/PathTable.cpp \
     $$PWD/References.cpp \
+    $$PWD/RepositoriesSearch.cpp \
+    $$PWD/ResourceBudget.cpp \
     $$PWD/RevisionFiles.cpp \
+    $$PWD/RevisionFilesStore.cpp \
+    $$PWD/RevisionsBuilder.cpp \
     $$PWD/RevisionsCache.cpp \
+    $$PWD/RevisionsDiskCache.cpp \
+    $$PWD/RevisionsSearchIndex.cpp \
+    $$PWD/RevisionsSearcher.cpp \
+    $$PWD/RevisionsSnapshot.cpp \
+    $$PWD/SubgraphLanes.cpp \
+    $$PWD/TraceRecorder.cpp \
+    $$PWD/WarmStartSnapshot.cpp \
+    $$PWD/WorkerPool.cpp \
     $$PWD/lanes.cpp
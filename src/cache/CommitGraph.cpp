@@ -0,0 +1,403 @@
+#include "CommitGraph.h"
+
+#include <CommitInfo.h>
+
+#include <QLogger.h>
+
+#include <QDir>
+#include <QFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace QLogger;
+
+namespace
+{
+constexpr quint32 SIGNATURE = 0x43475048; // CGPH
+constexpr quint32 CHUNK_FANOUT = 0x4f494446; // OIDF
+constexpr quint32 CHUNK_IDS = 0x4f49444c; // OIDL
+constexpr quint32 CHUNK_COMMIT_DATA = 0x43444154; // CDAT
+constexpr quint32 CHUNK_EXTRA_EDGES = 0x45444745; // EDGE
+constexpr quint32 CHUNK_BLOOM_INDEXES = 0x42494458; // BIDX
+constexpr quint32 CHUNK_BLOOM_DATA = 0x42444154; // BDAT
+constexpr quint32 NO_PARENT = 0x70000000;
+constexpr quint32 EXTRA_EDGES_FLAG = 0x80000000;
+constexpr qint64 HEADER_SIZE = 8;
+constexpr qint64 CHUNK_ENTRY_SIZE = 12;
+constexpr qint64 FANOUT_SIZE = 256 * 4;
+constexpr int COMMIT_DATA_SIZE = 16; // The parents, the generation and the date that follow the SHA of the tree.
+
+quint32 read32(const uchar *data)
+{
+   return qFromBigEndian<quint32>(data);
+}
+
+quint64 read64(const uchar *data)
+{
+   return qFromBigEndian<quint64>(data);
+}
+}
+
+CommitGraph::CommitGraph(const QString &objectsDir)
+{
+   const QDir info(QDir(objectsDir).filePath("info"));
+   const auto singleFile = info.filePath("commit-graph");
+   auto valid = true;
+
+   // Like git, the single file is used before the chain.
+   if (QFile::exists(singleFile))
+      valid = map(singleFile);
+   else
+   {
+      QFile chain(info.filePath("commit-graphs/commit-graph-chain"));
+
+      if (chain.open(QIODevice::ReadOnly))
+      {
+         // The chain lists the layers from the base to the top.
+         const auto hashes = QString::fromLatin1(chain.readAll()).split('\n', QString::SkipEmptyParts);
+
+         for (const auto &hash : hashes)
+         {
+            if (valid)
+               valid = map(info.filePath(QString("commit-graphs/graph-%1.graph").arg(hash.trimmed())));
+         }
+      }
+   }
+
+   if (!valid)
+   {
+      QLog_Warning("Git", QString("The commit-graph of {%1} can't be read.").arg(objectsDir));
+
+      mCount = 0;
+   }
+}
+
+CommitGraph::~CommitGraph()
+{
+   for (const auto &layer : qAsConst(mLayers))
+   {
+      if (layer.data)
+         layer.file->unmap(layer.data);
+
+      delete layer.file;
+   }
+}
+
+bool CommitGraph::map(const QString &path)
+{
+   // The layer is released by the destructor even if it's not valid.
+   mLayers.append(Layer());
+
+   auto &layer = mLayers.last();
+   layer.file = new QFile(path);
+
+   if (!layer.file->open(QIODevice::ReadOnly))
+      return false;
+
+   layer.size = layer.file->size();
+
+   if (layer.size < HEADER_SIZE + CHUNK_ENTRY_SIZE)
+      return false;
+
+   layer.data = layer.file->map(0, layer.size);
+
+   if (!layer.data)
+      return false;
+
+   const auto data = layer.data;
+   const auto hashSize = data[5] == 1 ? ObjectId::SHA1_SIZE : data[5] == 2 ? ObjectId::SHA256_SIZE : 0;
+
+   if (read32(data) != SIGNATURE || data[4] != 1 || hashSize == 0 || (mLayers.count() > 1 && hashSize != mHashSize))
+      return false;
+
+   mHashSize = hashSize;
+
+   const auto chunks = static_cast<qint64>(data[6]);
+
+   if (HEADER_SIZE + (chunks + 1) * CHUNK_ENTRY_SIZE > layer.size)
+      return false;
+
+   qint64 idsSize = 0;
+   qint64 commitDataSize = 0;
+   auto bloomChunks = 0;
+
+   for (auto i = 0; i < chunks; ++i)
+   {
+      const auto entry = data + HEADER_SIZE + i * CHUNK_ENTRY_SIZE;
+      const auto offset = read64(entry + 4);
+      const auto end = read64(entry + CHUNK_ENTRY_SIZE + 4);
+
+      if (offset > end || end > static_cast<quint64>(layer.size))
+         return false;
+
+      const auto chunkSize = static_cast<qint64>(end - offset);
+
+      switch (read32(entry))
+      {
+         case CHUNK_FANOUT:
+            if (chunkSize != FANOUT_SIZE)
+               return false;
+
+            layer.fanout = data + offset;
+            break;
+         case CHUNK_IDS:
+            layer.ids = data + offset;
+            idsSize = chunkSize;
+            break;
+         case CHUNK_COMMIT_DATA:
+            layer.commitData = data + offset;
+            commitDataSize = chunkSize;
+            break;
+         case CHUNK_EXTRA_EDGES:
+            layer.extraEdges = data + offset;
+            layer.extraEdgesCount = static_cast<int>(chunkSize / 4);
+            break;
+         case CHUNK_BLOOM_INDEXES:
+         case CHUNK_BLOOM_DATA:
+            ++bloomChunks;
+            break;
+         default:
+            break;
+      }
+   }
+
+   if (!layer.fanout || !layer.ids || !layer.commitData)
+      return false;
+
+   layer.count = static_cast<int>(read32(layer.fanout + FANOUT_SIZE - 4));
+   layer.changedPaths = bloomChunks == 2;
+
+   if (idsSize != static_cast<qint64>(layer.count) * mHashSize
+       || commitDataSize != static_cast<qint64>(layer.count) * (mHashSize + COMMIT_DATA_SIZE))
+      return false;
+
+   layer.base = mCount;
+   mCount += layer.count;
+
+   return true;
+}
+
+bool CommitGraph::hasChangedPaths() const
+{
+   return isValid()
+       && std::all_of(mLayers.cbegin(), mLayers.cend(), [](const Layer &layer) { return layer.changedPaths; });
+}
+
+const CommitGraph::Layer *CommitGraph::layer(int position) const
+{
+   for (const auto &layer : mLayers)
+   {
+      if (position >= layer.base && position < layer.base + layer.count)
+         return &layer;
+   }
+
+   return nullptr;
+}
+
+int CommitGraph::position(const ObjectId &id) const
+{
+   if (!isValid() || id.size() != mHashSize)
+      return -1;
+
+   const auto firstByte = id.data()[0];
+
+   for (const auto &layer : mLayers)
+   {
+      // The fanout tells where the ids that start with every byte end.
+      auto low = firstByte == 0 ? 0 : static_cast<int>(read32(layer.fanout + (firstByte - 1) * 4));
+      auto high = std::min(static_cast<int>(read32(layer.fanout + firstByte * 4)), layer.count);
+
+      while (low < high)
+      {
+         const auto middle = low + (high - low) / 2;
+         const auto comparison = std::memcmp(layer.ids + middle * mHashSize, id.data(), mHashSize);
+
+         if (comparison == 0)
+            return layer.base + middle;
+
+         if (comparison < 0)
+            low = middle + 1;
+         else
+            high = middle;
+      }
+   }
+
+   return -1;
+}
+
+ObjectId CommitGraph::id(int position) const
+{
+   const auto layer = this->layer(position);
+
+   return layer ? ObjectId::fromBinary(layer->ids + (position - layer->base) * mHashSize, mHashSize) : ObjectId();
+}
+
+long long CommitGraph::commitTime(int position) const
+{
+   const auto layer = this->layer(position);
+
+   if (!layer)
+      return 0;
+
+   // The date takes the lowest 34 bits of the 64 that follow the parents. The rest is the generation number.
+   const auto entry = layer->commitData + (position - layer->base) * (mHashSize + COMMIT_DATA_SIZE) + mHashSize + 8;
+
+   return (static_cast<long long>(read32(entry) & 0x3) << 32) | read32(entry + 4);
+}
+
+bool CommitGraph::parents(int position, QVector<int> &parents) const
+{
+   parents.clear();
+
+   const auto layer = this->layer(position);
+
+   if (!layer)
+      return false;
+
+   const auto entry = layer->commitData + (position - layer->base) * (mHashSize + COMMIT_DATA_SIZE) + mHashSize;
+   const auto first = read32(entry);
+   const auto second = read32(entry + 4);
+
+   if (first != NO_PARENT)
+   {
+      if (first >= static_cast<quint32>(mCount))
+         return false;
+
+      parents.append(static_cast<int>(first));
+   }
+
+   if (second == NO_PARENT)
+      return true;
+
+   if (!(second & EXTRA_EDGES_FLAG))
+   {
+      if (second >= static_cast<quint32>(mCount))
+         return false;
+
+      parents.append(static_cast<int>(second));
+      return true;
+   }
+
+   // The octopus merges have the rest of their parents in the list of extra edges. The last one has the flag on.
+   for (auto edge = static_cast<int>(second & ~EXTRA_EDGES_FLAG);; ++edge)
+   {
+      if (edge >= layer->extraEdgesCount)
+         return false;
+
+      const auto value = read32(layer->extraEdges + edge * 4);
+      const auto parent = value & ~EXTRA_EDGES_FLAG;
+
+      if (parent >= static_cast<quint32>(mCount))
+         return false;
+
+      parents.append(static_cast<int>(parent));
+
+      if (value & EXTRA_EDGES_FLAG)
+         return true;
+   }
+}
+
+bool CommitGraph::load(const QVector<ObjectId> &tips, bool firstParent, QVector<CommitInfo *> &commits) const
+{
+   if (!isValid())
+      return false;
+
+   // The number of children of every reachable commit that are not shown yet, or -1 if the commit is not reachable.
+   QVector<int> children(mCount, -1);
+   QVector<int> pending;
+   QVector<int> tipPositions;
+   QVector<int> parentPositions;
+
+   for (const auto &tip : tips)
+   {
+      const auto position = this->position(tip);
+
+      if (position == -1)
+      {
+         QLog_Debug("Git", QString("The commit {%1} is not in the commit-graph.").arg(tip.toString()));
+         return false;
+      }
+
+      if (children.at(position) == -1)
+      {
+         children[position] = 0;
+         pending.append(position);
+         tipPositions.append(position);
+      }
+   }
+
+   while (!pending.isEmpty())
+   {
+      const auto position = pending.takeLast();
+
+      if (!parents(position, parentPositions))
+         return false;
+
+      if (firstParent && parentPositions.count() > 1)
+         parentPositions.resize(1);
+
+      for (const auto parent : qAsConst(parentPositions))
+      {
+         if (children.at(parent) == -1)
+         {
+            children[parent] = 0;
+            pending.append(parent);
+         }
+
+         ++children[parent];
+      }
+   }
+
+   // Like git log --date-order: a commit is ready once all its children are shown and the newest ready goes first.
+   const auto older = [this](int a, int b) {
+      const auto timeA = commitTime(a);
+      const auto timeB = commitTime(b);
+
+      return timeA != timeB ? timeA < timeB : a > b;
+   };
+
+   QVector<int> ready;
+
+   for (const auto tip : qAsConst(tipPositions))
+   {
+      if (children.at(tip) == 0)
+         ready.append(tip);
+   }
+
+   std::make_heap(ready.begin(), ready.end(), older);
+
+   QVector<CommitInfo *> built;
+   QVector<ObjectId> parentIds;
+
+   while (!ready.isEmpty())
+   {
+      std::pop_heap(ready.begin(), ready.end(), older);
+
+      const auto position = ready.takeLast();
+
+      parents(position, parentPositions);
+      parentIds.clear();
+
+      // Like --first-parent with %P, all the parents are listed although only the first one is followed.
+      for (auto i = 0; i < parentPositions.count(); ++i)
+      {
+         const auto parent = parentPositions.at(i);
+
+         parentIds.append(id(parent));
+
+         if ((i == 0 || !firstParent) && --children[parent] == 0)
+         {
+            ready.append(parent);
+            std::push_heap(ready.begin(), ready.end(), older);
+         }
+      }
+
+      built.append(new CommitInfo(id(position), parentIds, commitTime(position)));
+   }
+
+   commits.append(built);
+
+   return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+
+#include <QString>
+#include <QVector>
+
+class CommitInfo;
+class QFile;
+
+/*!
+ \brief The CommitGraph reads the commit-graph file that git writes in objects/info: the SHAs, the parents and the
+ dates of the commits in a binary format. The files are memory mapped, so the topology of the whole history is
+ available without running git log. Both the single file and the chains of the incremental commit-graph are read.
+
+ The commits written after the commit-graph are not in it, so the loads that reach a commit that is not in the graph
+ fail and the caller has to ask git.
+
+ \class CommitGraph CommitGraph.h "CommitGraph.h"
+*/
+class CommitGraph
+{
+public:
+   /*!
+    \brief Default constructor. It maps the commit-graph of the repository, if it has one.
+
+    \param objectsDir The absolute path of the objects directory of the repository.
+   */
+   explicit CommitGraph(const QString &objectsDir);
+   ~CommitGraph();
+
+   /*!
+    \brief Tells if the commit-graph exists and its format is supported.
+   */
+   bool isValid() const { return mCount > 0; }
+   /*!
+    \brief Returns the number of commits of the commit-graph.
+   */
+   int count() const { return mCount; }
+   /*!
+    \brief Tells if every file of the commit-graph has the Bloom filters of the paths changed by its commits, written
+    with git commit-graph write --changed-paths. Without them the history of a path reads the trees of every commit.
+   */
+   bool hasChangedPaths() const;
+   /*!
+    \brief Returns the position of a commit in the graph.
+
+    \param id The SHA of the commit.
+    \return The position or -1 if the commit is not in the graph.
+   */
+   int position(const ObjectId &id) const;
+   /*!
+    \brief Returns the SHA of the commit in the given position.
+   */
+   ObjectId id(int position) const;
+   /*!
+    \brief Returns the commit date of the commit in the given position, in seconds since epoch.
+   */
+   long long commitTime(int position) const;
+   /*!
+    \brief Reads the positions of the parents of a commit.
+
+    \param position The position of the commit.
+    \param parents The vector where the positions of the parents are stored.
+    \return False if the file is corrupted.
+   */
+   bool parents(int position, QVector<int> &parents) const;
+   /*!
+    \brief Builds the commits reachable from the tips, sorted like git log --date-order: no parent is shown before its
+    children and the commits are sorted by date otherwise. The commits only have their SHA, their parents and their
+    date.
+
+    \param tips The SHAs the history starts from.
+    \param firstParent If true only the first parent of every commit is followed, like git log --first-parent. The
+    commits still list all their parents.
+    \param commits The vector where the commits are appended. The caller takes the ownership.
+    \return False if a tip is not in the graph or the file is corrupted. Nothing is appended then.
+   */
+   bool load(const QVector<ObjectId> &tips, bool firstParent, QVector<CommitInfo *> &commits) const;
+
+private:
+   struct Layer
+   {
+      QFile *file = nullptr;
+      uchar *data = nullptr;
+      qint64 size = 0;
+      int base = 0;
+      int count = 0;
+      const uchar *fanout = nullptr;
+      const uchar *ids = nullptr;
+      const uchar *commitData = nullptr;
+      const uchar *extraEdges = nullptr;
+      int extraEdgesCount = 0;
+      bool changedPaths = false;
+   };
+
+   int mHashSize = ObjectId::SHA1_SIZE;
+   int mCount = 0;
+   QVector<Layer> mLayers;
+
+   bool map(const QString &path);
+   const Layer *layer(int position) const;
+
+   Q_DISABLE_COPY(CommitGraph)
+};
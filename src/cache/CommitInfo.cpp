@@ -1,50 +1,240 @@
 #include "CommitInfo.h"
 
+#include <LaneType.h>
+#include <MemoryReport.h>
+
 #include <QStringList>
 
+#include <cstring>
+
 const QString CommitInfo::ZERO_SHA = QString("0000000000000000000000000000000000000000");
+const ObjectId CommitInfo::ZERO_ID = ObjectId::fromHex(CommitInfo::ZERO_SHA);
 
 CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, const QString &author, long long secsSinceEpoch,
                        const QString &log, const QString &longLog)
 {
-   mSha = sha;
-   mParentsSha = parents;
-   mCommitter = author;
-   mAuthor = author;
-   mCommitDate = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
+   mSha = ObjectId::fromHex(sha);
+
+   for (const auto &parent : parents)
+      mParentsSha.append(ObjectId::fromHex(parent));
+   mCommitterId = IdentityTable::intern(author);
+   mAuthorId = mCommitterId;
+   mCommitSecs = secsSinceEpoch;
    mShortLog = log;
    mLongLog = longLog;
 }
 
+CommitInfo::CommitInfo(const ObjectId &sha, const QVector<ObjectId> &parents, long long secsSinceEpoch)
+   : mSha(sha)
+   , mParentsSha(parents)
+   , mCommitSecs(secsSinceEpoch)
+   , mDetailsMissing(true)
+{
+}
+
+namespace
+{
+/**
+ * @brief Returns the position of the next @p c character in the range [@p from, @p end) or @p end if it's not found.
+ */
+const char *findChar(const char *from, const char *end, char c)
+{
+   const auto found = static_cast<const char *>(std::memchr(from, c, static_cast<size_t>(end - from)));
+
+   return found ? found : end;
+}
+
+/**
+ * @brief Returns the line that starts at @p from and moves @p from to the beginning of the next one.
+ */
+QLatin1String nextLine(const char *&from, const char *end)
+{
+   const auto lineEnd = findChar(from, end, '\n');
+   const QLatin1String line(from, static_cast<int>(lineEnd - from));
+
+   from = lineEnd < end ? lineEnd + 1 : end;
+
+   return line;
+}
+
+int parseTimeZoneOffset(const char *zone)
+{
+   // The zone is given as +hhmm or -hhmm.
+   if (zone[0] != '+' && zone[0] != '-')
+      return 0;
+
+   const auto hours = (zone[1] - '0') * 10 + (zone[2] - '0');
+   const auto minutes = (zone[3] - '0') * 10 + (zone[4] - '0');
+   const auto offset = (hours * 60 + minutes) * 60;
+
+   return zone[0] == '-' ? -offset : offset;
+}
+}
+
 CommitInfo::CommitInfo(const QByteArray &b)
 {
-   const auto fields = QString::fromUtf8(b).split('\n');
+   // The data has the format given by GIT_LOG_FORMAT, or GIT_LOG_TOPOLOGY_FORMAT, preceded by the log size line. The
+   // fields are separated by the unit separator (0x1f), that can't be part of any of them but the long log:
+   // log size <n>\n<boundary>␟<sha>␟<parents>␟<committer>␟<author>␟<date>␟<short log>␟<long log>
+   auto pos = b.constData();
+   auto end = pos + b.size();
+
+   // The log size tells where the message ends, so the long log is never searched.
+   if (b.startsWith(LOG_SIZE_PREFIX))
+   {
+      const auto sizeBegin = pos + LOG_SIZE_PREFIX_LENGTH;
+      const auto sizeEnd = findChar(sizeBegin, end, '\n');
+      const auto size = QByteArray::fromRawData(sizeBegin, static_cast<int>(sizeEnd - sizeBegin)).toInt();
+
+      pos = sizeEnd < end ? sizeEnd + 1 : end;
+
+      if (size >= 0 && size < end - pos)
+         end = pos + size;
+   }
+
+   QLatin1String fields[FIELDS_COUNT - 1];
+
+   for (auto &field : fields)
+   {
+      const auto fieldEnd = findChar(pos, end, FIELD_SEPARATOR);
+
+      // The short log must be followed by a separator (the long log can be empty).
+      if (fieldEnd == end)
+         return;
+
+      field = QLatin1String(pos, static_cast<int>(fieldEnd - pos));
+      pos = fieldEnd + 1;
+   }
+
+   const auto &boundary = fields[0];
+   const auto &sha = fields[1];
+   const auto &parents = fields[2];
+
+   if (sha.isEmpty())
+      return;
+
+   if (!boundary.isEmpty())
+      mBoundaryInfo = QChar::fromLatin1(*boundary.data());
+   mSha = ObjectId::fromHex(sha.data(), sha.size());
+
+   const auto parentsEnd = parents.data() + parents.size();
+   auto parent = parents.data();
+
+   while (parent < parentsEnd)
+   {
+      const auto parentEnd = findChar(parent, parentsEnd, ' ');
 
-   if (fields.count() > 6)
+      if (parentEnd > parent)
+         mParentsSha.append(ObjectId::fromHex(parent, static_cast<int>(parentEnd - parent)));
+
+      parent = parentEnd < parentsEnd ? parentEnd + 1 : parentsEnd;
+   }
+
+   // The identities always have the email between angle brackets: an empty one comes from GIT_LOG_TOPOLOGY_FORMAT.
+   if (fields[3].isEmpty())
+      mDetailsMissing = true;
+   else
    {
-      auto combinedShas = fields.at(1);
-      auto sha = combinedShas.split('X').first();
-      mBoundaryInfo = sha.at(0);
-      sha.remove(0, 1);
-      mSha = sha;
-      combinedShas = combinedShas.remove(0, mSha.size() + 1 + 1);
-      mParentsSha = combinedShas.trimmed().split(' ', QString::SkipEmptyParts);
-      mCommitter = fields.at(2);
-      mAuthor = fields.at(3);
-      mCommitDate = QDateTime::fromSecsSinceEpoch(fields.at(4).toInt());
-      mShortLog = fields.at(5);
-
-      for (auto i = 6; i < fields.count(); ++i)
-         mLongLog += fields.at(i);
+      mCommitterId = IdentityTable::intern(fields[3].data(), fields[3].size());
+      mAuthorId = IdentityTable::intern(fields[4].data(), fields[4].size());
+   }
+
+   // The date has the seconds since the epoch followed by the ISO date, that ends with the time zone.
+   const auto &date = fields[5];
+   const auto dateEnd = date.data() + date.size();
+   const auto secsEnd = findChar(date.data(), dateEnd, ' ');
+
+   mCommitSecs = QByteArray::fromRawData(date.data(), static_cast<int>(secsEnd - date.data())).toLongLong();
+
+   if (dateEnd - secsEnd > 5)
+      mTimeZoneOffset = parseTimeZoneOffset(dateEnd - 5);
+
+   mShortLog = QString::fromUtf8(fields[6].data(), fields[6].size());
+
+   // The lines of the long log are stored without the line breaks.
+   if (pos == end)
+      return;
+
+   if (findChar(pos, end, '\n') == end)
+      mLongLog = QString::fromUtf8(pos, static_cast<int>(end - pos));
+   else
+   {
+      QByteArray longLog;
+      longLog.reserve(static_cast<int>(end - pos));
+
+      while (pos < end)
+      {
+         const auto line = nextLine(pos, end);
+         longLog.append(line.data(), line.size());
+      }
+
+      mLongLog = QString::fromUtf8(longLog);
    }
 }
 
+int CommitInfo::findRecordEnd(const QByteArray &data, int from)
+{
+   // The message is jumped over with its size, so a NUL character in it doesn't split the record.
+   if (data.size() - from > LOG_SIZE_PREFIX_LENGTH
+       && std::memcmp(data.constData() + from, LOG_SIZE_PREFIX, static_cast<size_t>(LOG_SIZE_PREFIX_LENGTH)) == 0)
+   {
+      const auto sizeBegin = from + LOG_SIZE_PREFIX_LENGTH;
+      const auto sizeEnd = data.indexOf('\n', sizeBegin);
+
+      if (sizeEnd == -1)
+         return -1;
+
+      auto valid = false;
+      const auto size = QByteArray::fromRawData(data.constData() + sizeBegin, sizeEnd - sizeBegin).toInt(&valid);
+      const auto messageEnd = static_cast<qint64>(sizeEnd) + 1 + size;
+
+      if (valid && size >= 0)
+      {
+         if (messageEnd >= data.size())
+            return -1;
+
+         if (data.at(static_cast<int>(messageEnd)) == '\0')
+            return static_cast<int>(messageEnd);
+      }
+   }
+
+   return data.indexOf('\0', from);
+}
+
+QVector<QByteArray> CommitInfo::splitRecords(const QByteArray &data)
+{
+   QVector<QByteArray> records;
+   auto start = 0;
+
+   for (auto end = findRecordEnd(data, start); end != -1; end = findRecordEnd(data, start))
+   {
+      records.append(data.mid(start, end - start));
+      start = end + 1;
+   }
+
+   // The last record is not followed by a NUL character.
+   if (start < data.size())
+      records.append(data.mid(start));
+
+   return records;
+}
+
+void CommitInfo::setDetails(const CommitInfo &details)
+{
+   mCommitterId = details.mCommitterId;
+   mAuthorId = details.mAuthorId;
+   mCommitSecs = details.mCommitSecs;
+   mTimeZoneOffset = details.mTimeZoneOffset;
+   mShortLog = details.mShortLog;
+   mLongLog = details.mLongLog;
+   mDetailsMissing = false;
+}
+
 bool CommitInfo::operator==(const CommitInfo &commit) const
 {
-   return (mSha == commit.mSha || mSha.startsWith(commit.sha()) || commit.sha().startsWith(mSha))
-       && mParentsSha == commit.mParentsSha && mCommitter == commit.mCommitter && mAuthor == commit.mAuthor
-       && mCommitDate == commit.mCommitDate && mShortLog == commit.mShortLog && mLongLog == commit.mLongLog
-       && mLanes == commit.mLanes;
+   return mSha == commit.mSha && mParentsSha == commit.mParentsSha && mCommitterId == commit.mCommitterId
+       && mAuthorId == commit.mAuthorId && mCommitSecs == commit.mCommitSecs && mShortLog == commit.mShortLog
+       && mLongLog == commit.mLongLog && mTimeZoneOffset == commit.mTimeZoneOffset && mLanes == commit.mLanes;
 }
 
 bool CommitInfo::operator!=(const CommitInfo &commit) const
@@ -75,11 +265,37 @@ QString CommitInfo::getFieldStr(CommitInfo::Field field) const
    }
 }
 
+QStringList CommitInfo::parents() const
+{
+   QStringList parents;
+   parents.reserve(mParentsSha.count());
+
+   for (const auto &parent : mParentsSha)
+      parents.append(parent.toString());
+
+   return parents;
+}
+
 bool CommitInfo::isValid() const
 {
-   QRegExp hexMatcher("^[0-9A-F]{40}$", Qt::CaseInsensitive);
+   return !mSha.isNull();
+}
+
+int CommitInfo::memoryUsage() const
+{
+   const auto characters = mShortLog.size() + mLongLog.size() + mDiff.size();
+
+   return static_cast<int>(sizeof(CommitInfo)) + characters * static_cast<int>(sizeof(QChar))
+       + mParentsSha.count() * static_cast<int>(sizeof(ObjectId));
+}
+
+CommitInfo::MemoryBreakdown CommitInfo::memoryBreakdown() const
+{
+   MemoryBreakdown breakdown;
+   breakdown.logs = MemoryReport::bytes(mShortLog) + MemoryReport::bytes(mLongLog) + MemoryReport::bytes(mDiff);
+   breakdown.parents = MemoryReport::bytes(mParentsSha);
 
-   return !mSha.isEmpty() && hexMatcher.exactMatch(mSha);
+   return breakdown;
 }
 
 int CommitInfo::getActiveLane() const
@@ -97,7 +313,57 @@ int CommitInfo::getActiveLane() const
    return -1;
 }
 
-void CommitInfo::addReference(References::Type type, const QString &reference)
+QDataStream &operator<<(QDataStream &out, const CommitInfo &commit)
+{
+   // The references are not stored: they are loaded every time the repository is loaded.
+   // The identities are stored as text since their ids are only valid while the application runs.
+   out << commit.mBoundaryInfo << commit.mSha << commit.mParentsSha << commit.committer() << commit.author()
+       << static_cast<qint64>(commit.mCommitSecs) << static_cast<qint32>(commit.mTimeZoneOffset) << commit.mShortLog
+       << commit.mLongLog;
+
+   out << static_cast<qint32>(commit.mLanes.count());
+
+   for (const auto &lane : commit.mLanes)
+      out << static_cast<quint8>(lane.getType());
+
+   return out;
+}
+
+QDataStream &operator>>(QDataStream &in, CommitInfo &commit)
 {
-   mReferences.addReference(type, reference);
+   qint64 secsSinceEpoch = 0;
+   qint32 timeZoneOffset = 0;
+   qint32 lanesCount = 0;
+   QString committer;
+   QString author;
+
+   in >> commit.mBoundaryInfo >> commit.mSha >> commit.mParentsSha >> committer >> author >> secsSinceEpoch
+       >> timeZoneOffset >> commit.mShortLog >> commit.mLongLog >> lanesCount;
+
+   commit.mCommitterId = IdentityTable::intern(committer);
+   commit.mAuthorId = IdentityTable::intern(author);
+   commit.mCommitSecs = secsSinceEpoch;
+   commit.mTimeZoneOffset = timeZoneOffset;
+   commit.mLanes.clear();
+
+   if (lanesCount < 0)
+   {
+      in.setStatus(QDataStream::ReadCorruptData);
+      return in;
+   }
+
+   commit.mLanes.reserve(lanesCount);
+
+   for (auto i = 0; i < lanesCount && in.status() == QDataStream::Ok; ++i)
+   {
+      quint8 type = 0;
+      in >> type;
+
+      if (type >= static_cast<quint8>(LaneType::LANE_TYPES_NUM))
+         in.setStatus(QDataStream::ReadCorruptData);
+      else
+         commit.mLanes.append(Lane(static_cast<LaneType>(type)));
+   }
+
+   return in;
 }
@@ -27,7 +27,9 @@
 #include <QStringList>
 #include <QDateTime>
 
+#include <IdentityTable.h>
 #include <Lane.h>
+#include <ObjectId.h>
 #include <References.h>
 
 class CommitInfo
@@ -48,25 +50,77 @@ public:
    explicit CommitInfo(const QString &sha, const QStringList &parents, const QString &author, long long secsSinceEpoch,
                        const QString &log, const QString &longLog);
    explicit CommitInfo(const QByteArray &b);
+   /*!
+    \brief Creates a commit that only knows its place in the history, as the commit-graph file gives it. The authors and
+    the logs are missing until \ref setDetails is called.
+
+    \param sha The SHA of the commit.
+    \param parents The SHAs of the parents.
+    \param secsSinceEpoch The commit date.
+   */
+   explicit CommitInfo(const ObjectId &sha, const QVector<ObjectId> &parents, long long secsSinceEpoch);
    bool operator==(const CommitInfo &commit) const;
    bool operator!=(const CommitInfo &commit) const;
 
    QString getFieldStr(CommitInfo::Field field) const;
    bool isBoundary() const { return mBoundaryInfo == '-'; }
    int parentsCount() const { return mParentsSha.count(); }
-   QString parent(int idx) const { return mParentsSha.count() > idx ? mParentsSha.at(idx) : QString(); }
-   QStringList parents() const { return mParentsSha; }
+   QString parent(int idx) const { return parentId(idx).toString(); }
+   QStringList parents() const;
+   ObjectId parentId(int idx) const { return mParentsSha.count() > idx ? mParentsSha.at(idx) : ObjectId(); }
+   QVector<ObjectId> parentIds() const { return mParentsSha; }
 
-   QString sha() const { return mSha; }
-   QString committer() const { return mCommitter; }
-   QString author() const { return mAuthor; }
-   QString authorDate() const { return QString::number(mCommitDate.toSecsSinceEpoch()); }
+   QString sha() const { return mSha.toString(); }
+   ObjectId id() const { return mSha; }
+   QString committer() const { return IdentityTable::get(mCommitterId).full; }
+   QString committerName() const { return IdentityTable::get(mCommitterId).name; }
+   QString committerEmail() const { return IdentityTable::get(mCommitterId).email; }
+   int committerId() const { return mCommitterId; }
+   QString author() const { return IdentityTable::get(mAuthorId).full; }
+   QString authorName() const { return IdentityTable::get(mAuthorId).name; }
+   QString authorEmail() const { return IdentityTable::get(mAuthorId).email; }
+   int authorId() const { return mAuthorId; }
+   QString authorDate() const { return QString::number(mCommitSecs); }
+   long long secsSinceEpoch() const { return mCommitSecs; }
+   /*!
+    \brief Returns the offset from UTC of the time zone of the author when the commit was made, in seconds.
+   */
+   int timeZoneOffset() const { return mTimeZoneOffset; }
    QString shortLog() const { return mShortLog; }
    QString longLog() const { return mLongLog; }
    QString fullLog() const { return QString("%1\n\n%2").arg(mShortLog, mLongLog.trimmed()); }
 
    bool isValid() const;
-   bool isWip() const { return mSha == ZERO_SHA; }
+   /*!
+    \brief Tells if the authors and the logs of the commit are known. Only the commits loaded from the commit-graph or
+    with GitRepoLoader::GIT_LOG_TOPOLOGY_FORMAT miss them.
+   */
+   bool hasDetails() const { return !mDetailsMissing; }
+   /*!
+    \brief Takes the authors, the date and the logs from another commit with the same SHA, parsed from git log.
+
+    \param details The commit with the details.
+   */
+   void setDetails(const CommitInfo &details);
+   /*!
+    \brief Returns an approximation of the memory used by the commit, in bytes. The lanes are not included: they are
+    shared with the rest of commits that have the same ones.
+   */
+   int memoryUsage() const;
+   /*!
+    \brief The heap memory of a commit by structure, in bytes.
+   */
+   struct MemoryBreakdown
+   {
+      qint64 logs = 0;
+      qint64 parents = 0;
+   };
+   /*!
+    \brief Returns the heap memory used by the commit by structure, with the capacity of its strings and vectors. The
+    object itself and the lanes, that are shared, are not included.
+   */
+   MemoryBreakdown memoryBreakdown() const;
+   bool isWip() const { return mSha == ZERO_ID; }
 
    void setLanes(const QVector<Lane> &lanes) { mLanes = lanes; }
    QVector<Lane> getLanes() const { return mLanes; }
@@ -74,23 +128,60 @@ public:
    int getLanesCount() const { return mLanes.count(); }
    int getActiveLane() const;
 
-   void addReference(References::Type type, const QString &reference);
-   void addReferences(const References &refs) { mReferences = refs; }
-   QStringList getReferences(References::Type type) const { return mReferences.getReferences(type); }
-   bool hasReferences() const { return !mReferences.isEmpty(); }
+   /*!
+    \brief Tells if the commit has references. The references themselves are kept by the RevisionsCache, see
+    RevisionsCache::getReferences.
+   */
+   bool hasReferences() const { return mHasReferences; }
+   void setHasReferences(bool hasReferences) { mHasReferences = hasReferences; }
 
    static const QString ZERO_SHA;
+   static const ObjectId ZERO_ID;
+
+   /*!
+    \brief Returns the position of the NUL character that ends a record of git log -z --log-size, or -1 if the record
+    is not complete yet. The message is jumped over with its size instead of being searched.
+
+    \param data The output of git log.
+    \param from The position where the record starts.
+    \return The position of the NUL character.
+   */
+   static int findRecordEnd(const QByteArray &data, int from);
+   /*!
+    \brief Splits the output of git log -z --log-size into the records of the commits.
+   */
+   static QVector<QByteArray> splitRecords(const QByteArray &data);
+
+   /*!
+    \brief The character between the fields of GitRepoLoader::GIT_LOG_FORMAT.
+   */
+   static constexpr char FIELD_SEPARATOR = '\x1f';
+   /*!
+    \brief The number of fields of GitRepoLoader::GIT_LOG_FORMAT: the boundary mark, the SHA, the parents, the
+    committer, the author, the date, the short log and the long log.
+   */
+   static constexpr int FIELDS_COUNT = 8;
+
+   friend class CommitView;
+   friend QDataStream &operator<<(QDataStream &out, const CommitInfo &commit);
+   friend QDataStream &operator>>(QDataStream &in, CommitInfo &commit);
 
 private:
+   static constexpr char LOG_SIZE_PREFIX[] = "log size ";
+   static constexpr int LOG_SIZE_PREFIX_LENGTH = sizeof(LOG_SIZE_PREFIX) - 1;
+
    QChar mBoundaryInfo;
-   QString mSha;
-   QStringList mParentsSha;
-   QString mCommitter;
-   QString mAuthor;
-   QDateTime mCommitDate;
+   ObjectId mSha;
+   QVector<ObjectId> mParentsSha;
+   int mCommitterId = IdentityTable::EMPTY_ID;
+   int mAuthorId = IdentityTable::EMPTY_ID;
+   // The dates are formatted only when they are shown, with DateFormatter.
+   long long mCommitSecs = 0;
+   int mTimeZoneOffset = 0;
    QString mShortLog;
    QString mLongLog;
    QString mDiff;
    QVector<Lane> mLanes;
-   References mReferences;
+   bool mHasReferences = false;
+   bool mDetailsMissing = false;
 };
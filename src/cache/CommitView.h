@@ -0,0 +1,80 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+
+/*!
+ \brief The CommitView class is a lightweight handle to a commit stored in the RevisionsCache. It gives read-only access
+ to the data of the commit without copying it, so it can be used in the paths that are called for every visible cell
+ (painting, model data) without allocating anything.
+
+ The handle is only valid until the cache changes: it must not be stored beyond the function that requested it.
+
+ \class CommitView CommitView.h "CommitView.h"
+*/
+class CommitView
+{
+public:
+   CommitView() = default;
+   explicit CommitView(const CommitInfo *commit, const References *references = nullptr)
+      : mCommit(commit)
+      , mReferences(references)
+   {
+   }
+
+   bool isValid() const { return mCommit && mCommit->isValid(); }
+   bool isWip() const { return mCommit->isWip(); }
+   bool isBoundary() const { return mCommit->isBoundary(); }
+   bool hasDetails() const { return mCommit->hasDetails(); }
+
+   const ObjectId &id() const { return mCommit->mSha; }
+   QString sha() const { return mCommit->mSha.toString(); }
+   const QString &author() const { return IdentityTable::get(mCommit->mAuthorId).full; }
+   const QString &authorName() const { return IdentityTable::get(mCommit->mAuthorId).name; }
+   const QString &committer() const { return IdentityTable::get(mCommit->mCommitterId).full; }
+   int authorId() const { return mCommit->mAuthorId; }
+   const QString &shortLog() const { return mCommit->mShortLog; }
+   long long secsSinceEpoch() const { return mCommit->mCommitSecs; }
+
+   const QVector<Lane> &lanes() const { return mCommit->mLanes; }
+   Lane getLane(int i) const { return mCommit->mLanes.at(i); }
+   int getLanesCount() const { return mCommit->mLanes.count(); }
+   int getActiveLane() const { return mCommit->getActiveLane(); }
+
+   bool hasReferences() const { return mReferences && !mReferences->isEmpty(); }
+   QStringList getReferences(References::Type type) const
+   {
+      return mReferences ? mReferences->getReferences(type) : QStringList();
+   }
+
+   /*!
+    \brief Returns a copy of the commit. It should only be used when the data must outlive the handle.
+   */
+   CommitInfo toCommitInfo() const { return mCommit ? *mCommit : CommitInfo(); }
+
+private:
+   const CommitInfo *mCommit = nullptr;
+   const References *mReferences = nullptr;
+};
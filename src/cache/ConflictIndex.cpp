@@ -0,0 +1,136 @@
+#include "ConflictIndex.h"
+
+#include <LazyLog.h>
+
+#include <QFile>
+
+#include <cstring>
+
+namespace
+{
+const int MARKER_SIZE = 7;
+
+/*!
+ \brief Tells if a line is a conflict marker: seven times the character, followed by a space or the end of the line.
+*/
+bool isMarker(const uchar *line, qint64 size, char character)
+{
+   if (size < MARKER_SIZE || (size > MARKER_SIZE && line[MARKER_SIZE] != ' ' && line[MARKER_SIZE] != '\r'))
+      return false;
+
+   for (auto i = 0; i < MARKER_SIZE; ++i)
+      if (line[i] != character)
+         return false;
+
+   return true;
+}
+}
+
+ConflictIndex::ConflictIndex(const void *repository, QObject *parent)
+   : QObject(parent)
+   , mWorker(new WorkerQueue(repository, WorkerPool::Priority::Refresh, true))
+{
+}
+
+ConflictIndex::~ConflictIndex()
+{
+   mRequest.fetchAndAddOrdered(1);
+
+   // The scans that didn't start are discarded.
+   mWorker.reset();
+}
+
+void ConflictIndex::scan(const QString &workingDir, const QStringList &files)
+{
+   const auto request = mRequest.fetchAndAddOrdered(1) + 1;
+
+   mWorkingDir = workingDir;
+   mRegions.clear();
+
+   for (const auto &file : files)
+      post(request, file);
+}
+
+void ConflictIndex::rescan(const QString &file)
+{
+   if (!mWorkingDir.isEmpty())
+      post(mRequest.loadAcquire(), file);
+}
+
+void ConflictIndex::clear()
+{
+   mRequest.fetchAndAddOrdered(1);
+   mWorkingDir.clear();
+   mRegions.clear();
+}
+
+void ConflictIndex::post(int request, const QString &file)
+{
+   const auto path = mWorkingDir + "/" + file;
+
+   mWorker->post([this, request, file, path]() {
+      if (request != mRequest.loadAcquire())
+         return;
+
+      const auto regions = scanFile(path);
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, request, file, regions]() {
+             if (request == mRequest.loadAcquire())
+             {
+                mRegions.insert(file, regions);
+                emit signalFileIndexed(file);
+             }
+          },
+          Qt::QueuedConnection);
+   });
+}
+
+QVector<ConflictIndex::Region> ConflictIndex::scanFile(const QString &path)
+{
+   QVector<Region> regions;
+   QFile file(path);
+
+   if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+      return regions;
+
+   const auto size = file.size();
+   const auto data = file.map(0, size);
+
+   if (!data)
+   {
+      QLog_LazyDebug("UI", QString("The file {%1} couldn't be mapped to find its conflicts.").arg(path));
+      return regions;
+   }
+
+   Region region;
+   auto line = 1;
+
+   for (qint64 offset = 0; offset < size; ++line)
+   {
+      const auto begin = data + offset;
+      const auto newLine = static_cast<const uchar *>(std::memchr(begin, '\n', static_cast<size_t>(size - offset)));
+      const auto length = newLine ? newLine - begin : size - offset;
+
+      // Only the markers that follow the ones before them are taken, like git does when it parses the conflicts.
+      if (*begin == '<' && isMarker(begin, length, '<'))
+         region = Region { line, -1, -1, -1 };
+      else if (region.start != -1 && region.separator == -1 && *begin == '|' && isMarker(begin, length, '|'))
+         region.base = line;
+      else if (region.start != -1 && *begin == '=' && isMarker(begin, length, '='))
+         region.separator = line;
+      else if (region.separator != -1 && *begin == '>' && isMarker(begin, length, '>'))
+      {
+         region.end = line;
+         regions.append(region);
+         region = Region();
+      }
+
+      offset += length + 1;
+   }
+
+   file.unmap(data);
+
+   return regions;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <WorkerPool.h>
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QObject>
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+
+/*!
+ \brief The ConflictIndex finds, in a worker thread, the conflicts of the files of a merge: the lines of the
+ <<<<<<<, ||||||| (diff3 style), ======= and >>>>>>> markers of every region. The files are memory mapped and scanned
+ in parallel, so a merge with hundreds of conflicted files shows its conflicts without opening them one by one, and the
+ navigation goes to the regions without reading the files again.
+
+ \class ConflictIndex ConflictIndex.h "ConflictIndex.h"
+*/
+class ConflictIndex : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the conflicts of a file are known.
+
+    \param file The file, relative to the working directory.
+   */
+   void signalFileIndexed(const QString &file);
+
+public:
+   /*!
+    \brief A conflict region. The lines start at 1, the base is -1 when the file has no diff3 markers.
+   */
+   struct Region
+   {
+      int start = -1;
+      int base = -1;
+      int separator = -1;
+      int end = -1;
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param repository The repository the work belongs to, identified by its RevisionsCache.
+    \param parent The parent object if needed.
+   */
+   explicit ConflictIndex(const void *repository, QObject *parent = nullptr);
+   /*!
+    \brief Destructor. The scans that didn't start are discarded.
+   */
+   ~ConflictIndex();
+
+   /*!
+    \brief Starts scanning the files of a merge. The files scanned before are discarded.
+
+    \param workingDir The working directory of the repository.
+    \param files The files in conflict, relative to the working directory.
+   */
+   void scan(const QString &workingDir, const QStringList &files);
+   /*!
+    \brief Scans again a file, for instance when it's edited or resolved.
+
+    \param file The file, relative to the working directory.
+   */
+   void rescan(const QString &file);
+   /*!
+    \brief Discards the files and the scans in progress.
+   */
+   void clear();
+   /*!
+    \brief Tells if the conflicts of the file are known.
+   */
+   bool isIndexed(const QString &file) const { return mRegions.contains(file); }
+   /*!
+    \brief Returns the conflicts of a file, empty if it has none or if it's not scanned yet.
+   */
+   QVector<Region> regions(const QString &file) const { return mRegions.value(file); }
+
+   /*!
+    \brief Finds the conflicts of a file.
+
+    \param path The absolute path of the file.
+    \return The regions, in the order they appear.
+   */
+   static QVector<Region> scanFile(const QString &path);
+
+private:
+   QScopedPointer<WorkerQueue> mWorker;
+   QAtomicInt mRequest;
+   QString mWorkingDir;
+   QHash<QString, QVector<Region>> mRegions;
+
+   void post(int request, const QString &file);
+};
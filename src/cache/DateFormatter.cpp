@@ -0,0 +1,29 @@
+#include "DateFormatter.h"
+
+#include <QDateTime>
+
+const QString DateFormatter::SHORT_FORMAT = "dd MMM yyyy hh:mm";
+const QString DateFormatter::NUMERIC_FORMAT = "dd/MM/yyyy hh:mm";
+
+DateFormatter &DateFormatter::instance()
+{
+   static DateFormatter formatter;
+   return formatter;
+}
+
+QString DateFormatter::format(long long secsSinceEpoch, const QString &format)
+{
+   auto &dates = instance().mDates;
+   const auto key = qMakePair(format, secsSinceEpoch / 60);
+
+   if (const auto it = dates.constFind(key); it != dates.constEnd())
+      return it.value();
+
+   if (dates.count() >= MAX_ENTRIES)
+      dates.clear();
+
+   const auto date = QDateTime::fromSecsSinceEpoch(secsSinceEpoch).toString(format);
+   dates.insert(key, date);
+
+   return date;
+}
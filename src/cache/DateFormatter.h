@@ -0,0 +1,68 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QString>
+
+/*!
+ \brief The DateFormatter turns the dates of the commits, stored as seconds since the epoch, into the text shown in the
+ views. The formatted dates are kept by minute, that is the precision shown, so the rows of the history that are
+ painted again and the commits of the same minute don't format them again.
+
+ It is used from the UI thread only.
+
+ \class DateFormatter DateFormatter.h "DateFormatter.h"
+*/
+class DateFormatter
+{
+public:
+   /*!
+    \brief The format of the dates in the history, the diffs and the blame.
+   */
+   static const QString SHORT_FORMAT;
+   /*!
+    \brief The format of the dates in the information of a commit.
+   */
+   static const QString NUMERIC_FORMAT;
+
+   /*!
+    \brief Returns the date in local time with the given format. The format must not show the seconds.
+
+    \param secsSinceEpoch The date.
+    \param format The format, as QDateTime::toString takes it.
+    \return The formatted date.
+   */
+   static QString format(long long secsSinceEpoch, const QString &format = SHORT_FORMAT);
+
+   /*!
+    \brief The maximum number of formatted dates kept. The cache is emptied when it is full.
+   */
+   static constexpr int MAX_ENTRIES = 4096;
+
+private:
+   QHash<QPair<QString, long long>, QString> mDates;
+
+   static DateFormatter &instance();
+};
@@ -0,0 +1,103 @@
+#include "DiffCache.h"
+
+#include <CommitInfo.h>
+#include <ResourceBudget.h>
+
+#include <climits>
+
+DiffCache::DiffCache()
+   : mDiffs(MAX_COST)
+{
+   // The cost is measured in bytes: the limit can't exceed an int.
+   ResourceBudget::instance().addCache(
+       QString("Diffs"), MAX_COST,
+       [this]() {
+          QMutexLocker locker(&mMutex);
+          return static_cast<qint64>(mDiffs.totalCost());
+       },
+       [this](qint64 bytes) {
+          QMutexLocker locker(&mMutex);
+          mDiffs.setMaxCost(static_cast<int>(qMin(bytes, static_cast<qint64>(INT_MAX))));
+       });
+}
+
+DiffCache &DiffCache::instance()
+{
+   static DiffCache cache;
+   return cache;
+}
+
+QString DiffCache::toString(const Key &key)
+{
+   return QString("%1\n%2\n%3\n%4\n%5").arg(key.repository, key.sha, key.parentSha, key.file, key.options);
+}
+
+bool DiffCache::isCacheable(const Key &key)
+{
+   return !key.sha.isEmpty() && key.sha != CommitInfo::ZERO_SHA && key.parentSha != CommitInfo::ZERO_SHA;
+}
+
+bool DiffCache::find(const Key &key, QString &text)
+{
+   if (!isCacheable(key))
+      return false;
+
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   if (const auto diff = cache.mDiffs.object(toString(key)))
+   {
+      text = *diff;
+      ++cache.mHits;
+      return true;
+   }
+
+   ++cache.mMisses;
+   return false;
+}
+
+void DiffCache::insert(const Key &key, const QString &text)
+{
+   if (!isCacheable(key))
+      return;
+
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   // QCache deletes the text by itself when it doesn't fit in the budget.
+   cache.mDiffs.insert(toString(key), new QString(text), qMax(1, text.size() * static_cast<int>(sizeof(QChar))));
+}
+
+DiffCache::Statistics DiffCache::statistics()
+{
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   Statistics statistics;
+   statistics.hits = cache.mHits;
+   statistics.misses = cache.mMisses;
+   statistics.entries = cache.mDiffs.count();
+   statistics.cost = cache.mDiffs.totalCost();
+
+   return statistics;
+}
+
+MemoryReport DiffCache::memoryReport()
+{
+   auto &cache = instance();
+   QMutexLocker locker(&cache.mMutex);
+
+   // QCache keeps every entry in a hash node with the key and a node of its own with the links of the LRU list: about
+   // nine pointers with the bucket. The cost of the entries is already an estimation of their heap memory.
+   auto keys = qint64(cache.mDiffs.count()) * qint64(sizeof(void *) * 9 + sizeof(QString));
+
+   for (const auto &key : cache.mDiffs.keys())
+      keys += MemoryReport::bytes(key);
+
+   MemoryReport report;
+   report.add("Diff cache texts", cache.mDiffs.count(),
+              cache.mDiffs.totalCost() + cache.mDiffs.count() * qint64(sizeof(QString)));
+   report.add("Diff cache keys", cache.mDiffs.count(), keys);
+
+   return report;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <MemoryReport.h>
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+
+/*!
+ \brief The DiffCache class keeps the text of the diffs that have already been loaded, shared by all the diff views of
+ the application. A diff between two commits can never change, so once it is stored it is only dropped to stay within
+ the memory budget. The diffs of the work in progress are never stored: they must be run again every time the files
+ change.
+
+ \class DiffCache DiffCache.h "DiffCache.h"
+*/
+class DiffCache
+{
+public:
+   /*!
+    \brief Identifies a diff: the repository (see GitBase::getRepositoryId, the same for all its work trees), the two
+    commits, the file (empty for a full commit diff) and the options given to Git, so the same pair of commits can be
+    stored once per kind of diff.
+   */
+   struct Key
+   {
+      QString repository;
+      QString sha;
+      QString parentSha;
+      QString file;
+      QString options;
+   };
+
+   /*!
+    \brief The memory, in bytes, that the stored diffs can use.
+   */
+   static constexpr int MAX_COST = 64 * 1024 * 1024;
+
+   /*!
+    \brief Tells if the diff of the key can be stored. Only the diffs where both sides are commits can.
+
+    \param key The diff.
+    \return True if the diff can't change.
+   */
+   static bool isCacheable(const Key &key);
+   /*!
+    \brief Looks for the text of a diff that has already been stored.
+
+    \param key The diff.
+    \param text The text of the diff, if it is found.
+    \return True if the diff was in the cache.
+   */
+   static bool find(const Key &key, QString &text);
+   /*!
+    \brief Stores the text of a diff. Diffs that are not cacheable, or that are bigger than the whole budget, are
+    ignored.
+
+    \param key The diff.
+    \param text The text of the diff. An empty text is stored as well: it means that there are no changes.
+   */
+   static void insert(const Key &key, const QString &text);
+   /*!
+    \brief The use of the cache since the application started.
+   */
+   struct Statistics
+   {
+      qint64 hits = 0;
+      qint64 misses = 0;
+      int entries = 0;
+      int cost = 0;
+   };
+   /*!
+    \brief Returns how many diffs were found and not found, and the diffs stored with the memory they use.
+   */
+   static Statistics statistics();
+   /*!
+    \brief Returns the memory held by the diffs stored and by the keys and nodes of the cache.
+   */
+   static MemoryReport memoryReport();
+
+private:
+   DiffCache();
+
+   static DiffCache &instance();
+   static QString toString(const Key &key);
+
+   QMutex mMutex;
+   QCache<QString, QString> mDiffs;
+   qint64 mHits = 0;
+   qint64 mMisses = 0;
+};
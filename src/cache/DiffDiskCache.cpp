@@ -0,0 +1,122 @@
+#include "DiffDiskCache.h"
+
+#include <QLogger.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+using namespace QLogger;
+
+namespace
+{
+const quint32 kMagic = 0x47514446; // GQDF
+const int kCompressionLevel = 1;
+const QString kExtension(".diff");
+}
+
+std::atomic<bool> DiffDiskCache::sEnabled { false };
+std::atomic<qint64> DiffDiskCache::sMaxBytes { DEFAULT_MAX_BYTES };
+
+DiffDiskCache::DiffDiskCache(const QString &directory)
+   : mDirectory(directory)
+{
+}
+
+void DiffDiskCache::configure(bool enabled, qint64 maxBytes)
+{
+   sEnabled = enabled;
+   sMaxBytes = maxBytes;
+}
+
+QString DiffDiskCache::filePath(const QByteArray &key) const
+{
+   const auto name = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex();
+
+   return QDir(mDirectory).filePath(QString::fromLatin1(name) + kExtension);
+}
+
+bool DiffDiskCache::load(const QByteArray &key, QByteArray &data) const
+{
+   if (!sEnabled || mDirectory.isEmpty())
+      return false;
+
+   QFile file(filePath(key));
+
+   if (!file.open(QIODevice::ReadWrite))
+      return false;
+
+   QDataStream in(&file);
+   in.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic = 0;
+   quint32 version = 0;
+   QByteArray storedKey;
+   qint32 size = 0;
+   QByteArray compressed;
+
+   in >> magic >> version >> storedKey >> size >> compressed;
+
+   // Two keys with the same hash would be a different diff.
+   if (in.status() != QDataStream::Ok || magic != kMagic || version != VERSION || storedKey != key)
+      return false;
+
+   data = qUncompress(compressed);
+
+   if (data.size() != size)
+   {
+      QLog_Warning("Git", QString("The diff cache file {%1} is corrupted.").arg(file.fileName()));
+      return false;
+   }
+
+   // The modification time is the last use of the diff: the files not used for longer are removed first.
+   file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+   return true;
+}
+
+void DiffDiskCache::save(const QByteArray &key, const QByteArray &data) const
+{
+   if (!sEnabled || mDirectory.isEmpty())
+      return;
+
+   QDir().mkpath(mDirectory);
+
+   QSaveFile file(filePath(key));
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Git", QString("The diff cache file {%1} can't be written.").arg(file.fileName()));
+      return;
+   }
+
+   QDataStream out(&file);
+   out.setVersion(QDataStream::Qt_5_9);
+   out << kMagic << VERSION << key << static_cast<qint32>(data.size()) << qCompress(data, kCompressionLevel);
+
+   if (file.commit())
+      evict();
+}
+
+void DiffDiskCache::evict() const
+{
+   const auto files = QDir(mDirectory).entryInfoList({ "*" + kExtension }, QDir::Files, QDir::Time);
+   const auto maxBytes = sMaxBytes.load();
+   qint64 bytes = 0;
+   auto removed = 0;
+
+   // The files come sorted from the last used to the oldest one.
+   for (const auto &file : files)
+   {
+      bytes += file.size();
+
+      if (bytes > maxBytes && QFile::remove(file.absoluteFilePath()))
+         ++removed;
+   }
+
+   if (removed > 0)
+      QLog_Debug("Git", QString("Removed {%1} diffs from the disk cache.").arg(removed));
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+
+/*!
+ \brief The DiffDiskCache stores in the directory of a repository the output of the diffs between two commits, so they
+ are not run again in a later session. A diff between two commits can never change: the files are only removed when
+ the cache grows over its size, the ones that were not read for longer first. Every file is compressed with the fastest
+ level of zlib.
+
+ The cache is disabled by default. It can be used from any thread.
+
+ \class DiffDiskCache DiffDiskCache.h "DiffDiskCache.h"
+*/
+class DiffDiskCache
+{
+public:
+   /*!
+    \brief Default constructor.
+
+    \param directory The directory where the diffs of the repository are stored.
+   */
+   explicit DiffDiskCache(const QString &directory);
+
+   /*!
+    \brief Enables the cache for all the repositories and sets its size.
+
+    \param enabled True to store and read the diffs, otherwise false.
+    \param maxBytes The size the files of a repository can take.
+   */
+   static void configure(bool enabled, qint64 maxBytes);
+   /*!
+    \brief Tells if the diffs are stored on disk.
+   */
+   static bool isEnabled() { return sEnabled; }
+
+   /*!
+    \brief Reads a diff that was stored. The diff becomes the last one to be removed.
+
+    \param key The key that identifies the diff: the kind of command, its options and the ids of the two commits.
+    \param data The output of the command, if it is found.
+    \return True if the diff was found and its file is valid, otherwise false.
+   */
+   bool load(const QByteArray &key, QByteArray &data) const;
+   /*!
+    \brief Stores a diff and removes the oldest ones if the cache is over its size.
+
+    \param key The key that identifies the diff.
+    \param data The output of the command.
+   */
+   void save(const QByteArray &key, const QByteArray &data) const;
+
+   static constexpr quint32 VERSION = 1;
+   static constexpr qint64 DEFAULT_MAX_BYTES = 256 * 1024 * 1024;
+
+private:
+   QString mDirectory;
+
+   static std::atomic<bool> sEnabled;
+   static std::atomic<qint64> sMaxBytes;
+
+   QString filePath(const QByteArray &key) const;
+   void evict() const;
+};
@@ -0,0 +1,234 @@
+#include "HistoryFilter.h"
+
+#include <CommitInfo.h>
+#include <IdentityTable.h>
+#include <RevisionsCache.h>
+#include <RevisionsSnapshot.h>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+template<typename Predicate>
+QBitArray evaluateRows(const RevisionsCache &cache, int from, int to, Predicate predicate)
+{
+   const auto snapshot = cache.snapshot();
+   QBitArray rows(to);
+
+   for (auto row = std::max(from, 1); row < to; ++row)
+   {
+      if (const auto commit = snapshot.commit(row); commit && predicate(*commit))
+         rows.setBit(row);
+   }
+
+   return rows;
+}
+
+void copyBits(const QBitArray &source, int from, int to, QBitArray &destination)
+{
+   for (auto row = from; row < to; ++row)
+      destination.setBit(row, source.testBit(row));
+}
+}
+
+HistoryFilter::HistoryFilter()
+   : mKey("all")
+   , mEvaluator([](const RevisionsCache &, int, int to) { return QBitArray(to, true); })
+{
+}
+
+HistoryFilter::HistoryFilter(const QString &key, bool local, Evaluator evaluator)
+   : mKey(key)
+   , mLocal(local)
+   , mEvaluator(std::move(evaluator))
+{
+}
+
+HistoryFilter HistoryFilter::author(const QString &text)
+{
+   return HistoryFilter(QString("author(%1)").arg(text), true, [text](const RevisionsCache &cache, int from, int to) {
+      const auto matches = IdentityTable::matching(text);
+
+      return evaluateRows(cache, from, to,
+                          [&matches](const CommitInfo &commit) { return matches.value(commit.authorId()); });
+   });
+}
+
+HistoryFilter HistoryFilter::authorId(int authorId)
+{
+   return HistoryFilter(QString("authorId(%1)").arg(authorId), true,
+                        [authorId](const RevisionsCache &cache, int from, int to) {
+                           const auto authorRows = cache.getAuthorRows(authorId);
+                           QBitArray rows(to);
+
+                           for (auto it = std::lower_bound(authorRows.cbegin(), authorRows.cend(), from);
+                                it != authorRows.cend() && *it < to; ++it)
+                              rows.setBit(*it);
+
+                           return rows;
+                        });
+}
+
+HistoryFilter HistoryFilter::dateRange(const QDateTime &from, const QDateTime &to)
+{
+   const auto fromSecs = from.isValid() ? from.toSecsSinceEpoch() : std::numeric_limits<long long>::min();
+   const auto toSecs = to.isValid() ? to.toSecsSinceEpoch() : std::numeric_limits<long long>::max();
+   const auto key = QString("date(%1,%2)").arg(fromSecs).arg(toSecs);
+
+   return HistoryFilter(key, true, [fromSecs, toSecs](const RevisionsCache &cache, int fromRow, int toRow) {
+      return evaluateRows(cache, fromRow, toRow, [fromSecs, toSecs](const CommitInfo &commit) {
+         const auto secs = commit.secsSinceEpoch();
+         return secs >= fromSecs && secs <= toSecs;
+      });
+   });
+}
+
+HistoryFilter HistoryFilter::reachableFrom(References::Type type, const QString &pattern)
+{
+   const auto regExp = QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern));
+   const auto key = QString("reachable(%1,%2)").arg(static_cast<int>(type)).arg(pattern);
+
+   return HistoryFilter(key, false, [type, regExp](const RevisionsCache &cache, int, int to) {
+      const auto snapshot = cache.snapshot();
+      QBitArray rows(to);
+
+      for (const auto &reference : cache.getBranches(type))
+      {
+         for (const auto &name : reference.second)
+         {
+            if (regExp.match(name).hasMatch())
+            {
+               if (const auto row = cache.getCommitPos(reference.first); row > 0 && row < to)
+                  rows.setBit(row);
+
+               break;
+            }
+         }
+      }
+
+      // The parents are always in later rows than their children, so one pass marks everything reachable.
+      for (auto row = 1; row < to; ++row)
+      {
+         if (!rows.testBit(row))
+            continue;
+
+         for (const auto &parent : snapshot.commit(row)->parentIds())
+         {
+            if (const auto parentRow = cache.getCommitPos(parent); parentRow > row && parentRow < to)
+               rows.setBit(parentRow);
+         }
+      }
+
+      return rows;
+   });
+}
+
+HistoryFilter HistoryFilter::shas(const QStringList &shaList)
+{
+   // The lists can be long (e.g. the history of a file), so the key only keeps their hash.
+   const auto hash = QCryptographicHash::hash(shaList.join(',').toLatin1(), QCryptographicHash::Sha1).toHex();
+
+   return HistoryFilter(QString("shas(%1)").arg(QString::fromLatin1(hash)), true,
+                        [shaList](const RevisionsCache &cache, int from, int to) {
+                           QBitArray rows(to);
+
+                           for (const auto &sha : shaList)
+                           {
+                              if (const auto row = cache.getCommitPos(sha); row >= std::max(from, 1) && row < to)
+                                 rows.setBit(row);
+                           }
+
+                           return rows;
+                        });
+}
+
+HistoryFilter HistoryFilter::operator&(const HistoryFilter &other) const
+{
+   return HistoryFilter(QString("(%1&%2)").arg(mKey, other.mKey), mLocal && other.mLocal,
+                        [left = mEvaluator, right = other.mEvaluator](const RevisionsCache &cache, int from, int to) {
+                           return left(cache, from, to) & right(cache, from, to);
+                        });
+}
+
+HistoryFilter HistoryFilter::operator|(const HistoryFilter &other) const
+{
+   return HistoryFilter(QString("(%1|%2)").arg(mKey, other.mKey), mLocal && other.mLocal,
+                        [left = mEvaluator, right = other.mEvaluator](const RevisionsCache &cache, int from, int to) {
+                           return left(cache, from, to) | right(cache, from, to);
+                        });
+}
+
+HistoryFilter HistoryFilter::operator~() const
+{
+   return HistoryFilter(QString("~%1").arg(mKey), mLocal,
+                        [evaluator = mEvaluator](const RevisionsCache &cache, int from, int to) {
+                           return ~evaluator(cache, from, to);
+                        });
+}
+
+QBitArray HistoryFilter::evaluate(const RevisionsCache &cache) const
+{
+   return evaluate(cache, 0, cache.count());
+}
+
+QBitArray HistoryFilter::evaluate(const RevisionsCache &cache, int from, int to) const
+{
+   auto rows = mEvaluator(cache, from, to);
+   rows.resize(to);
+
+   if (!rows.isEmpty())
+      rows.clearBit(0);
+
+   return rows;
+}
+
+HistoryFilterCache::HistoryFilterCache(int maxFilters)
+   : mResults(maxFilters)
+{
+}
+
+QBitArray HistoryFilterCache::evaluate(const HistoryFilter &filter, const RevisionsCache &cache)
+{
+   const auto count = cache.count();
+   const auto generation = cache.generation();
+
+   if (const auto result = mResults.object(filter.key()))
+   {
+      const auto shift = cache.rowsShiftSince(result->generation);
+      const auto previousCount = result->rows.size();
+
+      if (shift == 0 && previousCount == count && (filter.isLocal() || result->generation == generation))
+         return result->rows;
+
+      if (filter.isLocal() && shift >= 0 && previousCount > 0 && previousCount + shift <= count)
+      {
+         // The rows added on top and at the end are evaluated, the rest are moved down from the previous result.
+         QBitArray rows(count);
+
+         if (shift > 0)
+            copyBits(filter.evaluate(cache, 1, 1 + shift), 1, 1 + shift, rows);
+
+         for (auto row = 1; row < previousCount; ++row)
+            rows.setBit(row + shift, result->rows.testBit(row));
+
+         if (previousCount + shift < count)
+            copyBits(filter.evaluate(cache, previousCount + shift, count), previousCount + shift, count, rows);
+
+         result->generation = generation;
+         result->rows = rows;
+
+         return rows;
+      }
+   }
+
+   const auto rows = filter.evaluate(cache);
+
+   mResults.insert(filter.key(), new Result { generation, rows });
+
+   return rows;
+}
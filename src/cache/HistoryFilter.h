@@ -0,0 +1,155 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <References.h>
+
+#include <QBitArray>
+#include <QStringList>
+#include <QCache>
+
+#include <functional>
+
+class RevisionsCache;
+class QDateTime;
+
+/*!
+ \brief The HistoryFilter is a condition over the commits of the RevisionsCache. Evaluating it gives a bitset with one
+ bit per row of the history, so the filters are combined with the bitwise operators (AND, OR, NOT) without going back to
+ git:
+
+ \code
+ const auto filter = HistoryFilter::author("john") & HistoryFilter::dateRange(from, to)
+     & HistoryFilter::reachableFrom(References::Type::LocalBranch, "release/*");
+ view->filter(filter);
+ \endcode
+
+ The conditions that need git (e.g. the commits that touch a path) are built from the SHAs git returns with \ref shas
+ and combined as any other filter. The filters read the references of the cache, so they are evaluated in the GUI
+ thread.
+
+ Every filter has a key that identifies its definition, used by the HistoryFilterCache to keep the results.
+
+ \class HistoryFilter HistoryFilter.h "HistoryFilter.h"
+*/
+class HistoryFilter
+{
+public:
+   /*!
+    \brief Builds a filter that accepts all the commits.
+   */
+   HistoryFilter();
+
+   /*!
+    \brief Accepts the commits whose author contains the text (case insensitive), either in the name or the email.
+   */
+   static HistoryFilter author(const QString &text);
+   /*!
+    \brief Accepts the commits of the author. The rows come straight from the rows the cache keeps for every author.
+   */
+   static HistoryFilter authorId(int authorId);
+   /*!
+    \brief Accepts the commits done between the two dates, both included. An invalid date leaves that side open.
+   */
+   static HistoryFilter dateRange(const QDateTime &from, const QDateTime &to);
+   /*!
+    \brief Accepts the commits reachable from the references whose name matches the wildcard pattern (e.g.
+    "release/*").
+   */
+   static HistoryFilter reachableFrom(References::Type type, const QString &pattern);
+   /*!
+    \brief Accepts the commits of the list.
+   */
+   static HistoryFilter shas(const QStringList &shaList);
+
+   HistoryFilter operator&(const HistoryFilter &other) const;
+   HistoryFilter operator|(const HistoryFilter &other) const;
+   HistoryFilter operator~() const;
+
+   /*!
+    \brief Returns the text that identifies the definition of the filter. Two filters with the same key accept the
+    same commits.
+   */
+   QString key() const { return mKey; }
+   /*!
+    \brief Tells if the filter decides every row by itself. Those filters can be evaluated only for the rows added to
+    the history. The reachability depends on the rest of the history, so it's not local.
+   */
+   bool isLocal() const { return mLocal; }
+
+   /*!
+    \brief Evaluates the filter over the history of the cache. The WIP row is never accepted.
+
+    \param cache The cache to evaluate the filter with.
+    \return The bitset with the accepted rows.
+   */
+   QBitArray evaluate(const RevisionsCache &cache) const;
+
+private:
+   friend class HistoryFilterCache;
+
+   // Returns a bitset of \p to bits where only the rows from \p from are evaluated.
+   using Evaluator = std::function<QBitArray(const RevisionsCache &, int from, int to)>;
+
+   explicit HistoryFilter(const QString &key, bool local, Evaluator evaluator);
+
+   QString mKey;
+   bool mLocal = true;
+   Evaluator mEvaluator;
+
+   QBitArray evaluate(const RevisionsCache &cache, int from, int to) const;
+};
+
+/*!
+ \brief The HistoryFilterCache keeps the results of the last filters evaluated, keyed by their definition and the
+ generation of the cache. When the history grows (the rows loaded incrementally or the commits added on top of it) the
+ local filters are only evaluated for the new rows.
+
+ \class HistoryFilterCache HistoryFilter.h "HistoryFilter.h"
+*/
+class HistoryFilterCache
+{
+public:
+   explicit HistoryFilterCache(int maxFilters = DEFAULT_MAX_FILTERS);
+
+   /*!
+    \brief Evaluates the filter, reusing the previous result of the same filter if there is any.
+
+    \param filter The filter to evaluate.
+    \param cache The cache to evaluate the filter with.
+    \return The bitset with the accepted rows.
+   */
+   QBitArray evaluate(const HistoryFilter &filter, const RevisionsCache &cache);
+
+private:
+   static constexpr int DEFAULT_MAX_FILTERS = 16;
+
+   struct Result
+   {
+      int generation = -1;
+      QBitArray rows;
+   };
+
+   QCache<QString, Result> mResults;
+};
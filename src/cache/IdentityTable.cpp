@@ -0,0 +1,84 @@
+#include "IdentityTable.h"
+
+IdentityTable::IdentityTable()
+{
+   mIdentities.push_back(Identity());
+   mIds.insert(QByteArray(), EMPTY_ID);
+}
+
+IdentityTable &IdentityTable::instance()
+{
+   static IdentityTable table;
+   return table;
+}
+
+int IdentityTable::intern(const char *data, int size)
+{
+   auto &table = instance();
+
+   // The key is not copied for the lookup: only the new identities need their own copy.
+   const auto key = QByteArray::fromRawData(data, size);
+
+   {
+      QReadLocker locker(&table.mLock);
+
+      if (const auto it = table.mIds.constFind(key); it != table.mIds.constEnd())
+         return it.value();
+   }
+
+   QWriteLocker locker(&table.mLock);
+
+   if (const auto it = table.mIds.constFind(key); it != table.mIds.constEnd())
+      return it.value();
+
+   Identity identity;
+   identity.full = QString::fromUtf8(data, size);
+
+   const auto emailStart = identity.full.indexOf('<');
+   identity.name = identity.full.left(emailStart);
+
+   if (emailStart != -1)
+   {
+      const auto emailEnd = identity.full.lastIndexOf('>');
+      identity.email = identity.full.mid(emailStart + 1, emailEnd > emailStart ? emailEnd - emailStart - 1 : -1);
+   }
+
+   const auto id = static_cast<int>(table.mIdentities.size());
+
+   table.mIdentities.push_back(std::move(identity));
+   table.mIds.insert(QByteArray(data, size), id);
+
+   return id;
+}
+
+int IdentityTable::intern(const QString &nameAndEmail)
+{
+   const auto utf8 = nameAndEmail.toUtf8();
+
+   return intern(utf8.constData(), utf8.size());
+}
+
+const IdentityTable::Identity &IdentityTable::get(int id)
+{
+   auto &table = instance();
+
+   QReadLocker locker(&table.mLock);
+
+   // The deque never moves its elements when it grows, so the reference outlives the lock.
+   return id >= 0 && id < static_cast<int>(table.mIdentities.size()) ? table.mIdentities[id]
+                                                                       : table.mIdentities.front();
+}
+
+QVector<bool> IdentityTable::matching(const QString &text)
+{
+   auto &table = instance();
+
+   QReadLocker locker(&table.mLock);
+
+   QVector<bool> matches(static_cast<int>(table.mIdentities.size()));
+
+   for (auto i = 0; i < matches.count(); ++i)
+      matches[i] = table.mIdentities[i].full.contains(text);
+
+   return matches;
+}
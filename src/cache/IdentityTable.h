@@ -0,0 +1,99 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+#include <deque>
+
+/*!
+ \brief The IdentityTable class stores once every author and committer identity ("Name<email>") of the loaded
+ repositories. The commits only keep the integer id of their identities, so the memory is shared between all the commits
+ of the same person and the name and the email are split only once, when the identity is interned.
+
+ The table can be filled from the thread that builds the revisions while the UI reads it.
+
+ \class IdentityTable IdentityTable.h "IdentityTable.h"
+*/
+class IdentityTable
+{
+public:
+   struct Identity
+   {
+      QString full;
+      QString name;
+      QString email;
+   };
+
+   /*!
+    \brief The id of the empty identity. It is the one used by the commits that don't have any.
+   */
+   static constexpr int EMPTY_ID = 0;
+
+   /*!
+    \brief Returns the id of the identity in the format "Name<email>" given in UTF-8 characters. The identity is added to
+    the table if it wasn't there yet.
+
+    \param data The UTF-8 characters of the identity.
+    \param size The number of characters.
+    \return The id of the identity.
+   */
+   static int intern(const char *data, int size);
+   /*!
+    \brief Returns the id of the identity in the format "Name<email>". The identity is added to the table if it wasn't
+    there yet.
+
+    \param nameAndEmail The identity.
+    \return The id of the identity.
+   */
+   static int intern(const QString &nameAndEmail);
+   /*!
+    \brief Returns the identity of the given id. The reference remains valid for the lifetime of the application. An id
+    that is not in the table returns the empty identity.
+
+    \param id The id of the identity.
+    \return The identity.
+   */
+   static const Identity &get(int id);
+   /*!
+    \brief Returns, indexed by id, which identities contain the given text in their "Name<email>" representation. It
+    allows to filter the commits by author comparing integers.
+
+    \param text The text to search.
+    \return A vector with one flag for every identity of the table.
+   */
+   static QVector<bool> matching(const QString &text);
+
+private:
+   IdentityTable();
+
+   static IdentityTable &instance();
+
+   QReadWriteLock mLock;
+   QHash<QByteArray, int> mIds;
+   std::deque<Identity> mIdentities;
+};
@@ -1,6 +1,10 @@
 #pragma once
 
-enum class LaneType;
+#include <QHash>
+
+#include <cstdint>
+
+enum class LaneType : std::uint8_t;
 
 class Lane
 {
@@ -23,3 +27,8 @@ public:
 private:
    LaneType mType;
 };
+
+inline uint qHash(const Lane &lane, uint seed = 0)
+{
+   return qHash(static_cast<uint>(lane.getType()), seed);
+}
@@ -1,6 +1,8 @@
 #pragma once
 
-enum class LaneType
+#include <cstdint>
+
+enum class LaneType : std::uint8_t
 {
    EMPTY,
    ACTIVE,
@@ -0,0 +1,279 @@
+#include "LazyLog.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+
+#include <cstdint>
+#include <memory>
+
+using namespace QLogger;
+
+namespace
+{
+const int WRITER_INTERVAL_MS = 50;
+const int MAX_BATCH_MESSAGES = 1024;
+
+struct Message
+{
+   LogLevel level = LogLevel::Info;
+   QString module;
+   QString message;
+};
+
+/*
+ The ring buffer of Dmitry Vyukov: every cell keeps the position it can be written or read at, so the producers only
+ compete for the write position and never block. There is a single consumer, the writer.
+*/
+class RingBuffer
+{
+public:
+   explicit RingBuffer(int capacity)
+   {
+      auto size = size_t(1);
+
+      while (size < static_cast<size_t>(qMax(capacity, 2)))
+         size <<= 1;
+
+      mMask = size - 1;
+      mCells.reset(new Cell[size]);
+
+      for (auto i = size_t(0); i < size; ++i)
+         mCells[i].sequence.store(i, std::memory_order_relaxed);
+   }
+
+   bool push(Message &&message)
+   {
+      auto position = mWritePosition.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+         auto &cell = mCells[position & mMask];
+         const auto sequence = cell.sequence.load(std::memory_order_acquire);
+         const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+         if (difference == 0)
+         {
+            if (mWritePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+               cell.message = std::move(message);
+               cell.sequence.store(position + 1, std::memory_order_release);
+               return true;
+            }
+         }
+         else if (difference < 0)
+            return false;
+         else
+            position = mWritePosition.load(std::memory_order_relaxed);
+      }
+   }
+
+   bool pop(Message &message)
+   {
+      auto &cell = mCells[mReadPosition & mMask];
+
+      if (cell.sequence.load(std::memory_order_acquire) != mReadPosition + 1)
+         return false;
+
+      message = std::move(cell.message);
+      cell.sequence.store(mReadPosition + mMask + 1, std::memory_order_release);
+      ++mReadPosition;
+
+      return true;
+   }
+
+private:
+   struct Cell
+   {
+      std::atomic<size_t> sequence;
+      Message message;
+   };
+
+   std::unique_ptr<Cell[]> mCells;
+   size_t mMask = 0;
+   std::atomic<size_t> mWritePosition { 0 };
+   size_t mReadPosition = 0;
+};
+
+void write(const Message &message)
+{
+   switch (message.level)
+   {
+      case LogLevel::Trace:
+         QLog_Trace(message.module, message.message);
+         break;
+      case LogLevel::Debug:
+         QLog_Debug(message.module, message.message);
+         break;
+      case LogLevel::Info:
+         QLog_Info(message.module, message.message);
+         break;
+      case LogLevel::Warning:
+         QLog_Warning(message.module, message.message);
+         break;
+      case LogLevel::Error:
+         QLog_Error(message.module, message.message);
+         break;
+      case LogLevel::Fatal:
+         QLog_Fatal(message.module, message.message);
+         break;
+   }
+}
+
+class Writer : public QThread
+{
+public:
+   Writer(RingBuffer *buffer, const LazyLog::SinkOptions &options)
+      : mBuffer(buffer)
+      , mOptions(options)
+   {
+   }
+
+   std::atomic<bool> stopping { false };
+   std::atomic<int> dropped { 0 };
+
+protected:
+   void run() override
+   {
+      mWindow.start();
+
+      while (!stopping.load(std::memory_order_acquire))
+      {
+         if (drain() < MAX_BATCH_MESSAGES)
+            msleep(WRITER_INTERVAL_MS);
+      }
+
+      // The producers are stopped, everything left is written.
+      while (drain() > 0)
+         ;
+
+      closeWindow();
+   }
+
+private:
+   RingBuffer *mBuffer = nullptr;
+   LazyLog::SinkOptions mOptions;
+   QElapsedTimer mWindow;
+   QHash<QString, int> mWritten;
+   QHash<QString, int> mSkipped;
+
+   int drain()
+   {
+      if (mWindow.elapsed() >= 1000)
+         closeWindow();
+
+      Message message;
+      auto count = 0;
+
+      while (count < MAX_BATCH_MESSAGES && mBuffer->pop(message))
+      {
+         ++count;
+
+         auto &written = mWritten[message.module];
+
+         if (mOptions.maxMessagesPerSecond > 0 && written >= mOptions.maxMessagesPerSecond)
+            ++mSkipped[message.module];
+         else
+         {
+            ++written;
+            write(message);
+         }
+      }
+
+      return count;
+   }
+
+   void closeWindow()
+   {
+      if (mOptions.overflow == LazyLog::OverflowPolicy::Count)
+      {
+         for (auto iter = mSkipped.cbegin(); iter != mSkipped.cend(); ++iter)
+         {
+            QLog_Info(iter.key(),
+                      QString("{%1} messages skipped by the limit of {%2} per second.")
+                          .arg(QString::number(iter.value()), QString::number(mOptions.maxMessagesPerSecond)));
+         }
+
+         if (const auto lost = dropped.exchange(0))
+            QLog_Warning("Git", QString("{%1} messages lost, the log buffer was full.").arg(lost));
+      }
+      else
+         dropped.store(0);
+
+      mWritten.clear();
+      mSkipped.clear();
+      mWindow.restart();
+   }
+};
+
+struct Sink
+{
+   QMutex mutex;
+   std::unique_ptr<RingBuffer> buffer;
+   std::unique_ptr<Writer> writer;
+   std::atomic<Writer *> running { nullptr };
+   std::atomic<int> producers { 0 };
+};
+
+Sink &sink()
+{
+   static Sink instance;
+   return instance;
+}
+}
+
+namespace LazyLog
+{
+void startAsyncSink(const SinkOptions &options)
+{
+   auto &state = sink();
+   QMutexLocker lock(&state.mutex);
+
+   if (state.writer)
+      return;
+
+   if (!state.buffer)
+      state.buffer.reset(new RingBuffer(options.capacity));
+
+   state.writer.reset(new Writer(state.buffer.get(), options));
+   state.writer->start(QThread::LowPriority);
+   state.running.store(state.writer.get());
+}
+
+void stopAsyncSink()
+{
+   auto &state = sink();
+   QMutexLocker lock(&state.mutex);
+
+   if (!state.writer)
+      return;
+
+   // The producers that saw the writer running finish their posts before the last drain. Both sides use sequential
+   // consistency, so a producer either sees the writer stopped or is waited for.
+   state.running.store(nullptr);
+
+   while (state.producers.load() > 0)
+      QThread::yieldCurrentThread();
+
+   state.writer->stopping.store(true, std::memory_order_release);
+   state.writer->wait();
+   state.writer.reset();
+}
+
+bool post(QLogger::LogLevel level, const QString &module, const QString &message)
+{
+   auto &state = sink();
+
+   ++state.producers;
+
+   const auto writer = state.running.load();
+
+   if (writer && !state.buffer->push(Message { level, module, message }))
+      writer->dropped.fetch_add(1, std::memory_order_relaxed);
+
+   --state.producers;
+
+   return writer != nullptr;
+}
+}
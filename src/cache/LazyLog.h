@@ -0,0 +1,136 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QLogger.h>
+
+#include <atomic>
+
+/*!
+ \brief The LazyLog mirrors the level and the pause state of the QLoggerManager, so the hot paths can skip building
+ the messages that would be discarded. QLogger only checks the level once the message, and all its arguments, have been
+ formatted.
+
+ The QLog_LazyTrace and QLog_LazyDebug macros evaluate the message only when its level is enabled. They must be used
+ with the messages written once per command, commit or reference, the rest of the calls can keep the QLog ones.
+
+ While the asynchronous sink runs, the lazy messages are posted to a lock-free ring buffer instead of being given to
+ QLogger by the thread that writes them. A background writer takes them in batches, limits the messages of every module
+ per second and gives the rest to QLogger, so the loader and the GUI thread never wait for the log.
+*/
+namespace LazyLog
+{
+namespace Detail
+{
+// Everything is enabled until the level is set, so no message is lost before the logger is configured.
+inline std::atomic<int> level { static_cast<int>(QLogger::LogLevel::Trace) };
+inline std::atomic<bool> paused { false };
+}
+
+/*!
+ \brief What the sink does with the messages posted when the ring buffer is full.
+*/
+enum class OverflowPolicy
+{
+   Drop, ///< The messages are lost silently.
+   Count ///< The messages are lost, but the writer logs how many were.
+};
+
+/*!
+ \brief The configuration of the asynchronous sink.
+*/
+struct SinkOptions
+{
+   int capacity = 8192; ///< The number of messages the ring buffer holds, rounded up to a power of two.
+   OverflowPolicy overflow = OverflowPolicy::Count;
+   int maxMessagesPerSecond = 200; ///< The messages of a module written per second. 0 doesn't limit them.
+};
+
+/*!
+ \brief Starts the background writer of the lazy messages. The capacity of the ring buffer is fixed the first time.
+*/
+void startAsyncSink(const SinkOptions &options);
+
+/*!
+ \brief Writes the messages left in the ring buffer and stops the writer. The lazy messages are given to QLogger
+ directly again.
+*/
+void stopAsyncSink();
+
+/*!
+ \brief Posts a message to the asynchronous sink.
+
+ \return False if the sink doesn't run and the message must be given to QLogger.
+*/
+bool post(QLogger::LogLevel level, const QString &module, const QString &message);
+
+/*!
+ \brief Sets the level the QLoggerManager writes, it must be called every time it's overwritten.
+*/
+inline void setLevel(QLogger::LogLevel level)
+{
+   Detail::level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+/*!
+ \brief Sets if the QLoggerManager is paused, it must be called every time it's paused or resumed.
+*/
+inline void setPaused(bool paused)
+{
+   Detail::paused.store(paused, std::memory_order_relaxed);
+}
+
+/*!
+ \brief Returns true if a message with the given level would be written.
+*/
+inline bool isEnabled(QLogger::LogLevel level)
+{
+   return !Detail::paused.load(std::memory_order_relaxed)
+       && static_cast<int>(level) >= Detail::level.load(std::memory_order_relaxed);
+}
+}
+
+#define QLog_LazyTrace(module, message)                                                                                \
+   do                                                                                                                  \
+   {                                                                                                                   \
+      if (LazyLog::isEnabled(QLogger::LogLevel::Trace))                                                                \
+      {                                                                                                                \
+         const QString lazyLogMessage = message;                                                                       \
+                                                                                                                       \
+         if (!LazyLog::post(QLogger::LogLevel::Trace, module, lazyLogMessage))                                         \
+            QLog_Trace(module, lazyLogMessage);                                                                        \
+      }                                                                                                                \
+   } while (false)
+
+#define QLog_LazyDebug(module, message)                                                                                \
+   do                                                                                                                  \
+   {                                                                                                                   \
+      if (LazyLog::isEnabled(QLogger::LogLevel::Debug))                                                                \
+      {                                                                                                                \
+         const QString lazyLogMessage = message;                                                                       \
+                                                                                                                       \
+         if (!LazyLog::post(QLogger::LogLevel::Debug, module, lazyLogMessage))                                         \
+            QLog_Debug(module, lazyLogMessage);                                                                        \
+      }                                                                                                                \
+   } while (false)
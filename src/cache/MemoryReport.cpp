@@ -0,0 +1,49 @@
+#include "MemoryReport.h"
+
+#include <QJsonObject>
+
+void MemoryReport::add(const QString &structure, qint64 count, qint64 bytes)
+{
+   Entry entry;
+   entry.structure = structure;
+   entry.count = count;
+   entry.bytes = bytes;
+
+   mEntries.append(entry);
+}
+
+qint64 MemoryReport::total() const
+{
+   auto total = qint64(0);
+
+   for (const auto &entry : mEntries)
+      total += entry.bytes;
+
+   return total;
+}
+
+QStringList MemoryReport::toStrings() const
+{
+   QStringList lines;
+
+   for (const auto &entry : mEntries)
+   {
+      lines.append(QString("%1: %2 KB in %3 elements")
+                       .arg(entry.structure, QString::number(entry.bytes / 1024), QString::number(entry.count)));
+   }
+
+   return lines;
+}
+
+QJsonArray MemoryReport::toJson() const
+{
+   QJsonArray array;
+
+   for (const auto &entry : mEntries)
+   {
+      array.append(
+          QJsonObject { { "structure", entry.structure }, { "count", entry.count }, { "bytes", entry.bytes } });
+   }
+
+   return array;
+}
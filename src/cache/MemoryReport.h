@@ -0,0 +1,144 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ \brief The MemoryReport lists the bytes held by every structure of a cache, so the memory optimizations can be
+ measured one by one. The sizes are estimations: the heap blocks of the Qt containers are counted with their header
+ and their capacity, not only with their elements, but the overhead of the allocator is not.
+
+ The implicitly shared data (the paths interned in the PathTable, the lanes shared by the commits) is counted once, in
+ the structure that owns it. The rest of the shared strings are counted by every owner.
+
+ \class MemoryReport MemoryReport.h "MemoryReport.h"
+*/
+class MemoryReport
+{
+public:
+   /*!
+    \brief The memory of a structure.
+   */
+   struct Entry
+   {
+      QString structure;
+      qint64 count = 0; ///< The number of elements.
+      qint64 bytes = 0;
+   };
+
+   /*!
+    \brief Adds a structure to the report.
+
+    \param structure The name of the structure.
+    \param count The number of elements.
+    \param bytes The bytes held by the structure and its elements.
+   */
+   void add(const QString &structure, qint64 count, qint64 bytes);
+   /*!
+    \brief Returns the structures in the order they were added.
+   */
+   const QVector<Entry> &entries() const { return mEntries; }
+   /*!
+    \brief Returns the bytes held by all the structures.
+   */
+   qint64 total() const;
+   /*!
+    \brief Returns a line of text for every structure.
+   */
+   QStringList toStrings() const;
+   /*!
+    \brief Returns an array with an object for every structure.
+   */
+   QJsonArray toJson() const;
+
+   /*!
+    \brief Returns the bytes of the heap block of a string, 0 if it has none (null, empty or raw data).
+   */
+   static qint64 bytes(const QString &text)
+   {
+      return text.capacity() > 0 ? qint64(sizeof(QArrayData)) + (text.capacity() + 1) * qint64(sizeof(QChar)) : 0;
+   }
+   /*!
+    \brief Returns the bytes of the heap block of a vector, without the heap of its elements.
+   */
+   template <typename T>
+   static qint64 bytes(const QVector<T> &vector)
+   {
+      return vector.capacity() > 0 ? qint64(sizeof(QArrayData)) + vector.capacity() * qint64(sizeof(T)) : 0;
+   }
+   /*!
+    \brief Returns the bytes of the heap block of a list, without the heap of its elements. The capacity of a list is
+    not public, so only its size is counted.
+   */
+   template <typename T>
+   static qint64 bytes(const QList<T> &list)
+   {
+      return list.isEmpty() ? 0 : qint64(sizeof(QListData::Data)) + list.size() * qint64(sizeof(void *));
+   }
+   /*!
+    \brief Returns the bytes of the buckets and nodes of a hash, without the heap of its keys and values.
+   */
+   template <typename K, typename V>
+   static qint64 bytes(const QHash<K, V> &hash)
+   {
+      return hash.isEmpty() ? 0
+                            : hash.capacity() * qint64(sizeof(void *))
+                + hash.size() * node(sizeof(void *) + sizeof(uint) + sizeof(K) + sizeof(V));
+   }
+   /*!
+    \brief Returns the bytes of the buckets and nodes of a set, without the heap of its values.
+   */
+   template <typename T>
+   static qint64 bytes(const QSet<T> &set)
+   {
+      return set.isEmpty()
+          ? 0
+          : set.capacity() * qint64(sizeof(void *)) + set.size() * node(sizeof(void *) + sizeof(uint) + sizeof(T));
+   }
+   /*!
+    \brief Returns the bytes of the nodes of a map, without the heap of its keys and values.
+   */
+   template <typename K, typename V>
+   static qint64 bytes(const QMap<K, V> &map)
+   {
+      return map.size() * node(3 * sizeof(void *) + sizeof(K) + sizeof(V));
+   }
+
+private:
+   QVector<Entry> mEntries;
+
+   static qint64 node(size_t size)
+   {
+      // The nodes are aligned to the size of a pointer.
+      return qint64((size + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *));
+   }
+};
@@ -0,0 +1,171 @@
+#include "ObjectId.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+int hexValue(ushort c)
+{
+   if (c >= '0' && c <= '9')
+      return c - '0';
+   if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+   if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+
+   return -1;
+}
+
+template<typename CharGetter>
+bool parseHex(CharGetter charAt, int size, unsigned char *out)
+{
+   if (size != ObjectId::SHA1_SIZE * 2 && size != ObjectId::SHA256_SIZE * 2)
+      return false;
+
+   for (auto i = 0; i < size; i += 2)
+   {
+      const auto high = hexValue(charAt(i));
+      const auto low = hexValue(charAt(i + 1));
+
+      if (high == -1 || low == -1)
+         return false;
+
+      out[i / 2] = static_cast<unsigned char>((high << 4) | low);
+   }
+
+   return true;
+}
+}
+
+ObjectId ObjectId::fromHex(const QString &hex)
+{
+   ObjectId id;
+
+   if (parseHex([&hex](int i) { return hex.at(i).unicode(); }, hex.size(), id.mData.data()))
+      id.mSize = static_cast<unsigned char>(hex.size() / 2);
+
+   return id;
+}
+
+ObjectId ObjectId::fromHex(const char *hex, int size)
+{
+   ObjectId id;
+
+   if (parseHex([hex](int i) { return static_cast<ushort>(static_cast<unsigned char>(hex[i])); }, size,
+                id.mData.data()))
+      id.mSize = static_cast<unsigned char>(size / 2);
+
+   return id;
+}
+
+ObjectId ObjectId::fromBinary(const unsigned char *data, int size)
+{
+   ObjectId id;
+
+   if (size == SHA1_SIZE || size == SHA256_SIZE)
+   {
+      std::copy(data, data + size, id.mData.begin());
+      id.mSize = static_cast<unsigned char>(size);
+   }
+
+   return id;
+}
+
+QString ObjectId::toString() const
+{
+   static const char digits[] = "0123456789abcdef";
+
+   QString hex(mSize * 2, Qt::Uninitialized);
+   auto out = hex.data();
+
+   for (auto i = 0; i < mSize; ++i)
+   {
+      *out++ = QLatin1Char(digits[mData[i] >> 4]);
+      *out++ = QLatin1Char(digits[mData[i] & 0x0f]);
+   }
+
+   return hex;
+}
+
+bool ObjectId::startsWith(const QString &hexPrefix) const
+{
+   if (hexPrefix.size() > mSize * 2)
+      return false;
+
+   for (auto i = 0; i < hexPrefix.size(); ++i)
+   {
+      const auto nibble = i % 2 == 0 ? mData[i / 2] >> 4 : mData[i / 2] & 0x0f;
+
+      if (hexValue(hexPrefix.at(i).unicode()) != nibble)
+         return false;
+   }
+
+   return true;
+}
+
+int ObjectId::comparePrefix(const QString &hexPrefix) const
+{
+   const auto digits = std::min(hexPrefix.size(), mSize * 2);
+
+   for (auto i = 0; i < digits; ++i)
+   {
+      const auto nibble = i % 2 == 0 ? mData[i / 2] >> 4 : mData[i / 2] & 0x0f;
+      const auto value = hexValue(hexPrefix.at(i).unicode());
+
+      if (nibble != value)
+         return nibble < value ? -1 : 1;
+   }
+
+   // An id shorter than the prefix goes before it, like a shorter string does.
+   return digits < hexPrefix.size() ? -1 : 0;
+}
+
+bool ObjectId::operator==(const ObjectId &other) const
+{
+   return mSize == other.mSize && std::memcmp(mData.data(), other.mData.data(), mSize) == 0;
+}
+
+bool ObjectId::operator<(const ObjectId &other) const
+{
+   const auto result = std::memcmp(mData.data(), other.mData.data(), std::min(mSize, other.mSize));
+
+   return result < 0 || (result == 0 && mSize < other.mSize);
+}
+
+uint qHash(const ObjectId &id, uint seed)
+{
+   // The ids are already uniformly distributed so the first bytes are enough.
+   uint value = 0;
+   std::memcpy(&value, id.data(), sizeof(value));
+
+   return value ^ seed;
+}
+
+QDataStream &operator<<(QDataStream &out, const ObjectId &id)
+{
+   out << static_cast<quint8>(id.size());
+   out.writeRawData(reinterpret_cast<const char *>(id.data()), id.size());
+
+   return out;
+}
+
+QDataStream &operator>>(QDataStream &in, ObjectId &id)
+{
+   quint8 size = 0;
+   in >> size;
+
+   id = ObjectId();
+
+   if (size == ObjectId::SHA1_SIZE || size == ObjectId::SHA256_SIZE)
+   {
+      if (in.readRawData(reinterpret_cast<char *>(id.mData.data()), size) == size)
+         id.mSize = size;
+      else
+         in.setStatus(QDataStream::ReadPastEnd);
+   }
+   else if (size != 0)
+      in.setStatus(QDataStream::ReadCorruptData);
+
+   return in;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QHash>
+#include <QDataStream>
+
+#include <array>
+
+/*!
+ \brief The ObjectId class stores the binary value of a Git object id (SHA-1 or SHA-256). It is used instead of the
+ hexadecimal string in the cache and the lanes so every id takes a fixed amount of memory and it can be compared and
+ hashed cheaply. The conversion to the hexadecimal representation is only done when it is needed by the UI or by the
+ git commands.
+
+ \class ObjectId ObjectId.h "ObjectId.h"
+*/
+class ObjectId
+{
+public:
+   static constexpr int SHA1_SIZE = 20;
+   static constexpr int SHA256_SIZE = 32;
+
+   ObjectId() = default;
+
+   /*!
+    \brief Creates an ObjectId from its hexadecimal representation. If the text is not a complete SHA-1 or SHA-256 id,
+    the ObjectId is null.
+
+    \param hex The hexadecimal representation of the id.
+    \return The ObjectId.
+   */
+   static ObjectId fromHex(const QString &hex);
+   /*!
+    \brief Creates an ObjectId from its hexadecimal representation in Latin-1/UTF-8 characters. If the text is not a
+    complete SHA-1 or SHA-256 id, the ObjectId is null.
+
+    \param hex The characters of the hexadecimal representation.
+    \param size The number of characters.
+    \return The ObjectId.
+   */
+   static ObjectId fromHex(const char *hex, int size);
+   /*!
+    \brief Creates an ObjectId from its binary value, as it is stored in the files of git. If the size is not the one of
+    a SHA-1 or SHA-256 id, the ObjectId is null.
+
+    \param data The bytes of the id.
+    \param size The number of bytes.
+    \return The ObjectId.
+   */
+   static ObjectId fromBinary(const unsigned char *data, int size);
+
+   bool isNull() const { return mSize == 0; }
+   int size() const { return mSize; }
+   const unsigned char *data() const { return mData.data(); }
+
+   /*!
+    \brief Returns the hexadecimal representation of the id. An empty string is returned if the id is null.
+   */
+   QString toString() const;
+   /*!
+    \brief Checks if the hexadecimal representation of the id starts with the given text without converting the id.
+
+    \param hexPrefix The beginning of the hexadecimal representation.
+    \return True if the id starts with the prefix, otherwise false.
+   */
+   bool startsWith(const QString &hexPrefix) const;
+   /*!
+    \brief Compares the beginning of the hexadecimal representation of the id with the given prefix, in the same order
+    used by the less-than operator. It allows to binary search a prefix in a sorted list of ids.
+
+    \param hexPrefix The beginning of the hexadecimal representation. It must contain only hexadecimal digits.
+    \return A negative value if the id goes before the prefix, 0 if the id starts with it or a positive value if the id
+    goes after the prefix.
+   */
+   int comparePrefix(const QString &hexPrefix) const;
+
+   bool operator==(const ObjectId &other) const;
+   bool operator!=(const ObjectId &other) const { return !(*this == other); }
+   bool operator<(const ObjectId &other) const;
+
+private:
+   std::array<unsigned char, SHA256_SIZE> mData {};
+   unsigned char mSize = 0;
+
+   friend QDataStream &operator>>(QDataStream &in, ObjectId &id);
+};
+
+uint qHash(const ObjectId &id, uint seed = 0);
+QDataStream &operator<<(QDataStream &out, const ObjectId &id);
+QDataStream &operator>>(QDataStream &in, ObjectId &id);
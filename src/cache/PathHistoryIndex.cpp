@@ -0,0 +1,239 @@
+#include "PathHistoryIndex.h"
+
+#include <RevisionsCache.h>
+
+#include <QLogger.h>
+
+
+#include <algorithm>
+#include <limits>
+
+using namespace QLogger;
+
+namespace
+{
+// A rename chain longer than this is most likely a loop.
+const int MAX_RENAMES_DEPTH = 64;
+}
+
+PathHistoryIndex::PathHistoryIndex(const QSharedPointer<RevisionsCache> &cache, QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+   , mWorker(new WorkerQueue(mCache.data(), WorkerPool::Priority::Background))
+{
+}
+
+PathHistoryIndex::~PathHistoryIndex()
+{
+   mRequest.fetchAndAddOrdered(1);
+
+   mWorker.reset();
+}
+
+int PathHistoryIndex::start()
+{
+   const auto request = mRequest.fetchAndAddOrdered(1) + 1;
+   const auto generation = mCache->generation();
+
+   mData.reset();
+
+   mWorker->post([this, generation]() {
+      mPendingData = QSharedPointer<Data>::create();
+      mPendingData->generation = generation;
+      mPendingLine.clear();
+   });
+
+   return request;
+}
+
+void PathHistoryIndex::processData(int request, const QByteArray &data)
+{
+   mWorker->post([this, request, data]() {
+      if (request != mRequest.loadAcquire() || !mPendingData)
+         return;
+
+      auto begin = 0;
+
+      for (auto end = data.indexOf('\n'); end != -1; end = data.indexOf('\n', begin))
+      {
+         if (mPendingLine.isEmpty())
+            parseLine(data.mid(begin, end - begin));
+         else
+         {
+            mPendingLine.append(data.constData() + begin, end - begin);
+            parseLine(mPendingLine);
+            mPendingLine.clear();
+         }
+
+         begin = end + 1;
+      }
+
+      mPendingLine.append(data.constData() + begin, data.size() - begin);
+   });
+}
+
+void PathHistoryIndex::finish(int request)
+{
+   mWorker->post([this, request]() {
+      if (request != mRequest.loadAcquire() || !mPendingData)
+         return;
+
+      if (!mPendingLine.isEmpty())
+         parseLine(mPendingLine);
+
+      QSharedPointer<const Data> data = mPendingData;
+
+      mPendingData.reset();
+      mPendingLine.clear();
+
+      QLog_Debug("Git",
+                 QString("Path history index built with {%1} paths in {%2} commits.")
+                     .arg(QString::number(data->paths.count()), QString::number(data->commits.count())));
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, request, data]() {
+             if (request == mRequest.loadAcquire())
+             {
+                mData = data;
+                emit signalReady();
+             }
+          },
+          Qt::QueuedConnection);
+   });
+}
+
+bool PathHistoryIndex::isReady() const
+{
+   return mData && mData->generation == mCache->generation();
+}
+
+QStringList PathHistoryIndex::history(const QString &path) const
+{
+   if (!isReady())
+      return {};
+
+   QVector<int> commits;
+   collect(path, 0, 0, commits);
+
+   std::sort(commits.begin(), commits.end());
+   commits.erase(std::unique(commits.begin(), commits.end()), commits.end());
+
+   QStringList shas;
+   shas.reserve(commits.count());
+
+   for (const auto commit : qAsConst(commits))
+      shas.append(mData->commits.at(commit).toString());
+
+   return shas;
+}
+
+void PathHistoryIndex::annotateDirectory(const QString &directory)
+{
+   if (!isReady())
+      return;
+
+   mWorker->post([this, directory, data = mData]() {
+      const auto commits = lastCommits(*data, directory);
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, directory, data, commits]() {
+             // A new build might have been published meanwhile: its commits are not the same.
+             if (data == mData)
+                emit signalDirectoryAnnotated(directory, commits);
+          },
+          Qt::QueuedConnection);
+   });
+}
+
+QHash<QString, QString> PathHistoryIndex::lastCommits(const Data &data, const QString &directory)
+{
+   const auto prefix = directory.isEmpty() ? QString() : directory + '/';
+   QHash<QString, int> newest;
+
+   // The commits of every path are stored from the newest to the oldest, so the first one is the last that touched it.
+   // An entry is touched by the commits of all the paths under it.
+   for (auto iter = data.paths.cbegin(); iter != data.paths.cend(); ++iter)
+   {
+      if (iter.value().isEmpty() || !iter.key().startsWith(prefix))
+         continue;
+
+      const auto end = iter.key().indexOf('/', prefix.length());
+      const auto entry = iter.key().mid(prefix.length(), end == -1 ? -1 : end - prefix.length());
+      const auto commit = iter.value().constFirst();
+
+      if (const auto entryIter = newest.find(entry); entryIter == newest.end())
+         newest.insert(entry, commit);
+      else if (commit < entryIter.value())
+         entryIter.value() = commit;
+   }
+
+   QHash<QString, QString> shas;
+   shas.reserve(newest.count());
+
+   for (auto iter = newest.cbegin(); iter != newest.cend(); ++iter)
+      shas.insert(iter.key(), data.commits.at(iter.value()).toString());
+
+   return shas;
+}
+
+void PathHistoryIndex::parseLine(const QByteArray &line)
+{
+   if (line.isEmpty())
+      return;
+
+   const auto fields = line.split('\t');
+
+   if (fields.count() == 1)
+   {
+      if (const auto id = ObjectId::fromHex(line.constData(), line.size()); !id.isNull())
+         mPendingData->commits.append(id);
+
+      return;
+   }
+
+   if (mPendingData->commits.isEmpty())
+      return;
+
+   const auto commit = mPendingData->commits.count() - 1;
+
+   // Renames and copies ("R100\told\tnew") are stored under the new path, as git log --follow does.
+   if (fields.count() == 3 && (fields.constFirst().startsWith('R') || fields.constFirst().startsWith('C')))
+   {
+      const auto newPath = QString::fromUtf8(fields.at(2));
+
+      mPendingData->paths[newPath].append(commit);
+
+      if (fields.constFirst().startsWith('R'))
+         mPendingData->renames[newPath].append({ commit, QString::fromUtf8(fields.at(1)) });
+   }
+   else
+      mPendingData->paths[QString::fromUtf8(fields.at(1))].append(commit);
+}
+
+void PathHistoryIndex::collect(const QString &path, int from, int depth, QVector<int> &commits) const
+{
+   // The commits are stored from the newest to the oldest, so the first rename from the starting point is the one
+   // that created this path: the older history continues with the previous name.
+   auto to = std::numeric_limits<int>::max();
+   QString previousPath;
+
+   for (const auto &rename : mData->renames.value(path))
+   {
+      if (rename.first >= from && rename.first < to)
+      {
+         to = rename.first;
+         previousPath = rename.second;
+      }
+   }
+
+   for (const auto commit : mData->paths.value(path))
+   {
+      if (commit >= from && commit <= to)
+         commits.append(commit);
+   }
+
+   if (!previousPath.isEmpty() && depth < MAX_RENAMES_DEPTH)
+      collect(previousPath, to + 1, depth + 1, commits);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+#include <WorkerPool.h>
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QAtomicInt>
+
+class RevisionsCache;
+
+/*!
+ \brief The PathHistoryIndex keeps, for every path of the repository, the commits that changed it. It is built in a
+ worker thread from the output of a single git log that lists the files of every commit (see
+ GitHistory::loadPathHistoryIndex), so the history of a file is a lookup instead of a git log per file.
+
+ The renames are followed the same way git log --follow does. The index is tied to the generation of the cache it was
+ requested for: when the cache publishes a new generation, the index is not ready until it's built again.
+
+ \class PathHistoryIndex PathHistoryIndex.h "PathHistoryIndex.h"
+*/
+class PathHistoryIndex : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when a build of the index is published and the index can answer.
+   */
+   void signalReady();
+   /*!
+    \brief Signal triggered when the last commits of the entries of a directory are known (see \ref annotateDirectory).
+
+    \param directory The directory relative to the root of the repository, empty for the root.
+    \param lastCommits The SHA of the last commit that touched each entry, by entry name. The entries not in the
+    history are not listed.
+   */
+   void signalDirectoryAnnotated(const QString &directory, const QHash<QString, QString> &lastCommits);
+
+public:
+   explicit PathHistoryIndex(const QSharedPointer<RevisionsCache> &cache, QObject *parent = nullptr);
+   ~PathHistoryIndex();
+
+   /*!
+    \brief Starts a new build of the index. The build in progress, if any, is discarded.
+
+    \return The id of the build, to pass to \ref processData and \ref finish.
+   */
+   int start();
+   /*!
+    \brief Parses a chunk of the output of git. The chunks can be split anywhere.
+
+    \param request The id of the build.
+    \param data The chunk.
+   */
+   void processData(int request, const QByteArray &data);
+   /*!
+    \brief Ends the build. The index is ready once it has been published from the worker thread.
+
+    \param request The id of the build.
+   */
+   void finish(int request);
+   /*!
+    \brief Tells if the index can answer for the current generation of the cache.
+   */
+   bool isReady() const;
+   /*!
+    \brief Returns the SHAs of the commits that changed the file, from the newest to the oldest.
+
+    \param path The path of the file relative to the root of the repository.
+    \return The SHAs. The list is empty if the index is not ready or the path is unknown.
+   */
+   QStringList history(const QString &path) const;
+   /*!
+    \brief Finds in the worker thread the last commit that touched each entry of a directory, in one pass over the
+    index instead of a git log per entry. The result is notified with \ref signalDirectoryAnnotated. Nothing is
+    notified if the index is not ready.
+
+    \param directory The directory relative to the root of the repository, empty for the root.
+   */
+   void annotateDirectory(const QString &directory);
+
+private:
+   struct Data
+   {
+      int generation = -1;
+      QVector<ObjectId> commits;
+      QHash<QString, QVector<int>> paths;
+      QHash<QString, QVector<QPair<int, QString>>> renames;
+   };
+
+   QSharedPointer<RevisionsCache> mCache;
+   QScopedPointer<WorkerQueue> mWorker;
+   QAtomicInt mRequest = 0;
+   QSharedPointer<const Data> mData;
+
+   // Only used from the tasks of the worker queue.
+   QSharedPointer<Data> mPendingData;
+   QByteArray mPendingLine;
+
+   void parseLine(const QByteArray &line);
+   void collect(const QString &path, int from, int depth, QVector<int> &commits) const;
+   static QHash<QString, QString> lastCommits(const Data &data, const QString &directory);
+};
@@ -0,0 +1,64 @@
+#include "PathTable.h"
+
+#include <MemoryReport.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QWeakPointer>
+
+#include <iterator>
+
+QSharedPointer<PathTable> PathTable::forRepositoryGroup(const QString &group)
+{
+   static QMutex mutex;
+   static QHash<QString, QWeakPointer<PathTable>> tables;
+
+   QMutexLocker locker(&mutex);
+
+   auto table = tables.value(group).toStrongRef();
+
+   if (!table)
+   {
+      // The groups that are not used anymore are removed when a new one is created.
+      for (auto iter = tables.begin(); iter != tables.end();)
+         iter = iter.value() ? std::next(iter) : tables.erase(iter);
+
+      table.reset(new PathTable());
+      tables.insert(group, table);
+   }
+
+   return table;
+}
+
+QString PathTable::intern(const QString &path)
+{
+   {
+      QReadLocker locker(&mLock);
+
+      if (const auto iter = mPaths.constFind(path); iter != mPaths.constEnd())
+         return *iter;
+   }
+
+   QWriteLocker locker(&mLock);
+
+   return *mPaths.insert(path);
+}
+
+int PathTable::count() const
+{
+   QReadLocker locker(&mLock);
+
+   return mPaths.count();
+}
+
+qint64 PathTable::memoryUsage() const
+{
+   QReadLocker locker(&mLock);
+
+   auto bytes = MemoryReport::bytes(mPaths);
+
+   for (const auto &path : mPaths)
+      bytes += MemoryReport::bytes(path);
+
+   return bytes;
+}
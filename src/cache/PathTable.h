@@ -0,0 +1,71 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QReadWriteLock>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+
+/*!
+ \brief The PathTable stores once every path of the files of a group of repositories: a superproject and its
+ submodules. The same paths appear in many commits and in every repository of the group that tracks them, so they all
+ share the data of a single copy.
+
+ The table is shared by the caches of the repositories of the group and it's destroyed with the last of them. It can
+ be filled from any thread.
+
+ \class PathTable PathTable.h "PathTable.h"
+*/
+class PathTable
+{
+public:
+   /*!
+    \brief Returns the table of a group of repositories. It's created when the first repository asks for it.
+
+    \param group The group of the repositories, see GitBase::getRepositoryGroup.
+    \return The table.
+   */
+   static QSharedPointer<PathTable> forRepositoryGroup(const QString &group);
+
+   /*!
+    \brief Returns the shared copy of a path. The path is added to the table if it wasn't there yet.
+
+    \param path The path.
+    \return The shared copy.
+   */
+   QString intern(const QString &path);
+   /*!
+    \brief Returns the number of paths of the table.
+   */
+   int count() const;
+   /*!
+    \brief Returns the memory used by the table and its paths, in bytes.
+   */
+   qint64 memoryUsage() const;
+
+private:
+   mutable QReadWriteLock mLock;
+   QSet<QString> mPaths;
+};
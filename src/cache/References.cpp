@@ -1,11 +1,92 @@
 #include "References.h"
 
+#include <MemoryReport.h>
+
+#include <QHash>
+#include <QReadWriteLock>
+
+#include <algorithm>
+#include <deque>
+
+namespace
+{
+// The references are loaded in the UI thread but the snapshots of the references index can be read from the workers.
+struct ReferenceNames
+{
+   QReadWriteLock lock;
+   std::deque<QString> names;
+   QHash<QString, int> ids;
+};
+
+ReferenceNames &referenceNames()
+{
+   static ReferenceNames table;
+   return table;
+}
+}
+
+int References::intern(const QString &name)
+{
+   auto &table = referenceNames();
+
+   {
+      QReadLocker locker(&table.lock);
+
+      if (const auto it = table.ids.constFind(name); it != table.ids.constEnd())
+         return it.value();
+   }
+
+   QWriteLocker locker(&table.lock);
+
+   if (const auto it = table.ids.constFind(name); it != table.ids.constEnd())
+      return it.value();
+
+   const auto id = static_cast<int>(table.names.size());
+   table.names.push_back(name);
+   table.ids.insert(name, id);
+
+   return id;
+}
+
+const QString &References::name(int nameId)
+{
+   auto &table = referenceNames();
+   QReadLocker locker(&table.lock);
+
+   // The deque never moves its elements, so the reference remains valid when new names are added.
+   return table.names.at(static_cast<size_t>(nameId));
+}
+
 void References::addReference(Type type, const QString &value)
 {
-   mReferences[type].append(value);
+   mReferences.append({ type, intern(value) });
+}
+
+void References::removeReference(Type type, const QString &value)
+{
+   const auto nameId = intern(value);
+
+   mReferences.erase(std::remove_if(mReferences.begin(), mReferences.end(),
+                                    [type, nameId](const Reference &reference) {
+                                       return reference.type == type && reference.nameId == nameId;
+                                    }),
+                     mReferences.end());
 }
 
 QStringList References::getReferences(Type type) const
 {
-   return mReferences.value(type, QStringList());
+   QStringList references;
+
+   for (const auto &reference : mReferences)
+   {
+      if (reference.type == type)
+         references.append(name(reference.nameId));
+   }
+
+   return references;
+}
+
+qint64 References::memoryUsage() const
+{
+   return MemoryReport::bytes(mReferences);
 }
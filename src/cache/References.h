@@ -1,8 +1,14 @@
 #pragma once
 
-#include <QMap>
 #include <QStringList>
+#include <QVector>
 
+/*!
+ \brief The References class stores the references of a commit. The names are interned once for all the commits of the
+ loaded repositories, so every reference only takes its type and the id of its name.
+
+ \class References References.h "References.h"
+*/
 class References
 {
 public:
@@ -17,11 +23,25 @@ public:
    };
 
    void addReference(Type type, const QString &value);
+   void removeReference(Type type, const QString &value);
 
    QStringList getReferences(Type type) const;
 
    bool isEmpty() const { return mReferences.isEmpty(); }
+   /*!
+    \brief Returns the heap memory used by the references, in bytes. The interned names are not included.
+   */
+   qint64 memoryUsage() const;
 
 private:
-   QMap<Type, QStringList> mReferences;
+   struct Reference
+   {
+      Type type;
+      int nameId;
+   };
+
+   QVector<Reference> mReferences;
+
+   static int intern(const QString &name);
+   static const QString &name(int nameId);
 };
@@ -0,0 +1,202 @@
+#include "RepositoriesSearch.h"
+
+#include <CommitInfo.h>
+
+#include <QSet>
+
+#include <algorithm>
+
+namespace
+{
+bool isHex(const QString &text)
+{
+   return std::all_of(text.cbegin(), text.cend(), [](QChar c) {
+      return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+   });
+}
+
+bool isMoreRelevant(const RepositoriesSearch::Match &left, const RepositoriesSearch::Match &right)
+{
+   if (left.type != right.type)
+      return left.type < right.type;
+
+   if (left.prefix != right.prefix)
+      return left.prefix;
+
+   return left.secsSinceEpoch > right.secsSinceEpoch;
+}
+}
+
+RepositoriesSearch::RepositoriesSearch(QObject *parent)
+   : QObject(parent)
+{
+}
+
+RepositoriesSearch::~RepositoriesSearch()
+{
+   cancel();
+
+   // The searches that didn't start are discarded.
+   mQueues.clear();
+}
+
+void RepositoriesSearch::search(const QVector<Source> &sources, const QString &text)
+{
+   cancel();
+
+   const auto search = ++mSearch;
+   const auto cancelled = QSharedPointer<QAtomicInt>::create(0);
+   const auto trimmed = text.trimmed();
+
+   mCancelled = cancelled;
+   mMatches.clear();
+   mPendingSources = trimmed.isEmpty() ? 0 : sources.count();
+
+   if (mPendingSources == 0)
+   {
+      emit signalMatchesFound(mMatches, true);
+      return;
+   }
+
+   // Every repository has its own queue, so they are searched at the same time within the quotas of the pool.
+   QHash<const void *, QSharedPointer<WorkerQueue>> queues;
+
+   for (const auto &source : sources)
+   {
+      auto queue = mQueues.value(source.cache);
+
+      if (!queue)
+         queue = QSharedPointer<WorkerQueue>::create(source.cache, WorkerPool::Priority::Interactive);
+
+      queues.insert(source.cache, queue);
+
+      queue->post([this, search, source, trimmed, cancelled]() {
+         const auto matches = searchSource(source, trimmed, *cancelled);
+
+         if (cancelled->loadAcquire())
+            return;
+
+         QMetaObject::invokeMethod(
+             this, [this, search, matches]() { onSourceSearched(search, matches); }, Qt::QueuedConnection);
+      });
+   }
+
+   mQueues = queues;
+}
+
+void RepositoriesSearch::cancel()
+{
+   if (mCancelled)
+      mCancelled->storeRelease(1);
+
+   mCancelled.reset();
+   mPendingSources = 0;
+}
+
+QVector<RepositoriesSearch::Match> RepositoriesSearch::searchSource(const Source &source, const QString &text,
+                                                                   const QAtomicInt &cancelled)
+{
+   const auto makeMatch = [&source](const QString &sha, MatchType type, const QString &matchText, bool prefix) {
+      Match match;
+      match.repository = source.repository;
+      match.sha = sha;
+      match.type = type;
+      match.text = matchText;
+      match.prefix = prefix;
+
+      return match;
+   };
+
+   // The references don't know the date of their commit: it's taken when the commit is found in the history.
+   QVector<Match> references;
+   QHash<ObjectId, QVector<int>> undatedReferences;
+
+   for (const auto &reference : source.references)
+   {
+      for (const auto &name : reference.second)
+      {
+         if (references.count() < MAX_MATCHES_PER_REPOSITORY && name.contains(text, Qt::CaseInsensitive))
+         {
+            undatedReferences[ObjectId::fromHex(reference.first)].append(references.count());
+            references.append(
+                makeMatch(reference.first, MatchType::Reference, name, name.startsWith(text, Qt::CaseInsensitive)));
+         }
+      }
+   }
+
+   const auto shaPrefix = text.size() >= MIN_SHA_PREFIX && isHex(text) ? text.toLower() : QString();
+   QVector<Match> shas;
+   QVector<Match> shortLogs;
+
+   for (auto row = 1; row < source.snapshot.count(); ++row)
+   {
+      if (row % 1024 == 0 && cancelled.loadAcquire())
+         return {};
+
+      const auto commit = source.snapshot.commit(row);
+
+      if (!commit)
+         continue;
+
+      if (const auto iter = undatedReferences.find(commit->id()); iter != undatedReferences.end())
+      {
+         for (const auto index : qAsConst(iter.value()))
+            references[index].secsSinceEpoch = commit->secsSinceEpoch();
+
+         undatedReferences.erase(iter);
+      }
+
+      if (!shaPrefix.isEmpty() && shas.count() < MAX_MATCHES_PER_REPOSITORY && commit->id().startsWith(shaPrefix))
+      {
+         shas.append(makeMatch(commit->sha(), MatchType::Sha, QString(), true));
+         shas.last().secsSinceEpoch = commit->secsSinceEpoch();
+      }
+      else if (shortLogs.count() < MAX_MATCHES_PER_REPOSITORY && commit->shortLog().contains(text, Qt::CaseInsensitive))
+      {
+         const auto shortLog = commit->shortLog();
+
+         shortLogs.append(
+             makeMatch(commit->sha(), MatchType::ShortLog, shortLog, shortLog.startsWith(text, Qt::CaseInsensitive)));
+         shortLogs.last().secsSinceEpoch = commit->secsSinceEpoch();
+      }
+
+      // The history is in date order, so the first matches found are the newest ones.
+      if (undatedReferences.isEmpty() && shortLogs.count() == MAX_MATCHES_PER_REPOSITORY
+          && (shaPrefix.isEmpty() || shas.count() == MAX_MATCHES_PER_REPOSITORY))
+         break;
+   }
+
+   // A commit is only listed once, for its most relevant match.
+   QVector<Match> matches;
+   QSet<QString> listed;
+
+   for (const auto &group : { shas, references, shortLogs })
+   {
+      for (const auto &match : group)
+      {
+         if (matches.count() < MAX_MATCHES_PER_REPOSITORY && !listed.contains(match.sha))
+         {
+            listed.insert(match.sha);
+            matches.append(match);
+         }
+      }
+   }
+
+   return matches;
+}
+
+void RepositoriesSearch::onSourceSearched(int search, const QVector<Match> &matches)
+{
+   if (search != mSearch || mPendingSources == 0)
+      return;
+
+   --mPendingSources;
+
+   mMatches.append(matches);
+   std::stable_sort(mMatches.begin(), mMatches.end(), isMoreRelevant);
+
+   emit signalMatchesFound(mMatches, mPendingSources == 0);
+
+   if (mPendingSources == 0)
+      mCancelled.reset();
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RevisionsSnapshot.h>
+#include <WorkerPool.h>
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ \brief The RepositoriesSearch looks for a text in the history of several repositories at once: the SHAs that start
+ with it, the references whose names contain it and the short logs that contain it. Every repository is scanned by the
+ WorkerPool in its own queue, so the repositories are searched in parallel, and the matches are merged and ranked in
+ the GUI thread as the repositories finish.
+
+ Starting a new search cancels the previous one.
+
+ \class RepositoriesSearch RepositoriesSearch.h "RepositoriesSearch.h"
+*/
+class RepositoriesSearch : public QObject
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief What a match was found in, from the most to the least relevant.
+   */
+   enum class MatchType
+   {
+      Sha,
+      Reference,
+      ShortLog
+   };
+
+   /*!
+    \brief A commit that matches the text.
+   */
+   struct Match
+   {
+      QString repository;
+      QString sha;
+      MatchType type = MatchType::ShortLog;
+      /*!
+       \brief The text that matches: the reference or the short log. Empty for a SHA.
+      */
+      QString text;
+      long long secsSinceEpoch = 0;
+      /*!
+       \brief True if the reference or the short log is the text itself or starts with it.
+      */
+      bool prefix = false;
+   };
+
+   /*!
+    \brief A repository to search in. Its data is read from the worker threads, so it's taken in the GUI thread before
+    the search starts.
+   */
+   struct Source
+   {
+      /*!
+       \brief The repository, as it's given back in the matches.
+      */
+      QString repository;
+      /*!
+       \brief The identity of the repository in the WorkerPool: its RevisionsCache.
+      */
+      const void *cache = nullptr;
+      RevisionsSnapshot snapshot;
+      /*!
+       \brief The names of the branches and tags and the SHA they point to.
+      */
+      QVector<QPair<QString, QStringList>> references;
+   };
+
+signals:
+   /*!
+    \brief Signal triggered every time a repository has been searched.
+
+    \param matches All the matches found so far, the most relevant first.
+    \param finished True when all the repositories have been searched.
+   */
+   void signalMatchesFound(const QVector<RepositoriesSearch::Match> &matches, bool finished);
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent object if needed.
+   */
+   explicit RepositoriesSearch(QObject *parent = nullptr);
+   ~RepositoriesSearch();
+
+   /*!
+    \brief Starts a search. The text is compared without case.
+
+    \param sources The repositories to search in.
+    \param text The text to search.
+   */
+   void search(const QVector<Source> &sources, const QString &text);
+   /*!
+    \brief Cancels the search in progress, if any.
+   */
+   void cancel();
+
+   /*!
+    \brief The maximum number of matches of a repository. The search of the repository stops when it has them.
+   */
+   static constexpr int MAX_MATCHES_PER_REPOSITORY = 100;
+   /*!
+    \brief The minimum length of a text to be compared with the SHAs, so a short word doesn't match a lot of them.
+   */
+   static constexpr int MIN_SHA_PREFIX = 4;
+
+private:
+   QHash<const void *, QSharedPointer<WorkerQueue>> mQueues;
+   QSharedPointer<QAtomicInt> mCancelled;
+   int mSearch = 0;
+   int mPendingSources = 0;
+   QVector<Match> mMatches;
+
+   static QVector<Match> searchSource(const Source &source, const QString &text, const QAtomicInt &cancelled);
+   void onSourceSearched(int search, const QVector<Match> &matches);
+};
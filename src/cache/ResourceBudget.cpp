@@ -0,0 +1,164 @@
+#include "ResourceBudget.h"
+
+#include <WorkerPool.h>
+
+#include <QLogger.h>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+ResourceBudget &ResourceBudget::instance()
+{
+   static ResourceBudget budget;
+
+   return budget;
+}
+
+int ResourceBudget::addCache(const QString &name, qint64 budget, const UsageFunction &usage,
+                             const LimitFunction &setLimit)
+{
+   int id = 0;
+
+   {
+      QMutexLocker locker(&mMutex);
+
+      id = ++mLastCache;
+      mCaches.insert(id, { name, budget, 0, usage, setLimit });
+   }
+
+   rebalance();
+
+   return id;
+}
+
+void ResourceBudget::setCacheBudget(int id, qint64 budget)
+{
+   {
+      QMutexLocker locker(&mMutex);
+
+      const auto cache = mCaches.find(id);
+
+      if (cache == mCaches.end() || cache->budget == budget)
+         return;
+
+      cache->budget = budget;
+   }
+
+   rebalance();
+}
+
+void ResourceBudget::removeCache(int id)
+{
+   QMutexLocker applyLocker(&mApplyMutex);
+
+   {
+      QMutexLocker locker(&mMutex);
+
+      if (!mCaches.remove(id))
+         return;
+   }
+
+   applyLocker.unlock();
+
+   // The memory of the cache removed goes to the rest.
+   rebalance();
+}
+
+QVector<ResourceBudget::CacheUsage> ResourceBudget::caches() const
+{
+   QVector<Cache> caches;
+
+   {
+      QMutexLocker locker(&mMutex);
+      caches = mCaches.values().toVector();
+   }
+
+   QVector<CacheUsage> usages;
+   usages.reserve(caches.count());
+
+   for (const auto &cache : qAsConst(caches))
+      usages.append({ cache.name, cache.budget, cache.limit, cache.usage() });
+
+   return usages;
+}
+
+void ResourceBudget::setMemoryBudget(int megabytes)
+{
+   {
+      QMutexLocker locker(&mMutex);
+
+      const auto budget = std::max(megabytes, 0) * qint64(1024 * 1024);
+
+      if (budget == mMemoryBudget)
+         return;
+
+      mMemoryBudget = budget;
+   }
+
+   QLog_Info("UI", QString("Setting the memory budget to {%1} MB.").arg(megabytes));
+
+   rebalance();
+}
+
+int ResourceBudget::memoryBudget() const
+{
+   QMutexLocker locker(&mMutex);
+
+   return static_cast<int>(mMemoryBudget / (1024 * 1024));
+}
+
+void ResourceBudget::setMaxConcurrency(int tasks)
+{
+   {
+      QMutexLocker locker(&mMutex);
+
+      mMaxConcurrency = std::max(tasks, 0);
+   }
+
+   QLog_Info("UI", QString("Setting the maximum of concurrent tasks to {%1}.").arg(tasks));
+
+   WorkerPool::instance().setMaxConcurrency(tasks);
+}
+
+int ResourceBudget::maxConcurrency() const
+{
+   QMutexLocker locker(&mMutex);
+
+   return mMaxConcurrency;
+}
+
+void ResourceBudget::rebalance()
+{
+   QMutexLocker applyLocker(&mApplyMutex);
+   QVector<QPair<LimitFunction, qint64>> changes;
+
+   {
+      QMutexLocker locker(&mMutex);
+
+      qint64 total = 0;
+
+      for (const auto &cache : qAsConst(mCaches))
+         total += cache.budget;
+
+      for (auto &cache : mCaches)
+      {
+         auto limit = cache.budget;
+
+         // The shares are calculated in double: the product of two budgets in bytes doesn't fit in 64 bits.
+         if (mMemoryBudget > 0 && total > mMemoryBudget)
+            limit = std::max(MIN_CACHE_LIMIT,
+                             static_cast<qint64>(static_cast<double>(cache.budget) * mMemoryBudget / total));
+
+         if (limit != cache.limit)
+         {
+            cache.limit = limit;
+            changes.append({ cache.setLimit, limit });
+         }
+      }
+   }
+
+   // The caches take their own locks: the budget doesn't hold its own meanwhile.
+   for (const auto &change : qAsConst(changes))
+      change.first(change.second);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/*!
+ \brief The ResourceBudget is the global limit of the memory and the CPU GitQlient takes, for the machines it shares
+ with other work.
+
+ Every cache with a memory budget of its own registers here: the files of the commits of every repository, the diffs,
+ the blames, the tiles of the graph and the thumbnails of the images. While the sum of their budgets fits in the
+ global one, every cache uses its own. When it doesn't, every cache gets a part of the global budget proportional to
+ its own, and it drops its least recently used entries to fit in it.
+
+ The CPU budget is the number of tasks of the WorkerPool running at the same time. The tasks beyond it wait, and the
+ threads that become free take the work with the highest priority first, so the background tasks are the ones that
+ pause.
+
+ The limits are given to the caches in the thread that changes the budgets, outside of any lock of the budget. The
+ caches that are only used from the GUI thread take them with a queued call.
+
+ \class ResourceBudget ResourceBudget.h "ResourceBudget.h"
+*/
+class ResourceBudget
+{
+public:
+   /*!
+    \brief Returns the bytes a cache uses. It's called from the GUI thread.
+   */
+   using UsageFunction = std::function<qint64()>;
+   /*!
+    \brief Sets the bytes a cache can use.
+   */
+   using LimitFunction = std::function<void(qint64 bytes)>;
+
+   /*!
+    \brief The memory of a cache.
+   */
+   struct CacheUsage
+   {
+      QString name;
+      qint64 budget = 0; ///< The budget of the cache itself.
+      qint64 limit = 0; ///< The part of the global budget it gets.
+      qint64 usage = 0;
+   };
+
+   /*!
+    \brief The minimum limit of a cache, so the global budget never disables one completely.
+   */
+   static constexpr qint64 MIN_CACHE_LIMIT = 1024 * 1024;
+
+   /*!
+    \brief Returns the budget of the application.
+   */
+   static ResourceBudget &instance();
+
+   /*!
+    \brief Registers a cache. Its limit is set before it returns.
+
+    \param name The name of the cache, for the performance page.
+    \param budget The bytes the cache would use without a global budget.
+    \param usage The function that returns the bytes the cache uses.
+    \param setLimit The function that sets the bytes the cache can use.
+    \return The id of the cache.
+   */
+   int addCache(const QString &name, qint64 budget, const UsageFunction &usage, const LimitFunction &setLimit);
+   /*!
+    \brief Changes the budget of a cache itself. The limits of all the caches are calculated again.
+
+    \param id The id of the cache.
+    \param budget The bytes the cache would use without a global budget.
+   */
+   void setCacheBudget(int id, qint64 budget);
+   /*!
+    \brief Unregisters a cache. If its limit is being set, it waits until it ends, so the cache can be destroyed once
+    it returns.
+
+    \param id The id of the cache.
+   */
+   void removeCache(int id);
+   /*!
+    \brief Returns the memory of the caches. It's read from the GUI thread.
+   */
+   QVector<CacheUsage> caches() const;
+
+   /*!
+    \brief Sets the global memory budget.
+
+    \param megabytes The budget in MB. 0 doesn't limit the caches beyond their own budgets.
+   */
+   void setMemoryBudget(int megabytes);
+   /*!
+    \brief Returns the global memory budget in MB, 0 if there is none.
+   */
+   int memoryBudget() const;
+   /*!
+    \brief Sets the number of tasks of the WorkerPool that run at the same time.
+
+    \param tasks The number of tasks. 0 runs as many as threads the pool has.
+   */
+   void setMaxConcurrency(int tasks);
+   /*!
+    \brief Returns the number of tasks that run at the same time, 0 if it's the number of threads.
+   */
+   int maxConcurrency() const;
+
+private:
+   struct Cache
+   {
+      QString name;
+      qint64 budget = 0;
+      qint64 limit = 0;
+      UsageFunction usage;
+      LimitFunction setLimit;
+   };
+
+   mutable QMutex mMutex;
+   // Held while the limits are given to the caches, so a cache isn't removed meanwhile.
+   QMutex mApplyMutex;
+   QMap<int, Cache> mCaches;
+   int mLastCache = 0;
+   qint64 mMemoryBudget = 0;
+   int mMaxConcurrency = 0;
+
+   ResourceBudget() = default;
+
+   /*!
+    \brief Calculates the limits of the caches again and gives the new ones to their caches.
+   */
+   void rebalance();
+
+   Q_DISABLE_COPY(ResourceBudget)
+};
@@ -1,9 +1,12 @@
 #include "RevisionFiles.h"
 
+#include <MemoryReport.h>
+
 bool RevisionFiles::operator==(const RevisionFiles &revFiles) const
 {
    return mFiles == revFiles.mFiles && mOnlyModified == revFiles.mOnlyModified && mergeParent == revFiles.mergeParent
-       && mFileStatus == revFiles.mFileStatus && mRenamedFiles == revFiles.mRenamedFiles;
+       && mFileStatus == revFiles.mFileStatus && mRenamedFiles == revFiles.mRenamedFiles
+       && mLineStats == revFiles.mLineStats;
 }
 
 bool RevisionFiles::operator!=(const RevisionFiles &revFiles) const
@@ -11,6 +14,49 @@ bool RevisionFiles::operator!=(const RevisionFiles &revFiles) const
    return !(*this == revFiles);
 }
 
+bool RevisionFiles::isInPaths(const QString &file, const QSet<QString> &paths)
+{
+   // The file and the directories that contain it are looked up, so the cost doesn't grow with the number of paths.
+   auto path = file;
+
+   while (!path.isEmpty())
+   {
+      if (paths.contains(path))
+         return true;
+
+      path.truncate(qMax(path.lastIndexOf('/'), 0));
+   }
+
+   return false;
+}
+
+int RevisionFiles::memoryUsage() const
+{
+   // An approximation: the characters of the strings plus the fixed size of every element of the vectors.
+   auto bytes = static_cast<int>(sizeof(RevisionFiles));
+
+   for (const auto &file : mFiles)
+      bytes += file.size() * static_cast<int>(sizeof(QChar)) + static_cast<int>(sizeof(QString));
+
+   for (const auto &file : mRenamedFiles)
+      bytes += file.size() * static_cast<int>(sizeof(QChar)) + static_cast<int>(sizeof(QString));
+
+   return bytes + (mFileStatus.count() + mergeParent.count()) * static_cast<int>(sizeof(int))
+       + mLineStats.count() * static_cast<int>(sizeof(LineStats));
+}
+
+qint64 RevisionFiles::ownedMemory() const
+{
+   auto bytes = MemoryReport::bytes(mFiles) + MemoryReport::bytes(mRenamedFiles) + MemoryReport::bytes(mFileStatus)
+       + MemoryReport::bytes(mergeParent) + MemoryReport::bytes(mLineStats);
+
+   // The renamed files keep the status text of Git, that is not interned.
+   for (const auto &file : mRenamedFiles)
+      bytes += MemoryReport::bytes(file);
+
+   return bytes;
+}
+
 bool RevisionFiles::statusCmp(int idx, RevisionFiles::StatusFlag sf) const
 {
    if (idx >= mFileStatus.count())
@@ -77,3 +123,15 @@ void RevisionFiles::appendStatus(int pos, RevisionFiles::StatusFlag flag)
 {
    mFileStatus[pos] |= flag;
 }
+
+void RevisionFiles::setLineStats(int pos, int added, int deleted)
+{
+   if (pos < 0)
+      return;
+
+   if (pos >= mLineStats.count())
+      mLineStats.resize(pos + 1);
+
+   mLineStats[pos].added = added;
+   mLineStats[pos].deleted = deleted;
+}
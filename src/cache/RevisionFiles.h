@@ -2,6 +2,7 @@
 
 #include <QByteArray>
 #include <QVector>
+#include <QSet>
 #include <QStringList>
 
 class RevisionFiles
@@ -41,6 +42,37 @@ public:
    QString getFile(int index) const { return mFiles.at(index); }
    QStringList getFiles() const { return mFiles.toList(); }
    bool containsFile(const QString &fileName) { return mFiles.contains(fileName); }
+   int memoryUsage() const;
+   /*!
+    \brief Returns the heap memory owned by the files, in bytes. The paths are interned in the PathTable, so only the
+    vectors that point to them are counted.
+   */
+   qint64 ownedMemory() const;
+   static bool isInPaths(const QString &file, const QSet<QString> &paths);
+   /*!
+    \brief Stores the lines added and deleted in a file, as git diff --numstat gives them.
+
+    \param pos The position of the file.
+    \param added The lines added or BINARY_LINES.
+    \param deleted The lines deleted or BINARY_LINES.
+   */
+   void setLineStats(int pos, int added, int deleted);
+   /*!
+    \brief Tells if the lines changed in a file are known. They are for the files of the commits, read in the same
+    git call as the files themselves, but not for the WIP.
+   */
+   bool hasLineStats(int pos) const { return pos < mLineStats.count() && mLineStats.at(pos).added != UNKNOWN_LINES; }
+   /*!
+    \brief Returns the lines added in a file, BINARY_LINES for a binary file or UNKNOWN_LINES.
+   */
+   int linesAdded(int pos) const { return pos < mLineStats.count() ? mLineStats.at(pos).added : UNKNOWN_LINES; }
+   /*!
+    \brief Returns the lines deleted in a file, BINARY_LINES for a binary file or UNKNOWN_LINES.
+   */
+   int linesDeleted(int pos) const { return pos < mLineStats.count() ? mLineStats.at(pos).deleted : UNKNOWN_LINES; }
+
+   static constexpr int BINARY_LINES = -1;
+   static constexpr int UNKNOWN_LINES = -2;
 
 private:
    // Status information is splitted in a flags vector and in a string
@@ -56,4 +88,14 @@ private:
    bool mOnlyModified = true;
    QVector<int> mFileStatus;
    QVector<QString> mRenamedFiles;
+
+   struct LineStats
+   {
+      qint32 added = UNKNOWN_LINES;
+      qint32 deleted = UNKNOWN_LINES;
+
+      bool operator==(const LineStats &other) const { return added == other.added && deleted == other.deleted; }
+   };
+
+   QVector<LineStats> mLineStats;
 };
@@ -0,0 +1,108 @@
+#include "RevisionFilesStore.h"
+
+#include <ResourceBudget.h>
+
+#include <QHash>
+#include <QWeakPointer>
+
+#include <algorithm>
+#include <iterator>
+
+QSharedPointer<RevisionFilesStore> RevisionFilesStore::forRepository(const QString &repository)
+{
+   static QMutex mutex;
+   static QHash<QString, QWeakPointer<RevisionFilesStore>> stores;
+
+   QMutexLocker locker(&mutex);
+
+   auto store = stores.value(repository).toStrongRef();
+
+   if (!store)
+   {
+      // The repositories that are not opened anymore are removed when a new one is created.
+      for (auto iter = stores.begin(); iter != stores.end();)
+         iter = iter.value() ? std::next(iter) : stores.erase(iter);
+
+      store.reset(new RevisionFilesStore(DEFAULT_BUDGET_MB, QString("Files of the commits of %1").arg(repository)));
+      stores.insert(repository, store);
+   }
+
+   return store;
+}
+
+RevisionFilesStore::RevisionFilesStore(int budgetMb, const QString &name)
+   : mFiles(std::max(budgetMb, 1) * 1024)
+{
+   // The cost is measured in KB.
+   mBudgetId = ResourceBudget::instance().addCache(
+       name, std::max(budgetMb, 1) * qint64(1024 * 1024), [this]() { return memoryUsage(); },
+       [this](qint64 bytes) {
+          QMutexLocker locker(&mMutex);
+          mFiles.setMaxCost(static_cast<int>(std::max(bytes / 1024, qint64(1))));
+       });
+}
+
+RevisionFilesStore::~RevisionFilesStore()
+{
+   ResourceBudget::instance().removeCache(mBudgetId);
+}
+
+bool RevisionFilesStore::find(const Key &key, RevisionFiles &files) const
+{
+   QMutexLocker locker(&mMutex);
+
+   if (const auto stored = mFiles.object(key))
+   {
+      files = *stored;
+      return true;
+   }
+
+   return false;
+}
+
+bool RevisionFilesStore::contains(const Key &key) const
+{
+   QMutexLocker locker(&mMutex);
+
+   return mFiles.contains(key);
+}
+
+bool RevisionFilesStore::insert(const Key &key, const RevisionFiles &files)
+{
+   QMutexLocker locker(&mMutex);
+
+   if (const auto stored = mFiles.object(key); stored && *stored == files)
+      return false;
+
+   // The cost is measured in KB so the budget can be bigger than what fits in an int of bytes.
+   const auto cost = files.memoryUsage() / 1024 + 1;
+
+   return mFiles.insert(key, new RevisionFiles(files), cost);
+}
+
+void RevisionFilesStore::setBudget(int megabytes)
+{
+   // The budget calls the store back with its limit: the lock of the store can't be held here.
+   ResourceBudget::instance().setCacheBudget(mBudgetId, std::max(megabytes, 1) * qint64(1024 * 1024));
+}
+
+void RevisionFilesStore::clear()
+{
+   QMutexLocker locker(&mMutex);
+
+   mFiles.clear();
+}
+
+int RevisionFilesStore::count() const
+{
+   QMutexLocker locker(&mMutex);
+
+   return mFiles.count();
+}
+
+qint64 RevisionFilesStore::memoryUsage() const
+{
+   QMutexLocker locker(&mMutex);
+
+   return static_cast<qint64>(mFiles.totalCost()) * 1024;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+#include <RevisionFiles.h>
+
+#include <QCache>
+#include <QMutex>
+#include <QPair>
+#include <QSharedPointer>
+#include <QString>
+
+/*!
+ \brief The RevisionFilesStore keeps the files changed between two commits, the least recently used first out when
+ its memory budget is exceeded. The files between two commits never change, so the caches of the work trees of the
+ same repository share one store: a diff read in a tab is already known in the others. The files of the WIP and of the
+ stashes depend on the work tree and stay in every cache.
+
+ It can be used from any thread.
+
+ \class RevisionFilesStore RevisionFilesStore.h "RevisionFilesStore.h"
+*/
+class RevisionFilesStore
+{
+public:
+   using Key = QPair<ObjectId, ObjectId>;
+
+   /*!
+    \brief Returns the store of a repository. It's created when the first cache asks for it and destroyed with the last
+    one.
+
+    \param repository The repository, identified by its common git directory, see GitBase::getRepositoryId.
+    \return The store.
+   */
+   static QSharedPointer<RevisionFilesStore> forRepository(const QString &repository);
+
+   /*!
+    \brief Default constructor.
+
+    \param budgetMb The memory budget in MB.
+    \param name The name of the store in the ResourceBudget.
+   */
+   explicit RevisionFilesStore(int budgetMb = DEFAULT_BUDGET_MB, const QString &name = QString("Files of the commits"));
+   /*!
+    \brief Destructor.
+   */
+   ~RevisionFilesStore();
+
+   /*!
+    \brief Looks for the files between two commits.
+
+    \param key The commit and the one it's compared to.
+    \param files The files, if they are found.
+    \return True if the files were stored, otherwise false.
+   */
+   bool find(const Key &key, RevisionFiles &files) const;
+   /*!
+    \brief Tells if the files between two commits are stored.
+   */
+   bool contains(const Key &key) const;
+   /*!
+    \brief Stores the files between two commits, unless they are already stored or they exceed the budget.
+
+    \param key The commit and the one it's compared to.
+    \param files The files.
+    \return True if the files were stored, otherwise false.
+   */
+   bool insert(const Key &key, const RevisionFiles &files);
+   /*!
+    \brief Sets the memory budget. The caches sharing the store use the same setting. The store gets less if the
+    global budget of the ResourceBudget is exceeded.
+
+    \param megabytes The budget in MB.
+   */
+   void setBudget(int megabytes);
+   /*!
+    \brief Removes all the files.
+   */
+   void clear();
+   /*!
+    \brief Returns the number of pairs of commits stored.
+   */
+   int count() const;
+   /*!
+    \brief Returns the memory used by the files stored, in bytes.
+   */
+   qint64 memoryUsage() const;
+
+   static constexpr int DEFAULT_BUDGET_MB = 64;
+
+private:
+   mutable QMutex mMutex;
+   QCache<Key, RevisionFiles> mFiles;
+   int mBudgetId = 0;
+};
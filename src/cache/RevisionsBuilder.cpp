@@ -0,0 +1,400 @@
+#include "RevisionsBuilder.h"
+
+#include <CommitGraph.h>
+#include <LazyLog.h>
+#include <TraceRecorder.h>
+#include <RevisionsDiskCache.h>
+#include <WorkerPool.h>
+
+#include <QLogger.h>
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <atomic>
+
+using namespace QLogger;
+
+namespace
+{
+// The records are handed out in slices so the threads don't compete for every commit.
+constexpr auto PARSE_SLICE = 512;
+
+/*!
+ \brief The commits of a chunk parsed by the threads of the pool and the builder itself. The builder takes slices as
+ well, so the parsing finishes even when the quotas of the pool don't leave any thread free for the helpers. A helper
+ that starts after all the slices were taken returns without touching the records.
+*/
+struct ParseBatch
+{
+   QVector<QByteArray> records;
+   CommitInfo *revisions = nullptr;
+   int slices = 0;
+   int pendingSlices = 0;
+   std::atomic<int> nextSlice { 0 };
+   QMutex mutex;
+   QWaitCondition finished;
+
+   void parse()
+   {
+      for (auto slice = nextSlice++; slice < slices; slice = nextSlice++)
+      {
+         const auto end = std::min(records.count(), (slice + 1) * PARSE_SLICE);
+
+         for (auto i = slice * PARSE_SLICE; i < end; ++i)
+            revisions[i] = CommitInfo(records.at(i));
+
+         QMutexLocker locker(&mutex);
+
+         if (--pendingSlices == 0)
+            finished.wakeAll();
+      }
+   }
+};
+}
+
+RevisionsBuilder::RevisionsBuilder(const void *repository, QObject *parent)
+   : QObject(parent)
+   , mParseQueue(new WorkerQueue(repository, WorkerPool::Priority::Refresh, true))
+{
+   qRegisterMetaType<QVector<CommitInfo *>>("QVector<CommitInfo *>");
+   qRegisterMetaType<Lanes>("Lanes");
+}
+
+// The helpers that didn't start are discarded: the builder parses their slices while it waits.
+RevisionsBuilder::~RevisionsBuilder() = default;
+
+void RevisionsBuilder::init(int generation, const QString &wipParentSha, const QString &diskCacheFile,
+                            const QByteArray &diskCacheKey)
+{
+   QLog_Debug("Git", QString("Starting the generation {%1} of the cache.").arg(generation));
+
+   mGeneration = generation;
+   mTotalCommits = 0;
+   mPendingData.clear();
+   mDiskCacheFile = diskCacheFile;
+   mDiskCacheKey = diskCacheKey;
+   mDiskCacheData.clear();
+   mDelta = false;
+   mParseNs = 0;
+   mLanesNs = 0;
+
+   // The WIP commit is always the first row of the graph
+   const CommitInfo wip(CommitInfo::ZERO_SHA, { wipParentSha }, QString(), 0, QString(), QString());
+
+   mLanes.init(wip.id());
+   mLanes.calculateLanes(wip);
+}
+
+void RevisionsBuilder::initDelta(int generation, const QString &wipParentSha, const QString &previousWipParentSha)
+{
+   // The lanes of the current history start with the WIP commit on top of the previous HEAD
+   init(generation, previousWipParentSha);
+   mDeltaExpectedLanes = mLanes;
+
+   init(generation, wipParentSha);
+   mDelta = true;
+}
+
+void RevisionsBuilder::loadFromDiskCache(int generation)
+{
+   TraceSpan span("loader", "RevisionsBuilder::loadFromDiskCache");
+
+   if (generation != mGeneration)
+      return;
+
+   QVector<CommitInfo *> commits;
+   QElapsedTimer timer;
+   timer.start();
+
+   if (!mDiskCacheFile.isEmpty() && RevisionsDiskCache(mDiskCacheFile).load(mDiskCacheKey, commits))
+   {
+      mTotalCommits = commits.count();
+      mParseNs = timer.nsecsElapsed();
+      mLanes.clear();
+
+      // The cache is already up to date, there is no need to write it again.
+      mDiskCacheFile.clear();
+
+      if (!commits.isEmpty())
+         emit signalCommitsBuilt(mGeneration, commits);
+
+      emit signalBuildTimings(mGeneration, mParseNs / 1000000, mLanesNs / 1000000);
+      emit signalBuildFinished(mGeneration, mTotalCommits);
+   }
+   else
+      emit signalDiskCacheMissed(mGeneration);
+}
+
+void RevisionsBuilder::loadFromCommitGraph(int generation, const QString &objectsDir, const QStringList &tips,
+                                           bool firstParent)
+{
+   TraceSpan span("loader", "RevisionsBuilder::loadFromCommitGraph");
+
+   if (generation != mGeneration)
+      return;
+
+   QVector<ObjectId> tipIds;
+   tipIds.reserve(tips.count());
+
+   for (const auto &tip : tips)
+      tipIds.append(ObjectId::fromHex(tip));
+
+   QVector<CommitInfo *> commits;
+   QElapsedTimer timer;
+   timer.start();
+
+   if (CommitGraph(objectsDir).load(tipIds, firstParent, commits))
+   {
+      mTotalCommits = commits.count();
+      mParseNs = timer.nsecsElapsed();
+      mLanes.clear();
+
+      // The commits miss their details, so the history is not cached.
+      mDiskCacheFile.clear();
+
+      QLog_Debug("Git", QString("Loaded {%1} commits from the commit-graph.").arg(mTotalCommits));
+
+      if (!commits.isEmpty())
+         emit signalCommitsBuilt(mGeneration, commits);
+
+      emit signalBuildTimings(mGeneration, mParseNs / 1000000, mLanesNs / 1000000);
+      emit signalBuildFinished(mGeneration, mTotalCommits);
+   }
+   else
+      emit signalCommitGraphMissed(mGeneration);
+}
+
+void RevisionsBuilder::processData(int generation, const QByteArray &data)
+{
+   if (generation != mGeneration)
+      return;
+
+   QVector<QByteArray> records;
+   QVector<CommitInfo *> commits;
+   auto start = 0;
+
+   // The commit split between the previous chunk and this one is completed first: only its bytes are copied.
+   if (!mPendingData.isEmpty())
+   {
+      start = completePendingRecord(data);
+
+      if (start == -1)
+         return;
+
+      records.append(QByteArray::fromRawData(mPendingData.constData(), mPendingData.size() - 1));
+   }
+
+   // git log -z separates the commits with a NUL character. The records point to the chunk, which is alive until they
+   // are parsed, so the output of git log is not copied. The last commit of the chunk could be incomplete so it
+   // remains until the next chunk arrives.
+   auto end = CommitInfo::findRecordEnd(data, start);
+
+   while (end != -1)
+   {
+      records.append(QByteArray::fromRawData(data.constData() + start, end - start));
+
+      start = end + 1;
+      end = CommitInfo::findRecordEnd(data, start);
+   }
+
+   processRevisions(records, commits);
+
+   mPendingData = start < data.size() ? data.mid(start) : QByteArray();
+
+   if (!commits.isEmpty())
+      emit signalCommitsBuilt(mGeneration, commits);
+}
+
+int RevisionsBuilder::completePendingRecord(const QByteArray &data)
+{
+   // The data is appended up to every NUL character until the record ends there: a NUL character in the message
+   // doesn't end it.
+   auto from = 0;
+
+   while (from < data.size())
+   {
+      const auto nul = data.indexOf('\0', from);
+
+      if (nul == -1)
+         break;
+
+      mPendingData.append(data.constData() + from, nul + 1 - from);
+      from = nul + 1;
+
+      if (const auto end = CommitInfo::findRecordEnd(mPendingData, 0); end != -1)
+      {
+         // The bytes after the end of the record are parsed from the chunk.
+         const auto rest = mPendingData.size() - end - 1;
+
+         mPendingData.truncate(end + 1);
+
+         return from - rest;
+      }
+   }
+
+   mPendingData.append(data.constData() + from, data.size() - from);
+
+   return -1;
+}
+
+void RevisionsBuilder::finish(int generation)
+{
+   TraceSpan span("loader", "RevisionsBuilder::finish");
+
+   if (generation != mGeneration)
+      return;
+
+   // The last commit is not followed by a NUL character.
+   if (!mPendingData.isEmpty())
+   {
+      QVector<CommitInfo *> commits;
+
+      processRevisions({ mPendingData }, commits);
+
+      if (!commits.isEmpty())
+         emit signalCommitsBuilt(mGeneration, commits);
+   }
+
+   mPendingData.clear();
+
+   if (mDelta)
+   {
+      mDelta = false;
+
+      // The rows below the new commits only keep their lanes if they start from the same ones.
+      if (!(mLanes == mDeltaExpectedLanes))
+      {
+         QLog_Debug("Git", QString("The new commits of the generation {%1} change the current lanes.").arg(mGeneration));
+
+         emit signalDeltaLanes(mGeneration, mLanes, mDeltaExpectedLanes);
+      }
+
+      mDeltaExpectedLanes.clear();
+   }
+
+   mLanes.clear();
+
+   QLog_Debug("Git", QString("Generation {%1} built with {%2} commits.").arg(mGeneration).arg(mTotalCommits));
+
+   if (!mDiskCacheFile.isEmpty())
+      RevisionsDiskCache(mDiskCacheFile).save(mDiskCacheKey, mTotalCommits, mDiskCacheData);
+
+   mDiskCacheData.clear();
+
+   emit signalBuildTimings(mGeneration, mParseNs / 1000000, mLanesNs / 1000000);
+   emit signalBuildFinished(mGeneration, mTotalCommits);
+}
+
+void RevisionsBuilder::cancel(int generation, bool keepPartialResults)
+{
+   if (generation != mGeneration)
+      return;
+
+   QLog_Debug("Git", QString("Cancelling the generation {%1}.").arg(generation));
+
+   // The last chunk could contain an incomplete commit and a partial history must not be cached.
+   mPendingData.clear();
+   mDiskCacheFile.clear();
+   mDiskCacheData.clear();
+
+   // A partial delta can't be placed on top of the history because the lanes wouldn't match.
+   if (keepPartialResults && !mDelta)
+      finish(generation);
+   else
+   {
+      mDelta = false;
+      mLanes.clear();
+      mDeltaExpectedLanes.clear();
+
+      emit signalBuildCancelled(generation);
+   }
+
+   // Any data of this generation that arrives later is ignored.
+   mGeneration = -1;
+}
+
+void RevisionsBuilder::parseRevisions(const QVector<QByteArray> &records, QVector<CommitInfo> &revisions)
+{
+   TraceSpan span("loader", "RevisionsBuilder::parseRevisions");
+
+   revisions.resize(records.count());
+
+   const auto slices = (records.count() + PARSE_SLICE - 1) / PARSE_SLICE;
+   const auto helpers = std::min(slices, WorkerPool::instance().threadCount()) - 1;
+
+   if (helpers <= 0)
+   {
+      for (auto i = 0; i < records.count(); ++i)
+         revisions[i] = CommitInfo(records.at(i));
+
+      return;
+   }
+
+   QSharedPointer<ParseBatch> batch(new ParseBatch());
+   batch->records = records;
+   batch->revisions = revisions.data();
+   batch->slices = slices;
+   batch->pendingSlices = slices;
+
+   for (auto i = 0; i < helpers; ++i)
+      mParseQueue->post([batch]() { batch->parse(); });
+
+   batch->parse();
+
+   QMutexLocker locker(&batch->mutex);
+
+   while (batch->pendingSlices > 0)
+      batch->finished.wait(&batch->mutex);
+}
+
+void RevisionsBuilder::processRevisions(const QVector<QByteArray> &records, QVector<CommitInfo *> &commits)
+{
+   TraceSpan span("loader", "RevisionsBuilder::processRevisions");
+
+   if (records.isEmpty())
+      return;
+
+   QElapsedTimer timer;
+   timer.start();
+
+   QVector<CommitInfo> revisions;
+   parseRevisions(records, revisions);
+
+   mParseNs += timer.nsecsElapsed();
+
+   // The ordered stage: the lanes and the disk cache need the commits in the order of git log.
+   QDataStream out(&mDiskCacheData, QIODevice::WriteOnly | QIODevice::Append);
+   out.setVersion(QDataStream::Qt_5_9);
+
+   commits.reserve(commits.count() + revisions.count());
+
+   for (auto &revision : revisions)
+   {
+      if (revision.isValid())
+      {
+         // The lanes of a delta are needed to check that they fit on top of the current history.
+         if (mDelta)
+         {
+            timer.restart();
+
+            revision.setLanes(mLanes.calculateLanes(revision));
+
+            mLanesNs += timer.nsecsElapsed();
+         }
+
+         if (!mDiskCacheFile.isEmpty())
+            out << revision;
+
+         commits.append(new CommitInfo(std::move(revision)));
+
+         ++mTotalCommits;
+      }
+      else
+         QLog_LazyTrace("Git", QString("Discarding invalid revision data."));
+   }
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <lanes.h>
+
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QScopedPointer>
+
+Q_DECLARE_METATYPE(CommitInfo *)
+
+class WorkerQueue;
+
+/*!
+ \brief The RevisionsBuilder parses the output of git log. It is designed to run in a WorkerQueue so the GUI remains
+ responsive while a repository is being loaded. The lanes of the graph are calculated later by the RevisionsCache, when
+ the rows are shown, except for the commits of a delta generation that need them to be validated.
+
+ Every load is identified by a generation number. The data that belongs to an older generation is discarded so a new
+ load can start at any moment without waiting for the previous one to finish.
+
+ The commits are created in the worker pool and their ownership is transferred to the receiver of the
+ signalCommitsBuilt signal.
+
+ Loading is a pipeline: the chunks of git log arrive in order through the WorkerQueue of the builder, the commits of a
+ chunk are parsed in parallel in the worker pool, and then they are consumed in order by the builder, the only stage
+ that needs the sequence: the lanes of a delta and the disk cache.
+
+ \class RevisionsBuilder RevisionsBuilder.h "RevisionsBuilder.h"
+*/
+class RevisionsBuilder : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered every time a chunk of data has been processed.
+
+    \param generation The generation the commits belong to.
+    \param commits The commits built from the chunk. The receiver takes the ownership.
+   */
+   void signalCommitsBuilt(int generation, const QVector<CommitInfo *> &commits);
+   /*!
+    \brief Signal triggered when all the data of a generation has been processed.
+
+    \param generation The generation that has been built.
+    \param totalCommits The total of commits built, without the WIP commit.
+   */
+   void signalBuildFinished(int generation, int totalCommits);
+   /*!
+    \brief Signal triggered right before signalBuildFinished with the time spent in each step of the build.
+
+    \param generation The generation that has been built.
+    \param parseMs The time spent parsing the commits (or reading them from the disk cache).
+    \param lanesMs The time spent calculating the lanes.
+   */
+   void signalBuildTimings(int generation, qint64 parseMs, qint64 lanesMs);
+   /*!
+    \brief Signal triggered when the history can't be loaded from the disk cache and it has to be requested to git.
+
+    \param generation The generation that has to be built.
+   */
+   void signalDiskCacheMissed(int generation);
+   /*!
+    \brief Signal triggered when the history can't be loaded from the commit-graph, so it has to be asked to git.
+
+    \param generation The generation that couldn't be loaded.
+   */
+   void signalCommitGraphMissed(int generation);
+   /*!
+    \brief Signal triggered right before signalBuildFinished when the new commits of a delta generation change the
+    lanes the current history starts with. The rows below them are then calculated again until their lanes are the
+    same as before, see RevisionsCache::setDeltaLanes.
+
+    \param generation The generation.
+    \param lanes The lanes after the new commits.
+    \param expectedLanes The lanes the current history starts with.
+   */
+   void signalDeltaLanes(int generation, const Lanes &lanes, const Lanes &expectedLanes);
+   /*!
+    \brief Signal triggered when a generation is cancelled without keeping the commits already built.
+
+    \param generation The cancelled generation.
+   */
+   void signalBuildCancelled(int generation);
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param repository The repository the commits are parsed for, identified by its RevisionsCache.
+    \param parent The parent object.
+   */
+   explicit RevisionsBuilder(const void *repository, QObject *parent = nullptr);
+   ~RevisionsBuilder() override;
+
+   /*!
+    \brief Starts a new generation. The lanes are initialized with the WIP commit so the history graph starts with it.
+
+    \param generation The new generation number.
+    \param wipParentSha The SHA of the parent of the WIP commit (aka HEAD).
+    \param diskCacheFile The file where the history is cached. If it's empty the history is not cached.
+    \param diskCacheKey The key that identifies the history.
+   */
+   void init(int generation, const QString &wipParentSha, const QString &diskCacheFile = QString(),
+             const QByteArray &diskCacheKey = QByteArray());
+   /*!
+    \brief Loads the generation from the disk cache. If the cache matches, the commits are notified as if they had been
+    built. Otherwise signalDiskCacheMissed is triggered.
+
+    \param generation The generation to load.
+   */
+   void loadFromDiskCache(int generation);
+   /*!
+    \brief Loads the topology of the history from the commit-graph file of git. The commits only have their SHA, their
+    parents and their date: the authors and the logs are read later, for the rows that are shown. If a tip is not in
+    the commit-graph, signalCommitGraphMissed is triggered instead.
+
+    \param generation The generation to load.
+    \param objectsDir The absolute path of the objects directory of the repository.
+    \param tips The SHAs of the commits the history starts from.
+    \param firstParent If true, only the first parent of every commit is followed.
+   */
+   void loadFromCommitGraph(int generation, const QString &objectsDir, const QStringList &tips, bool firstParent);
+   /*!
+    \brief Starts a delta generation: only the commits that are not in the current history are processed. When the
+    generation finishes, it checks that the lanes after the new commits are the same the current history was built
+    with. Otherwise signalDeltaLanes is triggered before signalBuildFinished.
+
+    \param generation The new generation number.
+    \param wipParentSha The SHA of the parent of the WIP commit (aka HEAD).
+    \param previousWipParentSha The SHA of the parent of the WIP commit when the current history was built.
+   */
+   void initDelta(int generation, const QString &wipParentSha, const QString &previousWipParentSha);
+   /*!
+    \brief Processes a chunk of the git log output. The chunk doesn't need to contain complete commits.
+
+    \param generation The generation the data belongs to.
+    \param data The raw data.
+   */
+   void processData(int generation, const QByteArray &data);
+   /*!
+    \brief Processes the remaining data and notifies the end of the generation.
+
+    \param generation The generation to finish.
+   */
+   void finish(int generation);
+   /*!
+    \brief Cancels the generation. The data that is not processed yet is discarded and the disk cache is not written.
+
+    \param generation The generation to cancel.
+    \param keepPartialResults If true, the generation finishes with the commits already built. Otherwise
+    signalBuildCancelled is triggered.
+   */
+   void cancel(int generation, bool keepPartialResults);
+
+private:
+   int mGeneration = -1;
+   int mTotalCommits = 0;
+   bool mDelta = false;
+   qint64 mParseNs = 0;
+   qint64 mLanesNs = 0;
+   Lanes mDeltaExpectedLanes;
+   QByteArray mPendingData;
+   QString mDiskCacheFile;
+   QByteArray mDiskCacheKey;
+   QByteArray mDiskCacheData;
+   Lanes mLanes;
+   QScopedPointer<WorkerQueue> mParseQueue;
+
+   int completePendingRecord(const QByteArray &data);
+   void parseRevisions(const QVector<QByteArray> &records, QVector<CommitInfo> &revisions);
+   void processRevisions(const QVector<QByteArray> &records, QVector<CommitInfo *> &commits);
+};
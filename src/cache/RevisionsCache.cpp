@@ -1,168 +1,1516 @@
 #include "RevisionsCache.h"
 
+#include <LaneType.h>
+#include <LazyLog.h>
+#include <TraceRecorder.h>
+
 #include <QLogger.h>
 
+#include <QtAlgorithms>
+
+#include <algorithm>
+
 using namespace QLogger;
 
-RevisionsCache::RevisionsCache(QObject *parent)
-   : QObject(parent)
-{
+RevisionsCache::RevisionsCache(QObject *parent)
+   : QObject(parent)
+{
+}
+
+RevisionsCache::~RevisionsCache()
+{
+   // The commits of the history are deleted with their storages, once no snapshot uses them. Only the WIP commit is
+   // owned directly by the cache.
+   delete mCommits.value(0, nullptr);
+   qDeleteAll(mPendingCommits);
+
+   mStorages.clear();
+   mCommits.clear();
+   mCommitsMap.clear();
+   mCommitsRows.clear();
+   mPendingCommits.clear();
+   mPendingCommitsMap.clear();
+   mReferences.clear();
+   mReferencedCommits.clear();
+   mCommitReferences.clear();
+}
+
+void RevisionsCache::configure(int numElementsToStore)
+{
+   QLog_Debug("Git", QString("Configuring the cache for {%1} elements.").arg(numElementsToStore));
+
+   // We reserve 1 extra slots for the ZERO_SHA (aka WIP commit)
+   if (mCommits.isEmpty())
+      mCommits.resize(1);
+
+   // If there is no history loaded yet, the commits are shown while they are being loaded. Otherwise a new generation
+   // is built in the background and it replaces the current one once is completed.
+   mIncrementalLoad = mCommits.count() <= 1;
+   mDeltaLoad = false;
+
+   if (mIncrementalLoad)
+   {
+      mStorages = { QSharedPointer<RevisionsSnapshot::Storage>::create() };
+      mLanesRow = 1;
+      mLaneRows.clear();
+      mCommits.reserve(numElementsToStore + 1);
+      mCommitsMap.reserve(numElementsToStore + 1);
+      mCommitsRows.reserve(numElementsToStore + 1);
+   }
+   else
+   {
+      qDeleteAll(mPendingCommits);
+
+      mPendingCommits.clear();
+      mPendingCommits.resize(1);
+      mPendingCommits.reserve(numElementsToStore + 1);
+      mPendingCommitsMap.clear();
+      mPendingCommitsMap.reserve(numElementsToStore + 1);
+   }
+
+   mCacheLocked = false;
+}
+
+void RevisionsCache::configureDelta()
+{
+   QLog_Debug("Git", QString("Configuring the cache to add the new commits on top of the current history."));
+
+   if (mCommits.isEmpty())
+      mCommits.resize(1);
+
+   mIncrementalLoad = false;
+   mDeltaLoad = true;
+   mDeltaLanesChanged = false;
+
+   qDeleteAll(mPendingCommits);
+
+   mPendingCommits.clear();
+   mPendingCommits.resize(1);
+   mPendingCommitsMap.clear();
+
+   mCacheLocked = false;
+}
+
+void RevisionsCache::setDeltaLanes(const Lanes &lanes, const Lanes &expectedLanes)
+{
+   mDeltaLanes = lanes;
+   mDeltaExpectedLanes = expectedLanes;
+   mDeltaLanesChanged = true;
+}
+
+void RevisionsCache::configurePage()
+{
+   QLog_Debug("Git", QString("Configuring the cache to add a page of commits below the current history."));
+
+   if (mCommits.isEmpty())
+      mCommits.resize(1);
+
+   mIncrementalLoad = true;
+   mDeltaLoad = false;
+
+   // The snapshots taken so far keep the storage of the commits they have.
+   mStorages.prepend(QSharedPointer<RevisionsSnapshot::Storage>::create());
+
+   mCacheLocked = false;
+}
+
+QStringList RevisionsCache::getHistoryFrontier(const QStringList &tips) const
+{
+   calculateLanes(mCommits.count() - 1);
+
+   QStringList frontier;
+
+   for (const auto &id : mLanes.getPendingShas())
+   {
+      if (!mCommitsMap.contains(id))
+         frontier.append(id.toString());
+   }
+
+   for (const auto &tip : tips)
+   {
+      if (!mCommitsMap.contains(ObjectId::fromHex(tip)) && !frontier.contains(tip))
+         frontier.append(tip);
+   }
+
+   return frontier;
+}
+
+void RevisionsCache::setLanesOrigin(const QString &wipParentSha)
+{
+   auto &lanes = mIncrementalLoad ? mLanes : mPendingLanes;
+
+   // The WIP commit is always the first row of the graph
+   const CommitInfo wip(CommitInfo::ZERO_SHA, { wipParentSha }, QString(), 0, QString(), QString());
+
+   lanes.init(wip.id());
+   lanes.calculateLanes(wip);
+
+   (mIncrementalLoad ? mLanesOrigin : mPendingLanesOrigin) = wip.parentId(0);
+}
+
+void RevisionsCache::insertCommits(const QVector<CommitInfo *> &commits)
+{
+   TraceSpan span("cache", "RevisionsCache::insertCommits");
+
+   auto &storage = mIncrementalLoad ? mCommits : mPendingCommits;
+   auto &storageMap = mIncrementalLoad ? mCommitsMap : mPendingCommitsMap;
+
+   for (auto commit : commits)
+   {
+      const auto sha = commit->id();
+
+      if (storageMap.contains(sha) || (mDeltaLoad && mCommitsMap.contains(sha)))
+      {
+         QLog_Info("Git", QString("The commit with SHA {%1} is already in the cache.").arg(commit->sha()));
+
+         delete commit;
+      }
+      else
+      {
+         storage.append(commit);
+         storageMap.insert(sha, commit);
+
+         if (mIncrementalLoad)
+         {
+            mStorages.constFirst()->commits.append(commit);
+            mCommitsRows.insert(sha, mCommits.count() - 1);
+            mSortedCommitsDirty = true;
+            mRowColumnsDirty = true;
+         }
+      }
+   }
+}
+
+void RevisionsCache::setCommitDetails(const QVector<CommitInfo> &details)
+{
+   TraceSpan span("cache", "RevisionsCache::setCommitDetails");
+
+   const auto storage = QSharedPointer<RevisionsSnapshot::Storage>::create();
+
+   for (const auto &detail : details)
+   {
+      const auto row = mCommitsRows.value(detail.id(), -1);
+
+      if (row <= 0 || mCommits.at(row)->hasDetails())
+         continue;
+
+      const auto commit = mCommits.at(row);
+      const auto filled = new CommitInfo(*commit);
+      filled->setDetails(detail);
+
+      storage->commits.append(filled);
+      mCommits[row] = filled;
+      mCommitsMap.insert(filled->id(), filled);
+
+      if (mReferencedCommits.remove(commit))
+      {
+         mReferencedCommits.insert(filled);
+         std::replace(mReferences.begin(), mReferences.end(), commit, filled);
+      }
+   }
+
+   if (storage->commits.isEmpty())
+      return;
+
+   // The old commits stay in their storage until the generation is replaced.
+   mStorages.append(storage);
+   mSortedCommitsDirty = true;
+   mRowColumnsDirty = true;
+}
+
+bool RevisionsCache::replaceCommit(const ObjectId &id, const CommitInfo &commit)
+{
+   TraceSpan span("cache", "RevisionsCache::replaceCommit");
+
+   const auto row = mCommitsRows.value(id, -1);
+
+   if (mCacheLocked || row <= 0 || mCommitsMap.contains(commit.id()))
+      return false;
+
+   const auto replaced = mCommits.at(row);
+
+   if (replaced->parentIds() != commit.parentIds())
+      return false;
+
+   // The children come before their parents: a commit on top of the one replaced would lose its parent.
+   for (auto i = 1; i < row; ++i)
+   {
+      if (mCommits.at(i) && mCommits.at(i)->parentIds().contains(id))
+         return false;
+   }
+
+   QLog_LazyDebug("Git", QString("Replacing the commit {%1} by {%2}.").arg(id.toString(), commit.sha()));
+
+   // The lanes below the painted rows are calculated later from mLanes, that would still wait for the old sha1 and
+   // leave its lane open. The row gets its lanes now, so mLanes continues from the parents, the same for both commits.
+   calculateLanes(row);
+
+   const auto replacement = new CommitInfo(commit);
+   replacement->setLanes(replaced->getLanes());
+
+   const auto storage = QSharedPointer<RevisionsSnapshot::Storage>::create();
+   storage->commits.append(replacement);
+
+   // The old commit stays in its storage until the generation is replaced.
+   mStorages.append(storage);
+   mCommits[row] = replacement;
+   mCommitsMap.remove(id);
+   mCommitsMap.insert(replacement->id(), replacement);
+   mCommitsRows.remove(id);
+   mCommitsRows.insert(replacement->id(), row);
+
+   if (mReferencedCommits.remove(replaced))
+      mReferences.removeOne(replaced);
+
+   mCommitReferences.remove(id);
+   replacement->setHasReferences(false);
+
+   mLastPublishShift = 0;
+   mReferencesIndexDirty = true;
+   mSortedCommitsDirty = true;
+   mRowColumnsDirty = true;
+   ++mGeneration;
+
+   return true;
+}
+
+void RevisionsCache::restartLanes(const QString &wipParentSha)
+{
+   QLog_LazyDebug("Git", QString("Calculating the lanes again with the WIP on top of {%1}.").arg(wipParentSha));
+
+   const CommitInfo wip(CommitInfo::ZERO_SHA, { wipParentSha }, QString(), 0, QString(), QString());
+
+   mLanes.init(wip.id());
+   mLanes.calculateLanes(wip);
+   mLanesRow = 1;
+   mLaneRows.clear();
+}
+
+void RevisionsCache::publishGeneration()
+{
+   TraceSpan span("cache", "RevisionsCache::publishGeneration");
+
+   mLastPublishShift = mDeltaLoad ? mPendingCommits.count() - 1 : mIncrementalLoad ? 0 : -1;
+
+   if (mDeltaLoad)
+   {
+      QLog_Debug("Git", QString("Adding {%1} new commits on top of the history.").arg(mPendingCommits.count() - 1));
+
+      // The new commits come with their lanes and the old ones are only moved down, unless the new commits changed
+      // their lanes.
+      mLanesRow += mPendingCommits.count() - 1;
+      mLanesOrigin = ObjectId();
+
+      // The old commits keep their lanes but the references might have moved.
+      for (auto commit : qAsConst(mReferences))
+         commit->setHasReferences(false);
+
+      for (auto i = 1; i < mPendingCommits.count(); ++i)
+         mCommitsMap.insert(mPendingCommits.at(i)->id(), mPendingCommits.at(i));
+
+      const auto storage = QSharedPointer<RevisionsSnapshot::Storage>::create();
+      storage->commits = mPendingCommits.mid(1);
+      mStorages.prepend(storage);
+
+      mPendingCommits[0] = mCommits.value(0, nullptr);
+      mPendingCommits.reserve(mPendingCommits.count() + mCommits.count() - 1);
+
+      for (auto i = 1; i < mCommits.count(); ++i)
+         mPendingCommits.append(mCommits.at(i));
+
+      mCommits = std::move(mPendingCommits);
+
+      if (mDeltaLanesChanged)
+         convergeDeltaLanes(mLastPublishShift + 1);
+
+      mPendingCommits.clear();
+      mPendingCommitsMap.clear();
+   }
+   else if (!mIncrementalLoad && pendingKeepsLoadedRows())
+   {
+      QLog_Debug("Git",
+                 QString("Keeping the {%1} commits loaded and adding {%2} below them.")
+                     .arg(mCommits.count() - 1)
+                     .arg(mPendingCommits.count() - mCommits.count()));
+
+      // The loaded commits keep their lanes and their details. Only the references are loaded again.
+      for (auto commit : qAsConst(mReferences))
+         commit->setHasReferences(false);
+
+      const auto storage = QSharedPointer<RevisionsSnapshot::Storage>::create();
+      const auto loadedCount = mCommits.count();
+
+      for (auto i = 1; i < mPendingCommits.count(); ++i)
+      {
+         const auto commit = mPendingCommits.at(i);
+
+         if (i < loadedCount)
+            delete commit;
+         else
+         {
+            storage->commits.append(commit);
+            mCommits.append(commit);
+            mCommitsMap.insert(commit->id(), commit);
+         }
+      }
+
+      if (!storage->commits.isEmpty())
+         mStorages.append(storage);
+
+      mLastPublishShift = 0;
+
+      mPendingCommits.clear();
+      mPendingCommitsMap.clear();
+   }
+   else if (!mIncrementalLoad)
+   {
+      QLog_Debug("Git", QString("Replacing the cache with a new generation of {%1} commits.").arg(mPendingCommits.count()));
+
+      // The WIP commit is updated independently of the history so it's kept from the current generation.
+      const auto wip = mCommits.value(0, nullptr);
+
+      mPendingCommits[0] = wip;
+      mCommits[0] = nullptr;
+
+      if (wip)
+         mPendingCommitsMap.insert(wip->id(), wip);
+
+      // The commits of the previous generation are deleted when the snapshots that might still use them are released.
+      const auto storage = QSharedPointer<RevisionsSnapshot::Storage>::create();
+      storage->commits = mPendingCommits.mid(1);
+      mStorages = { storage };
+
+      mCommits = std::move(mPendingCommits);
+      mCommitsMap = std::move(mPendingCommitsMap);
+      mLanes = std::move(mPendingLanes);
+      mLanesOrigin = mPendingLanesOrigin;
+      mLanesRow = 1;
+      mLaneRows.clear();
+
+      mPendingCommits.clear();
+      mPendingCommitsMap.clear();
+   }
+
+   if (!mIncrementalLoad)
+   {
+      // The rows of the whole history change when a generation is published, so the row index is built again.
+      mCommitsRows.clear();
+      mCommitsRows.reserve(mCommits.count());
+
+      for (auto i = 0; i < mCommits.count(); ++i)
+      {
+         if (const auto commit = mCommits.at(i))
+            mCommitsRows.insert(commit->id(), i);
+      }
+   }
+
+   // The commits of a page come without references, the ones above keep theirs.
+   if (!mIncrementalLoad)
+   {
+      mReferences.clear();
+      mReferencedCommits.clear();
+      mCommitReferences.clear();
+   }
+
+   mReferencesIndexDirty = true;
+   mIncrementalLoad = false;
+   mDeltaLoad = false;
+   mSortedCommitsDirty = true;
+   mRowColumnsDirty = true;
+   ++mGeneration;
+}
+
+RevisionsSnapshot RevisionsCache::snapshot() const
+{
+   RevisionsSnapshot snapshot;
+   snapshot.mGeneration = mGeneration;
+   snapshot.mCommits = mCommits;
+   snapshot.mStorages = mStorages;
+
+   return snapshot;
+}
+
+int RevisionsCache::rowsShiftSince(int generation) const
+{
+   if (generation == mGeneration)
+      return 0;
+
+   return generation == mGeneration - 1 ? mLastPublishShift : -1;
+}
+
+void RevisionsCache::discardGeneration()
+{
+   qDeleteAll(mPendingCommits);
+
+   mPendingCommits.clear();
+   mPendingCommitsMap.clear();
+   mDeltaLoad = false;
+}
+
+CommitInfo RevisionsCache::getCommitInfoByRow(int row) const
+{
+   calculateLanes(row);
+
+   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+
+   return commit ? *commit : CommitInfo();
+}
+
+CommitView RevisionsCache::getCommitViewByRow(int row) const
+{
+   calculateLanes(row);
+
+   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+
+   if (commit && commit->hasReferences())
+   {
+      if (const auto references = mCommitReferences.constFind(commit->id()); references != mCommitReferences.constEnd())
+         return CommitView(commit, &references.value());
+   }
+
+   return CommitView(commit);
+}
+
+QStringList RevisionsCache::getReferences(const QString &sha, References::Type type) const
+{
+   return mCommitReferences.value(ObjectId::fromHex(sha)).getReferences(type);
+}
+
+int RevisionsCache::getCommitPos(const QString &sha) const
+{
+   return getCommitPos(ObjectId::fromHex(sha));
+}
+
+CommitInfo RevisionsCache::getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint)
+{
+   auto commitIter = searchCommit(field, text, startingPoint);
+
+   if (commitIter == mCommits.constEnd() && startingPoint > 0)
+      commitIter = searchCommit(field, text);
+
+   return commitIter != mCommits.constEnd() ? **commitIter : CommitInfo();
+}
+
+CommitInfo RevisionsCache::getCommitInfo(const QString &sha) const
+{
+   if (!sha.isEmpty())
+   {
+      const auto c = mCommitsMap.value(ObjectId::fromHex(sha), nullptr);
+
+      if (c == nullptr)
+      {
+         const auto commit = findCommitByPrefix(sha);
+
+         return commit ? *commit : CommitInfo();
+      }
+
+      return *c;
+   }
+
+   return CommitInfo();
+}
+
+void RevisionsCache::calculateLanes(int row) const
+{
+   // The lanes of a row depend on all the rows above it, so the rows are calculated in order up to the requested one
+   // and they are kept with their commits.
+   for (; mLanesRow <= row && mLanesRow < mCommits.count(); ++mLanesRow)
+   {
+      const auto commit = mCommits.at(mLanesRow);
+      const auto lanes = mLanes.calculateLanes(*commit);
+
+      // Most of the rows of a graph are repeated many times (e.g. a straight line of commits), so the commits share
+      // the data of the same rows instead of allocating one per commit.
+      auto sharedLanes = mLaneRows.constFind(lanes);
+
+      if (sharedLanes == mLaneRows.constEnd())
+         sharedLanes = mLaneRows.insert(lanes);
+
+      commit->setLanes(*sharedLanes);
+   }
+}
+
+void RevisionsCache::convergeDeltaLanes(int firstRow)
+{
+   TraceSpan span("cache", "RevisionsCache::convergeDeltaLanes");
+
+   // The lanes of a row only depend on the lanes before it: once the new lanes are the same as the ones the old rows
+   // were calculated with, the rest of the rows keep theirs. Only the rows that already have lanes are calculated, the
+   // rest are calculated later from mLanes.
+   const auto storage = QSharedPointer<RevisionsSnapshot::Storage>::create();
+   auto row = firstRow;
+
+   for (; row < mLanesRow && !(mDeltaLanes == mDeltaExpectedLanes); ++row)
+   {
+      const auto commit = mCommits.at(row);
+
+      mDeltaExpectedLanes.calculateLanes(*commit);
+
+      const auto lanes = mDeltaLanes.calculateLanes(*commit);
+      auto sharedLanes = mLaneRows.constFind(lanes);
+
+      if (sharedLanes == mLaneRows.constEnd())
+         sharedLanes = mLaneRows.insert(lanes);
+
+      // The snapshots taken before might be reading the lanes of the commit, so it's replaced by a copy.
+      const auto relaned = new CommitInfo(*commit);
+      relaned->setLanes(*sharedLanes);
+
+      storage->commits.append(relaned);
+      mCommits[row] = relaned;
+      mCommitsMap.insert(relaned->id(), relaned);
+   }
+
+   // Without converging in the rows calculated, the rest of the rows continue from the new lanes.
+   if (!(mDeltaLanes == mDeltaExpectedLanes))
+      mLanes = mDeltaLanes;
+
+   if (!storage->commits.isEmpty())
+      mStorages.append(storage);
+
+   QLog_Debug("Git", QString("Calculated again the lanes of {%1} rows below the new commits.").arg(row - firstRow));
+
+   mDeltaLanes.clear();
+   mDeltaExpectedLanes.clear();
+   mDeltaLanesChanged = false;
+}
+
+bool RevisionsCache::pendingKeepsLoadedRows() const
+{
+   // The content of a commit can't change without changing its SHA, and the lanes of a row only depend on the rows
+   // above it and the origin of the lanes. So the rows loaded are still valid when the new generation starts with the
+   // same SHAs from the same origin: comparing the ids is enough.
+   if (mCommits.count() <= 1 || mPendingCommits.count() < mCommits.count() || mLanesOrigin.isNull()
+       || mLanesOrigin != mPendingLanesOrigin)
+   {
+      return false;
+   }
+
+   for (auto i = 1; i < mCommits.count(); ++i)
+   {
+      const auto loaded = mCommits.at(i);
+      const auto pending = mPendingCommits.at(i);
+
+      if (!loaded || !pending || loaded->id() != pending->id() || loaded->isBoundary() != pending->isBoundary())
+         return false;
+   }
+
+   return true;
+}
+
+int RevisionsCache::findRowByDate(long long secsSinceEpoch) const
+{
+   // The commits that are out of order (e.g. rebased or with a wrong clock) are usually close to where they should be.
+   static constexpr int FIX_UP_WINDOW = 64;
+
+   if (mRowColumnsDirty)
+      buildRowColumns();
+
+   if (mCommitDates.count() <= 1)
+      return -1;
+
+   const auto newer = [secsSinceEpoch](long long date) { return date > secsSinceEpoch; };
+   const auto row = static_cast<int>(std::partition_point(mCommitDates.cbegin() + 1, mCommitDates.cend(), newer)
+                                     - mCommitDates.cbegin());
+   const auto from = std::max(1, row - FIX_UP_WINDOW);
+   const auto to = std::min(mCommitDates.count() - 1, row + FIX_UP_WINDOW);
+   auto found = -1;
+
+   for (auto i = from; i <= to; ++i)
+   {
+      const auto date = mCommitDates.at(i);
+
+      if (date <= secsSinceEpoch && (found == -1 || date > mCommitDates.at(found)))
+         found = i;
+   }
+
+   return found != -1 ? found : std::min(row, mCommitDates.count() - 1);
+}
+
+long long RevisionsCache::getCommitDateByRow(int row) const
+{
+   if (mRowColumnsDirty)
+      buildRowColumns();
+
+   return row >= 0 && row < mCommitDates.count() ? mCommitDates.at(row) : 0;
+}
+
+QVector<int> RevisionsCache::getAuthorRows(int authorId) const
+{
+   if (mRowColumnsDirty)
+      buildRowColumns();
+
+   return mAuthorRows.value(authorId);
+}
+
+QVector<int> RevisionsCache::getReferencedRows() const
+{
+   QVector<int> rows;
+   rows.reserve(mReferencedCommits.count());
+
+   for (const auto commit : mReferencedCommits)
+   {
+      if (const auto row = mCommitsRows.value(commit->id(), -1); row != -1)
+         rows.append(row);
+   }
+
+   std::sort(rows.begin(), rows.end());
+
+   return rows;
+}
+
+int RevisionsCache::getAuthorCommitsCount(int authorId) const
+{
+   if (mRowColumnsDirty)
+      buildRowColumns();
+
+   return mAuthorRows.value(authorId).count();
+}
+
+void RevisionsCache::buildRowColumns() const
+{
+   TraceSpan span("cache", "RevisionsCache::buildRowColumns");
+
+   mCommitDates.clear();
+   mCommitDates.reserve(mCommits.count());
+   mAuthorRows.clear();
+   mContainingMemo.clear();
+   mParentRowsBegin.clear();
+   mParentRowsBegin.reserve(mCommits.count() + 1);
+   mParentRows.clear();
+
+   for (auto row = 0; row < mCommits.count(); ++row)
+   {
+      const auto commit = mCommits.at(row);
+
+      mCommitDates.append(commit ? commit->secsSinceEpoch() : 0);
+      mParentRowsBegin.append(mParentRows.count());
+
+      if (commit)
+      {
+         for (const auto &parent : commit->parentIds())
+            mParentRows.append(mCommitsRows.value(parent, -1));
+      }
+
+      // The rows are visited in order, so the rows of every author are sorted.
+      if (commit && row > 0)
+         mAuthorRows[commit->authorId()].append(row);
+   }
+
+   mParentRowsBegin.append(mParentRows.count());
+
+   mRowColumnsDirty = false;
+}
+
+CommitInfo *RevisionsCache::findCommitByPrefix(const QString &prefix) const
+{
+   const auto isHexDigit = [](QChar c) {
+      return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+   };
+
+   if (!std::all_of(prefix.cbegin(), prefix.cend(), isHexDigit))
+      return nullptr;
+
+   if (mSortedCommitsDirty)
+   {
+      mSortedCommits.clear();
+      mSortedCommits.reserve(mCommitsMap.count());
+
+      for (auto commit : mCommitsMap)
+         mSortedCommits.append(commit);
+
+      std::sort(mSortedCommits.begin(), mSortedCommits.end(),
+                [](CommitInfo *a, CommitInfo *b) { return a->id() < b->id(); });
+
+      mSortedCommitsDirty = false;
+   }
+
+   // All the ids that start with the prefix are contiguous in the sorted list.
+   const auto first = std::lower_bound(
+       mSortedCommits.cbegin(), mSortedCommits.cend(), prefix,
+       [](CommitInfo *commit, const QString &hexPrefix) { return commit->id().comparePrefix(hexPrefix) < 0; });
+   const auto last = std::upper_bound(
+       first, mSortedCommits.cend(), prefix,
+       [](const QString &hexPrefix, CommitInfo *commit) { return commit->id().comparePrefix(hexPrefix) > 0; });
+
+   if (first == last)
+      return nullptr;
+
+   if (std::distance(first, last) > 1)
+   {
+      QLog_Warning("Git", QString("The short SHA {%1} is ambiguous: it matches {%2} commits.")
+                        .arg(prefix, QString::number(std::distance(first, last))));
+
+      return nullptr;
+   }
+
+   return *first;
+}
+
+RevisionFiles RevisionsCache::getRevisionFile(const QString &sha1, const QString &sha2) const
+{
+   const auto key = qMakePair(ObjectId::fromHex(sha1), ObjectId::fromHex(sha2));
+
+   if (key.first == CommitInfo::ZERO_ID)
+      return mWipRevisionFiles.value(key);
+
+   if (const auto stashFiles = mStashRevisionFiles.constFind(key); stashFiles != mStashRevisionFiles.constEnd())
+      return stashFiles.value();
+
+   if (RevisionFiles files; mRevisionFilesStore->find(key, files))
+   {
+      ++mRevisionFilesHits;
+      return files;
+   }
+
+   ++mRevisionFilesMisses;
+
+   return RevisionFiles();
+}
+
+bool RevisionsCache::insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file)
+{
+   const auto key = qMakePair(ObjectId::fromHex(sha1), ObjectId::fromHex(sha2));
+
+   if (key.first.isNull() || key.second.isNull())
+      return false;
+
+   // The files of the WIP are always needed and they are replaced every time the working directory changes, so they
+   // are kept outside of the budget.
+   if (key.first == CommitInfo::ZERO_ID)
+   {
+      if (mWipRevisionFiles.value(key) == file)
+         return false;
+
+      mWipRevisionFiles.insert(key, file);
+
+      return true;
+   }
+
+   if (RevisionFiles files; mRevisionFilesStore->find(key, files) && files == file)
+      return false;
+
+   QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+
+   if (!mRevisionFilesStore->insert(key, file))
+   {
+      QLog_Debug("Git", QString("The revisions files between {%1} and {%2} exceed the cache budget.").arg(sha1, sha2));
+
+      return false;
+   }
+
+   return true;
+}
+
+void RevisionsCache::insertStashRevisionFile(const QString &sha, const QString &parentSha, const RevisionFiles &file)
+{
+   const auto key = qMakePair(ObjectId::fromHex(sha), ObjectId::fromHex(parentSha));
+
+   if (!key.first.isNull() && !key.second.isNull())
+      mStashRevisionFiles.insert(key, file);
+}
+
+void RevisionsCache::retainStashRevisionFiles(const QVector<QString> &stashShas)
+{
+   QSet<ObjectId> stashes;
+
+   for (const auto &sha : stashShas)
+      stashes.insert(ObjectId::fromHex(sha));
+
+   for (auto iter = mStashRevisionFiles.begin(); iter != mStashRevisionFiles.end();)
+   {
+      if (stashes.contains(iter.key().first))
+         ++iter;
+      else
+         iter = mStashRevisionFiles.erase(iter);
+   }
+}
+
+void RevisionsCache::setRevisionFilesBudget(int megabytes)
+{
+   QLog_Debug("Git", QString("Setting the budget of the revisions files cache to {%1} MB.").arg(megabytes));
+
+   mRevisionFilesStore->setBudget(megabytes);
+}
+
+RevisionsCache::MemoryUsage RevisionsCache::memoryUsage() const
+{
+   MemoryUsage usage;
+
+   for (const auto commit : mCommits)
+      if (commit)
+         usage.commits += commit->memoryUsage();
+
+   usage.commits += (mCommitsMap.count() + mCommitsRows.count()) * static_cast<qint64>(sizeof(void *) * 4);
+
+   for (const auto &lanes : mLaneRows)
+      usage.lanes += lanes.count() * static_cast<qint64>(sizeof(Lane)) + static_cast<qint64>(sizeof(lanes));
+
+   usage.revisionFiles = mRevisionFilesStore->memoryUsage();
+
+   for (const auto &files : mWipRevisionFiles)
+      usage.revisionFiles += files.memoryUsage();
+
+   for (const auto &files : mStashRevisionFiles)
+      usage.revisionFiles += files.memoryUsage();
+
+   usage.indexes = (mSortedCommits.count() + mCommitDates.count()) * static_cast<qint64>(sizeof(qint64))
+       + (mParentRowsBegin.count() + mParentRows.count()) * static_cast<qint64>(sizeof(int));
+
+   for (const auto &rows : mAuthorRows)
+      usage.indexes += rows.count() * static_cast<qint64>(sizeof(int));
+
+   for (const auto &snapshot : mReferencesSnapshots)
+      for (const auto &references : snapshot)
+         usage.indexes += (references.first.size() + references.second.join(QString()).size())
+             * static_cast<qint64>(sizeof(QChar));
+
+   return usage;
+}
+
+MemoryReport RevisionsCache::memoryReport() const
+{
+   MemoryReport report;
+   CommitInfo::MemoryBreakdown commits;
+   auto count = 0;
+
+   for (const auto commit : mCommits)
+   {
+      if (commit)
+      {
+         const auto breakdown = commit->memoryBreakdown();
+         commits.logs += breakdown.logs;
+         commits.parents += breakdown.parents;
+         ++count;
+      }
+   }
+
+   report.add("Commit objects", count, count * qint64(sizeof(CommitInfo)));
+   report.add("Commit logs", count, commits.logs);
+   report.add("Commit parents", count, commits.parents);
+
+   auto commitReferences = MemoryReport::bytes(mCommitReferences);
+
+   for (const auto &references : mCommitReferences)
+      commitReferences += references.memoryUsage();
+
+   report.add("Commit references", mCommitReferences.count(), commitReferences);
+
+   auto storages = MemoryReport::bytes(mStorages);
+
+   for (const auto &storage : mStorages)
+      storages += qint64(sizeof(RevisionsSnapshot::Storage)) + MemoryReport::bytes(storage->commits);
+
+   report.add("Commits index", mCommits.count(),
+              MemoryReport::bytes(mCommits) + MemoryReport::bytes(mCommitsMap) + MemoryReport::bytes(mCommitsRows)
+                  + storages);
+   report.add("Pending commits", mPendingCommits.count(),
+              MemoryReport::bytes(mPendingCommits) + MemoryReport::bytes(mPendingCommitsMap));
+
+   auto authorRows = MemoryReport::bytes(mAuthorRows);
+
+   for (const auto &rows : mAuthorRows)
+      authorRows += MemoryReport::bytes(rows);
+
+   report.add("Sorted commits", mSortedCommits.count(),
+              MemoryReport::bytes(mSortedCommits) + MemoryReport::bytes(mCommitDates) + authorRows
+                  + MemoryReport::bytes(mParentRowsBegin) + MemoryReport::bytes(mParentRows));
+
+   auto lanes = MemoryReport::bytes(mLaneRows) + MemoryReport::bytes(mLanes.getLanes())
+       + MemoryReport::bytes(mPendingLanes.getLanes());
+
+   for (const auto &row : mLaneRows)
+      lanes += MemoryReport::bytes(row);
+
+   report.add("Lane rows", mLaneRows.count(), lanes);
+
+   // The cost of the cache is already an estimation, in KB.
+   report.add("Revision files", mRevisionFilesStore->count(), mRevisionFilesStore->memoryUsage());
+
+   auto wipFiles = MemoryReport::bytes(mWipRevisionFiles);
+
+   for (const auto &files : mWipRevisionFiles)
+      wipFiles += files.ownedMemory();
+
+   report.add("WIP revision files", mWipRevisionFiles.count(), wipFiles);
+
+   auto stashFiles = MemoryReport::bytes(mStashRevisionFiles);
+
+   for (const auto &files : mStashRevisionFiles)
+      stashFiles += files.ownedMemory();
+
+   report.add("Stash revision files", mStashRevisionFiles.count(), stashFiles);
+
+   auto references = MemoryReport::bytes(mReferences) + MemoryReport::bytes(mReferencedCommits)
+       + MemoryReport::bytes(mLocalBranchesIndex) + MemoryReport::bytes(mRemoteBranchesIndex)
+       + MemoryReport::bytes(mReferencesSnapshots);
+
+   for (const auto &name : mLocalBranchesIndex.keys() + mRemoteBranchesIndex.keys())
+      references += MemoryReport::bytes(name);
+
+   for (const auto &snapshot : mReferencesSnapshots)
+   {
+      references += MemoryReport::bytes(snapshot);
+
+      for (const auto &reference : snapshot)
+      {
+         references += MemoryReport::bytes(reference.first) + MemoryReport::bytes(reference.second);
+
+         for (const auto &name : reference.second)
+            references += MemoryReport::bytes(name);
+      }
+   }
+
+   report.add("References index", mReferences.count(), references);
+
+   auto distances = MemoryReport::bytes(mLocalBranchDistances);
+
+   for (const auto &branch : mLocalBranchDistances.keys())
+      distances += MemoryReport::bytes(branch);
+
+   report.add("Branch distances", mLocalBranchDistances.count(), distances);
+   report.add("Path table", mPathTable->count(), mPathTable->memoryUsage());
+
+   auto untracked = MemoryReport::bytes(mUntrackedfiles);
+
+   for (const auto &file : mUntrackedfiles)
+      untracked += MemoryReport::bytes(file);
+
+   report.add("Untracked files", mUntrackedfiles.count(), untracked);
+
+   return report;
+}
+
+bool RevisionsCache::compact()
+{
+   TraceSpan span("cache", "RevisionsCache::compact");
+
+   if (mCacheLocked)
+      return false;
+
+   QLog_Debug("Git",
+              QString("Compacting the cache: {%1} KB of revisions files freed.")
+                  .arg(QString::number(mRevisionFilesStore->memoryUsage() / 1024)));
+
+   mRevisionFilesStore->clear();
+
+   // The indexes are built again the first time they are used.
+   mSortedCommits.clear();
+   mSortedCommits.squeeze();
+   mSortedCommitsDirty = true;
+   mCommitDates.clear();
+   mCommitDates.squeeze();
+   mAuthorRows.clear();
+   mRowColumnsDirty = true;
+   mLocalBranchesIndex.clear();
+   mRemoteBranchesIndex.clear();
+   mReferencesSnapshots.clear();
+   mContainingMemo.clear();
+   mReferencesIndexDirty = true;
+
+   return true;
+}
+
+void RevisionsCache::insertReference(const QString &sha, References::Type type, const QString &reference)
+{
+   QLog_LazyDebug("Git", QString("Adding a new reference with SHA {%1}.").arg(sha));
+
+   const auto commit = mCommitsMap.value(ObjectId::fromHex(sha), nullptr);
+
+   if (commit)
+   {
+      mCommitReferences[commit->id()].addReference(type, reference);
+      commit->setHasReferences(true);
+
+      if (!mReferencedCommits.contains(commit))
+      {
+         mReferencedCommits.insert(commit);
+         mReferences.append(commit);
+      }
+
+      mReferencesIndexDirty = true;
+   }
+}
+
+void RevisionsCache::removeReference(const QString &sha, References::Type type, const QString &reference)
+{
+   QLog_LazyDebug("Git", QString("Removing the reference {%1} from SHA {%2}.").arg(reference, sha));
+
+   const auto commit = mCommitsMap.value(ObjectId::fromHex(sha), nullptr);
+
+   if (commit)
+   {
+      const auto references = mCommitReferences.find(commit->id());
+
+      if (references != mCommitReferences.end())
+      {
+         references.value().removeReference(type, reference);
+
+         if (references.value().isEmpty())
+         {
+            mCommitReferences.erase(references);
+            commit->setHasReferences(false);
+         }
+      }
+
+      if (!commit->hasReferences() && mReferencedCommits.remove(commit))
+         mReferences.removeOne(commit);
+
+      mReferencesIndexDirty = true;
+   }
+}
+
+void RevisionsCache::insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances)
+{
+   mLocalBranchDistances[name] = distances;
+}
+
+QVector<QPair<int, int>> RevisionsCache::getDistances(const QString &baseSha, const QStringList &shas) const
+{
+   QVector<QPair<int, int>> distances(shas.count(), qMakePair(-1, -1));
+
+   if (mCacheLocked)
+      return distances;
+
+   // The row 0 is the WIP commit, that no reference points to.
+   const auto baseRow = getCommitPos(ObjectId::fromHex(baseSha));
+
+   if (baseRow <= 0)
+      return distances;
+
+   QVector<int> rows(shas.count(), -1);
+
+   for (auto i = 0; i < shas.count(); ++i)
+   {
+      if (const auto row = getCommitPos(ObjectId::fromHex(shas.at(i))); row > 0)
+         rows[i] = row;
+   }
+
+   // Every walk has a bit of a 64 bits mask for the base and one for each of the commits it calculates.
+   static constexpr int COMMITS_PER_WALK = 63;
+
+   for (auto first = 0; first < shas.count(); first += COMMITS_PER_WALK)
+      walkDistances(baseRow, rows, first, qMin(first + COMMITS_PER_WALK, shas.count()), distances);
+
+   return distances;
+}
+
+void RevisionsCache::walkDistances(int baseRow, const QVector<int> &rows, int first, int last,
+                                   QVector<QPair<int, int>> &distances) const
+{
+   // The commits are stored in date order, so a commit is always in a row before the rows of its parents: the rows
+   // work as generation numbers. Walking the rows in order, every row gets the bits of the commits it's reachable
+   // from. A row that has the bit of the base but not the one of a commit is behind for that commit, and the other way
+   // round for ahead. Once all the rows reached have either all the bits or none, the rest of the history is common
+   // and the walk stops.
+   static constexpr quint64 BASE = 1;
+
+   auto all = BASE;
+   auto firstRow = baseRow;
+
+   for (auto i = first; i < last; ++i)
+   {
+      if (rows.at(i) != -1)
+      {
+         all |= BASE << (i - first + 1);
+         firstRow = qMin(firstRow, rows.at(i));
+      }
+   }
+
+   if (all == BASE)
+      return;
+
+   QVector<quint64> masks(mCommits.count(), 0);
+   QVector<int> ahead(last - first, 0);
+   QVector<int> behind(last - first, 0);
+   quint64 incomplete = 0;
+   auto open = 0;
+
+   const auto mark = [&masks, &open, all](int row, quint64 bits) {
+      const auto previous = masks.at(row);
+      const auto current = previous | bits;
+
+      if (current != previous)
+      {
+         masks[row] = current;
+         open += (current != all) - (previous != 0 && previous != all);
+      }
+   };
+
+   mark(baseRow, BASE);
+
+   for (auto i = first; i < last; ++i)
+   {
+      if (rows.at(i) != -1)
+         mark(rows.at(i), BASE << (i - first + 1));
+   }
+
+   for (auto row = firstRow; row < masks.count() && open > 0; ++row)
+   {
+      const auto mask = masks.at(row);
+
+      // The rows reachable only from common rows are common too, so the common rows are not walked.
+      if (mask == 0 || mask == all)
+         continue;
+
+      --open;
+
+      const auto isBehind = (mask & BASE) != 0;
+      const auto counted = (isBehind ? all & ~mask : mask) & ~BASE;
+
+      for (auto bits = counted; bits != 0; bits &= bits - 1)
+      {
+         const auto index = static_cast<int>(qCountTrailingZeroBits(bits)) - 1;
+
+         if (isBehind)
+            ++behind[index];
+         else
+            ++ahead[index];
+      }
+
+      for (const auto &parent : mCommits.at(row)->parentIds())
+      {
+         // The parent is not loaded (e.g. only the current branch is shown) so the distances of the commits that
+         // needed it can't be calculated.
+         if (const auto parentRow = getCommitPos(parent); parentRow > 0)
+            mark(parentRow, mask);
+         else
+            incomplete |= counted;
+      }
+   }
+
+   for (auto i = first; i < last; ++i)
+   {
+      const auto bit = BASE << (i - first + 1);
+
+      if ((all & bit) != 0 && (incomplete & bit) == 0)
+         distances[i] = qMakePair(ahead.at(i - first), behind.at(i - first));
+   }
 }
 
-RevisionsCache::~RevisionsCache()
+RevisionsCache::CommitRange RevisionsCache::getCommitRange(const QString &fromSha, const QString &toSha,
+                                                           bool symmetric) const
 {
-   for (auto commit : mCommits)
-      delete commit;
+   CommitRange range;
 
-   mCommits.clear();
-   mCommitsMap.clear();
-   mReferences.clear();
-}
+   if (mCacheLocked)
+      return range;
 
-void RevisionsCache::configure(int numElementsToStore)
-{
-   QLog_Debug("Git", QString("Configuring the cache for {%1} elements.").arg(numElementsToStore));
+   // The row 0 is the WIP commit, that isn't part of any range.
+   const auto fromRow = getCommitPos(ObjectId::fromHex(fromSha));
+   const auto toRow = getCommitPos(ObjectId::fromHex(toSha));
 
-   if (mCommits.isEmpty())
+   if (fromRow <= 0 || toRow <= 0)
+      return range;
+
+   if (mRowColumnsDirty)
+      buildRowColumns();
+
+   // The same walk as walkDistances with only two bits: a row marked from both commits is common, and so are all the
+   // rows reached from it. The walk stops when there are no rows left reached from only one of them.
+   static constexpr quint8 FROM = 1;
+   static constexpr quint8 TO = 2;
+   static constexpr quint8 BOTH = FROM | TO;
+
+   QVector<quint8> marks(mCommits.count(), 0);
+   auto open = 0;
+
+   const auto mark = [&marks, &open](int row, quint8 bits) {
+      const auto previous = marks.at(row);
+      const auto current = static_cast<quint8>(previous | bits);
+
+      if (current != previous)
+      {
+         marks[row] = current;
+         open += (current != BOTH) - (previous != 0 && previous != BOTH);
+      }
+   };
+
+   range.rows.resize(mCommits.count());
+   range.complete = true;
+
+   mark(fromRow, FROM);
+   mark(toRow, TO);
+
+   for (auto row = qMin(fromRow, toRow); row < marks.count() && open > 0; ++row)
    {
-      // We reserve 1 extra slots for the ZERO_SHA (aka WIP commit)
-      mCommits.resize(numElementsToStore + 1);
-      mCommitsMap.reserve(numElementsToStore + 1);
+      const auto bits = marks.at(row);
+
+      if (bits == 0 || bits == BOTH)
+         continue;
+
+      --open;
+
+      if (bits == TO)
+      {
+         range.rows.setBit(row);
+         ++range.toOnly;
+      }
+      else
+      {
+         if (symmetric)
+            range.rows.setBit(row);
+
+         ++range.fromOnly;
+      }
+
+      for (auto i = mParentRowsBegin.at(row); i < mParentRowsBegin.at(row + 1); ++i)
+      {
+         if (const auto parentRow = mParentRows.at(i); parentRow > 0)
+            mark(parentRow, bits);
+         else
+            range.complete = false;
+      }
    }
 
-   mCacheLocked = false;
+   return range;
 }
 
-CommitInfo RevisionsCache::getCommitInfoByRow(int row) const
+RevisionsCache::ContainingReferences RevisionsCache::getContainingReferences(const QString &sha, int maxRows) const
 {
-   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+   ContainingReferences containing;
 
-   return commit ? *commit : CommitInfo();
-}
+   if (mCacheLocked)
+      return containing;
 
-int RevisionsCache::getCommitPos(const QString &sha) const
-{
-   const auto commit = mCommitsMap.value(sha, nullptr);
-   return mCommits.indexOf(commit);
-}
+   const auto id = ObjectId::fromHex(sha);
+   const auto targetRow = getCommitPos(id);
 
-CommitInfo RevisionsCache::getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint)
-{
-   auto commitIter = searchCommit(field, text, startingPoint);
+   if (targetRow <= 0)
+      return containing;
 
-   if (commitIter == mCommits.constEnd() && startingPoint > 0)
-      commitIter = searchCommit(field, text);
+   // Building the indexes clears the memo if the history or the references changed.
+   if (mRowColumnsDirty)
+      buildRowColumns();
 
-   return commitIter != mCommits.constEnd() ? **commitIter : CommitInfo();
-}
+   if (mReferencesIndexDirty)
+      buildReferencesIndex();
 
-CommitInfo RevisionsCache::getCommitInfo(const QString &sha) const
-{
-   if (!sha.isEmpty())
-   {
-      const auto c = mCommitsMap.value(sha, nullptr);
+   if (const auto memo = mContainingMemo.object(id))
+      return *memo;
 
-      if (c == nullptr)
+   // A parent is always in a row after its children, so the references below the commit can't reach it.
+   QVector<QPair<int, const CommitInfo *>> candidates;
+   auto firstRow = targetRow;
+
+   for (const auto commit : mReferences)
+   {
+      if (const auto row = mCommitsRows.value(commit->id(), -1); row > 0 && row <= targetRow)
       {
-         const auto shas = mCommitsMap.keys();
-         const auto it = std::find_if(shas.cbegin(), shas.cend(),
-                                      [sha](const QString &shaToCompare) { return shaToCompare.startsWith(sha); });
+         candidates.append(qMakePair(row, commit));
+         firstRow = qMin(firstRow, row);
+      }
+   }
 
-         if (it != shas.cend())
-            return *mCommitsMap.value(*it);
+   const auto lastRow = maxRows > 0 ? qMax(firstRow, targetRow - maxRows) : firstRow;
 
-         return CommitInfo();
+   // The rows are walked upwards: the parents of a row are always visited before it, so a row reaches the commit if
+   // one of its parents does.
+   QBitArray reaches(targetRow - lastRow + 1);
+   reaches.setBit(targetRow - lastRow);
+
+   for (auto row = targetRow - 1; row >= lastRow; --row)
+   {
+      for (auto i = mParentRowsBegin.at(row); i < mParentRowsBegin.at(row + 1); ++i)
+      {
+         if (const auto parentRow = mParentRows.at(i);
+             parentRow > row && parentRow <= targetRow && reaches.testBit(parentRow - lastRow))
+         {
+            reaches.setBit(row - lastRow);
+            break;
+         }
       }
+   }
 
-      return *c;
+   for (const auto &candidate : qAsConst(candidates))
+   {
+      if (candidate.first < lastRow || !reaches.testBit(candidate.first - lastRow))
+         continue;
+
+      const auto references = mCommitReferences.value(candidate.second->id());
+
+      containing.localBranches.append(references.getReferences(References::Type::LocalBranch));
+      containing.remoteBranches.append(references.getReferences(References::Type::RemoteBranches));
+      containing.tags.append(references.getReferences(References::Type::Tag));
    }
 
-   return CommitInfo();
-}
+   containing.localBranches.sort();
+   containing.remoteBranches.sort();
+   containing.tags.sort();
+   containing.complete = lastRow == firstRow;
 
-RevisionFiles RevisionsCache::getRevisionFile(const QString &sha1, const QString &sha2) const
-{
-   return mRevisionFilesMap.value(qMakePair(sha1, sha2));
+   if (containing.complete)
+      mContainingMemo.insert(id, new ContainingReferences(containing));
+
+   return containing;
 }
 
-void RevisionsCache::insertCommitInfo(CommitInfo rev, int orderIdx)
+void RevisionsCache::updateWipCommit(const QString &parentSha, const QByteArray &status, bool keepUntracked)
 {
-   if (mCacheLocked)
-      QLog_Warning("Git", QString("The cache is currently locked."));
-   else if (mCommitsMap.contains(rev.sha()))
-      QLog_Info("Git", QString("The commit with SHA {%1} is already in the cache.").arg(rev.sha()));
+   TraceSpan span("cache", "RevisionsCache::updateWipCommit");
+
+   QLog_Debug("Git", QString("Updating the WIP commit. The actual parent has SHA {%1}.").arg(parentSha));
+
+   QVector<QString> untrackedFiles;
+   auto rf = parseWipStatus(status, untrackedFiles);
+
+   if (keepUntracked)
+   {
+      auto hiddenFiles = 0;
+      mUntrackedfiles = appendUntrackedFiles(rf, mUntrackedfiles, hiddenFiles);
+   }
    else
    {
-      rev.setLanes(calculateLanes(rev));
+      mUntrackedfiles = untrackedFiles;
+      mHiddenUntrackedFiles = 0;
+   }
+
+   setWipCommit(parentSha, rf);
+}
 
-      const auto commit = new CommitInfo(rev);
+bool RevisionsCache::updateWipUntrackedFiles(const QString &parentSha, const QByteArray &files)
+{
+   TraceSpan span("cache", "RevisionsCache::updateWipUntrackedFiles");
 
-      if (orderIdx >= mCommits.count())
-      {
-         QLog_Debug("Git", QString("Adding commit with sha {%1}.").arg(commit->sha()));
+   if (!containsRevisionFile(CommitInfo::ZERO_SHA, parentSha))
+      return false;
 
-         mCommits.append(commit);
-      }
-      else if (!(mCommits[orderIdx] && *mCommits[orderIdx] == *commit))
-      {
-         QLog_Trace("Git", QString("Overwriting commit with sha {%1}.").arg(commit->sha()));
+   const auto current = getRevisionFile(CommitInfo::ZERO_SHA, parentSha);
+   const auto previousUntracked = mUntrackedfiles.toList().toSet();
 
-         if (mCommits[orderIdx])
-            delete mCommits[orderIdx];
+   RevisionFiles rf;
+   rf.setOnlyModified(false);
 
-         mCommits[orderIdx] = commit;
+   for (auto i = 0; i < current.count(); ++i)
+   {
+      if (!previousUntracked.contains(current.getFile(i)))
+      {
+         rf.mFiles.append(current.getFile(i));
+         rf.setStatus(static_cast<RevisionFiles::StatusFlag>(current.getStatus(i)));
+         rf.mergeParent.append(1);
       }
+   }
 
-      mCommitsMap.insert(rev.sha(), commit);
+   QVector<QString> names;
 
-      if (mCommitsMap.contains(rev.parent(0)))
-         mCommitsMap.remove(rev.parent(0));
-   }
+   for (const auto &name : files.split('\0'))
+      if (!name.isEmpty())
+         names.append(QString::fromUtf8(name));
+
+   auto hiddenFiles = 0;
+   const auto untrackedFiles = appendUntrackedFiles(rf, names, hiddenFiles);
+
+   if (untrackedFiles == mUntrackedfiles && hiddenFiles == mHiddenUntrackedFiles)
+      return false;
+
+   QLog_Debug("Git", QString("Updating the untracked files of the WIP commit: {%1} listed and {%2} left out.")
+                         .arg(untrackedFiles.count())
+                         .arg(hiddenFiles));
+
+   mUntrackedfiles = untrackedFiles;
+   mHiddenUntrackedFiles = hiddenFiles;
+
+   setWipCommit(parentSha, rf);
+
+   return true;
 }
 
-bool RevisionsCache::insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file)
+QVector<QString> RevisionsCache::appendUntrackedFiles(RevisionFiles &rf, const QVector<QString> &files,
+                                                      int &hiddenFiles)
 {
-   const auto key = qMakePair(sha1, sha2);
+   // A file removed from the index but not from the disk is deleted and untracked at the same time.
+   QSet<QString> trackedFiles;
+   trackedFiles.reserve(rf.count());
+
+   for (const auto &file : qAsConst(rf.mFiles))
+      trackedFiles.insert(file);
 
-   if (!sha1.isEmpty() && !sha2.isEmpty() && mRevisionFilesMap.value(key) != file)
+   QVector<QString> untrackedFiles;
+   hiddenFiles = 0;
+
+   for (const auto &file : files)
    {
-      QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+      if (trackedFiles.contains(file))
+         continue;
 
-      mRevisionFilesMap.insert(key, file);
+      if (untrackedFiles.count() >= mMaxUntrackedFiles)
+      {
+         ++hiddenFiles;
+         continue;
+      }
 
-      return true;
+      untrackedFiles.append(file);
+      rf.mFiles.append(internPath(file));
+      rf.setStatus(RevisionFiles::UNKNOWN);
+      rf.mergeParent.append(1);
    }
 
-   return false;
+   return untrackedFiles;
 }
 
-void RevisionsCache::insertReference(const QString &sha, References::Type type, const QString &reference)
+bool RevisionsCache::patchWipCommit(const QString &parentSha, const QStringList &paths, const QByteArray &status)
 {
-   QLog_Debug("Git", QString("Adding a new reference with SHA {%1}.").arg(sha));
+   TraceSpan span("cache", "RevisionsCache::patchWipCommit");
 
-   auto commit = mCommitsMap[sha];
+   if (!containsRevisionFile(CommitInfo::ZERO_SHA, parentSha))
+      return false;
 
-   if (commit)
+   // The untracked files left out of the list have no names: which ones are inside the paths is only known by listing
+   // them all again.
+   if (mHiddenUntrackedFiles > 0)
+      return false;
+
+   QVector<QString> untrackedChanges;
+   const auto changes = parseWipStatus(status, untrackedChanges);
+
+   QLog_Debug("Git", QString("Updating {%1} paths of the WIP commit.").arg(paths.count()));
+
+   const auto pathsSet = paths.toSet();
+   const auto isAffected = [&pathsSet](const QString &file) { return RevisionFiles::isInPaths(file, pathsSet); };
+
+   const auto current = getRevisionFile(CommitInfo::ZERO_SHA, parentSha);
+
+   FileNamesLoader fl;
+   RevisionFiles rf;
+   rf.setOnlyModified(false);
+   fl.rf = &rf;
+
+   // The files outside the paths keep their status. The ones inside take the new one, if they still have changes. The
+   // untracked files are added at the end, so the limit of the list applies to them.
+   for (auto i = 0; i < current.count(); ++i)
+   {
+      if (current.getStatus(i) != RevisionFiles::UNKNOWN && !isAffected(current.getFile(i)))
+      {
+         appendFileName(current.getFile(i), fl);
+         rf.setStatus(static_cast<RevisionFiles::StatusFlag>(current.getStatus(i)));
+         rf.mergeParent.append(1);
+      }
+   }
+
+   for (auto i = 0; i < changes.count(); ++i)
    {
-      commit->addReference(type, reference);
+      if (changes.getStatus(i) == RevisionFiles::UNKNOWN)
+         continue;
 
-      if (!mReferences.contains(mCommitsMap[sha]))
-         mReferences.append(mCommitsMap[sha]);
+      appendFileName(changes.getFile(i), fl);
+      rf.setStatus(static_cast<RevisionFiles::StatusFlag>(changes.getStatus(i)));
+      rf.mergeParent.append(1);
    }
-}
 
-void RevisionsCache::insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances)
-{
-   mLocalBranchDistances[name] = distances;
-}
+   flushFileNames(fl);
 
-void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache)
-{
-   QLog_Debug("Git", QString("Updating the WIP commit. The actual parent has SHA {%1}.").arg(parentSha));
+   mUntrackedfiles.erase(std::remove_if(mUntrackedfiles.begin(), mUntrackedfiles.end(), isAffected),
+                         mUntrackedfiles.end());
+   mUntrackedfiles.append(untrackedChanges);
+   mUntrackedfiles = appendUntrackedFiles(rf, mUntrackedfiles, mHiddenUntrackedFiles);
 
-   const auto key = qMakePair(CommitInfo::ZERO_SHA, parentSha);
-   const auto fakeRevFile = fakeWorkDirRevFile(diffIndex, diffIndexCache);
+   setWipCommit(parentSha, rf);
 
+   return true;
+}
+
+void RevisionsCache::setWipCommit(const QString &parentSha, const RevisionFiles &fakeRevFile)
+{
    insertRevisionFile(CommitInfo::ZERO_SHA, parentSha, fakeRevFile);
 
    if (!mCacheLocked)
@@ -174,15 +1522,10 @@ void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &di
       CommitInfo c(CommitInfo::ZERO_SHA, { parentSha }, author, QDateTime::currentDateTime().toSecsSinceEpoch(), log,
                    longLog);
 
-      if (mLanes.isEmpty())
-         mLanes.init(c.sha());
-
-      c.setLanes(calculateLanes(c));
+      // The WIP commit is always the first commit in the first lane of the graph.
+      c.setLanes(mCommits[0] ? mCommits[0]->getLanes() : QVector<Lane> { Lane(LaneType::BRANCH) });
 
-      if (mCommits[0])
-         c.setLanes(mCommits[0]->getLanes());
-
-      const auto sha = c.sha();
+      const auto sha = c.id();
       const auto commit = new CommitInfo(std::move(c));
 
       if (mCommits[0])
@@ -191,44 +1534,29 @@ void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &di
       mCommits[0] = commit;
 
       mCommitsMap.insert(sha, commit);
+      mCommitsRows.insert(sha, 0);
+      mSortedCommitsDirty = true;
    }
 }
 
 void RevisionsCache::removeReference(const QString &sha)
 {
-   mCommitsMap[sha]->addReferences(References());
+   if (const auto commit = mCommitsMap.value(ObjectId::fromHex(sha), nullptr))
+   {
+      mCommitReferences.remove(commit->id());
+      commit->setHasReferences(false);
+      mReferencesIndexDirty = true;
+   }
 }
 
 bool RevisionsCache::containsRevisionFile(const QString &sha1, const QString &sha2) const
 {
-   return mRevisionFilesMap.contains(qMakePair(sha1, sha2));
-}
-
-QVector<Lane> RevisionsCache::calculateLanes(const CommitInfo &c)
-{
-   const auto sha = c.sha();
-
-   QLog_Trace("Git", QString("Updating the lanes for SHA {%1}.").arg(sha));
+   const auto key = qMakePair(ObjectId::fromHex(sha1), ObjectId::fromHex(sha2));
 
-   bool isDiscontinuity;
-   bool isFork = mLanes.isFork(sha, isDiscontinuity);
-   bool isMerge = c.parentsCount() > 1;
+   if (key.first == CommitInfo::ZERO_ID)
+      return mWipRevisionFiles.contains(key);
 
-   if (isDiscontinuity)
-      mLanes.changeActiveLane(sha); // uses previous isBoundary state
-
-   if (isFork)
-      mLanes.setFork(sha);
-   if (isMerge)
-      mLanes.setMerge(c.parents());
-   if (c.parentsCount() == 0)
-      mLanes.setInitial();
-
-   const auto lanes = mLanes.getLanes();
-
-   resetLanes(c, isFork);
-
-   return lanes;
+   return mStashRevisionFiles.contains(key) || mRevisionFilesStore->contains(key);
 }
 
 RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoader &fl)
@@ -237,8 +1565,34 @@ RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoade
    auto parNum = 1;
    const auto lines = buf.split("\n", QString::SkipEmptyParts);
 
+   // With --numstat the files of every parent are followed by their lines changed, in the same order. A rename or a
+   // copy is a single line in both formats: the lines are kept in the new file.
+   QVector<int> rawLinesFiles;
+   auto numstatLine = 0;
+
    for (auto line : lines)
    {
+      if (line[0] != ':' && line.contains('\t'))
+      {
+         if (numstatLine < rawLinesFiles.count())
+         {
+            const auto added = line.section('\t', 0, 0);
+            const auto deleted = line.section('\t', 1, 1);
+            auto addedValid = false;
+            auto deletedValid = false;
+            const auto addedCount = added.toInt(&addedValid);
+            const auto deletedCount = deleted.toInt(&deletedValid);
+
+            rf.setLineStats(rawLinesFiles.at(numstatLine), addedValid ? addedCount : RevisionFiles::BINARY_LINES,
+                            deletedValid ? deletedCount : RevisionFiles::BINARY_LINES);
+         }
+
+         ++numstatLine;
+         continue;
+      }
+
+      const auto filesBefore = rf.getFilesCount();
+
       if (line[0] == ':') // avoid sha's in merges output
       {
          if (line[1] == ':')
@@ -275,40 +1629,29 @@ RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoade
             else // It's a rename or a copy, we are not in fast path now!
                setExtStatus(rf, line.mid(97), parNum, fl);
          }
+
+         rawLinesFiles.append(rf.getFilesCount() > filesBefore ? filesBefore : -1);
       }
       else
+      {
          ++parNum;
+         rawLinesFiles.clear();
+         numstatLine = 0;
+      }
    }
 
    return rf;
 }
 
-void RevisionsCache::appendFileName(const QString &name, FileNamesLoader &fl)
+QString RevisionsCache::internPath(const QString &path)
 {
-   int idx = name.lastIndexOf('/') + 1;
-   const QString &dr = name.left(idx);
-   const QString &nm = name.mid(idx);
-
-   auto it = mDirNames.indexOf(dr);
-   if (it == -1)
-   {
-      int idx = mDirNames.count();
-      mDirNames.append(dr);
-      fl.rfDirs.append(idx);
-   }
-   else
-      fl.rfDirs.append(it);
-
-   it = mFileNames.indexOf(nm);
-   if (it == -1)
-   {
-      int idx = mFileNames.count();
-      mFileNames.append(nm);
-      fl.rfNames.append(idx);
-   }
-   else
-      fl.rfNames.append(it);
+   return mPathTable->intern(path);
+}
 
+void RevisionsCache::appendFileName(const QString &name, FileNamesLoader &fl)
+{
+   // The same paths appear in many commits, so all the RevisionFiles share the data of a single copy of every path.
+   fl.rfPaths.append(internPath(name));
    fl.files.append(name);
 }
 
@@ -317,17 +1660,24 @@ void RevisionsCache::flushFileNames(FileNamesLoader &fl)
    if (!fl.rf)
       return;
 
-   for (auto i = 0; i < fl.rfNames.count(); ++i)
-   {
-      const auto dirName = mDirNames.at(fl.rfDirs.at(i));
-      const auto fileName = mFileNames.at(fl.rfNames.at(i));
+   QSet<QString> files;
+   files.reserve(fl.rf->mFiles.count() + fl.rfPaths.count());
 
-      if (!fl.rf->mFiles.contains(dirName + fileName))
-         fl.rf->mFiles.append(dirName + fileName);
+   for (const auto &file : qAsConst(fl.rf->mFiles))
+      files.insert(file);
+
+   fl.rf->mFiles.reserve(fl.rf->mFiles.count() + fl.rfPaths.count());
+
+   for (const auto &path : qAsConst(fl.rfPaths))
+   {
+      if (!files.contains(path))
+      {
+         files.insert(path);
+         fl.rf->mFiles.append(path);
+      }
    }
 
-   fl.rfNames.clear();
-   fl.rfDirs.clear();
+   fl.rfPaths.clear();
    fl.rf = nullptr;
 }
 
@@ -337,7 +1687,7 @@ bool RevisionsCache::pendingLocalChanges() const
 
    if (!mCacheLocked)
    {
-      const auto commit = mCommitsMap.value(CommitInfo::ZERO_SHA);
+      const auto commit = mCommitsMap.value(CommitInfo::ZERO_ID);
       const auto rf = getRevisionFile(CommitInfo::ZERO_SHA, commit->parent(0));
       localChanges = rf.count() == mUntrackedfiles.count();
    }
@@ -347,41 +1697,62 @@ bool RevisionsCache::pendingLocalChanges() const
 
 QVector<QPair<QString, QStringList>> RevisionsCache::getBranches(References::Type type) const
 {
-   QVector<QPair<QString, QStringList>> branches;
-
-   for (auto commit : mReferences)
-      branches.append(QPair<QString, QStringList>(commit->sha(), commit->getReferences(type)));
+   if (mReferencesIndexDirty)
+      buildReferencesIndex();
 
-   return branches;
+   return mReferencesSnapshots.value(type);
 }
 
 QVector<QPair<QString, QStringList>> RevisionsCache::getTags() const
 {
-   QVector<QPair<QString, QStringList>> tags;
+   return getBranches(References::Type::Tag);
+}
 
-   for (auto commit : mReferences)
-      tags.append(QPair<QString, QStringList>(commit->sha(), commit->getReferences(References::Type::Tag)));
+QString RevisionsCache::getCommitForBranch(const QString &branch, bool local) const
+{
+   if (mReferencesIndexDirty)
+      buildReferencesIndex();
 
-   return tags;
+   return (local ? mLocalBranchesIndex : mRemoteBranchesIndex).value(branch).toString();
 }
 
-QString RevisionsCache::getCommitForBranch(const QString &branch, bool local) const
+void RevisionsCache::buildReferencesIndex() const
 {
-   QString sha;
+   TraceSpan span("cache", "RevisionsCache::buildReferencesIndex");
+
+   // The index is built once after the references are loaded: callers get implicitly shared copies of the snapshots.
+   mLocalBranchesIndex.clear();
+   mRemoteBranchesIndex.clear();
+   mReferencesSnapshots.clear();
 
-   for (auto commit : mReferences)
+   for (const auto type : { References::Type::LocalBranch, References::Type::RemoteBranches, References::Type::Tag })
    {
-      const auto branches
-          = commit->getReferences(local ? References::Type::LocalBranch : References::Type::RemoteBranches);
+      auto &snapshot = mReferencesSnapshots[type];
+      auto nameIndex = type == References::Type::LocalBranch
+          ? &mLocalBranchesIndex
+          : type == References::Type::RemoteBranches ? &mRemoteBranchesIndex : nullptr;
 
-      if (branches.contains(branch))
+      for (auto commit : mReferences)
       {
-         sha = commit->sha();
-         break;
+         const auto references = mCommitReferences.value(commit->id()).getReferences(type);
+
+         if (references.isEmpty())
+            continue;
+
+         snapshot.append(qMakePair(commit->sha(), references));
+
+         if (nameIndex)
+         {
+            for (const auto &name : references)
+            {
+               if (!nameIndex->contains(name))
+                  nameIndex->insert(name, commit->id());
+            }
+         }
       }
    }
 
-   return sha;
+   mReferencesIndexDirty = false;
 }
 
 void RevisionsCache::setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl)
@@ -436,33 +1807,37 @@ void RevisionsCache::setExtStatus(RevisionFiles &rf, const QString &rowSt, int p
 QVector<CommitInfo *>::const_iterator RevisionsCache::searchCommit(CommitInfo::Field field, const QString &text,
                                                                    const int startingPoint) const
 {
+   if (field == CommitInfo::Field::AUTHOR || field == CommitInfo::Field::COMMITER)
+   {
+      // The text is looked for once in every identity instead of once in every commit.
+      const auto matches = IdentityTable::matching(text);
+      const auto isAuthor = field == CommitInfo::Field::AUTHOR;
+
+      return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
+                          [&matches, isAuthor](CommitInfo *info) {
+                             return info && matches.value(isAuthor ? info->authorId() : info->committerId(), false);
+                          });
+   }
+
    return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
                        [field, text](CommitInfo *info) { return info->getFieldStr(field).contains(text); });
 }
 
-void RevisionsCache::resetLanes(const CommitInfo &c, bool isFork)
-{
-   const auto nextSha = c.parentsCount() == 0 ? QString() : c.parent(0);
-
-   mLanes.nextParent(nextSha);
-
-   if (c.parentsCount() > 1)
-      mLanes.afterMerge();
-   if (isFork)
-      mLanes.afterFork();
-   if (mLanes.isBranch())
-      mLanes.afterBranch();
-}
-
 void RevisionsCache::clear()
 {
+   // The commits are not removed: they remain available until a new generation replaces them.
    mCacheLocked = true;
-   mDirNames.clear();
-   mFileNames.clear();
-   mRevisionFilesMap.clear();
-   mLanes.clear();
-   mCommitsMap.clear();
-   mReferences.clear();
+
+   QLog_Debug("Git",
+              QString("Clearing the revisions files cache: {%1} KB used, {%2} hits and {%3} misses.")
+                  .arg(QString::number(mRevisionFilesStore->memoryUsage() / 1024), QString::number(mRevisionFilesHits),
+                       QString::number(mRevisionFilesMisses)));
+
+   // The files between two commits never change and the other work trees of the repository may be using them: only
+   // the budget of the store removes them.
+   mWipRevisionFiles.clear();
+   mRevisionFilesHits = 0;
+   mRevisionFilesMisses = 0;
 }
 
 int RevisionsCache::count() const
@@ -470,45 +1845,93 @@ int RevisionsCache::count() const
    return mCommits.count();
 }
 
-RevisionFiles RevisionsCache::fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache)
+RevisionFiles RevisionsCache::parseWipStatus(const QByteArray &status, QVector<QString> &untrackedFiles)
 {
    FileNamesLoader fl;
-   auto rf = parseDiffFormat(diffIndex, fl);
-   fl.rf = &rf;
+   RevisionFiles rf;
    rf.setOnlyModified(false);
+   fl.rf = &rf;
+
+   untrackedFiles.clear();
+
+   // A file removed from the index but not from the disk is listed twice: deleted and untracked.
+   QSet<QString> paths;
+   const auto entries = status.split('\0');
 
-   for (const auto &it : qAsConst(mUntrackedfiles))
+   for (auto i = 0; i < entries.count(); ++i)
    {
-      if (fl.rf != &rf)
+      const auto &entry = entries.at(i);
+
+      if (entry.size() < 3)
+         continue;
+
+      const auto type = entry.at(0);
+
+      if (type == '?')
       {
-         flushFileNames(fl);
-         fl.rf = &rf;
-      }
+         const auto path = QString::fromUtf8(entry.mid(2));
 
-      appendFileName(it, fl);
-      rf.setStatus(RevisionFiles::UNKNOWN);
-      rf.mergeParent.append(1);
-   }
+         if (paths.contains(path))
+            continue;
 
-   RevisionFiles cachedFiles = parseDiffFormat(diffIndexCache, fl);
-   flushFileNames(fl);
+         paths.insert(path);
+         untrackedFiles.append(path);
 
-   for (auto i = 0; i < rf.count(); i++)
-   {
-      if (cachedFiles.mFiles.indexOf(rf.getFile(i)) != -1)
+         appendFileName(path, fl);
+         rf.setStatus(RevisionFiles::UNKNOWN);
+         rf.mergeParent.append(1);
+      }
+      else if (type == '1' || type == '2' || type == 'u')
       {
-         if (cachedFiles.statusCmp(i, RevisionFiles::CONFLICT))
-            rf.appendStatus(i, RevisionFiles::CONFLICT);
+         // The path goes after 8 fields for the changed entries, 9 for the renamed and 10 for the unmerged.
+         const auto fields = type == '1' ? 8 : type == '2' ? 9 : 10;
+         auto pathStart = 0;
+
+         for (auto field = 0; field < fields && pathStart != -1; ++field)
+            pathStart = entry.indexOf(' ', pathStart) + 1;
+
+         // The renamed entries are followed by the original path, that is not shown.
+         if (type == '2')
+            ++i;
+
+         if (pathStart <= 0)
+            continue;
 
-         rf.appendStatus(i, RevisionFiles::IN_INDEX);
+         const auto indexStatus = entry.at(2);
+         const auto workTreeStatus = entry.at(3);
+         const auto path = QString::fromUtf8(entry.mid(pathStart));
+
+         paths.insert(path);
+         appendFileName(path, fl);
+         rf.mergeParent.append(1);
+
+         // Like comparing HEAD with the work tree, with the files changed in the index marked.
+         if (type == 'u')
+         {
+            rf.setStatus(RevisionFiles::MODIFIED);
+            rf.appendStatus(rf.getFilesCount() - 1, RevisionFiles::CONFLICT);
+         }
+         else if (indexStatus == 'A')
+            rf.setStatus(RevisionFiles::NEW);
+         else if (indexStatus == 'D' || workTreeStatus == 'D')
+            rf.setStatus(RevisionFiles::DELETED);
+         else
+            rf.setStatus(RevisionFiles::MODIFIED);
+
+         if (indexStatus != '.')
+            rf.appendStatus(rf.getFilesCount() - 1, RevisionFiles::IN_INDEX);
       }
    }
 
+   flushFileNames(fl);
+
    return rf;
 }
 
 RevisionFiles RevisionsCache::parseDiff(const QString &logDiff)
 {
+   TraceSpan span("cache", "RevisionsCache::parseDiff");
+
    FileNamesLoader fl;
 
    auto rf = parseDiffFormat(logDiff, fl);
@@ -518,7 +1941,42 @@ RevisionFiles RevisionsCache::parseDiff(const QString &logDiff)
    return rf;
 }
 
-void RevisionsCache::setUntrackedFilesList(const QVector<QString> &untrackedFiles)
+QVector<QPair<QString, RevisionFiles>> RevisionsCache::parseDiffs(const QString &output)
 {
-   mUntrackedfiles = untrackedFiles;
+   TraceSpan span("cache", "RevisionsCache::parseDiffs");
+
+   QVector<QPair<QString, RevisionFiles>> diffs;
+   QString sha;
+   auto sectionStart = -1;
+   auto lineStart = 0;
+
+   // The lines of the files start with ':' and the lines changed in them, if any, follow. Any other one is the commit
+   // of the next diff, maybe followed by the parent it's compared to.
+   while (lineStart < output.length())
+   {
+      auto lineEnd = output.indexOf('\n', lineStart);
+
+      if (lineEnd == -1)
+         lineEnd = output.length();
+
+      // The lines of --numstat have tabs, the ones of the commits don't.
+      const auto tab = output.indexOf('\t', lineStart);
+
+      if (lineEnd > lineStart && output.at(lineStart) != ':' && (tab == -1 || tab > lineEnd))
+      {
+         if (sectionStart != -1)
+            diffs.append(qMakePair(sha, parseDiff(output.mid(sectionStart, lineStart - sectionStart))));
+
+         const auto separator = output.indexOf(' ', lineStart);
+         sha = output.mid(lineStart, (separator == -1 || separator > lineEnd ? lineEnd : separator) - lineStart);
+         sectionStart = lineEnd + 1;
+      }
+
+      lineStart = lineEnd + 1;
+   }
+
+   if (sectionStart != -1)
+      diffs.append(qMakePair(sha, parseDiff(output.mid(sectionStart))));
+
+   return diffs;
 }
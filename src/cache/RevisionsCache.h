@@ -23,12 +23,20 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <MemoryReport.h>
+#include <PathTable.h>
 #include <RevisionFiles.h>
-#include <lanes.h>
+#include <RevisionFilesStore.h>
 #include <CommitInfo.h>
+#include <CommitView.h>
+#include <RevisionsSnapshot.h>
+#include <lanes.h>
 
+#include <QBitArray>
 #include <QObject>
 #include <QHash>
+#include <QCache>
+#include <QSet>
 
 struct WorkingDirInfo;
 
@@ -52,31 +60,347 @@ public:
    ~RevisionsCache();
 
    void configure(int numElementsToStore);
+   void configureDelta();
+   /*!
+    \brief Sets the lanes of a delta generation whose new commits change the lanes the current history starts with.
+    When the generation is published, the rows below the new commits are calculated again only until their lanes
+    converge with the ones they had: from there on the rows are the same, so a refresh after a commit or a fetch
+    touches a few rows.
+
+    \param lanes The lanes after the new commits.
+    \param expectedLanes The lanes the current history starts with.
+   */
+   void setDeltaLanes(const Lanes &lanes, const Lanes &expectedLanes);
+   /*!
+    \brief Configures the cache to add the next page of a partial history below the commits loaded. The commits are
+    shown while they are loaded and their lanes continue the ones of the rows above.
+   */
+   void configurePage();
+   /*!
+    \brief Returns where a partial history continues: the commits the lanes of the last row wait for plus the tips of
+    the history that aren't loaded yet. A git log from them gives the rest of the history in the same order.
+
+    \param tips The tips the history was loaded from.
+    \return The SHAs of the commits, or an empty list if the whole history is loaded.
+   */
+   QStringList getHistoryFrontier(const QStringList &tips) const;
+   /*!
+    \brief Sets the state the lanes of the generation being loaded start from. The lanes of every row are calculated
+    from it when the row is requested for the first time, so the history doesn't need them to be loaded.
+
+    \param wipParentSha The SHA of the parent of the WIP commit (aka HEAD) the generation is loaded with.
+   */
+   void setLanesOrigin(const QString &wipParentSha);
    void clear();
 
+   void insertCommits(const QVector<CommitInfo *> &commits);
+   void publishGeneration();
+   void discardGeneration();
+   /*!
+    \brief Fills the author, the dates and the log of the commits that were loaded without them from the commit-graph.
+    The commits are replaced by filled copies, since the snapshots taken before could be reading the old ones.
+
+    \param details The commits read from git with all their details.
+   */
+   void setCommitDetails(const QVector<CommitInfo> &details);
+   /*!
+    \brief Replaces a commit by the one that amends it, in the same row and with the same lanes, and publishes it as a
+    new generation with the rows unchanged. The references of the commit replaced are dropped.
+
+    \param id The SHA of the commit replaced.
+    \param commit The new commit. It must have the same parents.
+    \return True if the commit was replaced, false if it's not in the cache, it has other parents or there are
+    commits on top of it.
+   */
+   bool replaceCommit(const ObjectId &id, const CommitInfo &commit);
+   /*!
+    \brief Starts the lanes of the history again with the WIP commit on top of another commit, for instance after a
+    checkout. The lanes of the rows are calculated again as they are read.
+
+    \param wipParentSha The new parent of the WIP commit.
+   */
+   void restartLanes(const QString &wipParentSha);
+   bool isIncrementalLoad() const { return mIncrementalLoad; }
+   /*!
+    \brief Takes a read-only snapshot of the current history. See RevisionsSnapshot for what can be read from it in
+    other threads.
+
+    \return The snapshot.
+   */
+   RevisionsSnapshot snapshot() const;
+   int generation() const { return mGeneration; }
+   /*!
+    \brief Tells how the rows of a previous generation moved in the current one. It allows to update the data computed
+    per row for that generation instead of computing it again.
+
+    \param generation The previous generation.
+    \return The number of rows added on top of the history (0 if the rows didn't move, like when the history is loaded
+    incrementally) or -1 if the rows of that generation are not valid anymore.
+   */
+   int rowsShiftSince(int generation) const;
+
    int count() const;
 
    CommitInfo getCommitInfo(const QString &sha) const;
    CommitInfo getCommitInfoByRow(int row) const;
+   /*!
+    \brief Returns a handle to the commit in the given row without copying it. See CommitView for its lifetime.
+
+    \param row The row of the commit in the history.
+    \return The handle of the commit. It is not valid if the row doesn't exist.
+   */
+   CommitView getCommitViewByRow(int row) const;
+   /*!
+    \brief Returns the references of the given type that point to a commit.
+
+    \param sha The SHA of the commit.
+    \param type The type of the references.
+    \return The names of the references.
+   */
+   QStringList getReferences(const QString &sha, References::Type type) const;
    int getCommitPos(const QString &sha) const;
+   int getCommitPos(const ObjectId &id) const { return mCommitsRows.value(id, -1); }
+   /*!
+    \brief Finds the newest commit done at or before the given date. The history is in date order, so the row is
+    binary searched and then fixed up in a small window around it, since the order isn't strict.
+
+    \param secsSinceEpoch The date.
+    \return The row of the commit or the last row if all the commits are newer. -1 if the history is empty.
+   */
+   int findRowByDate(long long secsSinceEpoch) const;
+   /*!
+    \brief Returns the date of the commit in the given row without copying or building the commit.
+
+    \param row The row of the commit.
+    \return The date in seconds since epoch or 0 if the row doesn't exist.
+   */
+   long long getCommitDateByRow(int row) const;
+   /*!
+    \brief Returns the rows of the commits of an author, without the WIP. Like the dates, the rows of every author are
+    kept from the last time the rows of the history changed.
+
+    \param authorId The id of the author in the IdentityTable.
+    \return The sorted rows.
+   */
+   QVector<int> getAuthorRows(int authorId) const;
+   /*!
+    \brief Returns the rows of the commits that have references (branches or tags).
+
+    \return The sorted rows.
+   */
+   QVector<int> getReferencedRows() const;
+   /*!
+    \brief Returns the number of commits of an author.
+
+    \param authorId The id of the author in the IdentityTable.
+    \return The count.
+   */
+   int getAuthorCommitsCount(int authorId) const;
    CommitInfo getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint = 0);
    RevisionFiles getRevisionFile(const QString &sha1, const QString &sha2) const;
 
-   void insertCommitInfo(CommitInfo rev, int orderIdx);
-
    bool insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file);
+   /*!
+    \brief Keeps the files of a stash outside of the budget of the revisions files. The content of a stash never
+    changes, so they stay until the stash is dropped, see \ref retainStashRevisionFiles.
+
+    \param sha The commit of the stash.
+    \param parentSha The commit the stash is compared to.
+    \param file The files.
+   */
+   void insertStashRevisionFile(const QString &sha, const QString &parentSha, const RevisionFiles &file);
+   /*!
+    \brief Removes the files of the stashes that are not in the list anymore.
+
+    \param stashShas The commits of the stashes listed by git stash list.
+   */
+   void retainStashRevisionFiles(const QVector<QString> &stashShas);
+   /*!
+    \brief Sets the memory budget of the files cached for the pairs of commits. When it is exceeded the least recently
+    used files are removed. The files of the WIP commit are never removed.
+
+    \param megabytes The budget in MB.
+   */
+   void setRevisionFilesBudget(int megabytes);
+   /*!
+    \brief The approximate memory used by the cache, in bytes.
+   */
+   struct MemoryUsage
+   {
+      qint64 commits = 0;
+      qint64 lanes = 0;
+      qint64 revisionFiles = 0;
+      qint64 indexes = 0;
+
+      qint64 total() const { return commits + lanes + revisionFiles + indexes; }
+   };
+   /*!
+    \brief Returns an approximation of the memory used by the cache.
+
+    \return The memory used by the commits, the lanes, the files cached for the pairs of commits and the indexes.
+   */
+   MemoryUsage memoryUsage() const;
+   /*!
+    \brief Returns the memory held by every structure of the cache, with the capacity of its strings and containers.
+    The paths are counted once, in the table shared by the repositories of the group.
+
+    \return The report, in the order the structures are declared.
+   */
+   MemoryReport memoryReport() const;
+   /*!
+    \brief Frees the memory that is rebuilt when it's needed again: the files cached for the pairs of commits, also for
+    the work trees that share them, and the indexes built from the commits. The commits, the lanes and the files of
+    the WIP commit are kept. Nothing is freed while the history is being loaded.
+
+    \return True if the cache was compacted, otherwise false.
+   */
+   bool compact();
+   /*!
+    \brief Sets the table that stores the paths of the files. The caches of a superproject and its submodules share
+    it, see PathTable::forRepositoryGroup.
+
+    \param table The table.
+   */
+   void setPathTable(const QSharedPointer<PathTable> &table) { mPathTable = table; }
+   /*!
+    \brief Sets the store of the files changed between two commits. The caches of the work trees of a repository share
+    it, see RevisionFilesStore::forRepository.
+
+    \param store The store.
+   */
+   void setRevisionFilesStore(const QSharedPointer<RevisionFilesStore> &store) { mRevisionFilesStore = store; }
+   int revisionFilesHits() const { return mRevisionFilesHits; }
+   int revisionFilesMisses() const { return mRevisionFilesMisses; }
    void insertReference(const QString &sha, References::Type type, const QString &reference);
+   /*!
+    \brief Removes a reference from a commit. The commit stops being referenced when it has no references left.
+
+    \param sha The commit the reference points to.
+    \param type The type of the reference.
+    \param reference The name of the reference.
+   */
+   void removeReference(const QString &sha, References::Type type, const QString &reference);
    void insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances);
    LocalBranchDistances getLocalBranchDistances(const QString &name) { return mLocalBranchDistances.value(name); }
-   void updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache);
+   /*!
+    \brief Calculates how many commits every commit has that the base doesn't (ahead) and the other way round (behind),
+    walking the history loaded. All the commits are walked at the same time.
+
+    \param baseSha The commit the distances are calculated to, for instance master.
+    \param shas The commits, for instance the local branches.
+    \return The pairs of ahead and behind, in the order of the commits. A pair is -1, -1 when the history loaded
+    doesn't have all the commits needed.
+   */
+   QVector<QPair<int, int>> getDistances(const QString &baseSha, const QStringList &shas) const;
+   /*!
+    \brief The commits of a range between two commits, as rows of the cache.
+   */
+   struct CommitRange
+   {
+      // The bit of every row in the range.
+      QBitArray rows;
+      // The commits reachable only from the first commit (the ones A..B hides) and only from the second one.
+      int fromOnly = 0;
+      int toOnly = 0;
+      // False if a commit or a parent needed isn't loaded: the range has only the commits found.
+      bool complete = false;
+   };
+   /*!
+    \brief Calculates the commits of a range in the history loaded, without asking git. The parents are followed by
+    their rows and the rows work as generation numbers, so the walk stops as soon as the rest of the history is common.
+
+    \param fromSha The first commit, A in A..B.
+    \param toSha The second commit, B in A..B.
+    \param symmetric False for A..B (the commits reachable from B but not from A), true for A...B (the commits
+    reachable from only one of them). The counts of both sides are calculated anyway.
+    \return The range. It's empty and not complete if one of the commits isn't loaded.
+   */
+   CommitRange getCommitRange(const QString &fromSha, const QString &toSha, bool symmetric) const;
+   /*!
+    \brief The references that contain a commit, like git branch --contains and git tag --contains.
+   */
+   struct ContainingReferences
+   {
+      QStringList localBranches;
+      QStringList remoteBranches;
+      QStringList tags;
+      // False if the walk reached its limit before all the references were checked.
+      bool complete = false;
+   };
+   /*!
+    \brief Finds the branches and tags that contain a commit in the history loaded, without asking git. Only the
+    references in rows above the commit can reach it, so only the rows between the highest of them and the commit are
+    walked, each once. The results are memoized per commit until the history or the references change.
+
+    \param sha The commit.
+    \param maxRows The maximum number of rows walked, or -1 to walk all the rows needed. The references above the limit
+    aren't checked and the result isn't memoized.
+    \return The references, sorted by name. The references of the commits that aren't loaded aren't considered.
+   */
+   ContainingReferences getContainingReferences(const QString &sha, int maxRows = -1) const;
+   /*!
+    \brief Updates the WIP commit with the state of the work tree.
+
+    \param parentSha The commit HEAD points to.
+    \param status The output of git status --porcelain=v2 -z --no-renames.
+    \param keepUntracked True if the status doesn't list the untracked files and the WIP keeps the ones it had until
+    \ref updateWipUntrackedFiles, otherwise false.
+   */
+   void updateWipCommit(const QString &parentSha, const QByteArray &status, bool keepUntracked = false);
+   /*!
+    \brief Replaces the untracked files of the WIP commit. Only the first ones up to the maximum set with
+    \ref setMaxUntrackedFiles are kept, the rest are only counted.
+
+    \param parentSha The commit HEAD points to.
+    \param files The output of git ls-files --others -z.
+    \return False if there is no WIP commit for the parent or the untracked files didn't change.
+   */
+   bool updateWipUntrackedFiles(const QString &parentSha, const QByteArray &files);
+   /*!
+    \brief Sets the maximum number of untracked files in the WIP commit.
+
+    \param maxFiles The maximum number of files.
+   */
+   void setMaxUntrackedFiles(int maxFiles) { mMaxUntrackedFiles = qMax(maxFiles, 0); }
+   /*!
+    \brief Returns the number of untracked files left out of the WIP commit because of the maximum.
+
+    \return int The number of files.
+   */
+   int getHiddenUntrackedFiles() const { return mHiddenUntrackedFiles; }
+   /*!
+    \brief Updates only some paths of the WIP commit. The files outside them keep the status they had.
+
+    \param parentSha The commit HEAD points to.
+    \param paths The files or directories updated, relative to the root of the repository.
+    \param status The output of git status, like in \ref updateWipCommit, limited to the paths.
+    \return False if there is no WIP commit for the parent to update, or if some untracked files are left out of the
+    list: the whole WIP commit must be updated then.
+   */
+   bool patchWipCommit(const QString &parentSha, const QStringList &paths, const QByteArray &status);
 
    void removeReference(const QString &sha);
 
    bool containsRevisionFile(const QString &sha1, const QString &sha2) const;
 
    RevisionFiles parseDiff(const QString &logDiff);
+   /*!
+    \brief Parses in a single pass the output of a batched git diff-tree, see GitHistory::diffFilesBatchArguments.
+    The paths are interned like in \ref parseDiff.
+
+    \param output The output of git, with a line with the commit before the files of every diff.
+    \return The commits and their files, in the order of the output.
+   */
+   QVector<QPair<QString, RevisionFiles>> parseDiffs(const QString &output);
+   /*!
+    \brief Returns the shared copy of a path. The same paths appear in many places, so they all share the data of a
+    single copy.
+
+    \param path The path relative to the root of the repository.
+    \return The shared copy.
+   */
+   QString internPath(const QString &path);
 
-   void setUntrackedFilesList(const QVector<QString> &untrackedFiles);
    bool pendingLocalChanges() const;
 
    QVector<QPair<QString, QStringList>> getBranches(References::Type type) const;
@@ -85,16 +409,58 @@ public:
    QString getCommitForBranch(const QString &branch, bool local = true) const;
 
 private:
+   static constexpr int DEFAULT_REVISION_FILES_BUDGET_MB = 64;
+   static constexpr int MAX_CONTAINING_MEMO = 256;
+
    bool mCacheLocked = true;
+   bool mIncrementalLoad = false;
+   bool mDeltaLoad = false;
+   int mGeneration = 0;
+   int mLastPublishShift = -1;
    QVector<CommitInfo *> mCommits;
-   QHash<QString, CommitInfo *> mCommitsMap;
-   QHash<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
+   QVector<QSharedPointer<RevisionsSnapshot::Storage>> mStorages;
+   QHash<ObjectId, CommitInfo *> mCommitsMap;
+   QHash<ObjectId, int> mCommitsRows;
+   QVector<CommitInfo *> mPendingCommits;
+   QHash<ObjectId, CommitInfo *> mPendingCommitsMap;
+   mutable QVector<CommitInfo *> mSortedCommits;
+   mutable bool mSortedCommitsDirty = true;
+   mutable QVector<long long> mCommitDates;
+   mutable QHash<int, QVector<int>> mAuthorRows;
+   // The rows of the parents of every row, from mParentRowsBegin[row] to mParentRowsBegin[row + 1]. -1 is a parent
+   // that isn't loaded.
+   mutable QVector<int> mParentRowsBegin;
+   mutable QVector<int> mParentRows;
+   mutable QCache<ObjectId, ContainingReferences> mContainingMemo { MAX_CONTAINING_MEMO };
+   mutable bool mRowColumnsDirty = true;
+   mutable Lanes mLanes;
+   mutable int mLanesRow = 1;
+   mutable QSet<QVector<Lane>> mLaneRows;
+   Lanes mPendingLanes;
+   Lanes mDeltaLanes;
+   Lanes mDeltaExpectedLanes;
+   bool mDeltaLanesChanged = false;
+   // The parents of the WIP the lanes are calculated from. An empty id is an origin that is not known.
+   ObjectId mLanesOrigin;
+   ObjectId mPendingLanesOrigin;
+   QSharedPointer<RevisionFilesStore> mRevisionFilesStore { new RevisionFilesStore(DEFAULT_REVISION_FILES_BUDGET_MB) };
+   QHash<QPair<ObjectId, ObjectId>, RevisionFiles> mWipRevisionFiles;
+   QHash<QPair<ObjectId, ObjectId>, RevisionFiles> mStashRevisionFiles;
+   mutable int mRevisionFilesHits = 0;
+   mutable int mRevisionFilesMisses = 0;
    QVector<CommitInfo *> mReferences;
+   // The references of the commits, that only keep a flag to tell they have some.
+   QHash<ObjectId, References> mCommitReferences;
+   QSet<CommitInfo *> mReferencedCommits;
+   mutable bool mReferencesIndexDirty = true;
+   mutable QHash<QString, ObjectId> mLocalBranchesIndex;
+   mutable QHash<QString, ObjectId> mRemoteBranchesIndex;
+   mutable QMap<References::Type, QVector<QPair<QString, QStringList>>> mReferencesSnapshots;
    QMap<QString, LocalBranchDistances> mLocalBranchDistances;
-   Lanes mLanes;
-   QVector<QString> mDirNames;
-   QVector<QString> mFileNames;
+   QSharedPointer<PathTable> mPathTable { new PathTable() };
    QVector<QString> mUntrackedfiles;
+   int mMaxUntrackedFiles = 10000;
+   int mHiddenUntrackedFiles = 0;
 
    struct FileNamesLoader
    {
@@ -104,18 +470,25 @@ private:
       }
 
       RevisionFiles *rf;
-      QVector<int> rfDirs;
-      QVector<int> rfNames;
+      QVector<QString> rfPaths;
       QVector<QString> files;
    };
 
-   RevisionFiles fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache);
-   QVector<Lane> calculateLanes(const CommitInfo &c);
+   CommitInfo *findCommitByPrefix(const QString &prefix) const;
+   void calculateLanes(int row) const;
+   void convergeDeltaLanes(int firstRow);
+   bool pendingKeepsLoadedRows() const;
+   void buildRowColumns() const;
+   void buildReferencesIndex() const;
+   void walkDistances(int baseRow, const QVector<int> &rows, int first, int last,
+                      QVector<QPair<int, int>> &distances) const;
+   RevisionFiles parseWipStatus(const QByteArray &status, QVector<QString> &untrackedFiles);
+   QVector<QString> appendUntrackedFiles(RevisionFiles &rf, const QVector<QString> &files, int &hiddenFiles);
+   void setWipCommit(const QString &parentSha, const RevisionFiles &fakeRevFile);
    RevisionFiles parseDiffFormat(const QString &buf, FileNamesLoader &fl);
    void appendFileName(const QString &name, FileNamesLoader &fl);
    void flushFileNames(FileNamesLoader &fl);
    void setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl);
    QVector<CommitInfo *>::const_iterator searchCommit(CommitInfo::Field field, const QString &text,
                                                       int startingPoint = 0) const;
-   void resetLanes(const CommitInfo &c, bool isFork);
 };
@@ -0,0 +1,103 @@
+#include "RevisionsDiskCache.h"
+
+#include <CommitInfo.h>
+
+#include <QLogger.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+using namespace QLogger;
+
+namespace
+{
+const quint32 kMagic = 0x47514843; // GQHC
+}
+
+RevisionsDiskCache::RevisionsDiskCache(const QString &filePath)
+   : mFilePath(filePath)
+{
+}
+
+bool RevisionsDiskCache::load(const QByteArray &key, QVector<CommitInfo *> &commits) const
+{
+   QFile file(mFilePath);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   const auto size = file.size();
+   const auto mapped = file.map(0, size);
+
+   if (!mapped)
+      return false;
+
+   const auto data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), static_cast<int>(size));
+   QDataStream in(data);
+   in.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic = 0;
+   quint32 version = 0;
+   QByteArray storedKey;
+   qint32 count = 0;
+
+   in >> magic >> version >> storedKey >> count;
+
+   auto loaded = false;
+
+   if (in.status() != QDataStream::Ok || magic != kMagic || version != VERSION)
+      QLog_Info("Git", QString("The history cache file {%1} is not valid.").arg(mFilePath));
+   else if (storedKey != key)
+      QLog_Info("Git", QString("The history cache is outdated."));
+   else
+   {
+      const auto initialCount = commits.count();
+      commits.reserve(initialCount + count);
+
+      for (auto i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+      {
+         const auto commit = new CommitInfo();
+         in >> *commit;
+         commits.append(commit);
+      }
+
+      loaded = in.status() == QDataStream::Ok;
+
+      if (loaded)
+         QLog_Debug("Git", QString("Loaded {%1} commits from the history cache.").arg(count));
+      else
+      {
+         QLog_Warning("Git", QString("The history cache file {%1} is corrupted.").arg(mFilePath));
+
+         qDeleteAll(commits.begin() + initialCount, commits.end());
+         commits.resize(initialCount);
+      }
+   }
+
+   file.unmap(mapped);
+
+   return loaded;
+}
+
+bool RevisionsDiskCache::save(const QByteArray &key, int commitsCount, const QByteArray &data) const
+{
+   QDir().mkpath(QFileInfo(mFilePath).absolutePath());
+
+   QSaveFile file(mFilePath);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Git", QString("The history cache file {%1} can't be written.").arg(mFilePath));
+      return false;
+   }
+
+   QDataStream out(&file);
+   out.setVersion(QDataStream::Qt_5_9);
+   out << kMagic << VERSION << key << static_cast<qint32>(commitsCount);
+
+   file.write(data);
+
+   return file.commit();
+}
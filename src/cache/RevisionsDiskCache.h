@@ -0,0 +1,78 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+
+class CommitInfo;
+
+/*!
+ \brief The RevisionsDiskCache stores the history of a repository in a file so it can be loaded without running git log
+ when the repository is opened again. The file contains the parsed commits together with their lanes and it is
+ identified by a key built from the tips of the references. If the key doesn't match, the file is ignored and it is
+ overwritten with the new history once is loaded.
+
+ The file is memory mapped when it is read, so the commits are built directly from the mapped data.
+
+ \class RevisionsDiskCache RevisionsDiskCache.h "RevisionsDiskCache.h"
+*/
+class RevisionsDiskCache
+{
+public:
+   /*!
+    \brief Default constructor.
+
+    \param filePath The full path of the cache file.
+   */
+   explicit RevisionsDiskCache(const QString &filePath);
+
+   /*!
+    \brief Loads the commits stored in the cache file.
+
+    \param key The key that identifies the history that is expected.
+    \param commits The vector where the commits are appended. The caller takes the ownership.
+    \return True if the file exists, it is valid and its key matches, otherwise false.
+   */
+   bool load(const QByteArray &key, QVector<CommitInfo *> &commits) const;
+   /*!
+    \brief Writes the cache file. The previous file is only replaced when the new one has been completely written.
+
+    \param key The key that identifies the history.
+    \param commitsCount The number of commits stored in the data.
+    \param data The commits serialized with the QDataStream operators of CommitInfo.
+    \return True if the file was written, otherwise false.
+   */
+   bool save(const QByteArray &key, int commitsCount, const QByteArray &data) const;
+
+   /*!
+    \brief The version of the file format. It changes with the data of the commits as well: the version 3 has the long
+    logs parsed from the fields of GitRepoLoader::GIT_LOG_FORMAT, without the trailing space of the line format.
+   */
+   static constexpr quint32 VERSION = 3;
+
+private:
+   QString mFilePath;
+};
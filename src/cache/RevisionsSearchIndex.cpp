@@ -0,0 +1,189 @@
+#include "RevisionsSearchIndex.h"
+
+#include <RevisionsCache.h>
+#include <RevisionsSnapshot.h>
+#include <IdentityTable.h>
+
+#include <QLogger.h>
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+namespace
+{
+quint64 trigram(const QChar *text)
+{
+   return (static_cast<quint64>(text[0].unicode()) << 32) | (static_cast<quint64>(text[1].unicode()) << 16)
+       | text[2].unicode();
+}
+
+QVector<quint64> trigrams(const QString &text)
+{
+   QVector<quint64> keys;
+
+   if (text.size() < 3)
+      return keys;
+
+   keys.reserve(text.size() - 2);
+
+   for (auto i = 0; i + 2 < text.size(); ++i)
+      keys.append(trigram(text.constData() + i));
+
+   std::sort(keys.begin(), keys.end());
+   keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+   return keys;
+}
+}
+
+RevisionsSearchIndex::RevisionsSearchIndex(const QSharedPointer<RevisionsCache> &cache, QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+   , mWorker(new WorkerQueue(mCache.data(), WorkerPool::Priority::Background))
+{
+}
+
+RevisionsSearchIndex::~RevisionsSearchIndex()
+{
+   // The build in progress, if any, stops at the next check.
+   mRequest.fetchAndAddOrdered(1);
+
+   mWorker.reset();
+}
+
+void RevisionsSearchIndex::rebuild()
+{
+   const auto request = mRequest.fetchAndAddOrdered(1) + 1;
+   const auto snapshot = QSharedPointer<RevisionsSnapshot>::create(mCache->snapshot());
+
+   mData.reset();
+
+   mWorker->post([this, request, snapshot]() {
+      const auto data = build(request, snapshot);
+
+      if (data)
+      {
+         QMetaObject::invokeMethod(
+             this,
+             [this, request, data]() {
+                if (request == mRequest.loadAcquire())
+                   mData = data;
+             },
+             Qt::QueuedConnection);
+      }
+   });
+}
+
+QSharedPointer<const RevisionsSearchIndex::Data>
+RevisionsSearchIndex::build(int request, const QSharedPointer<RevisionsSnapshot> &snapshot) const
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   const auto data = QSharedPointer<Data>::create();
+   data->generation = snapshot->generation();
+   data->snapshot = snapshot;
+
+   // The rows are visited in order so every posting list is sorted without any extra step.
+   for (auto row = 1; row < snapshot->count(); ++row)
+   {
+      if (row % 4096 == 0 && request != mRequest.loadAcquire())
+         return {};
+
+      const auto commit = snapshot->commit(row);
+
+      if (!commit)
+         continue;
+
+      for (const auto key : trigrams(commit->shortLog()))
+         data->shortLogTrigrams[key].append(row);
+
+      data->authorRows[commit->authorId()].append(row);
+   }
+
+   QLog_Debug("Git",
+              QString("Search index with {%1} trigrams built in {%2} ms.")
+                  .arg(QString::number(data->shortLogTrigrams.count()), QString::number(timer.elapsed())));
+
+   return data;
+}
+
+int RevisionsSearchIndex::findRow(CommitInfo::Field field, const QString &text, int startingRow) const
+{
+   if (!mData || mData->generation != mCache->generation())
+      return NOT_READY;
+
+   QVector<int> candidates;
+
+   if (field == CommitInfo::Field::SHORT_LOG && text.size() >= 3)
+      candidates = findShortLogCandidates(text);
+   else if (field == CommitInfo::Field::AUTHOR)
+      candidates = findAuthorCandidates(text);
+   else
+      return NOT_READY;
+
+   // The trigrams only tell which commits might match: the text is checked in them from the starting row and then
+   // from the beginning.
+   const auto start = std::lower_bound(candidates.cbegin(), candidates.cend(), startingRow);
+   const auto matches = [this, field, &text](int row) {
+      const auto commit = mData->snapshot->commit(row);
+      return commit && (field != CommitInfo::Field::SHORT_LOG || commit->shortLog().contains(text));
+   };
+
+   if (const auto it = std::find_if(start, candidates.cend(), matches); it != candidates.cend())
+      return *it;
+
+   const auto it = std::find_if(candidates.cbegin(), start, matches);
+
+   return it != start ? *it : -1;
+}
+
+QVector<int> RevisionsSearchIndex::findShortLogCandidates(const QString &text) const
+{
+   QVector<const QVector<int> *> postings;
+
+   for (const auto key : trigrams(text))
+   {
+      const auto it = mData->shortLogTrigrams.constFind(key);
+
+      if (it == mData->shortLogTrigrams.constEnd())
+         return {};
+
+      postings.append(&it.value());
+   }
+
+   // Intersecting from the shortest list keeps the intermediate results small.
+   std::sort(postings.begin(), postings.end(),
+             [](const QVector<int> *a, const QVector<int> *b) { return a->count() < b->count(); });
+
+   auto candidates = *postings.constFirst();
+
+   for (auto i = 1; i < postings.count() && !candidates.isEmpty(); ++i)
+   {
+      QVector<int> intersection;
+      std::set_intersection(candidates.cbegin(), candidates.cend(), postings.at(i)->cbegin(), postings.at(i)->cend(),
+                            std::back_inserter(intersection));
+      candidates = std::move(intersection);
+   }
+
+   return candidates;
+}
+
+QVector<int> RevisionsSearchIndex::findAuthorCandidates(const QString &text) const
+{
+   const auto identities = IdentityTable::matching(text);
+   QVector<int> candidates;
+
+   for (auto it = mData->authorRows.cbegin(); it != mData->authorRows.cend(); ++it)
+   {
+      if (identities.value(it.key(), false))
+         candidates.append(it.value());
+   }
+
+   std::sort(candidates.begin(), candidates.end());
+
+   return candidates;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <WorkerPool.h>
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QAtomicInt>
+
+class RevisionsCache;
+class RevisionsSnapshot;
+
+/*!
+ \brief The RevisionsSearchIndex builds, in a worker thread, an inverted index of the history once it has been loaded.
+ The short logs are indexed by trigrams and the authors by identity, so the searches of the history widget are answered
+ from the posting lists instead of scanning every commit.
+
+ The index is tied to the generation of the cache it was built from. While it is being built, or if the cache has
+ published a new generation since, the searches return NOT_READY and the caller must fall back to the cache.
+
+ \class RevisionsSearchIndex RevisionsSearchIndex.h "RevisionsSearchIndex.h"
+*/
+class RevisionsSearchIndex : public QObject
+{
+   Q_OBJECT
+
+public:
+   static constexpr int NOT_READY = -2;
+
+   explicit RevisionsSearchIndex(const QSharedPointer<RevisionsCache> &cache, QObject *parent = nullptr);
+   ~RevisionsSearchIndex();
+
+   /*!
+    \brief Starts building the index of the current history of the cache. The index being built, if any, is discarded.
+   */
+   void rebuild();
+   /*!
+    \brief Finds the first row, starting from \p startingRow, whose field contains the text. If there is no match
+    until the end of the history, the search continues from the beginning.
+
+    \param field The field to search in. Only the short log and the author are indexed.
+    \param text The text to search. The short log is only indexed for texts of three or more characters.
+    \param startingRow The first row to check.
+    \return The row, -1 if no commit matches or NOT_READY if the index can't answer the search.
+   */
+   int findRow(CommitInfo::Field field, const QString &text, int startingRow = 0) const;
+
+private:
+   struct Data
+   {
+      int generation = -1;
+      QSharedPointer<RevisionsSnapshot> snapshot;
+      QHash<quint64, QVector<int>> shortLogTrigrams;
+      QHash<int, QVector<int>> authorRows;
+   };
+
+   QSharedPointer<RevisionsCache> mCache;
+   QScopedPointer<WorkerQueue> mWorker;
+   QAtomicInt mRequest = 0;
+   QSharedPointer<const Data> mData;
+
+   QSharedPointer<const Data> build(int request, const QSharedPointer<RevisionsSnapshot> &snapshot) const;
+   QVector<int> findShortLogCandidates(const QString &text) const;
+   QVector<int> findAuthorCandidates(const QString &text) const;
+};
@@ -0,0 +1,129 @@
+#include "RevisionsSearcher.h"
+
+#include <CommitInfo.h>
+#include <RevisionsSnapshot.h>
+
+#include <algorithm>
+
+RevisionsSearcher::RevisionsSearcher(const void *repository, QObject *parent)
+   : QObject(parent)
+   , mWorker(new WorkerQueue(repository, WorkerPool::Priority::Interactive, true))
+{
+}
+
+RevisionsSearcher::~RevisionsSearcher()
+{
+   cancel();
+
+   // The chunks that didn't start are discarded.
+   mWorker.reset();
+}
+
+void RevisionsSearcher::search(const RevisionsSnapshot &snapshot, const Predicate &predicate,
+                               int startingRow)
+{
+   cancel();
+
+   const auto search = ++mSearch;
+   const auto cancelled = QSharedPointer<QAtomicInt>::create(0);
+   const auto chunks = (snapshot.count() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+   mCancelled = cancelled;
+   mGeneration = snapshot.generation();
+   mStartingRow = startingRow;
+   mNextMatchNotified = false;
+   mMatchesCount = 0;
+   mPendingChunks = chunks;
+   mChunksDone = QVector<bool>(chunks, false);
+   mChunksMatches = QVector<QVector<int>>(chunks);
+
+   if (chunks == 0)
+   {
+      emit signalNextMatch(mGeneration, -1);
+      emit signalMatchesFound(0, true);
+      return;
+   }
+
+   for (auto chunk = 0; chunk < chunks; ++chunk)
+   {
+      mWorker->post([this, search, chunk, snapshot, predicate, cancelled]() {
+         QVector<int> matches;
+         const auto end = std::min((chunk + 1) * CHUNK_SIZE, snapshot.count());
+
+         for (auto row = chunk * CHUNK_SIZE; row < end; ++row)
+         {
+            if (row % 1024 == 0 && cancelled->loadAcquire())
+               return;
+
+            if (const auto commit = snapshot.commit(row); commit && predicate(*commit))
+               matches.append(row);
+         }
+
+         QMetaObject::invokeMethod(
+             this, [this, search, chunk, matches]() { onChunkScanned(search, chunk, matches); },
+             Qt::QueuedConnection);
+      });
+   }
+}
+
+void RevisionsSearcher::cancel()
+{
+   if (mCancelled)
+      mCancelled->storeRelease(1);
+
+   mCancelled.reset();
+   mPendingChunks = 0;
+}
+
+void RevisionsSearcher::onChunkScanned(int search, int chunk, const QVector<int> &matches)
+{
+   if (search != mSearch || mPendingChunks == 0)
+      return;
+
+   mChunksDone[chunk] = true;
+   mChunksMatches[chunk] = matches;
+   mMatchesCount += matches.count();
+   --mPendingChunks;
+
+   notifyNextMatch();
+
+   emit signalMatchesFound(mMatchesCount, mPendingChunks == 0);
+
+   if (mPendingChunks == 0)
+      mCancelled.reset();
+}
+
+void RevisionsSearcher::notifyNextMatch()
+{
+   if (mNextMatchNotified)
+      return;
+
+   // The chunks finish in any order: the next match is known once all the chunks from the starting row up to the
+   // first one with a match have been scanned.
+   const auto chunks = mChunksDone.count();
+   const auto startingChunk = std::min(mStartingRow / CHUNK_SIZE, chunks - 1);
+
+   for (auto i = 0; i <= chunks; ++i)
+   {
+      const auto chunk = (startingChunk + i) % chunks;
+
+      if (!mChunksDone.at(chunk))
+         return;
+
+      // The starting chunk is checked twice: first from the starting row and, after wrapping, before it.
+      for (const auto row : qAsConst(mChunksMatches[chunk]))
+      {
+         const auto afterStart = row >= mStartingRow;
+
+         if ((i == 0 && afterStart) || (i == chunks && !afterStart) || (i > 0 && i < chunks))
+         {
+            mNextMatchNotified = true;
+            emit signalNextMatch(mGeneration, row);
+            return;
+         }
+      }
+   }
+
+   mNextMatchNotified = true;
+   emit signalNextMatch(mGeneration, -1);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <WorkerPool.h>
+
+#include <QObject>
+#include <QVector>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QAtomicInt>
+
+#include <functional>
+
+class CommitInfo;
+class RevisionsSnapshot;
+
+/*!
+ \brief The RevisionsSearcher scans a snapshot of the history in parallel, for the searches the RevisionsSearchIndex
+ can't answer (e.g. regular expressions). The history is split in chunks that are scanned by the WorkerPool, with the
+ interactive priority, and the matches are notified while the chunks finish, so the GUI thread never runs the scan.
+
+ Starting a new search cancels the previous one.
+
+ \class RevisionsSearcher RevisionsSearcher.h "RevisionsSearcher.h"
+*/
+class RevisionsSearcher : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the first match from the starting row is known. It doesn't wait for the rest of the
+    history to be scanned.
+
+    \param generation The generation of the cache the snapshot was taken from.
+    \param row The row of the match or -1 if no commit matches.
+   */
+   void signalNextMatch(int generation, int row);
+   /*!
+    \brief Signal triggered every time a chunk of the history has been scanned.
+
+    \param matches The total of matches found so far.
+    \param finished True when all the history has been scanned.
+   */
+   void signalMatchesFound(int matches, bool finished);
+
+public:
+   using Predicate = std::function<bool(const CommitInfo &)>;
+
+   /*!
+    \brief Default constructor.
+
+    \param repository The repository the searches belong to, identified by its RevisionsCache.
+    \param parent The parent object if needed.
+   */
+   explicit RevisionsSearcher(const void *repository, QObject *parent = nullptr);
+   ~RevisionsSearcher();
+
+   /*!
+    \brief Starts a search in the snapshot. The predicate is called from several threads at the same time, so it must
+    only read the data of the commit.
+
+    \param snapshot The snapshot of the history to search in.
+    \param predicate The condition the commits must fulfil.
+    \param startingRow The row the next match is looked for from. The search continues from the beginning if there is
+    no match after it.
+   */
+   void search(const RevisionsSnapshot &snapshot, const Predicate &predicate, int startingRow);
+   /*!
+    \brief Cancels the search in progress, if any.
+   */
+   void cancel();
+
+private:
+   static constexpr int CHUNK_SIZE = 16384;
+
+   QScopedPointer<WorkerQueue> mWorker;
+   QSharedPointer<QAtomicInt> mCancelled;
+   int mSearch = 0;
+   int mGeneration = -1;
+   int mStartingRow = 0;
+   bool mNextMatchNotified = false;
+   int mMatchesCount = 0;
+   int mPendingChunks = 0;
+   QVector<bool> mChunksDone;
+   QVector<QVector<int>> mChunksMatches;
+
+   void onChunkScanned(int search, int chunk, const QVector<int> &matches);
+   void notifyNextMatch();
+};
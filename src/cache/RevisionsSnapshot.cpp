@@ -0,0 +1,8 @@
+#include "RevisionsSnapshot.h"
+
+#include <CommitInfo.h>
+
+RevisionsSnapshot::Storage::~Storage()
+{
+   qDeleteAll(commits);
+}
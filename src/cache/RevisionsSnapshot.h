@@ -0,0 +1,78 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QVector>
+#include <QSharedPointer>
+
+class CommitInfo;
+
+/*!
+ \brief The RevisionsSnapshot class is a read-only handle to the history of the RevisionsCache as it was when the
+ snapshot was taken. The commits it points to are kept alive until the last snapshot that uses them is destroyed, even
+ if the cache publishes a new generation in the meanwhile. That allows to read the history from another thread (e.g. to
+ search in it) without blocking the loader or the UI.
+
+ Only the data parsed from git (SHA, parents, author, committer, date and logs) can be read from another thread: the
+ lanes and the references of the commits are updated by the cache in the GUI thread. The WIP commit is not part of the
+ snapshot since it's replaced every time the working directory changes.
+
+ \class RevisionsSnapshot RevisionsSnapshot.h "RevisionsSnapshot.h"
+*/
+class RevisionsSnapshot
+{
+public:
+   /*!
+    \brief The Storage owns the commits of a generation. They are deleted when the storage is released by the cache and
+    by all the snapshots.
+   */
+   struct Storage
+   {
+      QVector<CommitInfo *> commits;
+
+      ~Storage();
+   };
+
+   RevisionsSnapshot() = default;
+
+   /*!
+    \brief Returns the number of the generation of the cache the snapshot was taken from.
+   */
+   int generation() const { return mGeneration; }
+   /*!
+    \brief Returns the number of rows of the snapshot, including the row of the WIP commit.
+   */
+   int count() const { return mCommits.count(); }
+   /*!
+    \brief Returns the commit in the given row. The row 0 (WIP) and the rows out of range return nullptr.
+   */
+   const CommitInfo *commit(int row) const { return row > 0 && row < mCommits.count() ? mCommits.at(row) : nullptr; }
+
+private:
+   friend class RevisionsCache;
+
+   int mGeneration = 0;
+   QVector<CommitInfo *> mCommits;
+   QVector<QSharedPointer<Storage>> mStorages;
+};
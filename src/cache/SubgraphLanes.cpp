@@ -0,0 +1,178 @@
+#include "SubgraphLanes.h"
+
+#include <CommitInfo.h>
+#include <RevisionsCache.h>
+#include <RevisionsSnapshot.h>
+#include <lanes.h>
+
+#include <QLogger.h>
+
+#include <QElapsedTimer>
+#include <QHash>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+namespace
+{
+/*!
+ \brief A commit shown that waits for its rewritten parents: the index of the commit in the rows shown, and the
+ position of the original parent the path comes from, so the rewritten parents keep the order of the original ones.
+*/
+struct Waiting
+{
+   int index;
+   int rank;
+};
+
+void addWaiting(QVector<Waiting> &waiting, const Waiting &item)
+{
+   // The paths that meet again are only kept once, by the lowest rank.
+   for (auto &other : waiting)
+   {
+      if (other.index == item.index)
+      {
+         other.rank = std::min(other.rank, item.rank);
+         return;
+      }
+   }
+
+   waiting.append(item);
+}
+}
+
+SubgraphLanes::SubgraphLanes(const QSharedPointer<RevisionsCache> &cache, QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+   , mWorker(new WorkerQueue(mCache.data(), WorkerPool::Priority::Interactive))
+{
+}
+
+SubgraphLanes::~SubgraphLanes()
+{
+   // The calculation in progress, if any, stops at the next check.
+   mRequest.fetchAndAddOrdered(1);
+
+   mWorker.reset();
+}
+
+void SubgraphLanes::rebuild(const QVector<int> &rows)
+{
+   const auto request = mRequest.fetchAndAddOrdered(1) + 1;
+   const auto snapshot = QSharedPointer<RevisionsSnapshot>::create(mCache->snapshot());
+
+   mLanes.clear();
+
+   if (rows.isEmpty())
+      return;
+
+   mWorker->post([this, request, snapshot, rows]() {
+      const auto lanes = calculate(request, *snapshot, rows);
+
+      if (!lanes.isEmpty())
+      {
+         QMetaObject::invokeMethod(
+             this,
+             [this, request, lanes]() {
+                if (request == mRequest.loadAcquire())
+                {
+                   mLanes = lanes;
+                   emit signalLanesReady();
+                }
+             },
+             Qt::QueuedConnection);
+      }
+   });
+}
+
+void SubgraphLanes::clear()
+{
+   mRequest.fetchAndAddOrdered(1);
+   mLanes.clear();
+}
+
+QVector<QVector<Lane>> SubgraphLanes::calculate(int request, const RevisionsSnapshot &snapshot,
+                                                const QVector<int> &rows) const
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   const auto count = rows.count();
+   QVector<QVector<Waiting>> parents(count);
+   QHash<ObjectId, QVector<Waiting>> pending;
+   auto next = 0;
+
+   // The children come before their parents, so a single pass takes every path from a commit shown down to the
+   // commits shown it reaches first. Only the commits at the front of those paths are kept pending.
+   for (auto row = rows.constFirst(); row < snapshot.count() && (next < count || !pending.isEmpty()); ++row)
+   {
+      if (row % 4096 == 0 && request != mRequest.loadAcquire())
+         return {};
+
+      const auto isShown = next < count && rows.at(next) == row;
+      const auto commit = snapshot.commit(row);
+
+      if (!commit)
+      {
+         next += isShown ? 1 : 0;
+         continue;
+      }
+
+      const auto waiting = pending.take(commit->id());
+      const auto commitParents = commit->parentIds();
+
+      if (isShown)
+      {
+         for (const auto &item : waiting)
+            addWaiting(parents[item.index], { next, item.rank });
+
+         for (auto i = 0; i < commitParents.count(); ++i)
+            addWaiting(pending[commitParents.at(i)], { next, i });
+
+         ++next;
+      }
+      else if (!waiting.isEmpty())
+      {
+         for (const auto &parent : commitParents)
+         {
+            auto &parentWaiting = pending[parent];
+
+            for (const auto &item : waiting)
+               addWaiting(parentWaiting, item);
+         }
+      }
+   }
+
+   QVector<QVector<Lane>> result(count);
+   Lanes lanes;
+
+   for (auto i = 0; i < count; ++i)
+   {
+      const auto commit = snapshot.commit(rows.at(i));
+
+      if (!commit)
+         continue;
+
+      if (lanes.isEmpty())
+         lanes.init(commit->id());
+
+      auto &commitParents = parents[i];
+      std::stable_sort(commitParents.begin(), commitParents.end(),
+                       [](const Waiting &a, const Waiting &b) { return a.rank < b.rank; });
+
+      QVector<ObjectId> parentIds;
+      parentIds.reserve(commitParents.count());
+
+      for (const auto &parent : qAsConst(commitParents))
+         parentIds.append(snapshot.commit(rows.at(parent.index))->id());
+
+      result[i] = lanes.calculateLanes(commit->id(), parentIds);
+   }
+
+   QLog_Debug("Git",
+              QString("Lanes of the {%1} rows of the filtered history calculated in {%2} ms.")
+                  .arg(QString::number(count), QString::number(timer.elapsed())));
+
+   return result;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <Lane.h>
+#include <WorkerPool.h>
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QVector>
+
+class RevisionsCache;
+class RevisionsSnapshot;
+
+/*!
+ \brief The SubgraphLanes calculates, in a worker thread, the lanes of the graph of a filtered history (e.g. the history
+ of a file) as if only the commits shown existed. The lanes of the whole history are meaningless once most of the rows
+ are hidden.
+
+ The parents of every commit shown are rewritten to their nearest ancestors that are also shown, like git does with
+ the history simplification, and the lanes are calculated over those commits alone.
+
+ \class SubgraphLanes SubgraphLanes.h "SubgraphLanes.h"
+*/
+class SubgraphLanes : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the lanes of the last rows given to \ref rebuild are ready.
+   */
+   void signalLanesReady();
+
+public:
+   explicit SubgraphLanes(const QSharedPointer<RevisionsCache> &cache, QObject *parent = nullptr);
+   ~SubgraphLanes();
+
+   /*!
+    \brief Starts calculating the lanes of the given rows. The lanes calculated before are discarded.
+
+    \param rows The rows of the cache that are shown, sorted.
+   */
+   void rebuild(const QVector<int> &rows);
+   /*!
+    \brief Discards the lanes and the calculation in progress, if any.
+   */
+   void clear();
+   /*!
+    \brief Returns the lanes of a row of the filtered history.
+
+    \param index The position of the row in the rows given to \ref rebuild.
+    \return The lanes, or an empty vector if they are not calculated yet.
+   */
+   QVector<Lane> lanes(int index) const { return mLanes.value(index); }
+
+private:
+   QSharedPointer<RevisionsCache> mCache;
+   QScopedPointer<WorkerQueue> mWorker;
+   QAtomicInt mRequest;
+   QVector<QVector<Lane>> mLanes;
+
+   QVector<QVector<Lane>> calculate(int request, const RevisionsSnapshot &snapshot, const QVector<int> &rows) const;
+};
@@ -0,0 +1,118 @@
+#include "TraceRecorder.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+namespace
+{
+const QElapsedTimer &clock()
+{
+   static const auto timer = []() {
+      QElapsedTimer timer;
+      timer.start();
+      return timer;
+   }();
+
+   return timer;
+}
+}
+
+TraceRecorder &TraceRecorder::instance()
+{
+   static TraceRecorder recorder;
+   return recorder;
+}
+
+qint64 TraceRecorder::now()
+{
+   return clock().nsecsElapsed() / 1000;
+}
+
+void TraceRecorder::record(const char *category, const QString &name, qint64 startUs, qint64 durationUs)
+{
+   QMutexLocker locker(&mMutex);
+
+   Event event;
+   event.category = category;
+   event.name = name;
+   event.startUs = startUs;
+   event.durationUs = durationUs;
+   event.thread = currentThread();
+
+   if (mEvents.count() < MAX_EVENTS)
+      mEvents.append(std::move(event));
+   else
+      mEvents[mNextEvent] = std::move(event);
+
+   mNextEvent = (mNextEvent + 1) % MAX_EVENTS;
+}
+
+void TraceRecorder::clear()
+{
+   QMutexLocker locker(&mMutex);
+
+   mEvents.clear();
+   mNextEvent = 0;
+}
+
+int TraceRecorder::count() const
+{
+   QMutexLocker locker(&mMutex);
+
+   return mEvents.count();
+}
+
+QByteArray TraceRecorder::toJson() const
+{
+   QMutexLocker locker(&mMutex);
+
+   QJsonArray events;
+
+   for (auto iter = mThreadNames.cbegin(); iter != mThreadNames.cend(); ++iter)
+   {
+      events.append(QJsonObject { { "name", "thread_name" },
+                                  { "ph", "M" },
+                                  { "pid", 1 },
+                                  { "tid", iter.key() },
+                                  { "args", QJsonObject { { "name", iter.value() } } } });
+   }
+
+   for (const auto &event : mEvents)
+   {
+      events.append(QJsonObject { { "name", event.name },
+                                  { "cat", QString::fromLatin1(event.category) },
+                                  { "ph", "X" },
+                                  { "ts", event.startUs },
+                                  { "dur", event.durationUs },
+                                  { "pid", 1 },
+                                  { "tid", event.thread } });
+   }
+
+   return QJsonDocument(QJsonObject { { "traceEvents", events }, { "displayTimeUnit", "ms" } }).toJson();
+}
+
+int TraceRecorder::currentThread()
+{
+   // The ids of the threads are small numbers, given the first time a thread records a span.
+   static std::atomic<int> nextThread { 0 };
+   thread_local const auto thread = ++nextThread;
+
+   if (!mThreadNames.contains(thread))
+   {
+      const auto current = QThread::currentThread();
+      auto name = current ? current->objectName() : QString();
+
+      if (QCoreApplication::instance() && current == QCoreApplication::instance()->thread())
+         name = "GUI";
+      else if (name.isEmpty())
+         name = QString("Thread %1").arg(thread);
+
+      mThreadNames.insert(thread, name);
+   }
+
+   return thread;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+/*!
+ \brief The TraceRecorder keeps a timeline of what the application does when a load or a refresh is slow: the spans
+ of the loader, the cache, the git processes, the watcher and the diff and blame loaders, with the thread they ran on.
+ It's disabled by default, and while it's disabled a span only checks a flag. The last MAX_EVENTS spans are kept and can
+ be exported in the trace event format of chrome://tracing and Perfetto.
+
+ \class TraceRecorder TraceRecorder.h "TraceRecorder.h"
+*/
+class TraceRecorder
+{
+public:
+   /*!
+    \brief The number of spans kept. The oldest ones are overwritten.
+   */
+   static constexpr int MAX_EVENTS = 100000;
+
+   /*!
+    \brief Returns the recorder of the application.
+   */
+   static TraceRecorder &instance();
+   /*!
+    \brief Returns the microseconds since the recorder was created, the time base of the spans.
+   */
+   static qint64 now();
+
+   /*!
+    \brief Enables or disables the recording. The spans recorded are kept.
+   */
+   void setEnabled(bool enabled) { mEnabled.store(enabled, std::memory_order_relaxed); }
+   /*!
+    \brief Tells if the spans are being recorded.
+   */
+   bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+   /*!
+    \brief Records a span that finished in the current thread.
+
+    \param category The part of the application, for instance "git" or "cache".
+    \param name The name of the span.
+    \param startUs The start of the span, as returned by \ref now.
+    \param durationUs The duration of the span in microseconds.
+   */
+   void record(const char *category, const QString &name, qint64 startUs, qint64 durationUs);
+   /*!
+    \brief Removes all the spans recorded.
+   */
+   void clear();
+   /*!
+    \brief Returns the number of spans recorded.
+   */
+   int count() const;
+   /*!
+    \brief Exports the spans as a Chrome trace JSON, with the names of the threads.
+   */
+   QByteArray toJson() const;
+
+private:
+   struct Event
+   {
+      const char *category = nullptr;
+      QString name;
+      qint64 startUs = 0;
+      qint64 durationUs = 0;
+      int thread = 0;
+   };
+
+   mutable QMutex mMutex;
+   std::atomic<bool> mEnabled { false };
+   QVector<Event> mEvents;
+   int mNextEvent = 0;
+   QMap<int, QString> mThreadNames;
+
+   TraceRecorder() = default;
+
+   int currentThread();
+};
+
+/*!
+ \brief The TraceSpan records the span of its scope in the TraceRecorder, if it's enabled when the span starts.
+
+ \class TraceSpan TraceRecorder.h "TraceRecorder.h"
+*/
+class TraceSpan
+{
+public:
+   /*!
+    \brief Starts the span.
+
+    \param category The part of the application, it must be a literal.
+    \param name The name of the span, it must be a literal.
+   */
+   TraceSpan(const char *category, const char *name)
+      : mCategory(category)
+      , mName(name)
+      , mStartUs(TraceRecorder::instance().isEnabled() ? TraceRecorder::now() : -1)
+   {
+   }
+   ~TraceSpan()
+   {
+      if (mStartUs >= 0)
+         TraceRecorder::instance().record(mCategory, QString::fromLatin1(mName), mStartUs,
+                                          TraceRecorder::now() - mStartUs);
+   }
+
+   TraceSpan(const TraceSpan &) = delete;
+   TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+   const char *mCategory = nullptr;
+   const char *mName = nullptr;
+   qint64 mStartUs = -1;
+};
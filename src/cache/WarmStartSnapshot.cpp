@@ -0,0 +1,116 @@
+#include "WarmStartSnapshot.h"
+
+#include <CommitInfo.h>
+
+#include <QLogger.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+using namespace QLogger;
+
+namespace
+{
+const quint32 kMagic = 0x47515753; // GQWS
+}
+
+WarmStartSnapshot::WarmStartSnapshot(const QString &filePath)
+   : mFilePath(filePath)
+{
+}
+
+bool WarmStartSnapshot::load(QString &headSha, QVector<CommitInfo *> &commits, QVector<Reference> &references) const
+{
+   QFile file(mFilePath);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   QDataStream in(&file);
+   in.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic = 0;
+   quint32 version = 0;
+   qint32 count = 0;
+
+   in >> magic >> version >> headSha >> count;
+
+   if (in.status() != QDataStream::Ok || magic != kMagic || version != VERSION || count < 0 || count > ROWS)
+   {
+      QLog_Info("Git", QString("The warm start file {%1} is not valid.").arg(mFilePath));
+      return false;
+   }
+
+   QVector<CommitInfo *> loaded;
+   loaded.reserve(count);
+
+   for (auto i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+   {
+      const auto commit = new CommitInfo();
+      in >> *commit;
+      loaded.append(commit);
+   }
+
+   qint32 referencesCount = 0;
+   in >> referencesCount;
+
+   QVector<Reference> loadedReferences;
+
+   for (auto i = 0; i < referencesCount && in.status() == QDataStream::Ok; ++i)
+   {
+      Reference reference;
+      qint32 type = 0;
+
+      in >> reference.sha >> type >> reference.name;
+
+      if (type < 0 || type >= static_cast<qint32>(References::Type::AnyRef))
+         in.setStatus(QDataStream::ReadCorruptData);
+
+      reference.type = static_cast<References::Type>(type);
+      loadedReferences.append(reference);
+   }
+
+   if (in.status() != QDataStream::Ok)
+   {
+      QLog_Warning("Git", QString("The warm start file {%1} is corrupted.").arg(mFilePath));
+
+      qDeleteAll(loaded);
+      return false;
+   }
+
+   commits.append(loaded);
+   references.append(loadedReferences);
+
+   return true;
+}
+
+bool WarmStartSnapshot::save(const QString &headSha, const QVector<CommitInfo> &commits,
+                             const QVector<Reference> &references) const
+{
+   QDir().mkpath(QFileInfo(mFilePath).absolutePath());
+
+   QSaveFile file(mFilePath);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Git", QString("The warm start file {%1} can't be written.").arg(mFilePath));
+      return false;
+   }
+
+   QDataStream out(&file);
+   out.setVersion(QDataStream::Qt_5_9);
+   out << kMagic << VERSION << headSha << static_cast<qint32>(commits.count());
+
+   for (const auto &commit : commits)
+      out << commit;
+
+   out << static_cast<qint32>(references.count());
+
+   for (const auto &reference : references)
+      out << reference.sha << static_cast<qint32>(reference.type) << reference.name;
+
+   return file.commit();
+}
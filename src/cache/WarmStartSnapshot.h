@@ -0,0 +1,93 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <References.h>
+
+#include <QString>
+#include <QVector>
+
+class CommitInfo;
+
+/*!
+ \brief The WarmStartSnapshot stores the first rows of the history of a repository in a small file: the commits, with
+ their subject, author, date and lanes, and their references. When the repository is opened again the rows are shown
+ at once, before git is asked for anything, while the history is loaded in the background.
+
+ The rows aren't validated when they are read: the load that follows replaces them, or keeps them in place if the
+ history starts with the same commits from the same HEAD.
+
+ \class WarmStartSnapshot WarmStartSnapshot.h "WarmStartSnapshot.h"
+*/
+class WarmStartSnapshot
+{
+public:
+   /*!
+    \brief A reference of one of the commits stored.
+   */
+   struct Reference
+   {
+      QString sha;
+      References::Type type;
+      QString name;
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param filePath The full path of the snapshot file.
+   */
+   explicit WarmStartSnapshot(const QString &filePath);
+
+   /*!
+    \brief Reads the snapshot.
+
+    \param headSha The commit HEAD pointed to, the parent of the WIP the lanes start from.
+    \param commits The vector where the commits are appended, in the order of the rows. The caller takes the ownership.
+    \param references The references of the commits.
+    \return True if the file exists and it's valid, otherwise false.
+   */
+   bool load(QString &headSha, QVector<CommitInfo *> &commits, QVector<Reference> &references) const;
+   /*!
+    \brief Writes the snapshot. The previous file is only replaced when the new one has been completely written.
+
+    \param headSha The commit HEAD points to.
+    \param commits The commits of the first rows, below the WIP.
+    \param references The references of those commits.
+    \return True if the file was written, otherwise false.
+   */
+   bool save(const QString &headSha, const QVector<CommitInfo> &commits, const QVector<Reference> &references) const;
+
+   /*!
+    \brief The number of rows stored: enough to fill the first screen of the history.
+   */
+   static constexpr int ROWS = 100;
+   /*!
+    \brief The version of the file format. It follows the one of the commits in RevisionsDiskCache.
+   */
+   static constexpr quint32 VERSION = 1;
+
+private:
+   QString mFilePath;
+};
@@ -0,0 +1,244 @@
+#include "WorkerPool.h"
+
+#include <QThread>
+
+#include <QLogger.h>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+WorkerPool &WorkerPool::instance()
+{
+   static WorkerPool pool;
+
+   return pool;
+}
+
+WorkerPool::WorkerPool()
+{
+   const auto threads = qMax(1, QThread::idealThreadCount());
+
+   for (auto i = 0; i < threads; ++i)
+   {
+      const auto thread = QThread::create([this]() { work(); });
+      thread->setObjectName(QString("WorkerPool-%1").arg(i));
+      thread->start();
+
+      mThreads.append(thread);
+   }
+
+   QLog_Debug("UI", QString("Worker pool started with {%1} threads.").arg(threads));
+}
+
+WorkerPool::~WorkerPool()
+{
+   {
+      QMutexLocker locker(&mMutex);
+      mStopping = true;
+      mWorkAvailable.wakeAll();
+   }
+
+   for (const auto thread : qAsConst(mThreads))
+   {
+      thread->wait();
+      delete thread;
+   }
+
+   qDeleteAll(mQueues);
+}
+
+void WorkerPool::setForegroundRepository(const void *repository)
+{
+   QMutexLocker locker(&mMutex);
+
+   mForeground = repository;
+
+   // The quotas changed: a queue that had to wait might run now.
+   mWorkAvailable.wakeAll();
+}
+
+void WorkerPool::setMaxConcurrency(int tasks)
+{
+   QMutexLocker locker(&mMutex);
+
+   mMaxConcurrency = tasks > 0 ? std::min(tasks, static_cast<int>(mThreads.count())) : 0;
+
+   // The quotas changed: a queue that had to wait might run now.
+   mWorkAvailable.wakeAll();
+}
+
+int WorkerPool::createQueue(const void *repository, Priority priority, bool parallel)
+{
+   QMutexLocker locker(&mMutex);
+
+   const auto workQueue = new Queue();
+   workQueue->repository = repository;
+   workQueue->priority = priority;
+   workQueue->parallel = parallel;
+
+   mQueues.insert(++mLastQueue, workQueue);
+
+   return mLastQueue;
+}
+
+void WorkerPool::post(int id, const Task &task)
+{
+   QMutexLocker locker(&mMutex);
+
+   const auto workQueue = mQueues.value(id);
+
+   if (!workQueue)
+      return;
+
+   workQueue->tasks.enqueue(task);
+
+   // A queue with tasks is always ready, except a serial one that is running: it's ready again when its task ends.
+   if (workQueue->tasks.count() == 1 && (workQueue->parallel || workQueue->running == 0))
+   {
+      mReady[static_cast<int>(workQueue->priority)].enqueue(workQueue);
+      mWorkAvailable.wakeOne();
+   }
+}
+
+void WorkerPool::removeQueue(int id)
+{
+   QMutexLocker locker(&mMutex);
+
+   const auto workQueue = mQueues.take(id);
+
+   if (!workQueue)
+      return;
+
+   workQueue->tasks.clear();
+   mReady[static_cast<int>(workQueue->priority)].removeOne(workQueue);
+
+   while (workQueue->running > 0)
+      mTaskFinished.wait(&mMutex);
+
+   delete workQueue;
+}
+
+int WorkerPool::concurrency() const
+{
+   return mMaxConcurrency > 0 ? mMaxConcurrency : mThreads.count();
+}
+
+int WorkerPool::priorityQuota(Priority priority) const
+{
+   const auto threads = concurrency();
+
+   switch (priority)
+   {
+      case Priority::Interactive:
+         return threads;
+      case Priority::Refresh:
+         return qMax(1, threads - 1);
+      case Priority::Background:
+         break;
+   }
+
+   return qMax(1, threads / 2);
+}
+
+int WorkerPool::repositoryQuota(const void *repository) const
+{
+   return repository == mForeground ? concurrency() : qMax(1, concurrency() / 2);
+}
+
+WorkerPool::Queue *WorkerPool::takeNext()
+{
+   if (mRunning >= concurrency())
+      return nullptr;
+
+   for (auto &ready : mReady)
+   {
+      auto next = -1;
+
+      for (auto i = 0; i < ready.count(); ++i)
+      {
+         const auto workQueue = ready.at(i);
+
+         if (mRunningByPriority[static_cast<int>(workQueue->priority)] >= priorityQuota(workQueue->priority)
+             || mRunningByRepository.value(workQueue->repository) >= repositoryQuota(workQueue->repository))
+            continue;
+
+         if (next == -1)
+            next = i;
+
+         if (workQueue->repository == mForeground)
+         {
+            next = i;
+            break;
+         }
+      }
+
+      if (next != -1)
+      {
+         const auto workQueue = ready.takeAt(next);
+
+         // A parallel queue stays ready while it has tasks, behind the rest of the queues of its priority.
+         if (workQueue->parallel && workQueue->tasks.count() > 1)
+            ready.enqueue(workQueue);
+
+         return workQueue;
+      }
+   }
+
+   return nullptr;
+}
+
+void WorkerPool::work()
+{
+   QMutexLocker locker(&mMutex);
+
+   while (!mStopping)
+   {
+      const auto workQueue = takeNext();
+
+      if (!workQueue)
+      {
+         mWorkAvailable.wait(&mMutex);
+         continue;
+      }
+
+      const auto task = workQueue->tasks.dequeue();
+      ++workQueue->running;
+      ++mRunning;
+      ++mRunningByPriority[static_cast<int>(workQueue->priority)];
+      ++mRunningByRepository[workQueue->repository];
+
+      locker.unlock();
+      task();
+      locker.relock();
+
+      --workQueue->running;
+      --mRunning;
+      --mRunningByPriority[static_cast<int>(workQueue->priority)];
+
+      if (--mRunningByRepository[workQueue->repository] == 0)
+         mRunningByRepository.remove(workQueue->repository);
+
+      if (!workQueue->parallel && !workQueue->tasks.isEmpty())
+         mReady[static_cast<int>(workQueue->priority)].enqueue(workQueue);
+
+      // The quotas are free again: another thread might take a queue that had to wait.
+      mTaskFinished.wakeAll();
+      mWorkAvailable.wakeAll();
+   }
+}
+
+WorkerQueue::WorkerQueue(const void *repository, WorkerPool::Priority priority, bool parallel)
+   : mId(WorkerPool::instance().createQueue(repository, priority, parallel))
+{
+}
+
+WorkerQueue::~WorkerQueue()
+{
+   WorkerPool::instance().removeQueue(mId);
+}
+
+void WorkerQueue::post(const WorkerPool::Task &task)
+{
+   WorkerPool::instance().post(mId, task);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+
+class QThread;
+
+/*!
+ \brief The WorkerPool runs the work of all the repositories that doesn't belong to the GUI thread: the parsing of the
+ history, the search index, the path history index... It has as many threads as cores, so opening more repositories
+ doesn't start more threads.
+
+ The work is posted to a WorkerQueue. The tasks of a queue run one after the other, in the order they were posted,
+ like in a thread of their own, unless the queue is parallel. Every queue belongs to a repository and has a priority,
+ and the threads take the next task from the highest priority that has work within its quotas:
+
+ - The tasks of the background priority never take more than half of the threads, and the ones of the refresh
+   priority leave a thread free, so the interactive work always finds one.
+ - Every repository but the foreground one takes at most half of the threads. The foreground repository is also
+   served first within every priority.
+
+ The number of tasks running at the same time can be lower than the number of threads, see ResourceBudget. The quotas
+ are then parts of that number.
+
+ \class WorkerPool WorkerPool.h "WorkerPool.h"
+*/
+class WorkerPool
+{
+public:
+   /*!
+    \brief The priority classes, from the highest to the lowest.
+   */
+   enum class Priority
+   {
+      Interactive,
+      Refresh,
+      Background
+   };
+
+   /*!
+    \brief The work to do in a thread of the pool.
+   */
+   using Task = std::function<void()>;
+
+   /*!
+    \brief Returns the pool of the application.
+   */
+   static WorkerPool &instance();
+
+   /*!
+    \brief Returns the number of threads of the pool.
+   */
+   int threadCount() const { return mThreads.count(); }
+   /*!
+    \brief Sets the repository the user is looking at. Its work goes first and has no quota.
+
+    \param repository The repository, identified the same way as in its queues.
+   */
+   void setForegroundRepository(const void *repository);
+   /*!
+    \brief Sets the number of tasks that run at the same time. The tasks running are not stopped if there are more.
+
+    \param tasks The number of tasks. 0, or more than the threads, runs as many as threads.
+   */
+   void setMaxConcurrency(int tasks);
+
+private:
+   friend class WorkerQueue;
+
+   struct Queue
+   {
+      const void *repository = nullptr;
+      Priority priority = Priority::Background;
+      bool parallel = false;
+      QQueue<Task> tasks;
+      int running = 0;
+   };
+
+   static constexpr int TOTAL_PRIORITIES = 3;
+
+   QMutex mMutex;
+   QWaitCondition mWorkAvailable;
+   QWaitCondition mTaskFinished;
+   QVector<QThread *> mThreads;
+   QHash<int, Queue *> mQueues;
+   QQueue<Queue *> mReady[TOTAL_PRIORITIES];
+   QHash<const void *, int> mRunningByRepository;
+   int mRunningByPriority[TOTAL_PRIORITIES] {};
+   int mRunning = 0;
+   int mMaxConcurrency = 0;
+   int mLastQueue = 0;
+   const void *mForeground = nullptr;
+   bool mStopping = false;
+
+   WorkerPool();
+   ~WorkerPool();
+
+   int createQueue(const void *repository, Priority priority, bool parallel);
+   void post(int id, const Task &task);
+   void removeQueue(int id);
+   int concurrency() const;
+   int priorityQuota(Priority priority) const;
+   int repositoryQuota(const void *repository) const;
+   Queue *takeNext();
+   void work();
+};
+
+/*!
+ \brief A WorkerQueue is a queue of tasks of a repository that run in the WorkerPool one after the other, in the order
+ they were posted, as if the queue had a thread of its own. The tasks of a parallel queue run at the same time in as
+ many threads as the quotas allow, in any order.
+
+ \class WorkerQueue WorkerPool.h "WorkerPool.h"
+*/
+class WorkerQueue
+{
+public:
+   /*!
+    \brief Default constructor.
+
+    \param repository The repository the work belongs to. The repositories are identified by their RevisionsCache.
+    \param priority The priority of the work.
+    \param parallel True if the tasks can run at the same time, otherwise false.
+   */
+   WorkerQueue(const void *repository, WorkerPool::Priority priority, bool parallel = false);
+   /*!
+    \brief Destructor. The tasks that didn't start are discarded and it waits for the one running, if any.
+   */
+   ~WorkerQueue();
+
+   /*!
+    \brief Posts a task. Unless the queue is parallel, it runs after the tasks posted before.
+
+    \param task The task.
+   */
+   void post(const WorkerPool::Task &task);
+
+private:
+   int mId = 0;
+
+   Q_DISABLE_COPY(WorkerQueue)
+};
@@ -8,43 +8,181 @@
 */
 #include "lanes.h"
 
-#include <QStringList>
+#include <CommitInfo.h>
 
-void Lanes::init(const QString &expectedSha)
+#include <algorithm>
+
+QVector<Lane> Lanes::calculateLanes(const CommitInfo &c)
+{
+   return calculateLanes(c.id(), c.parentIds());
+}
+
+QVector<Lane> Lanes::calculateLanes(const ObjectId &sha, const QVector<ObjectId> &parents)
+{
+   const auto id = idOf(sha);
+   const auto parentsCount = parents.count();
+
+   changedStart = 0;
+   changedEnd = -1;
+   releasableIds.append(id);
+
+   bool isDiscontinuity;
+   bool isFork = this->isFork(id, isDiscontinuity);
+   bool isMerge = parentsCount > 1;
+
+   if (isDiscontinuity)
+      changeActiveLane(id); // uses previous isBoundary state
+
+   if (isFork)
+      setFork(id);
+   if (isMerge)
+   {
+      parentIds.clear();
+
+      for (auto i = 0; i < parentsCount; ++i)
+         parentIds.append(idOf(parents.at(i)));
+
+      setMerge(parentIds);
+   }
+   if (parentsCount == 0)
+      setInitial();
+
+   const auto lanes = getLanes();
+
+   nextParent(isMerge ? parentIds.constFirst() : idOf(parents.value(0)));
+
+   if (isMerge)
+      afterMerge();
+   if (isFork)
+      afterFork();
+   if (isBranch())
+      afterBranch();
+
+   releaseUnusedIds();
+
+   return lanes;
+}
+
+bool Lanes::operator==(const Lanes &other) const
+{
+   if (activeLane != other.activeLane || typeVec != other.typeVec || nextIdVec.count() != other.nextIdVec.count())
+      return false;
+
+   // The ids are local to every instance, so the lanes are compared by the sha1 behind them.
+   for (auto i = 0; i < nextIdVec.count(); ++i)
+   {
+      if (shaOfId.at(nextIdVec.at(i)) != other.shaOfId.at(other.nextIdVec.at(i)))
+         return false;
+   }
+
+   return true;
+}
+
+QVector<ObjectId> Lanes::getPendingShas() const
+{
+   QVector<ObjectId> shas;
+   QVector<bool> added(shaOfId.count(), false);
+
+   // The empty lanes keep the id of the last commit they had.
+   for (auto i = 0; i < nextIdVec.count(); ++i)
+   {
+      const auto id = nextIdVec.at(i);
+
+      if (!typeVec.at(i).equals(LaneType::EMPTY) && !added.at(id))
+      {
+         added[id] = true;
+         shas.append(shaOfId.at(id));
+      }
+   }
+
+   return shas;
+}
+
+void Lanes::init(const ObjectId &expectedSha)
 {
    clear();
    activeLane = 0;
-   add(LaneType::BRANCH, expectedSha, activeLane);
+   add(LaneType::BRANCH, idOf(expectedSha), activeLane);
 }
 
 void Lanes::clear()
 {
    typeVec.clear();
-   nextShaVec.clear();
+   nextIdVec.clear();
+   ids.clear();
+   shaOfId.clear();
+   lanesOfId.clear();
+   idInUse.clear();
+   freeIds.clear();
+   releasableIds.clear();
+}
+
+int Lanes::idOf(const ObjectId &sha)
+{
+   const auto iter = ids.constFind(sha);
+
+   if (iter != ids.constEnd())
+      return *iter;
+
+   int id;
+
+   if (freeIds.isEmpty())
+   {
+      id = shaOfId.count();
+      shaOfId.append(sha);
+      lanesOfId.append(QVector<int>());
+      idInUse.append(true);
+   }
+   else
+   {
+      id = freeIds.takeLast();
+      shaOfId[id] = sha;
+      idInUse[id] = true;
+   }
+
+   ids.insert(sha, id);
+
+   return id;
+}
+
+void Lanes::releaseUnusedIds()
+{
+   for (const auto id : qAsConst(releasableIds))
+   {
+      if (idInUse.at(id) && lanesOfId.at(id).isEmpty())
+      {
+         ids.remove(shaOfId.at(id));
+         idInUse[id] = false;
+         freeIds.append(id);
+      }
+   }
+
+   releasableIds.clear();
 }
 
-bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
+bool Lanes::isFork(int id, bool &isDiscontinuity)
 {
-   int pos = findNextSha(sha, 0);
+   int pos = findNextId(id, 0);
    isDiscontinuity = activeLane != pos;
 
-   return pos == -1 ? false : findNextSha(sha, pos + 1) != -1;
+   return pos == -1 ? false : findNextId(id, pos + 1) != -1;
 }
 
-void Lanes::setFork(const QString &sha)
+void Lanes::setFork(int id)
 {
    auto rangeEnd = 0;
    auto idx = 0;
-   auto rangeStart = rangeEnd = idx = findNextSha(sha, 0);
+   auto rangeStart = rangeEnd = idx = findNextId(id, 0);
 
    while (idx != -1)
    {
       rangeEnd = idx;
       typeVec[idx].setType(LaneType::TAIL);
-      idx = findNextSha(sha, idx + 1);
+      idx = findNextId(id, idx + 1);
    }
 
    typeVec[activeLane].setType(NODE);
+   markChanged(std::min(rangeStart, activeLane), std::max(rangeEnd, activeLane));
 
    auto &startT = typeVec[rangeStart];
    auto &endT = typeVec[rangeEnd];
@@ -77,7 +215,7 @@ void Lanes::setFork(const QString &sha)
    }
 }
 
-void Lanes::setMerge(const QStringList &parents)
+void Lanes::setMerge(const QVector<int> &parents)
 {
    auto &t = typeVec[activeLane];
    auto wasFork = t.equals(NODE);
@@ -90,11 +228,11 @@ void Lanes::setMerge(const QStringList &parents)
 
    auto rangeStart = activeLane;
    auto rangeEnd = activeLane;
-   QStringList::const_iterator it(parents.constBegin());
+   auto it = parents.constBegin();
 
    for (++it; it != parents.constEnd(); ++it)
    { // skip first parent
-      int idx = findNextSha(*it, 0);
+      int idx = findNextId(*it, 0);
 
       if (idx != -1)
       {
@@ -116,6 +254,8 @@ void Lanes::setMerge(const QStringList &parents)
          rangeEnd = add(LaneType::HEAD, *it, rangeEnd + 1);
    }
 
+   markChanged(rangeStart, rangeEnd);
+
    auto &startT = typeVec[rangeStart];
    auto &endT = typeVec[rangeEnd];
 
@@ -158,7 +298,7 @@ void Lanes::setInitial()
       t.setType(LaneType::INITIAL);
 }
 
-void Lanes::changeActiveLane(const QString &sha)
+void Lanes::changeActiveLane(int id)
 {
    auto &t = typeVec[activeLane];
 
@@ -167,18 +307,20 @@ void Lanes::changeActiveLane(const QString &sha)
    else
       t.setType(LaneType::NOT_ACTIVE);
 
-   int idx = findNextSha(sha, 0); // find first sha
+   int idx = findNextId(id, 0); // find first sha
    if (idx != -1)
       typeVec[idx].setType(LaneType::ACTIVE); // called before setBoundary()
    else
-      idx = add(LaneType::BRANCH, sha, activeLane); // new branch
+      idx = add(LaneType::BRANCH, id, activeLane); // new branch
 
    activeLane = idx;
 }
 
 void Lanes::afterMerge()
 {
-   for (int i = 0; i < typeVec.count(); i++)
+   const auto end = std::min(changedEnd, typeVec.count() - 1);
+
+   for (int i = changedStart; i <= end; i++)
    {
       auto &t = typeVec[i];
 
@@ -193,7 +335,9 @@ void Lanes::afterMerge()
 
 void Lanes::afterFork()
 {
-   for (int i = 0; i < typeVec.count(); i++)
+   const auto end = std::min(changedEnd, typeVec.count() - 1);
+
+   for (int i = changedStart; i <= end; i++)
    {
       auto &t = typeVec[i];
 
@@ -206,11 +350,19 @@ void Lanes::afterFork()
          t.setType(LaneType::ACTIVE); // boundary will be reset by changeActiveLane()
    }
 
-   while (typeVec.last().equals(LaneType::EMPTY))
+   // The empty lanes at the end are removed at once.
+   auto count = typeVec.count();
+
+   while (count > 0 && typeVec.at(count - 1).equals(LaneType::EMPTY))
    {
-      typeVec.pop_back();
-      nextShaVec.pop_back();
+      // The last lane is the last position of its sha1.
+      const auto id = nextIdVec.at(--count);
+      lanesOfId[id].removeLast();
+      releasableIds.append(id);
    }
+
+   typeVec.resize(count);
+   nextIdVec.resize(count);
 }
 
 bool Lanes::isBranch()
@@ -223,20 +375,48 @@ void Lanes::afterBranch()
    typeVec[activeLane].setType(LaneType::ACTIVE); // TODO test with boundaries
 }
 
-void Lanes::nextParent(const QString &sha)
+void Lanes::nextParent(int id)
 {
-   nextShaVec[activeLane] = sha;
+   setNextId(activeLane, id);
 }
 
-int Lanes::findNextSha(const QString &next, int pos)
+void Lanes::markChanged(int from, int to)
 {
-   for (int i = pos; i < nextShaVec.count(); i++)
+   if (changedEnd < changedStart)
    {
-      if (nextShaVec[i] == next)
-         return i;
+      changedStart = from;
+      changedEnd = to;
    }
+   else
+   {
+      changedStart = std::min(changedStart, from);
+      changedEnd = std::max(changedEnd, to);
+   }
+}
 
-   return -1;
+int Lanes::findNextId(int next, int pos) const
+{
+   // With many lanes open, comparing the sha1 of every lane for every commit was the main cost of the load.
+   const auto &lanes = lanesOfId.at(next);
+   const auto lane = std::lower_bound(lanes.cbegin(), lanes.cend(), pos);
+
+   return lane == lanes.cend() ? -1 : *lane;
+}
+
+void Lanes::setNextId(int pos, int next)
+{
+   auto &previous = nextIdVec[pos];
+
+   if (previous == next)
+      return;
+
+   lanesOfId[previous].removeOne(pos);
+   releasableIds.append(previous);
+
+   previous = next;
+
+   auto &lanes = lanesOfId[next];
+   lanes.insert(std::lower_bound(lanes.begin(), lanes.end(), pos), pos);
 }
 
 int Lanes::findType(const LaneType type, int pos)
@@ -252,7 +432,7 @@ int Lanes::findType(const LaneType type, int pos)
    return -1;
 }
 
-int Lanes::add(const LaneType type, const QString &next, int pos)
+int Lanes::add(const LaneType type, int next, int pos)
 {
    // first check empty lanes starting from pos
    if (pos < typeVec.count())
@@ -261,14 +441,15 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
       if (pos != -1)
       {
          typeVec[pos].setType(type);
-         nextShaVec[pos] = next;
+         setNextId(pos, next);
          return pos;
       }
    }
 
    // if all lanes are occupied add a new lane
    typeVec.append(type);
-   nextShaVec.append(next);
+   nextIdVec.append(next);
+   lanesOfId[next].append(nextIdVec.count() - 1);
    return typeVec.count() - 1;
 }
 
@@ -7,15 +7,17 @@
 #ifndef LANES_H
 #define LANES_H
 
-#include <QString>
+#include <QHash>
 #include <QVector>
 
 #include <LaneType.h>
 #include <Lane.h>
+#include <ObjectId.h>
+
+class CommitInfo;
 
 //
-//  At any given time, the Lanes class represents a single revision (row) of the history graph.
-//  The Lanes class contains a vector of the sha1 hashes of the next commit to appear in each lane (column).
+//  The Lanes class contains a vector of the ids of the sha1 hashes of the next commit to appear in each lane (column).
 //  The Lanes class also contains a vector used to decide which glyph to draw on the history graph.
 //
 //  For each revision (row) (from recent (top) to ancient past (bottom)), the Lanes class is updated, and the
@@ -29,30 +31,53 @@ class Lanes
 public:
    Lanes() { } // init() will setup us later, when data is available
    bool isEmpty() { return typeVec.empty(); }
-   void init(const QString &expectedSha);
+   bool operator==(const Lanes &other) const;
+   void init(const ObjectId &expectedSha);
    void clear();
-   bool isFork(const QString &sha, bool &isDiscontinuity);
-   void setFork(const QString &sha);
-   void setMerge(const QStringList &parents);
+   void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
+   QVector<Lane> getLanes() const { return typeVec; }
+   QVector<ObjectId> getPendingShas() const; // the sha1 hashes the lanes still wait for, each one once
+   QVector<Lane> calculateLanes(const CommitInfo &c); // returns the row of the commit and moves to the next one
+   QVector<Lane> calculateLanes(const ObjectId &sha, const QVector<ObjectId> &parents);
+
+private:
+   // The sha1 hashes of a commit and its parents are resolved to integer ids once per row, when entering
+   // calculateLanes(). The rest of the engine only works with those ids and the lane types.
+   int idOf(const ObjectId &sha);
+   void releaseUnusedIds();
+   bool isFork(int id, bool &isDiscontinuity);
+   void setFork(int id);
+   void setMerge(const QVector<int> &parents);
    void setInitial();
-   void changeActiveLane(const QString &sha);
+   void changeActiveLane(int id);
    void afterMerge();
    void afterFork();
    bool isBranch();
    void afterBranch();
-   void nextParent(const QString &sha);
-   void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
-   QVector<Lane> getLanes() const { return typeVec; }
-
-private:
-   int findNextSha(const QString &next, int pos);
+   void nextParent(int id);
+   int findNextId(int next, int pos) const;
+   void setNextId(int pos, int next);
+   void markChanged(int from, int to);
    int findType(LaneType type, int pos);
-   int add(LaneType type, const QString &next, int pos);
+   int add(LaneType type, int next, int pos);
    bool isNode(Lane lane) const;
 
-   int activeLane;
+   int activeLane = 0;
    QVector<Lane> typeVec; // Describes which glyphs should be drawn.
-   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QVector<int> nextIdVec; // The ids of the sha1 of the next commit to appear in each lane (column).
+   // Only the sha1 hashes some lane still waits for keep their id, so the tables below are bounded by the number
+   // of lanes and not by the number of commits: the id of a sha1 no lane waits for anymore is reused.
+   QHash<ObjectId, int> ids;
+   QVector<ObjectId> shaOfId;
+   QVector<QVector<int>> lanesOfId; // The lanes of every id of nextIdVec, in ascending order.
+   QVector<bool> idInUse;
+   QVector<int> freeIds;
+   QVector<int> releasableIds; // The ids that may have lost their last lane in the current row.
+   QVector<int> parentIds; // Reused for every merge row.
+   // The lanes a fork or a merge changed in the current row. Only they can have the types afterMerge() and
+   // afterFork() normalize, so the rest of lanes are not visited.
+   int changedStart = 0;
+   int changedEnd = -1;
    LaneType NODE = LaneType::MERGE_FORK;
    LaneType NODE_R = LaneType::MERGE_FORK_R;
    LaneType NODE_L = LaneType::MERGE_FORK_L;
@@ -7,6 +7,7 @@
 #include <GitLocal.h>
 #include <GitQlientRole.h>
 #include <UnstagedMenu.h>
+#include <WipFilesModel.h>
 
 #include <QMessageBox>
 
@@ -47,19 +48,15 @@ void AmendWidget::configure(const QString &sha)
 
       mCurrentSha = sha;
 
-      const auto author = commit.author().split("<");
-      ui->leAuthorName->setText(author.first());
-      ui->leAuthorEmail->setText(author.last().mid(0, author.last().count() - 1));
+      ui->leAuthorName->setText(commit.authorName());
+      ui->leAuthorEmail->setText(commit.authorEmail());
 
       blockSignals(true);
-      mCurrentFilesCache.clear();
-      ui->untrackedFilesList->clear();
-      ui->unstagedFilesList->clear();
-      ui->stagedFilesList->clear();
+      clearFiles();
       blockSignals(false);
 
-      insertFiles(files, ui->unstagedFilesList);
-      insertFiles(amendFiles, ui->stagedFilesList);
+      insertFiles(files, mUnstagedModel);
+      insertFiles(amendFiles, mStagedModel);
    }
    else
    {
@@ -67,15 +64,14 @@ void AmendWidget::configure(const QString &sha)
 
       prepareCache();
 
-      insertFiles(files, ui->unstagedFilesList);
+      insertFiles(files, mUnstagedModel);
 
       clearCache();
 
-      insertFiles(amendFiles, ui->stagedFilesList);
+      insertFiles(amendFiles, mStagedModel);
    }
 
-   ui->lUnstagedCount->setText(QString("(%1)").arg(ui->unstagedFilesList->count()));
-   ui->lStagedCount->setText(QString("(%1)").arg(ui->stagedFilesList->count()));
+   updateFilesCounters();
 
    if (lastMsgBeforeError.isEmpty())
    {
@@ -84,7 +80,7 @@ void AmendWidget::configure(const QString &sha)
    }
 
    ui->teDescription->moveCursor(QTextCursor::Start);
-   ui->pbCommit->setEnabled(ui->stagedFilesList->count());
+   ui->pbCommit->setEnabled(mStagedModel->rowCount());
 }
 
 bool AmendWidget::commitChanges()
@@ -124,13 +120,14 @@ bool AmendWidget::commitChanges()
 
 void AmendWidget::showUnstagedMenu(const QPoint &pos)
 {
-   const auto item = ui->unstagedFilesList->itemAt(pos);
+   const auto index = ui->unstagedFilesList->indexAt(pos);
 
-   if (item)
+   if (index.isValid())
    {
-      const auto fileName = item->toolTip();
-      const auto unsolvedConflicts = item->data(GitQlientRole::U_IsConflict).toBool();
-      const auto contextMenu = new UnstagedMenu(mGit, fileName, unsolvedConflicts, this);
+      const auto fileName = index.data(GitQlientRole::U_Name).toString();
+      const auto unsolvedConflicts = index.data(GitQlientRole::U_IsConflict).toBool();
+      const auto fileNames = selectedFiles(index);
+      const auto contextMenu = new UnstagedMenu(mGit, fileNames, unsolvedConflicts, this);
       connect(contextMenu, &UnstagedMenu::signalEditFile, this,
               [this, fileName]() { emit signalEditFile(mGit->getWorkingDir() + "/" + fileName, 0, 0); });
       connect(contextMenu, &UnstagedMenu::signalShowDiff, this, &AmendWidget::requestDiff);
@@ -138,7 +135,8 @@ void AmendWidget::showUnstagedMenu(const QPoint &pos)
       connect(contextMenu, &UnstagedMenu::signalRevertAll, this, &AmendWidget::revertAllChanges);
       connect(contextMenu, &UnstagedMenu::signalCheckedOut, this, &AmendWidget::signalCheckoutPerformed);
       connect(contextMenu, &UnstagedMenu::signalShowFileHistory, this, &AmendWidget::signalShowFileHistory);
-      connect(contextMenu, &UnstagedMenu::signalStageFile, this, [this, item] { addFileToCommitList(item); });
+      connect(contextMenu, &UnstagedMenu::signalStageFile, this,
+              [this, fileNames] { addFilesToCommitList(fileNames); });
 
       const auto parentPos = ui->unstagedFilesList->mapToParent(pos);
       contextMenu->popup(mapToGlobal(parentPos));
@@ -4,14 +4,16 @@
 #include <GitRepoLoader.h>
 #include <GitBase.h>
 #include <GitLocal.h>
-#include <GitQlientStyles.h>
 #include <CommitInfo.h>
 #include <RevisionFiles.h>
 #include <UnstagedMenu.h>
 #include <RevisionsCache.h>
-#include <FileWidget.h>
+#include <GitQlientRole.h>
+#include <WipFileDelegate.h>
+#include <WipFilesModel.h>
 
 #include <QDir>
+#include <QItemSelectionModel>
 #include <QKeyEvent>
 #include <QMenu>
 #include <QMessageBox>
@@ -19,11 +21,8 @@
 #include <QScrollBar>
 #include <QTextCodec>
 #include <QToolTip>
-#include <QListWidgetItem>
 #include <QTextStream>
 #include <QProcess>
-#include <QItemDelegate>
-#include <QPainter>
 
 #include <QLogger.h>
 
@@ -33,19 +32,15 @@ const int CommitChangesWidget::kMaxTitleChars = 50;
 
 QString CommitChangesWidget::lastMsgBeforeError;
 
-enum GitQlientRole
-{
-   U_ListRole = Qt::UserRole,
-   U_IsConflict,
-   U_Name
-};
-
 CommitChangesWidget::CommitChangesWidget(const QSharedPointer<RevisionsCache> &cache,
                                          const QSharedPointer<GitBase> &git, QWidget *parent)
    : QWidget(parent)
    , ui(new Ui::CommitChangesWidget)
    , mCache(cache)
    , mGit(git)
+   , mUntrackedModel(new WipFilesModel(QIcon(":/icons/add"), false, this))
+   , mUnstagedModel(new WipFilesModel(QIcon(":/icons/add"), false, this))
+   , mStagedModel(new WipFilesModel(QIcon(":/icons/remove"), true, this))
 {
    ui->setupUi(this);
    setAttribute(Qt::WA_DeleteOnClose);
@@ -63,20 +58,34 @@ CommitChangesWidget::CommitChangesWidget(const QSharedPointer<RevisionsCache> &c
    QIcon untrackedIcon(":/icons/untracked");
    ui->untrackedFilesIcon->setPixmap(untrackedIcon.pixmap(15, 15));
 
+   const auto delegate = new WipFileDelegate(this);
+   connect(delegate, &WipFileDelegate::signalButtonClicked, this, &CommitChangesWidget::onButtonClicked);
+
+   ui->untrackedFilesList->setModel(mUntrackedModel);
+   ui->untrackedFilesList->setItemDelegate(delegate);
+   ui->untrackedFilesList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+   ui->unstagedFilesList->setModel(mUnstagedModel);
+   ui->unstagedFilesList->setItemDelegate(delegate);
+   ui->unstagedFilesList->setUniformItemSizes(true);
+   ui->unstagedFilesList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+   ui->stagedFilesList->setModel(mStagedModel);
+   ui->stagedFilesList->setItemDelegate(delegate);
+   ui->stagedFilesList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
    connect(ui->leCommitTitle, &QLineEdit::textChanged, this, &CommitChangesWidget::updateCounter);
    connect(ui->leCommitTitle, &QLineEdit::returnPressed, this, &CommitChangesWidget::commitChanges);
    connect(ui->pbCommit, &QPushButton::clicked, this, &CommitChangesWidget::commitChanges);
    connect(ui->untrackedFilesList, &UntrackedFilesList::signalShowDiff, this, &CommitChangesWidget::requestDiff);
-   connect(ui->untrackedFilesList, &UntrackedFilesList::signalStageFile, this,
-           &CommitChangesWidget::addFileToCommitList);
+   connect(ui->untrackedFilesList, &UntrackedFilesList::signalStageFiles, this,
+           &CommitChangesWidget::addFilesToCommitList);
    connect(ui->untrackedFilesList, &UntrackedFilesList::signalCheckoutPerformed, this,
            &CommitChangesWidget::signalCheckoutPerformed);
    connect(ui->stagedFilesList, &StagedFilesList::signalResetFile, this, &CommitChangesWidget::resetFile);
    connect(ui->stagedFilesList, &StagedFilesList::signalShowDiff, this, &CommitChangesWidget::requestDiff);
-   connect(ui->unstagedFilesList, &QListWidget::customContextMenuRequested, this,
+   connect(ui->unstagedFilesList, &QListView::customContextMenuRequested, this,
            &CommitChangesWidget::showUnstagedMenu);
-   connect(ui->unstagedFilesList, &QListWidget::itemDoubleClicked, this,
-           [this](QListWidgetItem *item) { requestDiff(item->toolTip()); });
+   connect(ui->unstagedFilesList, &QListView::doubleClicked, this,
+           [this](const QModelIndex &index) { requestDiff(index.data(GitQlientRole::U_Name).toString()); });
 
    ui->pbCancelAmend->setVisible(false);
    ui->leAuthorName->setVisible(false);
@@ -94,82 +103,53 @@ void CommitChangesWidget::reload()
    configure(mCurrentSha);
 }
 
-void CommitChangesWidget::resetFile(QListWidgetItem *item)
+void CommitChangesWidget::resetFile(const QString &fileName)
+{
+   resetFiles({ fileName });
+}
+
+void CommitChangesWidget::resetFiles(const QStringList &fileNames)
 {
+   if (fileNames.isEmpty())
+      return;
+
    QScopedPointer<GitLocal> git(new GitLocal(mGit));
-   const auto ret = git->resetFile(item->toolTip());
-   const auto revInfo = mCache->getCommitInfo(mCurrentSha);
-   const auto files = mCache->getRevisionFile(mCurrentSha, revInfo.parent(0));
+   const auto ret = git->resetFiles(fileNames);
 
-   for (auto i = 0; i < files.count(); ++i)
-   {
-      auto fileName = files.getFile(i);
+   QSet<QString> toMove;
 
-      if (fileName == item->toolTip())
+   for (const auto &fileName : fileNames)
+   {
+      if (const auto row = mStagedModel->rowOf(fileName); row != -1)
       {
-         const auto isUnknown = files.statusCmp(i, RevisionFiles::UNKNOWN);
-         const auto isInIndex = files.statusCmp(i, RevisionFiles::IN_INDEX);
-         const auto untrackedFile = !isInIndex && isUnknown;
-         const auto row = ui->stagedFilesList->row(item);
-         const auto iconPath = QString(":/icons/add");
-
-         if (isInIndex)
-         {
-            item->setData(GitQlientRole::U_ListRole, QVariant::fromValue(ui->unstagedFilesList));
-
-            ui->stagedFilesList->takeItem(row);
-            ui->unstagedFilesList->addItem(item);
-
-            const auto fileWidget = new FileWidget(iconPath, item->toolTip());
-            fileWidget->setTextColor(item->foreground().color());
-
-            connect(fileWidget, &FileWidget::clicked, this, [this, item]() { addFileToCommitList(item); });
-            ui->unstagedFilesList->setItemWidget(item, fileWidget);
-         }
-         else if (untrackedFile)
-         {
-            item->setData(GitQlientRole::U_ListRole, QVariant::fromValue(ui->untrackedFilesList));
-
-            ui->stagedFilesList->takeItem(row);
-            ui->untrackedFilesList->addItem(item);
-
-            const auto fileWidget = new FileWidget(iconPath, item->toolTip());
-            fileWidget->setTextColor(item->foreground().color());
-
-            connect(fileWidget, &FileWidget::clicked, this, [this, item]() { addFileToCommitList(item); });
-            ui->untrackedFilesList->setItemWidget(item, fileWidget);
-         }
+         const auto status = mStagedModel->file(row).status;
+
+         if (status & (RevisionFiles::IN_INDEX | RevisionFiles::UNKNOWN))
+            toMove.insert(fileName);
       }
    }
 
-   if (ret.success)
-      emit signalUpdateWip();
-}
+   if (!toMove.isEmpty())
+   {
+      QVector<WipFilesModel::File> unstaged;
+      QVector<WipFilesModel::File> untracked;
 
-QColor CommitChangesWidget::getColorForFile(const RevisionFiles &files, int index) const
-{
-   const auto isUnknown = files.statusCmp(index, RevisionFiles::UNKNOWN);
-   const auto isInIndex = files.statusCmp(index, RevisionFiles::IN_INDEX);
-   const auto isConflict = files.statusCmp(index, RevisionFiles::CONFLICT);
-   const auto untrackedFile = !isInIndex && isUnknown;
+      for (auto file : mStagedModel->takeFiles(toMove))
+      {
+         file.origin = file.status & RevisionFiles::IN_INDEX ? mUnstagedModel : mUntrackedModel;
+         mCurrentFilesCache[file.name].second = file.origin;
+
+         (file.origin == mUnstagedModel ? unstaged : untracked).append(file);
+      }
 
-   QColor myColor;
-   const auto isDeleted = files.statusCmp(index, RevisionFiles::DELETED);
+      mUnstagedModel->appendFiles(unstaged);
+      mUntrackedModel->appendFiles(untracked);
 
-   if (isConflict)
-   {
-      myColor = GitQlientStyles::getBlue();
+      updateFilesCounters();
    }
-   else if (isDeleted)
-      myColor = GitQlientStyles::getRed();
-   else if (untrackedFile)
-      myColor = GitQlientStyles::getOrange();
-   else if (files.statusCmp(index, RevisionFiles::NEW) || isUnknown || isInIndex)
-      myColor = GitQlientStyles::getGreen();
-   else
-      myColor = GitQlientStyles::getTextColor();
 
-   return myColor;
+   if (ret.success)
+      emit signalUpdateWipPaths(fileNames);
 }
 
 void CommitChangesWidget::prepareCache()
@@ -180,89 +160,107 @@ void CommitChangesWidget::prepareCache()
 
 void CommitChangesWidget::clearCache()
 {
-   for (auto it = mCurrentFilesCache.begin(); it != mCurrentFilesCache.end();)
-   {
+   QSet<QString> files;
+
+   for (auto it = mCurrentFilesCache.cbegin(); it != mCurrentFilesCache.cend(); ++it)
       if (!it.value().first)
+         files.insert(it.key());
+
+   removeCachedFiles(files);
+}
+
+void CommitChangesWidget::removeCachedFiles(const QSet<QString> &files)
+{
+   QHash<WipFilesModel *, QSet<QString>> filesByList;
+
+   for (const auto &file : files)
+   {
+      if (const auto it = mCurrentFilesCache.find(file); it != mCurrentFilesCache.end())
       {
-         delete it.value().second;
-         it = mCurrentFilesCache.erase(it);
+         filesByList[it.value().second].insert(file);
+         mCurrentFilesCache.erase(it);
       }
-      else
-         ++it;
    }
+
+   for (auto it = filesByList.cbegin(); it != filesByList.cend(); ++it)
+      it.key()->removeFiles(it.value());
+}
+
+void CommitChangesWidget::clearFiles()
+{
+   mUntrackedModel->clear();
+   mUnstagedModel->clear();
+   mStagedModel->clear();
+   mCurrentFilesCache.clear();
 }
 
-void CommitChangesWidget::insertFiles(const RevisionFiles &files, QListWidget *fileList)
+void CommitChangesWidget::updateFilesCounters()
 {
+   if (const auto hiddenFiles = mCache->getHiddenUntrackedFiles(); hiddenFiles > 0)
+   {
+      ui->lUntrackedCount->setText(tr("(%1, %2 more)").arg(mUntrackedModel->rowCount()).arg(hiddenFiles));
+      ui->lUntrackedCount->setToolTip(tr("Only the first %1 untracked files are listed. The files that are not part "
+                                         "of the repository can be added to .gitignore.")
+                                          .arg(mUntrackedModel->rowCount()));
+   }
+   else
+   {
+      ui->lUntrackedCount->setText(QString("(%1)").arg(mUntrackedModel->rowCount()));
+      ui->lUntrackedCount->setToolTip(QString());
+   }
+
+   ui->lUnstagedCount->setText(QString("(%1)").arg(mUnstagedModel->rowCount()));
+   ui->lStagedCount->setText(QString("(%1)").arg(mStagedModel->rowCount()));
+}
+
+void CommitChangesWidget::insertFiles(const RevisionFiles &files, WipFilesModel *fileList)
+{
+   // The files already listed keep their list. The new ones are added to their list in a single insertion.
+   QHash<WipFilesModel *, QVector<WipFilesModel::File>> newFiles;
+
    for (auto i = 0; i < files.count(); ++i)
    {
       const auto fileName = files.getFile(i);
 
-      if (!mCurrentFilesCache.contains(fileName))
+      if (const auto it = mCurrentFilesCache.find(fileName); it != mCurrentFilesCache.end())
       {
-         const auto isUnknown = files.statusCmp(i, RevisionFiles::UNKNOWN);
-         const auto isInIndex = files.statusCmp(i, RevisionFiles::IN_INDEX);
-         const auto isConflict = files.statusCmp(i, RevisionFiles::CONFLICT);
-         const auto untrackedFile = !isInIndex && isUnknown;
-         const auto staged = isInIndex && !isUnknown && !isConflict;
-
-         auto parent = fileList;
-         if (untrackedFile)
-            parent = ui->untrackedFilesList;
-         else if (staged)
-            parent = ui->stagedFilesList;
-
-         auto item = new QListWidgetItem(parent);
-         item->setData(GitQlientRole::U_ListRole, QVariant::fromValue(parent));
-         item->setData(GitQlientRole::U_Name, fileName);
-
-         if (parent == ui->stagedFilesList)
-            item->setFlags(item->flags() & (~Qt::ItemIsSelectable & ~Qt::ItemIsEnabled));
-
-         mCurrentFilesCache.insert(fileName, qMakePair(true, item));
-
-         if (isConflict)
-         {
-            item->setData(GitQlientRole::U_IsConflict, isConflict);
-
-            const auto newName = fileName + QString(" (conflicts");
-            item->setText(newName);
-            item->setData(GitQlientRole::U_Name, newName);
-         }
-         else
-            item->setText(fileName);
-
-         item->setToolTip(fileName);
-
-         const auto fileWidget = new FileWidget(
-             !untrackedFile && staged ? QString(":/icons/remove") : QString(":/icons/add"), item->text());
-         const auto textColor = getColorForFile(files, i);
-
-         fileWidget->setTextColor(textColor);
-         item->setForeground(textColor);
-
-         if (staged)
-            connect(fileWidget, &FileWidget::clicked, this, [this, item]() { resetFile(item); });
-         else
-            connect(fileWidget, &FileWidget::clicked, this, [this, item]() { addFileToCommitList(item); });
-
-         parent->setItemWidget(item, fileWidget);
-         item->setText("");
-         item->setSizeHint(fileWidget->sizeHint());
+         it.value().first = true;
+         continue;
       }
-      else
-         mCurrentFilesCache[fileName].first = true;
+
+      auto file = WipFilesModel::fromRevisionFiles(files, i);
+      const auto isUnknown = file.status & RevisionFiles::UNKNOWN;
+      const auto isInIndex = file.status & RevisionFiles::IN_INDEX;
+      const auto isConflict = file.status & RevisionFiles::CONFLICT;
+      const auto untrackedFile = !isInIndex && isUnknown;
+      const auto staged = isInIndex && !isUnknown && !isConflict;
+
+      file.origin = fileList;
+
+      if (untrackedFile)
+         file.origin = mUntrackedModel;
+      else if (staged)
+         file.origin = mStagedModel;
+
+      newFiles[file.origin].append(file);
+      mCurrentFilesCache.insert(fileName, qMakePair(true, file.origin));
    }
+
+   for (auto it = newFiles.cbegin(); it != newFiles.cend(); ++it)
+      it.key()->appendFiles(it.value());
 }
 
 void CommitChangesWidget::addAllFilesToCommitList()
 {
-   for (auto i = ui->unstagedFilesList->count() - 1; i >= 0; --i)
-      addFileToCommitList(ui->unstagedFilesList->item(i));
+   const auto files = mUnstagedModel->takeFiles();
 
-   ui->lUnstagedCount->setText(QString("(%1)").arg(ui->unstagedFilesList->count()));
-   ui->lStagedCount->setText(QString("(%1)").arg(ui->stagedFilesList->count()));
-   ui->pbCommit->setEnabled(ui->stagedFilesList->count() > 0);
+   for (const auto &file : files)
+      mCurrentFilesCache[file.name].second = mStagedModel;
+
+   mStagedModel->appendFiles(files);
+
+   updateFilesCounters();
+   ui->pbCommit->setEnabled(mStagedModel->rowCount() > 0);
 }
 
 void CommitChangesWidget::requestDiff(const QString &fileName)
@@ -270,88 +268,133 @@ void CommitChangesWidget::requestDiff(const QString &fileName)
    emit signalShowDiff(CommitInfo::ZERO_SHA, mCache->getCommitInfo(CommitInfo::ZERO_SHA).parent(0), fileName);
 }
 
-void CommitChangesWidget::addFileToCommitList(QListWidgetItem *item)
+void CommitChangesWidget::addFileToCommitList(const QString &fileName)
+{
+   addFilesToCommitList({ fileName });
+}
+
+void CommitChangesWidget::addFilesToCommitList(const QStringList &fileNames)
 {
-   const auto fileList = qvariant_cast<QListWidget *>(item->data(GitQlientRole::U_ListRole));
-   const auto row = fileList->row(item);
-   const auto fileWidget = qobject_cast<FileWidget *>(fileList->itemWidget(item));
-   const auto newFileWidget = new FileWidget(":/icons/remove", fileWidget->text());
-   newFileWidget->setTextColor(item->foreground().color());
+   QHash<WipFilesModel *, QSet<QString>> filesByList;
+
+   for (const auto &fileName : fileNames)
+   {
+      const auto it = mCurrentFilesCache.constFind(fileName);
 
-   connect(newFileWidget, &FileWidget::clicked, this, [this, item]() { removeFileFromCommitList(item); });
+      if (it != mCurrentFilesCache.cend() && it.value().second != mStagedModel)
+         filesByList[it.value().second].insert(fileName);
+   }
 
-   fileList->removeItemWidget(item);
-   fileList->takeItem(row);
+   if (filesByList.isEmpty())
+      return;
 
-   ui->stagedFilesList->addItem(item);
-   ui->stagedFilesList->setItemWidget(item, newFileWidget);
+   for (auto it = filesByList.cbegin(); it != filesByList.cend(); ++it)
+   {
+      const auto files = it.key()->takeFiles(it.value());
 
-   if (item->data(GitQlientRole::U_IsConflict).toBool())
-      newFileWidget->setText(newFileWidget->text().remove("(conflicts)").trimmed());
+      for (const auto &file : files)
+         mCurrentFilesCache[file.name].second = mStagedModel;
 
-   delete fileWidget;
+      mStagedModel->appendFiles(files);
+   }
 
-   ui->lUntrackedCount->setText(QString("(%1)").arg(ui->untrackedFilesList->count()));
-   ui->lUnstagedCount->setText(QString("(%1)").arg(ui->unstagedFilesList->count()));
-   ui->lStagedCount->setText(QString("(%1)").arg(ui->stagedFilesList->count()));
+   updateFilesCounters();
    ui->pbCommit->setEnabled(true);
 }
 
 void CommitChangesWidget::revertAllChanges()
 {
-   auto needsUpdate = false;
+   revertFiles(mUnstagedModel->fileNames());
+}
 
-   for (auto i = ui->unstagedFilesList->count() - 1; i >= 0; --i)
-   {
-      QScopedPointer<GitLocal> git(new GitLocal(mGit));
-      needsUpdate |= git->checkoutFile(ui->unstagedFilesList->takeItem(i)->toolTip());
-   }
+void CommitChangesWidget::revertFiles(const QStringList &fileNames)
+{
+   if (fileNames.isEmpty())
+      return;
+
+   const auto names = fileNames.toSet();
 
-   if (needsUpdate)
+   for (const auto &fileName : fileNames)
+      mCurrentFilesCache.remove(fileName);
+
+   mUnstagedModel->removeFiles(names);
+
+   QScopedPointer<GitLocal> git(new GitLocal(mGit));
+
+   if (git->checkoutFiles(fileNames))
       emit signalCheckoutPerformed();
 }
 
-void CommitChangesWidget::removeFileFromCommitList(QListWidgetItem *item)
+void CommitChangesWidget::removeFileFromCommitList(const QString &fileName)
 {
-   if (item->flags() & Qt::ItemIsSelectable)
-   {
-      const auto itemOriginalList = qvariant_cast<QListWidget *>(item->data(GitQlientRole::U_ListRole));
-      const auto row = ui->stagedFilesList->row(item);
-      const auto fileWidget = qobject_cast<FileWidget *>(ui->stagedFilesList->itemWidget(item));
-      const auto newFileWidget = new FileWidget(":/icons/add", fileWidget->text());
-      newFileWidget->setTextColor(item->foreground().color());
-
-      connect(newFileWidget, &FileWidget::clicked, this, [this, item]() { addFileToCommitList(item); });
+   removeFilesFromCommitList({ fileName });
+}
 
-      if (item->data(GitQlientRole::U_IsConflict).toBool())
-         newFileWidget->setText(fileWidget->text().append(" (conflicts)"));
+void CommitChangesWidget::removeFilesFromCommitList(const QStringList &fileNames)
+{
+   QSet<QString> toRemove;
 
-      delete fileWidget;
+   // The files that were in the index already can only be reset.
+   for (const auto &fileName : fileNames)
+   {
+      if (const auto row = mStagedModel->rowOf(fileName); row != -1 && mStagedModel->file(row).origin != mStagedModel)
+         toRemove.insert(fileName);
+   }
 
-      ui->stagedFilesList->removeItemWidget(item);
-      const auto item = ui->stagedFilesList->takeItem(row);
+   if (toRemove.isEmpty())
+      return;
 
-      itemOriginalList->addItem(item);
-      itemOriginalList->setItemWidget(item, newFileWidget);
+   QHash<WipFilesModel *, QVector<WipFilesModel::File>> filesByList;
 
-      ui->lUnstagedCount->setText(QString("(%1)").arg(ui->unstagedFilesList->count()));
-      ui->lStagedCount->setText(QString("(%1)").arg(ui->stagedFilesList->count()));
-      ui->pbCommit->setDisabled(ui->stagedFilesList->count() == 0);
+   for (const auto &file : mStagedModel->takeFiles(toRemove))
+   {
+      mCurrentFilesCache[file.name].second = file.origin;
+      filesByList[file.origin].append(file);
    }
+
+   for (auto it = filesByList.cbegin(); it != filesByList.cend(); ++it)
+      it.key()->appendFiles(it.value());
+
+   updateFilesCounters();
+   ui->pbCommit->setDisabled(mStagedModel->rowCount() == 0);
 }
 
-QStringList CommitChangesWidget::getFiles()
+QStringList CommitChangesWidget::selectedFiles(const QModelIndex &index) const
 {
-   QStringList selFiles;
-   const auto totalItems = ui->stagedFilesList->count();
+   const auto fileName = index.data(GitQlientRole::U_Name).toString();
+   QAbstractItemView *view = ui->untrackedFilesList;
 
-   for (auto i = 0; i < totalItems; ++i)
-   {
-      const auto fileWidget = static_cast<FileWidget *>(ui->stagedFilesList->itemWidget(ui->stagedFilesList->item(i)));
-      selFiles.append(fileWidget->text());
-   }
+   if (index.model() == mUnstagedModel)
+      view = ui->unstagedFilesList;
+   else if (index.model() == mStagedModel)
+      view = ui->stagedFilesList;
+
+   // The action of a row that is part of the selection applies to all the selected rows.
+   if (!view->selectionModel()->isSelected(index))
+      return { fileName };
+
+   QStringList fileNames;
+   const auto rows = view->selectionModel()->selectedRows();
 
-   return selFiles;
+   for (const auto &row : rows)
+      fileNames.append(row.data(GitQlientRole::U_Name).toString());
+
+   return fileNames;
+}
+
+void CommitChangesWidget::onButtonClicked(const QModelIndex &index)
+{
+   if (index.model() != mStagedModel)
+      addFilesToCommitList(selectedFiles(index));
+   else if (index.flags() & Qt::ItemIsSelectable)
+      removeFilesFromCommitList(selectedFiles(index));
+   else
+      resetFile(index.data(GitQlientRole::U_Name).toString());
+}
+
+QStringList CommitChangesWidget::getFiles()
+{
+   return mStagedModel->fileNames();
 }
 
 bool CommitChangesWidget::checkMsg(QString &msg)
@@ -393,23 +436,14 @@ void CommitChangesWidget::updateCounter(const QString &text)
 
 bool CommitChangesWidget::hasConflicts()
 {
-   for (const auto &pair : mCurrentFilesCache.values())
-      if (pair.second->data(GitQlientRole::U_IsConflict).toBool())
-         return true;
-
-   return false;
+   return mUntrackedModel->hasConflicts() || mUnstagedModel->hasConflicts() || mStagedModel->hasConflicts();
 }
 
 void CommitChangesWidget::clear()
 {
-   ui->untrackedFilesList->clear();
-   ui->unstagedFilesList->clear();
-   ui->stagedFilesList->clear();
-   mCurrentFilesCache.clear();
+   clearFiles();
    ui->leCommitTitle->clear();
    ui->teDescription->clear();
    ui->pbCommit->setEnabled(false);
-   ui->lStagedCount->setText(QString("(%1)").arg(ui->unstagedFilesList->count()));
-   ui->lUnstagedCount->setText(QString("(%1)").arg(ui->stagedFilesList->count()));
-   ui->lUntrackedCount->setText(QString("(%1)").arg(ui->unstagedFilesList->count()));
+   updateFilesCounters();
 }
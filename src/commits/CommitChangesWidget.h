@@ -24,13 +24,14 @@
  ***************************************************************************************/
 
 #include <QWidget>
-#include <QMap>
+#include <QHash>
+#include <QSet>
 
-class QListWidget;
-class QListWidgetItem;
+class QModelIndex;
 class RevisionsCache;
 class GitBase;
 class RevisionFiles;
+class WipFilesModel;
 
 namespace Ui
 {
@@ -47,6 +48,7 @@ signals:
    void signalCheckoutPerformed();
    void signalShowFileHistory(const QString &fileName);
    void signalUpdateWip();
+   void signalUpdateWipPaths(const QStringList &paths);
    void signalCancelAmend(const QString &commitSha);
 
    /**
@@ -72,25 +74,36 @@ protected:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
    QString mCurrentSha;
-   QMap<QString, QPair<bool, QListWidgetItem *>> mCurrentFilesCache;
+   WipFilesModel *mUntrackedModel = nullptr;
+   WipFilesModel *mUnstagedModel = nullptr;
+   WipFilesModel *mStagedModel = nullptr;
+   QHash<QString, QPair<bool, WipFilesModel *>> mCurrentFilesCache;
 
    virtual bool commitChanges() = 0;
    virtual void showUnstagedMenu(const QPoint &pos) = 0;
 
-   virtual void insertFiles(const RevisionFiles &files, QListWidget *fileList) final;
+   virtual void insertFiles(const RevisionFiles &files, WipFilesModel *fileList) final;
    virtual void prepareCache() final;
    virtual void clearCache() final;
+   virtual void removeCachedFiles(const QSet<QString> &files) final;
+   virtual void clearFiles() final;
+   virtual void updateFilesCounters() final;
    virtual void addAllFilesToCommitList() final;
    virtual void requestDiff(const QString &fileName) final;
-   virtual void addFileToCommitList(QListWidgetItem *item) final;
+   virtual void addFileToCommitList(const QString &fileName) final;
+   virtual void addFilesToCommitList(const QStringList &fileNames) final;
    virtual void revertAllChanges() final;
-   virtual void removeFileFromCommitList(QListWidgetItem *item) final;
+   virtual void revertFiles(const QStringList &fileNames) final;
+   virtual void removeFileFromCommitList(const QString &fileName) final;
+   virtual void removeFilesFromCommitList(const QStringList &fileNames) final;
    virtual QStringList getFiles() final;
    virtual bool checkMsg(QString &msg) final;
    virtual void updateCounter(const QString &text) final;
    virtual bool hasConflicts() final;
-   virtual void resetFile(QListWidgetItem *item) final;
-   virtual QColor getColorForFile(const RevisionFiles &files, int index) const final;
+   virtual void resetFile(const QString &fileName) final;
+   virtual void resetFiles(const QStringList &fileNames) final;
+   virtual QStringList selectedFiles(const QModelIndex &index) const final;
+   virtual void onButtonClicked(const QModelIndex &index) final;
 
    static QString lastMsgBeforeError;
    static const int kMaxTitleChars;
@@ -2,11 +2,12 @@
 
 #include <RevisionsCache.h>
 #include <CommitInfo.h>
+#include <DateFormatter.h>
 #include <FileListWidget.h>
+#include <GitCommitDetails.h>
 
 #include <QLabel>
 #include <QVBoxLayout>
-#include <QDateTime>
 
 #include <QLogger.h>
 
@@ -25,6 +26,7 @@ CommitInfoWidget::CommitInfoWidget(const QSharedPointer<RevisionsCache> &cache,
    , labelEmail(new QLabel())
    , fileListWidget(new FileListWidget(mGit, mCache))
    , labelModCount(new QLabel())
+   , mCommitDetails(new GitCommitDetails(mGit, mCache, this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
@@ -87,6 +89,13 @@ CommitInfoWidget::CommitInfoWidget(const QSharedPointer<RevisionsCache> &cache,
            [this](QListWidgetItem *item) { emit signalOpenFileCommit(mCurrentSha, mParentSha, item->text()); });
    connect(fileListWidget, &FileListWidget::signalShowFileHistory, this, &CommitInfoWidget::signalShowFileHistory);
    connect(fileListWidget, &FileListWidget::signalEditFile, this, &CommitInfoWidget::signalEditFile);
+   connect(fileListWidget, &FileListWidget::signalFilesInserted, this,
+           [this]() { labelModCount->setText(QString("(%1)").arg(fileListWidget->count())); });
+   connect(mCommitDetails, &GitCommitDetails::signalDetailsLoaded, this, [this]() {
+      const auto sha = mCurrentSha;
+      mCurrentSha.clear();
+      configure(sha);
+   });
 }
 
 void CommitInfoWidget::configure(const QString &sha)
@@ -109,17 +118,16 @@ void CommitInfoWidget::configure(const QString &sha)
          mCurrentSha = currentRev.sha();
          mParentSha = currentRev.parent(0);
 
-         QDateTime commitDate = QDateTime::fromSecsSinceEpoch(currentRev.authorDate().toInt());
-         labelSha->setText(sha);
+         // The selected commit can be out of the rows shown, that are the ones whose details are read.
+         if (!currentRev.hasDetails())
+            mCommitDetails->request({ currentRev.id() });
 
-         const auto author = currentRev.committer();
-         const auto authorName = author.split("<").first();
-         const auto email = author.split("<").last().split(">").first();
+         labelSha->setText(sha);
 
-         labelEmail->setText(email);
+         labelEmail->setText(currentRev.committerEmail());
          labelTitle->setText(currentRev.shortLog());
-         labelAuthor->setText(authorName);
-         labelDateTime->setText(commitDate.toString("dd/MM/yyyy hh:mm"));
+         labelAuthor->setText(currentRev.committerName());
+         labelDateTime->setText(DateFormatter::format(currentRev.secsSinceEpoch(), DateFormatter::NUMERIC_FORMAT));
 
          const auto description = currentRev.longLog().trimmed();
          labelDescription->setText(description.isEmpty() ? "No description provided." : description);
@@ -27,6 +27,7 @@
 
 class RevisionsCache;
 class GitBase;
+class GitCommitDetails;
 class QLabel;
 class FileListWidget;
 
@@ -68,4 +69,5 @@ private:
    QLabel *labelEmail = nullptr;
    FileListWidget *fileListWidget = nullptr;
    QLabel *labelModCount = nullptr;
+   GitCommitDetails *mCommitDetails = nullptr;
 };
@@ -10,11 +10,12 @@ HEADERS += \
     $$PWD/FileContextMenu.h \
     $$PWD/FileListDelegate.h \
     $$PWD/FileListWidget.h \
-    $$PWD/FileWidget.h \
     $$PWD/GitQlientRole.h \
     $$PWD/StagedFilesList.h \
     $$PWD/UnstagedMenu.h \
     $$PWD/UntrackedFilesList.h \
+    $$PWD/WipFileDelegate.h \
+    $$PWD/WipFilesModel.h \
     $$PWD/WipWidget.h
 
 SOURCES += \
@@ -24,8 +25,9 @@ SOURCES += \
     $$PWD/FileContextMenu.cpp \
     $$PWD/FileListDelegate.cpp \
     $$PWD/FileListWidget.cpp \
-    $$PWD/FileWidget.cpp \
     $$PWD/StagedFilesList.cpp \
     $$PWD/UnstagedMenu.cpp \
     $$PWD/UntrackedFilesList.cpp \
+    $$PWD/WipFileDelegate.cpp \
+    $$PWD/WipFilesModel.cpp \
     $$PWD/WipWidget.cpp
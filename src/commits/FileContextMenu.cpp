@@ -29,7 +29,7 @@ FileContextMenu::FileContextMenu(const QString &file, QWidget *parent)
 
    const auto copyPathAction = addAction(tr("Copy path"));
    connect(copyPathAction, &QAction::triggered, this, [file]() {
-      QSettings settings;
+      GitQlientSettings settings;
       const auto fullPath = QString("%1/%2").arg(settings.value("WorkingDirectory").toString(), file);
       QApplication::clipboard()->setText(fullPath);
    });
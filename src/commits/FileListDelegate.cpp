@@ -1,6 +1,8 @@
 #include "FileListDelegate.h"
 
+#include <GitQlientRole.h>
 #include <GitQlientStyles.h>
+#include <RevisionFiles.h>
 
 #include <QPainter>
 
@@ -19,10 +21,11 @@ void FileListDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
    else if (option.state & QStyle::State_MouseOver)
       painter->fillRect(option.rect, GitQlientStyles::getGraphHoverColor());
 
-   painter->setPen(qvariant_cast<QColor>(index.data(Qt::ForegroundRole)));
-
    auto newOpt = option;
    newOpt.rect.setX(newOpt.rect.x() + OFFSET);
+   newOpt.rect.setWidth(newOpt.rect.width() - paintLineStats(painter, newOpt, index));
+
+   painter->setPen(qvariant_cast<QColor>(index.data(Qt::ForegroundRole)));
 
    QFontMetrics fm(newOpt.font);
    painter->drawText(newOpt.rect, fm.elidedText(index.data().toString(), Qt::ElideRight, newOpt.rect.width() - OFFSET),
@@ -31,6 +34,40 @@ void FileListDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
    painter->restore();
 }
 
+int FileListDelegate::paintLineStats(QPainter *painter, const QStyleOptionViewItem &option,
+                                     const QModelIndex &index) const
+{
+   const auto added = index.data(GitQlientRole::U_LinesAdded);
+
+   if (!added.isValid())
+      return 0;
+
+   const auto deleted = index.data(GitQlientRole::U_LinesDeleted).toInt();
+   const QFontMetrics fm(option.font);
+   auto rect = option.rect.adjusted(0, 0, -OFFSET, 0);
+   auto width = 0;
+
+   // The stats are painted from the right: the deleted lines, the added ones or the binary mark.
+   const auto paintText = [&](const QString &text, const QColor &color) {
+      painter->setPen(color);
+      painter->drawText(rect, text, QTextOption(Qt::AlignRight | Qt::AlignVCenter));
+
+      const auto textWidth = fm.horizontalAdvance(text) + OFFSET;
+      rect.setWidth(rect.width() - textWidth);
+      width += textWidth;
+   };
+
+   if (added.toInt() == RevisionFiles::BINARY_LINES)
+      paintText(tr("bin"), GitQlientStyles::getTextColor());
+   else
+   {
+      paintText(QString("-%1").arg(deleted), GitQlientStyles::getRed());
+      paintText(QString("+%1").arg(added.toInt()), GitQlientStyles::getGreen());
+   }
+
+   return width + OFFSET;
+}
+
 QSize FileListDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const
 {
    return QSize(option.rect.width(), 25);
@@ -36,4 +36,11 @@ public:
 
 private:
    static const int OFFSET;
+
+   /*!
+    \brief Paints the lines added and deleted in the file, if they are known, at the right of the row.
+
+    \return The width used.
+   */
+   int paintLineStats(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
 };
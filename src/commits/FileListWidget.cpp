@@ -7,6 +7,7 @@
 #include <GitQlientStyles.h>
 #include <RevisionsCache.h>
 #include <GitBase.h>
+#include <GitQlientRole.h>
 
 #include <QApplication>
 #include <QDrag>
@@ -14,6 +15,7 @@
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPalette>
+#include <QScrollBar>
 #include <QMenu>
 #include <QItemDelegate>
 
@@ -31,14 +33,23 @@ FileListWidget::FileListWidget(const QSharedPointer<GitBase> &git, QSharedPointe
 
 FileListWidget::~FileListWidget()
 {
+   if (mRequest != 0)
+      mGit->cancel(mRequest);
+
    delete mFileDelegate;
 }
 
-void FileListWidget::addItem(const QString &label, const QColor &clr)
+void FileListWidget::addItem(const QString &label, const QColor &clr, int linesAdded, int linesDeleted)
 {
    const auto item = new QListWidgetItem(label, this);
    item->setForeground(clr);
    item->setToolTip(label);
+
+   if (linesAdded != RevisionFiles::UNKNOWN_LINES)
+   {
+      item->setData(GitQlientRole::U_LinesAdded, linesAdded);
+      item->setData(GitQlientRole::U_LinesDeleted, linesDeleted);
+   }
 }
 
 void FileListWidget::showContextMenu(const QPoint &pos)
@@ -63,22 +74,82 @@ void FileListWidget::insertFiles(const QString &currentSha, const QString &compa
 {
    clear();
 
-   RevisionFiles files;
-
    if (mCache->containsRevisionFile(currentSha, compareToSha))
-      files = mCache->getRevisionFile(currentSha, compareToSha);
+      showFiles(mCache->getRevisionFile(currentSha, compareToSha));
    else if (!compareToSha.isEmpty())
    {
       QScopedPointer<GitHistory> git(new GitHistory(mGit));
-      const auto ret = git->getDiffFiles(currentSha, compareToSha);
 
-      if (ret.success)
-      {
-         files = mCache->parseDiff(ret.output.toString());
-         mCache->insertRevisionFile(currentSha, compareToSha, files);
-      }
+      // The files are shown first without looking for the copies, that can take much longer than the rest of the
+      // diff. The list is upgraded when the complete files arrive.
+      const auto request = git->getDiffFilesAsync(
+          currentSha, compareToSha, this,
+          [this, currentSha, compareToSha](const GitExecResult &ret) {
+             mRequest = 0;
+
+             if (!ret.success)
+                return;
+
+             showFiles(mCache->parseDiff(ret.output.toString()));
+
+             emit signalFilesInserted();
+
+             upgradeFiles(currentSha, compareToSha);
+          },
+          GitHistory::RenameDetection::Renames);
+
+      // The callback already ran if the files were stored, and it could have started the upgrade.
+      if (request != 0)
+         mRequest = request;
    }
+}
+
+void FileListWidget::upgradeFiles(const QString &currentSha, const QString &compareToSha)
+{
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+
+   mRequest = git->getDiffFilesAsync(
+       currentSha, compareToSha, this,
+       [this, currentSha, compareToSha](const GitExecResult &ret) {
+          mRequest = 0;
 
+          if (!ret.success)
+             return;
+
+          const auto files = mCache->parseDiff(ret.output.toString());
+          mCache->insertRevisionFile(currentSha, compareToSha, files);
+
+          // The list is replaced in place: the file selected and the scroll are kept.
+          const auto selected = currentItem() ? currentItem()->text() : QString();
+          const auto scroll = verticalScrollBar()->value();
+
+          QListWidget::clear();
+          showFiles(files);
+
+          if (const auto items = findItems(selected, Qt::MatchExactly); !selected.isEmpty() && !items.isEmpty())
+             setCurrentItem(items.constFirst());
+
+          verticalScrollBar()->setValue(scroll);
+
+          emit signalFilesInserted();
+       },
+       GitHistory::RenameDetection::Copies, GitBase::Priority::Background);
+}
+
+void FileListWidget::clear()
+{
+   // The files of the previous selection are not shown anymore.
+   if (mRequest != 0)
+   {
+      mGit->cancel(mRequest);
+      mRequest = 0;
+   }
+
+   QListWidget::clear();
+}
+
+void FileListWidget::showFiles(const RevisionFiles &files)
+{
    if (files.count() != 0)
    {
       setUpdatesEnabled(false);
@@ -104,7 +175,7 @@ void FileListWidget::insertFiles(const QString &currentSha, const QString &compa
                fileName = files.getFile(i);
             }
 
-            addItem(fileName, clr);
+            addItem(fileName, clr, files.linesAdded(i), files.linesDeleted(i));
          }
       }
 
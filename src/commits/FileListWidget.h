@@ -28,6 +28,7 @@
 class GitBase;
 class RevisionsCache;
 class FileListDelegate;
+class RevisionFiles;
 
 class FileListWidget : public QListWidget
 {
@@ -43,19 +44,37 @@ signals:
     * @param column The column
     */
    void signalEditFile(const QString &fileName, int line, int column);
+   /**
+    * @brief Signal triggered when the files read from git are shown.
+    */
+   void signalFilesInserted();
 
 public:
    explicit FileListWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                            QWidget *parent = nullptr);
    ~FileListWidget() override;
 
+   /**
+    * @brief Shows the files changed between two commits. The files that are not in the cache are read from git without
+    * blocking: the list is filled when they arrive, unless other files are requested before.
+    *
+    * @param currentSha The commit.
+    * @param compareToSha The commit to compare to.
+    */
    void insertFiles(const QString &currentSha, const QString &compareToSha);
+   /**
+    * @brief Clears the list and cancels the files being read from git.
+    */
+   void clear();
 
 private:
    QSharedPointer<GitBase> mGit;
    QSharedPointer<RevisionsCache> mCache;
    FileListDelegate *mFileDelegate = nullptr;
+   int mRequest = 0;
 
    void showContextMenu(const QPoint &);
-   void addItem(const QString &label, const QColor &clr);
+   void addItem(const QString &label, const QColor &clr, int linesAdded, int linesDeleted);
+   void showFiles(const RevisionFiles &files);
+   void upgradeFiles(const QString &currentSha, const QString &compareToSha);
 };
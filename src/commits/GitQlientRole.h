@@ -29,5 +29,7 @@ enum GitQlientRole
 {
    U_ListRole = Qt::UserRole,
    U_IsConflict,
-   U_Name
+   U_Name,
+   U_LinesAdded,
+   U_LinesDeleted
 };
@@ -5,27 +5,27 @@
 #include <QMenu>
 
 StagedFilesList::StagedFilesList(QWidget *parent)
-   : QListWidget(parent)
+   : QListView(parent)
 {
-   connect(this, &QListWidget::customContextMenuRequested, this, &StagedFilesList::onContextMenu);
-   connect(this, &QListWidget::itemDoubleClicked, this, &StagedFilesList::onShowDiff);
+   setUniformItemSizes(true);
+
+   connect(this, &QListView::customContextMenuRequested, this, &StagedFilesList::onContextMenu);
+   connect(this, &QListView::doubleClicked, this, &StagedFilesList::onDoubleClick);
 }
 
 void StagedFilesList::onContextMenu(const QPoint &pos)
 {
-   if (mSelectedItem = itemAt(pos); mSelectedItem != nullptr)
+   if (const auto index = indexAt(pos); index.isValid())
    {
-      const auto menu = new QMenu(this);
+      mSelectedFile = index.data(GitQlientRole::U_Name).toString();
 
-      if (mSelectedItem->flags() & Qt::ItemIsSelectable)
-      {
-         const auto itemOriginalList = qvariant_cast<QListWidget *>(mSelectedItem->data(GitQlientRole::U_ListRole));
+      const auto menu = new QMenu(this);
 
-         if (sender() == itemOriginalList)
-            connect(menu->addAction("Reset"), &QAction::triggered, this, &StagedFilesList::onResetFile);
-         else
-            connect(menu->addAction("See changes"), &QAction::triggered, this, &StagedFilesList::onShowDiff);
-      }
+      // The files that are not selectable were in the index already, the rest were added to the commit in the list.
+      if (index.flags() & Qt::ItemIsSelectable)
+         connect(menu->addAction("See changes"), &QAction::triggered, this, &StagedFilesList::onShowDiff);
+      else
+         connect(menu->addAction("Reset"), &QAction::triggered, this, &StagedFilesList::onResetFile);
 
       menu->popup(mapToGlobal(mapToParent(pos)));
    }
@@ -33,15 +33,15 @@ void StagedFilesList::onContextMenu(const QPoint &pos)
 
 void StagedFilesList::onResetFile()
 {
-   emit signalResetFile(mSelectedItem);
+   emit signalResetFile(mSelectedFile);
 }
 
 void StagedFilesList::onShowDiff()
 {
-   emit signalShowDiff(mSelectedItem->toolTip());
+   emit signalShowDiff(mSelectedFile);
 }
 
-void StagedFilesList::onDoubleClick(QListWidgetItem *item)
+void StagedFilesList::onDoubleClick(const QModelIndex &index)
 {
-   emit signalShowDiff(item->toolTip());
+   emit signalShowDiff(index.data(GitQlientRole::U_Name).toString());
 }
@@ -23,24 +23,24 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QListWidget>
+#include <QListView>
 
-class StagedFilesList : public QListWidget
+class StagedFilesList : public QListView
 {
    Q_OBJECT
 
 signals:
-   void signalResetFile(QListWidgetItem *item);
+   void signalResetFile(const QString &fileName);
    void signalShowDiff(const QString &fileName);
 
 public:
    explicit StagedFilesList(QWidget *parent);
 
 private:
-   QListWidgetItem *mSelectedItem = nullptr;
+   QString mSelectedFile;
 
    void onContextMenu(const QPoint &pos);
    void onResetFile();
    void onShowDiff();
-   void onDoubleClick(QListWidgetItem *item);
+   void onDoubleClick(const QModelIndex &index);
 };
@@ -9,14 +9,34 @@
 #include <QDir>
 #include <QMessageBox>
 
-UnstagedMenu::UnstagedMenu(const QSharedPointer<GitBase> &git, const QString &fileName, bool hasConflicts,
+UnstagedMenu::UnstagedMenu(const QSharedPointer<GitBase> &git, const QStringList &fileNames, bool hasConflicts,
                            QWidget *parent)
    : QMenu(parent)
    , mGit(git)
-   , mFileName(fileName)
+   , mFileNames(fileNames)
+   , mFileName(fileNames.value(0))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
+   if (mFileNames.count() > 1)
+   {
+      connect(addAction(tr("Stage files")), &QAction::triggered, this, &UnstagedMenu::signalStageFile);
+      connect(addAction(tr("Revert files changes")), &QAction::triggered, this, [this]() {
+         const auto msgBoxRet
+             = QMessageBox::question(this, tr("Reverting files"), tr("Are you sure you want to revert the changes?"));
+
+         if (msgBoxRet == QMessageBox::Yes)
+         {
+            QScopedPointer<GitLocal> git(new GitLocal(mGit));
+            const auto ret = git->checkoutFiles(mFileNames);
+
+            emit signalCheckedOut(ret);
+         }
+      });
+
+      return;
+   }
+
    connect(addAction("See changes"), &QAction::triggered, this, [this]() { emit signalShowDiff(mFileName); });
    connect(addAction("Blame"), &QAction::triggered, this, [this]() { emit signalShowFileHistory(mFileName); });
 
@@ -42,11 +42,21 @@ signals:
    void signalStageFile();
 
 public:
-   explicit UnstagedMenu(const QSharedPointer<GitBase> &git, const QString &fileName, bool hasConflicts,
+   /*!
+    \brief Builds the menu for the files the user clicked on. With several files only the stage and revert actions,
+    that apply to all of them, are available.
+
+    \param git The git object to perform Git operations.
+    \param fileNames The files the menu applies to.
+    \param hasConflicts True if the file has conflicts. Only used for a single file.
+    \param parent The parent widget if needed.
+   */
+   explicit UnstagedMenu(const QSharedPointer<GitBase> &git, const QStringList &fileNames, bool hasConflicts,
                          QWidget *parent = nullptr);
 
 private:
    QSharedPointer<GitBase> mGit;
+   QStringList mFileNames;
    QString mFileName;
 
    bool addEntryToGitIgnore(const QString &entry);
@@ -1,22 +1,50 @@
 #include "UntrackedFilesList.h"
 
+#include <GitQlientRole.h>
+
+#include <QItemSelectionModel>
 #include <QMenu>
 #include <QProcess>
 
 UntrackedFilesList::UntrackedFilesList(QWidget *parent)
-   : QListWidget(parent)
+   : QListView(parent)
 {
-   connect(this, &QListWidget::customContextMenuRequested, this, &UntrackedFilesList::onContextMenu);
-   connect(this, &QListWidget::itemDoubleClicked, this, &UntrackedFilesList::onDoubleClick);
+   setUniformItemSizes(true);
+
+   connect(this, &QListView::customContextMenuRequested, this, &UntrackedFilesList::onContextMenu);
+   connect(this, &QListView::doubleClicked, this, &UntrackedFilesList::onDoubleClick);
 }
 
 void UntrackedFilesList::onContextMenu(const QPoint &pos)
 {
-   if (mSelectedItem = itemAt(pos); mSelectedItem != nullptr)
+   if (const auto index = indexAt(pos); index.isValid())
    {
+      mSelectedFiles.clear();
+
+      // The actions of a row that is part of the selection apply to all the selected rows.
+      if (selectionModel()->isSelected(index))
+      {
+         const auto rows = selectionModel()->selectedRows();
+
+         for (const auto &row : rows)
+            mSelectedFiles.append(row.data(GitQlientRole::U_Name).toString());
+      }
+      else
+         mSelectedFiles.append(index.data(GitQlientRole::U_Name).toString());
+
       const auto contextMenu = new QMenu(this);
-      connect(contextMenu->addAction(tr("Stage file")), &QAction::triggered, this, &UntrackedFilesList::onStageFile);
-      connect(contextMenu->addAction(tr("Delete file")), &QAction::triggered, this, &UntrackedFilesList::onDeleteFile);
+
+      if (mSelectedFiles.count() == 1)
+      {
+         connect(contextMenu->addAction(tr("Stage file")), &QAction::triggered, this, &UntrackedFilesList::onStageFile);
+         connect(contextMenu->addAction(tr("Delete file")), &QAction::triggered, this,
+                 &UntrackedFilesList::onDeleteFile);
+      }
+      else
+      {
+         connect(contextMenu->addAction(tr("Stage files")), &QAction::triggered, this,
+                 &UntrackedFilesList::onStageFile);
+      }
 
       contextMenu->popup(mapToGlobal(mapToParent(pos)));
    }
@@ -24,20 +52,20 @@ void UntrackedFilesList::onContextMenu(const QPoint &pos)
 
 void UntrackedFilesList::onStageFile()
 {
-   emit signalStageFile(mSelectedItem);
+   emit signalStageFiles(mSelectedFiles);
 }
 
 void UntrackedFilesList::onDeleteFile()
 {
    QProcess p;
    p.setWorkingDirectory(mWorkingDir);
-   p.start(QString("rm -rf %1").arg(mSelectedItem->toolTip()));
+   p.start(QString("rm -rf %1").arg(mSelectedFiles.constFirst()));
 
    if (p.waitForFinished())
       emit signalCheckoutPerformed();
 }
 
-void UntrackedFilesList::onDoubleClick(QListWidgetItem *item)
+void UntrackedFilesList::onDoubleClick(const QModelIndex &index)
 {
-   emit signalShowDiff(item->toolTip());
+   emit signalShowDiff(index.data(GitQlientRole::U_Name).toString());
 }
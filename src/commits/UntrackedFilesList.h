@@ -23,14 +23,14 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QListWidget>
+#include <QListView>
 
-class UntrackedFilesList : public QListWidget
+class UntrackedFilesList : public QListView
 {
    Q_OBJECT
 
 signals:
-   void signalStageFile(QListWidgetItem *item);
+   void signalStageFiles(const QStringList &fileNames);
    void signalCheckoutPerformed();
    void signalShowDiff(const QString &fileName);
 
@@ -40,10 +40,10 @@ public:
 
 private:
    QString mWorkingDir;
-   QListWidgetItem *mSelectedItem = nullptr;
+   QStringList mSelectedFiles;
 
    void onContextMenu(const QPoint &pos);
    void onStageFile();
    void onDeleteFile();
-   void onDoubleClick(QListWidgetItem *item);
+   void onDoubleClick(const QModelIndex &index);
 };
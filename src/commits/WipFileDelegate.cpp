@@ -0,0 +1,67 @@
+#include "WipFileDelegate.h"
+
+#include <GitQlientStyles.h>
+
+#include <QMouseEvent>
+#include <QPainter>
+
+const int WipFileDelegate::OFFSET = 5;
+const int WipFileDelegate::BUTTON_SIZE = 15;
+const int WipFileDelegate::ROW_HEIGHT = 25;
+
+WipFileDelegate::WipFileDelegate(QObject *parent)
+   : QItemDelegate(parent)
+{
+}
+
+void WipFileDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+   painter->save();
+
+   if (option.state & QStyle::State_Selected)
+      painter->fillRect(option.rect, GitQlientStyles::getGraphSelectionColor());
+   else if (option.state & QStyle::State_MouseOver)
+      painter->fillRect(option.rect, GitQlientStyles::getGraphHoverColor());
+
+   const auto button = buttonRect(option.rect);
+   qvariant_cast<QIcon>(index.data(Qt::DecorationRole)).paint(painter, button);
+
+   auto textRect = option.rect;
+   textRect.setLeft(button.right() + OFFSET);
+
+   painter->setPen(qvariant_cast<QColor>(index.data(Qt::ForegroundRole)));
+
+   QFontMetrics fm(option.font);
+   painter->drawText(textRect, fm.elidedText(index.data().toString(), Qt::ElideRight, textRect.width() - OFFSET),
+                     QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
+
+   painter->restore();
+}
+
+QSize WipFileDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const
+{
+   return QSize(option.rect.width(), ROW_HEIGHT);
+}
+
+bool WipFileDelegate::editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                                  const QModelIndex &index)
+{
+   if (event->type() == QEvent::MouseButtonRelease)
+   {
+      const auto mouseEvent = static_cast<QMouseEvent *>(event);
+
+      if (mouseEvent->button() == Qt::LeftButton && buttonRect(option.rect).contains(mouseEvent->pos()))
+      {
+         emit signalButtonClicked(index);
+         return true;
+      }
+   }
+
+   return QItemDelegate::editorEvent(event, model, option, index);
+}
+
+QRect WipFileDelegate::buttonRect(const QRect &rowRect)
+{
+   return QRect(rowRect.left() + OFFSET, rowRect.top() + (rowRect.height() - BUTTON_SIZE) / 2, BUTTON_SIZE,
+                BUTTON_SIZE);
+}
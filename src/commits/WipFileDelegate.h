@@ -0,0 +1,61 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QItemDelegate>
+
+/*!
+ \brief The WipFileDelegate class paints the rows of the lists of files of the commit widgets: the button to move the
+ file between the lists and the name of the file, with the color of its status. All the rows have the same height.
+
+*/
+class WipFileDelegate : public QItemDelegate
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the button of a row is clicked.
+
+    \param index The index of the row.
+   */
+   void signalButtonClicked(const QModelIndex &index);
+
+public:
+   explicit WipFileDelegate(QObject *parent = nullptr);
+
+   void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+   QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const override;
+
+protected:
+   bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                    const QModelIndex &index) override;
+
+private:
+   static const int OFFSET;
+   static const int BUTTON_SIZE;
+   static const int ROW_HEIGHT;
+
+   static QRect buttonRect(const QRect &rowRect);
+};
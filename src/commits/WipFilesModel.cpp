@@ -0,0 +1,209 @@
+#include "WipFilesModel.h"
+
+#include <GitQlientRole.h>
+#include <GitQlientStyles.h>
+#include <RevisionFiles.h>
+
+#include <QColor>
+
+#include <algorithm>
+
+WipFilesModel::WipFilesModel(const QIcon &icon, bool isCommitList, QObject *parent)
+   : QAbstractListModel(parent)
+   , mIcon(icon)
+   , mIsCommitList(isCommitList)
+{
+}
+
+int WipFilesModel::rowCount(const QModelIndex &parent) const
+{
+   return parent.isValid() ? 0 : mFiles.count();
+}
+
+QVariant WipFilesModel::data(const QModelIndex &index, int role) const
+{
+   if (!index.isValid() || index.row() >= mFiles.count())
+      return QVariant();
+
+   const auto &file = mFiles.at(index.row());
+   const auto isConflict = (file.status & RevisionFiles::CONFLICT) != 0;
+
+   switch (role)
+   {
+      case Qt::DisplayRole:
+         return isConflict && !mIsCommitList ? QString("%1 (conflicts)").arg(file.name) : file.name;
+      case Qt::ToolTipRole:
+         return file.name;
+      case Qt::ForegroundRole:
+         return colorForStatus(file.status);
+      case Qt::DecorationRole:
+         return mIcon;
+      case GitQlientRole::U_Name:
+         return file.name;
+      case GitQlientRole::U_IsConflict:
+         return isConflict;
+      default:
+         return QVariant();
+   }
+}
+
+Qt::ItemFlags WipFilesModel::flags(const QModelIndex &index) const
+{
+   if (!index.isValid() || index.row() >= mFiles.count())
+      return Qt::NoItemFlags;
+
+   // The files that start in the list to commit are already in the index: they can be reset, but not moved.
+   if (mIsCommitList && mFiles.at(index.row()).origin == this)
+      return Qt::ItemIsEnabled;
+
+   return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+WipFilesModel::File WipFilesModel::fromRevisionFiles(const RevisionFiles &files, int index)
+{
+   File file;
+   file.name = files.getFile(index);
+
+   for (const auto flag :
+        { RevisionFiles::MODIFIED, RevisionFiles::DELETED, RevisionFiles::NEW, RevisionFiles::RENAMED,
+          RevisionFiles::COPIED, RevisionFiles::UNKNOWN, RevisionFiles::IN_INDEX, RevisionFiles::CONFLICT })
+   {
+      if (files.statusCmp(index, flag))
+         file.status |= flag;
+   }
+
+   return file;
+}
+
+QColor WipFilesModel::colorForStatus(int status)
+{
+   const auto isUnknown = status & RevisionFiles::UNKNOWN;
+   const auto isInIndex = status & RevisionFiles::IN_INDEX;
+
+   if (status & RevisionFiles::CONFLICT)
+      return GitQlientStyles::getBlue();
+   else if (status & RevisionFiles::DELETED)
+      return GitQlientStyles::getRed();
+   else if (!isInIndex && isUnknown)
+      return GitQlientStyles::getOrange();
+   else if (status & RevisionFiles::NEW || isUnknown || isInIndex)
+      return GitQlientStyles::getGreen();
+
+   return GitQlientStyles::getTextColor();
+}
+
+void WipFilesModel::appendFiles(const QVector<File> &files)
+{
+   if (files.isEmpty())
+      return;
+
+   beginInsertRows(QModelIndex(), mFiles.count(), mFiles.count() + files.count() - 1);
+   mFiles.append(files);
+   endInsertRows();
+}
+
+void WipFilesModel::removeFiles(const QSet<QString> &names)
+{
+   if (names.isEmpty())
+      return;
+
+   // From the end, so the rows of the ranges not removed yet don't move.
+   for (auto last = mFiles.count() - 1; last >= 0; --last)
+   {
+      if (!names.contains(mFiles.at(last).name))
+         continue;
+
+      auto first = last;
+
+      while (first > 0 && names.contains(mFiles.at(first - 1).name))
+         --first;
+
+      beginRemoveRows(QModelIndex(), first, last);
+      mFiles.erase(mFiles.begin() + first, mFiles.begin() + last + 1);
+      endRemoveRows();
+
+      last = first;
+   }
+}
+
+WipFilesModel::File WipFilesModel::takeFile(const QString &name)
+{
+   const auto row = rowOf(name);
+
+   if (row == -1)
+      return File();
+
+   beginRemoveRows(QModelIndex(), row, row);
+   const auto file = mFiles.takeAt(row);
+   endRemoveRows();
+
+   return file;
+}
+
+QVector<WipFilesModel::File> WipFilesModel::takeFiles()
+{
+   beginResetModel();
+   const auto files = std::move(mFiles);
+   mFiles.clear();
+   endResetModel();
+
+   return files;
+}
+
+QVector<WipFilesModel::File> WipFilesModel::takeFiles(const QSet<QString> &names)
+{
+   QVector<File> files;
+
+   for (const auto &file : qAsConst(mFiles))
+   {
+      if (names.contains(file.name))
+         files.append(file);
+   }
+
+   removeFiles(names);
+
+   return files;
+}
+
+void WipFilesModel::clear()
+{
+   beginResetModel();
+   mFiles.clear();
+   endResetModel();
+}
+
+QStringList WipFilesModel::fileNames() const
+{
+   QStringList names;
+   names.reserve(mFiles.count());
+
+   for (const auto &file : mFiles)
+      names.append(file.name);
+
+   return names;
+}
+
+bool WipFilesModel::hasConflicts() const
+{
+   return std::any_of(mFiles.cbegin(), mFiles.cend(),
+                      [](const File &file) { return file.status & RevisionFiles::CONFLICT; });
+}
+
+void WipFilesModel::resolveConflict(const QString &name)
+{
+   if (const auto row = rowOf(name); row != -1)
+   {
+      mFiles[row].status = (mFiles.at(row).status & ~RevisionFiles::CONFLICT) | RevisionFiles::IN_INDEX;
+
+      emit dataChanged(index(row), index(row));
+   }
+}
+
+int WipFilesModel::rowOf(const QString &name) const
+{
+   for (auto row = 0; row < mFiles.count(); ++row)
+      if (mFiles.at(row).name == name)
+         return row;
+
+   return -1;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractListModel>
+#include <QIcon>
+#include <QSet>
+#include <QVector>
+
+class RevisionFiles;
+
+/*!
+ \brief The WipFilesModel class holds one of the lists of files of the commit widgets: untracked, unstaged or staged.
+ The rows only store the name and the status of the files. The colors, texts and tooltips are built when the view asks
+ for them, so only the visible rows cost something.
+
+*/
+class WipFilesModel : public QAbstractListModel
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief A file of the list.
+   */
+   struct File
+   {
+      QString name;
+      int status = 0; /*!< The RevisionFiles::StatusFlag of the file. */
+      WipFilesModel *origin = nullptr; /*!< The list where the file goes back when it's removed from the commit. */
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param icon The icon of the button of every row.
+    \param isCommitList True for the list of files to commit. The files that start there can't be moved out.
+    \param parent The parent object if needed.
+   */
+   explicit WipFilesModel(const QIcon &icon, bool isCommitList = false, QObject *parent = nullptr);
+
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   QVariant data(const QModelIndex &index, int role) const override;
+   Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+   /*!
+    \brief Builds a file from the status of a file in a RevisionFiles.
+
+    \param files The files of a commit.
+    \param index The index of the file.
+    \return File The file, without origin.
+   */
+   static File fromRevisionFiles(const RevisionFiles &files, int index);
+   /*!
+    \brief Returns the color a file is shown with, depending on its status.
+
+    \param status The RevisionFiles::StatusFlag of the file.
+    \return QColor The color.
+   */
+   static QColor colorForStatus(int status);
+   /*!
+    \brief Appends some files at the end of the list, notifying the view once.
+
+    \param files The files to append.
+   */
+   void appendFiles(const QVector<File> &files);
+   /*!
+    \brief Removes some files of the list. Every range of consecutive rows is notified once.
+
+    \param names The names of the files to remove.
+   */
+   void removeFiles(const QSet<QString> &names);
+   /*!
+    \brief Removes a file of the list and returns it.
+
+    \param name The name of the file.
+    \return File The file removed. The name is empty if it was not in the list.
+   */
+   File takeFile(const QString &name);
+   /*!
+    \brief Removes all the files of the list and returns them.
+
+    \return QVector<File> The files removed.
+   */
+   QVector<File> takeFiles();
+   /*!
+    \brief Removes some files of the list and returns them in the order they had in the list.
+
+    \param names The names of the files to remove.
+    \return QVector<File> The files removed.
+   */
+   QVector<File> takeFiles(const QSet<QString> &names);
+   /*!
+    \brief Removes all the files of the list.
+   */
+   void clear();
+   /*!
+    \brief Returns the file of a row.
+
+    \param row The row.
+    \return const File & The file.
+   */
+   const File &file(int row) const { return mFiles.at(row); }
+   /*!
+    \brief Returns the names of all the files of the list.
+
+    \return QStringList The names.
+   */
+   QStringList fileNames() const;
+   /*!
+    \brief Tells if any file of the list has conflicts.
+
+    \return bool True if there are conflicts, otherwise false.
+   */
+   bool hasConflicts() const;
+   /*!
+    \brief Marks the conflicts of a file as resolved. The file is shown as added to the index.
+
+    \param name The name of the file.
+   */
+   void resolveConflict(const QString &name);
+   /*!
+    \brief Returns the row of a file.
+
+    \param name The name of the file.
+    \return int The row, or -1 if the file is not in the list.
+   */
+   int rowOf(const QString &name) const;
+
+private:
+   QIcon mIcon;
+   bool mIsCommitList = false;
+   QVector<File> mFiles;
+};
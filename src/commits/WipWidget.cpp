@@ -7,8 +7,7 @@
 #include <GitLocal.h>
 #include <UnstagedMenu.h>
 #include <GitBase.h>
-#include <FileWidget.h>
-#include <GitQlientStyles.h>
+#include <WipFilesModel.h>
 
 #include <QMessageBox>
 
@@ -41,14 +40,54 @@ void WipWidget::configure(const QString &sha)
 
    prepareCache();
 
-   insertFiles(files, ui->unstagedFilesList);
+   insertFiles(files, mUnstagedModel);
 
    clearCache();
 
-   ui->lUnstagedCount->setText(QString("(%1)").arg(ui->unstagedFilesList->count()));
-   ui->lStagedCount->setText(QString("(%1)").arg(ui->stagedFilesList->count()));
+   updateCounters();
    ui->teDescription->moveCursor(QTextCursor::Start);
-   ui->pbCommit->setEnabled(ui->stagedFilesList->count());
+}
+
+void WipWidget::updatePaths(const QStringList &paths)
+{
+   const auto commit = mCache->getCommitInfo(CommitInfo::ZERO_SHA);
+
+   if (commit.parentsCount() <= 0)
+      return;
+
+   if (!mCache->containsRevisionFile(CommitInfo::ZERO_SHA, commit.parent(0)))
+   {
+      configure(CommitInfo::ZERO_SHA);
+      return;
+   }
+
+   QLog_Info("UI", QString("Updating {%1} paths of the WIP").arg(paths.count()));
+
+   // The items of the paths changed are created again, so they go to the list of their new status.
+   const auto pathsSet = paths.toSet();
+   QSet<QString> affectedFiles;
+
+   for (auto iter = mCurrentFilesCache.cbegin(); iter != mCurrentFilesCache.cend(); ++iter)
+      if (RevisionFiles::isInPaths(iter.key(), pathsSet))
+         affectedFiles.insert(iter.key());
+
+   removeCachedFiles(affectedFiles);
+
+   const auto files = mCache->getRevisionFile(CommitInfo::ZERO_SHA, commit.parent(0));
+
+   prepareCache();
+
+   insertFiles(files, mUnstagedModel);
+
+   clearCache();
+
+   updateCounters();
+}
+
+void WipWidget::updateCounters()
+{
+   updateFilesCounters();
+   ui->pbCommit->setEnabled(mStagedModel->rowCount());
 }
 
 bool WipWidget::commitChanges()
@@ -90,13 +129,14 @@ bool WipWidget::commitChanges()
 
 void WipWidget::showUnstagedMenu(const QPoint &pos)
 {
-   const auto item = ui->unstagedFilesList->itemAt(pos);
+   const auto index = ui->unstagedFilesList->indexAt(pos);
 
-   if (item)
+   if (index.isValid())
    {
-      const auto fileName = item->toolTip();
-      const auto unsolvedConflicts = item->data(GitQlientRole::U_IsConflict).toBool();
-      const auto contextMenu = new UnstagedMenu(mGit, fileName, unsolvedConflicts, this);
+      const auto fileName = index.data(GitQlientRole::U_Name).toString();
+      const auto unsolvedConflicts = index.data(GitQlientRole::U_IsConflict).toBool();
+      const auto fileNames = selectedFiles(index);
+      const auto contextMenu = new UnstagedMenu(mGit, fileNames, unsolvedConflicts, this);
       connect(contextMenu, &UnstagedMenu::signalEditFile, this,
               [this, fileName]() { emit signalEditFile(mGit->getWorkingDir() + "/" + fileName, 0, 0); });
       connect(contextMenu, &UnstagedMenu::signalShowDiff, this, &WipWidget::requestDiff);
@@ -104,13 +144,10 @@ void WipWidget::showUnstagedMenu(const QPoint &pos)
       connect(contextMenu, &UnstagedMenu::signalRevertAll, this, &WipWidget::revertAllChanges);
       connect(contextMenu, &UnstagedMenu::signalCheckedOut, this, &WipWidget::signalCheckoutPerformed);
       connect(contextMenu, &UnstagedMenu::signalShowFileHistory, this, &WipWidget::signalShowFileHistory);
-      connect(contextMenu, &UnstagedMenu::signalStageFile, this, [this, item] { addFileToCommitList(item); });
-      connect(contextMenu, &UnstagedMenu::signalConflictsResolved, this, [this, item] {
-         const auto fileWidget = qobject_cast<FileWidget *>(ui->unstagedFilesList->itemWidget(item));
-
-         item->setData(GitQlientRole::U_IsConflict, false);
-         item->setText(fileWidget->text().remove("(conflicts)").trimmed());
-         item->setForeground(GitQlientStyles::getGreen());
+      connect(contextMenu, &UnstagedMenu::signalStageFile, this,
+              [this, fileNames] { addFilesToCommitList(fileNames); });
+      connect(contextMenu, &UnstagedMenu::signalConflictsResolved, this, [this, fileName] {
+         mUnstagedModel->resolveConflict(fileName);
          configure(mCurrentSha);
       });
 
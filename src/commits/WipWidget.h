@@ -25,8 +25,6 @@
 
 #include <CommitChangesWidget.h>
 
-class QListWidget;
-class QListWidgetItem;
 class RevisionsCache;
 class GitBase;
 class RevisionFiles;
@@ -47,8 +45,16 @@ public:
    ~WipWidget() = default;
 
    void configure(const QString &sha) override;
+   /*!
+    \brief Updates the files of some paths, that the WIP commit has already updated. The items of the rest of the
+    files are kept as they are.
+
+    \param paths The files or directories changed, relative to the root of the repository.
+   */
+   void updatePaths(const QStringList &paths);
 
 private:
    bool commitChanges() override;
    void showUnstagedMenu(const QPoint &pos) override;
+   void updateCounters();
 };
@@ -6,9 +6,11 @@ FORMS += \
 HEADERS += \
     $$PWD/ConfigWidget.h \
     $$PWD/GeneralConfigPage.h \
-    $$PWD/GitConfigDlg.h
+    $$PWD/GitConfigDlg.h \
+    $$PWD/PerformancePage.h
 
 SOURCES += \
     $$PWD/ConfigWidget.cpp \
     $$PWD/GeneralConfigPage.cpp \
-    $$PWD/GitConfigDlg.cpp
+    $$PWD/GitConfigDlg.cpp \
+    $$PWD/PerformancePage.cpp
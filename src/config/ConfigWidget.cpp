@@ -1,10 +1,12 @@
 #include "ConfigWidget.h"
 
 #include <GeneralConfigPage.h>
+#include <PerformancePage.h>
 #include <CreateRepoDlg.h>
 #include <ProgressDlg.h>
 #include <GitQlientSettings.h>
 #include <ClickableFrame.h>
+#include <GitCommandStatsDlg.h>
 #include <GitBase.h>
 #include <GitConfig.h>
 
@@ -59,6 +61,11 @@ ConfigWidget::ConfigWidget(QWidget *parent)
    connect(version, &ClickableFrame::clicked, this, &ConfigWidget::showAbout);
    version->setToolTip(sha);
    repoOptionsLayout->addWidget(version);
+
+   const auto gitStats = new ClickableFrame(tr("Git commands statistics ..."), Qt::AlignLeft | Qt::AlignVCenter);
+   gitStats->setLinkStyle();
+   connect(gitStats, &ClickableFrame::clicked, this, [this]() { GitCommandStatsDlg(this).exec(); });
+   repoOptionsLayout->addWidget(gitStats);
    repoOptionsLayout->addStretch();
 
    const auto usedSubtitle = new QLabel(tr("Configuration"));
@@ -161,6 +168,7 @@ QWidget *ConfigWidget::createConfigWidget()
    mBtnGroup->addButton(new QPushButton(tr("General")), 0);
    mBtnGroup->addButton(new QPushButton(tr("Most used repos")), 1);
    mBtnGroup->addButton(new QPushButton(tr("Recent repos")), 2);
+   mBtnGroup->addButton(new QPushButton(tr("Performance")), 3);
 
    const auto firstBtn = mBtnGroup->button(2);
    firstBtn->setProperty("selected", true);
@@ -202,6 +210,7 @@ QWidget *ConfigWidget::createConfigWidget()
    stackedWidget->addWidget(new GeneralConfigPage());
    stackedWidget->addWidget(mostUsedProjectsFrame);
    stackedWidget->addWidget(projectsFrame);
+   stackedWidget->addWidget(new PerformancePage());
    stackedWidget->setCurrentIndex(2);
 
    connect(mBtnGroup, static_cast<void (QButtonGroup::*)(int)>(&QButtonGroup::buttonClicked), this,
@@ -256,7 +265,6 @@ QWidget *ConfigWidget::createRecentProjectsPage()
    const auto clear = new QPushButton("Clear list");
    clear->setObjectName("warnButton");
    connect(clear, &QPushButton::clicked, this, [this]() {
-      mSettings->sync();
       mSettings->clearRecentProjects();
 
       mRecentProjectsLayout->addWidget(createRecentProjectsPage());
@@ -292,7 +300,6 @@ QWidget *ConfigWidget::createUsedProjectsPage()
    const auto clear = new QPushButton("Clear list");
    clear->setObjectName("warnButton");
    connect(clear, &QPushButton::clicked, this, [this]() {
-      mSettings->sync();
       mSettings->clearMostUsedProjects();
 
       mUsedProjectsLayout->addWidget(createUsedProjectsPage());
@@ -342,7 +349,6 @@ void ConfigWidget::showAbout()
 
 void ConfigWidget::onRepoOpened()
 {
-   mSettings->sync();
    mRecentProjectsLayout->addWidget(createRecentProjectsPage());
    mUsedProjectsLayout->addWidget(createUsedProjectsPage());
 }
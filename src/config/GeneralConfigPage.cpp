@@ -1,6 +1,8 @@
 #include "GeneralConfigPage.h"
 
 #include <GitQlientSettings.h>
+#include <LazyLog.h>
+#include <ResourceBudget.h>
 #include <QLogger.h>
 
 #include <QTimer>
@@ -24,6 +26,11 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    , mStatusLabel(new QLabel())
    , mExternalEditor(new QLineEdit())
    , mStylesSchema(new QComboBox())
+   , mMaxLanes(new QSpinBox())
+   , mAcceleratedGraph(new QCheckBox(tr(" (needs OpenGL and a restart)")))
+   , mMaintenance(new QComboBox())
+   , mMemoryBudget(new QSpinBox())
+   , mConcurrentTasks(new QSpinBox())
    , mReset(new QPushButton(tr("Reset")))
    , mApply(new QPushButton(tr("Apply")))
 
@@ -68,6 +75,36 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    mStylesSchema->addItems({ "dark", "bright" });
    mStylesSchema->setCurrentText(settings.value("colorSchema", "bright").toString());
 
+   mMaxLanes->setRange(0, 500);
+   mMaxLanes->setSpecialValueText(tr("No limit"));
+   mMaxLanes->setToolTip(tr("The lanes beyond the limit are collapsed in one column. It needs a restart."));
+   mMaxLanes->setValue(settings.value("graphMaxLanes", 0).toInt());
+
+   mAcceleratedGraph->setChecked(settings.value("acceleratedGraph", false).toBool());
+
+   mMaintenance->addItem(tr("Ask"), QString("ask"));
+   mMaintenance->addItem(tr("In the background"), QString("background"));
+   mMaintenance->addItem(tr("Never"), QString("never"));
+   mMaintenance->setToolTip(tr("The commit-graph, the multi-pack-index and the untracked cache make git faster."));
+   mMaintenance->setCurrentIndex(mMaintenance->findData(
+       settings.value(GitQlientSettings::MaintenanceKey, GitQlientSettings::MaintenanceValue).toString()));
+
+   mMemoryBudget->setRange(0, 64 * 1024);
+   mMemoryBudget->setSingleStep(64);
+   mMemoryBudget->setSuffix(tr(" MB"));
+   mMemoryBudget->setSpecialValueText(tr("No limit"));
+   mMemoryBudget->setToolTip(tr("The memory all the caches can use together. The least recently used entries are "
+                                "dropped first."));
+   mMemoryBudget->setValue(
+       settings.value(GitQlientSettings::MemoryBudgetMbKey, GitQlientSettings::MemoryBudgetMbValue).toInt());
+
+   mConcurrentTasks->setRange(0, 256);
+   mConcurrentTasks->setSpecialValueText(tr("One per core"));
+   mConcurrentTasks->setToolTip(tr("The tasks that run at the same time in the background threads. The work the user "
+                                   "waits for goes first."));
+   mConcurrentTasks->setValue(
+       settings.value(GitQlientSettings::MaxConcurrentTasksKey, GitQlientSettings::MaxConcurrentTasksValue).toInt());
+
    mStatusLabel->setObjectName("configLabel");
 
    connect(mReset, &QPushButton::clicked, this, &GeneralConfigPage::resetChanges);
@@ -101,6 +138,16 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    layout->addWidget(mExternalEditor, row, 1);
    layout->addWidget(new QLabel(tr("Styles schema")), ++row, 0);
    layout->addWidget(mStylesSchema, row, 1);
+   layout->addWidget(new QLabel(tr("Max graph lanes")), ++row, 0);
+   layout->addWidget(mMaxLanes, row, 1);
+   layout->addWidget(new QLabel(tr("Accelerated history graph")), ++row, 0);
+   layout->addWidget(mAcceleratedGraph, row, 1);
+   layout->addWidget(new QLabel(tr("Repository maintenance")), ++row, 0);
+   layout->addWidget(mMaintenance, row, 1);
+   layout->addWidget(new QLabel(tr("Memory budget of the caches")), ++row, 0);
+   layout->addWidget(mMemoryBudget, row, 1);
+   layout->addWidget(new QLabel(tr("Concurrent background tasks")), ++row, 0);
+   layout->addWidget(mConcurrentTasks, row, 1);
    layout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), ++row, 0, 1, 2);
    layout->addLayout(buttonsLayout, ++row, 0, 1, 2);
 }
@@ -116,6 +163,14 @@ void GeneralConfigPage::resetChanges()
    mExternalEditor->setText(
        settings.value(GitQlientSettings::ExternalEditorKey, GitQlientSettings::ExternalEditorValue).toString());
    mStylesSchema->setCurrentText(settings.value("colorSchema", "bright").toString());
+   mMaxLanes->setValue(settings.value("graphMaxLanes", 0).toInt());
+   mAcceleratedGraph->setChecked(settings.value("acceleratedGraph", false).toBool());
+   mMaintenance->setCurrentIndex(mMaintenance->findData(
+       settings.value(GitQlientSettings::MaintenanceKey, GitQlientSettings::MaintenanceValue).toString()));
+   mMemoryBudget->setValue(
+       settings.value(GitQlientSettings::MemoryBudgetMbKey, GitQlientSettings::MemoryBudgetMbValue).toInt());
+   mConcurrentTasks->setValue(
+       settings.value(GitQlientSettings::MaxConcurrentTasksKey, GitQlientSettings::MaxConcurrentTasksValue).toInt());
 
    QTimer::singleShot(3000, mStatusLabel, &QLabel::clear);
 
@@ -132,12 +187,22 @@ void GeneralConfigPage::applyChanges()
    settings.setValue("autoFormat", mAutoFormat->isChecked());
    settings.setValue(GitQlientSettings::ExternalEditorKey, mExternalEditor->text());
    settings.setValue("colorSchema", mStylesSchema->currentText());
+   settings.setValue("graphMaxLanes", mMaxLanes->value());
+   settings.setValue("acceleratedGraph", mAcceleratedGraph->isChecked());
+   settings.setValue(GitQlientSettings::MaintenanceKey, mMaintenance->currentData().toString());
+   settings.setValue(GitQlientSettings::MemoryBudgetMbKey, mMemoryBudget->value());
+   settings.setValue(GitQlientSettings::MaxConcurrentTasksKey, mConcurrentTasks->value());
 
    QTimer::singleShot(3000, mStatusLabel, &QLabel::clear);
    mStatusLabel->setText(tr("Changes applied! \n Reset is needed if the color schema changed."));
 
    const auto logger = QLoggerManager::getInstance();
    logger->overwriteLogLevel(static_cast<LogLevel>(mLevelCombo->currentIndex()));
+   LazyLog::setLevel(static_cast<LogLevel>(mLevelCombo->currentIndex()));
+   LazyLog::setPaused(mDisableLogs->isChecked());
+
+   ResourceBudget::instance().setMemoryBudget(mMemoryBudget->value());
+   ResourceBudget::instance().setMaxConcurrency(mConcurrentTasks->value());
 
    if (mDisableLogs->isChecked())
       logger->pause();
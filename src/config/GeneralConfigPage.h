@@ -39,6 +39,13 @@ following:
 - Auto-prune: The user can configure the interval where GitQlient performs a prune.
 - Disable logs: The user can enable or disable logs.
 - Log level: The user can configure the level of the logs for GitQlient.
+- Max graph lanes: The user can limit the lanes painted in the graph. The rest are collapsed in one column.
+- Accelerated graph: The user can paint the history views with OpenGL. It needs a restart.
+- Memory budget: The user can limit the memory all the caches take together. The least recently used entries are
+  dropped first.
+- Concurrent tasks: The user can limit the background tasks that run at the same time.
+- Repository maintenance: The user can choose if GitQlient asks before writing the commit-graph, the multi-pack-index
+  and the untracked cache of the repositories, writes them in the background or never does.
 
 */
 class GeneralConfigPage : public QFrame
@@ -62,6 +69,11 @@ private:
    QLabel *mStatusLabel = nullptr;
    QLineEdit *mExternalEditor = nullptr;
    QComboBox *mStylesSchema = nullptr;
+   QSpinBox *mMaxLanes = nullptr;
+   QCheckBox *mAcceleratedGraph = nullptr;
+   QComboBox *mMaintenance = nullptr;
+   QSpinBox *mMemoryBudget = nullptr;
+   QSpinBox *mConcurrentTasks = nullptr;
    QPushButton *mReset = nullptr;
    QPushButton *mApply = nullptr;
 
@@ -0,0 +1,244 @@
+#include "PerformancePage.h"
+
+#include <BlameCache.h>
+#include <DiffCache.h>
+#include <GitCommandStats.h>
+#include <PerformanceMetrics.h>
+#include <ResourceBudget.h>
+#include <TraceRecorder.h>
+
+#include <QCheckBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace
+{
+const int REFRESH_INTERVAL_MS = 1000;
+const int SLOWEST_COMMANDS = 10;
+
+QString toKb(qint64 bytes)
+{
+   return QString("%1 KB").arg(bytes / 1024);
+}
+
+QString hitRate(qint64 hits, qint64 misses)
+{
+   const auto total = hits + misses;
+
+   if (total == 0)
+      return QObject::tr("no requests");
+
+   return QObject::tr("%1% of %2 requests").arg(QString::number(100.0 * hits / total, 'f', 1)).arg(total);
+}
+
+void addStructures(QTreeWidgetItem *parent, const MemoryReport &report)
+{
+   for (const auto &entry : report.entries())
+   {
+      const auto value = QObject::tr("%1 in %2 elements").arg(toKb(entry.bytes)).arg(entry.count);
+      new QTreeWidgetItem(parent, { entry.structure, value });
+   }
+}
+}
+
+PerformancePage::PerformancePage(QWidget *parent)
+   : QFrame(parent)
+   , mTree(new QTreeWidget())
+   , mRecordTrace(new QCheckBox(tr("Record the timeline")))
+   , mTraceStatus(new QLabel())
+   , mRefreshTimer(new QTimer(this))
+{
+   mTree->setColumnCount(2);
+   mTree->setHeaderLabels({ tr("Metric"), tr("Value") });
+   mTree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+   mTree->setSelectionMode(QAbstractItemView::NoSelection);
+
+   mRecordTrace->setChecked(TraceRecorder::instance().isEnabled());
+   connect(mRecordTrace, &QCheckBox::toggled, this,
+           [](bool checked) { TraceRecorder::instance().setEnabled(checked); });
+
+   const auto clearTrace = new QPushButton(tr("Clear"));
+   connect(clearTrace, &QPushButton::clicked, this, [this]() {
+      TraceRecorder::instance().clear();
+      refresh();
+   });
+
+   const auto exportTraceBtn = new QPushButton(tr("Export trace..."));
+   connect(exportTraceBtn, &QPushButton::clicked, this, &PerformancePage::exportTrace);
+
+   const auto traceLayout = new QHBoxLayout();
+   traceLayout->setContentsMargins(QMargins());
+   traceLayout->setSpacing(10);
+   traceLayout->addWidget(mRecordTrace);
+   traceLayout->addWidget(mTraceStatus);
+   traceLayout->addStretch();
+   traceLayout->addWidget(clearTrace);
+   traceLayout->addWidget(exportTraceBtn);
+
+   const auto layout = new QVBoxLayout(this);
+   layout->setContentsMargins(20, 20, 20, 20);
+   layout->setSpacing(10);
+   layout->addWidget(new QLabel(tr("The metrics are updated every second.")));
+   layout->addWidget(mTree);
+   layout->addLayout(traceLayout);
+
+   mRefreshTimer->setInterval(REFRESH_INTERVAL_MS);
+   connect(mRefreshTimer, &QTimer::timeout, this, &PerformancePage::refresh);
+}
+
+void PerformancePage::showEvent(QShowEvent *event)
+{
+   refresh();
+   mRefreshTimer->start();
+
+   QFrame::showEvent(event);
+}
+
+void PerformancePage::hideEvent(QHideEvent *event)
+{
+   mRefreshTimer->stop();
+
+   QFrame::hideEvent(event);
+}
+
+void PerformancePage::refresh()
+{
+   const auto repositories = PerformanceMetrics::instance().repositories();
+   const auto elapsedMs = mSinceRefresh.isValid() ? qMax(mSinceRefresh.restart(), qint64(1)) : qint64(0);
+
+   if (!mSinceRefresh.isValid())
+      mSinceRefresh.start();
+
+   const auto scrollPosition = mTree->verticalScrollBar()->value();
+
+   mTree->clear();
+
+   const auto processes = new QTreeWidgetItem(mTree, { tr("Git processes") });
+   const auto caches = new QTreeWidgetItem(mTree, { tr("Caches") });
+   const auto loading = new QTreeWidgetItem(mTree, { tr("History load") });
+   const auto startup = new QTreeWidgetItem(mTree, { tr("Startup") });
+   const auto paint = new QTreeWidgetItem(mTree, { tr("Paint") });
+   const auto watcher = new QTreeWidgetItem(mTree, { tr("Watcher") });
+   const auto memory = new QTreeWidgetItem(mTree, { tr("Memory") });
+
+   QHash<QString, qint64> watcherEvents;
+
+   for (const auto &repository : repositories)
+   {
+      const auto name = QFileInfo(repository.repository).fileName();
+
+      addMetric(processes, name,
+                tr("%1 running, %2 waiting").arg(repository.runningProcesses).arg(repository.waitingProcesses));
+      addMetric(caches, tr("Files of the commits of %1").arg(name),
+                hitRate(repository.revisionFilesHits, repository.revisionFilesMisses));
+      addMetric(loading, name,
+                repository.loading.totalMs >= 0 ? repository.loading.toString() : tr("not loaded yet"));
+      addMetric(startup, name, repository.startup.toString());
+      addMetric(paint, name,
+                repository.frameTimes.isEmpty() ? tr("enable the frameStatistics setting to measure it")
+                                                : tr("frame (ms): %1").arg(repository.frameTimes));
+
+      // The rate is measured from the last refresh, the first time there is nothing to compare with.
+      const auto previousEvents = mWatcherEvents.value(repository.repository, -1);
+      const auto eventsRate = previousEvents >= 0 && elapsedMs > 0
+          ? QString::number((repository.watcherEvents - previousEvents) * 1000.0 / elapsedMs, 'f', 1)
+          : QString("-");
+
+      watcherEvents.insert(repository.repository, repository.watcherEvents);
+      addMetric(watcher, name, tr("%1 events/s, %2 watches").arg(eventsRate).arg(repository.watchCount));
+
+      addMetric(memory, name,
+                tr("%1 (%2 of commits, %3 of lanes, %4 of files, %5 of indexes, %6 of diffs)")
+                    .arg(toKb(repository.memory.total() + repository.diffsMemory), toKb(repository.memory.commits),
+                         toKb(repository.memory.lanes), toKb(repository.memory.revisionFiles),
+                         toKb(repository.memory.indexes), toKb(repository.diffsMemory)));
+
+      const auto structures = new QTreeWidgetItem(
+          memory, { tr("Structures of %1").arg(name), toKb(repository.memoryByStructure.total()) });
+      addStructures(structures, repository.memoryByStructure);
+   }
+
+   mWatcherEvents = watcherEvents;
+
+   auto commands = GitCommandStats::instance().entries();
+   std::sort(commands.begin(), commands.end(), [](const GitCommandStats::Entry &a, const GitCommandStats::Entry &b) {
+      return a.totalWallMs / a.count > b.totalWallMs / b.count;
+   });
+
+   const auto slowest = new QTreeWidgetItem(processes, { tr("Slowest commands") });
+
+   for (auto i = 0; i < std::min(SLOWEST_COMMANDS, commands.count()); ++i)
+   {
+      const auto &command = commands.at(i);
+
+      addMetric(slowest, command.command,
+                tr("%1 runs, mean %2 ms, max %3 ms")
+                    .arg(command.count)
+                    .arg(command.totalWallMs / command.count)
+                    .arg(command.maxWallMs));
+   }
+
+   const auto diffs = DiffCache::statistics();
+   addMetric(caches, tr("Diffs"),
+             tr("%1, %2 stored in %3").arg(hitRate(diffs.hits, diffs.misses)).arg(diffs.entries).arg(toKb(diffs.cost)));
+
+   const auto blames = BlameCache::statistics();
+   addMetric(caches, tr("Blames"),
+             tr("%1, %2 stored in %3")
+                 .arg(hitRate(blames.hits, blames.misses))
+                 .arg(blames.entries)
+                 .arg(toKb(blames.cost)));
+
+   // The diffs and the blames are shared by all the repositories.
+   auto cachesReport = DiffCache::memoryReport();
+
+   for (const auto &entry : BlameCache::memoryReport().entries())
+      cachesReport.add(entry.structure, entry.count, entry.bytes);
+
+   const auto cachesStructures
+       = new QTreeWidgetItem(memory, { tr("Structures of the diffs and blames"), toKb(cachesReport.total()) });
+   addStructures(cachesStructures, cachesReport);
+
+   const auto &budget = ResourceBudget::instance();
+   const auto budgetMb = budget.memoryBudget();
+   const auto total = budgetMb > 0 ? tr("%1 MB in total").arg(budgetMb) : tr("no global limit");
+   const auto limits = new QTreeWidgetItem(memory, { tr("Limits of the caches"), total });
+
+   for (const auto &cache : budget.caches())
+      addMetric(limits, cache.name, tr("%1 of %2").arg(toKb(cache.usage), toKb(cache.limit)));
+
+   mTree->expandAll();
+   mTree->verticalScrollBar()->setValue(scrollPosition);
+
+   mTraceStatus->setText(tr("%1 spans recorded").arg(TraceRecorder::instance().count()));
+}
+
+void PerformancePage::exportTrace()
+{
+   const auto fileName = QFileDialog::getSaveFileName(this, tr("Export the trace"), QString(), tr("JSON (*.json)"));
+
+   if (fileName.isEmpty())
+      return;
+
+   QFile file(fileName);
+
+   if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(TraceRecorder::instance().toJson()) == -1)
+      QMessageBox::warning(this, tr("Export failed"), tr("The trace couldn't be written to %1.").arg(fileName));
+}
+
+void PerformancePage::addMetric(QTreeWidgetItem *parent, const QString &name, const QString &value)
+{
+   new QTreeWidgetItem(parent, { name, value });
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QElapsedTimer>
+#include <QFrame>
+#include <QHash>
+
+class QCheckBox;
+class QLabel;
+class QTimer;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/*!
+ \brief The PerformancePage shows the live metrics of GitQlient, to diagnose a slow repository without a debugger:
+- Git processes: the processes running and waiting for every repository, and the slowest commands (see
+  GitCommandStats).
+- Caches: the hit rate of the files of the commits of every repository, and the use of the diffs and blames caches.
+- History load: the time of every phase of the last load of every repository.
+- Startup: the time from the opening of every repository until its history, watcher, blame tree and configuration
+  checks were ready, and until all of them were.
+- Paint: the percentiles of the frame times of the history, when the frameStatistics setting is enabled.
+- Watcher: the file system events per second and the watches of every repository.
+- Memory: the memory used by the caches of every repository, and the limits of the caches in the global budget (see
+  ResourceBudget).
+
+The metrics are read every second while the page is visible. The page also records the timeline of the loads and
+refreshes (see TraceRecorder) and exports it as a Chrome trace.
+
+ \class PerformancePage PerformancePage.h "PerformancePage.h"
+*/
+class PerformancePage : public QFrame
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit PerformancePage(QWidget *parent = nullptr);
+
+protected:
+   void showEvent(QShowEvent *event) override;
+   void hideEvent(QHideEvent *event) override;
+
+private:
+   QTreeWidget *mTree = nullptr;
+   QCheckBox *mRecordTrace = nullptr;
+   QLabel *mTraceStatus = nullptr;
+   QTimer *mRefreshTimer = nullptr;
+   QElapsedTimer mSinceRefresh;
+   QHash<QString, qint64> mWatcherEvents;
+
+   /*!
+    \brief Reads the metrics again and shows them.
+   */
+   void refresh();
+   /*!
+    \brief Asks for a file and writes the recorded trace to it.
+   */
+   void exportTrace();
+   /*!
+    \brief Adds a row to the tree.
+
+    \param parent The section of the row.
+    \param name The name of the metric.
+    \param value The value of the metric.
+   */
+   void addMetric(QTreeWidgetItem *parent, const QString &name, const QString &value);
+};
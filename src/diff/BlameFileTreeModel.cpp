@@ -0,0 +1,264 @@
+#include "BlameFileTreeModel.h"
+
+#include <GitHistory.h>
+#include <GitSparseCheckout.h>
+#include <PathHistoryIndex.h>
+#include <RevisionsCache.h>
+#include <CommitInfo.h>
+#include <DateFormatter.h>
+
+#include <QDir>
+
+#include <algorithm>
+
+BlameFileTreeModel::BlameFileTreeModel(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
+                                       PathHistoryIndex *pathIndex, QObject *parent)
+   : QAbstractItemModel(parent)
+   , mCache(cache)
+   , mGit(git)
+   , mPathIndex(pathIndex)
+   , mRoot(new Entry())
+{
+   connect(mPathIndex, &PathHistoryIndex::signalDirectoryAnnotated, this, &BlameFileTreeModel::onDirectoryAnnotated);
+   connect(mPathIndex, &PathHistoryIndex::signalReady, this, &BlameFileTreeModel::onIndexReady);
+}
+
+void BlameFileTreeModel::init(const QString &workingDirectory)
+{
+   beginResetModel();
+
+   mWorkingDirectory = workingDirectory;
+   mSparseCone = GitSparseCheckout(mGit).getConeDirectories();
+   mDirectories.clear();
+   mRoot.reset(new Entry());
+   mRoot->children = loadEntries(mRoot.data());
+   mRoot->fetched = true;
+
+   endResetModel();
+
+   mDirectories.insert(mRoot->path, mRoot.data());
+   mPathIndex->annotateDirectory(mRoot->path);
+}
+
+QString BlameFileTreeModel::filePath(const QModelIndex &index) const
+{
+   const auto item = entry(index);
+
+   return item ? QDir(mWorkingDirectory).filePath(item->path) : QString();
+}
+
+bool BlameFileTreeModel::isFile(const QModelIndex &index) const
+{
+   const auto item = entry(index);
+
+   return item && item->type == Type::File;
+}
+
+QModelIndex BlameFileTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+   const auto directory = parent.isValid() ? entry(parent) : mRoot.data();
+
+   if (!directory || row < 0 || row >= directory->children.count() || column < 0 || column >= columnCount())
+      return QModelIndex();
+
+   return createIndex(row, column, directory->children.at(row));
+}
+
+QModelIndex BlameFileTreeModel::parent(const QModelIndex &index) const
+{
+   const auto item = entry(index);
+
+   if (!item || item->parent == mRoot.data())
+      return QModelIndex();
+
+   return indexOf(item->parent, Column::Name);
+}
+
+int BlameFileTreeModel::rowCount(const QModelIndex &parent) const
+{
+   if (parent.column() > 0)
+      return 0;
+
+   const auto directory = parent.isValid() ? entry(parent) : mRoot.data();
+
+   return directory ? directory->children.count() : 0;
+}
+
+int BlameFileTreeModel::columnCount(const QModelIndex &) const
+{
+   return static_cast<int>(Column::LastCommit) + 1;
+}
+
+bool BlameFileTreeModel::hasChildren(const QModelIndex &parent) const
+{
+   if (parent.column() > 0)
+      return false;
+
+   const auto directory = parent.isValid() ? entry(parent) : mRoot.data();
+
+   // The directories that are not loaded yet show the expand arrow: all the directories of a git tree have files.
+   return directory && directory->type == Type::Directory && (!directory->fetched || !directory->children.isEmpty());
+}
+
+bool BlameFileTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+   const auto directory = parent.isValid() ? entry(parent) : mRoot.data();
+
+   return directory && directory->type == Type::Directory && !directory->fetched;
+}
+
+void BlameFileTreeModel::fetchMore(const QModelIndex &parent)
+{
+   if (canFetchMore(parent))
+      fetch(parent.isValid() ? entry(parent) : mRoot.data(), parent);
+}
+
+QVariant BlameFileTreeModel::data(const QModelIndex &index, int role) const
+{
+   const auto item = entry(index);
+
+   if (!item)
+      return QVariant();
+
+   if (index.column() == static_cast<int>(Column::Name))
+   {
+      switch (role)
+      {
+         case Qt::DisplayRole:
+            return item->name;
+         case Qt::ToolTipRole:
+            return item->path;
+         case Qt::DecorationRole:
+            return mIconProvider.icon(item->type == Type::File ? QFileIconProvider::File : QFileIconProvider::Folder);
+         default:
+            return QVariant();
+      }
+   }
+
+   if ((role != Qt::DisplayRole && role != Qt::ToolTipRole) || item->lastCommit.isEmpty())
+      return QVariant();
+
+   const auto commit = mCache->getCommitInfo(item->lastCommit);
+
+   if (!commit.isValid())
+      return role == Qt::DisplayRole ? item->lastCommit.left(8) : item->lastCommit;
+
+   if (role == Qt::DisplayRole)
+      return commit.shortLog();
+
+   const auto date = DateFormatter::format(commit.secsSinceEpoch());
+
+   return QString("%1\n%2\n%3\n\n%4").arg(item->lastCommit, commit.author(), date, commit.shortLog());
+}
+
+QVariant BlameFileTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+   if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+      return QVariant();
+
+   switch (static_cast<Column>(section))
+   {
+      case Column::Name:
+         return tr("Name");
+      case Column::LastCommit:
+         return tr("Last commit");
+   }
+
+   return QVariant();
+}
+
+BlameFileTreeModel::Entry *BlameFileTreeModel::entry(const QModelIndex &index) const
+{
+   return index.isValid() ? static_cast<Entry *>(index.internalPointer()) : nullptr;
+}
+
+QModelIndex BlameFileTreeModel::indexOf(Entry *entry, Column column) const
+{
+   return createIndex(entry->row, static_cast<int>(column), entry);
+}
+
+QVector<BlameFileTreeModel::Entry *> BlameFileTreeModel::loadEntries(Entry *directory)
+{
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+   const auto ret = git->getTreeEntries(directory->path);
+   QVector<Entry *> entries;
+
+   if (!ret.success)
+      return entries;
+
+   // Every entry is "<mode> <type> <object>\t<path>".
+   for (const auto &line : QString::fromUtf8(ret.output.toByteArray()).split('\0', QString::SkipEmptyParts))
+   {
+      const auto tab = line.indexOf('\t');
+
+      if (tab == -1)
+         continue;
+
+      const auto type = line.section(' ', 1, 1);
+      const auto path = line.mid(tab + 1);
+
+      if (type == "tree" && !GitSparseCheckout::isInCone(mSparseCone, path))
+         continue;
+
+      const auto item = new Entry();
+
+      item->path = mCache->internPath(path);
+      item->name = item->path.mid(item->path.lastIndexOf('/') + 1);
+      item->type = type == "tree" ? Type::Directory : type == "commit" ? Type::Submodule : Type::File;
+      item->fetched = item->type != Type::Directory;
+      item->parent = directory;
+
+      entries.append(item);
+   }
+
+   // The directories go first, like in a file system view.
+   std::sort(entries.begin(), entries.end(), [](const Entry *first, const Entry *second) {
+      if ((first->type == Type::Directory) != (second->type == Type::Directory))
+         return first->type == Type::Directory;
+
+      return first->name.compare(second->name, Qt::CaseInsensitive) < 0;
+   });
+
+   for (auto row = 0; row < entries.count(); ++row)
+      entries.at(row)->row = row;
+
+   return entries;
+}
+
+void BlameFileTreeModel::fetch(Entry *directory, const QModelIndex &parent)
+{
+   const auto entries = loadEntries(directory);
+
+   directory->fetched = true;
+
+   if (!entries.isEmpty())
+   {
+      beginInsertRows(parent, 0, entries.count() - 1);
+      directory->children = entries;
+      endInsertRows();
+   }
+
+   mDirectories.insert(directory->path, directory);
+   mPathIndex->annotateDirectory(directory->path);
+}
+
+void BlameFileTreeModel::onDirectoryAnnotated(const QString &directory, const QHash<QString, QString> &lastCommits)
+{
+   const auto item = mDirectories.value(directory);
+
+   if (!item || item->children.isEmpty())
+      return;
+
+   for (const auto child : qAsConst(item->children))
+      child->lastCommit = lastCommits.value(child->name);
+
+   emit dataChanged(indexOf(item->children.constFirst(), Column::LastCommit),
+                    indexOf(item->children.constLast(), Column::LastCommit), { Qt::DisplayRole, Qt::ToolTipRole });
+}
+
+void BlameFileTreeModel::onIndexReady()
+{
+   // The commits might have changed: the directories loaded so far are annotated again.
+   for (auto iter = mDirectories.cbegin(); iter != mDirectories.cend(); ++iter)
+      mPathIndex->annotateDirectory(iter.key());
+}
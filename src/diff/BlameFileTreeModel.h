@@ -0,0 +1,141 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractItemModel>
+#include <QFileIconProvider>
+#include <QHash>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QVector>
+
+class RevisionsCache;
+class GitBase;
+class PathHistoryIndex;
+
+/*!
+ \brief The BlameFileTreeModel is the tree of the files tracked by git that the blame shows. It's built from git
+ ls-tree one directory at a time, when the directory is expanded, so the working directory is neither walked nor
+ watched. The paths are shared with the ones of the cache.
+
+ Next to every entry it shows the last commit that touched it. The commits of a directory are requested to the
+ PathHistoryIndex when the directory is loaded and they are shown as they arrive.
+
+ \class BlameFileTreeModel BlameFileTreeModel.h "BlameFileTreeModel.h"
+*/
+class BlameFileTreeModel : public QAbstractItemModel
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief The columns of the model.
+   */
+   enum class Column
+   {
+      Name,
+      LastCommit
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param cache The cache of the repository, to get the information of the commits and to share the paths.
+    \param git The git object to perform Git operations.
+    \param pathIndex The index of the history of the paths.
+    \param parent The parent object if needed.
+   */
+   explicit BlameFileTreeModel(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
+                               PathHistoryIndex *pathIndex, QObject *parent = nullptr);
+
+   /*!
+    \brief Loads the root directory of the repository. The directories loaded before are discarded.
+
+    \param workingDirectory The root of the repository.
+   */
+   void init(const QString &workingDirectory);
+   /*!
+    \brief Returns the full path of the entry of an index.
+
+    \param index The index.
+    \return The path.
+   */
+   QString filePath(const QModelIndex &index) const;
+   /*!
+    \brief Tells if the entry of an index is a file that can be blamed. Directories and submodules are not.
+
+    \param index The index.
+    \return True if it is a file, otherwise false.
+   */
+   bool isFile(const QModelIndex &index) const;
+
+   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex parent(const QModelIndex &index) const override;
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+   bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+   bool canFetchMore(const QModelIndex &parent) const override;
+   void fetchMore(const QModelIndex &parent) override;
+   QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+   enum class Type
+   {
+      Directory,
+      File,
+      Submodule
+   };
+
+   struct Entry
+   {
+      ~Entry() { qDeleteAll(children); }
+
+      QString name;
+      QString path;
+      Type type = Type::Directory;
+      bool fetched = false;
+      QString lastCommit;
+      Entry *parent = nullptr;
+      int row = 0;
+      QVector<Entry *> children;
+   };
+
+   QSharedPointer<RevisionsCache> mCache;
+   QSharedPointer<GitBase> mGit;
+   PathHistoryIndex *mPathIndex = nullptr;
+   QString mWorkingDirectory;
+   // The directories checked out in a sparse checkout: the tree only shows them and their parents.
+   QStringList mSparseCone;
+   QScopedPointer<Entry> mRoot;
+   QHash<QString, Entry *> mDirectories;
+   QFileIconProvider mIconProvider;
+
+   Entry *entry(const QModelIndex &index) const;
+   QModelIndex indexOf(Entry *entry, Column column) const;
+   QVector<Entry *> loadEntries(Entry *directory);
+   void fetch(Entry *directory, const QModelIndex &parent);
+   void onDirectoryAnnotated(const QString &directory, const QHash<QString, QString> &lastCommits);
+   void onIndexReady();
+};
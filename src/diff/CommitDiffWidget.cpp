@@ -1,5 +1,6 @@
 #include "CommitDiffWidget.h"
 
+#include <DateFormatter.h>
 #include <FileListWidget.h>
 #include <RevisionsCache.h>
 
@@ -11,6 +12,7 @@ CommitDiffWidget::CommitDiffWidget(QSharedPointer<GitBase> git, QSharedPointer<R
    , mGit(git)
    , mCache(cache)
    , fileListWidget(new FileListWidget(mGit, cache))
+   , mRangeLabel(new QLabel())
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
@@ -23,8 +25,14 @@ CommitDiffWidget::CommitDiffWidget(QSharedPointer<GitBase> git, QSharedPointer<R
    const auto layout = new QVBoxLayout(this);
    layout->setContentsMargins(QMargins());
    layout->setSpacing(10);
+   layout->addWidget(mRangeLabel);
    layout->addWidget(fileListWidget);
 
+   mRangeLabel->setWordWrap(true);
+   mRangeLabel->setVisible(false);
+
+   connect(mRangeLabel, &QLabel::linkActivated, this, [this]() { emit signalHighlightCommits(mRangeRows); });
+
    connect(fileListWidget, &FileListWidget::itemDoubleClicked, this,
            [this](QListWidgetItem *item) { emit signalOpenFileCommit(mFirstShaStr, mSecondShaStr, item->text()); });
    connect(fileListWidget, &FileListWidget::signalShowFileHistory, this, &CommitDiffWidget::signalShowFileHistory);
@@ -38,7 +46,7 @@ void CommitDiffWidget::configure(const QString &firstSha, const QString &secondS
    if (mFirstShaStr != CommitInfo::ZERO_SHA)
    {
       const auto c = mCache->getCommitInfo(mFirstShaStr);
-      const auto dateStr = QDateTime::fromSecsSinceEpoch(c.authorDate().toUInt()).toString("dd MMM yyyy hh:mm");
+      const auto dateStr = DateFormatter::format(c.secsSinceEpoch());
    }
 
    mSecondShaStr = secondSha;
@@ -46,8 +54,44 @@ void CommitDiffWidget::configure(const QString &firstSha, const QString &secondS
    if (mFirstShaStr != CommitInfo::ZERO_SHA)
    {
       const auto c = mCache->getCommitInfo(mSecondShaStr);
-      const auto dateStr = QDateTime::fromSecsSinceEpoch(c.authorDate().toUInt()).toString("dd MMM yyyy hh:mm");
+      const auto dateStr = DateFormatter::format(c.secsSinceEpoch());
    }
 
    fileListWidget->insertFiles(mFirstShaStr, mSecondShaStr);
+
+   updateRange();
+}
+
+void CommitDiffWidget::updateRange()
+{
+   mRangeRows.clear();
+
+   // The range goes from the base, the second SHA, to the first one.
+   const auto range = mCache->getCommitRange(mSecondShaStr, mFirstShaStr, true);
+
+   if (range.rows.isEmpty())
+   {
+      mRangeLabel->setVisible(false);
+      return;
+   }
+
+   for (auto row = 0; row < range.rows.size(); ++row)
+   {
+      if (range.rows.testBit(row))
+         mRangeRows.append(row);
+   }
+
+   const auto base = mSecondShaStr.left(8);
+   const auto tip = mFirstShaStr.left(8);
+   auto text = tr("%1 commits in %2..%3, %4 in %3..%2.")
+                   .arg(QString::number(range.toOnly), base, tip, QString::number(range.fromOnly));
+
+   if (!range.complete)
+      text.prepend(tr("The history loaded is partial. "));
+
+   if (!mRangeRows.isEmpty())
+      text.append(QString(" <a href=\"highlight\">%1</a>").arg(tr("Show in history")));
+
+   mRangeLabel->setText(text);
+   mRangeLabel->setVisible(true);
 }
@@ -24,10 +24,12 @@
  ***************************************************************************************/
 
 #include <QFrame>
+#include <QVector>
 
 class GitBase;
 class FileListWidget;
 class RevisionsCache;
+class QLabel;
 
 /*!
  \brief The CommitDiffWidget creates the layout that contains the information of a commit diff. This widget is located
@@ -69,6 +71,13 @@ signals:
     */
    void signalEditFile(const QString &fileName, int line, int column);
 
+   /*!
+    \brief Signal triggered when the user wants to see the commits between the two SHAs in the history.
+
+    \param rows The rows of the commits, sorted.
+   */
+   void signalHighlightCommits(const QVector<int> &rows);
+
 public:
    /*!
     \brief Default constructor.
@@ -92,6 +101,14 @@ private:
    QSharedPointer<GitBase> mGit;
    QSharedPointer<RevisionsCache> mCache;
    FileListWidget *fileListWidget = nullptr;
+   QLabel *mRangeLabel = nullptr;
    QString mFirstShaStr;
    QString mSecondShaStr;
+   QVector<int> mRangeRows;
+
+   /*!
+    \brief Shows how many commits are between the two SHAs. They are found in the history loaded, so the label is
+    hidden when one of the commits isn't loaded.
+   */
+   void updateRange();
 };
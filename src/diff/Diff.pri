@@ -1,21 +1,47 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/BlameFileTreeModel.h \
     $$PWD/CommitDiffWidget.h \
     $$PWD/DiffButton.h \
+    $$PWD/DiffFileClassifier.h \
+    $$PWD/DiffFindBar.h \
+    $$PWD/DiffHunks.h \
     $$PWD/DiffInfoPanel.h \
+    $$PWD/DiffModel.h \
+    $$PWD/DiffSearch.h \
+    $$PWD/DiffSideBySideView.h \
+    $$PWD/DiffTextView.h \
+    $$PWD/FileBlameLoader.h \
+    $$PWD/FileBlameView.h \
     $$PWD/FileBlameWidget.h \
     $$PWD/FileDiffHighlighter.h \
     $$PWD/FileDiffView.h \
     $$PWD/FileDiffWidget.h \
-    $$PWD/FullDiffWidget.h
+    $$PWD/FullDiffWidget.h \
+    $$PWD/HibernatedDiff.h \
+    $$PWD/ImageDiffPreview.h \
+    $$PWD/WordDiff.h
 
 SOURCES += \
+    $$PWD/BlameFileTreeModel.cpp \
     $$PWD/CommitDiffWidget.cpp \
     $$PWD/DiffButton.cpp \
+    $$PWD/DiffFileClassifier.cpp \
+    $$PWD/DiffFindBar.cpp \
+    $$PWD/DiffHunks.cpp \
     $$PWD/DiffInfoPanel.cpp \
+    $$PWD/DiffModel.cpp \
+    $$PWD/DiffSearch.cpp \
+    $$PWD/DiffSideBySideView.cpp \
+    $$PWD/DiffTextView.cpp \
+    $$PWD/FileBlameLoader.cpp \
+    $$PWD/FileBlameView.cpp \
     $$PWD/FileBlameWidget.cpp \
     $$PWD/FileDiffHighlighter.cpp \
     $$PWD/FileDiffView.cpp \
     $$PWD/FileDiffWidget.cpp \
-    $$PWD/FullDiffWidget.cpp
+    $$PWD/FullDiffWidget.cpp \
+    $$PWD/HibernatedDiff.cpp \
+    $$PWD/ImageDiffPreview.cpp \
+    $$PWD/WordDiff.cpp
@@ -0,0 +1,64 @@
+#include "DiffFileClassifier.h"
+
+#include <QStringList>
+
+QVector<DiffFileStats> DiffFileClassifier::parseNumstat(const QString &numstat)
+{
+   QVector<DiffFileStats> files;
+
+   // Every file is "<additions>\t<deletions>\t<path>\0". The renames and copies have an empty path followed by
+   // "<old path>\0<new path>\0".
+   const auto fields = numstat.split('\0');
+
+   for (auto i = 0; i < fields.count(); ++i)
+   {
+      const auto parts = fields.at(i).split('\t');
+
+      if (parts.count() != 3)
+         continue;
+
+      DiffFileStats stats;
+      stats.binary = parts.at(0) == "-" && parts.at(1) == "-";
+      stats.additions = parts.at(0).toInt();
+      stats.deletions = parts.at(1).toInt();
+      // The diff-tree of a single commit starts with its SHA, that is never followed by a tab.
+      stats.path = parts.at(2).trimmed();
+
+      if (stats.path.isEmpty())
+      {
+         if (i + 2 >= fields.count())
+            break;
+
+         stats.path = fields.at(i + 2);
+         i += 2;
+      }
+
+      files.append(stats);
+   }
+
+   return files;
+}
+
+bool DiffFileClassifier::looksGenerated(const QString &path)
+{
+   static const QStringList lockFiles { "package-lock.json", "yarn.lock",   "pnpm-lock.yaml", "Cargo.lock",
+                                        "Gemfile.lock",      "poetry.lock", "composer.lock",  "go.sum" };
+
+   const auto name = path.mid(path.lastIndexOf('/') + 1);
+
+   return lockFiles.contains(name) || name.endsWith(".min.js") || name.endsWith(".min.css") || name.endsWith(".map");
+}
+
+DiffFileClassifier::Reason DiffFileClassifier::classify(const DiffFileStats &stats, bool generatedAttribute)
+{
+   if (stats.binary)
+      return Reason::Binary;
+
+   if (generatedAttribute || looksGenerated(stats.path))
+      return Reason::Generated;
+
+   if (stats.additions + stats.deletions >= MAX_CHANGED_LINES)
+      return Reason::Large;
+
+   return Reason::None;
+}
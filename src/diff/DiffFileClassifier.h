@@ -0,0 +1,88 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QVector>
+
+/*!
+ \brief The DiffFileStats are the number of lines that changed in a file of a diff, as git diff --numstat gives them.
+*/
+struct DiffFileStats
+{
+   QString path;
+   int additions = 0;
+   int deletions = 0;
+   bool binary = false;
+};
+
+/*!
+ \brief The DiffFileClassifier decides which files of a commit diff are not worth loading until the user asks for them:
+ binary files, generated files (lockfiles, minified bundles or files with the linguist-generated attribute) and files
+ with too many changed lines. It only needs the stats of the diff, not its text.
+
+ \class DiffFileClassifier DiffFileClassifier.h "DiffFileClassifier.h"
+*/
+class DiffFileClassifier
+{
+public:
+   /*!
+    \brief Why a file is collapsed.
+   */
+   enum class Reason
+   {
+      None,
+      Binary,
+      Generated,
+      Large
+   };
+
+   /*!
+    \brief The number of changed lines from which a file is collapsed.
+   */
+   static constexpr int MAX_CHANGED_LINES = 5000;
+
+   /*!
+    \brief Parses the output of git diff --numstat -z.
+
+    \param numstat The output.
+    \return The stats of every file. The renamed files have the new path.
+   */
+   static QVector<DiffFileStats> parseNumstat(const QString &numstat);
+   /*!
+    \brief Tells if a file is usually generated only by its name, like lockfiles and minified files.
+
+    \param path The path of the file.
+    \return True if the file looks generated.
+   */
+   static bool looksGenerated(const QString &path);
+   /*!
+    \brief Decides if a file is collapsed.
+
+    \param stats The stats of the file.
+    \param generatedAttribute Whether the file has the linguist-generated attribute.
+    \return The reason to collapse the file, or Reason::None.
+   */
+   static Reason classify(const DiffFileStats &stats, bool generatedAttribute);
+};
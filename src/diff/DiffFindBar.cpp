@@ -0,0 +1,186 @@
+#include "DiffFindBar.h"
+
+#include <GitQlientStyles.h>
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QShortcut>
+
+#include <algorithm>
+
+DiffFindBar::DiffFindBar(QTextEdit *editor, QWidget *parent)
+   : QFrame(parent)
+   , mEditor(editor)
+   , mCursorForPosition([editor](const QPoint &pos) { return editor->cursorForPosition(pos); })
+   , mCreateCursor([editor]() { return QTextCursor(editor->document()); })
+   , mSetTextCursor([editor](const QTextCursor &cursor) { editor->setTextCursor(cursor); })
+   , mSetExtraSelections(
+         [editor](const QList<QTextEdit::ExtraSelection> &selections) { editor->setExtraSelections(selections); })
+{
+   setup();
+}
+
+DiffFindBar::DiffFindBar(QPlainTextEdit *editor, QWidget *parent)
+   : QFrame(parent)
+   , mEditor(editor)
+   , mCursorForPosition([editor](const QPoint &pos) { return editor->cursorForPosition(pos); })
+   , mCreateCursor([editor]() { return QTextCursor(editor->document()); })
+   , mSetTextCursor([editor](const QTextCursor &cursor) { editor->setTextCursor(cursor); })
+   , mSetExtraSelections(
+         [editor](const QList<QTextEdit::ExtraSelection> &selections) { editor->setExtraSelections(selections); })
+{
+   setup();
+}
+
+void DiffFindBar::setup()
+{
+   mFindInput = new QLineEdit();
+   mFindInput->setPlaceholderText(tr("Find in the diff..."));
+
+   mMatchesLabel = new QLabel();
+
+   mGoPrevious = new QPushButton();
+   mGoPrevious->setIcon(QIcon(":/icons/go_up"));
+   mGoPrevious->setToolTip(tr("Previous match"));
+
+   mGoNext = new QPushButton();
+   mGoNext->setIcon(QIcon(":/icons/go_down"));
+   mGoNext->setToolTip(tr("Next match"));
+
+   const auto closeButton = new QPushButton();
+   closeButton->setIcon(QIcon(":/icons/close"));
+
+   const auto layout = new QHBoxLayout(this);
+   layout->setContentsMargins(QMargins());
+   layout->setSpacing(5);
+   layout->addWidget(mFindInput);
+   layout->addWidget(mMatchesLabel);
+   layout->addWidget(mGoPrevious);
+   layout->addWidget(mGoNext);
+   layout->addWidget(closeButton);
+
+   connect(mFindInput, &QLineEdit::textChanged, this, &DiffFindBar::find);
+   connect(mFindInput, &QLineEdit::returnPressed, this, [this]() { goToMatch(mCurrentMatch + 1); });
+   connect(mGoPrevious, &QPushButton::clicked, this, [this]() { goToMatch(mCurrentMatch - 1); });
+   connect(mGoNext, &QPushButton::clicked, this, [this]() { goToMatch(mCurrentMatch + 1); });
+   connect(closeButton, &QPushButton::clicked, this, &DiffFindBar::closeBar);
+
+   // Only the visible matches are highlighted, so they are updated every time the editor scrolls.
+   connect(mEditor->verticalScrollBar(), &QScrollBar::valueChanged, this, &DiffFindBar::highlightVisibleMatches);
+   connect(mEditor->horizontalScrollBar(), &QScrollBar::valueChanged, this, &DiffFindBar::highlightVisibleMatches);
+
+   connect(new QShortcut(QKeySequence::Find, mEditor), &QShortcut::activated, this, &DiffFindBar::open);
+   connect(new QShortcut(QKeySequence(Qt::Key_Escape), this), &QShortcut::activated, this, &DiffFindBar::closeBar);
+
+   setVisible(false);
+}
+
+void DiffFindBar::setDiff(const QSharedPointer<const DiffModel> &diff)
+{
+   mSearch.setDiff(diff);
+
+   if (isVisible())
+      find();
+}
+
+void DiffFindBar::open()
+{
+   setVisible(true);
+
+   mFindInput->setFocus();
+   mFindInput->selectAll();
+}
+
+void DiffFindBar::find()
+{
+   mMatches = mSearch.find(mFindInput->text());
+   mCurrentMatch = -1;
+
+   if (!mMatches.isEmpty())
+   {
+      // The search starts from the text the user is reading.
+      const auto top = mCursorForPosition(QPoint(0, 0)).position();
+      const auto first = std::lower_bound(mMatches.offsets.cbegin(), mMatches.offsets.cend(), top);
+
+      goToMatch(first != mMatches.offsets.cend() ? static_cast<int>(first - mMatches.offsets.cbegin()) : 0);
+   }
+   else
+   {
+      updateLabel();
+      highlightVisibleMatches();
+   }
+}
+
+void DiffFindBar::goToMatch(int match)
+{
+   if (mMatches.isEmpty())
+      return;
+
+   mCurrentMatch = (match + mMatches.count()) % mMatches.count();
+
+   auto cursor = mCreateCursor();
+   cursor.setPosition(mMatches.offsets.at(mCurrentMatch));
+   cursor.setPosition(mMatches.offsets.at(mCurrentMatch) + mFindInput->text().size(), QTextCursor::KeepAnchor);
+   mSetTextCursor(cursor);
+
+   updateLabel();
+   highlightVisibleMatches();
+}
+
+void DiffFindBar::updateLabel()
+{
+   if (mFindInput->text().isEmpty())
+      mMatchesLabel->clear();
+   else if (mMatches.isEmpty())
+      mMatchesLabel->setText(tr("No matches"));
+   else
+      mMatchesLabel->setText(tr("%1 of %2 (%3 files, %4 hunks)")
+                                 .arg(QString::number(mCurrentMatch + 1), QString::number(mMatches.count()),
+                                      QString::number(mMatches.filesCount), QString::number(mMatches.hunksCount)));
+}
+
+void DiffFindBar::highlightVisibleMatches()
+{
+   QList<QTextEdit::ExtraSelection> selections;
+
+   if (isVisible() && !mMatches.isEmpty())
+   {
+      const auto viewport = mEditor->viewport()->rect();
+      const auto top = mCursorForPosition(viewport.topLeft()).position();
+      const auto bottom = mCursorForPosition(viewport.bottomRight()).position();
+      const auto size = mFindInput->text().size();
+
+      QTextCharFormat format;
+      format.setBackground(GitQlientStyles::getOrange());
+
+      // The matches that start a bit before the first visible position might still be visible at the end of the line.
+      for (auto it = std::lower_bound(mMatches.offsets.cbegin(), mMatches.offsets.cend(), top - size);
+           it != mMatches.offsets.cend() && *it <= bottom; ++it)
+      {
+         QTextEdit::ExtraSelection selection;
+         selection.format = format;
+         selection.cursor = mCreateCursor();
+         selection.cursor.setPosition(*it);
+         selection.cursor.setPosition(*it + size, QTextCursor::KeepAnchor);
+         selections.append(selection);
+      }
+   }
+
+   mSetExtraSelections(selections);
+}
+
+void DiffFindBar::closeBar()
+{
+   setVisible(false);
+
+   mMatches = DiffMatches();
+   mCurrentMatch = -1;
+
+   highlightVisibleMatches();
+
+   mEditor->setFocus();
+}
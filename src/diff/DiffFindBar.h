@@ -0,0 +1,98 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <DiffSearch.h>
+
+#include <QFrame>
+#include <QTextEdit>
+
+#include <functional>
+
+class QLineEdit;
+class QLabel;
+class QPushButton;
+class QPlainTextEdit;
+class QAbstractScrollArea;
+
+/*!
+ \brief The DiffFindBar is the find bar of the diff editors. It finds all the matches of the text at once with a
+ DiffSearch, shows how many there are and in how many files and hunks, and only highlights the matches that are visible
+ in the editor, so a diff with thousands of matches is as fast as one with a few. It is opened with the find shortcut of
+ the editor (usually Ctrl+F) and closed with Escape.
+
+ \class DiffFindBar DiffFindBar.h "DiffFindBar.h"
+*/
+class DiffFindBar : public QFrame
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief Creates the find bar for a QTextEdit.
+
+    \param editor The editor to search in.
+    \param parent The parent widget if needed.
+   */
+   explicit DiffFindBar(QTextEdit *editor, QWidget *parent = nullptr);
+   /*!
+    \brief Creates the find bar for a QPlainTextEdit.
+
+    \param editor The editor to search in.
+    \param parent The parent widget if needed.
+   */
+   explicit DiffFindBar(QPlainTextEdit *editor, QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the diff the editor shows. It must be called every time the text of the editor changes.
+
+    \param diff The parsed diff, or null when the editor is empty.
+   */
+   void setDiff(const QSharedPointer<const DiffModel> &diff);
+   /*!
+    \brief Shows the bar and moves the focus to the text to find.
+   */
+   void open();
+
+private:
+   QAbstractScrollArea *mEditor = nullptr;
+   std::function<QTextCursor(const QPoint &)> mCursorForPosition;
+   std::function<QTextCursor()> mCreateCursor;
+   std::function<void(const QTextCursor &)> mSetTextCursor;
+   std::function<void(const QList<QTextEdit::ExtraSelection> &)> mSetExtraSelections;
+   QLineEdit *mFindInput = nullptr;
+   QLabel *mMatchesLabel = nullptr;
+   QPushButton *mGoPrevious = nullptr;
+   QPushButton *mGoNext = nullptr;
+   DiffSearch mSearch;
+   DiffMatches mMatches;
+   int mCurrentMatch = -1;
+
+   void setup();
+   void find();
+   void goToMatch(int match);
+   void updateLabel();
+   void highlightVisibleMatches();
+   void closeBar();
+};
@@ -0,0 +1,219 @@
+#include "DiffHunks.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <climits>
+
+DiffHunks::DiffHunks(const QString &diff)
+{
+   static const QRegularExpression header("^@@ -(\\d+)(?:,(\\d+))? \\+(\\d+)(?:,(\\d+))? @@(.*)$");
+
+   auto lines = diff.split('\n');
+
+   // The output of Git ends with a line break.
+   if (!lines.isEmpty() && lines.constLast().isEmpty())
+      lines.removeLast();
+
+   for (const auto &line : qAsConst(lines))
+   {
+      if (line.startsWith("@@"))
+      {
+         const auto match = header.match(line);
+
+         if (!match.hasMatch())
+            return;
+
+         Hunk hunk;
+         hunk.oldStart = match.captured(1).toInt();
+         hunk.oldCount = match.capturedRef(2).isEmpty() ? 1 : match.captured(2).toInt();
+         hunk.newStart = match.captured(3).toInt();
+         hunk.newCount = match.capturedRef(4).isEmpty() ? 1 : match.captured(4).toInt();
+         hunk.section = match.captured(5);
+         mHunks.append(hunk);
+      }
+      else if (mHunks.isEmpty())
+         return;
+      else
+         mHunks.last().lines.append(line);
+   }
+
+   mValid = !mHunks.isEmpty();
+}
+
+int DiffHunks::hunkAt(int line) const
+{
+   auto headerLine = 0;
+
+   for (auto i = 0; i < mHunks.count() && headerLine <= line; ++i)
+   {
+      if (headerLine == line)
+         return i;
+
+      headerLine += 1 + mHunks.at(i).lines.count();
+   }
+
+   return -1;
+}
+
+void DiffHunks::expandAbove(int hunk, int lines, const QStringList &fileLines)
+{
+   if (!mValid || hunk < 0 || hunk >= mHunks.count())
+      return;
+
+   auto &current = mHunks[hunk];
+
+   // The first line, counting from 1, that is not shown yet above the hunk.
+   const auto gapStart = hunk == 0 ? 1 : mHunks.at(hunk - 1).newStart + mHunks.at(hunk - 1).newCount;
+   const auto available = current.newStart - gapStart;
+   const auto added = std::min(lines, available);
+
+   // The file might not be the version the diff was made from.
+   if (added <= 0 || current.newStart - 1 > fileLines.count())
+      return;
+
+   QStringList context;
+   context.reserve(added);
+
+   for (auto i = current.newStart - added; i < current.newStart; ++i)
+      context.append(QString(" ") + fileLines.at(i - 1));
+
+   current.lines = context + current.lines;
+   current.oldStart -= added;
+   current.oldCount += added;
+   current.newStart -= added;
+   current.newCount += added;
+
+   // When there are no lines left between the two hunks, the second one continues the first one.
+   if (hunk > 0 && added == available)
+   {
+      auto &previous = mHunks[hunk - 1];
+      previous.lines += current.lines;
+      previous.oldCount += current.oldCount;
+      previous.newCount += current.newCount;
+
+      mHunks.remove(hunk);
+   }
+}
+
+void DiffHunks::expandAll(const QStringList &fileLines)
+{
+   if (!mValid)
+      return;
+
+   for (auto hunk = mHunks.count() - 1; hunk >= 0; --hunk)
+      expandAbove(hunk, INT_MAX, fileLines);
+
+   // The lines after the last hunk.
+   auto &last = mHunks.last();
+
+   for (auto i = std::max(1, last.newStart + last.newCount); i <= fileLines.count(); ++i)
+   {
+      last.lines.append(QString(" ") + fileLines.at(i - 1));
+      ++last.oldCount;
+      ++last.newCount;
+   }
+}
+
+QString DiffHunks::toString() const
+{
+   QStringList text;
+
+   for (const auto &hunk : mHunks)
+   {
+      text.append(QString("@@ -%1,%2 +%3,%4 @@%5")
+                      .arg(QString::number(hunk.oldStart), QString::number(hunk.oldCount),
+                           QString::number(hunk.newStart), QString::number(hunk.newCount), hunk.section));
+      text += hunk.lines;
+   }
+
+   return text.join('\n');
+}
+
+QString DiffHunks::patch(const QString &file, int firstLine, int lastLine) const
+{
+   QStringList text;
+   auto headerLine = 0;
+   auto newOffset = 0;
+
+   for (const auto &hunk : mHunks)
+   {
+      const auto firstHunkLine = headerLine + 1;
+      const auto whole = firstLine <= headerLine && lastLine >= headerLine;
+
+      headerLine = firstHunkLine + hunk.lines.count();
+
+      if (!whole && (lastLine < firstHunkLine || firstLine >= headerLine))
+         continue;
+
+      QStringList lines;
+      auto oldCount = 0;
+      auto newCount = 0;
+      auto hasChanges = false;
+      auto previousKept = true;
+
+      for (auto i = 0; i < hunk.lines.count(); ++i)
+      {
+         const auto &line = hunk.lines.at(i);
+         const auto selected = whole || (firstHunkLine + i >= firstLine && firstHunkLine + i <= lastLine);
+         const auto marker = line.isEmpty() ? QChar(' ') : line.at(0);
+
+         // The "\ No newline at end of file" belongs to the line before it.
+         if (marker == '\\')
+         {
+            if (previousKept)
+               lines.append(line);
+         }
+         else if (marker == '+')
+         {
+            previousKept = selected;
+
+            if (selected)
+            {
+               lines.append(line);
+               ++newCount;
+               hasChanges = true;
+            }
+         }
+         else if (marker == '-')
+         {
+            previousKept = true;
+            ++oldCount;
+
+            if (selected)
+            {
+               lines.append(line);
+               hasChanges = true;
+            }
+            else
+            {
+               lines.append(QString(" ") + line.midRef(1));
+               ++newCount;
+            }
+         }
+         else
+         {
+            previousKept = true;
+            lines.append(line.isEmpty() ? QString(" ") : line);
+            ++oldCount;
+            ++newCount;
+         }
+      }
+
+      if (!hasChanges)
+         continue;
+
+      // The hunks left out don't move the lines of the next ones in the new version.
+      text.append(QString("@@ -%1,%2 +%3,%4 @@")
+                      .arg(QString::number(hunk.oldStart), QString::number(oldCount),
+                           QString::number(hunk.oldStart + newOffset), QString::number(newCount)));
+      text += lines;
+
+      newOffset += newCount - oldCount;
+   }
+
+   if (text.isEmpty())
+      return QString();
+
+   return QString("diff --git a/%1 b/%1\n--- a/%1\n+++ b/%1\n").arg(file) + text.join('\n') + '\n';
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ \brief The DiffHunks are the hunks of the diff of a single file, fetched with the default context of Git. The context
+ around a hunk can be expanded afterwards with the lines of the file, so showing the whole file doesn't need Git to
+ output it. When the context of two hunks meets, they are merged into one.
+
+ \class DiffHunks DiffHunks.h "DiffHunks.h"
+*/
+class DiffHunks
+{
+public:
+   /*!
+    \brief Parses the hunks of a diff.
+
+    \param diff The diff of a single file, starting at its first hunk.
+   */
+   explicit DiffHunks(const QString &diff = QString());
+
+   /*!
+    \brief Tells if the diff could be parsed and its context can be expanded.
+   */
+   bool isValid() const { return mValid; }
+   /*!
+    \brief Returns the hunk whose header is in the given line of \ref toString, or -1 if the line is not a header.
+
+    \param line The line of the text.
+    \return The index of the hunk.
+   */
+   int hunkAt(int line) const;
+   /*!
+    \brief Adds to a hunk the context lines above it.
+
+    \param hunk The index of the hunk.
+    \param lines The maximum number of lines to add.
+    \param fileLines The lines of the new version of the file.
+   */
+   void expandAbove(int hunk, int lines, const QStringList &fileLines);
+   /*!
+    \brief Adds all the context the file has, so the diff shows the whole new version of the file.
+
+    \param fileLines The lines of the new version of the file.
+   */
+   void expandAll(const QStringList &fileLines);
+   /*!
+    \brief Returns the text of the diff with the expanded context.
+   */
+   QString toString() const;
+   /*!
+    \brief Builds a patch, for git apply, with only some of the changes of the diff. A hunk whose header is selected is
+    taken completely. Of the rest of the hunks, the added lines that are not selected are left out and the removed
+    ones are kept as context, so the patch doesn't change them.
+
+    \param file The path of the file in the repository.
+    \param firstLine The first line of \ref toString selected.
+    \param lastLine The last line of \ref toString selected.
+    \return The patch, or an empty string if no change is selected.
+   */
+   QString patch(const QString &file, int firstLine, int lastLine) const;
+
+private:
+   struct Hunk
+   {
+      int oldStart = 0;
+      int oldCount = 0;
+      int newStart = 0;
+      int newCount = 0;
+      QString section;
+      QStringList lines;
+   };
+
+   QVector<Hunk> mHunks;
+   bool mValid = false;
+};
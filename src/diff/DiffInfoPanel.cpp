@@ -1,9 +1,9 @@
 #include "DiffInfoPanel.h"
 
+#include <DateFormatter.h>
 #include <RevisionsCache.h>
 
 #include <QLabel>
-#include <QDateTime>
 #include <QVBoxLayout>
 
 DiffInfoPanel::DiffInfoPanel(QSharedPointer<RevisionsCache> cache, QWidget *parent)
@@ -91,15 +91,13 @@ void DiffInfoPanel::configure(const QString &currentSha, const QString &previous
    mLabelCurrentSha->setText(currentCommit.sha());
    mLabelCurrentTitle->setText(currentCommit.shortLog());
    mLabelCurrentAuthor->setText(currentCommit.author());
-   mLabelCurrentDateTime->setText(
-       QDateTime::fromSecsSinceEpoch(currentCommit.authorDate().toInt()).toString("dd MMM yyyy hh:mm"));
+   mLabelCurrentDateTime->setText(DateFormatter::format(currentCommit.secsSinceEpoch()));
    mLabelCurrentEmail->setText("");
 
    const auto previousCommit = mCache->getCommitInfo(previousSha);
    mLabelPreviousSha->setText(previousCommit.sha());
    mLabelPreviousTitle->setText(previousCommit.shortLog());
    mLabelPreviousAuthor->setText(previousCommit.author());
-   mLabelPreviousDateTime->setText(
-       QDateTime::fromSecsSinceEpoch(previousCommit.authorDate().toInt()).toString("dd MMM yyyy hh:mm"));
+   mLabelPreviousDateTime->setText(DateFormatter::format(previousCommit.secsSinceEpoch()));
    mLabelPreviousEmail->setText("");
 }
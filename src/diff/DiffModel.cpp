@@ -0,0 +1,169 @@
+#include "DiffModel.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace
+{
+ushort unit(char c)
+{
+   return static_cast<uchar>(c);
+}
+
+ushort unit(QChar c)
+{
+   return c.unicode();
+}
+
+template<typename Char>
+bool startsWith(const Char *line, int size, const char *prefix)
+{
+   auto i = 0;
+
+   for (; prefix[i] != '\0'; ++i)
+   {
+      if (i >= size || unit(line[i]) != unit(prefix[i]))
+         return false;
+   }
+
+   return true;
+}
+
+template<typename Char>
+DiffModel::LineKind kindOfLine(const Char *line, int size, DiffModel::LineState &state)
+{
+   using LineKind = DiffModel::LineKind;
+
+   if (startsWith(line, size, "diff "))
+   {
+      state.inHeader = true;
+      return LineKind::FileHeader;
+   }
+
+   if (startsWith(line, size, "@@"))
+   {
+      // A combined diff starts its hunks with one "@" more than the number of parents.
+      auto ats = 0;
+
+      while (ats < size && unit(line[ats]) == '@')
+         ++ats;
+
+      state.inHeader = false;
+      state.columns = std::max(1, ats - 1);
+
+      return LineKind::Hunk;
+   }
+
+   // The lines between the "diff" line and the first hunk describe the file, even the "---" and "+++" ones.
+   if (state.inHeader)
+      return LineKind::FileInfo;
+
+   for (auto i = 0; i < std::min(size, state.columns); ++i)
+   {
+      if (unit(line[i]) == '+')
+         return LineKind::Addition;
+
+      if (unit(line[i]) == '-')
+         return LineKind::Removal;
+   }
+
+   return LineKind::Context;
+}
+}
+
+DiffModel::DiffModel(const QString &diff)
+   : mText(diff)
+{
+   const auto data = mText.constData();
+   const auto size = mText.size();
+   LineState state;
+
+   for (auto offset = 0; offset < size;)
+   {
+      auto end = mText.indexOf('\n', offset);
+
+      if (end == -1)
+         end = size;
+
+      const auto line = mLineKinds.count();
+      const auto kind = kindOf(data + offset, end - offset, state);
+
+      if (kind == LineKind::FileHeader)
+         mFiles.append({ offset, line, mHunks.count() });
+      else if (kind == LineKind::Hunk)
+         mHunks.append({ offset, line, mFiles.count() - 1 });
+
+      if (kind == LineKind::FileHeader || kind == LineKind::Hunk || line == 0)
+         mSections.append({ offset, 0 });
+
+      mLineOffsets.append(offset);
+      mLineKinds.append(kind);
+
+      offset = end + 1;
+   }
+
+   // The last offset closes the last line.
+   mLineOffsets.append(size + 1);
+
+   mHash = hashOf(mText.midRef(0));
+
+   for (auto i = 0; i < mSections.count(); ++i)
+   {
+      const auto end = i + 1 < mSections.count() ? mSections.at(i + 1).offset : size;
+      mSections[i].hash = hashOf(mText.midRef(mSections.at(i).offset, end - mSections.at(i).offset));
+   }
+}
+
+quint64 DiffModel::hashOf(const QStringRef &text)
+{
+   // Two hashes of the same text with different seeds work as one of 64 bits.
+   return (static_cast<quint64>(qHash(text, 0x9e3779b9U)) << 32) | qHash(text, 0x85ebca6bU);
+}
+
+DiffModel::LineKind DiffModel::kindOf(const char *line, int size, LineState &state)
+{
+   return kindOfLine(line, size, state);
+}
+
+DiffModel::LineKind DiffModel::kindOf(const QChar *line, int size, LineState &state)
+{
+   return kindOfLine(line, size, state);
+}
+
+QStringRef DiffModel::lineText(int line) const
+{
+   const auto start = mLineOffsets.at(line);
+   return mText.midRef(start, std::min(mLineOffsets.at(line + 1) - 1, mText.size()) - start);
+}
+
+int DiffModel::fileOf(int offset) const
+{
+   const auto it = std::upper_bound(mFiles.cbegin(), mFiles.cend(), offset,
+                                    [](int value, const File &file) { return value < file.offset; });
+
+   return static_cast<int>(it - mFiles.cbegin()) - 1;
+}
+
+int DiffModel::hunkOf(int offset) const
+{
+   const auto it = std::upper_bound(mHunks.cbegin(), mHunks.cend(), offset,
+                                    [](int value, const Hunk &hunk) { return value < hunk.offset; });
+   const auto hunk = static_cast<int>(it - mHunks.cbegin()) - 1;
+
+   // A file that starts after the hunk ends it.
+   if (hunk != -1 && fileOf(offset) != mHunks.at(hunk).file)
+      return -1;
+
+   return hunk;
+}
+
+quint64 DiffModel::hunkHash(int hunk) const
+{
+   // Every hunk starts a section, so the section is the one at the same offset.
+   const auto offset = mHunks.at(hunk).offset;
+   const auto it = std::lower_bound(mSections.cbegin(), mSections.cend(), offset,
+                                    [](const Section &section, int value) { return section.offset < value; });
+
+   return it != mSections.cend() && it->offset == offset ? it->hash : 0;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+/*!
+ \brief The DiffModel is the structure of a unified diff: its files, their hunks and the kind of every line. It is
+ parsed once when a diff is loaded and shared by the editor, its highlighter and its find bar, so none of them has to
+ interpret the raw text again. The model keeps the text of the diff (the QString is shared, not copied) and stores only
+ offsets to it.
+
+ \class DiffModel DiffModel.h "DiffModel.h"
+*/
+class DiffModel
+{
+public:
+   /*!
+    \brief The kind of a line of the diff.
+   */
+   enum class LineKind : quint8
+   {
+      Context,
+      Addition,
+      Removal,
+      Hunk,
+      FileHeader,
+      FileInfo
+   };
+
+   /*!
+    \brief A file of the diff. It starts at its "diff" line and its lines go until the next file.
+   */
+   struct File
+   {
+      int offset = 0;
+      int firstLine = 0;
+      int firstHunk = 0;
+   };
+
+   /*!
+    \brief A hunk of the diff. It starts at its "@@" line and its lines go until the next hunk or file.
+   */
+   struct Hunk
+   {
+      int offset = 0;
+      int firstLine = 0;
+      int file = -1;
+   };
+
+   /*!
+    \brief A part of the text that changes as a whole: the text before the first file, the header of a file or a hunk.
+    It goes until the next section.
+   */
+   struct Section
+   {
+      int offset = 0;
+      quint64 hash = 0;
+   };
+
+   /*!
+    \brief Parses a diff.
+
+    \param diff The raw text of the diff.
+   */
+   explicit DiffModel(const QString &diff = QString());
+
+   /*!
+    \brief The state of the lines before the one parsed by \ref kindOf.
+   */
+   struct LineState
+   {
+      bool inHeader = false;
+      /*!
+       \brief The columns of "+" and "-" at the start of the lines: one, or one per parent in the combined diff of a
+       merge. It's given by the number of "@" of the hunk.
+      */
+      int columns = 1;
+   };
+
+   /*!
+    \brief Returns the kind of a line given its characters, following the state of the lines before it. It is the rule
+    used to parse the diffs, exposed for the views that don't keep the diff in a QString.
+
+    \param line The characters of the line.
+    \param size The number of characters.
+    \param state The state of the lines before. It's updated for the next line.
+    \return The kind of the line.
+   */
+   static LineKind kindOf(const char *line, int size, LineState &state);
+   /*!
+    \overload
+   */
+   static LineKind kindOf(const QChar *line, int size, LineState &state);
+
+   /*!
+    \brief Returns a hash of a text, with 64 bits so two different diffs practically never have the same one. It
+    allows to know if a diff changed without keeping its previous text.
+
+    \param text The text.
+    \return The hash.
+   */
+   static quint64 hashOf(const QStringRef &text);
+
+   /*!
+    \brief Returns the text of the diff.
+   */
+   const QString &text() const { return mText; }
+   /*!
+    \brief Returns the number of lines of the diff.
+   */
+   int lineCount() const { return mLineKinds.count(); }
+   /*!
+    \brief Returns the kind of a line.
+
+    \param line The index of the line.
+    \return The kind of the line.
+   */
+   LineKind lineKind(int line) const { return mLineKinds.at(line); }
+   /*!
+    \brief Returns the offset in the text where a line starts.
+
+    \param line The index of the line.
+    \return The offset.
+   */
+   int lineOffset(int line) const { return mLineOffsets.at(line); }
+   /*!
+    \brief Returns the text of a line without its line break, as a reference to the text of the diff.
+
+    \param line The index of the line.
+    \return The text of the line.
+   */
+   QStringRef lineText(int line) const;
+   /*!
+    \brief Returns the files of the diff, sorted by offset.
+   */
+   const QVector<File> &files() const { return mFiles; }
+   /*!
+    \brief Returns the hunks of the diff, sorted by offset.
+   */
+   const QVector<Hunk> &hunks() const { return mHunks; }
+   /*!
+    \brief Returns the sections of the diff, sorted by offset, with the hash of their text. Comparing them tells which
+    hunks changed between two versions of a diff.
+   */
+   const QVector<Section> &sections() const { return mSections; }
+   /*!
+    \brief Returns the hash of the whole text, the same that \ref hashOf returns for it.
+   */
+   quint64 hash() const { return mHash; }
+   /*!
+    \brief Returns the file that contains an offset of the text.
+
+    \param offset The offset in the text.
+    \return The index of the file, or -1 if the offset is before the first one.
+   */
+   int fileOf(int offset) const;
+   /*!
+    \brief Returns the hunk that contains an offset of the text. An offset in the header of a file doesn't belong to
+    any hunk.
+
+    \param offset The offset in the text.
+    \return The index of the hunk, or -1 if the offset is not in a hunk.
+   */
+   int hunkOf(int offset) const;
+   /*!
+    \brief Returns the hash of a hunk, the one of its section.
+
+    \param hunk The index of the hunk.
+    \return The hash of the text of the hunk.
+   */
+   quint64 hunkHash(int hunk) const;
+
+private:
+   QString mText;
+   QVector<int> mLineOffsets;
+   QVector<LineKind> mLineKinds;
+   QVector<File> mFiles;
+   QVector<Hunk> mHunks;
+   QVector<Section> mSections;
+   quint64 mHash = 0;
+};
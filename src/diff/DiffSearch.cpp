@@ -0,0 +1,41 @@
+#include "DiffSearch.h"
+
+#include <DiffModel.h>
+
+#include <QStringMatcher>
+
+void DiffSearch::setDiff(const QSharedPointer<const DiffModel> &diff)
+{
+   mDiff = diff;
+}
+
+DiffMatches DiffSearch::find(const QString &text, Qt::CaseSensitivity caseSensitivity) const
+{
+   DiffMatches matches;
+
+   if (text.isEmpty() || !mDiff)
+      return matches;
+
+   const auto &diff = mDiff->text();
+
+   // The matcher builds its skip table once for the whole diff.
+   const QStringMatcher matcher(text, caseSensitivity);
+
+   for (auto offset = matcher.indexIn(diff); offset != -1; offset = matcher.indexIn(diff, offset + text.size()))
+   {
+      const auto file = mDiff->fileOf(offset);
+      const auto hunk = mDiff->hunkOf(offset);
+
+      if (matches.files.isEmpty() || matches.files.constLast() != file)
+         ++matches.filesCount;
+
+      if (hunk != -1 && (matches.hunks.isEmpty() || matches.hunks.constLast() != hunk))
+         ++matches.hunksCount;
+
+      matches.offsets.append(offset);
+      matches.files.append(file);
+      matches.hunks.append(hunk);
+   }
+
+   return matches;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+class DiffModel;
+
+/*!
+ \brief The DiffMatches are all the occurrences of a text in a diff, with the file and the hunk where every one is.
+
+ \class DiffMatches DiffSearch.h "DiffSearch.h"
+*/
+struct DiffMatches
+{
+   QVector<int> offsets;
+   QVector<int> files;
+   QVector<int> hunks;
+   int filesCount = 0;
+   int hunksCount = 0;
+
+   int count() const { return offsets.count(); }
+   bool isEmpty() const { return offsets.isEmpty(); }
+};
+
+/*!
+ \brief The DiffSearch finds all the occurrences of a text in the raw text of a diff at once, instead of one by one
+ through the document of the editor. Every match is placed in its file and hunk with a binary search in the DiffModel of
+ the diff.
+
+ \class DiffSearch DiffSearch.h "DiffSearch.h"
+*/
+class DiffSearch
+{
+public:
+   /*!
+    \brief Sets the diff to search in.
+
+    \param diff The parsed diff. It can be null to search in an empty diff.
+   */
+   void setDiff(const QSharedPointer<const DiffModel> &diff);
+   /*!
+    \brief Finds all the occurrences of the text.
+
+    \param text The text to find.
+    \param caseSensitivity Whether the letter case must match.
+    \return The matches, sorted by offset.
+   */
+   DiffMatches find(const QString &text, Qt::CaseSensitivity caseSensitivity = Qt::CaseInsensitive) const;
+
+private:
+   QSharedPointer<const DiffModel> mDiff;
+};
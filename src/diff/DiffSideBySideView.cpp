@@ -0,0 +1,344 @@
+#include "DiffSideBySideView.h"
+
+#include <DiffModel.h>
+#include <GitQlientStyles.h>
+#include <WordDiff.h>
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QRegularExpression>
+#include <QScrollBar>
+
+#include <algorithm>
+
+namespace
+{
+QColor tint(QColor color)
+{
+   color.setAlpha(50);
+   return color;
+}
+}
+
+DiffSideBySideView::DiffSideBySideView(QWidget *parent)
+   : QAbstractScrollArea(parent)
+   , mWordDiff(new WordDiff(this))
+{
+   setFocusPolicy(Qt::StrongFocus);
+
+   QFont font;
+   font.setFamily(QString::fromUtf8("Ubuntu Mono"));
+   setFont(font);
+
+   updateScrollBars();
+
+   connect(mWordDiff, &WordDiff::signalHunkCompared, viewport(), qOverload<>(&QWidget::update));
+}
+
+void DiffSideBySideView::setDiff(const QSharedPointer<const DiffModel> &diff)
+{
+   if (diff == mDiff && !mRows.isEmpty())
+      return;
+
+   mWordDiff->cancel();
+   mDiff = diff;
+
+   buildRows();
+   updateScrollBars();
+
+   viewport()->update();
+}
+
+void DiffSideBySideView::buildRows()
+{
+   static const QRegularExpression header("^@@ -(\\d+)(?:,\\d+)? \\+(\\d+)");
+
+   mRows.clear();
+   mLongestLine = 0;
+   mMaxNumber = 0;
+
+   if (!mDiff)
+      return;
+
+   mRows.reserve(mDiff->lineCount());
+
+   auto oldNumber = 0;
+   auto newNumber = 0;
+
+   // A block of changes is a run of removals followed by a run of additions. Its rows start at blockStart and the
+   // additions are paired with the removals in order.
+   auto blockStart = 0;
+   auto removals = 0;
+   auto additions = 0;
+
+   for (auto line = 0; line < mDiff->lineCount(); ++line)
+   {
+      mLongestLine = std::max(mLongestLine, mDiff->lineText(line).size());
+
+      const auto kind = mDiff->lineKind(line);
+
+      // The marks like "\ No newline at end of file" are not shown: they would split the blocks of changes.
+      if (kind == DiffModel::LineKind::Context && mDiff->lineText(line).startsWith('\\'))
+         continue;
+
+      if (kind != DiffModel::LineKind::Removal && kind != DiffModel::LineKind::Addition)
+         removals = additions = 0;
+
+      switch (kind)
+      {
+         case DiffModel::LineKind::Removal:
+         {
+            if (additions > 0)
+               removals = additions = 0;
+
+            if (removals == 0)
+               blockStart = mRows.count();
+
+            Row row;
+            row.oldLine = line;
+            row.oldNumber = oldNumber++;
+            mRows.append(row);
+
+            ++removals;
+            break;
+         }
+         case DiffModel::LineKind::Addition:
+         {
+            if (removals == 0 && additions == 0)
+               blockStart = mRows.count();
+
+            const auto index = blockStart + additions;
+
+            if (index < mRows.count())
+            {
+               mRows[index].newLine = line;
+               mRows[index].newNumber = newNumber++;
+            }
+            else
+            {
+               Row row;
+               row.newLine = line;
+               row.newNumber = newNumber++;
+               mRows.append(row);
+            }
+
+            ++additions;
+            break;
+         }
+         case DiffModel::LineKind::Hunk:
+         {
+            const auto match = header.match(mDiff->lineText(line));
+
+            if (match.hasMatch())
+            {
+               oldNumber = match.capturedRef(1).toInt();
+               newNumber = match.capturedRef(2).toInt();
+            }
+
+            mRows.append({ line, line, 0, 0 });
+            break;
+         }
+         case DiffModel::LineKind::Context:
+            mRows.append({ line, line, oldNumber++, newNumber++ });
+            break;
+         case DiffModel::LineKind::FileHeader:
+         case DiffModel::LineKind::FileInfo:
+            mRows.append({ line, line, 0, 0 });
+            break;
+      }
+
+      mMaxNumber = std::max(mMaxNumber, std::max(oldNumber, newNumber));
+   }
+}
+
+bool DiffSideBySideView::isHeader(const Row &row) const
+{
+   if (row.oldLine == -1 || row.oldLine != row.newLine)
+      return false;
+
+   const auto kind = mDiff->lineKind(row.oldLine);
+
+   return kind == DiffModel::LineKind::Hunk || kind == DiffModel::LineKind::FileHeader
+       || kind == DiffModel::LineKind::FileInfo;
+}
+
+int DiffSideBySideView::numbersWidth() const
+{
+   auto digits = 1;
+   auto max = std::max(1, mMaxNumber);
+
+   while (max >= 10)
+   {
+      max /= 10;
+      ++digits;
+   }
+
+   return 8 + fontMetrics().boundingRect(QLatin1Char('9')).width() * digits;
+}
+
+void DiffSideBySideView::updateScrollBars()
+{
+   const auto lineHeight = std::max(1, fontMetrics().height());
+   const auto visibleRows = std::max(1, viewport()->height() / lineHeight);
+   const auto charWidth = fontMetrics().boundingRect(QLatin1Char('M')).width();
+   const auto paneWidth = viewport()->width() / 2;
+   const auto textWidth = numbersWidth() + 8 + mLongestLine * charWidth;
+
+   verticalScrollBar()->setRange(0, std::max(0, mRows.count() - visibleRows));
+   verticalScrollBar()->setSingleStep(1);
+   verticalScrollBar()->setPageStep(visibleRows);
+
+   // Both panes scroll horizontally together.
+   horizontalScrollBar()->setRange(0, std::max(0, textWidth - paneWidth));
+   horizontalScrollBar()->setSingleStep(charWidth);
+   horizontalScrollBar()->setPageStep(paneWidth);
+}
+
+void DiffSideBySideView::paintSide(QPainter &painter, const QRect &rect, int line, int number) const
+{
+   const auto gutter = numbersWidth();
+
+   if (line == -1)
+   {
+      painter.fillRect(rect, QBrush(tint(GitQlientStyles::getTextColor()), Qt::BDiagPattern));
+      painter.fillRect(QRect(rect.x(), rect.y(), gutter, rect.height()), GitQlientStyles::getBackgroundColor());
+      return;
+   }
+
+   const auto kind = mDiff->lineKind(line);
+
+   if (kind == DiffModel::LineKind::Removal)
+      painter.fillRect(rect, tint(GitQlientStyles::getRed()));
+   else if (kind == DiffModel::LineKind::Addition)
+      painter.fillRect(rect, tint(GitQlientStyles::getGreen()));
+
+   paintChangedWords(painter, rect.adjusted(gutter, 0, 0, 0), line);
+
+   // The first character of the line is the mark of the diff, that the colors already show.
+   const auto text = mDiff->lineText(line).mid(1).toString().replace('\t', QLatin1String("    "));
+
+   painter.save();
+   painter.setClipRect(rect.adjusted(gutter, 0, 0, 0));
+   painter.setPen(palette().color(QPalette::Text));
+   painter.drawText(rect.x() + gutter + 4 - horizontalScrollBar()->value(), rect.y() + fontMetrics().ascent(), text);
+   painter.restore();
+
+   painter.fillRect(QRect(rect.x(), rect.y(), gutter, rect.height()), GitQlientStyles::getBackgroundColor());
+   painter.setPen(GitQlientStyles::getTextColor());
+   painter.drawText(rect.x(), rect.y(), gutter - 3, rect.height(), Qt::AlignRight, QString::number(number));
+}
+
+void DiffSideBySideView::paintChangedWords(QPainter &painter, const QRect &rect, int line) const
+{
+   const auto kind = mDiff->lineKind(line);
+   const auto hunk = mDiff->hunkOf(mDiff->lineOffset(line));
+
+   if (hunk == -1 || (kind != DiffModel::LineKind::Removal && kind != DiffModel::LineKind::Addition))
+      return;
+
+   const auto changes = mWordDiff->find(mDiff->hunkHash(hunk));
+   const auto index = line - mDiff->hunks().at(hunk).firstLine;
+
+   if (!changes || index >= changes->count())
+      return;
+
+   auto color = kind == DiffModel::LineKind::Removal ? GitQlientStyles::getRed() : GitQlientStyles::getGreen();
+   color.setAlpha(110);
+
+   // The font is monospaced, so the columns of the text (with the tabs expanded) give the position of the words.
+   const auto columns = [](const QStringRef &text) {
+      return text.size() + text.count(QLatin1Char('\t')) * 3;
+   };
+   const auto charWidth = fontMetrics().boundingRect(QLatin1Char('M')).width();
+   const auto text = mDiff->lineText(line);
+   const auto x = rect.x() + 4 - horizontalScrollBar()->value();
+
+   painter.save();
+   painter.setClipRect(rect);
+
+   for (const auto &change : changes->at(index))
+   {
+      const auto start = columns(text.mid(1, change.start - 1));
+      const auto length = columns(text.mid(change.start, change.length));
+
+      painter.fillRect(QRect(x + start * charWidth, rect.y(), length * charWidth, rect.height()), color);
+   }
+
+   painter.restore();
+}
+
+void DiffSideBySideView::paintEvent(QPaintEvent *event)
+{
+   QPainter painter(viewport());
+   painter.fillRect(event->rect(), palette().color(QPalette::Base));
+
+   if (!mDiff)
+      return;
+
+   const auto lineHeight = fontMetrics().height();
+   const auto width = viewport()->width();
+   const auto paneWidth = width / 2;
+   const auto firstRow = verticalScrollBar()->value() + event->rect().top() / lineHeight;
+   const auto lastRow = std::min(mRows.count() - 1, verticalScrollBar()->value() + event->rect().bottom() / lineHeight);
+
+   auto boldFont = font();
+   boldFont.setBold(true);
+
+   auto lastHunk = -1;
+
+   for (auto index = firstRow; index <= lastRow; ++index)
+   {
+      const auto &row = mRows.at(index);
+      const auto y = (index - verticalScrollBar()->value()) * lineHeight;
+
+      if (isHeader(row))
+      {
+         // The headers go across both panes and don't scroll horizontally.
+         const auto isHunk = mDiff->lineKind(row.oldLine) == DiffModel::LineKind::Hunk;
+
+         painter.setFont(boldFont);
+         painter.setPen(isHunk ? GitQlientStyles::getOrange() : GitQlientStyles::getBlue());
+         painter.drawText(4, y + fontMetrics().ascent(), mDiff->lineText(row.oldLine).toString());
+         painter.setFont(font());
+      }
+      else
+      {
+         // The visible hunks are the ones whose words are compared.
+         const auto line = row.newLine != -1 ? row.newLine : row.oldLine;
+         const auto hunk = mDiff->hunkOf(mDiff->lineOffset(line));
+
+         if (hunk != -1 && hunk != lastHunk)
+         {
+            mWordDiff->compare(mDiff, hunk, mDiff->hunkHash(hunk));
+            lastHunk = hunk;
+         }
+
+         paintSide(painter, QRect(0, y, paneWidth, lineHeight), row.oldLine, row.oldNumber);
+         paintSide(painter, QRect(paneWidth, y, width - paneWidth, lineHeight), row.newLine, row.newNumber);
+      }
+   }
+
+   painter.setPen(GitQlientStyles::getTextColor());
+   painter.drawLine(paneWidth, event->rect().top(), paneWidth, event->rect().bottom());
+}
+
+void DiffSideBySideView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void DiffSideBySideView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+   QAbstractScrollArea::mouseDoubleClickEvent(event);
+
+   const auto index = verticalScrollBar()->value() + event->pos().y() / std::max(1, fontMetrics().height());
+
+   if (index >= 0 && index < mRows.count())
+   {
+      const auto &row = mRows.at(index);
+      emit signalLineDoubleClicked(row.newLine != -1 ? row.newLine : row.oldLine);
+   }
+}
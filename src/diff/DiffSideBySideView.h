@@ -0,0 +1,115 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractScrollArea>
+#include <QSharedPointer>
+#include <QVector>
+
+class DiffModel;
+class WordDiff;
+
+/*!
+ \brief The DiffSideBySideView shows the diff of a file in two panes: the old version on the left and the new one on
+ the right. Both panes paint from the same DiffModel: the lines are not copied, there is only one map of rows that
+ says which line of the model goes to each side, so the panes are always aligned and scroll together. Only the visible
+ rows are painted, so the size of the file doesn't matter once the map is built.
+
+ The removals and additions of a hunk are paired row by row; when one side has more lines the other one shows empty
+ rows. The words that changed between the lines of a pair are marked once the WordDiff has compared their hunk.
+
+ \class DiffSideBySideView DiffSideBySideView.h "DiffSideBySideView.h"
+*/
+class DiffSideBySideView : public QAbstractScrollArea
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the user double clicks a row.
+
+    \param line The line of the model shown in the row, on the new side if both sides have one.
+   */
+   void signalLineDoubleClicked(int line);
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit DiffSideBySideView(QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the diff to show and builds the map of rows. Setting again the diff that is shown does nothing.
+
+    \param diff The parsed diff of a single file.
+   */
+   void setDiff(const QSharedPointer<const DiffModel> &diff);
+
+protected:
+   /*!
+    \brief Paints the visible rows of both panes.
+
+    \param event The paint event.
+   */
+   void paintEvent(QPaintEvent *event) override;
+   /*!
+    \brief Updates the ranges of the scroll bars to the new size of the viewport.
+
+    \param event The resize event.
+   */
+   void resizeEvent(QResizeEvent *event) override;
+   /*!
+    \brief Notifies the line of the row that was double clicked.
+
+    \param event The mouse event.
+   */
+   void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+   /*!
+    \brief A row of the view. A line is -1 when its side is empty. The headers have the same line on both sides.
+   */
+   struct Row
+   {
+      int oldLine = -1;
+      int newLine = -1;
+      int oldNumber = 0;
+      int newNumber = 0;
+   };
+
+   QSharedPointer<const DiffModel> mDiff;
+   QVector<Row> mRows;
+   WordDiff *mWordDiff = nullptr;
+   int mLongestLine = 0;
+   int mMaxNumber = 0;
+
+   void buildRows();
+   bool isHeader(const Row &row) const;
+   int numbersWidth() const;
+   void paintSide(QPainter &painter, const QRect &rect, int line, int number) const;
+   void paintChangedWords(QPainter &painter, const QRect &rect, int line) const;
+   void updateScrollBars();
+};
@@ -0,0 +1,201 @@
+#include "DiffTextView.h"
+
+#include <GitQlientStyles.h>
+
+#include <QEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+QColor lineColor(DiffModel::LineKind kind, const QColor &defaultColor, bool &bold)
+{
+   bold = kind == DiffModel::LineKind::Hunk || kind == DiffModel::LineKind::FileHeader;
+
+   switch (kind)
+   {
+      case DiffModel::LineKind::Hunk:
+         return GitQlientStyles::getOrange();
+      case DiffModel::LineKind::Addition:
+         return GitQlientStyles::getGreen();
+      case DiffModel::LineKind::Removal:
+         return GitQlientStyles::getRed();
+      case DiffModel::LineKind::FileHeader:
+      case DiffModel::LineKind::FileInfo:
+         return GitQlientStyles::getBlue();
+      case DiffModel::LineKind::Context:
+         break;
+   }
+
+   return defaultColor;
+}
+}
+
+DiffTextView::DiffTextView(QWidget *parent)
+   : QAbstractScrollArea(parent)
+{
+   setFocusPolicy(Qt::StrongFocus);
+
+   QFont font;
+   font.setFamily(QString::fromUtf8("Ubuntu Mono"));
+   setFont(font);
+
+   updateScrollBars();
+}
+
+void DiffTextView::setDiff(const QByteArray &diff)
+{
+   mDiff = diff;
+   mLineOffsets.clear();
+   mLineKinds.clear();
+   mLongestLine = 0;
+
+   const auto data = mDiff.constData();
+   const auto size = mDiff.size();
+
+   // A rough guess of the number of lines avoids most of the reallocations of the index.
+   mLineOffsets.reserve(size / 40 + 1);
+   mLineKinds.reserve(size / 40 + 1);
+
+   auto start = 0;
+   DiffModel::LineState state;
+
+   while (start < size)
+   {
+      mLineOffsets.append(start);
+
+      const auto end = static_cast<const char *>(memchr(data + start, '\n', static_cast<size_t>(size - start)));
+      const auto next = end ? static_cast<int>(end - data) + 1 : size + 1;
+
+      mLineKinds.append(DiffModel::kindOf(data + start, next - 1 - start, state));
+
+      mLongestLine = std::max(mLongestLine, std::min(next - 1 - start, MAX_LINE_SIZE));
+      start = next;
+   }
+
+   // The last offset closes the last line, so the size of every line is the distance to the next one.
+   mLineOffsets.append(start);
+   mLineOffsets.squeeze();
+   mLineKinds.squeeze();
+
+   verticalScrollBar()->setValue(0);
+   horizontalScrollBar()->setValue(0);
+
+   updateScrollBars();
+   viewport()->update();
+}
+
+void DiffTextView::clear()
+{
+   setDiff(QByteArray());
+}
+
+int DiffTextView::memoryUsage() const
+{
+   return mDiff.size() + mLineOffsets.count() * static_cast<int>(sizeof(int))
+       + mLineKinds.count() * static_cast<int>(sizeof(DiffModel::LineKind));
+}
+
+int DiffTextView::lineCount() const
+{
+   return std::max(0, mLineOffsets.count() - 1);
+}
+
+QString DiffTextView::lineText(int line) const
+{
+   const auto start = mLineOffsets.at(line);
+   auto size = std::min(mLineOffsets.at(line + 1) - 1 - start, MAX_LINE_SIZE);
+
+   if (size > 0 && mDiff.at(start + size - 1) == '\r')
+      --size;
+
+   return QString::fromUtf8(mDiff.constData() + start, size).replace('\t', QLatin1String("    "));
+}
+
+int DiffTextView::lineNumbersWidth() const
+{
+   auto digits = 1;
+   auto max = std::max(1, lineCount());
+
+   while (max >= 10)
+   {
+      max /= 10;
+      ++digits;
+   }
+
+   return 8 + fontMetrics().boundingRect(QLatin1Char('9')).width() * digits;
+}
+
+void DiffTextView::updateScrollBars()
+{
+   const auto lineHeight = std::max(1, fontMetrics().height());
+   const auto visibleLines = std::max(1, viewport()->height() / lineHeight);
+   const auto charWidth = fontMetrics().boundingRect(QLatin1Char('M')).width();
+   const auto textWidth = lineNumbersWidth() + 8 + mLongestLine * charWidth;
+
+   verticalScrollBar()->setRange(0, std::max(0, lineCount() - visibleLines));
+   verticalScrollBar()->setSingleStep(1);
+   verticalScrollBar()->setPageStep(visibleLines);
+
+   horizontalScrollBar()->setRange(0, std::max(0, textWidth - viewport()->width()));
+   horizontalScrollBar()->setSingleStep(charWidth);
+   horizontalScrollBar()->setPageStep(viewport()->width());
+}
+
+void DiffTextView::paintEvent(QPaintEvent *event)
+{
+   QPainter painter(viewport());
+   painter.fillRect(event->rect(), palette().color(QPalette::Base));
+
+   const auto metrics = fontMetrics();
+   const auto lineHeight = metrics.height();
+   const auto numbersWidth = lineNumbersWidth();
+   const auto textX = numbersWidth + 4 - horizontalScrollBar()->value();
+   const auto firstLine = verticalScrollBar()->value() + event->rect().top() / lineHeight;
+   const auto lastLine = std::min(lineCount() - 1, verticalScrollBar()->value() + event->rect().bottom() / lineHeight);
+   const auto textColor = palette().color(QPalette::Text);
+
+   auto boldFont = font();
+   boldFont.setBold(true);
+
+   for (auto line = firstLine; line <= lastLine; ++line)
+   {
+      const auto y = (line - verticalScrollBar()->value()) * lineHeight;
+      auto bold = false;
+
+      painter.setPen(lineColor(mLineKinds.at(line), textColor, bold));
+      painter.setFont(bold ? boldFont : font());
+      painter.drawText(textX, y + metrics.ascent(), lineText(line));
+   }
+
+   // The numbers are painted over the text so they stay in place when the view scrolls horizontally.
+   painter.setFont(font());
+   painter.fillRect(QRect(0, event->rect().top(), numbersWidth, event->rect().height()),
+                    GitQlientStyles::getBackgroundColor());
+   painter.setPen(GitQlientStyles::getTextColor());
+
+   for (auto line = firstLine; line <= lastLine; ++line)
+   {
+      const auto y = (line - verticalScrollBar()->value()) * lineHeight;
+      painter.drawText(0, y, numbersWidth - 3, lineHeight, Qt::AlignRight, QString::number(line + 1));
+   }
+}
+
+void DiffTextView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void DiffTextView::changeEvent(QEvent *event)
+{
+   QAbstractScrollArea::changeEvent(event);
+
+   if (event->type() == QEvent::FontChange)
+      updateScrollBars();
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <DiffModel.h>
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <QVector>
+
+/*!
+ \brief The DiffTextView shows diffs too big for a text document. It keeps the raw output of Git in a single byte
+ buffer and an index with the offset and the kind of every line, classified with the rules of the DiffModel. Only the
+ visible lines are decoded and painted, so the memory used is the size of the diff plus five bytes per line, and
+ showing a new diff only costs the time to index it.
+
+ The additions, removals, hunk headers and file headers are colored like in the other diff editors. The view is read
+ only and doesn't support selecting text.
+
+ \class DiffTextView DiffTextView.h "DiffTextView.h"
+*/
+class DiffTextView : public QAbstractScrollArea
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief The size, in bytes, from which a diff is shown in this view instead of a text editor.
+   */
+   static constexpr int MIN_DIFF_SIZE = 16 * 1024 * 1024;
+   /*!
+    \brief The maximum number of bytes of a line that are shown. The rest of the line is cut.
+   */
+   static constexpr int MAX_LINE_SIZE = 64 * 1024;
+
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit DiffTextView(QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the diff to show and indexes its lines.
+
+    \param diff The raw output of Git in UTF-8.
+   */
+   void setDiff(const QByteArray &diff);
+   /*!
+    \brief Clears the view and releases the diff.
+   */
+   void clear();
+   /*!
+    \brief Returns an approximation of the memory used by the diff and its index of lines, in bytes.
+   */
+   int memoryUsage() const;
+
+protected:
+   /*!
+    \brief Paints the visible lines and their numbers.
+
+    \param event The paint event.
+   */
+   void paintEvent(QPaintEvent *event) override;
+   /*!
+    \brief Updates the ranges of the scroll bars to the new size of the viewport.
+
+    \param event The resize event.
+   */
+   void resizeEvent(QResizeEvent *event) override;
+   /*!
+    \brief Updates the ranges of the scroll bars when the font changes.
+
+    \param event The change event.
+   */
+   void changeEvent(QEvent *event) override;
+
+private:
+   QByteArray mDiff;
+   QVector<int> mLineOffsets;
+   QVector<DiffModel::LineKind> mLineKinds;
+   int mLongestLine = 0;
+
+   int lineCount() const;
+   QString lineText(int line) const;
+   int lineNumbersWidth() const;
+   void updateScrollBars();
+};
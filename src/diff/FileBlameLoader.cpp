@@ -0,0 +1,337 @@
+#include "FileBlameLoader.h"
+
+#include <CommitInfo.h>
+#include <GitBase.h>
+#include <GitBlobReader.h>
+#include <GitHistory.h>
+#include <GitRequestorProcess.h>
+#include <TraceRecorder.h>
+
+#include <QFile>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+FileBlameLoader::FileBlameLoader(const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mGit(git)
+   , mBlobReader(GitBlobReader::instance(git))
+{
+   connect(mBlobReader.data(), &GitBlobReader::signalBlobRead, this, [this](int request, const QByteArray &data) {
+      if (request == mBlobRequest)
+         setText(QString::fromUtf8(data));
+   });
+   connect(mBlobReader.data(), &GitBlobReader::signalBlobMissing, this, [this](int request) {
+      if (request == mBlobRequest)
+      {
+         // A blame without its text is shown, but not stored.
+         mTextMissing = true;
+         setText(QString());
+      }
+   });
+}
+
+BlameCache::Key FileBlameLoader::cacheKey(const QString &repository, const QString &file, const QString &sha)
+{
+   return { repository, file, sha };
+}
+
+void FileBlameLoader::load(const QString &file, const QString &sha, const QString &baseSha)
+{
+   TraceSpan span("blame", "FileBlameLoader::load");
+
+   cancel();
+
+   const auto request = ++mRequest;
+
+   mFile = file;
+   mSha = sha;
+   mLoading = true;
+   mTraceStart = TraceRecorder::instance().isEnabled() ? TraceRecorder::now() : -1;
+
+   BlameCache::Blame cached;
+
+   if (BlameCache::find(cacheKey(mGit->getRepositoryId(), mFile, mSha), cached))
+   {
+      setText(cached.text);
+
+      for (const auto &commit : qAsConst(cached.commits))
+         addCommit(commit);
+
+      // The lines are annotated by runs of the same commit.
+      auto start = 0;
+
+      for (auto line = 1; line <= cached.lineCommits.count(); ++line)
+      {
+         if (line == cached.lineCommits.count() || cached.lineCommits.at(line) != cached.lineCommits.at(start))
+         {
+            if (cached.lineCommits.at(start) != -1)
+               annotate(start, line - start, cached.lineCommits.at(start));
+
+            start = line;
+         }
+      }
+
+      mBlameReceived = true;
+      onBlameFinished();
+      return;
+   }
+
+   // The lines that didn't change since the base revision keep their blame. If nothing was removed, there is nothing
+   // left to blame.
+   QVector<QPair<int, int>> lines;
+   const auto reused = !baseSha.isEmpty() && reuseBlame(baseSha, lines);
+
+   loadText();
+
+   if (reused && lines.isEmpty())
+   {
+      mBlameReceived = true;
+      onBlameFinished();
+      return;
+   }
+
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+   mBlameProcess = git->blame(mFile, mSha, lines);
+
+   if (!mBlameProcess)
+   {
+      onBlameFinished();
+      return;
+   }
+
+   connect(mBlameProcess.data(), &GitRequestorProcess::procDataReady, this, [this, request](const QByteArray &data) {
+      if (request == mRequest)
+         processBlameData(data);
+   });
+   connect(mBlameProcess.data(), &GitRequestorProcess::procDataFinished, this, [this, request]() {
+      if (request == mRequest)
+         onBlameFinished();
+   });
+}
+
+void FileBlameLoader::cancel()
+{
+   if (mBlameProcess)
+      mBlameProcess->onCancel();
+
+   // The late answers of the previous load are recognized by the request.
+   ++mRequest;
+
+   mBlameProcess.clear();
+   mBlobRequest = 0;
+   mPendingLine.clear();
+   mEntry = BlameEntry();
+   mCommits.clear();
+   mBlame = BlameCache::Blame();
+   mLoading = false;
+   mBlameReceived = false;
+   mBlameFinished = false;
+   mTextLoaded = false;
+   mTextMissing = false;
+}
+
+bool FileBlameLoader::reuseBlame(const QString &baseSha, QVector<QPair<int, int>> &lines)
+{
+   BlameCache::Blame base;
+
+   if (mSha == CommitInfo::ZERO_SHA || !BlameCache::find(cacheKey(mGit->getRepositoryId(), mFile, baseSha), base))
+      return false;
+
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+   const auto ret = git->getFileLineChanges(mSha, baseSha, mFile);
+
+   if (!ret.success)
+      return false;
+
+   static const QRegularExpression hunkHeader("^@@ -(\\d+)(?:,(\\d+))? \\+(\\d+)(?:,(\\d+))? @@",
+                                              QRegularExpression::MultilineOption);
+   auto matches = hunkHeader.globalMatch(ret.output.toString());
+   auto line = 1;
+   auto baseLine = 1;
+   const auto copy = [this, &base](int firstLine, int firstBaseLine, int count) {
+      for (auto i = 0; i < count && firstBaseLine - 1 + i < base.lineCommits.count(); ++i)
+      {
+         const auto commit = base.lineCommits.at(firstBaseLine - 1 + i);
+
+         if (commit == -1)
+            continue;
+
+         const auto &info = base.commits.at(commit);
+         auto index = mCommits.value(info.sha, -1);
+
+         if (index == -1)
+            index = addCommit(info);
+
+         annotate(firstLine - 1 + i, 1, index);
+      }
+   };
+
+   // The diff goes from the revision to blame to the base one: the old side of every hunk are the lines of the
+   // revision that have to be blamed again, and the lines between hunks are the same in both revisions.
+   while (matches.hasNext())
+   {
+      const auto match = matches.next();
+      const auto start = match.capturedRef(1).toInt();
+      const auto count = match.capturedRef(2).isNull() ? 1 : match.capturedRef(2).toInt();
+      const auto baseCount = match.capturedRef(4).isNull() ? 1 : match.capturedRef(4).toInt();
+
+      // A hunk without old lines goes after its start line.
+      const auto hunkStart = count == 0 ? start + 1 : start;
+
+      copy(line, baseLine, hunkStart - line);
+      baseLine += hunkStart - line + baseCount;
+      line = hunkStart + count;
+
+      if (count > 0)
+         lines.append({ start, count });
+   }
+
+   copy(line, baseLine, base.lineCommits.count() - baseLine + 1);
+
+   return true;
+}
+
+void FileBlameLoader::loadText()
+{
+   if (mSha == CommitInfo::ZERO_SHA)
+   {
+      QFile localFile(QString("%1/%2").arg(mGit->getWorkingDir(), mFile));
+
+      if (localFile.open(QIODevice::ReadOnly))
+         setText(QString::fromUtf8(localFile.readAll()));
+      else
+      {
+         mTextMissing = true;
+         setText(QString());
+      }
+   }
+   else
+   {
+      mBlobRequest = mBlobReader->read(QString("%1:%2").arg(mSha, mFile));
+   }
+}
+
+void FileBlameLoader::processBlameData(const QByteArray &data)
+{
+   TraceSpan span("blame", "FileBlameLoader::processBlameData");
+
+   mBlameReceived = mBlameReceived || !data.isEmpty();
+
+   mPendingLine.append(data);
+
+   auto start = 0;
+   auto end = mPendingLine.indexOf('\n');
+
+   while (end != -1)
+   {
+      parseBlameLine(QString::fromUtf8(mPendingLine.constData() + start, end - start));
+
+      start = end + 1;
+      end = mPendingLine.indexOf('\n', start);
+   }
+
+   mPendingLine.remove(0, start);
+}
+
+void FileBlameLoader::parseBlameLine(const QString &line)
+{
+   // Every group starts with "<sha> <original line> <final line> <lines>". The first group of a commit is followed by
+   // its headers and every group ends with the filename.
+   if (mEntry.sha.isEmpty())
+   {
+      const auto fields = line.split(' ');
+
+      if (fields.count() >= 4)
+      {
+         mEntry.sha = fields.at(0);
+         mEntry.finalLine = fields.at(2).toInt();
+         mEntry.count = fields.at(3).toInt();
+      }
+
+      return;
+   }
+
+   if (line.startsWith("author "))
+      mEntry.author = line.mid(7);
+   else if (line.startsWith("author-time "))
+      mEntry.dateTime = QDateTime::fromSecsSinceEpoch(line.midRef(12).toLongLong());
+   else if (line.startsWith("summary "))
+      mEntry.summary = line.mid(8);
+   else if (line.startsWith("filename "))
+   {
+      auto commit = mCommits.value(mEntry.sha, -1);
+
+      if (commit == -1)
+         commit = addCommit({ mEntry.sha, mEntry.author, mEntry.dateTime, mEntry.summary });
+
+      if (mEntry.finalLine > 0)
+         annotate(mEntry.finalLine - 1, mEntry.count, commit);
+
+      mEntry = BlameEntry();
+   }
+}
+
+int FileBlameLoader::addCommit(const BlameCache::Commit &commit)
+{
+   const auto index = mBlame.commits.count();
+
+   mBlame.commits.append(commit);
+   mCommits.insert(commit.sha, index);
+
+   emit signalCommitAdded(commit);
+
+   return index;
+}
+
+void FileBlameLoader::annotate(int firstLine, int count, int commit)
+{
+   if (firstLine + count > mBlame.lineCommits.count())
+   {
+      const auto previousCount = mBlame.lineCommits.count();
+      mBlame.lineCommits.resize(firstLine + count);
+      std::fill(mBlame.lineCommits.begin() + previousCount, mBlame.lineCommits.end(), -1);
+   }
+
+   std::fill(mBlame.lineCommits.begin() + firstLine, mBlame.lineCommits.begin() + firstLine + count, commit);
+
+   emit signalLinesAnnotated(firstLine, count, commit);
+}
+
+void FileBlameLoader::setText(const QString &text)
+{
+   mBlame.text = text;
+   mTextLoaded = true;
+
+   emit signalTextLoaded(text);
+
+   finishIfLoaded();
+}
+
+void FileBlameLoader::onBlameFinished()
+{
+   TraceSpan span("blame", "FileBlameLoader::onBlameFinished");
+
+   mBlameProcess.clear();
+   mBlameFinished = true;
+
+   emit signalBlameFinished(mBlameReceived);
+
+   finishIfLoaded();
+}
+
+void FileBlameLoader::finishIfLoaded()
+{
+   if (!mLoading || !mBlameFinished || !mTextLoaded)
+      return;
+
+   mLoading = false;
+
+   if (mBlameReceived && !mTextMissing)
+      BlameCache::insert(cacheKey(mGit->getRepositoryId(), mFile, mSha), mBlame);
+
+   if (mTraceStart >= 0)
+      TraceRecorder::instance().record("blame", "Blame of " + mFile, mTraceStart, TraceRecorder::now() - mTraceStart);
+
+   emit signalLoaded();
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <BlameCache.h>
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+
+class GitBase;
+class GitBlobReader;
+class GitRequestorProcess;
+
+/*!
+ \brief The FileBlameLoader gets the blame of a file in a revision: it runs git blame --incremental asynchronously and
+ reads the text of the file at the same time, and notifies the commits and the annotated lines as they arrive.
+
+ The finished blames are kept in the BlameCache and a blame that is already there is notified right away. When the
+ blame of a base revision of the same file is in the cache, the lines that the diff between both revisions doesn't
+ touch keep their commit and only the changed ones are blamed.
+
+ \class FileBlameLoader FileBlameLoader.h "FileBlameLoader.h"
+*/
+class FileBlameLoader : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the text of the file is available.
+
+    \param text The text.
+   */
+   void signalTextLoaded(const QString &text);
+   /*!
+    \brief Signal triggered when a commit is found in the blame. The commits are numbered in the order they arrive.
+
+    \param commit The commit.
+   */
+   void signalCommitAdded(const BlameCache::Commit &commit);
+   /*!
+    \brief Signal triggered when the commit of a group of lines is known.
+
+    \param firstLine The first line, starting at 0.
+    \param count The number of lines.
+    \param commit The index of the commit.
+   */
+   void signalLinesAnnotated(int firstLine, int count, int commit);
+   /*!
+    \brief Signal triggered when Git finishes the blame.
+
+    \param blamed False if Git didn't give any line, for instance because the file is not in the repository.
+   */
+   void signalBlameFinished(bool blamed);
+   /*!
+    \brief Signal triggered when both the blame and the text have arrived, after the blame is stored in the cache.
+   */
+   void signalLoaded();
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param git The git object to perform Git operations.
+    \param parent The parent object if needed.
+   */
+   explicit FileBlameLoader(const QSharedPointer<GitBase> &git, QObject *parent = nullptr);
+
+   /*!
+    \brief Starts to load a blame. The load in progress, if any, is cancelled.
+
+    \param file The file, relative to the root of the repository.
+    \param sha The revision to blame, or CommitInfo::ZERO_SHA for the work directory.
+    \param baseSha A revision of the same file whose blame can be reused, if any.
+   */
+   void load(const QString &file, const QString &sha, const QString &baseSha = QString());
+   /*!
+    \brief Cancels the load in progress, if any.
+   */
+   void cancel();
+   /*!
+    \brief Tells if a load is in progress.
+   */
+   bool isLoading() const { return mLoading; }
+   /*!
+    \brief Builds the key of the blame of a file in a revision.
+
+    \param repository The repository, see GitBase::getRepositoryId.
+    \param file The file, relative to the root of the repository.
+    \param sha The revision.
+    \return The key in the BlameCache.
+   */
+   static BlameCache::Key cacheKey(const QString &repository, const QString &file, const QString &sha);
+
+private:
+   /*!
+    \brief A group of lines of the incremental blame, while its header is parsed.
+   */
+   struct BlameEntry
+   {
+      QString sha;
+      int finalLine = 0;
+      int count = 0;
+      QString author;
+      QDateTime dateTime;
+      QString summary;
+   };
+
+   QSharedPointer<GitBase> mGit;
+   QSharedPointer<GitBlobReader> mBlobReader;
+   QPointer<GitRequestorProcess> mBlameProcess;
+   QString mFile;
+   QString mSha;
+   int mBlobRequest = 0;
+   int mRequest = 0;
+   QByteArray mPendingLine;
+   BlameEntry mEntry;
+   QHash<QString, int> mCommits;
+   BlameCache::Blame mBlame;
+   bool mLoading = false;
+   qint64 mTraceStart = -1;
+   bool mBlameReceived = false;
+   bool mBlameFinished = false;
+   bool mTextLoaded = false;
+   bool mTextMissing = false;
+
+   bool reuseBlame(const QString &baseSha, QVector<QPair<int, int>> &lines);
+   void loadText();
+   void processBlameData(const QByteArray &data);
+   void parseBlameLine(const QString &line);
+   int addCommit(const BlameCache::Commit &commit);
+   void annotate(int firstLine, int count, int commit);
+   void setText(const QString &text);
+   void onBlameFinished();
+   void finishIfLoaded();
+};
@@ -0,0 +1,402 @@
+#include "FileBlameView.h"
+
+#include <CommitInfo.h>
+#include <GitQlientStyles.h>
+
+#include <QHelpEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QToolTip>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace
+{
+const std::array<QColor, FileBlameView::TOTAL_COLORS> kBorderColors {
+   QColor(25, 65, 99),    QColor(36, 95, 146),   QColor(44, 116, 177),  QColor(56, 136, 205),
+   QColor(87, 155, 213),  QColor(118, 174, 221), QColor(150, 192, 221), QColor(197, 220, 240)
+};
+const QColor kLocalChangesColor("#D89000");
+const int kColorGuideWidth = 5;
+const int kPadding = 5;
+}
+
+FileBlameView::FileBlameView(QWidget *parent)
+   : QAbstractScrollArea(parent)
+{
+   mInfoFont.setPointSize(9);
+
+   mCodeFont = QFont(mInfoFont);
+   mCodeFont.setFamily("Ubuntu Mono");
+   mCodeFont.setPointSize(10);
+
+   mRowHeight = std::max(QFontMetrics(mInfoFont).height(), QFontMetrics(mCodeFont).height()) + 4;
+
+   viewport()->setMouseTracking(true);
+
+   updateScrollBars();
+}
+
+void FileBlameView::clear()
+{
+   mCommits.clear();
+   mLineCommits.clear();
+   mLineOffsets.clear();
+   mText.clear();
+   mBlockStarts.clear();
+   mAges.clear();
+   mHoveredBlock = -1;
+   mLongestLine = 0;
+   mDateWidth = 0;
+   mAuthorWidth = 0;
+   mMessageWidth = 0;
+   mNumberWidth = 0;
+   mDirty = false;
+
+   verticalScrollBar()->setValue(0);
+   horizontalScrollBar()->setValue(0);
+
+   updateScrollBars();
+
+   viewport()->update();
+}
+
+void FileBlameView::setText(const QString &text)
+{
+   mText = text;
+   mLineOffsets.clear();
+   mLongestLine = 0;
+
+   auto offset = 0;
+
+   while (offset < mText.size())
+   {
+      auto end = mText.indexOf('\n', offset);
+
+      if (end == -1)
+         end = mText.size();
+
+      const auto line = mText.midRef(offset, end - offset);
+
+      mLineOffsets.append(offset);
+      mLongestLine = std::max(mLongestLine, line.size() + line.count(QLatin1Char('\t')) * 3);
+
+      offset = end + 1;
+   }
+
+   // The last offset closes the last line.
+   mLineOffsets.append(offset);
+
+   mDirty = true;
+
+   updateScrollBars();
+
+   viewport()->update();
+}
+
+int FileBlameView::addCommit(const Commit &commit)
+{
+   const QFontMetrics infoMetrics(mInfoFont);
+   const auto charWidth = infoMetrics.boundingRect(QLatin1Char('M')).width();
+
+   // The long names and titles are elided so the code keeps most of the width.
+   mDateWidth = std::max(mDateWidth, infoMetrics.boundingRect(commit.when).width() + 3 * kPadding);
+   mAuthorWidth = std::max(mAuthorWidth,
+                           std::min(infoMetrics.boundingRect(commit.author).width(), 20 * charWidth) + 3 * kPadding);
+   mMessageWidth = std::max(mMessageWidth,
+                            std::min(infoMetrics.boundingRect(commit.message).width(), MAX_MESSAGE_SIZE * charWidth)
+                                + 3 * kPadding);
+
+   mCommits.append(commit);
+   mDirty = true;
+
+   return mCommits.count() - 1;
+}
+
+void FileBlameView::annotate(int firstLine, int count, int commit)
+{
+   if (firstLine + count > mLineCommits.count())
+   {
+      // The lines that haven't been annotated yet have no commit.
+      const auto previousCount = mLineCommits.count();
+      mLineCommits.resize(firstLine + count);
+      std::fill(mLineCommits.begin() + previousCount, mLineCommits.end(), -1);
+   }
+
+   std::fill(mLineCommits.begin() + firstLine, mLineCommits.begin() + firstLine + count, commit);
+
+   mDirty = true;
+
+   // The blocks and the scroll bars are updated once for all the annotations that arrive together.
+   viewport()->update();
+}
+
+void FileBlameView::updateAnnotations()
+{
+   if (!mDirty)
+      return;
+
+   mDirty = false;
+   mHoveredBlock = -1;
+
+   // The text can arrive before the annotations: its lines have no commit yet.
+   const auto rows = rowCount();
+   const auto previousCount = mLineCommits.count();
+   mLineCommits.resize(rows);
+
+   if (previousCount < rows)
+      std::fill(mLineCommits.begin() + previousCount, mLineCommits.end(), -1);
+
+   mBlockStarts.clear();
+
+   for (auto row = 0; row < rows; ++row)
+   {
+      if (row == 0 || mLineCommits.at(row) != mLineCommits.at(row - 1))
+         mBlockStarts.append(row);
+   }
+
+   // The color guide splits the time between the oldest and the newest commit in equal parts.
+   auto secondsNewest = std::numeric_limits<qint64>::min();
+   auto secondsOldest = std::numeric_limits<qint64>::max();
+
+   for (const auto &commit : qAsConst(mCommits))
+   {
+      if (commit.sha != CommitInfo::ZERO_SHA)
+      {
+         secondsNewest = std::max(secondsNewest, commit.dateTime.toSecsSinceEpoch());
+         secondsOldest = std::min(secondsOldest, commit.dateTime.toSecsSinceEpoch());
+      }
+   }
+
+   const auto incrementSecs = secondsNewest > secondsOldest
+       ? std::max<qint64>(1, (secondsNewest - secondsOldest) / (TOTAL_COLORS - 1))
+       : 1;
+
+   mAges.resize(mCommits.count());
+
+   for (auto i = 0; i < mCommits.count(); ++i)
+   {
+      const auto &commit = mCommits.at(i);
+      const auto age = (secondsNewest - commit.dateTime.toSecsSinceEpoch()) / incrementSecs;
+
+      mAges[i] = commit.sha == CommitInfo::ZERO_SHA ? -1 : static_cast<int>(std::min<qint64>(age, TOTAL_COLORS - 1));
+   }
+
+   auto digits = 1;
+
+   for (auto max = rows; max >= 10; max /= 10)
+      ++digits;
+
+   mNumberWidth = kColorGuideWidth + 2 * kPadding
+       + QFontMetrics(mCodeFont).boundingRect(QLatin1Char('9')).width() * digits;
+
+   updateScrollBars();
+}
+
+void FileBlameView::paintEvent(QPaintEvent *event)
+{
+   updateAnnotations();
+
+   QPainter painter(viewport());
+   painter.fillRect(event->rect(), GitQlientStyles::getBackgroundColor());
+
+   const auto &lineCommits = mLineCommits;
+
+   if (lineCommits.isEmpty())
+   {
+      painter.setPen(GitQlientStyles::getTextColor());
+      painter.drawText(viewport()->rect(), Qt::AlignCenter, tr("Select a file to blame"));
+      return;
+   }
+
+   const auto firstVisibleRow = verticalScrollBar()->value();
+   const auto firstRow = firstVisibleRow + event->rect().top() / mRowHeight;
+   const auto lastRow = std::min(lineCommits.count() - 1, firstVisibleRow + event->rect().bottom() / mRowHeight);
+   const auto x = -horizontalScrollBar()->value();
+   const auto info = infoWidth();
+   const QFontMetrics infoMetrics(mInfoFont);
+   const QFontMetrics codeMetrics(mCodeFont);
+   const auto separatorColor = [] {
+      auto color = GitQlientStyles::getTextColor();
+      color.setAlpha(80);
+      return color;
+   }();
+
+   for (auto row = firstRow; row <= lastRow; ++row)
+   {
+      const auto y = (row - firstVisibleRow) * mRowHeight;
+      const auto block = blockOf(row);
+      const auto commitIndex = lineCommits.at(row);
+
+      if (block == mHoveredBlock && commitIndex != -1)
+         painter.fillRect(QRect(x, y, info, mRowHeight), GitQlientStyles::getGraphHoverColor());
+
+      if (row == mBlockStarts.at(block) && row != 0)
+      {
+         painter.setPen(separatorColor);
+         painter.drawLine(x, y, x + info, y);
+      }
+
+      // The information of the commit is shown once in its block, in the first row that is visible.
+      if (commitIndex != -1 && (row == mBlockStarts.at(block) || row == firstVisibleRow))
+      {
+         const auto &commit = mCommits.at(commitIndex);
+         const auto textY = y + (mRowHeight - infoMetrics.height()) / 2 + infoMetrics.ascent();
+         auto textX = x + kPadding;
+
+         painter.setFont(mInfoFont);
+         painter.setPen(GitQlientStyles::getTextColor());
+         painter.drawText(textX, textY, commit.when);
+         textX += mDateWidth;
+         painter.drawText(textX, textY,
+                          infoMetrics.elidedText(commit.author, Qt::ElideRight, mAuthorWidth - 3 * kPadding));
+         textX += mAuthorWidth;
+         painter.drawText(textX, textY,
+                          infoMetrics.elidedText(commit.message, Qt::ElideRight, mMessageWidth - 3 * kPadding));
+      }
+
+      const auto numberX = x + info;
+
+      if (commitIndex != -1)
+      {
+         const auto age = mAges.at(commitIndex);
+         painter.fillRect(QRect(numberX, y, kColorGuideWidth, mRowHeight),
+                          age == -1 ? kLocalChangesColor : kBorderColors.at(age));
+      }
+
+      painter.setFont(mCodeFont);
+      painter.setPen(GitQlientStyles::getTextColor());
+      painter.drawText(QRect(numberX, y, mNumberWidth - kPadding, mRowHeight), Qt::AlignVCenter | Qt::AlignRight,
+                       QString::number(row + 1));
+      painter.setPen(separatorColor);
+      painter.drawLine(numberX + mNumberWidth, y, numberX + mNumberWidth, y + mRowHeight);
+
+      const auto text = lineText(row).replace('\t', QLatin1String("    "));
+
+      painter.setPen(GitQlientStyles::getTextColor());
+      painter.drawText(numberX + mNumberWidth + kPadding,
+                       y + (mRowHeight - codeMetrics.height()) / 2 + codeMetrics.ascent(), text);
+   }
+}
+
+void FileBlameView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void FileBlameView::mouseMoveEvent(QMouseEvent *event)
+{
+   updateAnnotations();
+
+   const auto row = rowAt(event->pos());
+   const auto block = row != -1 ? blockOf(row) : -1;
+
+   viewport()->setCursor(block != -1 ? Qt::PointingHandCursor : Qt::ArrowCursor);
+
+   if (block != mHoveredBlock)
+   {
+      mHoveredBlock = block;
+      viewport()->update();
+   }
+}
+
+void FileBlameView::mouseReleaseEvent(QMouseEvent *event)
+{
+   const auto row = rowAt(event->pos());
+
+   if (event->button() == Qt::LeftButton && row != -1)
+      emit signalCommitSelected(mCommits.at(mLineCommits.at(row)).sha);
+}
+
+void FileBlameView::leaveEvent(QEvent *event)
+{
+   QAbstractScrollArea::leaveEvent(event);
+
+   if (mHoveredBlock != -1)
+   {
+      mHoveredBlock = -1;
+      viewport()->update();
+   }
+}
+
+bool FileBlameView::viewportEvent(QEvent *event)
+{
+   if (event->type() == QEvent::ToolTip)
+   {
+      const auto helpEvent = static_cast<QHelpEvent *>(event);
+      const auto row = rowAt(helpEvent->pos());
+
+      if (row != -1)
+      {
+         const auto &commit = mCommits.at(mLineCommits.at(row));
+
+         QToolTip::showText(helpEvent->globalPos(),
+                            QString("<p>%1</p><p>%2</p><p>%3</p>")
+                                .arg(commit.sha, commit.message, commit.dateTime.toString("dd/MM/yyyy hh:mm")),
+                            viewport());
+      }
+      else
+         QToolTip::hideText();
+
+      return true;
+   }
+
+   return QAbstractScrollArea::viewportEvent(event);
+}
+
+int FileBlameView::rowAt(const QPoint &pos) const
+{
+   // Only the information of the commits reacts to the mouse.
+   if (pos.x() + horizontalScrollBar()->value() >= infoWidth())
+      return -1;
+
+   const auto row = verticalScrollBar()->value() + pos.y() / mRowHeight;
+
+   // The lines that are not annotated yet have no commit to select.
+   return row < mLineCommits.count() && mLineCommits.at(row) != -1 ? row : -1;
+}
+
+int FileBlameView::rowCount() const
+{
+   return std::max(mLineOffsets.count() - 1, mLineCommits.count());
+}
+
+QString FileBlameView::lineText(int row) const
+{
+   if (row + 1 >= mLineOffsets.count())
+      return QString();
+
+   return mText.mid(mLineOffsets.at(row), mLineOffsets.at(row + 1) - mLineOffsets.at(row) - 1);
+}
+
+int FileBlameView::blockOf(int row) const
+{
+   const auto it = std::upper_bound(mBlockStarts.cbegin(), mBlockStarts.cend(), row);
+
+   return static_cast<int>(it - mBlockStarts.cbegin()) - 1;
+}
+
+int FileBlameView::infoWidth() const
+{
+   return mDateWidth + mAuthorWidth + mMessageWidth;
+}
+
+void FileBlameView::updateScrollBars()
+{
+   const auto visibleRows = std::max(1, viewport()->height() / mRowHeight);
+   const auto charWidth = QFontMetrics(mCodeFont).boundingRect(QLatin1Char('M')).width();
+   const auto width = infoWidth() + mNumberWidth + 2 * kPadding + mLongestLine * charWidth;
+
+   verticalScrollBar()->setRange(0, std::max(0, rowCount() - visibleRows));
+   verticalScrollBar()->setPageStep(visibleRows);
+
+   horizontalScrollBar()->setRange(0, std::max(0, width - viewport()->width()));
+   horizontalScrollBar()->setSingleStep(charWidth);
+   horizontalScrollBar()->setPageStep(viewport()->width());
+}
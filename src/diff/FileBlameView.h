@@ -0,0 +1,174 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractScrollArea>
+#include <QDateTime>
+#include <QFont>
+#include <QVector>
+
+/*!
+ \brief The FileBlameView shows the blame of a file. Every row is a line of the file with, on the left, the commit that
+ last changed it: its date, its author and its title, shown once for every block of lines of the same commit. The
+ number of the line has a color guide: the bright color indicates the more recent changes whereas the darkest color
+ indicates the oldest.
+
+ The view paints the rows from a compact array of annotations: the commits are stored once and every line only keeps
+ the index of its commit and the offset of its text. Only the visible rows are painted, so the size of the file only
+ matters when the blame is set.
+
+ The blame can be filled while it arrives: the text of the file and the annotations of every group of lines are added
+ in any order, and the lines that are not annotated yet are shown without commit.
+
+ \class FileBlameView FileBlameView.h "FileBlameView.h"
+*/
+class FileBlameView : public QAbstractScrollArea
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the user clicks the information of a commit.
+
+    \param sha The SHA of the commit.
+   */
+   void signalCommitSelected(const QString &sha);
+
+public:
+   /*!
+    \brief A commit of the blame.
+   */
+   struct Commit
+   {
+      QString sha;
+      QString author;
+      QDateTime dateTime;
+      QString when;
+      QString message;
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit FileBlameView(QWidget *parent = nullptr);
+
+   /*!
+    \brief Removes the text and the annotations.
+   */
+   void clear();
+   /*!
+    \brief Sets the text of the file.
+
+    \param text The contents of the file.
+   */
+   void setText(const QString &text);
+   /*!
+    \brief Adds a commit to the blame.
+
+    \param commit The commit.
+    \return The index of the commit, to pass to \ref annotate.
+   */
+   int addCommit(const Commit &commit);
+   /*!
+    \brief Sets the commit of a group of lines.
+
+    \param firstLine The first line, starting at 0.
+    \param count The number of lines.
+    \param commit The index of the commit.
+   */
+   void annotate(int firstLine, int count, int commit);
+
+   /*!
+    \brief The number of colors of the guide.
+   */
+   static constexpr int TOTAL_COLORS = 8;
+
+protected:
+   /*!
+    \brief Paints the visible rows.
+
+    \param event The paint event.
+   */
+   void paintEvent(QPaintEvent *event) override;
+   /*!
+    \brief Updates the ranges of the scroll bars to the new size of the viewport.
+
+    \param event The resize event.
+   */
+   void resizeEvent(QResizeEvent *event) override;
+   /*!
+    \brief Highlights the commit under the mouse.
+
+    \param event The mouse event.
+   */
+   void mouseMoveEvent(QMouseEvent *event) override;
+   /*!
+    \brief Notifies the commit that was clicked.
+
+    \param event The mouse event.
+   */
+   void mouseReleaseEvent(QMouseEvent *event) override;
+   /*!
+    \brief Removes the highlight of the commit when the mouse leaves the view.
+
+    \param event The event.
+   */
+   void leaveEvent(QEvent *event) override;
+   /*!
+    \brief Shows the tooltip of the commit under the mouse.
+
+    \param event The event.
+   */
+   bool viewportEvent(QEvent *event) override;
+
+private:
+   static constexpr int MAX_MESSAGE_SIZE = 50;
+
+   QVector<Commit> mCommits;
+   QVector<int> mLineCommits;
+   QVector<int> mLineOffsets;
+   QString mText;
+   QFont mInfoFont;
+   QFont mCodeFont;
+   int mRowHeight = 0;
+   int mDateWidth = 0;
+   int mAuthorWidth = 0;
+   int mMessageWidth = 0;
+   int mNumberWidth = 0;
+   int mLongestLine = 0;
+   QVector<int> mBlockStarts;
+   QVector<int> mAges;
+   bool mDirty = false;
+   int mHoveredBlock = -1;
+
+   int rowCount() const;
+   int rowAt(const QPoint &pos) const;
+   int blockOf(int row) const;
+   int infoWidth() const;
+   QString lineText(int row) const;
+   void updateAnnotations();
+   void updateScrollBars();
+};
@@ -23,20 +23,23 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <BlameCache.h>
+#include <FileBlameView.h>
+
 #include <QFrame>
-#include <QDateTime>
 
+class FileBlameLoader;
 class GitBase;
-class QScrollArea;
-class ClickableFrame;
 class QLabel;
-class RevisionsCache;
 
 /*!
- \brief The FileBalmeWidget class is the widget that creates the view for the blame of a file. It is formed by two
- parts: in the right side it is shown the code of the file. In the right and for every different line, it is shown the
- information of the commit with a color guide. The bright color indicates the more recent changes whereas the darkest
- color indicates the oldest.
+ \brief The FileBalmeWidget class is the widget that creates the view for the blame of a file. It shows the SHAs that
+ are blamed and a FileBlameView with the code of the file and, for every block of lines, the information of the commit
+ that changed it.
+
+ The blame is loaded by a FileBlameLoader, and the lines are annotated in the view as they arrive. Blaming another
+ revision cancels the blame in progress, and the lines that didn't change since the revision shown before keep their
+ blame.
 
 */
 class FileBlameWidget : public QFrame
@@ -50,17 +53,19 @@ signals:
     \param sha
    */
    void signalCommitSelected(const QString &sha);
+   /*!
+    \brief Signal triggered when the blame of the current revision has been completely loaded.
+   */
+   void signalBlameLoaded();
 
 public:
    /*!
     \brief Default constructor.
 
-    \param cache The internal repository cache.
     \param git The git object to perform Git operations.
     \param parent The parent widget if needed.
    */
-   explicit FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
-                            QWidget *parent = nullptr);
+   explicit FileBlameWidget(const QSharedPointer<GitBase> &git, QWidget *parent = nullptr);
 
    /*!
     \brief Sets up the widget by providing the file to blame and the last commit SHA where the file was modified. The
@@ -93,81 +98,31 @@ public:
    QString getCurrentFile() const { return mCurrentFile; }
 
 private:
-   QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
-   QFrame *mAnotation = nullptr;
    QLabel *mCurrentSha = nullptr;
    QLabel *mPreviousSha = nullptr;
-   QScrollArea *mScrollArea = nullptr;
-   QFont mInfoFont;
-   QFont mCodeFont;
+   FileBlameView *mBlameView = nullptr;
+   FileBlameLoader *mLoader = nullptr;
    QString mCurrentFile;
+   QString mBlameSha;
 
    /*!
-    \brief Private class that stores data of a annotation. An annotation is the informatio regarding when a line was
-    last modified.
-
-   */
-   struct Annotation
-   {
-      QString sha;
-      QString author;
-      QDateTime dateTime;
-      int line = 0;
-      QString content;
-   };
-
-   /*!
-    \brief Processes a blame converting the git output into a vector of annotations per each line.
-
-    \param blame The git blame output.
-    \return QVector<Annotation> Vector of the annotations for every line.
-   */
-   QVector<Annotation> processBlame(const QString &blame);
-   /*!
-    \brief Process all the \p annotations and creates the view of the file with that information.
-
-    \param annotations The annotations to process.
-   */
-   void formatAnnotatedFile(const QVector<Annotation> &annotations);
-   /*!
-    \brief Factory method that creates a label with the date and time based on an annotation.
-
-    \param annotation The annotation to process.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
-   */
-   QLabel *createDateLabel(const Annotation &annotation, bool isFirst);
-   /*!
-    \brief Factory method that creates a label with the author information based on an annotation.
-
-    \param author The author to be shown.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
-   */
-   QLabel *createAuthorLabel(const QString &author, bool isFirst);
-   /*!
-    \brief Factory method that creates a Clickable frame with the informatio of the commit (SHA and title).
+    \brief Adds a commit of the blame to the view.
 
-    \param sha The sha to show.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return ClickableFrame Returns a newly created ClickableFrame.
+    \param commit The commit.
    */
-   ClickableFrame *createMessageLabel(const QString &sha, bool isFirst);
+   void addCommit(const BlameCache::Commit &commit);
    /*!
-    \brief Factory method that creates a label with the number of line. Uses the \p annotation parameter to display a
-    visual help about when the change was done.
+    \brief Called when the blame finishes. Warns the user if Git didn't blame any line.
 
-    \param annotation The annotation to process.
-    \param row The row to display.
-    \return QLabel Returns a newly created QLabel.
+    \param blamed False if Git didn't give any line.
    */
-   QLabel *createNumLabel(const Annotation &annotation, int row);
+   void onBlameFinished(bool blamed);
    /*!
-    \brief Factory method that creates a label with the code line to be displayed.
+    \brief Describes how long ago a commit was done, like "3 days ago".
 
-    \param content The code line to display.
-    \return QLabel Returns a newly created QLable.
+    \param dateTime The date of the commit.
+    \return The description.
    */
-   QLabel *createCodeLabel(const QString &content);
+   static QString relativeDate(const QDateTime &dateTime);
 };
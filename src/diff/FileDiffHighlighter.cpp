@@ -1,42 +1,276 @@
 #include "FileDiffHighlighter.h"
 
+#include <DiffModel.h>
 #include <GitQlientStyles.h>
+#include <WordDiff.h>
 
-FileDiffHighlighter::FileDiffHighlighter(QTextDocument *document)
-   : QSyntaxHighlighter(document)
+#include <QElapsedTimer>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTextEdit>
+#include <QTextLayout>
+
+#include <algorithm>
+
+FileDiffHighlighter::FileDiffHighlighter(QTextEdit *editor)
+   : QObject(editor)
+   , mEditor(editor)
+   , mDocument(editor->document())
+   , mCursorForPosition([editor](const QPoint &pos) { return editor->cursorForPosition(pos); })
+   , mWordDiff(new WordDiff(this))
+{
+   setup();
+}
+
+FileDiffHighlighter::FileDiffHighlighter(QPlainTextEdit *editor)
+   : QObject(editor)
+   , mEditor(editor)
+   , mDocument(editor->document())
+   , mCursorForPosition([editor](const QPoint &pos) { return editor->cursorForPosition(pos); })
+   , mWordDiff(new WordDiff(this))
 {
+   setup();
+}
+
+void FileDiffHighlighter::setup()
+{
+   // The formats are the same for every block, so they are only built once.
+   mHunkFormat.setForeground(GitQlientStyles::getOrange());
+   mHunkFormat.setFontWeight(QFont::ExtraBold);
+   mAdditionFormat.setForeground(GitQlientStyles::getGreen());
+   mRemovalFormat.setForeground(GitQlientStyles::getRed());
+   mFileFormat.setForeground(GitQlientStyles::getBlue());
+   mFileFormat.setFontWeight(QFont::ExtraBold);
+   mFileInfoFormat.setForeground(GitQlientStyles::getBlue());
+
+   auto wordBackground = GitQlientStyles::getGreen();
+   wordBackground.setAlpha(60);
+   mAddedWordFormat.setBackground(wordBackground);
+   wordBackground = GitQlientStyles::getRed();
+   wordBackground.setAlpha(60);
+   mRemovedWordFormat.setBackground(wordBackground);
+
+   mTimer.setSingleShot(true);
+   mTimer.setInterval(0);
+
+   connect(&mTimer, &QTimer::timeout, this, &FileDiffHighlighter::highlightNextSlice);
+   connect(mWordDiff, &WordDiff::signalHunkCompared, this, &FileDiffHighlighter::onHunkCompared);
+   connect(mDocument, &QTextDocument::contentsChange, this, &FileDiffHighlighter::onContentsChange);
+   connect(mEditor->verticalScrollBar(), &QScrollBar::valueChanged, this, &FileDiffHighlighter::highlightVisibleBlocks);
 }
 
-void FileDiffHighlighter::highlightBlock(const QString &text)
+void FileDiffHighlighter::setDiff(const QSharedPointer<const DiffModel> &diff)
 {
-   setCurrentBlockState(previousBlockState() + 1);
+   // The hunks of the previous diff that are still waiting are not going to be shown.
+   mWordDiff->cancel();
+
+   mDiff = diff;
+
+   // The visible blocks are only known once the editor has laid out the new text.
+   mTimer.start();
+}
+
+void FileDiffHighlighter::rehighlight()
+{
+   // The blocks store the generation they were highlighted in, so a new one marks all of them as pending.
+   ++mGeneration;
+   mNextBlock = 0;
+
+   mTimer.start();
+}
+
+void FileDiffHighlighter::onContentsChange(int position, int, int charsAdded)
+{
+   if (mApplying)
+      return;
+
+   // A new text makes the model stale until the editor sets the one that belongs to it.
+   mDiff.clear();
 
-   if (!text.isEmpty())
+   // The blocks outside the change keep their text and their formats, so only the changed ones are highlighted again.
+   auto block = mDocument->findBlock(position);
+   const auto last = mDocument->findBlock(position + charsAdded);
+   const auto first = block.blockNumber();
+
+   while (block.isValid() && block.blockNumber() <= last.blockNumber())
    {
-      QBrush green = GitQlientStyles::getGreen();
-      QBrush magenta = GitQlientStyles::getRed();
-      QBrush orange = GitQlientStyles::getOrange();
+      block.setUserState(-1);
+      block = block.next();
+   }
+
+   mNextBlock = mTimer.isActive() ? std::min(mNextBlock, first) : first;
+   mTimer.start();
+}
 
-      QTextCharFormat myFormat;
-      const char firstChar = text.at(0).toLatin1();
+void FileDiffHighlighter::highlightVisibleBlocks()
+{
+   const auto bottomRight = mEditor->viewport()->rect().bottomRight();
+   auto block = mCursorForPosition(QPoint(0, 0)).block();
+   const auto last = mCursorForPosition(bottomRight).block().blockNumber();
+   auto lastHunk = -1;
 
-      switch (firstChar)
+   while (block.isValid() && block.blockNumber() <= last)
+   {
+      // The visible hunks are the ones whose words are compared.
+      if (mDiff && block.blockNumber() < mDiff->lineCount())
       {
-         case '@':
-            myFormat.setForeground(orange);
-            myFormat.setFontWeight(QFont::ExtraBold);
-            break;
-         case '+':
-            myFormat.setForeground(green);
-            break;
-         case '-':
-            myFormat.setForeground(magenta);
-            break;
-         default:
-            break;
+         const auto hunk = mDiff->hunkOf(mDiff->lineOffset(block.blockNumber()));
+
+         if (hunk != -1 && hunk != lastHunk)
+         {
+            mWordDiff->compare(mDiff, hunk, mDiff->hunkHash(hunk));
+            lastHunk = hunk;
+         }
       }
 
-      if (myFormat.isValid())
-         setFormat(0, text.length(), myFormat);
+      highlightBlock(block);
+      block = block.next();
    }
 }
+
+void FileDiffHighlighter::highlightNextSlice()
+{
+   if (!mDiff)
+      return;
+
+   highlightVisibleBlocks();
+
+   QElapsedTimer elapsed;
+   elapsed.start();
+
+   auto block = mDocument->findBlockByNumber(mNextBlock);
+
+   while (block.isValid() && elapsed.elapsed() < SLICE_MS)
+   {
+      highlightBlock(block);
+      block = block.next();
+   }
+
+   if (block.isValid())
+   {
+      mNextBlock = block.blockNumber();
+      mTimer.start();
+   }
+}
+
+void FileDiffHighlighter::highlightBlock(QTextBlock &block)
+{
+   // Without the model of the current text there is no way to know the kind of the line.
+   if (!mDiff || block.userState() == mGeneration)
+      return;
+
+   block.setUserState(mGeneration);
+
+   QVector<QTextLayout::FormatRange> ranges;
+
+   if (const auto format = formatFor(block))
+   {
+      QTextLayout::FormatRange range;
+      range.start = 0;
+      range.length = block.length();
+      range.format = *format;
+      ranges.append(range);
+
+      appendWordRanges(block, ranges);
+   }
+
+   // Most of the lines are context: when a block had no format and still has none, it doesn't need a new layout.
+   if (ranges.isEmpty() && block.layout()->formats().isEmpty())
+      return;
+
+   mApplying = true;
+   block.layout()->setFormats(ranges);
+   mDocument->markContentsDirty(block.position(), block.length());
+   mApplying = false;
+}
+
+void FileDiffHighlighter::appendWordRanges(const QTextBlock &block, QVector<QTextLayout::FormatRange> &ranges) const
+{
+   const auto line = block.blockNumber();
+   const auto kind = mDiff->lineKind(line);
+
+   if (kind != DiffModel::LineKind::Addition && kind != DiffModel::LineKind::Removal)
+      return;
+
+   const auto hunk = mDiff->hunkOf(mDiff->lineOffset(line));
+
+   if (hunk == -1)
+      return;
+
+   const auto changes = mWordDiff->find(mDiff->hunkHash(hunk));
+   const auto index = line - mDiff->hunks().at(hunk).firstLine;
+
+   if (!changes || index >= changes->count())
+      return;
+
+   // The ranges go after the one of the line, so their background is added to its color.
+   for (const auto &change : changes->at(index))
+   {
+      QTextLayout::FormatRange range;
+      range.start = change.start;
+      range.length = change.length;
+      range.format = kind == DiffModel::LineKind::Addition ? mAddedWordFormat : mRemovedWordFormat;
+      ranges.append(range);
+   }
+}
+
+void FileDiffHighlighter::onHunkCompared(quint64 hash)
+{
+   if (!mDiff)
+      return;
+
+   const auto &hunks = mDiff->hunks();
+   auto first = -1;
+
+   for (auto hunk = 0; hunk < hunks.count(); ++hunk)
+   {
+      if (mDiff->hunkHash(hunk) != hash)
+         continue;
+
+      // The blocks of the hunk are highlighted again with the ranges of the words.
+      const auto end = hunk + 1 < hunks.count() ? hunks.at(hunk + 1).firstLine : mDiff->lineCount();
+      auto block = mDocument->findBlockByNumber(hunks.at(hunk).firstLine);
+
+      while (block.isValid() && block.blockNumber() < end)
+      {
+         block.setUserState(-1);
+         block = block.next();
+      }
+
+      if (first == -1)
+         first = hunks.at(hunk).firstLine;
+   }
+
+   if (first == -1)
+      return;
+
+   mNextBlock = mTimer.isActive() ? std::min(mNextBlock, first) : first;
+   mTimer.start();
+}
+
+const QTextCharFormat *FileDiffHighlighter::formatFor(const QTextBlock &block) const
+{
+   // The editor shows the text of the model, so every block is the line with the same number.
+   if (!mDiff || block.blockNumber() >= mDiff->lineCount())
+      return nullptr;
+
+   switch (mDiff->lineKind(block.blockNumber()))
+   {
+      case DiffModel::LineKind::Hunk:
+         return &mHunkFormat;
+      case DiffModel::LineKind::Addition:
+         return &mAdditionFormat;
+      case DiffModel::LineKind::Removal:
+         return &mRemovalFormat;
+      case DiffModel::LineKind::FileHeader:
+         return &mFileFormat;
+      case DiffModel::LineKind::FileInfo:
+         return &mFileInfoFormat;
+      case DiffModel::LineKind::Context:
+         break;
+   }
+
+   return nullptr;
+}
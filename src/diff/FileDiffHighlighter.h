@@ -22,30 +22,96 @@
  ** License along with this library; if not, write to the Free Software
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
-#include <QSyntaxHighlighter>
+#include <QObject>
+#include <QSharedPointer>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <QTextLayout>
+#include <QTimer>
+
+#include <functional>
+
+class DiffModel;
+class WordDiff;
+class QAbstractScrollArea;
+class QPlainTextEdit;
+class QTextBlock;
+class QTextDocument;
+class QTextEdit;
 
 /*!
- \brief Overloaded class that adds syntax highlight for the diff view. It shows the additions in green, removals in red
- and the files where that happened in blue.
+ \brief Adds syntax highlight for the diff views. It shows the additions in green, removals in red and the files where
+ that happened in blue. The kind of every line comes from the DiffModel of the diff, so the text is not parsed again.
+
+ The highlight doesn't run over the whole document when the text changes. The blocks that are visible in the editor
+ are highlighted first, and the rest are highlighted in short slices when the event loop is idle, so a huge diff can be
+ scrolled right after it's set while the colors catch up. Scrolling to a block that isn't highlighted yet highlights
+ it immediately. When only a part of the text is replaced, only its blocks are highlighted again.
+
+ The words that changed inside the modified lines are marked with a background once the WordDiff has compared their
+ hunk. Only the visible hunks are compared, in a worker thread, and they are updated when the result arrives.
 
  \class FileDiffHighlighter FileDiffHighlighter.h "FileDiffHighlighter.h"
 */
-class FileDiffHighlighter : public QSyntaxHighlighter
+class FileDiffHighlighter : public QObject
 {
    Q_OBJECT
 
 public:
    /*!
-    \brief Default constructor.
+    \brief Creates the highlighter for a QTextEdit.
+
+    \param editor The editor to highlight. It becomes the parent of the highlighter.
+   */
+   explicit FileDiffHighlighter(QTextEdit *editor);
+   /*!
+    \brief Creates the highlighter for a QPlainTextEdit.
 
-    \param document The document to parse.
+    \param editor The editor to highlight. It becomes the parent of the highlighter.
    */
-   explicit FileDiffHighlighter(QTextDocument *document);
+   explicit FileDiffHighlighter(QPlainTextEdit *editor);
 
    /*!
-    \brief Analyses a block of text and applies the syntax highlighter.
+    \brief Sets the parsed diff that the editor shows and highlights it. It must be called every time the text of the
+    editor changes, after the text is set.
 
-    \param text The block of text to analyse.
+    \param diff The parsed diff, or null when the editor is empty.
    */
-   void highlightBlock(const QString &text) override;
+   void setDiff(const QSharedPointer<const DiffModel> &diff);
+   /*!
+    \brief Highlights again the whole document, starting with the visible blocks.
+   */
+   void rehighlight();
+
+private:
+   /*!
+    \brief The time, in milliseconds, that a slice of the background highlighting can take.
+   */
+   static constexpr int SLICE_MS = 8;
+
+   QAbstractScrollArea *mEditor = nullptr;
+   QTextDocument *mDocument = nullptr;
+   std::function<QTextCursor(const QPoint &)> mCursorForPosition;
+   QSharedPointer<const DiffModel> mDiff;
+   QTextCharFormat mHunkFormat;
+   QTextCharFormat mAdditionFormat;
+   QTextCharFormat mRemovalFormat;
+   QTextCharFormat mFileFormat;
+   QTextCharFormat mFileInfoFormat;
+   QTextCharFormat mAddedWordFormat;
+   QTextCharFormat mRemovedWordFormat;
+   WordDiff *mWordDiff = nullptr;
+   QTimer mTimer;
+   int mGeneration = 0;
+   int mNextBlock = 0;
+   bool mApplying = false;
+
+   void setup();
+   void onContentsChange(int position, int charsRemoved, int charsAdded);
+   void highlightVisibleBlocks();
+   void highlightNextSlice();
+   void highlightBlock(QTextBlock &block);
+   void appendWordRanges(const QTextBlock &block, QVector<QTextLayout::FormatRange> &ranges) const;
+   void onHunkCompared(quint64 hash);
+   const QTextCharFormat *formatFor(const QTextBlock &block) const;
 };
@@ -2,6 +2,7 @@
 
 #include <GitQlientStyles.h>
 
+#include <QMouseEvent>
 #include <QPainter>
 #include <QTextBlock>
 
@@ -65,6 +66,13 @@ void FileDiffView::resizeEvent(QResizeEvent *e)
    mLineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
 }
 
+void FileDiffView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+   QPlainTextEdit::mouseDoubleClickEvent(event);
+
+   emit signalLineDoubleClicked(cursorForPosition(event->pos()).blockNumber());
+}
+
 void FileDiffView::lineNumberAreaPaintEvent(QPaintEvent *event)
 {
    QPainter painter(mLineNumberArea);
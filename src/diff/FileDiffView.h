@@ -34,6 +34,14 @@ class FileDiffView : public QPlainTextEdit
 {
    Q_OBJECT
 
+signals:
+   /*!
+    \brief Signal triggered when the user double clicks a line.
+
+    \param line The number of the line, starting from 0.
+   */
+   void signalLineDoubleClicked(int line);
+
 public:
    /*!
     \brief Default constructor.
@@ -49,6 +57,12 @@ protected:
     \param event The resize event.
    */
    void resizeEvent(QResizeEvent *event) override;
+   /*!
+    \brief Overloaded method to notify which line the user double clicked.
+
+    \param event The mouse event.
+   */
+   void mouseDoubleClickEvent(QMouseEvent *event) override;
 
 private:
    /*!
@@ -1,17 +1,33 @@
 #include "FileDiffWidget.h"
 
 #include <GitHistory.h>
+#include <GitLocal.h>
 #include <FileDiffView.h>
 #include <FileDiffHighlighter.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
 #include <DiffInfoPanel.h>
+#include <DiffFindBar.h>
+#include <DiffTextView.h>
+#include <DiffModel.h>
+#include <GitBlobReader.h>
+#include <GitQlientSettings.h>
+#include <DiffSideBySideView.h>
+#include <GitRequestorProcess.h>
+#include <DiffCache.h>
+#include <GitBase.h>
+#include <TraceRecorder.h>
+#include <HibernatedDiff.h>
+#include <ImageDiffPreview.h>
 
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QLabel>
 #include <QScrollBar>
 #include <QDateTime>
+#include <QFile>
+#include <QMessageBox>
+#include <QTextBlock>
 
 FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                                QWidget *parent)
@@ -22,11 +38,33 @@ FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointe
    , mGoPrevious(new QPushButton())
    , mGoNext(new QPushButton())
    , mDiffInfoPanel(new DiffInfoPanel(cache))
+   , mFindBar(new DiffFindBar(mDiffView))
+   , mLargeDiffView(new DiffTextView())
+   , mLoadingPanel(new QFrame())
+   , mLoadingLabel(new QLabel())
+   , mCancelLoading(new QPushButton(tr("Cancel")))
+   , mExpandAll(new QPushButton(tr("Show the whole file")))
+   , mSideBySide(new QPushButton(tr("Side by side")))
+   , mStageSelection(new QPushButton(tr("Stage selection")))
+   , mSideBySideView(new DiffSideBySideView())
+   , mBlobReader(GitBlobReader::instance(git))
+   , mHibernated(new HibernatedDiff(cache.data(), this))
+   , mImagePreview(new ImageDiffPreview(git, cache))
 
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
-   mDiffHighlighter = new FileDiffHighlighter(mDiffView->document());
+   mDiffHighlighter = new FileDiffHighlighter(mDiffView);
+
+   // The restored text goes back to the cache of diffs, so it's shown as any other diff that is already known.
+   connect(mHibernated, &HibernatedDiff::signalRestored, this, [this](const QStringList &texts, int scrollPosition) {
+      if (!mCompacted)
+         return;
+
+      DiffCache::insert(mDiffKey, texts.constFirst());
+      configure(mCurrentSha, mPreviousSha, mCurrentFile);
+      shownScrollBar()->setValue(scrollPosition);
+   });
 
    mGoPrevious->setIcon(QIcon(":/icons/go_up"));
    mGoNext->setIcon(QIcon(":/icons/go_down"));
@@ -34,13 +72,146 @@ FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointe
    const auto vLayout = new QVBoxLayout(this);
    vLayout->setContentsMargins(QMargins());
    vLayout->setSpacing(10);
+   const auto loadingLayout = new QHBoxLayout(mLoadingPanel);
+   loadingLayout->setContentsMargins(QMargins());
+   loadingLayout->setSpacing(10);
+   loadingLayout->addWidget(mLoadingLabel);
+   loadingLayout->addStretch();
+   loadingLayout->addWidget(mCancelLoading);
+
+   mLoadingPanel->setVisible(false);
+
+   connect(mCancelLoading, &QPushButton::clicked, this, [this]() {
+      cancelLoading();
+      mLoadingLabel->setText(tr("Loading the diff was cancelled."));
+      mCancelLoading->setVisible(false);
+   });
+
+   mExpandAll->setEnabled(false);
+   mExpandAll->setToolTip(tr("Shows all the lines of the file around the changes. Double click the header of a hunk "
+                             "to show only some more lines above it."));
+
+   connect(mExpandAll, &QPushButton::clicked, this, [this]() { expandContext(EXPAND_ALL); });
+   const auto expandAtLine = [this](int line) {
+      if (const auto hunk = mHunks.hunkAt(line); hunk != -1)
+         expandContext(hunk);
+   };
+
+   connect(mDiffView, &FileDiffView::signalLineDoubleClicked, this, expandAtLine);
+   connect(mSideBySideView, &DiffSideBySideView::signalLineDoubleClicked, this, expandAtLine);
+
+   GitQlientSettings settings;
+   mSideBySide->setCheckable(true);
+   mSideBySide->setChecked(settings.value("sideBySideDiff", false).toBool());
+   mSideBySide->setToolTip(tr("Shows the old and the new version of the file next to each other."));
+
+   connect(mSideBySide, &QPushButton::toggled, this, [this](bool checked) {
+      GitQlientSettings settings;
+      settings.setValue("sideBySideDiff", checked);
+
+      if (mLargeDiffView->isHidden())
+         showTextView();
+   });
+   mStageSelection->setVisible(false);
+   mStageSelection->setEnabled(false);
+   mStageSelection->setToolTip(tr("Stages the changes of the lines selected, or the hunk where the cursor is if no "
+                                  "line is selected."));
+
+   connect(mStageSelection, &QPushButton::clicked, this, &FileDiffWidget::stageSelection);
+   connect(mBlobReader.data(), &GitBlobReader::signalBlobRead, this, [this](int request, const QByteArray &data) {
+      if (request == mBlobRequest)
+         onFileLinesLoaded(data);
+   });
+   connect(mBlobReader.data(), &GitBlobReader::signalBlobMissing, this, [this](int request) {
+      if (request == mBlobRequest)
+         mPendingExpansion = NO_EXPANSION;
+   });
+
+   const auto contextLayout = new QHBoxLayout();
+   contextLayout->setContentsMargins(QMargins());
+   contextLayout->addStretch();
+   contextLayout->addWidget(mStageSelection);
+   contextLayout->addWidget(mSideBySide);
+   contextLayout->addWidget(mExpandAll);
+
    vLayout->addWidget(mDiffInfoPanel);
+   vLayout->addLayout(contextLayout);
+   vLayout->addWidget(mImagePreview);
+   vLayout->addWidget(mLoadingPanel);
+   vLayout->addWidget(mFindBar);
    vLayout->addWidget(mDiffView);
+   vLayout->addWidget(mSideBySideView);
+   vLayout->addWidget(mLargeDiffView);
+
+   mLargeDiffView->setVisible(false);
+   mSideBySideView->setVisible(false);
+}
+
+FileDiffWidget::~FileDiffWidget()
+{
+   cancelLoading();
 }
 
 void FileDiffWidget::clear()
 {
    mDiffView->clear();
+   mDiff.clear();
+   mSideBySideView->setDiff(mDiff);
+   mLargeDiffView->clear();
+}
+
+qint64 FileDiffWidget::memoryUsage() const
+{
+   // The text of the diff is in the model and in the document of the view.
+   auto bytes
+       = static_cast<qint64>(mDiffBuffer.size()) + mLargeDiffView->memoryUsage() + mHibernated->memoryUsage();
+
+   if (mDiff)
+      bytes += mDiff->text().size() * static_cast<qint64>(sizeof(QChar)) * 2;
+
+   for (const auto &line : mFileLines)
+      bytes += line.size() * static_cast<qint64>(sizeof(QChar)) + static_cast<qint64>(sizeof(QString));
+
+   return bytes;
+}
+
+bool FileDiffWidget::compact()
+{
+   if (mCompacted || mDiffProcess)
+      return false;
+
+   clear();
+
+   mHasShownDiff = false;
+   mHunks = DiffHunks();
+   mBlobRequest = 0;
+   mFileLines.clear();
+   mFileLinesLoaded = false;
+   mCompacted = true;
+
+   return true;
+}
+
+bool FileDiffWidget::hibernate()
+{
+   if (mCompacted || mDiffProcess)
+      return false;
+
+   QString text;
+
+   if (mHasShownDiff && mCurrentSha != CommitInfo::ZERO_SHA && mLargeDiffView->isHidden()
+       && DiffCache::find(mDiffKey, text) && !text.isEmpty())
+   {
+      mHibernated->store({ text }, shownScrollBar()->value());
+   }
+
+   return compact();
+}
+
+void FileDiffWidget::restore()
+{
+   if (mCompacted && !mHibernated->restore())
+      configure(mCurrentSha, mPreviousSha, mCurrentFile);
 }
 
 bool FileDiffWidget::reload()
@@ -53,39 +224,352 @@ bool FileDiffWidget::reload()
 
 bool FileDiffWidget::configure(const QString &currentSha, const QString &previousSha, const QString &file)
 {
+   TraceSpan span("diff", "FileDiffWidget::configure");
+
+   // A reload of the same diff keeps the view, and its expanded context, if Git returns the same text.
+   if (currentSha != mCurrentSha || previousSha != mPreviousSha || file != mCurrentFile)
+      mHasShownDiff = false;
+
    mCurrentFile = file;
    mCurrentSha = currentSha;
    mPreviousSha = previousSha;
+   mCompacted = false;
+   mHibernated->clear();
 
    mDiffInfoPanel->configure(currentSha, previousSha);
+   mStageSelection->setVisible(mStagingEnabled && currentSha == CommitInfo::ZERO_SHA);
 
    auto destFile = file;
 
    if (destFile.contains("-->"))
       destFile = destFile.split("--> ").last().split("(").first().trimmed();
 
+   const auto sha = currentSha == CommitInfo::ZERO_SHA ? QString() : currentSha;
    QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   auto text = git->getFileDiff(currentSha == CommitInfo::ZERO_SHA ? QString() : currentSha, previousSha, destFile);
-   auto lines = text.split("\n");
 
-   for (auto i = 0; !lines.isEmpty() && i < 5; ++i)
-      lines.takeFirst();
+   cancelLoading();
 
-   if (!lines.isEmpty())
-   {
-      text = lines.join("\n");
+   mDestFile = destFile;
+
+   // The images are shown next to their diff, that only says that the binary files differ.
+   mImagePreview->configure(currentSha, previousSha, destFile);
 
-      const auto pos = mDiffView->verticalScrollBar()->value();
-      mDiffView->setPlainText(text);
+   mDiffKey = { mGit->getRepositoryId(), currentSha, previousSha, destFile, "hunks" };
 
-      mRowIndex = 0;
+   QString text;
 
-      mDiffView->moveCursor(QTextCursor::Start);
+   if (DiffCache::find(mDiffKey, text))
+   {
+      if (text.isEmpty())
+         return false;
 
-      mDiffView->verticalScrollBar()->setValue(pos);
+      mLoadingPanel->setVisible(false);
+      showDiff(text);
 
       return true;
    }
 
+   if (!git->hasFileChanges(sha, previousSha, destFile))
+   {
+      DiffCache::insert(mDiffKey, QString());
+      return false;
+   }
+
+   mDiffProcess = git->loadFileDiff(sha, previousSha, destFile);
+
+   if (!mDiffProcess)
+      return false;
+
+   mLoadingLabel->setText(tr("Loading the diff..."));
+   mCancelLoading->setVisible(true);
+   mLoadingPanel->setVisible(true);
+
+   connect(mDiffProcess, &GitRequestorProcess::procDataReady, this, [this](const QByteArray &data) {
+      mDiffBuffer.append(data);
+      mLoadingLabel->setText(tr("Loading the diff... %1 KB").arg(mDiffBuffer.size() / 1024));
+   });
+   connect(mDiffProcess, &GitRequestorProcess::procDataFinished, this, &FileDiffWidget::onDiffLoaded);
+
+   return true;
+}
+
+QScrollBar *FileDiffWidget::shownScrollBar() const
+{
+   if (mSideBySideView->isHidden())
+      return mDiffView->verticalScrollBar();
+
+   return mSideBySideView->verticalScrollBar();
+}
+
+void FileDiffWidget::cancelLoading()
+{
+   if (mDiffProcess)
+   {
+      disconnect(mDiffProcess.data(), nullptr, this, nullptr);
+      mDiffProcess->onCancel();
+   }
+
+   mDiffProcess.clear();
+   mDiffBuffer.clear();
+}
+
+void FileDiffWidget::onDiffLoaded()
+{
+   TraceSpan span("diff", "FileDiffWidget::onDiffLoaded");
+
+   mDiffProcess.clear();
+   mLoadingPanel->setVisible(false);
+
+   if (mDiffBuffer.size() >= DiffTextView::MIN_DIFF_SIZE)
+   {
+      showLargeDiff();
+      return;
+   }
+
+   const auto text = QString::fromUtf8(mDiffBuffer);
+
+   mDiffBuffer.clear();
+
+   DiffCache::insert(mDiffKey, text);
+   showDiff(text);
+}
+
+void FileDiffWidget::showLargeDiff()
+{
+   mHasShownDiff = false;
+   mHunks = DiffHunks();
+   mExpandAll->setEnabled(false);
+   mStageSelection->setEnabled(false);
+
+   // The header of git diff is skipped, like in showDiff, without copying the rest of the diff.
+   auto headerEnd = 0;
+
+   for (auto i = 0; i < 5 && headerEnd < mDiffBuffer.size(); ++i)
+   {
+      const auto newLine = mDiffBuffer.indexOf('\n', headerEnd);
+      headerEnd = newLine == -1 ? mDiffBuffer.size() : newLine + 1;
+   }
+
+   mDiffBuffer.remove(0, headerEnd);
+
+   mDiffView->clear();
+   mDiffView->setVisible(false);
+   mDiff.clear();
+   mSideBySideView->setDiff(mDiff);
+   mSideBySideView->setVisible(false);
+   mFindBar->setDiff(QSharedPointer<const DiffModel>());
+   mFindBar->setVisible(false);
+
+   mLargeDiffView->setDiff(mDiffBuffer);
+   mLargeDiffView->setVisible(true);
+
+   mDiffBuffer.clear();
+}
+
+void FileDiffWidget::showDiff(const QString &text)
+{
+   TraceSpan span("diff", "FileDiffWidget::showDiff");
+
+   // Comparing the hash of the output of Git avoids keeping it to know if a reload changed anything.
+   const auto hash = DiffModel::hashOf(text.midRef(0));
+
+   if (mHasShownDiff && hash == mShownHash && mLargeDiffView->isHidden())
+      return;
+
+   mHasShownDiff = true;
+   mShownHash = hash;
+
+   mLargeDiffView->clear();
+   mLargeDiffView->setVisible(false);
+
+   // The header of git diff is skipped: the view starts at the first hunk.
+   auto headerEnd = text.startsWith("@@") ? 0 : text.indexOf("\n@@");
+
+   if (headerEnd > 0)
+      ++headerEnd;
+   else if (headerEnd == -1)
+   {
+      // Without hunks (binary files, for example) only the header lines that name the file are skipped.
+      headerEnd = 0;
+
+      for (auto i = 0; i < 4 && headerEnd < text.size(); ++i)
+      {
+         const auto newLine = text.indexOf('\n', headerEnd);
+         headerEnd = newLine == -1 ? text.size() : newLine + 1;
+      }
+   }
+
+   const auto body = text.mid(headerEnd);
+
+   // The lines of the file are read again the next time they are needed: the diff changed, so the file might too.
+   mBlobRequest = 0;
+   mFileLines.clear();
+   mFileLinesLoaded = false;
+   mPendingExpansion = NO_EXPANSION;
+   mHunks = DiffHunks(body);
+   mExpandAll->setEnabled(mHunks.isValid());
+
+   setDiffText(body);
+   showTextView();
+}
+
+void FileDiffWidget::showTextView()
+{
+   const auto sideBySide = mSideBySide->isChecked();
+
+   // The rows of the side by side view are only built when it's shown.
+   if (sideBySide)
+      mSideBySideView->setDiff(mDiff);
+
+   mDiffView->setVisible(!sideBySide);
+   mSideBySideView->setVisible(sideBySide);
+
+   // The lines to stage are selected in the unified view.
+   mStageSelection->setEnabled(mHunks.isValid() && !sideBySide);
+}
+
+void FileDiffWidget::setDiffText(const QString &text)
+{
+   const QSharedPointer<const DiffModel> diff(new DiffModel(text));
+   mDiff = diff;
+
+   if (mSideBySide->isChecked())
+      mSideBySideView->setDiff(diff);
+
+   const auto pos = mDiffView->verticalScrollBar()->value();
+   mDiffView->setPlainText(diff->text());
+   mDiffHighlighter->setDiff(diff);
+
+   mRowIndex = 0;
+
+   mDiffView->moveCursor(QTextCursor::Start);
+
+   mDiffView->verticalScrollBar()->setValue(pos);
+
+   mFindBar->setDiff(diff);
+}
+
+bool FileDiffWidget::goToConflict(int conflict)
+{
+   if (!mDiff || !mLargeDiffView->isHidden())
+      return false;
+
+   auto found = -1;
+
+   // The view shows the lines of the model, so the line of the marker is the block of the view.
+   for (auto line = 0; line < mDiff->lineCount(); ++line)
+   {
+      const auto text = mDiff->lineText(line);
+
+      if (text.size() > 7 && text.mid(1, 7) == QLatin1String("<<<<<<<") && ++found == conflict)
+      {
+         mDiffView->setTextCursor(QTextCursor(mDiffView->document()->findBlockByNumber(line)));
+         mDiffView->centerCursor();
+         return true;
+      }
+   }
+
    return false;
 }
+
+void FileDiffWidget::setStagingEnabled(bool enabled)
+{
+   mStagingEnabled = enabled;
+   mStageSelection->setVisible(mStagingEnabled && mCurrentSha == CommitInfo::ZERO_SHA);
+}
+
+void FileDiffWidget::expandContext(int hunk)
+{
+   if (!mHunks.isValid())
+      return;
+
+   if (!mFileLinesLoaded)
+   {
+      // Only the last request is kept: the file is read once and the expansion is done when it arrives.
+      const auto loading = mPendingExpansion != NO_EXPANSION;
+      mPendingExpansion = hunk;
+
+      if (!loading)
+         loadFileLines();
+
+      return;
+   }
+
+   if (hunk == EXPAND_ALL)
+      mHunks.expandAll(mFileLines);
+   else
+      mHunks.expandAbove(hunk, EXPAND_LINES, mFileLines);
+
+   setDiffText(mHunks.toString());
+}
+
+void FileDiffWidget::loadFileLines()
+{
+   if (mCurrentSha == CommitInfo::ZERO_SHA)
+   {
+      QFile file(QString("%1/%2").arg(mGit->getWorkingDir(), mDestFile));
+
+      if (file.open(QIODevice::ReadOnly))
+         onFileLinesLoaded(file.readAll());
+      else
+         mPendingExpansion = NO_EXPANSION;
+   }
+   else
+   {
+      mBlobRequest = mBlobReader->read(QString("%1:%2").arg(mCurrentSha, mDestFile));
+   }
+}
+
+void FileDiffWidget::onFileLinesLoaded(const QByteArray &contents)
+{
+   mFileLines = QString::fromUtf8(contents).split('\n');
+
+   // The last line break doesn't start a new line.
+   if (!mFileLines.isEmpty() && mFileLines.constLast().isEmpty())
+      mFileLines.removeLast();
+
+   mFileLinesLoaded = true;
+
+   const auto hunk = mPendingExpansion;
+   mPendingExpansion = NO_EXPANSION;
+
+   if (hunk != NO_EXPANSION)
+      expandContext(hunk);
+}
+
+void FileDiffWidget::stageSelection()
+{
+   if (!mHunks.isValid() || mCurrentSha != CommitInfo::ZERO_SHA)
+      return;
+
+   // The view shows the text of the hunks, so its blocks are their lines.
+   const auto cursor = mDiffView->textCursor();
+   const auto document = mDiffView->document();
+   auto firstLine = document->findBlock(cursor.selectionStart()).blockNumber();
+   auto lastLine = document->findBlock(cursor.selectionEnd()).blockNumber();
+
+   // Without a selection the header of the hunk selects all of it.
+   if (!cursor.hasSelection())
+   {
+      while (firstLine > 0 && mHunks.hunkAt(firstLine) == -1)
+         --firstLine;
+
+      lastLine = firstLine;
+   }
+
+   const auto patch = mHunks.patch(mDestFile, firstLine, lastLine);
+
+   if (patch.isEmpty())
+      return;
+
+   QScopedPointer<GitLocal> git(new GitLocal(mGit));
+   const auto ret = git->stagePatch(patch.toUtf8());
+
+   if (ret.success)
+      emit signalUpdateWipPaths({ mDestFile });
+   else
+   {
+      QMessageBox::warning(this, tr("Stage selection"),
+                           tr("The changes selected couldn't be staged:\n%1").arg(ret.output.toString()));
+   }
+}
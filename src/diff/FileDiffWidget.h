@@ -23,7 +23,11 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <DiffCache.h>
+#include <DiffHunks.h>
+
 #include <QFrame>
+#include <QPointer>
 
 class FileDiffHighlighter;
 class FileDiffView;
@@ -31,6 +35,16 @@ class QPushButton;
 class GitBase;
 class DiffInfoPanel;
 class RevisionsCache;
+class DiffFindBar;
+class DiffTextView;
+class GitRequestorProcess;
+class HibernatedDiff;
+class ImageDiffPreview;
+class QScrollBar;
+class GitBlobReader;
+class DiffSideBySideView;
+class DiffModel;
+class QLabel;
 
 /*!
  \brief The FileDiffWidget creates the layout that contains all the widgets related with the creation of the diff of a
@@ -42,6 +56,15 @@ class FileDiffWidget : public QFrame
 {
    Q_OBJECT
 
+signals:
+   /*!
+    \brief Signal triggered when some changes of the file are staged, so only its entries of the work in progress are
+    updated.
+
+    \param paths The file.
+   */
+   void signalUpdateWipPaths(const QStringList &paths);
+
 public:
    /*!
     \brief Default constructor.
@@ -51,6 +74,10 @@ public:
    */
    explicit FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                            QWidget *parent = nullptr);
+   /*!
+    \brief Destructor. It cancels the diff that is being loaded.
+   */
+   ~FileDiffWidget() override;
 
    /*!
     \brief Clears the current information on the diff view.
@@ -63,12 +90,40 @@ public:
    */
    bool reload();
    /*!
-    \brief Configures the diff view with the two commits that will be compared and the file that will be applied.
+    \brief Returns an approximation of the memory used by the diff shown, in bytes.
+   */
+   qint64 memoryUsage() const;
+   /*!
+    \brief Frees the diff shown while the view is not seen. The view keeps the commits and the file, so the diff is
+    loaded again with \ref restore. A diff that is being loaded is not freed.
+
+    \return True if the diff was freed, otherwise false.
+   */
+   bool compact();
+   /*!
+    \brief Tells if the diff was freed with \ref compact and has to be loaded again before it's seen.
+   */
+   bool isCompacted() const { return mCompacted; }
+   /*!
+    \brief Loads again the diff freed with \ref compact.
+   */
+   void restore();
+   /*!
+    \brief Frees the diff like \ref compact but keeps a compressed copy of its text and the position of the scroll.
+    \ref restore shows it again from the copy, without Git. The diffs of the work in progress and the large diffs don't
+    keep a copy: they are loaded again.
+
+    \return True if the diff was freed, otherwise false.
+   */
+   bool hibernate();
+   /*!
+    \brief Configures the diff view with the two commits that will be compared and the file that will be applied. The
+    diff is loaded asynchronously: the view shows the previous contents and the progress until it's available.
 
     \param currentSha The base SHA.
     \param previousSha The SHA to compare to.
     \param file The file that will show the diff.
-    \return bool Returns true if the configuration was applied, otherwise false.
+    \return bool Returns true if the file changed and the diff is being loaded, otherwise false.
    */
    bool configure(const QString &currentSha, const QString &previousSha, const QString &file);
    /*!
@@ -83,8 +138,28 @@ public:
     \return QString The SHA that the diff is compared to.
    */
    QString getPreviousSha() const { return mPreviousSha; }
+   /*!
+    \brief Moves the view to a conflict of the file: the line of the diff that adds its <<<<<<< marker.
+
+    \param conflict The index of the conflict in the file.
+    \return True if the diff shown has the conflict, otherwise false.
+   */
+   bool goToConflict(int conflict);
+   /*!
+    \brief Allows to stage the lines of the diff of the work in progress. It's disabled by default.
+
+    \param enabled True to show the button that stages the selection.
+   */
+   void setStagingEnabled(bool enabled);
 
 private:
+   /*!
+    \brief The number of context lines that a double click on the header of a hunk adds above it.
+   */
+   static constexpr int EXPAND_LINES = 20;
+   static constexpr int EXPAND_ALL = -1;
+   static constexpr int NO_EXPANSION = -2;
+
    QString mCurrentFile;
    QString mCurrentSha;
    QString mPreviousSha;
@@ -95,7 +170,89 @@ private:
    QPushButton *mGoPrevious = nullptr;
    QPushButton *mGoNext = nullptr;
    DiffInfoPanel *mDiffInfoPanel = nullptr;
+   DiffFindBar *mFindBar = nullptr;
+   DiffTextView *mLargeDiffView = nullptr;
+   QFrame *mLoadingPanel = nullptr;
+   QLabel *mLoadingLabel = nullptr;
+   QPushButton *mCancelLoading = nullptr;
+   QPushButton *mExpandAll = nullptr;
+   QPushButton *mSideBySide = nullptr;
+   QPushButton *mStageSelection = nullptr;
+   DiffSideBySideView *mSideBySideView = nullptr;
+   QSharedPointer<GitBlobReader> mBlobReader;
+   QPointer<GitRequestorProcess> mDiffProcess;
+   QByteArray mDiffBuffer;
+   HibernatedDiff *mHibernated = nullptr;
+   ImageDiffPreview *mImagePreview = nullptr;
+   DiffCache::Key mDiffKey;
+   QString mDestFile;
+   DiffHunks mHunks;
+   QSharedPointer<const DiffModel> mDiff;
+   quint64 mShownHash = 0;
+   bool mHasShownDiff = false;
+   bool mCompacted = false;
+   bool mStagingEnabled = false;
+   int mBlobRequest = 0;
+   QStringList mFileLines;
+   bool mFileLinesLoaded = false;
+   int mPendingExpansion = NO_EXPANSION;
    QVector<int> mModifications;
    int mRowIndex = 0;
    int mDestRow = 0;
+
+   /*!
+    \brief Returns the vertical scroll bar of the view shown: the unified view or the side by side view.
+   */
+   QScrollBar *shownScrollBar() const;
+   /*!
+    \brief Cancels the diff that is being loaded, if any.
+   */
+   void cancelLoading();
+   /*!
+    \brief Stores the diff once it's completely loaded and shows it.
+   */
+   void onDiffLoaded();
+   /*!
+    \brief Shows the output of Git for the diff of the file, without its header.
+
+    \param text The output of git diff.
+   */
+   void showDiff(const QString &text);
+   /*!
+    \brief Sets the text of the diff view, parsed once for the highlighter and the find bar.
+
+    \param text The hunks of the diff.
+   */
+   void setDiffText(const QString &text);
+   /*!
+    \brief Shows the diff in the unified view or in the side by side view, as the user chose.
+   */
+   void showTextView();
+   /*!
+    \brief Expands the context of the diff with the lines of the file. The file is read when it's needed for the first
+    time: from the working directory for the work in progress, or else from the repository through a GitBlobReader.
+
+    \param hunk The hunk to expand above, or EXPAND_ALL to show the whole file.
+   */
+   void expandContext(int hunk);
+   /*!
+    \brief Reads the new version of the file.
+   */
+   void loadFileLines();
+   /*!
+    \brief Splits the contents of the file in lines and does the expansion that was waiting for them.
+
+    \param contents The contents of the file.
+   */
+   void onFileLinesLoaded(const QByteArray &contents);
+   /*!
+    \brief Shows the loaded diff in a DiffTextView when it's too big for the text editor.
+   */
+   void showLargeDiff();
+   /*!
+    \brief Stages the changes of the lines selected in the unified view, or the hunk of the cursor if there is no
+    selection. The patch is built from the hunks shown and applied to the index without reloading the whole work in
+    progress.
+   */
+   void stageSelection();
 };
@@ -3,74 +3,39 @@
 #include <CommitInfo.h>
 #include <GitHistory.h>
 #include <DiffInfoPanel.h>
+#include <DiffFindBar.h>
+#include <DiffCache.h>
+#include <DiffTextView.h>
+#include <DiffModel.h>
+#include <FileDiffHighlighter.h>
+#include <TraceRecorder.h>
+#include <GitBase.h>
 #include <RevisionsCache.h>
-#include <GitQlientStyles.h>
+#include <HibernatedDiff.h>
 
+#include <QComboBox>
+#include <QMouseEvent>
 #include <QScrollBar>
-#include <QTextCharFormat>
 #include <QTextCodec>
 #include <QVBoxLayout>
 
-FullDiffWidget::DiffHighlighter::DiffHighlighter(QTextEdit *p)
-   : QSyntaxHighlighter(p)
-{
-}
-
-void FullDiffWidget::DiffHighlighter::highlightBlock(const QString &text)
-{
-   // state is used to count paragraphs, starting from 0
-   setCurrentBlockState(previousBlockState() + 1);
-   if (text.isEmpty())
-      return;
-
-   QTextCharFormat myFormat;
-   const char firstChar = text.at(0).toLatin1();
-   switch (firstChar)
-   {
-      case '@':
-         myFormat.setForeground(GitQlientStyles::getOrange());
-         myFormat.setFontWeight(QFont::ExtraBold);
-         break;
-      case '+':
-         myFormat.setForeground(GitQlientStyles::getGreen());
-         break;
-      case '-':
-         myFormat.setForeground(GitQlientStyles::getRed());
-         break;
-      case 'c':
-      case 'd':
-      case 'i':
-      case 'n':
-      case 'o':
-      case 'r':
-      case 's':
-         if (text.startsWith("diff --git a/"))
-         {
-            myFormat.setForeground(GitQlientStyles::getBlue());
-            myFormat.setFontWeight(QFont::ExtraBold);
-         }
-         else if (text.startsWith("copy ") || text.startsWith("index ") || text.startsWith("new ")
-                  || text.startsWith("old ") || text.startsWith("rename ") || text.startsWith("similarity "))
-            myFormat.setForeground(GitQlientStyles::getBlue());
-         break;
-      default:
-         break;
-   }
-   if (myFormat.isValid())
-      setFormat(0, text.length(), myFormat);
-}
+#include <algorithm>
 
 FullDiffWidget::FullDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                                QWidget *parent)
    : QTextEdit(parent)
    , mGit(git)
    , mCache(cache)
+   , mHibernated(new HibernatedDiff(cache.data(), this))
    , mDiffInfoPanel(new DiffInfoPanel(cache))
+   , mMergeDiffMode(new QComboBox())
    , mDiffWidget(new QTextEdit())
+   , mFindBar(new DiffFindBar(mDiffWidget))
+   , mLargeDiffView(new DiffTextView())
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
-   diffHighlighter = new DiffHighlighter(this);
+   mDiffHighlighter = new FileDiffHighlighter(mDiffWidget);
 
    QFont font;
    font.setFamily(QString::fromUtf8("Ubuntu Mono"));
@@ -85,42 +50,416 @@ FullDiffWidget::FullDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointe
    layout->setContentsMargins(QMargins());
    layout->setSpacing(10);
    layout->addWidget(mDiffInfoPanel);
+   layout->addWidget(mMergeDiffMode);
+   layout->addWidget(mFindBar);
    layout->addWidget(mDiffWidget);
+   layout->addWidget(mLargeDiffView);
+
+   mLargeDiffView->setVisible(false);
+
+   // The combined diff of a merge is the default: it only has what the merge itself changed, so it's much cheaper
+   // than the diff with the first parent, that has all the changes merged.
+   mMergeDiffMode->addItem(tr("Combined diff with all the parents"));
+   mMergeDiffMode->addItem(tr("Diff with the first parent"));
+   mMergeDiffMode->setVisible(false);
+
+   connect(mMergeDiffMode, qOverload<int>(&QComboBox::currentIndexChanged), this,
+           [this]() { loadDiff(mCurrentSha, mPreviousSha); });
+
+   mDiffWidget->viewport()->installEventFilter(this);
+
+   // The copy has the main diff and then the patch of every collapsed file, empty if the user didn't open it.
+   connect(mHibernated, &HibernatedDiff::signalRestored, this, [this](const QStringList &texts, int scrollPosition) {
+      if (!mCompacted)
+         return;
+
+      if (texts.count() != mCollapsedFiles.count() + 1)
+      {
+         loadDiff(mCurrentSha, mPreviousSha);
+         return;
+      }
+
+      mMainDiff = texts.constFirst();
+
+      for (auto i = 0; i < mCollapsedFiles.count(); ++i)
+         mCollapsedFiles[i].patch = texts.at(i + 1);
+
+      mCompacted = false;
+      processData(composeDiff());
+
+      const auto view = mLargeDiffView->isHidden() ? static_cast<QAbstractScrollArea *>(mDiffWidget) : mLargeDiffView;
+      view->verticalScrollBar()->setValue(scrollPosition);
+   });
 }
 
 void FullDiffWidget::reload()
 {
-   if (mCurrentSha != CommitInfo::ZERO_SHA)
+   if (mCurrentSha == CommitInfo::ZERO_SHA)
+      loadDiff(mCurrentSha, mPreviousSha);
+}
+
+qint64 FullDiffWidget::memoryUsage() const
+{
+   // The text of the diff is in the model and in the document of the view.
+   auto bytes = static_cast<qint64>(mMainDiff.size()) * static_cast<qint64>(sizeof(QChar))
+       + mLargeDiffView->memoryUsage() + mHibernated->memoryUsage();
+
+   if (mDiff)
+      bytes += mDiff->text().size() * static_cast<qint64>(sizeof(QChar)) * 2;
+
+   for (const auto &file : mCollapsedFiles)
+      bytes += file.patch.size() * static_cast<qint64>(sizeof(QChar));
+
+   return bytes;
+}
+
+bool FullDiffWidget::compact()
+{
+   if (mCompacted)
+      return false;
+
+   mDiff.clear();
+   mDiffHash = 0;
+   mHasDiff = false;
+   mMainDiff.clear();
+
+   // The files that the user opened stay opened when the diff is loaded again.
+   for (auto &file : mCollapsedFiles)
+      file.patch.clear();
+
+   mDiffHighlighter->setDiff(mDiff);
+   mFindBar->setDiff(mDiff);
+   mDiffWidget->clear();
+   mLargeDiffView->clear();
+   mCompacted = true;
+
+   return true;
+}
+
+bool FullDiffWidget::hibernate()
+{
+   if (mCompacted)
+      return false;
+
+   if (mHasDiff && mCurrentSha != CommitInfo::ZERO_SHA)
+   {
+      QStringList texts { mMainDiff };
+
+      for (const auto &file : qAsConst(mCollapsedFiles))
+         texts.append(file.patch);
+
+      const auto view = mLargeDiffView->isHidden() ? static_cast<QAbstractScrollArea *>(mDiffWidget) : mLargeDiffView;
+      mHibernated->store(texts, view->verticalScrollBar()->value());
+   }
+
+   return compact();
+}
+
+void FullDiffWidget::restore()
+{
+   if (mCompacted && !mHibernated->restore())
       loadDiff(mCurrentSha, mPreviousSha);
 }
 
 void FullDiffWidget::processData(const QString &fileChunk)
 {
-   if (mPreviousDiffText != fileChunk)
+   TraceSpan span("diff", "FullDiffWidget::processData");
+
+   // A reload that doesn't change the diff only costs its hash.
+   const auto hash = DiffModel::hashOf(fileChunk.midRef(0));
+
+   if (mHasDiff && hash == mDiffHash)
+      return;
+
+   mHasDiff = true;
+   mDiffHash = hash;
+
+   if (fileChunk.size() >= DiffTextView::MIN_DIFF_SIZE)
    {
-      mPreviousDiffText = fileChunk;
+      mDiff.clear();
+      mDiffWidget->clear();
+      mDiffWidget->setVisible(false);
+      mFindBar->setDiff(mDiff);
+      mFindBar->setVisible(false);
+
+      mLargeDiffView->setDiff(fileChunk.toUtf8());
+      mLargeDiffView->setVisible(true);
+
+      return;
+   }
+
+   mLargeDiffView->clear();
+   mLargeDiffView->setVisible(false);
+   mDiffWidget->setVisible(true);
 
-      const auto pos = mDiffWidget->verticalScrollBar()->value();
+   const QSharedPointer<const DiffModel> diff(new DiffModel(fileChunk));
+   const auto pos = mDiffWidget->verticalScrollBar()->value();
 
-      mDiffWidget->setUpdatesEnabled(false);
+   mDiffWidget->setUpdatesEnabled(false);
+
+   if (mDiff)
+      replaceChangedSections(*diff);
+   else
+   {
       mDiffWidget->clear();
-      mDiffWidget->setPlainText(fileChunk);
+      mDiffWidget->setPlainText(diff->text());
       mDiffWidget->moveCursor(QTextCursor::Start);
-      mDiffWidget->verticalScrollBar()->setValue(pos);
-      mDiffWidget->setUpdatesEnabled(true);
    }
+
+   mDiffHighlighter->setDiff(diff);
+   mDiffWidget->verticalScrollBar()->setValue(pos);
+   mDiffWidget->setUpdatesEnabled(true);
+
+   mDiff = diff;
+   mFindBar->setDiff(diff);
+}
+
+void FullDiffWidget::replaceChangedSections(const DiffModel &diff)
+{
+   const auto &oldSections = mDiff->sections();
+   const auto &newSections = diff.sections();
+   const auto common = std::min(oldSections.count(), newSections.count());
+
+   // The sections with the same hash at the beginning and at the end are kept: only the text between them changed.
+   auto prefix = 0;
+
+   while (prefix < common && oldSections.at(prefix).hash == newSections.at(prefix).hash)
+      ++prefix;
+
+   auto suffix = 0;
+
+   while (suffix < common - prefix
+          && oldSections.at(oldSections.count() - 1 - suffix).hash
+              == newSections.at(newSections.count() - 1 - suffix).hash)
+      ++suffix;
+
+   const auto offsetOf = [](const DiffModel &model, int section) {
+      return section < model.sections().count() ? model.sections().at(section).offset : model.text().size();
+   };
+
+   const auto oldStart = offsetOf(*mDiff, prefix);
+   const auto oldEnd = offsetOf(*mDiff, oldSections.count() - suffix);
+   const auto newStart = offsetOf(diff, prefix);
+   const auto newEnd = offsetOf(diff, newSections.count() - suffix);
+
+   QTextCursor cursor(mDiffWidget->document());
+   cursor.setPosition(oldStart);
+   cursor.setPosition(oldEnd, QTextCursor::KeepAnchor);
+   cursor.insertText(diff.text().mid(newStart, newEnd - newStart));
 }
 
 void FullDiffWidget::loadDiff(const QString &sha, const QString &diffToSha)
 {
+   TraceSpan span("diff", "FullDiffWidget::loadDiff");
+
+   const auto sameDiff = sha == mCurrentSha && diffToSha == mPreviousSha;
+
    mCurrentSha = sha;
    mPreviousSha = diffToSha;
+   mCompacted = false;
+   mHibernated->clear();
 
    mDiffInfoPanel->configure(mCurrentSha, mPreviousSha);
+   mMergeDiffMode->setVisible(isMergeWithFirstParent());
+
+   // The stats of a merge are the ones with the first parent, so the files of a combined diff are never collapsed: it
+   // only has the few files that the merge changed.
+   const auto mergeDiff = isCombinedDiff() ? GitHistory::MergeDiff::Combined : GitHistory::MergeDiff::FirstParent;
+   auto collapsedFiles
+       = mergeDiff == GitHistory::MergeDiff::Combined ? QVector<CollapsedFile>() : findCollapsedFiles();
+
+   // A reload keeps loaded the files that the user already opened.
+   if (sameDiff)
+   {
+      for (auto &file : collapsedFiles)
+      {
+         const auto previous = std::find_if(mCollapsedFiles.cbegin(), mCollapsedFiles.cend(),
+                                            [&file](const CollapsedFile &other) { return other.path == file.path; });
+
+         if (previous != mCollapsedFiles.cend() && previous->loaded)
+         {
+            file.loaded = true;
+            file.patch = loadFilePatch(file.path);
+         }
+      }
+   }
+
+   QStringList excludedFiles;
+
+   for (const auto &file : qAsConst(collapsedFiles))
+      excludedFiles.append(file.path);
+
+   auto options = excludedFiles.isEmpty() ? QString("diff-tree") : QString("diff-tree-collapsed");
+
+   if (mergeDiff == GitHistory::MergeDiff::Combined)
+      options = "diff-tree-cc";
+
+   const auto command = [this, excludedFiles, mergeDiff]() {
+      QScopedPointer<GitHistory> git(new GitHistory(mGit));
+      return git->getCommitDiff(mCurrentSha, mPreviousSha, excludedFiles, mergeDiff);
+   };
+
+   if (cachedDiff(options, QString(), command, mMainDiff))
+   {
+      mCollapsedFiles = collapsedFiles;
+      processData(composeDiff());
+   }
+}
+
+bool FullDiffWidget::eventFilter(QObject *watched, QEvent *event)
+{
+   if (watched == mDiffWidget->viewport() && event->type() == QEvent::MouseButtonDblClick && mDiff)
+   {
+      const auto position = mDiffWidget->cursorForPosition(static_cast<QMouseEvent *>(event)->pos()).position();
+      const auto fileIndex = mDiff->fileOf(position);
+
+      if (fileIndex >= 0)
+      {
+         const auto header = mDiff->lineText(mDiff->files().at(fileIndex).firstLine).toString();
+         const auto file
+             = std::find_if(mCollapsedFiles.begin(), mCollapsedFiles.end(), [&header](const CollapsedFile &collapsed) {
+                  return header == QString("diff --git a/%1 b/%1").arg(collapsed.path);
+               });
+
+         if (file != mCollapsedFiles.end() && !file->loaded)
+         {
+            file->patch = loadFilePatch(file->path);
+            file->loaded = true;
+
+            processData(composeDiff());
+
+            return true;
+         }
+      }
+   }
+
+   return QTextEdit::eventFilter(watched, event);
+}
+
+bool FullDiffWidget::isMergeWithFirstParent() const
+{
+   if (mCurrentSha == CommitInfo::ZERO_SHA)
+      return false;
+
+   const auto commit = mCache->getCommitInfo(mCurrentSha);
+
+   return commit.parentsCount() > 1 && commit.parent(0) == mPreviousSha;
+}
+
+bool FullDiffWidget::isCombinedDiff() const
+{
+   return mMergeDiffMode->currentIndex() == 0 && isMergeWithFirstParent();
+}
+
+QVector<FullDiffWidget::CollapsedFile> FullDiffWidget::findCollapsedFiles() const
+{
+   QVector<CollapsedFile> collapsedFiles;
+   QString numstat;
+
+   const auto command = [this]() {
+      QScopedPointer<GitHistory> git(new GitHistory(mGit));
+      return git->getCommitDiffStats(mCurrentSha, mPreviousSha);
+   };
+
+   if (!cachedDiff("numstat", QString(), command, numstat))
+      return collapsedFiles;
+
+   const auto stats = DiffFileClassifier::parseNumstat(numstat);
+   QStringList files;
+
+   for (const auto &file : stats)
+      files.append(file.path);
 
    QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   const auto ret = git->getCommitDiff(mCurrentSha, mPreviousSha);
+   const auto generatedFiles = git->getGeneratedFiles(files);
+
+   for (const auto &file : stats)
+   {
+      const auto reason = DiffFileClassifier::classify(file, generatedFiles.contains(file.path));
+
+      if (reason != DiffFileClassifier::Reason::None)
+      {
+         CollapsedFile collapsed;
+         collapsed.path = file.path;
+         collapsed.reason = reason;
+         collapsed.changedLines = file.additions + file.deletions;
+         collapsedFiles.append(collapsed);
+      }
+   }
+
+   return collapsedFiles;
+}
+
+QString FullDiffWidget::composeDiff() const
+{
+   auto text = mMainDiff;
+
+   for (const auto &file : mCollapsedFiles)
+   {
+      if (!text.isEmpty() && !text.endsWith('\n'))
+         text.append('\n');
+
+      if (file.loaded)
+      {
+         text.append(file.patch);
+         continue;
+      }
+
+      text.append(QString("diff --git a/%1 b/%1\n").arg(file.path));
+
+      switch (file.reason)
+      {
+         case DiffFileClassifier::Reason::Binary:
+            text.append(tr("    Binary file collapsed. Double click to load it.\n"));
+            break;
+         case DiffFileClassifier::Reason::Generated:
+            text.append(tr("    Generated file collapsed (%1 lines changed). Double click to load it.\n")
+                            .arg(file.changedLines));
+            break;
+         default:
+            text.append(tr("    Large file collapsed (%1 lines changed). Double click to load it.\n")
+                            .arg(file.changedLines));
+            break;
+      }
+   }
+
+   return text;
+}
+
+QString FullDiffWidget::loadFilePatch(const QString &file) const
+{
+   QString patch;
+
+   const auto command = [this, file]() {
+      QScopedPointer<GitHistory> git(new GitHistory(mGit));
+      return git->getCommitFileDiff(mCurrentSha, mPreviousSha, file);
+   };
+
+   if (!cachedDiff("diff-tree-file", file, command, patch))
+      return QString();
+
+   // The diff-tree of a single commit starts with its SHA.
+   const auto start = patch.startsWith("diff ") ? 0 : patch.indexOf("\ndiff ");
+
+   return start < 0 ? QString() : patch.mid(start == 0 ? 0 : start + 1);
+}
+
+bool FullDiffWidget::cachedDiff(const QString &options, const QString &file,
+                                const std::function<GitExecResult()> &command, QString &text) const
+{
+   const DiffCache::Key key { mGit->getRepositoryId(), mCurrentSha, mPreviousSha, file, options };
+
+   if (DiffCache::find(key, text))
+      return true;
+
+   const auto ret = command();
 
    if (ret.success)
-      processData(ret.output.toString());
+   {
+      // The stats are in the -z format: the bytes are decoded as they are, the conversion to string stops at a NUL.
+      text = QString::fromUtf8(ret.output.toByteArray());
+      DiffCache::insert(key, text);
+   }
+
+   return ret.success;
 }
@@ -23,12 +23,23 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QSyntaxHighlighter>
+#include <DiffFileClassifier.h>
+#include <GitExecResult.h>
+
 #include <QTextEdit>
+#include <QVector>
+
+#include <functional>
 
 class GitBase;
+class QComboBox;
 class DiffInfoPanel;
 class RevisionsCache;
+class DiffFindBar;
+class DiffTextView;
+class FileDiffHighlighter;
+class DiffModel;
+class HibernatedDiff;
 
 /*!
  \brief The FullDiffWidget class is an overload class inherited from QTextEdit that process the output from a diff for a
@@ -55,6 +66,33 @@ public:
 
    */
    void reload();
+   /*!
+    \brief Returns an approximation of the memory used by the diff shown, in bytes.
+   */
+   qint64 memoryUsage() const;
+   /*!
+    \brief Frees the diff shown while the view is not seen. The view keeps the commits, so the diff is loaded again
+    with \ref restore.
+
+    \return True if the diff was freed, otherwise false.
+   */
+   bool compact();
+   /*!
+    \brief Tells if the diff was freed with \ref compact and has to be loaded again before it's seen.
+   */
+   bool isCompacted() const { return mCompacted; }
+   /*!
+    \brief Loads again the diff freed with \ref compact.
+   */
+   void restore();
+   /*!
+    \brief Frees the diff like \ref compact but keeps a compressed copy of its text, with the files that the user
+    opened, and the position of the scroll. \ref restore shows it again from the copy, without Git. The diff of the
+    work in progress doesn't keep a copy: it's loaded again.
+
+    \return True if the diff was freed, otherwise false.
+   */
+   bool hibernate();
    /*!
     \brief Loads a diff for a specific commit SHA respect another commit SHA.
 
@@ -63,28 +101,96 @@ public:
    */
    void loadDiff(const QString &sha, const QString &diffToSha);
 
+protected:
+   /*!
+    \brief Loads the collapsed file placeholder that the user double clicks.
+   */
+   bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
+   /*!
+    \brief A file of the diff that is not loaded with the rest: only a placeholder is shown until the user asks for it.
+   */
+   struct CollapsedFile
+   {
+      QString path;
+      DiffFileClassifier::Reason reason = DiffFileClassifier::Reason::None;
+      int changedLines = 0;
+      bool loaded = false;
+      QString patch;
+   };
+
+
    QSharedPointer<GitBase> mGit;
    QSharedPointer<RevisionsCache> mCache;
    QString mCurrentSha;
    QString mPreviousSha;
-   QString mPreviousDiffText;
+   QString mMainDiff;
+   QVector<CollapsedFile> mCollapsedFiles;
+   QSharedPointer<const DiffModel> mDiff;
+   quint64 mDiffHash = 0;
+   bool mHasDiff = false;
+   bool mCompacted = false;
+   HibernatedDiff *mHibernated = nullptr;
    DiffInfoPanel *mDiffInfoPanel = nullptr;
+   QComboBox *mMergeDiffMode = nullptr;
    QTextEdit *mDiffWidget = nullptr;
+   DiffFindBar *mFindBar = nullptr;
+   DiffTextView *mLargeDiffView = nullptr;
 
-   class DiffHighlighter : public QSyntaxHighlighter
-   {
-   public:
-      DiffHighlighter(QTextEdit *p);
-      void highlightBlock(const QString &text) override;
-   };
-
-   DiffHighlighter *diffHighlighter = nullptr;
+   FileDiffHighlighter *mDiffHighlighter = nullptr;
 
    /*!
-    \brief Method that processes the data from the Git diff command.
+    \brief Method that processes the data from the Git diff command. The diffs bigger than
+    \ref DiffTextView::MIN_DIFF_SIZE are shown in a DiffTextView instead of the text editor.
 
     \param fileChunk The file chuck to compare.
    */
    void processData(const QString &fileChunk);
+   /*!
+    \brief Replaces in the editor only the sections (file headers and hunks) of the shown diff that are different in
+    the new one, comparing their hashes.
+
+    \param diff The new diff.
+   */
+   void replaceChangedSections(const DiffModel &diff);
+   /*!
+    \brief Tells if the diff is the one of a merge commit with its first parent, the only one that can be combined.
+   */
+   bool isMergeWithFirstParent() const;
+   /*!
+    \brief Tells if the diff is shown as the combined diff of a merge, as chosen by the user.
+   */
+   bool isCombinedDiff() const;
+   /*!
+    \brief Finds the files of the diff that are collapsed, from the stats of the diff and the Git attributes.
+
+    \return The collapsed files.
+   */
+   QVector<CollapsedFile> findCollapsedFiles() const;
+   /*!
+    \brief Builds the text shown in the editor: the diff without the collapsed files, followed by the patch of every
+    collapsed file that has been loaded or a placeholder for the rest.
+
+    \return The text of the diff.
+   */
+   QString composeDiff() const;
+   /*!
+    \brief Gets the patch of a single file of the current diff.
+
+    \param file The file.
+    \return The patch, starting at its "diff --git" line.
+   */
+   QString loadFilePatch(const QString &file) const;
+   /*!
+    \brief Runs a diff command of the current diff, looking for its output in the DiffCache first.
+
+    \param options The name of the command in the cache key.
+    \param file The file of the diff, if any.
+    \param command The command to run if the diff is not in the cache.
+    \param text The output of the command.
+    \return True if the output is available.
+   */
+   bool cachedDiff(const QString &options, const QString &file, const std::function<GitExecResult()> &command,
+                   QString &text) const;
 };
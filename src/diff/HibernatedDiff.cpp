@@ -0,0 +1,79 @@
+#include "HibernatedDiff.h"
+
+#include <WorkerPool.h>
+
+HibernatedDiff::HibernatedDiff(const void *repository, QObject *parent)
+   : QObject(parent)
+   , mRepository(repository)
+{
+}
+
+HibernatedDiff::~HibernatedDiff()
+{
+   mWorker.reset();
+}
+
+void HibernatedDiff::store(const QStringList &texts, int scrollPosition)
+{
+   clear();
+
+   mTexts.reserve(texts.count());
+
+   for (const auto &text : texts)
+      mTexts.append(qCompress(text.toUtf8(), COMPRESSION_LEVEL));
+
+   mScrollPosition = scrollPosition;
+}
+
+bool HibernatedDiff::restore()
+{
+   if (mTexts.isEmpty())
+      return false;
+
+   // The worker is created the first time: most of the diffs never hibernate.
+   if (!mWorker)
+      mWorker.reset(new WorkerQueue(mRepository, WorkerPool::Priority::Interactive));
+
+   const auto request = ++mRequest;
+   const auto compressed = mTexts;
+   const auto scrollPosition = mScrollPosition;
+
+   mWorker->post([this, request, compressed, scrollPosition]() {
+      QStringList texts;
+      texts.reserve(compressed.count());
+
+      for (const auto &text : compressed)
+         texts.append(QString::fromUtf8(qUncompress(text)));
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, request, texts, scrollPosition]() {
+             if (request != mRequest || mTexts.isEmpty())
+                return;
+
+             mTexts.clear();
+             emit signalRestored(texts, scrollPosition);
+          },
+          Qt::QueuedConnection);
+   });
+
+   return true;
+}
+
+void HibernatedDiff::clear()
+{
+   // A decompression that is running finishes but its result is discarded.
+   ++mRequest;
+   mTexts.clear();
+   mScrollPosition = 0;
+}
+
+qint64 HibernatedDiff::memoryUsage() const
+{
+   qint64 bytes = 0;
+
+   for (const auto &text : mTexts)
+      bytes += text.size();
+
+   return bytes;
+}
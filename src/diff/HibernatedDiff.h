@@ -0,0 +1,104 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QVector>
+
+class WorkerQueue;
+
+/*!
+ \brief The HibernatedDiff class keeps the raw text of a diff that is not seen, compressed, together with the position
+ of its scroll. A diff view that hibernates frees its models and documents and keeps only this copy: restoring it
+ doesn't run Git again and the text is decompressed in a worker so the GUI remains responsive.
+
+ \class HibernatedDiff HibernatedDiff.h "HibernatedDiff.h"
+*/
+class HibernatedDiff : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered in the GUI thread when the texts requested with \ref restore are decompressed. The copy is
+    discarded before the signal is emitted.
+
+    \param texts The texts in the order they were stored.
+    \param scrollPosition The position of the vertical scroll when the texts were stored.
+   */
+   void signalRestored(const QStringList &texts, int scrollPosition);
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param repository The repository the diff belongs to, to run the decompression in its workers.
+    \param parent The parent object.
+   */
+   explicit HibernatedDiff(const void *repository, QObject *parent = nullptr);
+   /*!
+    \brief Destructor. It waits for the decompression running, if any.
+   */
+   ~HibernatedDiff() override;
+
+   /*!
+    \brief Compresses and keeps the texts of a diff, replacing the previous ones.
+
+    \param texts The raw texts of the diff.
+    \param scrollPosition The position of the vertical scroll of the view.
+   */
+   void store(const QStringList &texts, int scrollPosition);
+   /*!
+    \brief Decompresses the texts in a worker. The result arrives through \ref signalRestored.
+
+    \return True if there was a copy to restore, otherwise false.
+   */
+   bool restore();
+   /*!
+    \brief Discards the copy and the decompression requested, if any.
+   */
+   void clear();
+   /*!
+    \brief Tells if there is a copy of the diff, being restored or not.
+   */
+   bool isEmpty() const { return mTexts.isEmpty(); }
+   /*!
+    \brief Returns the memory used by the compressed copy, in bytes.
+   */
+   qint64 memoryUsage() const;
+
+   /*!
+    \brief The level of zlib: the copy is kept rarely and restored once, so the fastest level is enough.
+   */
+   static constexpr int COMPRESSION_LEVEL = 1;
+
+private:
+   const void *mRepository = nullptr;
+   QScopedPointer<WorkerQueue> mWorker;
+   QVector<QByteArray> mTexts;
+   int mScrollPosition = 0;
+   int mRequest = 0;
+};
@@ -0,0 +1,263 @@
+#include "ImageDiffPreview.h"
+
+#include <CommitInfo.h>
+#include <GitBase.h>
+#include <GitBlobReader.h>
+#include <ResourceBudget.h>
+#include <WorkerPool.h>
+
+#include <QBuffer>
+#include <QCache>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QImageReader>
+#include <QLabel>
+#include <QSet>
+
+#include <algorithm>
+
+namespace
+{
+// The thumbnails are only used in the GUI thread: the workers give them back through a queued call.
+QCache<QString, QImage> &thumbnails()
+{
+   static QCache<QString, QImage> cache(ImageDiffPreview::BUDGET_KB);
+   // The cost is measured in KB. The limit can be set from any thread, so it's queued.
+   static const auto budgetId = ResourceBudget::instance().addCache(
+       QString("Image thumbnails"), ImageDiffPreview::BUDGET_KB * qint64(1024),
+       []() { return cache.totalCost() * qint64(1024); },
+       [](qint64 bytes) {
+          QMetaObject::invokeMethod(
+              qApp, [bytes]() { cache.setMaxCost(static_cast<int>(std::max(bytes / 1024, qint64(1)))); },
+              Qt::QueuedConnection);
+       });
+   Q_UNUSED(budgetId)
+
+   return cache;
+}
+}
+
+ImageDiffPreview::ImageDiffPreview(const QSharedPointer<GitBase> &git, const QSharedPointer<RevisionsCache> &cache,
+                                   QWidget *parent)
+   : QFrame(parent)
+   , mGit(git)
+   , mBlobReader(GitBlobReader::instance(git))
+   , mWorker(new WorkerQueue(cache.data(), WorkerPool::Priority::Interactive, true))
+{
+   mOld.label = new QLabel();
+   mOld.label->setToolTip(tr("The previous version of the image"));
+   mNew.label = new QLabel();
+   mNew.label->setToolTip(tr("The new version of the image"));
+
+   const auto layout = new QHBoxLayout(this);
+   layout->setContentsMargins(QMargins());
+   layout->setSpacing(10);
+
+   for (const auto label : { mOld.label, mNew.label })
+   {
+      label->setAlignment(Qt::AlignCenter);
+      label->setMinimumSize(THUMBNAIL_SIZE, THUMBNAIL_SIZE / 2);
+      layout->addWidget(label);
+   }
+
+   layout->addStretch();
+
+   const auto versions = [this]() { return QVector<Version *> { &mOld, &mNew }; };
+
+   connect(mBlobReader.data(), &GitBlobReader::signalObjectInfo, this,
+           [this, versions](int request, const QString &id, const QString &, qint64 size) {
+              for (const auto version : versions())
+              {
+                 if (request != version->infoRequest)
+                    continue;
+
+                 version->infoRequest = 0;
+                 version->key = id;
+
+                 if (const auto image = thumbnails().object(id))
+                    show(*version, *image, QString());
+                 else if (size > MAX_IMAGE_BYTES)
+                    show(*version, QImage(), tr("The image is too big to be shown."));
+                 else
+                    version->readRequest = mBlobReader->read(id);
+              }
+           });
+   connect(mBlobReader.data(), &GitBlobReader::signalBlobRead, this,
+           [this, versions](int request, const QByteArray &contents) {
+              for (const auto version : versions())
+              {
+                 if (request == version->readRequest)
+                 {
+                    version->readRequest = 0;
+                    decode(*version, contents);
+                 }
+              }
+           });
+   connect(mBlobReader.data(), &GitBlobReader::signalBlobMissing, this, [this, versions](int request) {
+      for (const auto version : versions())
+      {
+         if (request == version->infoRequest || request == version->readRequest)
+         {
+            version->infoRequest = 0;
+            version->readRequest = 0;
+            show(*version, QImage(), tr("No image"));
+         }
+      }
+   });
+
+   setVisible(false);
+}
+
+ImageDiffPreview::~ImageDiffPreview()
+{
+   mWorker.reset();
+}
+
+bool ImageDiffPreview::configure(const QString &currentSha, const QString &previousSha, const QString &file)
+{
+   // The answers of the previous file are ignored.
+   ++mEpoch;
+
+   for (const auto version : { &mOld, &mNew })
+   {
+      version->infoRequest = 0;
+      version->readRequest = 0;
+      version->key.clear();
+   }
+
+   if (!isImage(file))
+   {
+      setVisible(false);
+      return false;
+   }
+
+   setVisible(true);
+
+   if (previousSha.isEmpty())
+      show(mOld, QImage(), tr("No image"));
+   else
+      requestBlob(mOld, previousSha, file);
+
+   if (currentSha == CommitInfo::ZERO_SHA)
+      requestWorkTreeFile(file);
+   else
+      requestBlob(mNew, currentSha, file);
+
+   return true;
+}
+
+bool ImageDiffPreview::isImage(const QString &file)
+{
+   static QSet<QString> extensions;
+
+   if (extensions.isEmpty())
+   {
+      for (const auto &format : QImageReader::supportedImageFormats())
+         extensions.insert(QString::fromLatin1(format).toLower());
+   }
+
+   return extensions.contains(QFileInfo(file).suffix().toLower());
+}
+
+void ImageDiffPreview::requestBlob(Version &version, const QString &sha, const QString &file)
+{
+   show(version, QImage(), tr("Loading..."));
+
+   // The information gives the SHA of the blob, the key of its thumbnail, before reading it.
+   version.infoRequest = mBlobReader->readInfo(QString("%1:%2").arg(sha, file));
+}
+
+void ImageDiffPreview::requestWorkTreeFile(const QString &file)
+{
+   const QFileInfo info(QString("%1/%2").arg(mGit->getWorkingDir(), file));
+
+   if (!info.exists())
+   {
+      show(mNew, QImage(), tr("No image"));
+      return;
+   }
+
+   if (info.size() > MAX_IMAGE_BYTES)
+   {
+      show(mNew, QImage(), tr("The image is too big to be shown."));
+      return;
+   }
+
+   // The file of the work tree has no blob: it's identified by its modification.
+   mNew.key = QString("%1\n%2\n%3")
+                  .arg(info.absoluteFilePath(), QString::number(info.lastModified().toMSecsSinceEpoch()),
+                       QString::number(info.size()));
+
+   if (const auto image = thumbnails().object(mNew.key))
+   {
+      show(mNew, *image, QString());
+      return;
+   }
+
+   show(mNew, QImage(), tr("Loading..."));
+   decode(mNew, QByteArray(), info.absoluteFilePath());
+}
+
+void ImageDiffPreview::decode(Version &version, const QByteArray &data, const QString &path)
+{
+   const auto epoch = mEpoch;
+   const auto key = version.key;
+
+   mWorker->post([this, epoch, key, data, path]() {
+      QBuffer buffer;
+      QFile file(path);
+      QIODevice *device = &file;
+
+      if (path.isEmpty())
+      {
+         buffer.setData(data);
+         device = &buffer;
+      }
+
+      QImageReader reader(device);
+      const auto size = reader.size();
+
+      // The formats that support it decode the image already scaled, that is much faster for the big ones.
+      if (size.isValid() && (size.width() > THUMBNAIL_SIZE || size.height() > THUMBNAIL_SIZE))
+         reader.setScaledSize(size.scaled(THUMBNAIL_SIZE, THUMBNAIL_SIZE, Qt::KeepAspectRatio));
+
+      auto image = reader.read();
+
+      if (image.width() > THUMBNAIL_SIZE || image.height() > THUMBNAIL_SIZE)
+         image = image.scaled(THUMBNAIL_SIZE, THUMBNAIL_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+      QMetaObject::invokeMethod(
+          this, [this, epoch, key, image]() { onDecoded(epoch, key, image); }, Qt::QueuedConnection);
+   });
+}
+
+void ImageDiffPreview::onDecoded(int epoch, const QString &key, const QImage &image)
+{
+   // The thumbnail is kept even if the preview changed: the user could go back to it. The cost is measured in KB like
+   // the budget.
+   if (!image.isNull())
+      thumbnails().insert(key, new QImage(image), static_cast<int>(image.sizeInBytes() / 1024) + 1);
+
+   if (epoch != mEpoch)
+      return;
+
+   for (const auto version : { &mOld, &mNew })
+   {
+      if (version->key == key)
+         show(*version, image, tr("The image can't be decoded."));
+   }
+}
+
+void ImageDiffPreview::show(Version &version, const QImage &image, const QString &text)
+{
+   if (image.isNull())
+   {
+      version.label->setPixmap(QPixmap());
+      version.label->setText(text);
+   }
+   else
+      version.label->setPixmap(QPixmap::fromImage(image));
+}
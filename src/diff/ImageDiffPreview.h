@@ -0,0 +1,155 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QFrame>
+#include <QImage>
+#include <QScopedPointer>
+#include <QSharedPointer>
+
+class GitBase;
+class GitBlobReader;
+class QLabel;
+class RevisionsCache;
+class WorkerQueue;
+
+/*!
+ \brief The ImageDiffPreview shows the old and the new version of an image changed by a diff, scaled to thumbnails.
+ The versions in the repository are read through the GitBlobReader, without a process each, and the new version of the
+ work in progress is read from the work tree. The images are decoded and scaled in the WorkerPool, so a large image
+ never blocks the UI.
+
+ The thumbnails are kept in a cache shared by all the previews, with a memory budget and the least recently used out
+ first. The versions in the repository are identified by the SHA of their blob, so the same image shown in many commits
+ is only decoded once.
+
+ \class ImageDiffPreview ImageDiffPreview.h "ImageDiffPreview.h"
+*/
+class ImageDiffPreview : public QFrame
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param git The git object of the repository.
+    \param cache The cache of the repository, that identifies its work in the WorkerPool.
+    \param parent The parent widget if needed.
+   */
+   explicit ImageDiffPreview(const QSharedPointer<GitBase> &git, const QSharedPointer<RevisionsCache> &cache,
+                             QWidget *parent = nullptr);
+   /*!
+    \brief Destructor. It waits for the image being decoded, if any.
+   */
+   ~ImageDiffPreview() override;
+
+   /*!
+    \brief Shows the versions of a file if it's an image, otherwise the preview is hidden.
+
+    \param currentSha The commit, or CommitInfo::ZERO_SHA for the work in progress.
+    \param previousSha The commit to compare to.
+    \param file The file.
+    \return True if the file is an image, otherwise false.
+   */
+   bool configure(const QString &currentSha, const QString &previousSha, const QString &file);
+   /*!
+    \brief Tells if a file is an image that Qt can decode, from its extension.
+
+    \param file The file.
+    \return True if it's an image, otherwise false.
+   */
+   static bool isImage(const QString &file);
+
+   /*!
+    \brief The maximum width and height of the thumbnails.
+   */
+   static constexpr int THUMBNAIL_SIZE = 256;
+   /*!
+    \brief The memory budget of the cache of thumbnails.
+   */
+   static constexpr int BUDGET_KB = 32 * 1024;
+   /*!
+    \brief The images bigger than this are not read.
+   */
+   static constexpr qint64 MAX_IMAGE_BYTES = 64 * 1024 * 1024;
+
+private:
+   /*!
+    \brief One of the two versions of the image.
+   */
+   struct Version
+   {
+      QLabel *label = nullptr;
+      int infoRequest = 0;
+      int readRequest = 0;
+      QString key;
+   };
+
+   QSharedPointer<GitBase> mGit;
+   QSharedPointer<GitBlobReader> mBlobReader;
+   QScopedPointer<WorkerQueue> mWorker;
+   Version mOld;
+   Version mNew;
+   int mEpoch = 0;
+
+   /*!
+    \brief Asks the blob of a version of the file in a commit.
+
+    \param version The version.
+    \param sha The commit.
+    \param file The file.
+   */
+   void requestBlob(Version &version, const QString &sha, const QString &file);
+   /*!
+    \brief Reads the new version of the file from the work tree.
+
+    \param file The file.
+   */
+   void requestWorkTreeFile(const QString &file);
+   /*!
+    \brief Decodes and scales an image in a worker. The data is only read there if it's not given.
+
+    \param version The version.
+    \param data The contents of the image, or empty to read them from \p path.
+    \param path The file of the work tree.
+   */
+   void decode(Version &version, const QByteArray &data, const QString &path = QString());
+   /*!
+    \brief Stores a decoded thumbnail and shows it, unless the preview changed after it was requested.
+
+    \param epoch The value of the epoch when the image was requested.
+    \param key The key of the thumbnail in the cache.
+    \param image The thumbnail, null if the image couldn't be decoded.
+   */
+   void onDecoded(int epoch, const QString &key, const QImage &image);
+   /*!
+    \brief Shows a thumbnail, or a text if it's null.
+
+    \param version The version.
+    \param image The thumbnail.
+    \param text The text shown when there is no thumbnail.
+   */
+   void show(Version &version, const QImage &image, const QString &text);
+};
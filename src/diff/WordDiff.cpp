@@ -0,0 +1,303 @@
+#include "WordDiff.h"
+
+#include <DiffModel.h>
+
+#include <QHash>
+#include <QRunnable>
+
+#include <algorithm>
+
+namespace
+{
+class CompareTask : public QRunnable
+{
+public:
+   explicit CompareTask(std::function<void()> task)
+      : mTask(std::move(task))
+   {
+   }
+
+   void run() override { mTask(); }
+
+private:
+   std::function<void()> mTask;
+};
+
+struct Token
+{
+   int start = 0;
+   int length = 0;
+   uint hash = 0;
+};
+
+QVector<Token> tokenize(const QStringRef &line)
+{
+   QVector<Token> tokens;
+   const auto isWord = [](QChar c) { return c.isLetterOrNumber() || c == QLatin1Char('_'); };
+   auto i = 0;
+
+   while (i < line.size())
+   {
+      const auto start = i;
+
+      if (isWord(line.at(i)))
+      {
+         while (i < line.size() && isWord(line.at(i)))
+            ++i;
+      }
+      else if (line.at(i).isSpace())
+      {
+         while (i < line.size() && line.at(i).isSpace())
+            ++i;
+      }
+      else
+         ++i;
+
+      tokens.append({ start, i - start, qHash(line.mid(start, i - start)) });
+   }
+
+   return tokens;
+}
+
+void appendRange(QVector<WordDiff::Range> &ranges, const Token &token)
+{
+   // The tokens that change one after the other are shown as a single range.
+   if (!ranges.isEmpty() && ranges.last().start + ranges.last().length == token.start)
+      ranges.last().length += token.length;
+   else
+      ranges.append({ token.start, token.length });
+}
+}
+
+WordDiff::WordDiff(QObject *parent)
+   : QObject(parent)
+   , mHunks(MAX_HUNKS)
+{
+   // A single worker compares the hunks in the order the views ask for them.
+   mPool.setMaxThreadCount(1);
+}
+
+WordDiff::~WordDiff()
+{
+   cancel();
+
+   mPool.waitForDone();
+}
+
+const WordDiff::HunkChanges *WordDiff::find(quint64 hash) const
+{
+   return mHunks.object(hash);
+}
+
+void WordDiff::compare(const QSharedPointer<const DiffModel> &diff, int hunk, quint64 hash)
+{
+   if (!diff || mHunks.contains(hash) || mPending.contains(hash))
+      return;
+
+   mPending.insert(hash);
+
+   mPool.start(new CompareTask([this, diff, hunk, hash]() {
+      const auto changes = compareHunk(*diff, hunk);
+
+      QMetaObject::invokeMethod(
+          this, [this, hash, changes]() { onHunkCompared(hash, changes); }, Qt::QueuedConnection);
+   }));
+}
+
+void WordDiff::cancel()
+{
+   mPool.clear();
+   mPending.clear();
+}
+
+void WordDiff::onHunkCompared(quint64 hash, const HunkChanges &changes)
+{
+   mPending.remove(hash);
+   mHunks.insert(hash, new HunkChanges(changes));
+
+   emit signalHunkCompared(hash);
+}
+
+WordDiff::HunkChanges WordDiff::compareHunk(const DiffModel &diff, int hunk)
+{
+   const auto first = diff.hunks().at(hunk).firstLine;
+   auto end = first + 1;
+
+   while (end < diff.lineCount())
+   {
+      const auto kind = diff.lineKind(end);
+
+      if (kind != DiffModel::LineKind::Context && kind != DiffModel::LineKind::Addition
+          && kind != DiffModel::LineKind::Removal)
+         break;
+
+      ++end;
+   }
+
+   HunkChanges changes(end - first);
+   auto line = first + 1;
+
+   while (line < end)
+   {
+      // Every block of removed lines is paired, line by line, with the block of added lines that follows it.
+      auto removals = line;
+
+      while (removals < end && diff.lineKind(removals) == DiffModel::LineKind::Removal)
+         ++removals;
+
+      auto additions = removals;
+
+      while (additions < end && diff.lineKind(additions) == DiffModel::LineKind::Addition)
+         ++additions;
+
+      const auto pairs = std::min(removals - line, additions - removals);
+
+      for (auto i = 0; i < pairs; ++i)
+      {
+         const auto oldLine = diff.lineText(line + i);
+         const auto newLine = diff.lineText(removals + i);
+
+         if (oldLine.size() > MAX_LINE_SIZE || newLine.size() > MAX_LINE_SIZE)
+            continue;
+
+         QVector<Range> oldChanges;
+         QVector<Range> newChanges;
+
+         if (compareLines(oldLine.mid(1), newLine.mid(1), oldChanges, newChanges))
+         {
+            // The ranges are moved one position to go over the sign of the line.
+            for (auto &range : oldChanges)
+               ++range.start;
+
+            for (auto &range : newChanges)
+               ++range.start;
+
+            changes[line + i - first] = oldChanges;
+            changes[removals + i - first] = newChanges;
+         }
+      }
+
+      line = std::max(additions, line + 1);
+   }
+
+   return changes;
+}
+
+bool WordDiff::compareLines(const QStringRef &oldLine, const QStringRef &newLine, QVector<Range> &oldChanges,
+                            QVector<Range> &newChanges)
+{
+   const auto oldTokens = tokenize(oldLine);
+   const auto newTokens = tokenize(newLine);
+   const auto equal = [&](int oldToken, int newToken) {
+      const auto &a = oldTokens.at(oldToken);
+      const auto &b = newTokens.at(newToken);
+
+      return a.hash == b.hash && oldLine.mid(a.start, a.length) == newLine.mid(b.start, b.length);
+   };
+
+   // The common tokens at both ends don't need to go through the algorithm.
+   auto prefix = 0;
+
+   while (prefix < oldTokens.count() && prefix < newTokens.count() && equal(prefix, prefix))
+      ++prefix;
+
+   auto suffix = 0;
+
+   while (suffix < oldTokens.count() - prefix && suffix < newTokens.count() - prefix
+          && equal(oldTokens.count() - 1 - suffix, newTokens.count() - 1 - suffix))
+      ++suffix;
+
+   const auto n = oldTokens.count() - prefix - suffix;
+   const auto m = newTokens.count() - prefix - suffix;
+
+   if (n == 0 && m == 0)
+      return true;
+
+   if (prefix + suffix == 0 && (n == 0 || m == 0))
+      return false;
+
+   // Myers: v holds the furthest x reached in every diagonal k, and the trace keeps it for every number of edits so
+   // the path can be walked back.
+   const auto max = std::min(n + m, MAX_EDITS);
+   const auto offset = max + 1;
+   QVector<int> v(2 * max + 3, 0);
+   QVector<QVector<int>> trace;
+   auto edits = -1;
+
+   for (auto d = 0; d <= max && edits == -1; ++d)
+   {
+      trace.append(v);
+
+      for (auto k = -d; k <= d; k += 2)
+      {
+         auto x = (k == -d || (k != d && v.at(offset + k - 1) < v.at(offset + k + 1))) ? v.at(offset + k + 1)
+                                                                                       : v.at(offset + k - 1) + 1;
+         auto y = x - k;
+
+         while (x < n && y < m && equal(prefix + x, prefix + y))
+         {
+            ++x;
+            ++y;
+         }
+
+         v[offset + k] = x;
+
+         if (x >= n && y >= m)
+         {
+            edits = d;
+            break;
+         }
+      }
+   }
+
+   if (edits == -1)
+      return false;
+
+   QVector<bool> oldChanged(n, false);
+   QVector<bool> newChanged(m, false);
+   auto x = n;
+   auto y = m;
+
+   for (auto d = edits; d > 0; --d)
+   {
+      const auto &previous = trace.at(d);
+      const auto k = x - y;
+      const auto insertion
+          = k == -d || (k != d && previous.at(offset + k - 1) < previous.at(offset + k + 1));
+      const auto previousK = insertion ? k + 1 : k - 1;
+      const auto previousX = previous.at(offset + previousK);
+      const auto previousY = previousX - previousK;
+
+      while (x > previousX && y > previousY)
+      {
+         --x;
+         --y;
+      }
+
+      if (insertion)
+         newChanged[previousY] = true;
+      else
+         oldChanged[previousX] = true;
+
+      x = previousX;
+      y = previousY;
+   }
+
+   // A line without anything in common with the other is shown as changed as a whole by the line colors.
+   if (!oldChanged.contains(false) && !newChanged.contains(false) && prefix + suffix == 0)
+      return false;
+
+   for (auto i = 0; i < n; ++i)
+   {
+      if (oldChanged.at(i))
+         appendRange(oldChanges, oldTokens.at(prefix + i));
+   }
+
+   for (auto i = 0; i < m; ++i)
+   {
+      if (newChanged.at(i))
+         appendRange(newChanges, newTokens.at(prefix + i));
+   }
+
+   return true;
+}
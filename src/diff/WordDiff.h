@@ -0,0 +1,137 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QCache>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringRef>
+#include <QThreadPool>
+#include <QVector>
+
+class DiffModel;
+
+/*!
+ \brief The WordDiff finds the words that changed inside the lines of a hunk. The removed lines of a hunk are paired
+ with the added lines that follow them, and every pair is compared token by token (words, runs of spaces and single
+ symbols) with the Myers algorithm.
+
+ The hunks are compared in a worker thread and the result is kept by the hash of the hunk, so scrolling back to a hunk,
+ or reloading a diff that didn't change, doesn't compare it again. The views never wait for the result: they ask for
+ the hunks they show and update them when \ref signalHunkCompared arrives.
+
+ \class WordDiff WordDiff.h "WordDiff.h"
+*/
+class WordDiff : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the changes of a hunk are available.
+
+    \param hash The hash of the hunk, as in the sections of the DiffModel.
+   */
+   void signalHunkCompared(quint64 hash);
+
+public:
+   /*!
+    \brief A part of a line, from the beginning of the line (the +/- sign included).
+   */
+   struct Range
+   {
+      int start = 0;
+      int length = 0;
+   };
+
+   /*!
+    \brief The changed ranges of every line of a hunk, indexed from the "@@" line. The lines without a pair are empty.
+   */
+   using HunkChanges = QVector<QVector<Range>>;
+
+   /*!
+    \brief The number of hunks whose changes are kept.
+   */
+   static constexpr int MAX_HUNKS = 4096;
+   /*!
+    \brief The number of token edits from which two lines are considered different as a whole. Marking every word of
+    a rewritten line doesn't help to read it.
+   */
+   static constexpr int MAX_EDITS = 64;
+   /*!
+    \brief The lines longer than this are not compared.
+   */
+   static constexpr int MAX_LINE_SIZE = 4096;
+
+   explicit WordDiff(QObject *parent = nullptr);
+   ~WordDiff();
+
+   /*!
+    \brief Gets the changes of a hunk that has already been compared.
+
+    \param hash The hash of the hunk.
+    \return The changes, or null if the hunk has not been compared yet.
+   */
+   const HunkChanges *find(quint64 hash) const;
+   /*!
+    \brief Compares a hunk in the worker thread, unless it is already compared or waiting to be.
+
+    \param diff The diff of the hunk.
+    \param hunk The index of the hunk in the diff.
+    \param hash The hash of the hunk.
+   */
+   void compare(const QSharedPointer<const DiffModel> &diff, int hunk, quint64 hash);
+   /*!
+    \brief Drops the hunks that are waiting to be compared, for instance when the diff changes.
+   */
+   void cancel();
+
+   /*!
+    \brief Compares the lines of a hunk.
+
+    \param diff The diff of the hunk.
+    \param hunk The index of the hunk in the diff.
+    \return The changed ranges of every line.
+   */
+   static HunkChanges compareHunk(const DiffModel &diff, int hunk);
+   /*!
+    \brief Compares two lines token by token.
+
+    \param oldLine The removed line, without its sign.
+    \param newLine The added line, without its sign.
+    \param oldChanges The ranges of the removed line that are not in the added one.
+    \param newChanges The ranges of the added line that are not in the removed one.
+    \return False if the lines are too different to show which words changed.
+   */
+   static bool compareLines(const QStringRef &oldLine, const QStringRef &newLine, QVector<Range> &oldChanges,
+                            QVector<Range> &newChanges);
+
+private:
+   QThreadPool mPool;
+   QCache<quint64, HunkChanges> mHunks;
+   QSet<quint64> mPending;
+
+   void onHunkCompared(quint64 hash, const HunkChanges &changes);
+};
@@ -1,7 +1,15 @@
 #include "AGitProcess.h"
 
+#include <GitCommandStats.h>
+#include <LazyLog.h>
+#include <TraceRecorder.h>
+
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <utility>
 
 #include <QLogger.h>
 
@@ -15,11 +23,17 @@ void restoreSpaces(QString &newCmd, const QChar &sepChar)
    auto replace = false;
    const auto newCommandLength = newCmd.length();
 
+   // The quotes are counted once: counting them for every character made long commands quadratic.
+   const auto dollars = newCmd.count('$');
+   const auto doubleQuotes = newCmd.count('\"');
+   const auto singleQuotes = newCmd.count('\'');
+
    for (int i = 0; i < newCommandLength; ++i)
    {
       const auto c = newCmd[i];
+      const auto count = c == '$' ? dollars : c == '\"' ? doubleQuotes : singleQuotes;
 
-      if (!replace && (c == "$"[0] || c == '\"' || c == '\'') && (newCmd.count(c) % 2 == 0))
+      if (!replace && (c == '$' || c == '\"' || c == '\'') && (count % 2 == 0))
       {
          replace = true;
          quoteChar = c;
@@ -36,8 +50,9 @@ void restoreSpaces(QString &newCmd, const QChar &sepChar)
          newCmd[i] = QChar(' ');
    }
 }
+}
 
-QStringList splitArgList(const QString &cmd)
+QStringList AGitProcess::splitArgList(const QString &cmd)
 {
    // return argument list handling quotes and double quotes
    // substring, as example from:
@@ -89,13 +104,37 @@ QStringList splitArgList(const QString &cmd)
    }
    return sl;
 }
-}
 
 AGitProcess::AGitProcess(const QString &workingDir)
    : mWorkingDirectory(workingDir)
 {
    setWorkingDirectory(mWorkingDirectory);
 
+   // The measures are taken before the handlers of the subclasses read the output.
+   connect(
+       this, &AGitProcess::readyReadStandardOutput, this,
+       [this]() {
+          if (mFirstByteMs == -1)
+             mFirstByteMs = mTimer.elapsed();
+
+          // The output is peeked, so the subclasses read it as usual.
+          if (mRecording)
+             mRecordedOutput.append(peek(bytesAvailable()));
+
+          mOutputBytes += bytesAvailable();
+       },
+       Qt::DirectConnection);
+   connect(
+       this, static_cast<void (AGitProcess::*)(int, QProcess::ExitStatus)>(&AGitProcess::finished), this,
+       [this](int exitCode, QProcess::ExitStatus exitStatus) {
+          mOutputBytes += bytesAvailable();
+          recordStats(exitStatus == QProcess::NormalExit && exitCode == 0 && !mCanceling);
+
+          if (mRecording && !mCanceling)
+             recordRun(exitCode, exitStatus);
+       },
+       Qt::DirectConnection);
+
    connect(this, &AGitProcess::readyReadStandardOutput, this, &AGitProcess::onReadyStandardOutput,
            Qt::DirectConnection);
    connect(this, static_cast<void (AGitProcess::*)(int, QProcess::ExitStatus)>(&AGitProcess::finished), this,
@@ -104,18 +143,42 @@ AGitProcess::AGitProcess(const QString &workingDir)
 
 void AGitProcess::onCancel()
 {
+   if (mReplayPending)
+   {
+      // The replayed run finishes as a cancelled process does: without its output.
+      mCanceling = true;
+      QTimer::singleShot(0, this, &AGitProcess::replay);
+      return;
+   }
+
+   if (state() == QProcess::NotRunning)
+      return;
+
+   QLog_LazyDebug("Git", QString("Cancelling the process {%1}.").arg(mCommand));
+
    mCanceling = true;
 
-   waitForFinished();
+   // The process is asked to finish and killed if it doesn't do it in time. None of it blocks the caller.
+   terminate();
+
+   QTimer::singleShot(KILL_TIMEOUT_MS, this, [this]() {
+      if (state() != QProcess::NotRunning)
+      {
+         QLog_Warning("Git", QString("Killing the process {%1}.").arg(mCommand));
+
+         kill();
+      }
+   });
 }
 
 void AGitProcess::onReadyStandardOutput()
 {
    if (!mCanceling)
    {
-      const auto standardOutput = readAllStandardOutput();
+      const auto standardOutput = readOutput();
 
-      mRunOutput.append(QString::fromUtf8(standardOutput));
+      // The first chunk is shared, not copied, and the next ones are appended to the same buffer.
+      mRunOutput.append(standardOutput);
 
       emit procDataReady(standardOutput);
    }
@@ -123,45 +186,182 @@ void AGitProcess::onReadyStandardOutput()
 
 bool AGitProcess::execute(const QString &command)
 {
-   mCommand = command;
-
-   auto processStarted = false;
-   auto arguments = splitArgList(mCommand);
+   auto arguments = splitArgList(command);
 
-   if (!arguments.isEmpty())
+   if (arguments.isEmpty())
    {
-      QStringList env = QProcess::systemEnvironment();
-      env << "GIT_TRACE=0"; // avoid choking on debug traces
-      env << "GIT_FLUSH=0"; // skip the fflush() in 'git log'
+      mCommand = command;
+      return false;
+   }
+
+   const auto program = arguments.takeFirst();
 
-      setEnvironment(env);
-      setProgram(arguments.takeFirst());
-      setArguments(arguments);
-      start();
+   return execute(program, arguments);
+}
+
+bool AGitProcess::execute(const QString &program, const QStringList &arguments, const QByteArray &input)
+{
+   mCommand = QString("%1 %2").arg(program, arguments.join(' '));
+   mInput = input;
 
-      processStarted = waitForStarted();
+   QStringList env = QProcess::systemEnvironment();
+   env << "GIT_TRACE=0"; // avoid choking on debug traces
+   env << "GIT_FLUSH=0"; // skip the fflush() in 'git log'
 
-      if (!processStarted)
-         QLog_Warning("Git", QString("Unable to start the process:\n%1\nMore info:\n%2").arg(mCommand, errorString()));
-      else
-         QLog_Debug("Git", QString("Process started: %1").arg(mCommand));
+   setEnvironment(env);
+   setProgram(program);
+   setArguments(arguments);
+
+   mFirstByteMs = -1;
+   mOutputBytes = 0;
+   mTimer.start();
+
+   const auto &recorder = GitRecorder::instance();
+
+   if (recorder.isReplaying())
+      return startReplay();
+
+   mRecording = recorder.isRecording();
+   mRecordedOutput.clear();
+
+   start();
+
+   const auto processStarted = waitForStarted();
+
+   mSpawnMs = mTimer.elapsed();
+
+   if (!processStarted)
+   {
+      recordStats(false);
+      QLog_Warning("Git", QString("Unable to start the process:\n%1\nMore info:\n%2").arg(mCommand, errorString()));
    }
+   else
+      QLog_LazyDebug("Git", QString("Process started: %1").arg(mCommand));
 
    return processStarted;
 }
 
 void AGitProcess::onFinished(int, QProcess::ExitStatus exitStatus)
 {
-   QLog_Debug("Git", QString("Process {%1} finished.").arg(mCommand));
+   QLog_LazyDebug("Git", QString("Process {%1} finished.").arg(mCommand));
 
-   const auto errorOutput = readAllStandardError();
-
-   mErrorOutput = QString::fromUtf8(errorOutput);
-   mRealError = exitStatus != QProcess::NormalExit || mCanceling || errorOutput.contains("error")
-       || errorOutput.toLower().contains("could not read username");
+   // The subclasses that follow the progress read the standard error while the process runs.
+   mErrorOutput.append(readError());
+   mRealError = exitStatus != QProcess::NormalExit || mCanceling || mErrorOutput.contains("error")
+       || mErrorOutput.toLower().contains("could not read username");
 
    if (mRealError)
       mRunOutput = mErrorOutput;
    else
-      mRunOutput.append(readAllStandardOutput() + mErrorOutput);
+   {
+      mRunOutput.append(readOutput());
+      mRunOutput.append(mErrorOutput);
+   }
+}
+
+void AGitProcess::recordStats(bool success)
+{
+   GitCommandStats::Sample sample;
+   sample.spawnMs = mSpawnMs;
+   sample.firstByteMs = mFirstByteMs;
+   sample.wallMs = mTimer.elapsed();
+   sample.outputBytes = mOutputBytes;
+   sample.success = success;
+
+   GitCommandStats::instance().record(mCommand, sample);
+
+   if (auto &trace = TraceRecorder::instance(); trace.isEnabled())
+   {
+      const auto durationUs = mTimer.nsecsElapsed() / 1000;
+      trace.record("git", mCommand, TraceRecorder::now() - durationUs, durationUs);
+   }
+}
+
+void AGitProcess::recordRun(int exitCode, QProcess::ExitStatus exitStatus)
+{
+   GitRecorder::Entry entry;
+   entry.command = mCommand;
+   entry.normalExit = exitStatus == QProcess::NormalExit;
+   entry.exitCode = exitCode;
+   entry.spawnMs = mSpawnMs;
+   entry.firstByteMs = mFirstByteMs;
+   entry.wallMs = mTimer.elapsed();
+
+   // Nothing has read the end of the output yet: it's handled after this.
+   entry.output = mRecordedOutput.append(peek(bytesAvailable()));
+
+   setReadChannel(QProcess::StandardError);
+   entry.errorOutput = mErrorOutput + peek(bytesAvailable());
+   setReadChannel(QProcess::StandardOutput);
+
+   mRecordedOutput.clear();
+
+   GitRecorder::instance().record(mWorkingDirectory, std::move(entry), mInput);
+}
+
+bool AGitProcess::startReplay()
+{
+   auto &recorder = GitRecorder::instance();
+
+   mSpawnMs = 0;
+   mReplayPending = recorder.take(mWorkingDirectory, mCommand, mInput, mReplay);
+
+   if (!mReplayPending)
+   {
+      recordStats(false);
+      return false;
+   }
+
+   mReplayDelayMs = recorder.replayDelay(mReplay.wallMs);
+
+   QTimer::singleShot(mReplayDelayMs, this, &AGitProcess::replay);
+
+   QLog_LazyDebug("Git", QString("Process replayed: %1").arg(mCommand));
+
+   return true;
+}
+
+void AGitProcess::waitForReplay()
+{
+   // The time is counted from the start: the processes launched together are replayed together.
+   if (const auto remaining = mReplayDelayMs - mTimer.elapsed(); mReplayPending && remaining > 0)
+      QThread::msleep(static_cast<unsigned long>(remaining));
+
+   replay();
+}
+
+void AGitProcess::replay()
+{
+   if (!mReplayPending)
+      return;
+
+   mReplayPending = false;
+
+   if (!mReplay.output.isEmpty())
+   {
+      mFirstByteMs = mTimer.elapsed();
+      mOutputBytes = mReplay.output.size();
+
+      onReadyStandardOutput();
+   }
+
+   recordStats(mReplay.normalExit && mReplay.exitCode == 0 && !mCanceling);
+
+   onFinished(mReplay.exitCode, mReplay.normalExit ? QProcess::NormalExit : QProcess::CrashExit);
+}
+
+QByteArray AGitProcess::readOutput()
+{
+   if (mReplay.output.isEmpty())
+      return readAllStandardOutput();
+
+   return std::exchange(mReplay.output, QByteArray());
+}
+
+QByteArray AGitProcess::readError()
+{
+   if (mReplay.errorOutput.isEmpty())
+      return readAllStandardError();
+
+   return std::exchange(mReplay.errorOutput, QByteArray());
 }
@@ -23,9 +23,11 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <QElapsedTimer>
 #include <QProcess>
 
 #include <GitExecResult.h>
+#include <GitRecorder.h>
 
 class AGitProcess : public QProcess
 {
@@ -38,18 +40,90 @@ public:
    explicit AGitProcess(const QString &workingDir);
 
    virtual GitExecResult run(const QString &command) = 0;
+   /*!
+    \brief Cancels the process without waiting for it to finish. The process is terminated and, if it's still running
+    after KILL_TIMEOUT_MS, it is killed.
+   */
    void onCancel();
 
+   static constexpr int KILL_TIMEOUT_MS = 2000;
+
+   /*!
+    \brief Splits a command in its arguments. The quoted arguments keep their spaces and lose their quotes.
+
+    \param cmd The command.
+    \return The arguments, the program first.
+   */
+   static QStringList splitArgList(const QString &cmd);
+
 protected:
-   QString mRunOutput;
+   // The output is kept as it comes from git: it's decoded only if the result is read as a string.
+   QByteArray mRunOutput;
    QString mWorkingDirectory;
-   QString mErrorOutput;
+   QByteArray mErrorOutput;
    QString mCommand;
    bool mRealError = false;
    bool mCanceling = false;
+   /*!
+    \brief The measures of the process, added to GitCommandStats when it finishes. They don't depend on how the
+    subclasses read the output.
+   */
+   QElapsedTimer mTimer;
+   qint64 mSpawnMs = 0;
+   qint64 mFirstByteMs = -1;
+   qint64 mOutputBytes = 0;
+   /*!
+    \brief The input written to git, kept to find the command in a recording.
+   */
+   QByteArray mInput;
+   /*!
+    \brief True while a replayed run waits to be delivered. Meanwhile there is no git process: the subclasses must not
+    write to it.
+   */
+   bool mReplayPending = false;
+   /*!
+    \brief Starts a command given as a single string. The string is split into arguments, taking into account the
+    quotes. It's kept for the commands that are built as strings: the arguments can be passed as they are with the
+    other overload.
+
+    \param command The command, starting with the program.
+    \return True if the process started, otherwise false.
+   */
    bool execute(const QString &command);
+   /*!
+    \brief Starts a program with its arguments, without splitting or quoting them.
+
+    \param program The program.
+    \param arguments The arguments.
+    \param input The data the caller writes to the standard input of git. It's only used by the GitRecorder.
+    \return True if the process started, otherwise false.
+   */
+   bool execute(const QString &program, const QStringList &arguments, const QByteArray &input = QByteArray());
+   /*!
+    \brief Waits the time left of a replayed run and delivers it. It's for the subclasses that block until the process
+    finishes, since the delivery is otherwise done by the event loop.
+   */
+   void waitForReplay();
+   /*!
+    \brief Reads the standard output. The subclasses read it with this method instead of readAllStandardOutput so they
+    also get the output of a replayed run.
+   */
+   QByteArray readOutput();
+   /*!
+    \brief Reads the standard error, or the one of a replayed run.
+   */
+   QByteArray readError();
    virtual void onFinished(int, QProcess::ExitStatus exitStatus);
+   virtual void onReadyStandardOutput();
 
 private:
-   void onReadyStandardOutput();
+   bool mRecording = false;
+   QByteArray mRecordedOutput;
+   GitRecorder::Entry mReplay;
+   qint64 mReplayDelayMs = 0;
+
+   void recordStats(bool success);
+   void recordRun(int exitCode, QProcess::ExitStatus exitStatus);
+   bool startReplay();
+   void replay();
 };
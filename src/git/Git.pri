@@ -4,38 +4,70 @@ HEADERS += \
     $$PWD/AGitProcess.h \
     $$PWD/GitAsyncProcess.h \
     $$PWD/GitBase.h \
+    $$PWD/GitBlobReader.h \
     $$PWD/GitBranches.h \
     $$PWD/GitCloneProcess.h \
+    $$PWD/GitCommandGraph.h \
+    $$PWD/GitCommandStats.h \
+    $$PWD/GitCommitDetails.h \
     $$PWD/GitConfig.h \
+    $$PWD/GitConfigSnapshot.h \
     $$PWD/GitExecResult.h \
+    $$PWD/GitFilesPrefetch.h \
     $$PWD/GitHistory.h \
     $$PWD/GitLocal.h \
+    $$PWD/GitMaintenance.h \
     $$PWD/GitMerge.h \
+    $$PWD/GitPickaxeSearch.h \
     $$PWD/GitPatches.h \
+    $$PWD/GitProcessScheduler.h \
+    $$PWD/GitRecorder.h \
     $$PWD/GitRemote.h \
+    $$PWD/GitRemotesFetch.h \
     $$PWD/GitRepoLoader.h \
+    $$PWD/GitRepositoryReader.h \
     $$PWD/GitRequestorProcess.h \
+    $$PWD/GitSparseCheckout.h \
     $$PWD/GitStashes.h \
     $$PWD/GitSubmodules.h \
+    $$PWD/GitSubmodulesStatus.h \
     $$PWD/GitSyncProcess.h \
-    $$PWD/GitTags.h
+    $$PWD/GitTags.h \
+    $$PWD/GitWatcher.h \
+    $$PWD/GitWatcherHub.h
 
 SOURCES += \
     $$PWD/AGitProcess.cpp \
     $$PWD/GitAsyncProcess.cpp \
     $$PWD/GitBase.cpp \
+    $$PWD/GitBlobReader.cpp \
     $$PWD/GitBranches.cpp \
     $$PWD/GitCloneProcess.cpp \
+    $$PWD/GitCommandGraph.cpp \
+    $$PWD/GitCommandStats.cpp \
+    $$PWD/GitCommitDetails.cpp \
     $$PWD/GitConfig.cpp \
+    $$PWD/GitConfigSnapshot.cpp \
     $$PWD/GitExecResult.cpp \
+    $$PWD/GitFilesPrefetch.cpp \
     $$PWD/GitHistory.cpp \
     $$PWD/GitLocal.cpp \
+    $$PWD/GitMaintenance.cpp \
     $$PWD/GitMerge.cpp \
+    $$PWD/GitPickaxeSearch.cpp \
     $$PWD/GitPatches.cpp \
+    $$PWD/GitProcessScheduler.cpp \
+    $$PWD/GitRecorder.cpp \
     $$PWD/GitRemote.cpp \
+    $$PWD/GitRemotesFetch.cpp \
     $$PWD/GitRepoLoader.cpp \
+    $$PWD/GitRepositoryReader.cpp \
     $$PWD/GitRequestorProcess.cpp \
+    $$PWD/GitSparseCheckout.cpp \
     $$PWD/GitStashes.cpp \
     $$PWD/GitSubmodules.cpp \
+    $$PWD/GitSubmodulesStatus.cpp \
     $$PWD/GitSyncProcess.cpp \
-    $$PWD/GitTags.cpp
+    $$PWD/GitTags.cpp \
+    $$PWD/GitWatcher.cpp \
+    $$PWD/GitWatcherHub.cpp
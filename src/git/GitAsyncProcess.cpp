@@ -1,9 +1,12 @@
 #include "GitAsyncProcess.h"
 
+#include <QRegExp>
 #include <QTemporaryFile>
 GitAsyncProcess::GitAsyncProcess(const QString &workingDir)
    : AGitProcess(workingDir)
 {
+   connect(this, &AGitProcess::readyReadStandardError, this, &GitAsyncProcess::onReadyStandardError,
+           Qt::DirectConnection);
 }
 
 GitExecResult GitAsyncProcess::run(const QString &command)
@@ -11,12 +14,61 @@ GitExecResult GitAsyncProcess::run(const QString &command)
    return { execute(command), "" };
 }
 
+bool GitAsyncProcess::run(const QStringList &arguments, const QByteArray &input)
+{
+   const auto started = execute("git", arguments, input);
+
+   // The input is buffered by QProcess and written as git reads it, so the event loop isn't blocked.
+   if (started && !mReplayPending && !input.isEmpty())
+   {
+      write(input);
+      closeWriteChannel();
+   }
+
+   return started;
+}
+
+void GitAsyncProcess::onReadyStandardError()
+{
+   if (mCanceling)
+      return;
+
+   const auto err = readAllStandardError();
+   mErrorOutput.append(err);
+
+   // The progress lines are rewritten with a carriage return: only the last complete one of the chunk matters.
+   const auto lines = QString::fromUtf8(err).split(QRegExp("[\\r\\n]"), QString::SkipEmptyParts);
+
+   for (auto iter = lines.crbegin(); iter != lines.crend(); ++iter)
+   {
+      auto line = iter->trimmed();
+
+      if (line.startsWith("remote: "))
+         line = line.mid(8);
+
+      const auto separator = line.indexOf(':');
+      const auto percentage = line.indexOf('%');
+
+      if (separator > 0 && percentage > separator)
+      {
+         auto ok = false;
+         const auto value = line.mid(separator + 1, percentage - separator - 1).trimmed().toInt(&ok);
+
+         if (ok)
+         {
+            emit signalProgress(line.left(separator), value);
+            break;
+         }
+      }
+   }
+}
+
 void GitAsyncProcess::onFinished(int code, QProcess::ExitStatus exitStatus)
 {
    AGitProcess::onFinished(code, exitStatus);
 
    if (!mCanceling)
-      emit signalDataReady({ mRealError, mRunOutput });
+      emit signalDataReady({ !mRealError, mRunOutput });
 
    deleteLater();
 }
@@ -31,11 +31,29 @@ class GitAsyncProcess : public AGitProcess
 
 signals:
    void signalDataReady(GitExecResult result);
+   /*!
+    \brief Signal triggered when git reports the progress of a step in the standard error, for the commands run with
+    --progress.
+
+    \param stepDescription The step, for instance "Receiving objects".
+    \param value The percentage of the step.
+   */
+   void signalProgress(const QString &stepDescription, int value);
 
 public:
    explicit GitAsyncProcess(const QString &workingDir);
    GitExecResult run(const QString &command) override;
+   /*!
+    \brief Starts git with the given arguments, passed as they are. The result is notified with signalDataReady.
+
+    \param arguments The arguments of git.
+    \param input The data written to the standard input of git, that is closed after it. Nothing is written if it's
+    empty.
+    \return True if the process started, otherwise false.
+   */
+   bool run(const QStringList &arguments, const QByteArray &input = QByteArray());
 
 private:
+   void onReadyStandardError();
    void onFinished(int code, QProcess::ExitStatus exitStatus) override;
 };
@@ -2,17 +2,73 @@
 
 #include <GitSyncProcess.h>
 #include <GitAsyncProcess.h>
+#include <GitRepositoryReader.h>
+#include <LazyLog.h>
 
 #include <QLogger.h>
 
 using namespace QLogger;
 
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+namespace
+{
+QString repositoryIdOf(const GitRepositoryReader &reader, const QString &workingDirectory)
+{
+   // A directory that is not a repository yet is identified by its work tree.
+   return QDir::cleanPath(reader.commonDir().isEmpty() ? workingDirectory : reader.commonDir());
+}
+
+QByteArray filesStamp(const QStringList &files)
+{
+   QByteArray stamp;
+
+   for (const auto &file : files)
+   {
+      const QFileInfo info(file);
+
+      stamp.append(QByteArray::number(info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0));
+      stamp.append(':');
+      stamp.append(QByteArray::number(info.size()));
+      stamp.append(';');
+   }
+
+   return stamp;
+}
+
+void logResult(const QString &cmd, const GitExecResult &ret)
+{
+   const auto runOutput = ret.output.toString();
+
+   if (ret.success)
+   {
+      if (runOutput.contains("fatal:"))
+         QLog_Info("Git", QString("Git command {%1} reported issues:\n%2").arg(cmd, runOutput));
+      else
+         QLog_LazyTrace("Git", QString("Git command {%1} executed successfully.").arg(cmd));
+   }
+   else
+      QLog_Warning("Git", QString("Git command {%1} has errors:\n%2").arg(cmd, runOutput));
+}
+}
 
 GitBase::GitBase(const QString &workingDirectory, QObject *parent)
    : QObject(parent)
    , mWorkingDirectory(workingDirectory)
 {
+   // The submodules share the processes of their superproject and the work trees of a repository share everything.
+   const GitRepositoryReader reader(workingDirectory);
+   const auto superproject = reader.topSuperprojectDir();
+   mRepositoryId = repositoryIdOf(reader, workingDirectory);
+   mRepositoryGroup
+       = superproject.isEmpty() ? mRepositoryId : repositoryIdOf(GitRepositoryReader(superproject), superproject);
+   mScheduler = GitProcessScheduler::forRepositoryGroup(mRepositoryGroup);
+
+   connect(this, &GitBase::cancelAllProcesses, mScheduler.data(),
+           [this]() { mScheduler->cancelAll(mWorkingDirectory); });
 }
 
 QString GitBase::getWorkingDir() const
@@ -31,22 +87,133 @@ GitExecResult GitBase::run(const QString &cmd) const
    connect(this, &GitBase::cancelAllProcesses, &p, &AGitProcess::onCancel);
 
    const auto ret = p.run(cmd);
-   const auto runOutput = ret.output.toString();
 
-   if (ret.success)
+   logResult(cmd, ret);
+
+   return ret;
+}
+
+GitExecResult GitBase::run(const QStringList &arguments, const QByteArray &input) const
+{
+   GitSyncProcess p(mWorkingDirectory);
+   connect(this, &GitBase::cancelAllProcesses, &p, &AGitProcess::onCancel);
+
+   const auto ret = p.run(arguments, input);
+
+   logResult(QString("git %1").arg(arguments.join(' ')), ret);
+
+   return ret;
+}
+
+GitExecResult GitBase::runCached(const QString &cmd) const
+{
+   const auto stamp = getRepositoryStamp();
+
+   if (!stamp.isEmpty())
    {
+      QMutexLocker lock(&mMemoMutex);
 
-      if (runOutput.contains("fatal:"))
-         QLog_Info("Git", QString("Git command {%1} reported issues:\n%2").arg(cmd, runOutput));
-      else
-         QLog_Trace("Git", QString("Git command {%1} executed successfully.").arg(cmd));
+      if (mMemoStamp != stamp)
+      {
+         mMemo.clear();
+         mMemoStamp = stamp;
+      }
+      else if (const auto iter = mMemo.constFind(cmd); iter != mMemo.cend())
+      {
+         QLog_LazyTrace("Git", QString("Git command {%1} answered from the memo.").arg(cmd));
+         return iter.value();
+      }
+   }
+
+   const auto ret = run(cmd);
+
+   if (ret.success && !stamp.isEmpty())
+   {
+      QMutexLocker lock(&mMemoMutex);
+
+      // The state could have changed while git was running: the result is only valid for the stamp taken before.
+      if (mMemoStamp == stamp)
+         mMemo.insert(cmd, ret);
    }
-   else
-      QLog_Warning("Git", QString("Git command {%1} has errors:\n%2").arg(cmd, runOutput));
 
    return ret;
 }
 
+QByteArray GitBase::getRepositoryStamp() const
+{
+   // Without a stamp nothing is memoized: every command reaches the recording.
+   if (GitRecorder::instance().isActive())
+      return QByteArray();
+
+   const GitRepositoryReader reader(mWorkingDirectory);
+
+   if (!reader.isValid())
+      return QByteArray();
+
+   const QDir gitDir(reader.gitDir());
+   const QDir commonDir(reader.commonDir());
+
+   // Git replaces the files it updates by renaming a lock file, so the directories that hold them change too. The
+   // references in subdirectories of refs/heads are only seen through the reflog of HEAD when they are checked out.
+   const QStringList files { gitDir.path(),
+                             gitDir.filePath("HEAD"),
+                             gitDir.filePath("index"),
+                             gitDir.filePath("logs/HEAD"),
+                             commonDir.filePath("config"),
+                             commonDir.filePath("packed-refs"),
+                             commonDir.filePath("refs/heads"),
+                             commonDir.filePath("refs/remotes"),
+                             commonDir.filePath("refs/tags"),
+                             QDir(mWorkingDirectory).filePath(".gitmodules"),
+                             QDir::home().filePath(".gitconfig") };
+
+   return filesStamp(files);
+}
+
+QSharedPointer<const GitConfigSnapshot> GitBase::getConfig() const
+{
+   QMutexLocker lock(&mConfigMutex);
+
+   if (mConfig && filesStamp(mConfigFiles) == mConfigStamp)
+      return mConfig;
+
+   const GitRepositoryReader reader(mWorkingDirectory);
+
+   // The files that don't exist yet are watched too, so creating one of them is noticed.
+   const auto files = GitConfigSnapshot::knownFiles(reader.gitDir(), reader.commonDir(), mWorkingDirectory);
+   const auto stamp = filesStamp(files);
+
+   QLog_Debug("Git", QString("Loading the configuration of {%1}.").arg(mWorkingDirectory));
+
+   const auto ret = run({ "config", "--list", "-z", "--show-origin" });
+
+   if (!ret.success)
+      return QSharedPointer<GitConfigSnapshot>::create();
+
+   const auto config = QSharedPointer<GitConfigSnapshot>::create(ret.output.toByteArray(), reader.gitDir(),
+                                                                reader.commonDir(), mWorkingDirectory);
+   QStringList included;
+
+   for (const auto &file : config->files())
+   {
+      if (!files.contains(file))
+         included.append(file);
+   }
+
+   mConfig = config;
+   mConfigFiles = files + included;
+   mConfigStamp = stamp + filesStamp(included);
+
+   return mConfig;
+}
+
+void GitBase::invalidateConfig() const
+{
+   QMutexLocker lock(&mConfigMutex);
+
+   mConfig.reset();
+}
+
 bool GitBase::runAsync(const QString &cmd) const
 {
    const auto p = new GitAsyncProcess(mWorkingDirectory);
@@ -56,11 +223,39 @@ bool GitBase::runAsync(const QString &cmd) const
    return p->run(cmd).success;
 }
 
+int GitBase::runAsync(const QString &cmd, QObject *context, const ResultCallback &callback, Priority priority) const
+{
+   return mScheduler->schedule(mWorkingDirectory, cmd, priority, context, callback);
+}
+
+int GitBase::runAsync(const QStringList &arguments, QObject *context, const ResultCallback &callback,
+                      Priority priority, const QByteArray &input) const
+{
+   return mScheduler->schedule(mWorkingDirectory, arguments, priority, context, callback, input);
+}
+
+void GitBase::cancel(int request) const
+{
+   mScheduler->cancel(request);
+}
+
 void GitBase::updateCurrentBranch()
 {
    QLog_Trace("Git", "Updating the current branch");
 
-   const auto ret = run("git rev-parse --abbrev-ref HEAD");
+   if (usesBuiltinRead(ReadOperation::Head))
+   {
+      QString sha;
+      QString branch;
+
+      if (GitRepositoryReader(mWorkingDirectory).readHead(sha, branch))
+      {
+         mCurrentBranch = branch;
+         return;
+      }
+   }
+
+   const auto ret = runCached("git rev-parse --abbrev-ref HEAD");
 
    mCurrentBranch = ret.success ? ret.output.toString().trimmed() : QString();
 }
@@ -77,5 +272,74 @@ QString GitBase::getCurrentBranch()
 
 GitExecResult GitBase::getLastCommit() const
 {
-   return run("git rev-parse HEAD");
+   if (usesBuiltinRead(ReadOperation::Head))
+   {
+      QString sha;
+      QString branch;
+
+      if (GitRepositoryReader(mWorkingDirectory).readHead(sha, branch))
+         return { true, QString("%1\n").arg(sha).toUtf8() };
+
+      QLog_Trace("Git", "HEAD can't be read directly, asking git.");
+   }
+
+   return runCached("git rev-parse HEAD");
+}
+
+GitExecResult GitBase::getReferences(bool dereference) const
+{
+   if (usesBuiltinRead(ReadOperation::References))
+   {
+      QVector<GitRepositoryReader::Reference> references;
+
+      if (GitRepositoryReader(mWorkingDirectory).readReferences(dereference, references))
+         return { true, GitRepositoryReader::toShowRefOutput(references).toUtf8() };
+
+      QLog_Trace("Git", "The references can't be read directly, asking git.");
+   }
+
+   return runCached(dereference ? QString("git show-ref -d") : QString("git show-ref"));
+}
+
+GitExecResult GitBase::getReferenceRecords(bool tracking) const
+{
+   if (!tracking && usesBuiltinRead(ReadOperation::References))
+   {
+      QVector<GitRepositoryReader::Reference> references;
+
+      if (GitRepositoryReader(mWorkingDirectory).readReferences(true, references))
+         return { true, GitRepositoryReader::toReferenceRecords(references) };
+
+      QLog_Trace("Git", "The references can't be read directly, asking git.");
+   }
+
+   // The kind and the short name come from git: the records are parsed without slicing the names.
+   const auto format = QString("%(refname)%00%(refname:rstrip=-2)%00%(refname:lstrip=2)%00%(objectname)%00"
+                               "%(*objectname)%00")
+       + (tracking ? QString("%(upstream:track,nobracket)") : QString());
+
+   return runCached(QString("git for-each-ref --format=%1 refs/heads refs/remotes refs/tags").arg(format));
+}
+
+QString GitBase::getGitDir() const
+{
+   if (usesBuiltinRead(ReadOperation::GitDirectory))
+   {
+      const GitRepositoryReader reader(mWorkingDirectory);
+
+      if (reader.isValid())
+         return reader.gitDir();
+   }
+
+   const auto ret = runCached("git rev-parse --git-dir");
+
+   return ret.success ? QDir(mWorkingDirectory).absoluteFilePath(ret.output.toString().trimmed()) : QString();
+}
+
+void GitBase::setBuiltinRead(ReadOperation operation, bool enabled)
+{
+   if (enabled)
+      mBuiltinReads |= static_cast<int>(operation);
+   else
+      mBuiltinReads &= ~static_cast<int>(operation);
 }
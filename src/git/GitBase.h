@@ -23,9 +23,14 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitConfigSnapshot.h>
 #include <GitExecResult.h>
+#include <GitProcessScheduler.h>
+#include <GitRecorder.h>
 #include <RevisionsCache.h>
 
+#include <QHash>
+#include <QMutex>
 #include <QObject>
 #include <QSharedPointer>
 
@@ -38,11 +43,95 @@ signals:
    void signalResultReady(GitExecResult result);
 
 public:
+   /*!
+    \brief The function that receives the result of an asynchronous command.
+   */
+   using ResultCallback = GitProcessScheduler::ResultCallback;
+   using Priority = GitProcessScheduler::Priority;
+
+   /*!
+    \brief The read operations that can be answered by reading the repository files instead of starting git.
+   */
+   enum class ReadOperation
+   {
+      Head = 0x1,
+      References = 0x2,
+      GitDirectory = 0x4
+   };
+
    explicit GitBase(const QString &workingDirectory, QObject *parent = nullptr);
 
    GitExecResult run(const QString &cmd) const;
+   /*!
+    \brief Runs git with the given arguments. Unlike the string form of the command, the arguments are passed to the
+    process as they are: they are not split again and the paths need no quoting.
+
+    \param arguments The arguments of git, without the program.
+    \param input The data written to the standard input of git, for instance the paths of --pathspec-from-file=-.
+    \return The result of the command.
+   */
+   GitExecResult run(const QStringList &arguments, const QByteArray &input = QByteArray()) const;
+   /*!
+    \brief Runs a command that only reads the repository and remembers its result. The command is run again only once
+    the state of the repository changes: HEAD, the index, the references or the configuration. Only the successful
+    results are remembered.
+
+    \param cmd The command. It must not modify anything and its output must only depend on the repository state.
+    \return The result of the command.
+   */
+   GitExecResult runCached(const QString &cmd) const;
 
    bool runAsync(const QString &cmd) const;
+   /*!
+    \brief Runs a command without blocking, through the scheduler of the repository. The callback gets the result in
+    the thread of the GitBase once git finishes, unless the command is cancelled with \ref cancel or the context
+    object is destroyed before. If it's cancelled with the rest of the processes of the GitBase, the callback gets a
+    failure.
+
+    \param cmd The command.
+    \param context The object the callback belongs to.
+    \param callback The function that receives the result. It also gets a failure when git can't be started.
+    \param priority The priority of the command against the others waiting for a process.
+    \return The id of the request, to cancel it with \ref cancel.
+   */
+   int runAsync(const QString &cmd, QObject *context, const ResultCallback &callback,
+                Priority priority = Priority::Interactive) const;
+   /*!
+    \brief Runs git with the given arguments, passed as they are, without blocking. See the overload with the command
+    as a string.
+
+    \param arguments The arguments of git, without the program.
+    \param context The object the callback belongs to.
+    \param callback The function that receives the result.
+    \param priority The priority of the command against the others waiting for a process.
+    \param input The data written to the standard input of git, for the commands that read it with --stdin.
+    \return The id of the request, to cancel it with \ref cancel.
+   */
+   int runAsync(const QStringList &arguments, QObject *context, const ResultCallback &callback,
+                Priority priority = Priority::Interactive, const QByteArray &input = QByteArray()) const;
+   /*!
+    \brief Cancels an asynchronous command. Its callback is not called. Nothing happens if it finished already.
+
+    \param request The id of the request.
+   */
+   void cancel(int request) const;
+   /*!
+    \brief Returns the scheduler of the asynchronous commands, to configure it or to read its metrics. It's shared
+    with the rest of the repositories of the group.
+   */
+   GitProcessScheduler *getScheduler() const { return mScheduler.data(); }
+   /*!
+    \brief Returns the group of the repository: the repository of its outermost superproject if it's a submodule, or
+    the repository itself otherwise, identified as in \ref getRepositoryId. The repositories of a group share their
+    processes and the table of their paths.
+   */
+   QString getRepositoryGroup() const { return mRepositoryGroup; }
+   /*!
+    \brief Returns the identity of the repository: its common git directory. All the work trees of a repository have
+    the same one, so the caches of what never changes (the files and the diffs between commits, the blames) are
+    shared by their tabs. What depends on the work tree (HEAD, the index and the WIP) is kept by every tab.
+   */
+   QString getRepositoryId() const { return mRepositoryId; }
 
    QString getWorkingDir() const;
 
@@ -50,11 +139,91 @@ public:
 
    void updateCurrentBranch();
 
+   void setCurrentBranch(const QString &branch) { mCurrentBranch = branch; }
+
    QString getCurrentBranch();
 
    GitExecResult getLastCommit() const;
+   /*!
+    \brief Returns the references of the repository with the output of git show-ref.
+
+    \param dereference If true the annotated tags are followed by the commit they point to, like git show-ref -d.
+    \return The result of the command.
+   */
+   GitExecResult getReferences(bool dereference) const;
+   /*!
+    \brief Returns the branches, the remote branches and the tags of the repository in a single pass of git
+    for-each-ref: a line per reference with the fields of \ref ReferenceField separated by NUL. The peeled SHA is the
+    object an annotated tag points to, so the tags don't take a second line like in git show-ref -d.
+
+    \param tracking If true the local branches have how far they are from their upstream. Git walks the history for
+    it, so without it the references are read from the repository files when the built-in reader is enabled.
+    \return The result of the command.
+   */
+   GitExecResult getReferenceRecords(bool tracking) const;
+
+   /*!
+    \brief The fields of the records of \ref getReferenceRecords.
+   */
+   enum ReferenceField
+   {
+      RefNameField,
+      KindField,
+      ShortNameField,
+      ShaField,
+      PeeledShaField,
+      UpstreamTrackField,
+      ReferenceFieldsCount
+   };
+   /*!
+    \brief Returns the absolute path of the git directory, or an empty string if it's not a repository.
+   */
+   QString getGitDir() const;
+   /*!
+    \brief Enables or disables the built-in reader for a read operation. When it's enabled, the operation reads the
+    files of the repository directly and it only starts git if the reader can't answer. It's enabled by default.
+
+    \param operation The read operation.
+    \param enabled True to use the built-in reader.
+   */
+   void setBuiltinRead(ReadOperation operation, bool enabled);
+   /*!
+    \brief Returns the configuration of the repository as git reads it: the system, global, local and work tree
+    files. It's loaded with a single git config process and kept until one of its files changes, so the lookups don't
+    start git. It can be called from any thread.
+
+    \return The configuration. It's empty if git can't read it.
+   */
+   QSharedPointer<const GitConfigSnapshot> getConfig() const;
+   /*!
+    \brief Forgets the configuration loaded, so the next \ref getConfig reads it again. The changes are noticed
+    through the files anyway, but two writes in the same millisecond could keep the size and the time of a file.
+   */
+   void invalidateConfig() const;
 
 protected:
    QString mWorkingDirectory;
    QString mCurrentBranch;
+
+private:
+   QString mRepositoryGroup;
+   QString mRepositoryId;
+   QSharedPointer<GitProcessScheduler> mScheduler;
+   int mBuiltinReads = static_cast<int>(ReadOperation::Head) | static_cast<int>(ReadOperation::References)
+       | static_cast<int>(ReadOperation::GitDirectory);
+
+   mutable QMutex mMemoMutex;
+   mutable QByteArray mMemoStamp;
+   mutable QHash<QString, GitExecResult> mMemo;
+
+   mutable QMutex mConfigMutex;
+   mutable QSharedPointer<const GitConfigSnapshot> mConfig;
+   mutable QStringList mConfigFiles;
+   mutable QByteArray mConfigStamp;
+
+   bool usesBuiltinRead(ReadOperation operation) const
+   {
+      return (mBuiltinReads & static_cast<int>(operation)) && !GitRecorder::instance().isActive();
+   }
+   QByteArray getRepositoryStamp() const;
 };
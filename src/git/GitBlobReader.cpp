@@ -0,0 +1,183 @@
+#include "GitBlobReader.h"
+
+#include <GitBase.h>
+#include <GitRecorder.h>
+
+#include <QLogger.h>
+
+#include <QProcess>
+
+using namespace QLogger;
+
+QHash<GitBase *, QWeakPointer<GitBlobReader>> &GitBlobReader::readers()
+{
+   static QHash<GitBase *, QWeakPointer<GitBlobReader>> readers;
+   return readers;
+}
+
+QSharedPointer<GitBlobReader> GitBlobReader::instance(const QSharedPointer<GitBase> &gitBase)
+{
+   auto reader = readers().value(gitBase.data()).toStrongRef();
+
+   if (!reader)
+   {
+      // The reader is deleted later: the last widget that keeps it might go away while handling one of its signals.
+      reader = QSharedPointer<GitBlobReader>(new GitBlobReader(gitBase), &QObject::deleteLater);
+      readers().insert(gitBase.data(), reader);
+   }
+
+   return reader;
+}
+
+GitBlobReader::GitBlobReader(const QSharedPointer<GitBase> &gitBase)
+   : mGitBase(gitBase)
+{
+   mContents.option = "--batch";
+   mInfo.option = "--batch-check";
+
+   connect(mGitBase.data(), &GitBase::cancelAllProcesses, this, &GitBlobReader::stopAll);
+}
+
+GitBlobReader::~GitBlobReader()
+{
+   close(mContents);
+   close(mInfo);
+
+   if (const auto iter = readers().find(mGitBase.data()); iter != readers().end() && !iter.value().toStrongRef())
+      readers().erase(iter);
+}
+
+int GitBlobReader::read(const QString &object)
+{
+   QLog_Debug("Git", QString("Reading the object {%1}").arg(object));
+
+   return request(mContents, object);
+}
+
+int GitBlobReader::readInfo(const QString &object)
+{
+   QLog_Debug("Git", QString("Reading the information of the object {%1}").arg(object));
+
+   return request(mInfo, object);
+}
+
+int GitBlobReader::request(Channel &channel, const QString &object)
+{
+   const auto id = ++mLastRequest;
+
+   if (!channel.process && !start(channel))
+   {
+      // The id is returned first, so the callers know it when the signal arrives.
+      QMetaObject::invokeMethod(this, [this, id]() { emit signalBlobMissing(id); }, Qt::QueuedConnection);
+      return id;
+   }
+
+   channel.pending.enqueue(id);
+   channel.process->write(object.toUtf8() + '\n');
+
+   return id;
+}
+
+bool GitBlobReader::start(Channel &channel)
+{
+   // The batch channel isn't in the recordings: the objects are missing while replaying.
+   if (GitRecorder::instance().isActive())
+      return false;
+
+   channel.process = new QProcess(this);
+   channel.process->setWorkingDirectory(mGitBase->getWorkingDir());
+
+   connect(channel.process, &QProcess::readyReadStandardOutput, this, [this, &channel]() { onReadyRead(channel); });
+   connect(channel.process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this,
+           [this, &channel]() { stop(channel); });
+
+   channel.process->start("git", { "cat-file", channel.option });
+
+   if (!channel.process->waitForStarted())
+   {
+      QLog_Warning("Git", QString("The process git cat-file %1 couldn't be started.").arg(channel.option));
+
+      delete channel.process;
+      channel.process = nullptr;
+
+      return false;
+   }
+
+   return true;
+}
+
+void GitBlobReader::stop(Channel &channel)
+{
+   if (channel.process)
+   {
+      channel.process->disconnect(this);
+      channel.process->kill();
+      channel.process->deleteLater();
+      channel.process = nullptr;
+   }
+
+   channel.buffer.clear();
+
+   while (!channel.pending.isEmpty())
+      emit signalBlobMissing(channel.pending.dequeue());
+}
+
+void GitBlobReader::stopAll()
+{
+   stop(mContents);
+   stop(mInfo);
+}
+
+void GitBlobReader::close(Channel &channel)
+{
+   if (channel.process)
+   {
+      // The process ends by itself once its input is closed.
+      channel.process->disconnect(this);
+      channel.process->closeWriteChannel();
+      channel.process->waitForFinished(100);
+   }
+}
+
+void GitBlobReader::onReadyRead(Channel &channel)
+{
+   channel.buffer.append(channel.process->readAllStandardOutput());
+
+   // Every answer is a header line, "<sha> <type> <size>" or "<object> missing". With --batch the contents and a line
+   // break follow it when the object exists.
+   while (!channel.pending.isEmpty())
+   {
+      const auto headerEnd = channel.buffer.indexOf('\n');
+
+      if (headerEnd == -1)
+         return;
+
+      const auto header = channel.buffer.left(headerEnd);
+
+      if (header.endsWith(" missing") || header.endsWith(" ambiguous"))
+      {
+         channel.buffer.remove(0, headerEnd + 1);
+         emit signalBlobMissing(channel.pending.dequeue());
+         continue;
+      }
+
+      const auto fields = header.split(' ');
+      const auto size = fields.constLast().toLongLong();
+
+      if (&channel == &mInfo)
+      {
+         channel.buffer.remove(0, headerEnd + 1);
+         emit signalObjectInfo(channel.pending.dequeue(), QString::fromUtf8(fields.constFirst()),
+                               QString::fromUtf8(fields.value(1)), size);
+         continue;
+      }
+
+      if (channel.buffer.size() < headerEnd + 1 + size + 1)
+         return;
+
+      const auto contents = channel.buffer.mid(headerEnd + 1, static_cast<int>(size));
+      channel.buffer.remove(0, headerEnd + 1 + static_cast<int>(size) + 1);
+
+      emit signalBlobRead(channel.pending.dequeue(), contents);
+   }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+class GitBase;
+class QProcess;
+
+/*!
+ \brief The GitBlobReader reads Git objects through git cat-file processes that stay open between requests, so
+ reading a blob or the type and size of an object doesn't cost a new process. There is a single reader per repository,
+ shared by all the widgets that read the objects of that repository, and it lives while any of them keeps it.
+
+ The contents are read with git cat-file --batch and the information with git cat-file --batch-check, each process
+ started with the first request it gets. The answers are framed by the size that Git gives, so the contents may be
+ binary, and they arrive asynchronously, in the same order as the requests. Every request gets an id that the signals
+ carry, so every widget only takes its own answers.
+
+ \class GitBlobReader GitBlobReader.h "GitBlobReader.h"
+*/
+class GitBlobReader : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the contents of an object have been read.
+
+    \param request The id of the request given by \ref read.
+    \param contents The contents of the object.
+   */
+   void signalBlobRead(int request, const QByteArray &contents);
+   /*!
+    \brief Signal triggered when the information of an object has been read.
+
+    \param request The id of the request given by \ref readInfo.
+    \param id The SHA of the object.
+    \param type The type of the object: "blob", "tree", "commit" or "tag".
+    \param size The size of the object in bytes.
+   */
+   void signalObjectInfo(int request, const QString &id, const QString &type, qint64 size);
+   /*!
+    \brief Signal triggered when an object can't be read, because it doesn't exist or because the process stopped.
+
+    \param request The id of the request.
+   */
+   void signalBlobMissing(int request);
+
+public:
+   /*!
+    \brief Returns the reader of a repository. It is created if no one keeps it.
+
+    \param gitBase The git object of the repository.
+    \return The reader.
+   */
+   static QSharedPointer<GitBlobReader> instance(const QSharedPointer<GitBase> &gitBase);
+   /*!
+    \brief Destructor. It closes the processes.
+   */
+   ~GitBlobReader() override;
+
+   /*!
+    \brief Requests the contents of an object.
+
+    \param object The object in any format that Git accepts, usually "<sha>:<path>".
+    \return The id of the request.
+   */
+   int read(const QString &object);
+   /*!
+    \brief Requests the type and the size of an object, without reading its contents.
+
+    \param object The object in any format that Git accepts, usually "<sha>:<path>".
+    \return The id of the request.
+   */
+   int readInfo(const QString &object);
+
+private:
+   /*!
+    \brief One of the git cat-file processes with the requests waiting for an answer.
+   */
+   struct Channel
+   {
+      QString option;
+      QProcess *process = nullptr;
+      QQueue<int> pending;
+      QByteArray buffer;
+   };
+
+   QSharedPointer<GitBase> mGitBase;
+   Channel mContents;
+   Channel mInfo;
+   int mLastRequest = 0;
+
+   explicit GitBlobReader(const QSharedPointer<GitBase> &gitBase);
+
+   static QHash<GitBase *, QWeakPointer<GitBlobReader>> &readers();
+   int request(Channel &channel, const QString &object);
+   bool start(Channel &channel);
+   void stop(Channel &channel);
+   void stopAll();
+   void close(Channel &channel);
+   void onReadyRead(Channel &channel);
+};
@@ -32,11 +32,10 @@ GitExecResult GitBranches::getDistanceBetweenBranches(bool toMaster, const QStri
       return { false, "Same branch" };
    else
    {
-      const auto gitBase = new GitBase(mGitBase->getWorkingDir());
       const auto gitCmd = QString("git rev-list --left-right --count %1/%2...%3")
                               .arg(ret.output.toString(), toMaster ? QString("master") : right, right);
 
-      return gitBase->run(gitCmd);
+      return mGitBase->run(gitCmd);
    }
 }
 
@@ -1,5 +1,7 @@
 #include "GitCloneProcess.h"
 
+#include <cstring>
+
 GitCloneProcess::GitCloneProcess(const QString &workingDir)
    : AGitProcess(workingDir)
 {
@@ -16,26 +18,92 @@ void GitCloneProcess::onReadyStandardError()
 {
    if (!mCanceling)
    {
-      const auto err = readAllStandardError();
-      const auto errStr = QString::fromUtf8(err);
-      mErrorOutput += errStr;
+      mPendingLine.append(readAllStandardError());
+      parsePendingLines();
+   }
+}
+
+void GitCloneProcess::parsePendingLines()
+{
+   const auto data = mPendingLine.constData();
+   const auto size = mPendingLine.size();
+   auto start = 0;
 
-      if (!errStr.startsWith("remote: "))
+   for (auto i = 0; i < size; ++i)
+   {
+      if (data[i] == '\r' || data[i] == '\n')
       {
-         auto infoList = errStr.split(",", QString::SkipEmptyParts).first().split(":");
-         const auto stepDesc = infoList.takeFirst();
-         auto value = -1;
+         parseLine(data + start, i - start);
+         start = i + 1;
+      }
+   }
+
+   mPendingLine.remove(0, start);
+}
+
+void GitCloneProcess::parseLine(const char *line, int length)
+{
+   if (length == 0)
+      return;
+
+   static constexpr char remotePrefix[] = "remote: ";
+   static constexpr int remotePrefixLength = sizeof(remotePrefix) - 1;
+
+   const auto fromRemote = length >= remotePrefixLength && memcmp(line, remotePrefix, remotePrefixLength) == 0;
+   const auto begin = fromRemote ? line + remotePrefixLength : line;
+   const auto end = line + length;
+   const auto colon = static_cast<const char *>(memchr(begin, ':', end - begin));
+   auto value = -1;
+
+   if (colon)
+   {
+      auto current = colon + 1;
 
-         if (!infoList.isEmpty())
-            value = infoList.takeFirst().split("% ").first().trimmed().toInt();
+      while (current < end && *current == ' ')
+         ++current;
 
-         emit signalProgress(stepDesc, value);
+      auto number = 0;
+      auto digits = 0;
+
+      for (; current < end && *current >= '0' && *current <= '9' && digits < 3; ++current, ++digits)
+         number = number * 10 + (*current - '0');
+
+      if (digits > 0 && current < end && *current == '%')
+         value = number;
+   }
+
+   if (value >= 0)
+   {
+      const auto stepLength = static_cast<int>(colon - begin);
+
+      const auto sameStep = mLastStep.size() == stepLength && memcmp(mLastStep.constData(), begin, stepLength) == 0;
+
+      if (value != mLastValue || !sameStep)
+      {
+         mLastStep = QByteArray(begin, stepLength);
+         mLastValue = value;
+
+         emit signalProgress(QString::fromUtf8(mLastStep), value);
       }
    }
+   else if (!fromRemote)
+   {
+      mErrorOutput.append(line, length).append('\n');
+
+      emit signalProgress(QString::fromUtf8(line, length), -1);
+   }
 }
 
 void GitCloneProcess::onFinished(int code, QProcess::ExitStatus exitStatus)
 {
+   if (!mCanceling)
+   {
+      mPendingLine.append(readError());
+      parsePendingLines();
+      parseLine(mPendingLine.constData(), mPendingLine.size());
+      mPendingLine.clear();
+   }
+
    AGitProcess::onFinished(code, exitStatus);
 
    if (!mCanceling)
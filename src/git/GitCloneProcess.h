@@ -38,6 +38,22 @@ public:
    GitExecResult run(const QString &command) override;
 
 private:
+   // The end of the output that doesn't form a line yet: a read can stop in the middle of one.
+   QByteArray mPendingLine;
+   QByteArray mLastStep;
+   int mLastValue = -1;
+
    void onReadyStandardError();
+   /*!
+    \brief Parses the lines in the pending output and keeps the incomplete one. git rewrites the progress of a step
+    ending its lines with '\r' and ends the step with '\n'.
+   */
+   void parsePendingLines();
+   /*!
+    \brief Parses a line like "Receiving objects:  45% (450/1000), 1.20 MiB | 2.00 MiB/s" without splitting it. The
+    progress is emitted only when the step or its percentage change, not for every update of the counters. The lines
+    that aren't progress are kept as the error output, except the messages of the remote.
+   */
+   void parseLine(const char *line, int length);
    void onFinished(int, QProcess::ExitStatus exitStatus) override;
 };
@@ -0,0 +1,96 @@
+#include "GitCommandGraph.h"
+
+#include <GitSyncProcess.h>
+
+#include <QLogger.h>
+
+#include <algorithm>
+#include <memory>
+
+using namespace QLogger;
+
+GitCommandGraph::GitCommandGraph(const QString &workingDir)
+   : mWorkingDir(workingDir)
+{
+}
+
+int GitCommandGraph::addCommand(const QString &command)
+{
+   return addCommand([command](const QVector<GitExecResult> &) { return command; }, {});
+}
+
+int GitCommandGraph::addCommand(const CommandBuilder &builder, const QVector<int> &dependencies)
+{
+   Node node;
+   node.builder = builder;
+   node.dependencies = dependencies;
+
+   mNodes.append(node);
+
+   return mNodes.count() - 1;
+}
+
+void GitCommandGraph::run()
+{
+   auto pending = mNodes.count();
+
+   while (pending > 0)
+   {
+      QVector<int> ready;
+
+      for (auto i = 0; i < mNodes.count(); ++i)
+      {
+         const auto &node = mNodes.at(i);
+
+         if (!node.done
+             && std::all_of(node.dependencies.cbegin(), node.dependencies.cend(),
+                            [this](int dependency) { return mNodes.at(dependency).done; }))
+         {
+            ready.append(i);
+         }
+      }
+
+      if (ready.isEmpty())
+      {
+         QLog_Error("Git", QString("The command graph has cyclic dependencies."));
+         return;
+      }
+
+      QVector<QPair<int, std::shared_ptr<GitSyncProcess>>> processes;
+
+      for (auto id : qAsConst(ready))
+      {
+         auto &node = mNodes[id];
+         QVector<GitExecResult> dependencies;
+
+         for (auto dependency : qAsConst(node.dependencies))
+            dependencies.append(mNodes.at(dependency).result);
+
+         const auto command = node.builder(dependencies);
+
+         if (command.isEmpty())
+         {
+            node.done = true;
+            --pending;
+         }
+         else
+         {
+            const auto process = std::make_shared<GitSyncProcess>(mWorkingDir);
+            process->launch(command);
+
+            processes.append(qMakePair(id, process));
+         }
+      }
+
+      for (const auto &process : qAsConst(processes))
+      {
+         auto &node = mNodes[process.first];
+         node.result = process.second->waitForResult();
+         node.done = true;
+         --pending;
+
+         if (!node.result.success)
+            QLog_Warning("Git", QString("Git command has errors:\n%1").arg(node.result.output.toString()));
+      }
+   }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/*!
+ \brief The GitCommandGraph runs a set of git commands where some of them can depend on the result of others. All the
+ commands whose dependencies are already resolved are started at the same time and the graph waits for all of them
+ before starting the next ones. That way, the time needed to run independent commands is bounded by the slowest one
+ instead of the sum of all of them.
+
+ The commands are run synchronously from the point of view of the caller: run() returns when all of them finished.
+
+ \class GitCommandGraph GitCommandGraph.h "GitCommandGraph.h"
+*/
+class GitCommandGraph
+{
+public:
+   /*!
+    \brief Builds the command of a node from the results of its dependencies. If it returns an empty string, the node is
+    not executed and its result is unsuccessful.
+   */
+   using CommandBuilder = std::function<QString(const QVector<GitExecResult> &dependencies)>;
+
+   /*!
+    \brief Default constructor.
+
+    \param workingDir The directory where the commands are executed.
+   */
+   explicit GitCommandGraph(const QString &workingDir);
+
+   /*!
+    \brief Adds a command that doesn't depend on any other.
+
+    \param command The command to execute.
+    \return The id of the node, used to get its result or to make other nodes depend on it.
+   */
+   int addCommand(const QString &command);
+   /*!
+    \brief Adds a command that is built once the results of its dependencies are available.
+
+    \param builder The function that builds the command.
+    \param dependencies The ids of the nodes this command depends on.
+    \return The id of the node, used to get its result or to make other nodes depend on it.
+   */
+   int addCommand(const CommandBuilder &builder, const QVector<int> &dependencies);
+
+   /*!
+    \brief Runs all the commands of the graph.
+   */
+   void run();
+
+   /*!
+    \brief Returns the result of the node with the given id. It's only valid after run().
+
+    \param id The id of the node.
+    \return The result of the execution.
+   */
+   GitExecResult result(int id) const { return mNodes.at(id).result; }
+
+private:
+   struct Node
+   {
+      CommandBuilder builder;
+      QVector<int> dependencies;
+      GitExecResult result { false, QString() };
+      bool done = false;
+   };
+
+   QString mWorkingDir;
+   QVector<Node> mNodes;
+};
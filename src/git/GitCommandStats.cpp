@@ -0,0 +1,153 @@
+#include "GitCommandStats.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QStringList>
+
+GitCommandStats &GitCommandStats::instance()
+{
+   static GitCommandStats stats;
+
+   return stats;
+}
+
+void GitCommandStats::record(const QString &command, const Sample &sample)
+{
+   const auto key = commandTemplate(command);
+
+   QMutexLocker lock(&mMutex);
+
+   auto &entry = mEntries[key];
+   entry.command = key;
+   ++entry.count;
+   entry.totalSpawnMs += sample.spawnMs;
+   entry.totalWallMs += sample.wallMs;
+   entry.maxWallMs = qMax(entry.maxWallMs, sample.wallMs);
+   entry.totalOutputBytes += sample.outputBytes;
+   ++entry.histogram[bucket(sample.wallMs)];
+
+   if (!sample.success)
+      ++entry.failures;
+
+   if (sample.firstByteMs >= 0)
+   {
+      entry.totalFirstByteMs += sample.firstByteMs;
+      ++entry.firstByteCount;
+   }
+}
+
+QVector<GitCommandStats::Entry> GitCommandStats::entries() const
+{
+   QMutexLocker lock(&mMutex);
+
+   return mEntries.values().toVector();
+}
+
+void GitCommandStats::clear()
+{
+   QMutexLocker lock(&mMutex);
+
+   mEntries.clear();
+}
+
+QString GitCommandStats::toCsv() const
+{
+   QStringList header { "command",         "count",       "failures",      "total_spawn_ms", "total_first_byte_ms",
+                        "first_byte_count", "total_wall_ms", "max_wall_ms", "total_output_bytes" };
+
+   for (auto i = 0; i < HISTOGRAM_BUCKETS; ++i)
+      header.append(bucketLabel(i));
+
+   QString csv = header.join(',') + '\n';
+
+   for (const auto &entry : entries())
+   {
+      auto command = entry.command;
+      command.replace('"', "\"\"");
+
+      QStringList row { QString("\"%1\"").arg(command),
+                        QString::number(entry.count),
+                        QString::number(entry.failures),
+                        QString::number(entry.totalSpawnMs),
+                        QString::number(entry.totalFirstByteMs),
+                        QString::number(entry.firstByteCount),
+                        QString::number(entry.totalWallMs),
+                        QString::number(entry.maxWallMs),
+                        QString::number(entry.totalOutputBytes) };
+
+      for (const auto count : entry.histogram)
+         row.append(QString::number(count));
+
+      csv.append(row.join(',') + '\n');
+   }
+
+   return csv;
+}
+
+QByteArray GitCommandStats::toJson() const
+{
+   QJsonArray array;
+
+   for (const auto &entry : entries())
+   {
+      QJsonArray histogram;
+
+      for (auto i = 0; i < HISTOGRAM_BUCKETS; ++i)
+         histogram.append(QJsonObject { { "bucket", bucketLabel(i) }, { "count", entry.histogram.at(i) } });
+
+      array.append(QJsonObject { { "command", entry.command },
+                                 { "count", entry.count },
+                                 { "failures", entry.failures },
+                                 { "totalSpawnMs", entry.totalSpawnMs },
+                                 { "totalFirstByteMs", entry.totalFirstByteMs },
+                                 { "firstByteCount", entry.firstByteCount },
+                                 { "totalWallMs", entry.totalWallMs },
+                                 { "maxWallMs", entry.maxWallMs },
+                                 { "totalOutputBytes", entry.totalOutputBytes },
+                                 { "histogram", histogram } });
+   }
+
+   return QJsonDocument(array).toJson();
+}
+
+QString GitCommandStats::commandTemplate(const QString &command)
+{
+   const auto parts = command.split(' ', QString::SkipEmptyParts);
+   QStringList templateParts;
+
+   for (const auto &part : parts)
+   {
+      // The program and the subcommand are always kept. The rest of the words without dash are values.
+      if (templateParts.count() < 2 && !part.startsWith('-'))
+         templateParts.append(part);
+      else if (part == "--")
+         break;
+      else if (part.startsWith('-'))
+      {
+         const auto option = part.left(part.indexOf('='));
+
+         if (!templateParts.contains(option))
+            templateParts.append(option);
+      }
+   }
+
+   return templateParts.join(' ');
+}
+
+int GitCommandStats::bucket(qint64 ms)
+{
+   auto bucket = 0;
+
+   for (auto limit = 1LL; bucket < HISTOGRAM_BUCKETS - 1 && ms >= limit; limit *= 2)
+      ++bucket;
+
+   return bucket;
+}
+
+QString GitCommandStats::bucketLabel(int bucket)
+{
+   return bucket < HISTOGRAM_BUCKETS - 1 ? QString("< %1 ms").arg(1LL << bucket)
+                                         : QString(">= %1 ms").arg(1LL << (HISTOGRAM_BUCKETS - 2));
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/*!
+ \brief The GitCommandStats collects the timings of every git process run by GitQlient, grouped by the template of the
+ command: git, the subcommand and the options, without the values that change between calls (paths, SHAs, etc.). For
+ every template it keeps the number of runs and failures, the total and maximum times, the output size and a histogram
+ of the wall time in buckets that double their size.
+
+ Recording a sample only takes a lock and updates a few counters, so it's always enabled. The statistics are shared by
+ all the repositories and threads.
+
+ \class GitCommandStats GitCommandStats.h "GitCommandStats.h"
+*/
+class GitCommandStats
+{
+public:
+   /*!
+    \brief The number of buckets of the histograms. The first one counts the runs below 1 ms, the bucket i the runs
+    up to 2^i ms and the last one all the rest.
+   */
+   static constexpr int HISTOGRAM_BUCKETS = 14;
+
+   /*!
+    \brief The measures of a single run of git.
+   */
+   struct Sample
+   {
+      qint64 spawnMs = 0;
+      qint64 firstByteMs = -1;
+      qint64 wallMs = 0;
+      qint64 outputBytes = 0;
+      bool success = false;
+   };
+
+   /*!
+    \brief The aggregated measures of all the runs of a command template.
+   */
+   struct Entry
+   {
+      QString command;
+      qint64 count = 0;
+      qint64 failures = 0;
+      qint64 totalSpawnMs = 0;
+      qint64 totalFirstByteMs = 0;
+      qint64 firstByteCount = 0;
+      qint64 totalWallMs = 0;
+      qint64 maxWallMs = 0;
+      qint64 totalOutputBytes = 0;
+      QVector<qint64> histogram = QVector<qint64>(HISTOGRAM_BUCKETS, 0);
+   };
+
+   /*!
+    \brief Returns the statistics of the application.
+   */
+   static GitCommandStats &instance();
+
+   /*!
+    \brief Adds a run of git to the statistics of its command template.
+
+    \param command The command as it was run.
+    \param sample The measures.
+   */
+   void record(const QString &command, const Sample &sample);
+   /*!
+    \brief Returns the statistics of every command template, sorted by the template.
+   */
+   QVector<Entry> entries() const;
+   /*!
+    \brief Removes all the statistics.
+   */
+   void clear();
+
+   /*!
+    \brief Exports the statistics as CSV, with a header row and a column for every bucket of the histogram.
+   */
+   QString toCsv() const;
+   /*!
+    \brief Exports the statistics as a JSON array with an object for every template.
+   */
+   QByteArray toJson() const;
+
+   /*!
+    \brief Returns the template of a command: the program, the subcommand and the options without their values.
+
+    \param command The command.
+    \return The template.
+   */
+   static QString commandTemplate(const QString &command);
+   /*!
+    \brief Returns the bucket of the histogram for a time.
+
+    \param ms The time in milliseconds.
+    \return The bucket.
+   */
+   static int bucket(qint64 ms);
+   /*!
+    \brief Returns the description of a bucket, for instance "< 8 ms".
+
+    \param bucket The bucket.
+    \return The description.
+   */
+   static QString bucketLabel(int bucket);
+
+private:
+   mutable QMutex mMutex;
+   QMap<QString, Entry> mEntries;
+
+   GitCommandStats() = default;
+};
@@ -0,0 +1,74 @@
+#include "GitCommitDetails.h"
+
+#include <CommitInfo.h>
+#include <GitBase.h>
+#include <GitRepoLoader.h>
+#include <RevisionsCache.h>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+GitCommitDetails::GitCommitDetails(const QSharedPointer<GitBase> &gitBase, const QSharedPointer<RevisionsCache> &cache,
+                                   QObject *parent)
+   : QObject(parent)
+   , mGitBase(gitBase)
+   , mCache(cache)
+{
+}
+
+GitCommitDetails::~GitCommitDetails()
+{
+   for (const auto request : qAsConst(mRequests))
+      mGitBase->cancel(request);
+}
+
+void GitCommitDetails::request(const QVector<ObjectId> &shas)
+{
+   // The commits are listed in the order they are given, without walking their history.
+   QStringList arguments { "log",           "--no-walk=unsorted",
+                           "--no-color",    "--log-size",
+                           "--parents",     "-z",
+                           QString("--pretty=format:%1").arg(GitRepoLoader::GIT_LOG_FORMAT) };
+   const auto fixedArguments = arguments.count();
+
+   for (const auto &sha : shas)
+   {
+      if (!mRequested.contains(sha))
+      {
+         mRequested.insert(sha);
+         arguments.append(sha.toString());
+      }
+   }
+
+   if (arguments.count() == fixedArguments)
+      return;
+
+   QLog_Trace("Git", QString("Reading the details of {%1} commits.").arg(arguments.count() - fixedArguments));
+
+   const auto request = mGitBase->runAsync(
+       arguments, this,
+       [this](const GitExecResult &result) {
+          if (!result.success)
+             return;
+
+          const auto records = CommitInfo::splitRecords(result.output.toByteArray());
+          QVector<CommitInfo> details;
+          details.reserve(records.count());
+
+          for (const auto &record : records)
+          {
+             CommitInfo commit(record);
+
+             if (commit.isValid())
+                details.append(std::move(commit));
+          }
+
+          mCache->setCommitDetails(details);
+
+          emit signalDetailsLoaded();
+       },
+       GitBase::Priority::Interactive);
+
+   mRequests.append(request);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+
+class GitBase;
+class RevisionsCache;
+
+/*!
+ \brief The GitCommitDetails reads the authors, the dates and the logs of the commits that were loaded without them,
+ from the commit-graph or with only the topology of git log. Only the commits that are shown are asked to git, all of
+ them in a single git log --no-walk, and the cache gets them once git answers.
+
+ \class GitCommitDetails GitCommitDetails.h "GitCommitDetails.h"
+*/
+class GitCommitDetails : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the details of the commits requested have been stored in the cache.
+   */
+   void signalDetailsLoaded();
+
+public:
+   explicit GitCommitDetails(const QSharedPointer<GitBase> &gitBase, const QSharedPointer<RevisionsCache> &cache,
+                             QObject *parent = nullptr);
+   ~GitCommitDetails();
+
+   /*!
+    \brief Requests the details of the given commits. The commits that were already requested are not asked again.
+
+    \param shas The SHAs of the commits.
+   */
+   void request(const QVector<ObjectId> &shas);
+
+private:
+   QSharedPointer<GitBase> mGitBase;
+   QSharedPointer<RevisionsCache> mCache;
+   QSet<ObjectId> mRequested;
+   QVector<int> mRequests;
+};
@@ -2,15 +2,54 @@
 
 #include <GitBase.h>
 #include <GitCloneProcess.h>
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
 #include <QLogger.h>
 
 using namespace QLogger;
 
+namespace
+{
+GitUserInfo userInfoOf(const GitConfigSnapshot &config, GitConfigSnapshot::Scope scope)
+{
+   GitUserInfo userInfo;
+   userInfo.mUserName = config.value("user.name", scope).trimmed();
+   userInfo.mUserEmail = config.value("user.email", scope).trimmed();
+
+   return userInfo;
+}
+}
+
 bool GitUserInfo::isValid() const
 {
    return !mUserEmail.isNull() && !mUserEmail.isEmpty() && !mUserName.isNull() && !mUserName.isEmpty();
 }
 
+QString GitCloneOptions::toArguments() const
+{
+   QString arguments;
+
+   if (blobless)
+      arguments.append(" --filter=blob:none");
+
+   if (depth > 0)
+      arguments.append(QString(" --depth %1").arg(depth));
+
+   if (!shallowSince.isEmpty())
+      arguments.append(QString(" --shallow-since \"%1\"").arg(shallowSince));
+
+   if (singleBranch)
+      arguments.append(" --single-branch");
+
+   // Without --single-branch it's only the branch to check out, which also makes sense for a shallow clone.
+   if (!branch.isEmpty())
+      arguments.append(QString(" --branch %1").arg(branch));
+
+   return arguments;
+}
+
 GitConfig::GitConfig(QSharedPointer<GitBase> gitBase, QObject *parent)
    : QObject(parent)
    , mGitBase(gitBase)
@@ -19,21 +58,9 @@ GitConfig::GitConfig(QSharedPointer<GitBase> gitBase, QObject *parent)
 
 GitUserInfo GitConfig::getGlobalUserInfo() const
 {
-   GitUserInfo userInfo;
-
    QLog_Debug("Git", QString("Getting global user info"));
 
-   const auto nameRequest = mGitBase->run("git config --get --global user.name");
-
-   if (nameRequest.success)
-      userInfo.mUserName = nameRequest.output.toString().trimmed();
-
-   const auto emailRequest = mGitBase->run("git config --get --global user.email");
-
-   if (emailRequest.success)
-      userInfo.mUserEmail = emailRequest.output.toString().trimmed();
-
-   return userInfo;
+   return userInfoOf(*mGitBase->getConfig(), GitConfigSnapshot::Scope::Global);
 }
 
 void GitConfig::setGlobalUserInfo(const GitUserInfo &info)
@@ -42,32 +69,24 @@ void GitConfig::setGlobalUserInfo(const GitUserInfo &info)
 
    mGitBase->run(QString("git config --global user.name \"%1\"").arg(info.mUserName));
    mGitBase->run(QString("git config --global user.email %1").arg(info.mUserEmail));
+   mGitBase->invalidateConfig();
 }
 
 GitExecResult GitConfig::setGlobalData(const QString &key, const QString &value)
 {
    QLog_Debug("Git", QString("Configuring global key {%1} with value {%2}").arg(key, value));
 
-   return mGitBase->run(QString("git config --global %1 \"%2\"").arg(key, value));
+   const auto ret = mGitBase->run(QString("git config --global %1 \"%2\"").arg(key, value));
+   mGitBase->invalidateConfig();
+
+   return ret;
 }
 
 GitUserInfo GitConfig::getLocalUserInfo() const
 {
    QLog_Debug("Git", QString("Getting local user info"));
 
-   GitUserInfo userInfo;
-
-   const auto nameRequest = mGitBase->run("git config --get --local user.name");
-
-   if (nameRequest.success)
-      userInfo.mUserName = nameRequest.output.toString().trimmed();
-
-   const auto emailRequest = mGitBase->run("git config --get --local user.email");
-
-   if (emailRequest.success)
-      userInfo.mUserEmail = emailRequest.output.toString().trimmed();
-
-   return userInfo;
+   return userInfoOf(*mGitBase->getConfig(), GitConfigSnapshot::Scope::Local);
 }
 
 void GitConfig::setLocalUserInfo(const GitUserInfo &info)
@@ -76,6 +95,7 @@ void GitConfig::setLocalUserInfo(const GitUserInfo &info)
 
    mGitBase->run(QString("git config --local user.name \"%1\"").arg(info.mUserName));
    mGitBase->run(QString("git config --local user.email %1").arg(info.mUserEmail));
+   mGitBase->invalidateConfig();
 }
 
 GitExecResult GitConfig::setLocalData(const QString &key, const QString &value)
@@ -83,11 +103,16 @@ GitExecResult GitConfig::setLocalData(const QString &key, const QString &value)
 
    QLog_Debug("Git", QString("Configuring local key {%1} with value {%2}").arg(key, value));
 
-   return mGitBase->run(QString("git config --local %1 \"%2\"").arg(key, value));
+   const auto ret = mGitBase->run(QString("git config --local %1 \"%2\"").arg(key, value));
+   mGitBase->invalidateConfig();
+
+   return ret;
 }
 
-GitExecResult GitConfig::clone(const QString &url, const QString &fullPath)
+GitExecResult GitConfig::clone(const QString &url, const QString &fullPath, const GitCloneOptions &options)
 {
+   const auto arguments = options.toArguments();
+
    QLog_Debug("Git", QString("Starting the clone process for repo {%1} at {%2}.").arg(url, fullPath));
 
    const auto asyncRun = new GitCloneProcess(mGitBase->getWorkingDir());
@@ -95,7 +120,7 @@ GitExecResult GitConfig::clone(const QString &url, const QString &fullPath)
 
    mGitBase->setWorkingDir(fullPath);
 
-   return asyncRun->run(QString("git clone --progress %1 %2").arg(url, fullPath));
+   return asyncRun->run(QString("git clone --progress%1 %2 %3").arg(arguments, url, fullPath));
 }
 
 GitExecResult GitConfig::initRepo(const QString &fullPath)
@@ -114,40 +139,73 @@ GitExecResult GitConfig::getLocalConfig() const
 {
    QLog_Debug("Git", QString("Getting local config"));
 
-   return mGitBase->run("git config --local --list");
+   return { true, mGitBase->getConfig()->toList(GitConfigSnapshot::Scope::Local) };
 }
 
 GitExecResult GitConfig::getGlobalConfig() const
 {
    QLog_Debug("Git", QString("Getting global config"));
 
-   return mGitBase->run("git config --global --list");
+   return { true, mGitBase->getConfig()->toList(GitConfigSnapshot::Scope::Global) };
 }
 
 GitExecResult GitConfig::getRemoteForBranch(const QString &branch)
 {
    QLog_Debug("Git", QString("Getting remote for branch {%1}.").arg(branch));
 
-   const auto config = getLocalConfig();
+   const auto remote
+       = mGitBase->getConfig()->value(QString("branch.%1.remote").arg(branch), GitConfigSnapshot::Scope::Local);
 
-   if (config.success)
+   if (!remote.isEmpty())
+      return { true, remote };
+
+   return GitExecResult();
+}
+
+bool GitConfig::isFsmonitorEnabled() const
+{
+   // The value is either a boolean or the path of a hook.
+   const auto config = mGitBase->getConfig();
+
+   return config->contains("core.fsmonitor") && config->boolValue("core.fsmonitor", true);
+}
+
+bool GitConfig::enableFsmonitor()
+{
+   QLog_Debug("Git", QString("Enabling the file system monitor."));
+
+   QString fsmonitor;
+
+   // The versions of git without the daemon don't know the command.
+   if (const auto daemon = mGitBase->run("git fsmonitor--daemon status");
+       !daemon.output.toString().contains("is not a git command"))
    {
-      const auto values = config.output.toString().split('\n', QString::SkipEmptyParts);
-      const auto configKey = QString("branch.%1.remote=").arg(branch);
-      QString configValue;
+      fsmonitor = QString("true");
+   }
+   else if (!QStandardPaths::findExecutable("watchman").isEmpty())
+   {
+      const auto hooksDir = QDir(mGitBase->getGitDir()).filePath("hooks");
+      const auto hook = QDir(hooksDir).filePath("fsmonitor-watchman");
 
-      for (const auto &value : values)
+      if (!QFile::exists(hook))
       {
-         if (value.startsWith(configKey))
-         {
-            configValue = value.split("=").last();
-            break;
-         }
+         QFile::copy(QDir(hooksDir).filePath("fsmonitor-watchman.sample"), hook);
+         QFile::setPermissions(hook, QFile::permissions(hook) | QFile::ExeOwner | QFile::ExeGroup | QFile::ExeOther);
       }
 
-      if (!configValue.isEmpty())
-         return { true, configValue };
+      if (QFile::exists(hook))
+         fsmonitor = hook;
    }
 
-   return GitExecResult();
+   if (fsmonitor.isEmpty())
+   {
+      QLog_Warning("Git", QString("There is no file system monitor available."));
+      return false;
+   }
+
+   const auto enabled = mGitBase->run({ "config", "core.fsmonitor", fsmonitor }).success
+       && mGitBase->run({ "config", "core.untrackedCache", "true" }).success;
+   mGitBase->invalidateConfig();
+
+   return enabled;
 }
@@ -39,6 +39,36 @@ struct GitUserInfo
    bool isValid() const;
 };
 
+/*!
+ \brief The options of a clone that download less than the whole repository. By default the clone is complete.
+*/
+struct GitCloneOptions
+{
+   /*!
+    \brief Downloads the commits and trees but not the file contents (--filter=blob:none). Git fetches the blobs
+    from the remote when they're needed: the checkout, a diff or a blame.
+   */
+   bool blobless = false;
+   /*!
+    \brief Number of commits of history to download (--depth). Zero means the whole history.
+   */
+   int depth = 0;
+   /*!
+    \brief Downloads only the history after this date (--shallow-since). Ignored when empty.
+   */
+   QString shallowSince;
+   /*!
+    \brief Downloads only the history of one branch (--single-branch): the one in branch or the default one.
+   */
+   bool singleBranch = false;
+   QString branch;
+
+   /*!
+    \brief Builds the arguments of git clone for the options.
+   */
+   QString toArguments() const;
+};
+
 class GitConfig : public QObject
 {
    Q_OBJECT
@@ -55,11 +85,23 @@ public:
    GitUserInfo getLocalUserInfo() const;
    void setLocalUserInfo(const GitUserInfo &info);
    GitExecResult setLocalData(const QString &key, const QString &value);
-   GitExecResult clone(const QString &url, const QString &fullPath);
+   GitExecResult clone(const QString &url, const QString &fullPath, const GitCloneOptions &options = {});
    GitExecResult initRepo(const QString &fullPath);
    GitExecResult getLocalConfig() const;
    GitExecResult getGlobalConfig() const;
    GitExecResult getRemoteForBranch(const QString &branch);
+   /*!
+    \brief Tells if git uses a file system monitor in the repository (core.fsmonitor), either its own daemon or a
+    hook like the one of Watchman. With it, git status only looks at the files that changed.
+   */
+   bool isFsmonitorEnabled() const;
+   /*!
+    \brief Enables a file system monitor and the untracked cache in the repository. It uses the daemon of git if the
+    version installed has it, otherwise Watchman through the sample hook of git.
+
+    \return True if a monitor was enabled.
+   */
+   bool enableFsmonitor();
 
 private:
    QSharedPointer<GitBase> mGitBase;
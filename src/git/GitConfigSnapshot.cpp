@@ -0,0 +1,176 @@
+#include "GitConfigSnapshot.h"
+
+#include <QDir>
+#include <QProcessEnvironment>
+
+namespace
+{
+QString cleanPath(const QString &workingDir, const QString &path)
+{
+   return QDir::cleanPath(QDir(workingDir).absoluteFilePath(path));
+}
+
+QStringList globalFiles()
+{
+   const auto environment = QProcessEnvironment::systemEnvironment();
+   auto xdgHome = environment.value("XDG_CONFIG_HOME");
+
+   if (xdgHome.isEmpty())
+      xdgHome = QDir::home().filePath(".config");
+
+   QStringList files { QDir::cleanPath(QDir::home().filePath(".gitconfig")),
+                       QDir::cleanPath(QDir(xdgHome).filePath("git/config")) };
+
+   if (const auto global = environment.value("GIT_CONFIG_GLOBAL"); !global.isEmpty())
+      files.append(QDir::cleanPath(global));
+
+   return files;
+}
+
+bool isTrue(const QString &value)
+{
+   return value == "true" || value == "yes" || value == "on" || value == "1";
+}
+
+bool isFalse(const QString &value)
+{
+   return value.isEmpty() || value == "false" || value == "no" || value == "off" || value == "0";
+}
+}
+
+GitConfigSnapshot::GitConfigSnapshot(const QByteArray &output, const QString &gitDir, const QString &commonDir,
+                                     const QString &workingDir)
+{
+   const auto localFile = cleanPath(workingDir, QDir(commonDir).filePath("config"));
+   const auto worktreeFile = cleanPath(workingDir, QDir(gitDir).filePath("config.worktree"));
+   const auto global = globalFiles();
+   const auto fields = output.split('\0');
+
+   // The included files don't have a scope of their own: they belong to the file that includes them, which is the
+   // last known one since git reads the files in order.
+   auto scope = Scope::System;
+
+   for (auto i = 0; i + 1 < fields.count(); i += 2)
+   {
+      const auto origin = QString::fromUtf8(fields.at(i));
+      const auto &keyValue = fields.at(i + 1);
+
+      if (origin.startsWith("file:"))
+      {
+         const auto file = cleanPath(workingDir, origin.mid(5));
+
+         if (file == localFile)
+            scope = Scope::Local;
+         else if (file == worktreeFile)
+            scope = Scope::Worktree;
+         else if (global.contains(file))
+            scope = Scope::Global;
+
+         if (!mFiles.contains(file))
+            mFiles.append(file);
+      }
+      else if (origin.startsWith("command line:"))
+         scope = Scope::Command;
+
+      Entry entry;
+      entry.scope = scope;
+      entry.origin = origin;
+
+      // A key without value, which git reads as true, has no line break.
+      if (const auto lineBreak = keyValue.indexOf('\n'); lineBreak != -1)
+      {
+         entry.key = QString::fromUtf8(keyValue.left(lineBreak));
+         entry.value = QString::fromUtf8(keyValue.mid(lineBreak + 1));
+
+         if (entry.value.isNull())
+            entry.value = QString("");
+      }
+      else
+         entry.key = QString::fromUtf8(keyValue);
+
+      mIndex[entry.key].append(mEntries.count());
+      mEntries.append(entry);
+   }
+}
+
+QString GitConfigSnapshot::value(const QString &key, Scope scope) const
+{
+   const auto values = this->values(key, scope);
+
+   return values.isEmpty() ? QString() : values.last();
+}
+
+QStringList GitConfigSnapshot::values(const QString &key, Scope scope) const
+{
+   QStringList values;
+
+   for (const auto index : mIndex.value(normalizedKey(key)))
+   {
+      const auto &entry = mEntries.at(index);
+
+      if (scope == Scope::Any || entry.scope == scope)
+         values.append(entry.value.isNull() ? QString("true") : entry.value);
+   }
+
+   return values;
+}
+
+bool GitConfigSnapshot::contains(const QString &key, Scope scope) const
+{
+   return !values(key, scope).isEmpty();
+}
+
+bool GitConfigSnapshot::boolValue(const QString &key, bool defaultValue) const
+{
+   const auto indexes = mIndex.value(normalizedKey(key));
+
+   if (indexes.isEmpty())
+      return defaultValue;
+
+   const auto &entry = mEntries.at(indexes.last());
+
+   if (entry.value.isNull())
+      return true;
+
+   const auto value = entry.value.trimmed().toLower();
+
+   return isTrue(value) ? true : isFalse(value) ? false : defaultValue;
+}
+
+QString GitConfigSnapshot::toList(Scope scope) const
+{
+   QString list;
+
+   for (const auto &entry : mEntries)
+   {
+      if (scope != Scope::Any && entry.scope != scope)
+         continue;
+
+      list.append(entry.value.isNull() ? entry.key : QString("%1=%2").arg(entry.key, entry.value));
+      list.append('\n');
+   }
+
+   return list;
+}
+
+QString GitConfigSnapshot::normalizedKey(const QString &key)
+{
+   const auto firstDot = key.indexOf('.');
+   const auto lastDot = key.lastIndexOf('.');
+
+   if (firstDot == -1)
+      return key.toLower();
+
+   // The subsection is everything between the first and the last dots, and it keeps its case.
+   return key.left(firstDot).toLower() + key.mid(firstDot, lastDot - firstDot) + key.mid(lastDot).toLower();
+}
+
+QStringList GitConfigSnapshot::knownFiles(const QString &gitDir, const QString &commonDir, const QString &workingDir)
+{
+   auto files = QStringList { cleanPath(workingDir, QDir(commonDir).filePath("config")),
+                              cleanPath(workingDir, QDir(gitDir).filePath("config.worktree")) };
+   files.append(globalFiles());
+   files.append(QString("/etc/gitconfig"));
+
+   return files;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ \brief The GitConfigSnapshot is the configuration of a repository parsed from the output of
+ git config --list -z --show-origin: the entries of every file git reads, in the order git reads them. Looking for a
+ value is a hash lookup, so it replaces the git config process started for every question.
+
+ A snapshot never changes once it's parsed. The GitBase of the repository builds a new one when any of the files it
+ comes from changes, see GitBase::getConfig.
+
+ \class GitConfigSnapshot GitConfigSnapshot.h "GitConfigSnapshot.h"
+*/
+class GitConfigSnapshot
+{
+public:
+   /*!
+    \brief The files of the configuration, in the order git reads them.
+   */
+   enum class Scope
+   {
+      System,
+      Global,
+      Local,
+      Worktree,
+      Command,
+      Any
+   };
+
+   /*!
+    \brief An entry of the configuration.
+   */
+   struct Entry
+   {
+      Scope scope = Scope::System;
+      QString origin;
+      QString key;
+      QString value;
+   };
+
+   /*!
+    \brief Default constructor. The snapshot is empty.
+   */
+   GitConfigSnapshot() = default;
+
+   /*!
+    \brief Parses the output of git config --list -z --show-origin.
+
+    \param output The output of git.
+    \param gitDir The git directory of the work tree, to tell the local and the work tree files apart.
+    \param commonDir The common git directory of the repository.
+    \param workingDir The work tree, since git shows the paths of the repository files relative to it.
+   */
+   GitConfigSnapshot(const QByteArray &output, const QString &gitDir, const QString &commonDir,
+                     const QString &workingDir);
+
+   /*!
+    \brief Returns the last value of a key, which is the one git uses.
+
+    \param key The key. The section and the name are case insensitive, the subsection is not.
+    \param scope The file the value must come from.
+    \return The value or a null string if the key is not set.
+   */
+   QString value(const QString &key, Scope scope = Scope::Any) const;
+   /*!
+    \brief Returns all the values of a key, for the keys that can be repeated like remote.origin.fetch.
+   */
+   QStringList values(const QString &key, Scope scope = Scope::Any) const;
+   /*!
+    \brief Tells if a key is set.
+   */
+   bool contains(const QString &key, Scope scope = Scope::Any) const;
+   /*!
+    \brief Returns the value of a key as git reads a boolean. A key without value is true.
+
+    \param key The key.
+    \param defaultValue The value if the key is not set or it's not a boolean.
+   */
+   bool boolValue(const QString &key, bool defaultValue = false) const;
+   /*!
+    \brief Returns the entries of a file as key=value lines, like git config --list.
+   */
+   QString toList(Scope scope) const;
+   /*!
+    \brief Returns the files the entries come from, including the ones included by others.
+   */
+   QStringList files() const { return mFiles; }
+   /*!
+    \brief Returns the number of entries.
+   */
+   int count() const { return mEntries.count(); }
+
+   /*!
+    \brief Returns the key in the form used by git config --list: the section and the name in lower case.
+   */
+   static QString normalizedKey(const QString &key);
+   /*!
+    \brief Returns the files git reads the configuration from, whether they exist or not, except the included ones.
+    The system file depends on the prefix git was built with: this is its usual place, git shows where it is in the
+    origin of the entries if it's somewhere else.
+   */
+   static QStringList knownFiles(const QString &gitDir, const QString &commonDir, const QString &workingDir);
+
+private:
+   QVector<Entry> mEntries;
+   QHash<QString, QVector<int>> mIndex;
+   QStringList mFiles;
+};
@@ -26,6 +26,11 @@
 #include <QPair>
 #include <QVariant>
 
+/*!
+ \brief The result of a git command. The output of the processes is kept as the bytes git wrote (a QByteArray): it's
+ only decoded when it's read with toString(). The outputs that contain NUL characters have to be read with
+ toByteArray(), because the conversion to string stops at the first one.
+*/
 struct GitExecResult
 {
    GitExecResult() = default;
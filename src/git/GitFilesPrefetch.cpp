@@ -0,0 +1,74 @@
+#include "GitFilesPrefetch.h"
+
+#include <GitBase.h>
+#include <GitHistory.h>
+#include <RevisionsCache.h>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+GitFilesPrefetch::GitFilesPrefetch(const QSharedPointer<GitBase> &gitBase, const QSharedPointer<RevisionsCache> &cache,
+                                   QObject *parent)
+   : QObject(parent)
+   , mGitBase(gitBase)
+   , mCache(cache)
+{
+}
+
+GitFilesPrefetch::~GitFilesPrefetch()
+{
+   if (mRequest != 0)
+      mGitBase->cancel(mRequest);
+}
+
+void GitFilesPrefetch::prefetch(const QVector<QPair<QString, QString>> &diffs)
+{
+   QVector<QPair<QString, QString>> missingDiffs;
+   auto covered = true;
+
+   for (const auto &diff : diffs)
+   {
+      if (mCache->containsRevisionFile(diff.first, diff.second))
+         continue;
+
+      missingDiffs.append(diff);
+      covered = covered && mRequest != 0 && mRequestedDiffs.contains(diff);
+   }
+
+   if (covered)
+      return;
+
+   // The selection moved away: the running diffs are read again only if they are still around it.
+   if (mRequest != 0)
+      mGitBase->cancel(mRequest);
+
+   QLog_Trace("Git", QString("Prefetching the files of {%1} commits.").arg(missingDiffs.count()));
+
+   mRequestedDiffs = missingDiffs;
+   mRequest = mGitBase->runAsync(
+       GitHistory::diffFilesBatchArguments(), this,
+       [this, missingDiffs](const GitExecResult &result) {
+          mRequest = 0;
+          mRequestedDiffs.clear();
+
+          if (!result.success)
+             return;
+
+          const auto parsedDiffs = mCache->parseDiffs(result.output.toString());
+          auto parsed = parsedDiffs.constBegin();
+
+          // The diffs come in the order of the input. The ones git skipped don't have a section.
+          for (const auto &diff : missingDiffs)
+          {
+             if (parsed == parsedDiffs.constEnd() || parsed->first != diff.first)
+                continue;
+
+             if (!mCache->containsRevisionFile(diff.first, diff.second))
+                mCache->insertRevisionFile(diff.first, diff.second, parsed->second);
+
+             ++parsed;
+          }
+       },
+       GitBase::Priority::Background, GitHistory::diffFilesBatchInput(missingDiffs));
+}
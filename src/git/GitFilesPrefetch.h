@@ -0,0 +1,70 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QObject>
+#include <QPair>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+class GitBase;
+class RevisionsCache;
+
+/*!
+ \brief The GitFilesPrefetch reads in the background the files changed by the commits around the selected one and
+ stores them in the RevisionsCache, so moving the selection through the history finds them already there. All the
+ diffs are read by a single git diff-tree that runs with the lowest priority. It's replaced when the selection moves
+ to commits it doesn't cover.
+
+ \class GitFilesPrefetch GitFilesPrefetch.h "GitFilesPrefetch.h"
+*/
+class GitFilesPrefetch : public QObject
+{
+   Q_OBJECT
+
+public:
+   explicit GitFilesPrefetch(const QSharedPointer<GitBase> &gitBase, const QSharedPointer<RevisionsCache> &cache,
+                             QObject *parent = nullptr);
+   ~GitFilesPrefetch();
+
+   /*!
+    \brief Requests the files of the given diffs that are not in the cache yet. The running request is cancelled if
+    it doesn't read all of them.
+
+    \param diffs The pairs of commit and commit to compare to.
+   */
+   void prefetch(const QVector<QPair<QString, QString>> &diffs);
+
+   /*!
+    \brief The rows above and below the selection whose files are read.
+   */
+   static constexpr int NEIGHBOUR_ROWS = 5;
+
+private:
+   QSharedPointer<GitBase> mGitBase;
+   QSharedPointer<RevisionsCache> mCache;
+   int mRequest = 0;
+   QVector<QPair<QString, QString>> mRequestedDiffs;
+};
@@ -1,20 +1,66 @@
 #include "GitHistory.h"
 
+#include <CommitInfo.h>
+#include <DiffDiskCache.h>
 #include <GitBase.h>
+#include <GitRequestorProcess.h>
+#include <PathHistoryIndex.h>
+
 #include <QLogger.h>
 
+#include <QDir>
+
 using namespace QLogger;
 
+namespace
+{
+const QString DIFF_CACHE_DIR("gitqlient/diffs");
+// The files are stored with their lines changed since --numstat was added: the entries stored before don't have them.
+const QString FILES_DISK_CACHE_KIND("files-numstat");
+// The renames of the quick list of files are looked for only when few files are added and deleted.
+const int FAST_RENAME_LIMIT = 200;
+
+bool isCommitId(const QString &sha)
+{
+   return sha.size() == 40 && sha != CommitInfo::ZERO_SHA;
+}
+}
+
 GitHistory::GitHistory(const QSharedPointer<GitBase> &gitBase)
    : mGitBase(gitBase)
 {
 }
 
-GitExecResult GitHistory::blame(const QString &file, const QString &commitFrom)
+GitRequestorProcess *GitHistory::blame(const QString &file, const QString &commitFrom,
+                                       const QVector<QPair<int, int>> &lines)
 {
    QLog_Debug("Git", QString("Executing blame: {%1} from {%2}").arg(file, commitFrom));
 
-   return mGitBase->run(QString("git annotate %1 %2").arg(file, commitFrom));
+   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+
+   QObject::connect(mGitBase.data(), &GitBase::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+   // Without a commit, git blames the file as it is in the work directory.
+   const auto revision = commitFrom == CommitInfo::ZERO_SHA ? QString() : commitFrom;
+   auto runCmd = QString("git blame --incremental");
+
+   for (const auto &range : lines)
+      runCmd.append(QString(" -L %1,+%2").arg(range.first).arg(range.second));
+
+   if (!requestor->run(QString("%1 %2 -- %3").arg(runCmd, revision, quotedPath(file))).success)
+   {
+      requestor->deleteLater();
+      return nullptr;
+   }
+
+   return requestor;
+}
+
+GitExecResult GitHistory::getFileLineChanges(const QString &sha, const QString &toSha, const QString &file)
+{
+   QLog_Debug("Git", QString("Executing getFileLineChanges: {%1} from {%2} to {%3}").arg(file, sha, toSha));
+
+   return mGitBase->run(QString("git diff --no-color -U0 %1 %2 -- %3").arg(sha, toSha, quotedPath(file)));
 }
 
 GitExecResult GitHistory::history(const QString &file)
@@ -29,27 +75,47 @@ GitExecResult GitHistory::history(const QString &file)
    return ret;
 }
 
-GitExecResult GitHistory::getCommitDiff(const QString &sha, const QString &diffToSha)
+bool GitHistory::loadPathHistoryIndex(PathHistoryIndex *index)
+{
+   QLog_Debug("Git", "Loading the path history index");
+
+   const auto request = index->start();
+   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+
+   QObject::connect(requestor, &GitRequestorProcess::procDataReady, index,
+                    [index, request](const QByteArray &ba) { index->processData(request, ba); });
+   QObject::connect(requestor, &GitRequestorProcess::procDataFinished, index,
+                    [index, request]() { index->finish(request); });
+   QObject::connect(mGitBase.data(), &GitBase::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+   return requestor->run("git -c core.quotePath=false log --no-color -M --name-status --pretty=format:%H").success;
+}
+
+GitExecResult GitHistory::getCommitDiff(const QString &sha, const QString &diffToSha, const QStringList &excludedFiles,
+                                        MergeDiff mergeDiff)
 {
    if (!sha.isEmpty())
    {
-      QLog_Debug("Git", QString("Executing getCommitDiff: {%1} to {%2}").arg(sha, diffToSha));
+      const auto combined = mergeDiff == MergeDiff::Combined;
 
-      QString runCmd = QString("git diff-tree --no-color -r --patch-with-stat -m");
+      QLog_Debug("Git",
+                 QString("Executing getCommitDiff: {%1} to {%2}").arg(sha, combined ? QString("parents") : diffToSha));
 
-      if (sha != CommitInfo::ZERO_SHA)
-      {
-         runCmd += " -C ";
+      // The diff of the work in progress doesn't show the stats.
+      auto runCmd = diffCommand(sha == CommitInfo::ZERO_SHA ? QString() : "--patch-with-stat", sha, diffToSha,
+                                mergeDiff);
 
-         if (diffToSha.isEmpty())
-            runCmd += " --root ";
+      if (!excludedFiles.isEmpty())
+      {
+         runCmd.append(" -- .");
 
-         runCmd.append(QString("%1 %2").arg(diffToSha, sha)); // diffToSha could be empty
+         for (const auto &file : excludedFiles)
+            runCmd.append(" " + quotedPath(":(exclude)" + file));
       }
-      else
-         runCmd = "git diff HEAD ";
 
-      return mGitBase->run(runCmd);
+      const auto kind = QString(combined ? "diff-cc %1" : "diff %1").arg(excludedFiles.join('\n'));
+
+      return runStoredDiff(kind, sha, combined ? QString() : diffToSha, runCmd);
    }
    else
       QLog_Warning("Git", QString("Executing getCommitDiff with empty SHA"));
@@ -57,26 +123,214 @@ GitExecResult GitHistory::getCommitDiff(const QString &sha, const QString &diffT
    return qMakePair(false, QString());
 }
 
-QString GitHistory::getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file)
+GitExecResult GitHistory::getCommitFileDiff(const QString &sha, const QString &diffToSha, const QString &file,
+                                            MergeDiff mergeDiff)
 {
-   QLog_Debug("Git", QString("Executing getFileDiff: {%1} between {%2} and {%3}").arg(file, currentSha, previousSha));
+   QLog_Debug("Git", QString("Executing getCommitFileDiff: {%1} from {%2} to {%3}").arg(file, sha, diffToSha));
 
-   const auto ret = mGitBase->run(QString("git diff -U15000 %1 %2 %3").arg(previousSha, currentSha, file));
+   return mGitBase->run(diffCommand("--patch", sha, diffToSha, mergeDiff) + " -- " + quotedPath(file));
+}
+
+GitExecResult GitHistory::getCommitDiffStats(const QString &sha, const QString &diffToSha)
+{
+   QLog_Debug("Git", QString("Executing getCommitDiffStats: {%1} to {%2}").arg(sha, diffToSha));
+
+   return mGitBase->run(diffCommand("--numstat -z", sha, diffToSha));
+}
+
+QStringList GitHistory::getGeneratedFiles(const QStringList &files)
+{
+   QStringList generated;
+
+   if (files.isEmpty())
+      return generated;
+
+   QLog_Debug("Git", QString("Executing getGeneratedFiles for {%1} files").arg(files.count()));
+
+   auto runCmd = QString("git check-attr -z linguist-generated --");
+
+   for (const auto &file : files)
+      runCmd.append(" " + quotedPath(file));
+
+   const auto ret = mGitBase->run(runCmd);
 
    if (ret.success)
-      return ret.output.toString();
+   {
+      // The output is a list of "<path>\0<attribute>\0<value>\0". It's decoded from the bytes: the conversion of
+      // the result to a string stops at the first NUL.
+      const auto fields = QString::fromUtf8(ret.output.toByteArray()).split('\0');
+
+      for (auto i = 0; i + 2 < fields.count(); i += 3)
+      {
+         if (fields.at(i + 2) == "set" || fields.at(i + 2) == "true")
+            generated.append(fields.at(i));
+      }
+   }
+
+   return generated;
+}
+
+QString GitHistory::diffCommand(const QString &options, const QString &sha, const QString &diffToSha,
+                                MergeDiff mergeDiff)
+{
+   if (sha == CommitInfo::ZERO_SHA)
+      return QString("git diff %1 HEAD").arg(options);
+
+   // The combined diff needs the commit alone: git compares it with all its parents.
+   if (mergeDiff == MergeDiff::Combined)
+      return QString("git diff-tree --no-color -r --cc %1 %2").arg(options, sha);
+
+   auto runCmd = QString("git diff-tree --no-color -r %1 -m -C ").arg(options);
+
+   if (diffToSha.isEmpty())
+      runCmd += " --root ";
+
+   runCmd.append(QString("%1 %2").arg(diffToSha, sha)); // diffToSha could be empty
+
+   return runCmd;
+}
+
+QString GitHistory::quotedPath(const QString &path)
+{
+   return path.contains(' ') ? QString("\"%1\"").arg(path) : path;
+}
+
+bool GitHistory::hasFileChanges(const QString &currentSha, const QString &previousSha, const QString &file)
+{
+   QLog_Debug("Git",
+              QString("Executing hasFileChanges: {%1} between {%2} and {%3}").arg(file, currentSha, previousSha));
 
-   return QString();
+   const auto ret = mGitBase->run(QString("git diff --name-only %1 %2 -- %3").arg(previousSha, currentSha, file));
+
+   return ret.success && !ret.output.toString().trimmed().isEmpty();
+}
+
+GitRequestorProcess *GitHistory::loadFileDiff(const QString &currentSha, const QString &previousSha,
+                                              const QString &file)
+{
+   QLog_Debug("Git", QString("Executing loadFileDiff: {%1} between {%2} and {%3}").arg(file, currentSha, previousSha));
+
+   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+
+   QObject::connect(mGitBase.data(), &GitBase::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+   if (!requestor->run(QString("git diff %1 %2 -- %3").arg(previousSha, currentSha, file)).success)
+   {
+      requestor->deleteLater();
+      return nullptr;
+   }
+
+   return requestor;
 }
 
 GitExecResult GitHistory::getDiffFiles(const QString &sha, const QString &diffToSha)
 {
    QLog_Debug("Git", QString("Executing getDiffFiles: {%1} to {%2}").arg(sha, diffToSha));
 
-   QString runCmd = QString("git diff-tree -C --no-color -r -m ");
+   const auto runCmd = diffFilesCommand(sha, diffToSha);
+
+   if (diffToSha.isEmpty() || sha == CommitInfo::ZERO_SHA)
+      return mGitBase->run(runCmd);
+
+   return runStoredDiff(FILES_DISK_CACHE_KIND, sha, diffToSha, runCmd);
+}
+
+int GitHistory::getDiffFilesAsync(const QString &sha, const QString &diffToSha, QObject *context,
+                                  const GitBase::ResultCallback &callback, RenameDetection detection,
+                                  GitBase::Priority priority)
+{
+   const auto runCmd = diffFilesCommand(sha, diffToSha, detection);
+
+   if (!DiffDiskCache::isEnabled() || diffToSha.isEmpty() || !isCommitId(sha) || !isCommitId(diffToSha))
+      return mGitBase->runAsync(runCmd, context, callback, priority);
+
+   // The diffs are stored in the common git directory, shared by all the work trees of the repository.
+   const DiffDiskCache cache(QDir(mGitBase->getRepositoryId()).absoluteFilePath(DIFF_CACHE_DIR));
+   const auto key = QString("%1\n%2\n%3").arg(FILES_DISK_CACHE_KIND, sha, diffToSha).toUtf8();
+
+   if (QByteArray data; cache.load(key, data))
+   {
+      callback(GitExecResult(true, data));
+      return 0;
+   }
+
+   // Only the complete files are stored.
+   if (detection == RenameDetection::Renames)
+      return mGitBase->runAsync(runCmd, context, callback, priority);
+
+   return mGitBase->runAsync(
+       runCmd, context,
+       [cache, key, callback](const GitExecResult &ret) {
+          if (ret.success)
+             cache.save(key, ret.output.toByteArray());
+
+          callback(ret);
+       },
+       priority);
+}
+
+QString GitHistory::diffFilesCommand(const QString &sha, const QString &diffToSha, RenameDetection detection)
+{
+   QString runCmd = detection == RenameDetection::Copies
+       ? QString("git diff-tree -C --no-color -r -m --raw --numstat ")
+       : QString("git -c diff.renameLimit=%1 diff-tree -M --no-color -r -m --raw --numstat ").arg(FAST_RENAME_LIMIT);
 
    if (!diffToSha.isEmpty() && sha != CommitInfo::ZERO_SHA)
       runCmd.append(diffToSha + " " + sha);
 
+   return runCmd;
+}
+
+QStringList GitHistory::diffFilesBatchArguments()
+{
+   return { "diff-tree", "--stdin", "--always", "-C", "--no-color", "-r", "-m", "--raw", "--numstat" };
+}
+
+QByteArray GitHistory::diffFilesBatchInput(const QVector<QPair<QString, QString>> &diffs)
+{
+   QByteArray input;
+
+   // Every line is a commit followed by the one used as its parent.
+   for (const auto &diff : diffs)
+      input.append(QString("%1 %2\n").arg(diff.first, diff.second).toLatin1());
+
+   return input;
+}
+
+GitExecResult GitHistory::runStoredDiff(const QString &kind, const QString &sha, const QString &diffToSha,
+                                        const QString &cmd)
+{
+   // The diff of a commit with its parents is as immutable as the diff with another commit.
+   if (!DiffDiskCache::isEnabled() || !isCommitId(sha) || (!diffToSha.isEmpty() && !isCommitId(diffToSha)))
+      return mGitBase->run(cmd);
+
+   // The diffs are stored in the common git directory, shared by all the work trees of the repository.
+   const DiffDiskCache cache(QDir(mGitBase->getRepositoryId()).absoluteFilePath(DIFF_CACHE_DIR));
+   const auto key = QString("%1\n%2\n%3").arg(kind, sha, diffToSha).toUtf8();
+
+   if (QByteArray data; cache.load(key, data))
+   {
+      QLog_Trace("Git", QString("Diff read from the disk cache: {%1} to {%2}").arg(sha, diffToSha));
+      return GitExecResult(true, data);
+   }
+
+   const auto ret = mGitBase->run(cmd);
+
+   if (ret.success)
+      cache.save(key, ret.output.toByteArray());
+
+   return ret;
+}
+
+GitExecResult GitHistory::getTreeEntries(const QString &directory)
+{
+   QLog_Debug("Git", QString("Executing getTreeEntries: {%1}").arg(directory));
+
+   auto runCmd = QString("git ls-tree -z HEAD");
+
+   // The trailing slash lists the entries of the directory instead of the directory itself.
+   if (!directory.isEmpty())
+      runCmd.append(" -- " + quotedPath(directory + "/"));
+
    return mGitBase->run(runCmd);
 }
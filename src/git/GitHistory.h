@@ -23,23 +23,206 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitBase.h>
 #include <GitExecResult.h>
 
+#include <QPair>
 #include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
 
-class GitBase;
+class GitRequestorProcess;
+class PathHistoryIndex;
+class GitRequestorProcess;
 
 class GitHistory
 {
 public:
+   /*!
+    \brief How the diff of a merge commit with its first parent is shown.
+   */
+   enum class MergeDiff
+   {
+      FirstParent,
+      Combined
+   };
+   /*!
+    \brief How the files of a diff that moved are found. Looking for the copies (-C) compares the files added with
+    all the files modified, so it's much slower than looking for the renames (-M), that is also limited to a number
+    of files.
+   */
+   enum class RenameDetection
+   {
+      Renames,
+      Copies
+   };
+
    explicit GitHistory(const QSharedPointer<GitBase> &gitBase);
 
-   GitExecResult blame(const QString &file, const QString &commitFrom);
+   /*!
+    \brief Starts, asynchronously, the incremental blame of a file. The output arrives through the procDataReady signal
+    of the process, a group of lines at a time, and the process deletes itself when it finishes. It is cancelled with
+    the rest of the processes of the GitBase.
+
+    \param file The file to blame.
+    \param commitFrom The commit to blame from, or CommitInfo::ZERO_SHA for the files in the work directory.
+    \param lines The ranges of lines to blame, as the first line (starting at 1) and the number of lines. The whole
+    file is blamed if it's empty.
+    \return The process, or null if it didn't start.
+   */
+   GitRequestorProcess *blame(const QString &file, const QString &commitFrom,
+                              const QVector<QPair<int, int>> &lines = QVector<QPair<int, int>>());
+   /*!
+    \brief Gets the lines that changed in a file between two commits, as a diff without context.
+
+    \param sha The commit to compare from.
+    \param toSha The commit to compare to.
+    \param file The file.
+    \return The result of the command.
+   */
+   GitExecResult getFileLineChanges(const QString &sha, const QString &toSha, const QString &file);
    GitExecResult history(const QString &file);
-   GitExecResult getCommitDiff(const QString &sha, const QString &diffToSha);
-   QString getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file);
+   /*!
+    \brief Starts, asynchronously, the git log that lists the files changed by every commit and streams its output into
+    the index. The process is cancelled with the rest of the processes of the GitBase.
+
+    \param index The index to build.
+    \return True if the process started, otherwise false.
+   */
+   bool loadPathHistoryIndex(PathHistoryIndex *index);
+   /*!
+    \brief Gets the diff of a commit with its stats.
+
+    \param sha The commit, or CommitInfo::ZERO_SHA for the work in progress.
+    \param diffToSha The commit to compare to. If it's empty, the commit is compared with an empty tree.
+    \param excludedFiles The files left out of the diff.
+    \param mergeDiff With MergeDiff::Combined the commit, a merge, is compared with all its parents at once (git diff
+    --cc): only the lines that don't come from any of them, like the resolved conflicts, are shown. The diff is usually
+    much smaller than the one with the first parent, that has all the changes merged. \p diffToSha is not used.
+    \return The result of the command.
+   */
+   GitExecResult getCommitDiff(const QString &sha, const QString &diffToSha,
+                               const QStringList &excludedFiles = QStringList(),
+                               MergeDiff mergeDiff = MergeDiff::FirstParent);
+   /*!
+    \brief Gets the diff of a single file of a commit, with the same options as \ref getCommitDiff.
+
+    \param sha The commit, or CommitInfo::ZERO_SHA for the work in progress.
+    \param diffToSha The commit to compare to.
+    \param file The file.
+    \param mergeDiff How the diff of a merge is shown.
+    \return The result of the command.
+   */
+   GitExecResult getCommitFileDiff(const QString &sha, const QString &diffToSha, const QString &file,
+                                   MergeDiff mergeDiff = MergeDiff::FirstParent);
+   /*!
+    \brief Gets the number of added and deleted lines of every file of the diff of a commit, in the -z format of git
+    diff --numstat. The binary files have "-" instead of the numbers. Only the stats are computed, not the patch.
+
+    \param sha The commit, or CommitInfo::ZERO_SHA for the work in progress.
+    \param diffToSha The commit to compare to.
+    \return The result of the command.
+   */
+   GitExecResult getCommitDiffStats(const QString &sha, const QString &diffToSha);
+   /*!
+    \brief Returns which of the files are marked as generated with the linguist-generated attribute in the
+    .gitattributes files.
+
+    \param files The files to check.
+    \return The generated files.
+   */
+   QStringList getGeneratedFiles(const QStringList &files);
+   /*!
+    \brief Tells if a file changed between two commits. Only the names of the files are compared, so it's fast even
+    for big files.
+
+    \param currentSha The commit to compare. If it's empty, the working directory is compared.
+    \param previousSha The commit to compare to.
+    \param file The file.
+    \return True if the file changed, otherwise false.
+   */
+   bool hasFileChanges(const QString &currentSha, const QString &previousSha, const QString &file);
+   /*!
+    \brief Starts, asynchronously, the diff of a file with the default context. The output is streamed through
+    the procDataReady signal of the returned process and procDataFinished is emitted when the diff is complete. There
+    is no timeout: the process runs until it finishes or it's cancelled, also with the rest of the processes of the
+    GitBase.
+
+    \param currentSha The commit to compare. If it's empty, the working directory is compared.
+    \param previousSha The commit to compare to.
+    \param file The file.
+    \return The process, that deletes itself when it finishes, or nullptr if it couldn't start.
+   */
+   GitRequestorProcess *loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file);
    GitExecResult getDiffFiles(const QString &sha, const QString &diffToSha);
+   /*!
+    \brief Gets the files like \ref getDiffFiles but without blocking. A diff found in the DiffDiskCache is passed to
+    the callback before returning.
+
+    \param sha The commit.
+    \param diffToSha The commit to compare to.
+    \param context The object the callback belongs to.
+    \param callback The function that receives the result.
+    \param detection With RenameDetection::Renames the files are listed quickly but the copies are not found. The
+    result is not stored, but the one with the copies is given if it's in the DiffDiskCache.
+    \param priority The priority of the command.
+    \return The id of the request, to cancel it with GitBase::cancel, or 0 if the callback was already called.
+   */
+   int getDiffFilesAsync(const QString &sha, const QString &diffToSha, QObject *context,
+                         const GitBase::ResultCallback &callback,
+                         RenameDetection detection = RenameDetection::Copies,
+                         GitBase::Priority priority = GitBase::Priority::Interactive);
+   /*!
+    \brief Returns the command that \ref getDiffFiles runs, for the callers that run it asynchronously. It lists the
+    files with --raw followed by the lines changed in them with --numstat, in a single call.
+
+    \param sha The commit.
+    \param diffToSha The commit to compare to.
+    \param detection How the files that moved are found.
+    \return The command.
+   */
+   static QString diffFilesCommand(const QString &sha, const QString &diffToSha,
+                                   RenameDetection detection = RenameDetection::Copies);
+   /*!
+    \brief Returns the arguments of a single git diff-tree that reads many diffs from its standard input, given by
+    \ref diffFilesBatchInput, so they don't need a process each. The output has a line with the commit before the
+    files of every diff, even if it's empty, in the order of the input, with the lines changed like
+    \ref diffFilesCommand. RevisionsCache::parseDiffs splits it.
+
+    \return The arguments of git, without the program.
+   */
+   static QStringList diffFilesBatchArguments();
+   /*!
+    \brief Returns the standard input of \ref diffFilesBatchArguments for the given diffs.
+
+    \param diffs The pairs of commit and commit to compare to.
+    \return The input.
+   */
+   static QByteArray diffFilesBatchInput(const QVector<QPair<QString, QString>> &diffs);
+   /*!
+    \brief Lists the entries of a directory of the tree of HEAD, in the -z format of git ls-tree. Only the tracked
+    files are listed and the subdirectories are not entered.
+
+    \param directory The directory relative to the root of the repository, empty for the root.
+    \return The result of the command.
+   */
+   GitExecResult getTreeEntries(const QString &directory);
 
 private:
    QSharedPointer<GitBase> mGitBase;
+
+   /*!
+    \brief Runs a diff between two commits, reading it from the DiffDiskCache when it's enabled and it was run before.
+
+    \param kind The kind of diff, part of the key of the cache.
+    \param sha The commit.
+    \param diffToSha The commit to compare to.
+    \param cmd The command that gives the diff.
+    \return The result of the command.
+   */
+   GitExecResult runStoredDiff(const QString &kind, const QString &sha, const QString &diffToSha, const QString &cmd);
+
+   static QString diffCommand(const QString &options, const QString &sha, const QString &diffToSha,
+                              MergeDiff mergeDiff = MergeDiff::FirstParent);
+   static QString quotedPath(const QString &path);
 };
@@ -7,11 +7,20 @@ using namespace QLogger;
 
 namespace
 {
-static QString quote(const QStringList &sl)
+QByteArray pathspecInput(const QStringList &paths)
 {
-   QString q(sl.join(QString("$%1$").arg(' ')));
-   q.prepend("$").append("$");
-   return q;
+   // With --pathspec-file-nul the paths are separated by NUL, so they need no quoting whatever characters they have.
+   QByteArray input;
+
+   for (const auto &path : paths)
+      input.append(path.toUtf8()).append('\0');
+
+   return input;
+}
+
+QStringList pathspecArguments(const QStringList &arguments)
+{
+   return arguments + QStringList({ "--pathspec-from-file=-", "--pathspec-file-nul" });
 }
 }
 
@@ -66,6 +75,13 @@ GitExecResult GitLocal::markFileAsResolved(const QString &fileName) const
    return ret;
 }
 
+GitExecResult GitLocal::stagePatch(const QByteArray &patch) const
+{
+   QLog_Debug("Git", QString("Executing stagePatch: {%1} bytes").arg(patch.size()));
+
+   return mGitBase->run({ "apply", "--cached", "--recount", "--whitespace=nowarn", "-" }, patch);
+}
+
 bool GitLocal::checkoutFile(const QString &fileName) const
 {
    if (fileName.isEmpty())
@@ -77,14 +93,34 @@ bool GitLocal::checkoutFile(const QString &fileName) const
 
    QLog_Debug("Git", QString("Executing checkoutFile: {%1}").arg(fileName));
 
-   return mGitBase->run(QString("git checkout %1").arg(fileName)).success;
+   return checkoutFiles({ fileName });
+}
+
+bool GitLocal::checkoutFiles(const QStringList &fileNames) const
+{
+   if (fileNames.isEmpty())
+      return false;
+
+   QLog_Debug("Git", QString("Executing checkoutFiles for {%1} files").arg(fileNames.count()));
+
+   return mGitBase->run(pathspecArguments({ "checkout" }), pathspecInput(fileNames)).success;
 }
 
 GitExecResult GitLocal::resetFile(const QString &fileName) const
 {
    QLog_Debug("Git", QString("Executing resetFile: {%1}").arg(fileName));
 
-   return mGitBase->run(QString("git reset %1").arg(fileName));
+   return resetFiles({ fileName });
+}
+
+GitExecResult GitLocal::resetFiles(const QStringList &fileNames) const
+{
+   if (fileNames.isEmpty())
+      return GitExecResult(true, "No files to reset");
+
+   QLog_Debug("Git", QString("Executing resetFiles for {%1} files").arg(fileNames.count()));
+
+   return mGitBase->run(pathspecArguments({ "reset" }), pathspecInput(fileNames));
 }
 
 bool GitLocal::resetCommit(const QString &sha, CommitResetType type) const
@@ -128,7 +164,7 @@ GitExecResult GitLocal::commitFiles(QStringList &selFiles, const RevisionFiles &
 
    if (!notSel.empty())
    {
-      const auto ret = mGitBase->run("git reset -- " + quote(notSel));
+      const auto ret = mGitBase->run(pathspecArguments({ "reset" }), pathspecInput(notSel));
 
       if (!ret.success)
          return ret;
@@ -159,7 +195,7 @@ GitExecResult GitLocal::ammendCommit(const QStringList &selFiles, const Revision
 
    if (!notSel.empty())
    {
-      const auto ret = mGitBase->run("git reset -- " + quote(notSel));
+      const auto ret = mGitBase->run(pathspecArguments({ "reset" }), pathspecInput(notSel));
 
       if (!ret.success)
          return ret;
@@ -197,7 +233,8 @@ GitExecResult GitLocal::updateIndex(const RevisionFiles &files, const QStringLis
 
    if (!toRemove.isEmpty())
    {
-      const auto ret = mGitBase->run("git rm --cached --ignore-unmatch -- " + quote(toRemove));
+      const auto ret
+          = mGitBase->run(pathspecArguments({ "rm", "--cached", "--ignore-unmatch" }), pathspecInput(toRemove));
 
       if (!ret.success)
          return ret;
@@ -205,7 +242,7 @@ GitExecResult GitLocal::updateIndex(const RevisionFiles &files, const QStringLis
 
    if (!toAdd.isEmpty())
    {
-      const auto ret = mGitBase->run("git add -- " + quote(toAdd));
+      const auto ret = mGitBase->run(pathspecArguments({ "add" }), pathspecInput(toAdd));
 
       if (!ret.success)
          return ret;
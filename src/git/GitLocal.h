@@ -51,8 +51,30 @@ public:
    GitExecResult cherryPickContinue() const;
    GitExecResult checkoutCommit(const QString &sha) const;
    GitExecResult markFileAsResolved(const QString &fileName) const;
+   /*!
+    \brief Stages some changes of the work tree, given as a patch, with a single git apply --cached. The patch is
+    written to the standard input of git. The line counts of its hunks are recalculated by git.
+
+    \param patch The patch, like the one built by DiffHunks::patch.
+    \return The result of git.
+   */
+   GitExecResult stagePatch(const QByteArray &patch) const;
    bool checkoutFile(const QString &fileName) const;
+   /*!
+    \brief Discards the changes of several files in the work tree with a single git checkout.
+
+    \param fileNames The files to check out.
+    \return True if git succeeded, otherwise false.
+   */
+   bool checkoutFiles(const QStringList &fileNames) const;
    GitExecResult resetFile(const QString &fileName) const;
+   /*!
+    \brief Removes several files from the index with a single git reset. Their changes stay in the work tree.
+
+    \param fileNames The files to reset.
+    \return GitExecResult The result of git.
+   */
+   GitExecResult resetFiles(const QStringList &fileNames) const;
    bool resetCommit(const QString &sha, CommitResetType type) const;
    GitExecResult commitFiles(QStringList &selFiles, const RevisionFiles &allCommitFiles, const QString &msg) const;
    GitExecResult ammendCommit(const QStringList &selFiles, const RevisionFiles &allCommitFiles, const QString &msg,
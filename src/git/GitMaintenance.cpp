@@ -0,0 +1,167 @@
+#include "GitMaintenance.h"
+
+#include <CommitGraph.h>
+#include <GitBase.h>
+#include <GitConfigSnapshot.h>
+#include <GitRepositoryReader.h>
+#include <ObjectId.h>
+
+#include <QLogger.h>
+
+#include <QDir>
+#include <QFileInfo>
+
+using namespace QLogger;
+
+GitMaintenance::GitMaintenance(const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mGit(git)
+{
+}
+
+GitMaintenance::~GitMaintenance()
+{
+   cancel();
+}
+
+GitMaintenance::Advice GitMaintenance::check() const
+{
+   Advice advice;
+   const GitRepositoryReader reader(mGit->getWorkingDir());
+
+   if (!reader.isValid())
+      return advice;
+
+   const QDir commonDir(reader.commonDir());
+   const QDir objectsDir(commonDir.filePath("objects"));
+
+   // Git doesn't write the commit-graph of a shallow repository.
+   if (!QFile::exists(commonDir.filePath("shallow")))
+   {
+      const CommitGraph graph(objectsDir.absolutePath());
+      QString head;
+      QString branch;
+
+      if (!graph.isValid())
+      {
+         advice.writeCommitGraph = true;
+         advice.onlyStale = false;
+         advice.reasons.append(tr("The repository has no commit-graph."));
+      }
+      else if (!graph.hasChangedPaths())
+      {
+         advice.writeCommitGraph = true;
+         advice.onlyStale = false;
+         advice.reasons.append(tr("The commit-graph has no filters of the changed paths."));
+      }
+      else if (reader.readHead(head, branch) && !head.isEmpty() && graph.position(ObjectId::fromHex(head)) < 0)
+      {
+         advice.writeCommitGraph = true;
+         advice.reasons.append(tr("The commit-graph doesn't have the last commits."));
+      }
+   }
+
+   const QDir packDir(objectsDir.filePath("pack"));
+   const auto packs = packDir.entryInfoList({ "*.pack" }, QDir::Files, QDir::Time);
+
+   if (packs.count() >= MULTI_PACK_INDEX_MIN_PACKS)
+   {
+      const QFileInfo multiPackIndex(packDir.filePath("multi-pack-index"));
+
+      if (!multiPackIndex.exists())
+      {
+         advice.writeMultiPackIndex = true;
+         advice.onlyStale = false;
+         advice.reasons.append(tr("The repository has %1 packs and no multi-pack-index.").arg(packs.count()));
+      }
+      // The packs are sorted from the newest.
+      else if (packs.constFirst().lastModified() > multiPackIndex.lastModified())
+      {
+         advice.writeMultiPackIndex = true;
+         advice.reasons.append(tr("The multi-pack-index doesn't have the last packs."));
+      }
+   }
+
+   if (!mGit->getConfig()->boolValue("core.untrackedCache"))
+   {
+      advice.enableUntrackedCache = true;
+      advice.onlyStale = false;
+      advice.reasons.append(tr("The untracked cache is disabled."));
+   }
+
+   return advice;
+}
+
+bool GitMaintenance::start(const Advice &advice)
+{
+   if (isRunning() || advice.isEmpty())
+      return false;
+
+   mFailed = false;
+
+   if (advice.enableUntrackedCache)
+      mPending.append({ "config", "core.untrackedCache", "true" });
+
+   if (advice.writeCommitGraph)
+      mPending.append({ "commit-graph", "write", "--reachable", "--changed-paths", "--no-progress" });
+
+   // The incremental repack writes the multi-pack-index and then packs the small packs together.
+   if (advice.writeMultiPackIndex)
+      mPending.append({ "maintenance", "run", "--task=incremental-repack", "--quiet" });
+
+   QLog_Info("Git",
+             QString("Running the maintenance of {%1}: %2").arg(mGit->getWorkingDir(), advice.reasons.join(' ')));
+
+   startNext();
+
+   return true;
+}
+
+void GitMaintenance::cancel()
+{
+   if (mRequest != 0)
+      mGit->cancel(mRequest);
+
+   mRequest = 0;
+   mPending.clear();
+}
+
+void GitMaintenance::startNext()
+{
+   if (mPending.isEmpty())
+   {
+      mRequest = 0;
+      emit signalFinished(!mFailed);
+      return;
+   }
+
+   const auto arguments = mPending.takeFirst();
+
+   mRequest = mGit->runAsync(
+       arguments, this, [this, arguments](const GitExecResult &ret) { onFinished(arguments, ret); },
+       GitBase::Priority::Background);
+}
+
+void GitMaintenance::onFinished(const QStringList &arguments, const GitExecResult &result)
+{
+   const auto cmd = QString("git %1").arg(arguments.join(' '));
+
+   if (result.success)
+      QLog_Debug("Git", QString("Maintenance command {%1} finished.").arg(cmd));
+   else if (arguments.constFirst() == QString("maintenance")
+            && result.output.toString().contains("is not a git command"))
+   {
+      // The versions of git before the maintenance command can still write the index alone.
+      mPending.prepend({ "multi-pack-index", "write" });
+   }
+   else
+   {
+      QLog_Warning("Git", QString("Maintenance command {%1} failed: %2").arg(cmd, result.output.toString()));
+      mFailed = true;
+   }
+
+   if (arguments.constFirst() == QString("config"))
+      mGit->invalidateConfig();
+
+   startNext();
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+class GitBase;
+
+/*!
+ \brief The GitMaintenance looks for the structures git uses to read a repository faster and writes the ones that are
+ missing or out of date:
+- The commit-graph with the Bloom filters of the changed paths: the history, its order and the history of a path
+  don't have to parse every commit.
+- The multi-pack-index: the objects are looked up in one index instead of one per pack.
+- The untracked cache: git status doesn't read the directories that didn't change.
+
+The check only reads the files of the git directory, so it can be done every time a repository is opened. The
+commands run one after the other with the background priority, so they never delay the ones the user is waiting for.
+
+ \class GitMaintenance GitMaintenance.h "GitMaintenance.h"
+*/
+class GitMaintenance : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when all the commands finished.
+
+    \param ok True if all of them succeeded.
+   */
+   void signalFinished(bool ok);
+
+public:
+   /*!
+    \brief What the repository needs and why.
+   */
+   struct Advice
+   {
+      bool writeCommitGraph = false;
+      bool writeMultiPackIndex = false;
+      bool enableUntrackedCache = false;
+      // True if the structures exist and are only out of date.
+      bool onlyStale = true;
+      QStringList reasons;
+
+      bool isEmpty() const { return !writeCommitGraph && !writeMultiPackIndex && !enableUntrackedCache; }
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param git The git object of the repository.
+    \param parent The parent object.
+   */
+   explicit GitMaintenance(const QSharedPointer<GitBase> &git, QObject *parent = nullptr);
+   /*!
+    \brief Destructor. The command running is cancelled.
+   */
+   ~GitMaintenance() override;
+
+   /*!
+    \brief Looks for the structures that are missing or out of date.
+
+    \return The advice. It's empty if the repository is up to date or its git directory can't be read.
+   */
+   Advice check() const;
+   /*!
+    \brief Starts the commands that write what the advice asks for.
+
+    \param advice The result of \ref check.
+    \return False if the maintenance is already running or the advice is empty, otherwise true.
+   */
+   bool start(const Advice &advice);
+   /*!
+    \brief Cancels the command running and the ones waiting. \ref signalFinished is not sent.
+   */
+   void cancel();
+   /*!
+    \brief Tells if the maintenance is running.
+   */
+   bool isRunning() const { return mRequest != 0 || !mPending.isEmpty(); }
+
+   /*!
+    \brief The number of packs from which the repository needs a multi-pack-index.
+   */
+   static constexpr int MULTI_PACK_INDEX_MIN_PACKS = 2;
+
+private:
+   QSharedPointer<GitBase> mGit;
+   QVector<QStringList> mPending;
+   int mRequest = 0;
+   bool mFailed = false;
+
+   /*!
+    \brief Starts the next command, or reports the end if there are no more.
+   */
+   void startNext();
+   /*!
+    \brief Logs the result of a command and starts the next one.
+
+    \param arguments The arguments of the command.
+    \param result The result of git.
+   */
+   void onFinished(const QStringList &arguments, const GitExecResult &result);
+};
@@ -3,7 +3,9 @@
 #include <QLogger.h>
 #include <GitBase.h>
 
-#include <QFile>
+#include <QVector>
+
+#include <algorithm>
 
 using namespace QLogger;
 
@@ -12,36 +14,72 @@ GitPatches::GitPatches(const QSharedPointer<GitBase> &gitBase)
 {
 }
 
-GitExecResult GitPatches::exportPatch(const QStringList &shaList)
+GitExecResult GitPatches::exportPatch(const QStringList &shaList, const ProgressCallback &progress)
 {
    QLog_Debug("Git", QString("Executing exportPatch: {%1}").arg(shaList.join(",")));
 
-   auto val = 1;
+   // The parents of all the commits in one process. The SHAs go through stdin to not depend on the length limit of
+   // the command line.
+   const auto parentsRet = mGitBase->run({ "log", "--no-walk", "--stdin", "--format=%H %P" },
+                                         shaList.join('\n').append('\n').toUtf8());
+
+   if (!parentsRet.success)
+      return parentsRet;
+
+   struct Range
+   {
+      QString base;
+      QString last;
+      int count = 0;
+   };
+
+   // --no-walk sorts the commits by date, the newest first. The ranges are built from the oldest one.
+   auto commits = parentsRet.output.toString().split('\n', QString::SkipEmptyParts);
+   std::reverse(commits.begin(), commits.end());
+
+   QVector<Range> ranges;
+
+   for (const auto &commit : qAsConst(commits))
+   {
+      const auto fields = commit.split(' ', QString::SkipEmptyParts);
+      const auto &sha = fields.constFirst();
+      const auto singleParent = fields.count() == 2;
+
+      // format-patch skips the merges: they break the ranges in any case.
+      if (!ranges.isEmpty() && singleParent && ranges.constLast().last == fields.at(1))
+      {
+         ranges.last().last = sha;
+         ++ranges.last().count;
+      }
+      else
+         ranges.append({ singleParent ? fields.at(1) : QString(), sha, 1 });
+   }
+
    QStringList files;
+   auto exported = 0;
 
-   for (const auto &sha : shaList)
+   for (const auto &range : qAsConst(ranges))
    {
-      const auto ret = mGitBase->run(QString("git format-patch -1 %1").arg(sha));
+      const auto revision = range.base.isEmpty() ? QString("-1") : QString("%1..%2").arg(range.base, range.last);
+      QStringList arguments { "format-patch", "--start-number", QString::number(files.count() + 1), revision };
+
+      if (range.base.isEmpty())
+         arguments.append(range.last);
+
+      const auto ret = mGitBase->run(arguments);
 
       if (!ret.success)
-         break;
-      else
       {
-         auto filename = ret.output.toString();
-         filename = filename.remove("\n");
-         const auto text = filename.mid(filename.indexOf("-") + 1);
-         const auto number = QString("%1").arg(val, 4, 10, QChar('0'));
-         const auto newFileName = QString("%1-%2").arg(number, text);
-         files.append(newFileName);
-
-         QFile::rename(QString("%1/%2").arg(mGitBase->getWorkingDir(), filename),
-                       QString("%1/%2").arg(mGitBase->getWorkingDir(), newFileName));
-         ++val;
+         QLog_Error("Git", QString("Problem generating patches. Stop after {%1} commits").arg(exported));
+         break;
       }
-   }
 
-   if (val != shaList.count())
-      QLog_Error("Git", QString("Problem generating patches. Stop after {%1} iterations").arg(val));
+      files.append(ret.output.toString().split('\n', QString::SkipEmptyParts));
+      exported += range.count;
+
+      if (progress)
+         progress(exported, commits.count());
+   }
 
    return qMakePair(true, QVariant(files));
 }
@@ -27,13 +27,29 @@
 
 #include <QSharedPointer>
 
+#include <functional>
+
 class GitBase;
 
 class GitPatches
 {
 public:
+   /*!
+    \brief Called after each range of patches is written with the number of commits exported so far.
+   */
+   using ProgressCallback = std::function<void(int exported, int total)>;
+
    explicit GitPatches(const QSharedPointer<GitBase> &gitBase);
-   GitExecResult exportPatch(const QStringList &shaList);
+   /*!
+    \brief Exports the commits as a numbered series of patches in the working directory, the oldest first. The
+    commits that follow each other are exported with a single git format-patch of their range: the number of
+    processes depends on the gaps of the selection and not on its size.
+
+    \param shaList The commits to export.
+    \param progress Optional callback with the progress of the export.
+    \return The names of the patch files in the output.
+   */
+   GitExecResult exportPatch(const QStringList &shaList, const ProgressCallback &progress = {});
    bool applyPatch(const QString &fileName, bool asCommit = false);
 
 private:
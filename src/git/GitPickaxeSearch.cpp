@@ -0,0 +1,92 @@
+#include "GitPickaxeSearch.h"
+
+#include <GitBase.h>
+#include <GitRequestorProcess.h>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+GitPickaxeSearch::GitPickaxeSearch(const QSharedPointer<GitBase> &gitBase, QObject *parent)
+   : QObject(parent)
+   , mGitBase(gitBase)
+{
+}
+
+GitPickaxeSearch::~GitPickaxeSearch()
+{
+   cancel();
+}
+
+bool GitPickaxeSearch::start(const QString &text, Mode mode)
+{
+   cancel();
+
+   // The command is split by spaces unless the argument is quoted, and the quotes can't be escaped.
+   const auto quote = text.contains('"') ? QString("'") : QString("\"");
+
+   if (text.isEmpty() || (text.contains('"') && text.contains('\'')))
+   {
+      QLog_Warning("Git", QString("The content search can't be done with the text {%1}").arg(text));
+      return false;
+   }
+
+   QLog_Debug("Git", QString("Executing content search: {%1}").arg(text));
+
+   const auto option = mode == Mode::Text ? QString("-S") : QString("-G");
+   const auto cmd = QString("git log --no-color --pretty=format:%H %1%2%3%1").arg(quote, option, text);
+   const auto process = new GitRequestorProcess(mGitBase->getWorkingDir());
+
+   connect(process, &GitRequestorProcess::procDataReady, this, &GitPickaxeSearch::processData);
+   connect(process, &GitRequestorProcess::procDataFinished, this, [this]() {
+      processData("\n");
+      mProcess.clear();
+      emit signalFinished();
+   });
+   connect(mGitBase.data(), &GitBase::cancelAllProcesses, process, &AGitProcess::onCancel);
+
+   mProcess = process;
+   mPendingLine.clear();
+
+   if (!process->run(cmd).success)
+   {
+      mProcess.clear();
+      process->deleteLater();
+      return false;
+   }
+
+   return true;
+}
+
+void GitPickaxeSearch::cancel()
+{
+   if (mProcess)
+   {
+      mProcess->disconnect(this);
+      mProcess->onCancel();
+      mProcess.clear();
+   }
+}
+
+void GitPickaxeSearch::processData(const QByteArray &data)
+{
+   mPendingLine.append(data);
+
+   const auto end = mPendingLine.lastIndexOf('\n');
+
+   if (end == -1)
+      return;
+
+   QStringList shas;
+
+   for (const auto &line : mPendingLine.left(end).split('\n'))
+   {
+      if (const auto sha = QString::fromUtf8(line).trimmed(); !sha.isEmpty())
+         shas.append(sha);
+   }
+
+   mPendingLine.remove(0, end + 1);
+
+   if (!shas.isEmpty())
+      emit signalMatchesFound(shas);
+}
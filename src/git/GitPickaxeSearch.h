@@ -0,0 +1,90 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QPointer>
+#include <QStringList>
+
+class GitBase;
+class GitRequestorProcess;
+
+/*!
+ \brief The GitPickaxeSearch looks for the commits that added or removed some content (git log -S) or whose diff
+ matches a regular expression (git log -G). The search runs asynchronously and the SHAs are notified while git finds
+ them, from the newest to the oldest. It is cancelled with the rest of the processes of the GitBase.
+
+ \class GitPickaxeSearch GitPickaxeSearch.h "GitPickaxeSearch.h"
+*/
+class GitPickaxeSearch : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered every time git outputs new matches.
+
+    \param shas The SHAs of the commits found since the last notification.
+   */
+   void signalMatchesFound(const QStringList &shas);
+   /*!
+    \brief Signal triggered when git has finished the search.
+   */
+   void signalFinished();
+
+public:
+   enum class Mode
+   {
+      Text,
+      RegExp
+   };
+
+   explicit GitPickaxeSearch(const QSharedPointer<GitBase> &gitBase, QObject *parent = nullptr);
+   ~GitPickaxeSearch();
+
+   /*!
+    \brief Starts a new search. The search in progress, if any, is cancelled.
+
+    \param text The content to search for.
+    \param mode Whether the text is the exact content to find (-S) or a regular expression (-G).
+    \return True if the search started, otherwise false.
+   */
+   bool start(const QString &text, Mode mode);
+   /*!
+    \brief Cancels the search in progress, if any.
+   */
+   void cancel();
+   /*!
+    \brief Tells if there is a search in progress.
+   */
+   bool isRunning() const { return !mProcess.isNull(); }
+
+private:
+   QSharedPointer<GitBase> mGitBase;
+   QPointer<GitRequestorProcess> mProcess;
+   QByteArray mPendingLine;
+
+   void processData(const QByteArray &data);
+};
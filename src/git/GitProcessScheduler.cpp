@@ -0,0 +1,270 @@
+#include "GitProcessScheduler.h"
+
+#include <GitAsyncProcess.h>
+#include <LazyLog.h>
+
+#include <QLogger.h>
+
+#include <QCryptographicHash>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace QLogger;
+
+GitProcessScheduler::GitProcessScheduler(QObject *parent)
+   : QObject(parent)
+{
+}
+
+GitProcessScheduler::~GitProcessScheduler()
+{
+   // The processes running finish by themselves, they only lose their connections.
+   qDeleteAll(mJobs);
+   qDeleteAll(mCancelledJobs);
+}
+
+QSharedPointer<GitProcessScheduler> GitProcessScheduler::forRepositoryGroup(const QString &group)
+{
+   static QHash<QString, QWeakPointer<GitProcessScheduler>> schedulers;
+
+   auto scheduler = schedulers.value(group).toStrongRef();
+
+   if (!scheduler)
+   {
+      scheduler.reset(new GitProcessScheduler());
+      schedulers.insert(group, scheduler);
+
+      QObject::connect(scheduler.data(), &QObject::destroyed, [group]() {
+         if (!schedulers.value(group))
+            schedulers.remove(group);
+      });
+   }
+
+   return scheduler;
+}
+
+void GitProcessScheduler::setMaxConcurrentProcesses(int maxProcesses)
+{
+   mMaxProcesses = qMax(1, maxProcesses);
+
+   startNext();
+}
+
+int GitProcessScheduler::schedule(const QString &workingDirectory, const QString &cmd, Priority priority,
+                                  QObject *context, const ResultCallback &callback)
+{
+   const auto job = new Job();
+   job->key = QString("%1\n%2").arg(workingDirectory, cmd);
+   job->workingDirectory = workingDirectory;
+   job->cmd = cmd;
+   job->priority = priority;
+
+   return enqueue(job, context, callback);
+}
+
+int GitProcessScheduler::schedule(const QString &workingDirectory, const QStringList &arguments, Priority priority,
+                                  QObject *context, const ResultCallback &callback, const QByteArray &input)
+{
+   const auto job = new Job();
+   job->cmd = QString("git %1").arg(arguments.join(' '));
+   job->key = QString("%1\n%2").arg(workingDirectory, job->cmd);
+
+   // The input can be long: only its hash is part of the key.
+   if (!input.isEmpty())
+   {
+      const auto inputHash = QCryptographicHash::hash(input, QCryptographicHash::Sha1).toHex();
+      job->key.append(QString("\n%1").arg(QString::fromLatin1(inputHash)));
+   }
+
+   job->workingDirectory = workingDirectory;
+   job->arguments = arguments;
+   job->input = input;
+   job->hasArguments = true;
+   job->priority = priority;
+
+   return enqueue(job, context, callback);
+}
+
+int GitProcessScheduler::enqueue(Job *job, QObject *context, const ResultCallback &callback)
+{
+   const auto request = ++mLastRequest;
+   const Waiter waiter { request, context, callback };
+
+   if (const auto sameJob = mJobs.value(job->key))
+   {
+      ++mDeduplicated;
+
+      QLog_LazyTrace("Git", QString("The command {%1} is already scheduled, it's shared.").arg(job->cmd));
+
+      // A waiting command takes the highest priority of the requests that share it.
+      if (!sameJob->running && job->priority < sameJob->priority)
+      {
+         mQueues[static_cast<int>(sameJob->priority)].removeOne(sameJob);
+         sameJob->priority = job->priority;
+         mQueues[static_cast<int>(sameJob->priority)].enqueue(sameJob);
+      }
+
+      sameJob->waiters.append(waiter);
+      mRequests.insert(request, sameJob);
+
+      delete job;
+
+      return request;
+   }
+
+   job->waiters.append(waiter);
+   mJobs.insert(job->key, job);
+   mRequests.insert(request, job);
+   mQueues[static_cast<int>(job->priority)].enqueue(job);
+
+   QLog_LazyTrace("Git",
+                  QString("Command {%1} scheduled: {%2} running and {%3} interactive, {%4} refresh and {%5} "
+                          "background waiting.")
+                      .arg(job->cmd, QString::number(mRunning), QString::number(queueDepth(Priority::Interactive)),
+                           QString::number(queueDepth(Priority::Refresh)),
+                           QString::number(queueDepth(Priority::Background))));
+
+   startNext();
+
+   return request;
+}
+
+void GitProcessScheduler::cancel(int request)
+{
+   mPendingResults.remove(request);
+
+   const auto job = mRequests.take(request);
+
+   if (!job)
+      return;
+
+   for (auto i = 0; i < job->waiters.count(); ++i)
+   {
+      if (job->waiters.at(i).request == request)
+      {
+         job->waiters.remove(i);
+         break;
+      }
+   }
+
+   if (!job->waiters.isEmpty())
+      return;
+
+   if (job->running)
+   {
+      // The job ends when the process goes away. Meanwhile the same command starts a new process.
+      mJobs.remove(job->key);
+      mCancelledJobs.insert(job);
+
+      if (job->process)
+         job->process->onCancel();
+   }
+   else
+   {
+      mQueues[static_cast<int>(job->priority)].removeOne(job);
+      mJobs.remove(job->key);
+      delete job;
+   }
+}
+
+void GitProcessScheduler::cancelAll(const QString &workingDirectory)
+{
+   const auto inDirectory = [workingDirectory](Job *job) { return job->workingDirectory == workingDirectory; };
+
+   // The jobs are taken out of the queues first: finishing a job starts the next one.
+   QVector<Job *> waiting;
+
+   for (auto &queue : mQueues)
+   {
+      std::copy_if(queue.cbegin(), queue.cend(), std::back_inserter(waiting), inDirectory);
+      queue.erase(std::remove_if(queue.begin(), queue.end(), inDirectory), queue.end());
+   }
+
+   for (const auto job : qAsConst(waiting))
+      finish(job, GitExecResult(false, QString("The command was cancelled.")));
+
+   for (const auto job : mJobs.values() + mCancelledJobs.values())
+   {
+      if (job->process && inDirectory(job))
+         job->process->onCancel();
+   }
+}
+
+void GitProcessScheduler::startNext()
+{
+   while (mRunning < mMaxProcesses)
+   {
+      auto queue = std::find_if(std::begin(mQueues), std::end(mQueues), [](const QQueue<Job *> &jobs) {
+         return !jobs.isEmpty();
+      });
+
+      if (queue == std::end(mQueues))
+         return;
+
+      start(queue->dequeue());
+   }
+}
+
+void GitProcessScheduler::start(Job *job)
+{
+   const auto process = new GitAsyncProcess(job->workingDirectory);
+   const auto started = job->hasArguments ? process->run(job->arguments, job->input) : process->run(job->cmd).success;
+
+   if (!started)
+   {
+      process->deleteLater();
+      finish(job, GitExecResult(false, QString("The command couldn't be started.")));
+      return;
+   }
+
+   ++mRunning;
+   job->process = process;
+   job->running = true;
+
+   connect(process, &GitAsyncProcess::signalDataReady, this, [this, job](GitExecResult ret) { finish(job, ret); });
+   connect(process, &GitAsyncProcess::signalProgress, this, [this, job](const QString &step, int value) {
+      for (const auto &waiter : qAsConst(job->waiters))
+         emit signalProgress(waiter.request, step, value);
+   });
+   // A process that goes away without its result was cancelled.
+   connect(process, &QObject::destroyed, this,
+           [this, job]() { finish(job, GitExecResult(false, QString("The command was cancelled."))); });
+}
+
+void GitProcessScheduler::finish(Job *job, const GitExecResult &result)
+{
+   if (job->running)
+   {
+      if (job->process)
+         job->process->disconnect(this);
+
+      --mRunning;
+   }
+
+   if (mJobs.value(job->key) == job)
+      mJobs.remove(job->key);
+
+   mCancelledJobs.remove(job);
+
+   for (const auto &waiter : qAsConst(job->waiters))
+      mRequests.remove(waiter.request);
+
+   // The results are always delivered later: the request might have failed to start before its id was returned.
+   for (const auto &waiter : qAsConst(job->waiters))
+   {
+      mPendingResults.insert(waiter.request);
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, waiter, result]() {
+             if (mPendingResults.remove(waiter.request) && waiter.context)
+                waiter.callback(result);
+          },
+          Qt::QueuedConnection);
+   }
+
+   delete job;
+
+   startNext();
+}
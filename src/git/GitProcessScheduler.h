@@ -0,0 +1,200 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+#include <GitExecResult.h>
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+class GitAsyncProcess;
+
+/*!
+ \brief The GitProcessScheduler runs the asynchronous git commands of a repository and its submodules. Every command
+ has a priority and the commands wait in a queue per priority until one of the processes is free, so a command the
+ user is waiting for doesn't wait behind the ones that refresh the data or run in the background. A command that is
+ the same as one already waiting or running in the same directory doesn't start a new process: it gets the result of
+ that one.
+
+ The repositories opened from the same superproject, or from the same repository in other work trees, share a
+ scheduler, see \ref forRepositoryGroup, so opening them doesn't multiply the processes running.
+
+ \class GitProcessScheduler GitProcessScheduler.h "GitProcessScheduler.h"
+*/
+class GitProcessScheduler : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when a running command reports its progress. It's sent for every request that waits for
+    the command.
+
+    \param request The id of the request.
+    \param stepDescription The step git is doing.
+    \param value The percentage of the step.
+   */
+   void signalProgress(int request, const QString &stepDescription, int value);
+
+public:
+   /*!
+    \brief The function that receives the result of a command.
+   */
+   using ResultCallback = std::function<void(const GitExecResult &result)>;
+
+   /*!
+    \brief The priority classes, from the highest to the lowest.
+   */
+   enum class Priority
+   {
+      Interactive,
+      Refresh,
+      Background
+   };
+
+   static constexpr int DEFAULT_MAX_PROCESSES = 4;
+
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent object if needed.
+   */
+   explicit GitProcessScheduler(QObject *parent = nullptr);
+   /*!
+    \brief Destructor. The commands that are waiting are discarded.
+   */
+   ~GitProcessScheduler() override;
+
+   /*!
+    \brief Returns the scheduler shared by the repositories of a group. It's created when the first repository asks
+    for it and destroyed with the last one.
+
+    \param group The group of the repositories, see GitBase::getRepositoryGroup.
+    \return The scheduler.
+   */
+   static QSharedPointer<GitProcessScheduler> forRepositoryGroup(const QString &group);
+   /*!
+    \brief Sets how many processes can run at the same time. The processes running are not stopped if there are more.
+
+    \param maxProcesses The maximum, at least 1.
+   */
+   void setMaxConcurrentProcesses(int maxProcesses);
+   /*!
+    \brief Queues a command given as a single string, that is split into arguments like GitBase::run does.
+
+    \param workingDirectory The directory the command runs in.
+    \param cmd The command.
+    \param priority The priority of the command.
+    \param context The object the callback belongs to. The callback is not called if it's destroyed before.
+    \param callback The function that receives the result.
+    \return The id of the request.
+   */
+   int schedule(const QString &workingDirectory, const QString &cmd, Priority priority, QObject *context,
+                const ResultCallback &callback);
+   /*!
+    \brief Queues git with the given arguments, passed as they are.
+
+    \param workingDirectory The directory the command runs in.
+    \param arguments The arguments of git, without the program.
+    \param priority The priority of the command.
+    \param context The object the callback belongs to. The callback is not called if it's destroyed before.
+    \param callback The function that receives the result.
+    \param input The data written to the standard input of git. The requests share a process only if they have the
+    same input too.
+    \return The id of the request.
+   */
+   int schedule(const QString &workingDirectory, const QStringList &arguments, Priority priority, QObject *context,
+                const ResultCallback &callback, const QByteArray &input = QByteArray());
+   /*!
+    \brief Cancels a request. Its callback is not called. The process is only stopped if no other request shares it.
+
+    \param request The id of the request.
+   */
+   void cancel(int request);
+   /*!
+    \brief Cancels all the commands that run in a directory. Their callbacks get a failure.
+
+    \param workingDirectory The directory of the commands.
+   */
+   void cancelAll(const QString &workingDirectory);
+
+   /*!
+    \brief Returns how many commands of a priority are waiting for a process.
+   */
+   int queueDepth(Priority priority) const { return mQueues[static_cast<int>(priority)].count(); }
+   /*!
+    \brief Returns how many processes are running.
+   */
+   int runningCount() const { return mRunning; }
+   /*!
+    \brief Returns how many requests got the result of another one instead of starting a process.
+   */
+   int deduplicatedCount() const { return mDeduplicated; }
+
+private:
+   struct Waiter
+   {
+      int request = 0;
+      QPointer<QObject> context;
+      ResultCallback callback;
+   };
+
+   struct Job
+   {
+      QString key;
+      QString workingDirectory;
+      QString cmd;
+      QStringList arguments;
+      QByteArray input;
+      bool hasArguments = false;
+      Priority priority = Priority::Interactive;
+      QPointer<GitAsyncProcess> process;
+      bool running = false;
+      QVector<Waiter> waiters;
+   };
+
+   static constexpr int TOTAL_PRIORITIES = 3;
+
+   int mMaxProcesses = DEFAULT_MAX_PROCESSES;
+   int mRunning = 0;
+   int mLastRequest = 0;
+   int mDeduplicated = 0;
+   QQueue<Job *> mQueues[TOTAL_PRIORITIES];
+   QHash<QString, Job *> mJobs;
+   QHash<int, Job *> mRequests;
+   QSet<Job *> mCancelledJobs;
+   QSet<int> mPendingResults;
+
+   int enqueue(Job *job, QObject *context, const ResultCallback &callback);
+   void startNext();
+   void start(Job *job);
+   void finish(Job *job, const GitExecResult &result);
+};
@@ -0,0 +1,233 @@
+#include "GitRecorder.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+const auto FORMAT = QString("gitqlient-git-recording");
+
+QByteArray hash(const QByteArray &data)
+{
+   return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+}
+
+GitRecorder &GitRecorder::instance()
+{
+   static GitRecorder recorder;
+   return recorder;
+}
+
+bool GitRecorder::startRecording(const QString &fileName, bool hashPaths)
+{
+   QMutexLocker locker(&mMutex);
+
+   stopLocked();
+
+   mFile.setFileName(fileName);
+
+   if (!mFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+   {
+      QLog_Error("Git", QString("Can't write the recording {%1}: %2").arg(fileName, mFile.errorString()));
+      return false;
+   }
+
+   mHashPaths = hashPaths;
+
+   const QJsonObject header { { "format", FORMAT }, { "version", VERSION }, { "hashPaths", hashPaths } };
+   mFile.write(QJsonDocument(header).toJson(QJsonDocument::Compact).append('\n'));
+   mFile.flush();
+
+   mMode.storeRelease(static_cast<int>(Mode::Record));
+
+   QLog_Info("Git", QString("Recording the git commands in {%1}.").arg(fileName));
+
+   return true;
+}
+
+bool GitRecorder::startReplay(const QString &fileName, double speed)
+{
+   QMutexLocker locker(&mMutex);
+
+   stopLocked();
+
+   QFile file(fileName);
+
+   if (!file.open(QIODevice::ReadOnly))
+   {
+      QLog_Error("Git", QString("Can't read the recording {%1}: %2").arg(fileName, file.errorString()));
+      return false;
+   }
+
+   const auto header = QJsonDocument::fromJson(file.readLine()).object();
+
+   if (header.value("format").toString() != FORMAT || header.value("version").toInt() != VERSION)
+   {
+      QLog_Error("Git", QString("The file {%1} isn't a recording of this version.").arg(fileName));
+      return false;
+   }
+
+   mHashPaths = header.value("hashPaths").toBool();
+   mSpeed = qMax(0.0, speed);
+
+   while (!file.atEnd())
+   {
+      const auto line = QJsonDocument::fromJson(file.readLine()).object();
+
+      if (line.isEmpty())
+         continue;
+
+      Entry entry;
+      entry.directory = line.value("directory").toString();
+      entry.command = line.value("command").toString();
+      entry.inputHash = line.value("input").toString().toLatin1();
+      entry.normalExit = line.value("normalExit").toBool(true);
+      entry.exitCode = line.value("exitCode").toInt();
+      entry.spawnMs = static_cast<qint64>(line.value("spawnMs").toDouble());
+      entry.firstByteMs = static_cast<qint64>(line.value("firstByteMs").toDouble(-1));
+      entry.wallMs = static_cast<qint64>(line.value("wallMs").toDouble());
+      entry.output = QByteArray::fromBase64(line.value("output").toString().toLatin1());
+      entry.errorOutput = QByteArray::fromBase64(line.value("error").toString().toLatin1());
+
+      mEntries[key(entry.command, entry.inputHash)].enqueue(entry);
+      ++mCount;
+   }
+
+   mMode.storeRelease(static_cast<int>(Mode::Replay));
+
+   QLog_Info("Git", QString("Replaying %1 git commands from {%2}.").arg(mCount).arg(fileName));
+
+   return true;
+}
+
+void GitRecorder::stop()
+{
+   QMutexLocker locker(&mMutex);
+
+   stopLocked();
+}
+
+void GitRecorder::stopLocked()
+{
+   mMode.storeRelease(static_cast<int>(Mode::Off));
+
+   if (mFile.isOpen())
+      mFile.close();
+
+   mEntries.clear();
+   mCount = 0;
+   mMisses = 0;
+}
+
+void GitRecorder::record(const QString &workingDirectory, Entry entry, const QByteArray &input)
+{
+   if (!isRecording())
+      return;
+
+   // The output is hidden and encoded out of the lock: it can be big.
+   const auto directory = mHashPaths ? QString::fromLatin1(hash(workingDirectory.toUtf8())) : workingDirectory;
+   const auto command = QString::fromUtf8(hidePaths(entry.command.toUtf8(), workingDirectory));
+   const auto output = hidePaths(entry.output, workingDirectory).toBase64();
+   const auto errorOutput = hidePaths(entry.errorOutput, workingDirectory).toBase64();
+
+   const QJsonObject line { { "directory", directory },
+                            { "command", command },
+                            { "input", QString::fromLatin1(input.isEmpty() ? QByteArray() : hash(input)) },
+                            { "normalExit", entry.normalExit },
+                            { "exitCode", entry.exitCode },
+                            { "spawnMs", entry.spawnMs },
+                            { "firstByteMs", entry.firstByteMs },
+                            { "wallMs", entry.wallMs },
+                            { "output", QString::fromLatin1(output) },
+                            { "error", QString::fromLatin1(errorOutput) } };
+   const auto data = QJsonDocument(line).toJson(QJsonDocument::Compact).append('\n');
+
+   QMutexLocker locker(&mMutex);
+
+   if (mFile.isOpen())
+   {
+      mFile.write(data);
+      mFile.flush();
+      ++mCount;
+   }
+}
+
+bool GitRecorder::take(const QString &workingDirectory, const QString &command, const QByteArray &input,
+                       Entry &entry)
+{
+   const auto hidden = QString::fromUtf8(hidePaths(command.toUtf8(), workingDirectory));
+   const auto inputHash = input.isEmpty() ? QByteArray() : hash(input);
+
+   {
+      QMutexLocker locker(&mMutex);
+
+      auto iter = mEntries.find(key(hidden, inputHash));
+
+      if (iter == mEntries.end() || iter->isEmpty())
+      {
+         ++mMisses;
+         locker.unlock();
+
+         QLog_Warning("Git", QString("The command {%1} isn't in the recording.").arg(hidden));
+         return false;
+      }
+
+      entry = iter->size() > 1 ? iter->dequeue() : iter->head();
+   }
+
+   entry.output.replace(REPOSITORY_TOKEN, workingDirectory.toUtf8());
+   entry.errorOutput.replace(REPOSITORY_TOKEN, workingDirectory.toUtf8());
+
+   if (mHashPaths)
+   {
+      entry.output.replace(HOME_TOKEN, QDir::homePath().toUtf8());
+      entry.errorOutput.replace(HOME_TOKEN, QDir::homePath().toUtf8());
+   }
+
+   return true;
+}
+
+qint64 GitRecorder::replayDelay(qint64 wallMs) const
+{
+   QMutexLocker locker(&mMutex);
+
+   return mSpeed > 0.0 ? static_cast<qint64>(wallMs / mSpeed) : 0;
+}
+
+int GitRecorder::count() const
+{
+   QMutexLocker locker(&mMutex);
+
+   return mCount;
+}
+
+int GitRecorder::misses() const
+{
+   QMutexLocker locker(&mMutex);
+
+   return mMisses;
+}
+
+QByteArray GitRecorder::hidePaths(QByteArray data, const QString &workingDirectory) const
+{
+   // The working directory goes first: it's usually inside the home directory.
+   if (!workingDirectory.isEmpty())
+      data.replace(workingDirectory.toUtf8(), REPOSITORY_TOKEN);
+
+   if (mHashPaths)
+      data.replace(QDir::homePath().toUtf8(), HOME_TOKEN);
+
+   return data;
+}
+
+QString GitRecorder::key(const QString &command, const QByteArray &inputHash)
+{
+   return inputHash.isEmpty() ? command : QString("%1\n%2").arg(command, QString::fromLatin1(inputHash));
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAtomicInt>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+
+/*!
+ \brief The GitRecorder keeps the git I/O of GitQlient so a slow repository can be reproduced without it. While it
+ records, every git process appends a line to a file with its command, its input, its timings and its output. While it
+ replays, the processes don't start git: they take the result recorded for the same command and deliver it after the
+ time it took, so GitRepoLoader, the widgets and the bench see the same data at the same pace.
+
+ The working directory of the process is written as REPOSITORY_TOKEN in the commands and the outputs, so a recording
+ can be replayed from any directory. With the paths hashed, the directory itself is written as a hash and the home
+ directory of the user as HOME_TOKEN. The names of the files inside the repository are kept as they are.
+
+ The file has a JSON object per line: the first one describes the recording and every other one is a command. It's
+ disabled by default, and while it's disabled a process only checks the mode.
+
+ \class GitRecorder GitRecorder.h "GitRecorder.h"
+*/
+class GitRecorder
+{
+public:
+   enum class Mode
+   {
+      Off,
+      Record,
+      Replay
+   };
+
+   /*!
+    \brief The run of a command, as it's recorded.
+   */
+   struct Entry
+   {
+      QString directory;
+      QString command;
+      QByteArray inputHash;
+      bool normalExit = true;
+      int exitCode = 0;
+      qint64 spawnMs = 0;
+      qint64 firstByteMs = -1;
+      qint64 wallMs = 0;
+      QByteArray output;
+      QByteArray errorOutput;
+   };
+
+   static constexpr int VERSION = 1;
+   static constexpr const char *REPOSITORY_TOKEN = "{repository}";
+   static constexpr const char *HOME_TOKEN = "{home}";
+
+   /*!
+    \brief Returns the recorder of the application.
+   */
+   static GitRecorder &instance();
+
+   /*!
+    \brief Starts recording in a file, that is overwritten. A replay or a previous recording stop.
+
+    \param fileName The file.
+    \param hashPaths True to write the directories as hashes.
+    \return True if the file could be opened, otherwise false.
+   */
+   bool startRecording(const QString &fileName, bool hashPaths);
+   /*!
+    \brief Loads a recording and starts replaying it. A recording or a previous replay stop.
+
+    \param fileName The file.
+    \param speed How much faster than recorded the results are delivered. With 0 they are delivered at once.
+    \return True if the file is a recording, otherwise false.
+   */
+   bool startReplay(const QString &fileName, double speed = 1.0);
+   /*!
+    \brief Stops recording or replaying.
+   */
+   void stop();
+
+   Mode mode() const { return static_cast<Mode>(mMode.loadAcquire()); }
+   bool isRecording() const { return mode() == Mode::Record; }
+   bool isReplaying() const { return mode() == Mode::Replay; }
+   /*!
+    \brief Tells if it records or replays. The reads that GitQlient does from the files of the repository, without git,
+    are disabled meanwhile: they wouldn't be in the recording.
+   */
+   bool isActive() const { return mode() != Mode::Off; }
+
+   /*!
+    \brief Appends the run of a process to the recording. It does nothing if it isn't recording.
+
+    \param workingDirectory The working directory of the process.
+    \param entry The run, with the directory, the command and the output as they are.
+    \param input The data written to the standard input of git.
+   */
+   void record(const QString &workingDirectory, Entry entry, const QByteArray &input);
+   /*!
+    \brief Returns the result recorded for a command. The runs of the same command are returned in the order they were
+    recorded, and the last one is repeated when there are no more.
+
+    \param workingDirectory The working directory of the process.
+    \param command The command, as the process runs it.
+    \param input The data written to the standard input of git.
+    \param entry The run recorded, with the output for this working directory.
+    \return True if the command is in the recording, otherwise false.
+   */
+   bool take(const QString &workingDirectory, const QString &command, const QByteArray &input, Entry &entry);
+   /*!
+    \brief Returns the time a replayed run is delivered after, given the time it took when it was recorded.
+   */
+   qint64 replayDelay(qint64 wallMs) const;
+
+   /*!
+    \brief Returns the number of runs recorded or loaded.
+   */
+   int count() const;
+   /*!
+    \brief Returns the number of commands replayed that weren't in the recording.
+   */
+   int misses() const;
+
+private:
+   mutable QMutex mMutex;
+   QAtomicInt mMode { static_cast<int>(Mode::Off) };
+   QFile mFile;
+   bool mHashPaths = false;
+   double mSpeed = 1.0;
+   int mCount = 0;
+   int mMisses = 0;
+   QHash<QString, QQueue<Entry>> mEntries;
+
+   GitRecorder() = default;
+
+   void stopLocked();
+   QByteArray hidePaths(QByteArray data, const QString &workingDirectory) const;
+   static QString key(const QString &command, const QByteArray &inputHash);
+};
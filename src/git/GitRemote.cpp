@@ -37,3 +37,34 @@ GitExecResult GitRemote::prune()
 
    return mGitBase->run("git remote prune origin");
 }
+
+int GitRemote::push(bool force, QObject *context, const GitBase::ResultCallback &callback)
+{
+   QLog_Debug("Git", QString("Executing push asynchronously"));
+
+   return mGitBase->runAsync(QString("git push --progress").append(force ? QString(" --force") : QString()), context,
+                             callback);
+}
+
+int GitRemote::pull(QObject *context, const GitBase::ResultCallback &callback)
+{
+   QLog_Debug("Git", QString("Executing pull asynchronously"));
+
+   return mGitBase->runAsync("git pull --progress", context, callback);
+}
+
+int GitRemote::fetch(QObject *context, const GitBase::ResultCallback &callback)
+{
+   QLog_Debug("Git", QString("Executing fetch with prune asynchronously"));
+
+   // The fetch is usually triggered by the timer: it doesn't go before the commands the user is waiting for.
+   return mGitBase->runAsync("git fetch --all --tags --prune --force --progress", context, callback,
+                             GitBase::Priority::Background);
+}
+
+int GitRemote::prune(QObject *context, const GitBase::ResultCallback &callback)
+{
+   QLog_Debug("Git", QString("Executing prune asynchronously"));
+
+   return mGitBase->runAsync("git remote prune origin", context, callback);
+}
@@ -23,12 +23,11 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitBase.h>
 #include <GitExecResult.h>
 
 #include <QSharedPointer>
 
-class GitBase;
-
 class GitRemote
 {
 public:
@@ -39,6 +38,20 @@ public:
    bool fetch();
    GitExecResult prune();
 
+   /*!
+    \brief The asynchronous versions of the remote operations, that can take long. They don't block the caller: the
+    callback gets the result once git finishes. See GitBase::runAsync. The fetch, the pull and the push report their
+    progress through GitProcessScheduler::signalProgress.
+
+    \param context The object the callback belongs to.
+    \param callback The function that receives the result.
+    \return The id of the request, to cancel it with GitBase::cancel.
+   */
+   int push(bool force, QObject *context, const GitBase::ResultCallback &callback);
+   int pull(QObject *context, const GitBase::ResultCallback &callback);
+   int fetch(QObject *context, const GitBase::ResultCallback &callback);
+   int prune(QObject *context, const GitBase::ResultCallback &callback);
+
 private:
    QSharedPointer<GitBase> mGitBase;
 };
@@ -0,0 +1,113 @@
+#include "GitRemotesFetch.h"
+
+#include <GitBase.h>
+#include <GitProcessScheduler.h>
+
+#include <QLogger.h>
+
+#include <QTimer>
+
+using namespace QLogger;
+
+GitRemotesFetch::GitRemotesFetch(const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mGit(git)
+{
+   connect(mGit->getScheduler(), &GitProcessScheduler::signalProgress, this, &GitRemotesFetch::onProgress);
+}
+
+GitRemotesFetch::~GitRemotesFetch()
+{
+   cancel();
+}
+
+bool GitRemotesFetch::start()
+{
+   if (isRunning())
+      return false;
+
+   const auto ret = mGit->run("git remote");
+
+   if (!ret.success)
+      return false;
+
+   mPending = ret.output.toString().split('\n', QString::SkipEmptyParts);
+   mFailed.clear();
+
+   if (mPending.isEmpty())
+      return false;
+
+   QLog_Debug("Git", QString("Fetching {%1} remotes: {%2}").arg(mPending.count()).arg(mPending.join(", ")));
+
+   startNext();
+
+   return true;
+}
+
+void GitRemotesFetch::cancel()
+{
+   for (const auto request : qAsConst(mRunning))
+      mGit->cancel(request);
+
+   mRunning.clear();
+   mPending.clear();
+}
+
+void GitRemotesFetch::startNext()
+{
+   while (!mPending.isEmpty() && mRunning.count() < MAX_PARALLEL_FETCHES)
+   {
+      const auto remote = mPending.takeFirst().trimmed();
+
+      // The fetch is usually triggered by the timer: it doesn't go before the commands the user is waiting for.
+      const auto request = mGit->runAsync(
+          { "fetch", "--tags", "--prune", "--force", "--progress", remote }, this,
+          [this, remote](const GitExecResult &ret) { onFetched(remote, ret); }, GitBase::Priority::Background);
+
+      mRunning.insert(remote, request);
+
+      // The ids of the requests are never reused: the timeout only cancels the fetch it was started for.
+      QTimer::singleShot(REMOTE_TIMEOUT_MS, this, [this, remote, request]() {
+         if (mRunning.value(remote) != request)
+            return;
+
+         const auto seconds = REMOTE_TIMEOUT_MS / 1000;
+
+         mGit->cancel(request);
+         onFetched(remote, GitExecResult(false, QString("The remote didn't answer in %1 seconds.").arg(seconds)));
+      });
+   }
+}
+
+void GitRemotesFetch::onFetched(const QString &remote, const GitExecResult &result)
+{
+   if (!mRunning.remove(remote))
+      return;
+
+   if (result.success)
+      QLog_Debug("Git", QString("Remote {%1} fetched.").arg(remote));
+   else
+   {
+      QLog_Warning("Git", QString("The fetch of the remote {%1} failed: %2").arg(remote, result.output.toString()));
+      mFailed.append(remote);
+   }
+
+   emit signalRemoteFetched(remote, result);
+
+   startNext();
+
+   if (!isRunning())
+      emit signalFinished(mFailed);
+}
+
+void GitRemotesFetch::onProgress(int request, const QString &stepDescription, int value)
+{
+   for (auto iter = mRunning.cbegin(); iter != mRunning.cend(); ++iter)
+   {
+      if (iter.value() == request)
+      {
+         emit signalRemoteProgress(iter.key(), stepDescription, value);
+         break;
+      }
+   }
+}
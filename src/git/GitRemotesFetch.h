@@ -0,0 +1,125 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
+
+class GitBase;
+
+/*!
+ \brief The GitRemotesFetch fetches every remote of a repository in its own git process, several at the same time, so a
+ slow or unreachable remote doesn't delay the others. Every remote reports its progress and its result as soon as it
+ has them, and a remote that doesn't finish in \ref REMOTE_TIMEOUT_MS is cancelled and reported as failed.
+
+ The fetches run with the background priority and at most \ref MAX_PARALLEL_FETCHES at a time, so there is always a
+ process free for the commands the user is waiting for.
+
+ \class GitRemotesFetch GitRemotesFetch.h "GitRemotesFetch.h"
+*/
+class GitRemotesFetch : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the fetch of a remote reports its progress.
+
+    \param remote The remote.
+    \param stepDescription The step git is doing.
+    \param value The percentage of the step.
+   */
+   void signalRemoteProgress(const QString &remote, const QString &stepDescription, int value);
+   /*!
+    \brief Signal triggered when the fetch of a remote finishes, fails or times out.
+
+    \param remote The remote.
+    \param result The result of git.
+   */
+   void signalRemoteFetched(const QString &remote, const GitExecResult &result);
+   /*!
+    \brief Signal triggered once all the remotes finished.
+
+    \param failedRemotes The remotes that couldn't be fetched.
+   */
+   void signalFinished(const QStringList &failedRemotes);
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param git The git object of the repository.
+    \param parent The parent object.
+   */
+   explicit GitRemotesFetch(const QSharedPointer<GitBase> &git, QObject *parent = nullptr);
+   /*!
+    \brief Destructor. The fetches running are cancelled.
+   */
+   ~GitRemotesFetch() override;
+
+   /*!
+    \brief Starts to fetch all the remotes, with their tags, pruning the references that were removed.
+
+    \return False if the fetch is already running or the repository has no remotes, otherwise true.
+   */
+   bool start();
+   /*!
+    \brief Cancels the fetches running and the ones waiting. \ref signalFinished is not sent.
+   */
+   void cancel();
+   /*!
+    \brief Tells if any remote is being fetched.
+   */
+   bool isRunning() const { return !mRunning.isEmpty() || !mPending.isEmpty(); }
+
+   static constexpr int MAX_PARALLEL_FETCHES = 3;
+   static constexpr int REMOTE_TIMEOUT_MS = 2 * 60 * 1000;
+
+private:
+   QSharedPointer<GitBase> mGit;
+   QStringList mPending;
+   // The remotes being fetched and their requests.
+   QHash<QString, int> mRunning;
+   QStringList mFailed;
+
+   /*!
+    \brief Starts the fetch of the remotes waiting while there are free slots.
+   */
+   void startNext();
+   /*!
+    \brief Reports the result of a remote and starts the next one.
+
+    \param remote The remote.
+    \param result The result of git.
+   */
+   void onFetched(const QString &remote, const GitExecResult &result);
+   /*!
+    \brief Reports the progress of the fetch of a remote.
+   */
+   void onProgress(int request, const QString &stepDescription, int value);
+};
@@ -2,16 +2,67 @@
 
 #include <GitBase.h>
 #include <RevisionsCache.h>
+#include <RevisionsBuilder.h>
+#include <TraceRecorder.h>
+#include <WarmStartSnapshot.h>
 #include <GitRequestorProcess.h>
 #include <GitBranches.h>
+#include <GitCommandGraph.h>
+#include <GitConfig.h>
+#include <GitRepositoryReader.h>
+#include <GitSparseCheckout.h>
+#include <LazyLog.h>
+#include <WorkerPool.h>
 
 #include <QLogger.h>
 
+#include <QCryptographicHash>
 #include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QThread>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 using namespace QLogger;
 
-static const QString GIT_LOG_FORMAT("%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n%b ");
+const QString GitRepoLoader::GIT_LOG_FORMAT("%m%x1f%H%x1f%P%x1f%cn<%ce>%x1f%an<%ae>%x1f%at%x20%ai%x1f%s%x1f%b");
+const QString GitRepoLoader::GIT_LOG_TOPOLOGY_FORMAT("%m%x1f%H%x1f%P%x1f%x1f%x1f%at%x20%ai%x1f%s%x1f");
+static const QString DISK_CACHE_FILE("gitqlient/history.cache");
+static const QString WARM_START_FILE("gitqlient/warm-start.cache");
+
+QString LoadingTimings::toString() const
+{
+   QStringList phases;
+
+   const auto addPhase = [&phases](const QString &name, qint64 value) {
+      if (value >= 0)
+         phases.append(QString("%1: %2 ms").arg(name).arg(value));
+   };
+
+   addPhase("spawn", spawnMs);
+   addPhase("first byte", firstByteMs);
+   addPhase("read", readMs);
+   addPhase("parse", parseMs);
+   addPhase("lanes", lanesMs);
+   addPhase("references", referencesMs);
+   addPhase("total", totalMs);
+
+   return phases.join(", ");
+}
+
+GitRepoLoader::HistoryOrder GitRepoLoader::historyOrderFromString(const QString &name)
+{
+   if (name == QString("topo"))
+      return HistoryOrder::Topological;
+
+   if (name == QString("first-parent"))
+      return HistoryOrder::FirstParent;
+
+   return HistoryOrder::Date;
+}
 
 GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<RevisionsCache> cache, QObject *parent)
    : QObject(parent)
@@ -20,45 +71,117 @@ GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<Rev
 {
 }
 
+GitRepoLoader::~GitRepoLoader()
+{
+   mBuilderQueue.reset();
+
+   delete mBuilder;
+}
+
 bool GitRepoLoader::loadRepository()
 {
    if (mLocked)
+   {
       QLog_Warning("Git", "Git is currently loading data.");
-   else
+      return false;
+   }
+
+   return configureRepository() && loadRevisions();
+}
+
+bool GitRepoLoader::configureRepository()
+{
+   TraceSpan span("loader", "GitRepoLoader::configureRepository");
+
+   if (mGitBase->getWorkingDir().isEmpty())
    {
-      if (mGitBase->getWorkingDir().isEmpty())
-         QLog_Error("Git", "No working directory set.");
-      else
-      {
-         QLog_Info("Git", "Initializing Git...");
+      QLog_Error("Git", "No working directory set.");
+      return false;
+   }
 
-         mRevCache->clear();
+   QLog_Info("Git", "Initializing Git...");
 
-         mLocked = true;
+   // The repository directory and the current branch don't depend on each other.
+   GitCommandGraph graph(mGitBase->getWorkingDir());
+   const auto cdup = graph.addCommand("git rev-parse --show-cdup");
+   const auto currentBranch = graph.addCommand("git rev-parse --abbrev-ref HEAD");
 
-         if (configureRepoDirectory())
-         {
-            mGitBase->updateCurrentBranch();
+   graph.run();
 
-            requestRevisions();
+   if (!configureRepoDirectory(graph.result(cdup)))
+   {
+      QLog_Error("Git", "The working directory is not a Git repository.");
+      return false;
+   }
 
-            QLog_Info("Git", "... Git init finished");
+   const auto branch = graph.result(currentBranch);
 
-            return true;
-         }
-         else
-            QLog_Error("Git", "The working directory is not a Git repository.");
-      }
+   mGitBase->setCurrentBranch(branch.success ? branch.output.toString().trimmed() : QString());
+
+   mSparseCone = GitSparseCheckout(mGitBase).getConeDirectories();
+
+   return true;
+}
+
+bool GitRepoLoader::loadRevisions()
+{
+   TraceSpan span("loader", "GitRepoLoader::loadRevisions");
+
+   if (mLocked)
+   {
+      QLog_Warning("Git", "Git is currently loading data.");
+      return false;
    }
 
-   return false;
+   mLocked = true;
+
+   if (!requestRevisionsDelta())
+   {
+      mRevCache->clear();
+
+      requestRevisions();
+   }
+
+   QLog_Info("Git", "... Git init finished");
+
+   return true;
 }
 
-bool GitRepoLoader::configureRepoDirectory()
+bool GitRepoLoader::loadWarmStart()
 {
-   QLog_Debug("Git", "Configuring repository directory.");
+   TraceSpan span("loader", "GitRepoLoader::loadWarmStart");
+
+   if (mLocked || !mDiskCacheEnabled || mRevCache->count() > 1)
+      return false;
 
-   const auto ret = mGitBase->run("git rev-parse --show-cdup");
+   const auto file = getWarmStartFile();
+   QString headSha;
+   QVector<CommitInfo *> commits;
+   QVector<WarmStartSnapshot::Reference> references;
+
+   if (file.isEmpty() || !WarmStartSnapshot(file).load(headSha, commits, references) || commits.isEmpty())
+      return false;
+
+   // The rows are a generation like any other: the WIP on top of the HEAD they were stored with and the commits below.
+   mRevCache->configure(commits.count());
+   mRevCache->setLanesOrigin(headSha);
+   mRevCache->updateWipCommit(headSha, QByteArray());
+   mRevCache->insertCommits(commits);
+   mRevCache->publishGeneration();
+
+   for (const auto &reference : qAsConst(references))
+      mRevCache->insertReference(reference.sha, reference.type, reference.name);
+
+   QLog_Info("Git", QString("Showing {%1} rows of the history stored while it's loaded.").arg(commits.count()));
+
+   emit signalRevisionsChunkLoaded(mRevCache->count());
+
+   return true;
+}
+
+bool GitRepoLoader::configureRepoDirectory(const GitExecResult &ret)
+{
+   QLog_Debug("Git", "Configuring repository directory.");
 
    if (ret.success)
    {
@@ -73,176 +196,1198 @@ bool GitRepoLoader::configureRepoDirectory()
 
 void GitRepoLoader::loadReferences()
 {
+   TraceSpan span("loader", "GitRepoLoader::loadReferences");
+
    QLog_Debug("Git", "Loading references.");
 
-   const auto ret3 = mGitBase->run("git show-ref -d");
+   // The distances to the upstream branches come in the same pass.
+   const auto ret = mGitBase->getReferenceRecords(true);
+
+   mLoadedReferences.clear();
 
-   if (ret3.success)
+   if (ret.success)
    {
-      auto ret = mGitBase->getLastCommit();
+      const auto references = parseReferences(ret.output.toByteArray(), true);
 
-      if (ret.success)
-         ret.output = ret.output.toString().trimmed();
+      mLoadedReferences.reserve(references.count());
 
-      QString prevRefSha;
-      const auto curBranchSHA = ret.output.toString();
-      const auto referencesList = ret3.output.toString().split('\n', QString::SkipEmptyParts);
+      for (const auto &reference : references)
+      {
+         mRevCache->insertReference(reference.sha, reference.type, reference.name);
+         mLoadedReferences.insert(reference.refName, reference);
+      }
 
-      for (const auto &reference : referencesList)
+      loadLocalBranchesDistances(references);
+   }
+}
+
+bool GitRepoLoader::updateReferences()
+{
+   TraceSpan span("loader", "GitRepoLoader::updateReferences");
+
+   if (mLocked || mLoadedReferences.isEmpty() || mLoadedShowAll != mShowAll
+       || mLoadedWorkingDir != mGitBase->getWorkingDir())
+      return false;
+
+   const auto head = mGitBase->getLastCommit();
+   const auto headSha = head.success ? head.output.toString().trimmed() : QString();
+
+   if (headSha.isEmpty())
+      return false;
+
+   // With all the branches shown, a checkout of a commit already loaded doesn't change the history.
+   const auto headMoved = headSha != mLoadedWipParent;
+
+   if (headMoved && (!mShowAll || mRevCache->getCommitPos(headSha) <= 0))
+      return false;
+
+   // Most of the times nothing changed: the distances to the upstream branches are only asked for if needed.
+   const auto ret = mGitBase->getReferenceRecords(false);
+
+   if (!ret.success)
+      return false;
+
+   const auto references = parseReferences(ret.output.toByteArray(), false);
+   QHash<QString, Reference> currentReferences;
+   QVector<Reference> added;
+   QVector<Reference> removed;
+   QSet<QString> currentShas { headSha };
+
+   currentReferences.reserve(references.count());
+
+   for (const auto &reference : references)
+   {
+      const auto loaded = mLoadedReferences.constFind(reference.refName);
+
+      if (loaded == mLoadedReferences.cend())
+         added.append(reference);
+      else if (loaded.value().sha != reference.sha)
+      {
+         removed.append(loaded.value());
+         added.append(reference);
+      }
+
+      currentReferences.insert(reference.refName, reference);
+      currentShas.insert(reference.sha);
+   }
+
+   for (const auto &reference : qAsConst(mLoadedReferences))
+   {
+      if (!currentReferences.contains(reference.refName))
+         removed.append(reference);
+   }
+
+   // Checking out another branch on the same commit doesn't move HEAD.
+   const auto branch = mGitBase->run("git rev-parse --abbrev-ref HEAD");
+   const auto currentBranch = branch.success ? branch.output.toString().trimmed() : QString();
+
+   if (!headMoved && added.isEmpty() && removed.isEmpty() && currentBranch == mGitBase->getCurrentBranch())
+      return true;
+
+   for (const auto &reference : qAsConst(added))
+   {
+      if (mRevCache->getCommitPos(reference.sha) == -1)
+      {
+         QLog_LazyDebug("Git", QString("The reference {%1} points to a commit not loaded.").arg(reference.refName));
+         return false;
+      }
+   }
+
+   // The commits only reachable from the references removed are not part of the history anymore.
+   if (mShowAll)
+   {
+      QStringList removedShas;
+
+      for (const auto &reference : qAsConst(removed))
+      {
+         if (!currentShas.contains(reference.sha) && !removedShas.contains(reference.sha))
+            removedShas.append(reference.sha);
+      }
+
+      // A detached HEAD left behind can be the only way to reach its commits.
+      if (headMoved && !currentShas.contains(mLoadedWipParent) && !removedShas.contains(mLoadedWipParent))
+         removedShas.append(mLoadedWipParent);
+
+      if (!removedShas.isEmpty())
       {
-         const auto revSha = reference.left(40);
-         const auto refName = reference.mid(41);
+         // Too many references would exceed the command line limits.
+         if (removedShas.count() + currentShas.count() > 500)
+            return false;
+
+         const QStringList tips = currentShas.values();
+         const auto count
+             = mGitBase->run(QString("git rev-list --count %1 --not %2").arg(removedShas.join(' '), tips.join(' ')));
+
+         if (!count.success || count.output.toString().trimmed() != QString("0"))
+            return false;
+      }
+   }
+
+   QLog_Info("Git",
+             QString("Updating the references: {%1} added and {%2} removed.").arg(added.count()).arg(removed.count()));
+
+   QStringList shas;
+
+   for (const auto &reference : qAsConst(removed))
+   {
+      mRevCache->removeReference(reference.sha, reference.type, reference.name);
+      shas.append(reference.sha);
+   }
+
+   for (const auto &reference : qAsConst(added))
+   {
+      mRevCache->insertReference(reference.sha, reference.type, reference.name);
+      shas.append(reference.sha);
+   }
+
+   mLoadedReferences = std::move(currentReferences);
+   mGitBase->setCurrentBranch(currentBranch);
+
+   // The next delta of the history starts from the tips of the references as they are now.
+   if (mShowAll)
+   {
+      const auto tips = mGitBase->getReferences(false);
+
+      if (tips.success)
+         mLoadedTips = getReferenceTips(headSha, tips.output.toString());
+   }
+
+   loadLocalBranchesDistances(references);
+
+   if (headMoved)
+   {
+      QLog_Info("Git", QString("HEAD moved to {%1} in the history loaded.").arg(headSha));
+
+      shas.append(mLoadedWipParent);
+      shas.append(headSha);
+
+      mRevCache->restartLanes(headSha);
+      mLoadedWipParent = headSha;
+      mRequestedWipParent = headSha;
+
+      updateWipRevision();
+   }
+
+   shas.removeDuplicates();
+
+   emit signalReferencesUpdated(shas);
 
-         if (!refName.startsWith("refs/tags/") || (refName.startsWith("refs/tags/") && refName.endsWith("^{}")))
+   if (headMoved)
+      emit signalHeadMoved();
+
+   return true;
+}
+
+QVector<GitRepoLoader::Reference> GitRepoLoader::parseReferences(const QByteArray &records, bool tracking)
+{
+   QVector<Reference> references;
+   const auto data = records.constData();
+   const auto end = data + records.size();
+   const char *fields[GitBase::ReferenceFieldsCount];
+   int sizes[GitBase::ReferenceFieldsCount];
+
+   for (auto record = data; record < end;)
+   {
+      auto recordEnd = static_cast<const char *>(std::memchr(record, '\n', static_cast<size_t>(end - record)));
+
+      if (!recordEnd)
+         recordEnd = end;
+
+      auto count = 0;
+
+      for (auto field = record; count < GitBase::ReferenceFieldsCount && field <= recordEnd; ++count)
+      {
+         auto fieldEnd = static_cast<const char *>(std::memchr(field, '\0', static_cast<size_t>(recordEnd - field)));
+
+         if (!fieldEnd)
+            fieldEnd = recordEnd;
+
+         fields[count] = field;
+         sizes[count] = static_cast<int>(fieldEnd - field);
+         field = fieldEnd + 1;
+      }
+
+      record = recordEnd + 1;
+
+      if (count < GitBase::ReferenceFieldsCount)
+         continue;
+
+      const auto field = [&fields, &sizes](GitBase::ReferenceField index) {
+         return QByteArray::fromRawData(fields[index], sizes[index]);
+      };
+      const auto kind = field(GitBase::KindField);
+      Reference reference;
+
+      // The tags are taken dereferenced: the commit they point to, not the tag object. Like with git show-ref -d, only
+      // the annotated tags have one.
+      if (kind == "refs/tags")
+      {
+         if (sizes[GitBase::PeeledShaField] == 0)
+            continue;
+
+         reference.type = References::Type::Tag;
+         reference.sha = QString::fromLatin1(fields[GitBase::PeeledShaField], sizes[GitBase::PeeledShaField]);
+      }
+      else
+      {
+         if (kind == "refs/heads")
+            reference.type = References::Type::LocalBranch;
+         else if (kind == "refs/remotes" && !field(GitBase::ShortNameField).endsWith("/HEAD"))
+            reference.type = References::Type::RemoteBranches;
+         else
+            continue;
+
+         reference.sha = QString::fromLatin1(fields[GitBase::ShaField], sizes[GitBase::ShaField]);
+      }
+
+      reference.refName = QString::fromUtf8(fields[GitBase::RefNameField], sizes[GitBase::RefNameField]);
+      reference.name = QString::fromUtf8(fields[GitBase::ShortNameField], sizes[GitBase::ShortNameField]);
+
+      if (tracking && reference.type == References::Type::LocalBranch)
+      {
+         // The track is empty, "gone" or the distances: "ahead 1", "behind 2" or "ahead 1, behind 2". The record ends
+         // with the line feed or the null of the output, so the numbers are read in place.
+         const auto track = field(GitBase::UpstreamTrackField);
+         const auto ahead = track.indexOf("ahead ");
+         const auto behind = track.indexOf("behind ");
+
+         reference.hasTracking = true;
+
+         if (ahead != -1)
+            reference.aheadUpstream = static_cast<int>(std::strtol(track.constData() + ahead + 6, nullptr, 10));
+
+         if (behind != -1)
+            reference.behindUpstream = static_cast<int>(std::strtol(track.constData() + behind + 7, nullptr, 10));
+      }
+
+      references.append(reference);
+   }
+
+   return references;
+}
+
+void GitRepoLoader::loadLocalBranchesDistances(const QVector<Reference> &references)
+{
+   QVector<QPair<QString, QString>> localBranches;
+   QHash<QString, QString> remoteBranches;
+   QHash<QString, RevisionsCache::LocalBranchDistances> distances;
+   auto missingTracking = false;
+
+   for (const auto &reference : references)
+   {
+      if (reference.type == References::Type::LocalBranch)
+      {
+         localBranches.append(qMakePair(reference.name, reference.sha));
+
+         if (reference.hasTracking)
          {
-            auto localBranches = false;
-            References::Type type;
-            QString name;
+            auto &branchDistances = distances[reference.name];
+            branchDistances.aheadOrigin = reference.aheadUpstream;
+            branchDistances.behindOrigin = reference.behindUpstream;
+         }
+         else
+            missingTracking = true;
+      }
+      else if (reference.type == References::Type::RemoteBranches)
+         remoteBranches.insert(reference.name, reference.sha);
+   }
 
-            if (refName.startsWith("refs/tags/"))
-            {
-               type = References::Type::Tag;
-               name = refName.mid(10, reference.length());
-               name.remove("^{}");
-            }
-            else if (refName.startsWith("refs/heads/"))
-            {
-               type = References::Type::LocalBranch;
-               name = refName.mid(11);
-               localBranches = true;
-            }
-            else if (refName.startsWith("refs/remotes/") && !refName.endsWith("HEAD"))
-            {
-               type = References::Type::RemoteBranches;
-               name = refName.mid(13);
-            }
-            else
-               continue;
+   QLog_Debug("Git", QString("Calculating the distances of {%1} local branches.").arg(localBranches.count()));
+
+   // The distances to the upstream branches that didn't come with the references are given by git in one call.
+   const auto tracking = missingTracking
+       ? mGitBase->run("git for-each-ref --format=%(refname:short)%09%(upstream:track,nobracket) refs/heads")
+       : GitExecResult(false, QVariant());
+
+   if (tracking.success)
+   {
+      const auto lines = tracking.output.toString().split('\n', QString::SkipEmptyParts);
+
+      for (const auto &line : lines)
+      {
+         const auto separator = line.indexOf('\t');
+         const auto name = line.left(separator);
+         const auto values = line.mid(separator + 1).split(", ", QString::SkipEmptyParts);
+         auto &branchDistances = distances[name];
+
+         for (const auto &value : values)
+         {
+            if (value.startsWith("ahead "))
+               branchDistances.aheadOrigin = value.mid(6).toInt();
+            else if (value.startsWith("behind "))
+               branchDistances.behindOrigin = value.mid(7).toInt();
+         }
+      }
+   }
 
-            mRevCache->insertReference(revSha, type, name);
+   // The distances to master are calculated walking the history already loaded in the cache. Git is only called for
+   // those branches whose history is not completely loaded.
+   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
+   const auto masterRemote = gitConfig->getRemoteForBranch("master");
+   const auto masterName = QString("%1/master").arg(masterRemote.output.toString());
+   const auto masterSha = masterRemote.success ? remoteBranches.value(masterName) : QString();
+
+   if (!masterSha.isEmpty())
+   {
+      QStringList shas;
 
-            if (localBranches)
+      for (const auto &branch : localBranches)
+         shas.append(branch.second);
+
+      const auto masterDistances = mRevCache->getDistances(masterSha, shas);
+
+      for (auto i = 0; i < localBranches.count(); ++i)
+      {
+         auto &branchDistances = distances[localBranches.at(i).first];
+         const auto &distance = masterDistances.at(i);
+
+         if (distance.first != -1)
+         {
+            branchDistances.aheadMaster = distance.first;
+            branchDistances.behindMaster = distance.second;
+         }
+         else
+         {
+            const auto ret = mGitBase->run(
+                QString("git rev-list --left-right --count %1...%2").arg(masterName, localBranches.at(i).first));
+
+            if (ret.success)
             {
-               const auto git = new GitBranches(mGitBase);
-               RevisionsCache::LocalBranchDistances distances;
-
-               const auto distToMaster = git->getDistanceBetweenBranches(true, name);
-               auto toMaster = distToMaster.output.toString();
-
-               if (!toMaster.contains("fatal"))
-               {
-                  toMaster.replace('\n', "");
-                  const auto values = toMaster.split('\t');
-                  distances.behindMaster = values.first().toUInt();
-                  distances.aheadMaster = values.last().toUInt();
-               }
-
-               const auto distToOrigin = git->getDistanceBetweenBranches(false, name);
-               auto toOrigin = distToOrigin.output.toString();
-
-               if (!toOrigin.contains("fatal"))
-               {
-                  toOrigin.replace('\n', "");
-                  const auto values = toOrigin.split('\t');
-                  distances.behindOrigin = values.first().toUInt();
-                  distances.aheadOrigin = values.last().toUInt();
-               }
-
-               mRevCache->insertLocalBranchDistances(name, distances);
+               const auto values = ret.output.toString().trimmed().split('\t');
+               branchDistances.behindMaster = values.first().toInt();
+               branchDistances.aheadMaster = values.last().toInt();
             }
          }
-
-         prevRefSha = revSha;
       }
    }
+
+   for (const auto &branch : localBranches)
+      mRevCache->insertLocalBranchDistances(branch.first, distances.value(branch.first));
+}
+
+void GitRepoLoader::moveCurrentBranch(const QString &fromSha, const QString &toSha)
+{
+   const auto branch = mGitBase->getCurrentBranch();
+   const auto refName = QString("refs/heads/%1").arg(branch);
+   auto reference = mLoadedReferences.value(refName);
+
+   // With a detached HEAD no branch moved, but a reference might point to it.
+   if (reference.refName.isEmpty() || reference.sha != fromSha)
+   {
+      loadReferences();
+      return;
+   }
+
+   reference.sha = toSha;
+   reference.hasTracking = false;
+   mLoadedReferences.insert(refName, reference);
+
+   // Publishing the new commits clears the references of the history, they are set again from the ones loaded. Only
+   // the distances of the branch moved change. The remote branches give the distances to master.
+   QVector<Reference> references { reference };
+
+   for (const auto &loaded : qAsConst(mLoadedReferences))
+   {
+      mRevCache->insertReference(loaded.sha, loaded.type, loaded.name);
+
+      if (loaded.type == References::Type::RemoteBranches)
+         references.append(loaded);
+   }
+
+   loadLocalBranchesDistances(references);
+}
+
+bool GitRepoLoader::loadCommittedRevision()
+{
+   TraceSpan span("loader", "GitRepoLoader::loadCommittedRevision");
+
+   if (mLocked || mLoadedTips.isEmpty() || mLoadedWipParent.isEmpty() || mLoadedShowAll != mShowAll
+       || mLoadedWorkingDir != mGitBase->getWorkingDir() || mRevCache->count() <= 1)
+      return false;
+
+   // The SHA of HEAD followed by the SHA of its parents.
+   const auto ret = mGitBase->run("git rev-list --parents -n 1 HEAD");
+   const auto shas = ret.success ? ret.output.toString().trimmed().split(' ') : QStringList();
+
+   if (shas.count() != 2 || shas.last() != mLoadedWipParent)
+      return false;
+
+   QLog_Debug("Git", "Adding the new commit on top of the current history.");
+
+   mLocked = true;
+   mCommitDelta = true;
+
+   startLoadingTimings();
+
+   mRevCache->configureDelta();
+
+   updateWipRevision();
+
+   createBuilder();
+
+   const auto generation = ++mGeneration;
+   const auto wipParentSha = shas.first();
+   const auto previousWipParentSha = mLoadedWipParent;
+
+   mRequestedTips = mLoadedTips;
+   mRequestedTips.prepend(wipParentSha);
+   mRequestedWipParent = wipParentSha;
+
+   mBuilderQueue->post([builder = mBuilder, generation, wipParentSha, previousWipParentSha]() {
+      builder->initDelta(generation, wipParentSha, previousWipParentSha);
+   });
+
+   runLog(generation, QString("%1 --not %2").arg(wipParentSha, previousWipParentSha), false);
+
+   return true;
+}
+
+bool GitRepoLoader::loadPulledRevisions(const QString &previousHeadSha)
+{
+   TraceSpan span("loader", "GitRepoLoader::loadPulledRevisions");
+
+   if (mLocked || previousHeadSha.isEmpty() || previousHeadSha != mLoadedWipParent)
+      return false;
+
+   const auto head = mGitBase->getLastCommit();
+
+   if (!head.success)
+      return false;
+
+   const auto headSha = head.output.toString().trimmed();
+
+   if (headSha == previousHeadSha)
+      return updateReferences();
+
+   // The exit code tells if the previous HEAD is an ancestor of the new one.
+   if (!mGitBase->run(QString("git merge-base --is-ancestor %1 %2").arg(previousHeadSha, headSha)).success)
+      return false;
+
+   QLog_Debug("Git", "Adding the pulled commits on top of the current history.");
+
+   // The delta reads the commits that aren't reachable from the references loaded: the ones the pull brought.
+   mLocked = true;
+
+   if (!requestRevisionsDelta())
+   {
+      mLocked = false;
+      return false;
+   }
+
+   return true;
+}
+
+bool GitRepoLoader::loadNextPage()
+{
+   TraceSpan span("loader", "GitRepoLoader::loadNextPage");
+
+   if (mLocked || !mMorePages || mPageSize <= 0 || mLoadedWorkingDir != mGitBase->getWorkingDir())
+      return false;
+
+   const auto frontier = mRevCache->getHistoryFrontier(mLoadedTips);
+
+   // Too many commits would exceed the command line limits.
+   if (frontier.isEmpty() || frontier.count() > 500)
+   {
+      QLog_Debug("Git", QString("There is no page to load after {%1} commits.").arg(mRevCache->count()));
+
+      mMorePages = false;
+      return false;
+   }
+
+   QLog_Debug("Git", QString("Loading the next {%1} commits of the history.").arg(mPageSize));
+
+   mLocked = true;
+   mCommitDelta = false;
+   mPageLoad = true;
+   mPageFirstRow = mRevCache->count();
+
+   mRevCache->configurePage();
+
+   createBuilder();
+
+   const auto generation = ++mGeneration;
+   const auto wipParentSha = mLoadedWipParent;
+
+   mPageGeneration = generation;
+
+   mBuilderQueue->post([builder = mBuilder, generation, wipParentSha]() { builder->init(generation, wipParentSha); });
+
+   runLog(generation, QString("--max-count=%1 %2").arg(mPageSize).arg(frontier.join(' ')), false);
+
+   return true;
+}
+
+void GitRepoLoader::finishPage(bool morePages)
+{
+   mRevCache->publishGeneration();
+
+   mLocked = false;
+   mPageLoad = false;
+   mMorePages = morePages;
+
+   // The references of the commits that weren't loaded are added with them.
+   for (const auto &reference : qAsConst(mLoadedReferences))
+   {
+      if (mRevCache->getCommitPos(reference.sha) >= mPageFirstRow)
+         mRevCache->insertReference(reference.sha, reference.type, reference.name);
+   }
+
+   loadLocalBranchesDistances(QVector<Reference>::fromList(mLoadedReferences.values()));
+
+   QLog_Info("Git", QString("History page loaded. The history has {%1} commits.").arg(mRevCache->count()));
+
+   emit signalPageLoaded(mMorePages);
+}
+
+bool GitRepoLoader::loadAmendedRevision()
+{
+   TraceSpan span("loader", "GitRepoLoader::loadAmendedRevision");
+
+   if (mLocked || mLoadedWipParent.isEmpty() || mLoadedShowAll != mShowAll
+       || mLoadedWorkingDir != mGitBase->getWorkingDir())
+      return false;
+
+   const auto ret = mGitBase->run({ "log", "-1", "--no-color", "--log-size", "--parents", "-z",
+                                    QString("--pretty=format:%1").arg(GIT_LOG_FORMAT), "HEAD" });
+
+   if (!ret.success)
+      return false;
+
+   const CommitInfo commit(CommitInfo::splitRecords(ret.output.toByteArray()).value(0));
+   const auto refName = QString("refs/heads/%1").arg(mGitBase->getCurrentBranch());
+   auto branch = mLoadedReferences.value(refName);
+
+   if (!commit.isValid() || commit.sha() == mLoadedWipParent || branch.sha != mLoadedWipParent)
+      return false;
+
+   // Any other reference keeps the commit amended in the history.
+   for (const auto &reference : qAsConst(mLoadedReferences))
+   {
+      if (reference.sha == mLoadedWipParent && reference.refName != refName)
+         return false;
+   }
+
+   if (!mRevCache->replaceCommit(ObjectId::fromHex(mLoadedWipParent), commit))
+      return false;
+
+   QLog_Debug("Git", "Replacing the amended commit in the current history.");
+
+   startLoadingTimings();
+
+   std::replace(mLoadedTips.begin(), mLoadedTips.end(), mLoadedWipParent, commit.sha());
+   mRequestedTips = mLoadedTips;
+   mLoadedWipParent = commit.sha();
+   mRequestedWipParent = mLoadedWipParent;
+
+   branch.sha = mLoadedWipParent;
+   branch.hasTracking = false;
+   mLoadedReferences.insert(refName, branch);
+   mRevCache->insertReference(branch.sha, branch.type, branch.name);
+
+   QVector<Reference> references { branch };
+
+   for (const auto &reference : qAsConst(mLoadedReferences))
+   {
+      if (reference.type == References::Type::RemoteBranches)
+         references.append(reference);
+   }
+
+   loadLocalBranchesDistances(references);
+
+   updateWipRevision();
+
+   mTimings.totalMs = mLoadingTimer.elapsed();
+
+   emit signalLoadingTimings(mTimings);
+   emit signalLoadingFinished();
+
+   return true;
 }
 
 void GitRepoLoader::requestRevisions()
 {
+   TraceSpan span("loader", "GitRepoLoader::requestRevisions");
+
    QLog_Debug("Git", "Loading revisions.");
 
-   const auto baseCmd = QString("git log --date-order --no-color --log-size --parents --boundary -z --pretty=format:")
-                            .append(GIT_LOG_FORMAT)
-                            .append(mShowAll ? QString("--all") : mGitBase->getCurrentBranch());
+   mCommitDelta = false;
+   mPageLoad = false;
+   mMorePages = false;
+
+   startLoadingTimings();
+
+   mRevCache->configure(mRevCache->count());
+
+   QLog_Debug("Git", QString("Adding the WIP commit."));
+
+   updateWipRevision();
+
+   createBuilder();
+
+   // Every load is a new generation: whatever the builder is still doing for a previous load will be discarded.
+   const auto generation = ++mGeneration;
+   const auto wipParentSha = mRevCache->getCommitInfoByRow(0).parent(0);
+   const auto references = mGitBase->getReferences(false);
+
+   mRevCache->setLanesOrigin(wipParentSha);
+   const auto referencesList = references.success ? references.output.toString() : QString();
+   const auto diskCacheKey = getDiskCacheKey(wipParentSha, referencesList);
+   // A partial history is not cached, neither one without the details of the commits.
+   const auto diskCacheFile
+       = diskCacheKey.isEmpty() || mPageSize > 0 || mLazyCommitDetails ? QString() : getDiskCacheFile();
+
+   mPageGeneration = mPageSize > 0 ? generation : -1;
+
+   mRequestedTips = getReferenceTips(wipParentSha, referencesList);
+   mRequestedWipParent = wipParentSha;
+
+   mBuilderQueue->post([builder = mBuilder, generation, wipParentSha, diskCacheFile, diskCacheKey]() {
+      builder->init(generation, wipParentSha, diskCacheFile, diskCacheKey);
+      builder->loadFromDiskCache(generation);
+   });
+}
+
+bool GitRepoLoader::requestRevisionsDelta()
+{
+   TraceSpan span("loader", "GitRepoLoader::requestRevisionsDelta");
+
+   if (mLoadedTips.isEmpty() || mLoadedShowAll != mShowAll || mLoadedWorkingDir != mGitBase->getWorkingDir()
+       || mRevCache->count() <= 1)
+      return false;
+
+   const auto head = mGitBase->getLastCommit();
+   const auto references = mGitBase->getReferences(false);
+
+   if (!head.success || !references.success)
+      return false;
+
+   const auto wipParentSha = head.output.toString().trimmed();
+   const auto tips = getReferenceTips(wipParentSha, references.output.toString());
+
+   // Too many references would exceed the command line limits.
+   if (tips.isEmpty() || tips.count() + mLoadedTips.count() > 500)
+      return false;
+
+   mCommitDelta = false;
+
+   QStringList removedTips;
+
+   for (const auto &tip : qAsConst(mLoadedTips))
+   {
+      if (!tips.contains(tip))
+         removedTips.append(tip);
+   }
+
+   // If any commit is not reachable anymore the history was rewritten (amend, rebase, reset, deleted branch...).
+   if (!removedTips.isEmpty())
+   {
+      const auto ret = mGitBase->run(
+          QString("git rev-list --count %1 --not %2").arg(removedTips.join(' '), tips.join(' ')));
+
+      if (!ret.success || ret.output.toString().trimmed() != QString("0"))
+         return false;
+   }
+
+   QLog_Debug("Git", "Loading the new revisions on top of the current history.");
+
+   startLoadingTimings();
+
+   mRevCache->configureDelta();
+
+   updateWipRevision();
+
+   createBuilder();
+
+   const auto generation = ++mGeneration;
+   const auto previousWipParentSha = mLoadedWipParent;
+
+   mRequestedTips = tips;
+   mRequestedWipParent = wipParentSha;
+
+   mBuilderQueue->post([builder = mBuilder, generation, wipParentSha, previousWipParentSha]() {
+      builder->initDelta(generation, wipParentSha, previousWipParentSha);
+   });
+
+   runLog(generation, QString("%1 --not %2").arg(tips.join(' '), mLoadedTips.join(' ')), false);
+
+   return true;
+}
+
+void GitRepoLoader::requestRevisionsToGit(int generation)
+{
+   if (generation != mGeneration)
+      return;
+
+   // The commit-graph gives the date order, not the topological one of git.
+   const auto objectsDir = mCommitGraphLoading && mHistoryOrder != HistoryOrder::Topological && mPageSize == 0
+       ? getObjectsDir()
+       : QString();
+
+   if (objectsDir.isEmpty() || mRequestedWipParent.isEmpty())
+   {
+      runGitLog(generation);
+      return;
+   }
+
+   QLog_Debug("Git", "Loading the revisions from the commit-graph.");
+
+   const auto tips = getCommitGraphTips();
+   const auto firstParent = mHistoryOrder == HistoryOrder::FirstParent;
+
+   mBuilderQueue->post([builder = mBuilder, generation, objectsDir, tips, firstParent]() {
+      builder->loadFromCommitGraph(generation, objectsDir, tips, firstParent);
+   });
+}
+
+void GitRepoLoader::runGitLog(int generation)
+{
+   if (generation != mGeneration)
+      return;
+
+   QLog_Debug("Git", "Requesting the revisions to Git.");
+
+   const auto revisions = mShowAll ? QString("--all") : mGitBase->getCurrentBranch();
+
+   // The boundary would list the parents of the last commit of the page.
+   if (mPageSize > 0)
+      runLog(generation, QString("--max-count=%1 %2").arg(mPageSize).arg(revisions), false);
+   else
+      runLog(generation, revisions, true);
+}
+
+void GitRepoLoader::runLog(int generation, const QString &revisions, bool boundary)
+{
+   const auto baseCmd = QString("git %1 --no-color --log-size --parents%2 -z --pretty=format:")
+                            .arg(getHistoryOrderArgs(), boundary ? QString(" --boundary") : QString())
+                            .append(mLazyCommitDetails ? GIT_LOG_TOPOLOGY_FORMAT : GIT_LOG_FORMAT)
+                            .append(revisions);
 
    const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
-   connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevision);
+   connect(requestor, &GitRequestorProcess::procDataReady, this, [this, generation](const QByteArray &ba) {
+      mBuilderQueue->post([builder = mBuilder, generation, ba]() { builder->processData(generation, ba); });
+   });
+   connect(requestor, &GitRequestorProcess::procDataFinished, this, [this, generation]() {
+      mBuilderQueue->post([builder = mBuilder, generation]() { builder->finish(generation); });
+   });
+   connect(requestor, &GitRequestorProcess::procTimings, this,
+           [this, generation](qint64 spawnMs, qint64 firstByteMs, qint64 finishedMs) {
+              if (generation == mGeneration)
+              {
+                 mTimings.spawnMs = spawnMs;
+                 mTimings.firstByteMs = firstByteMs;
+                 mTimings.readMs = firstByteMs >= 0 ? finishedMs - firstByteMs : finishedMs - spawnMs;
+              }
+           });
    connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
 
+   mChunkTimer.invalidate();
+
    requestor->run(baseCmd);
 }
 
-void GitRepoLoader::processRevision(const QByteArray &ba)
+QString GitRepoLoader::getHistoryOrderArgs() const
 {
-   QLog_Debug("Git", "Processing revisions...");
+   if (mHistoryOrder == HistoryOrder::Date)
+      return QString("log --date-order");
 
-   const auto commits = ba.split('\000');
-   const auto totalCommits = commits.count();
-   auto count = 1;
+   // Without the generation numbers of the commit-graph git has to walk the whole history before it writes the first
+   // commit in topological order. The commit-graph is read by default since git 2.24, not before.
+   const QDir objects(getObjectsDir());
+   const auto hasCommitGraph = QFileInfo::exists(objects.filePath("info/commit-graph"))
+       || QFileInfo::exists(objects.filePath("info/commit-graphs/commit-graph-chain"));
 
-   QLog_Debug("Git", QString("There are {%1} commits to process.").arg(totalCommits));
+   if (!hasCommitGraph)
+      QLog_Debug("Git", "There is no commit-graph: the history in topological order is not streamed.");
 
-   mRevCache->configure(totalCommits);
+   return QString("%1log --topo-order%2")
+       .arg(hasCommitGraph ? QString("-c core.commitGraph=true ") : QString(),
+            mHistoryOrder == HistoryOrder::FirstParent ? QString(" --first-parent") : QString());
+}
 
-   emit signalLoadingStarted(totalCommits);
+QString GitRepoLoader::getObjectsDir() const
+{
+   // The objects of the linked work trees are in the common directory.
+   const auto reader = GitRepositoryReader(mGitBase->getWorkingDir());
+   const auto commonDir = reader.commonDir().isEmpty() ? mGitBase->getGitDir() : reader.commonDir();
 
-   QLog_Debug("Git", QString("Adding the WIP commit."));
+   return commonDir.isEmpty() ? QString() : QDir(commonDir).filePath("objects");
+}
 
-   updateWipRevision();
+QStringList GitRepoLoader::getCommitGraphTips() const
+{
+   QStringList tips { mRequestedWipParent };
+
+   if (!mShowAll)
+      return tips;
+
+   // Like git log --all, the annotated tags are followed to the commit they point to.
+   const auto references = mGitBase->getReferences(true);
+   const auto lines = references.success ? references.output.toString().split('\n', QString::SkipEmptyParts)
+                                         : QStringList();
 
-   for (const auto &commitInfo : commits)
+   for (const auto &line : lines)
    {
-      CommitInfo revision(commitInfo);
+      const auto sha = line.left(line.indexOf(' '));
 
-      if (revision.isValid())
-         mRevCache->insertCommitInfo(std::move(revision), count);
+      // The dereferenced tag follows the line of the tag object, that is not a commit.
+      if (line.endsWith("^{}"))
+         tips.last() = sha;
       else
+         tips.append(sha);
+   }
+
+   return tips;
+}
+
+QString GitRepoLoader::getDiskCacheFile() const
+{
+   const auto gitDir = mGitBase->getGitDir();
+
+   return gitDir.isEmpty() ? QString() : QDir(gitDir).absoluteFilePath(DISK_CACHE_FILE);
+}
+
+QString GitRepoLoader::getWarmStartFile() const
+{
+   const auto gitDir = mGitBase->getGitDir();
+
+   return gitDir.isEmpty() ? QString() : QDir(gitDir).absoluteFilePath(WARM_START_FILE);
+}
+
+void GitRepoLoader::saveWarmStart() const
+{
+   const auto file = getWarmStartFile();
+
+   if (!mDiskCacheEnabled || file.isEmpty())
+      return;
+
+   const auto rows = qMin(mRevCache->count() - 1, WarmStartSnapshot::ROWS);
+   QVector<CommitInfo> commits;
+   QVector<WarmStartSnapshot::Reference> references;
+
+   commits.reserve(rows);
+
+   for (auto row = 1; row <= rows; ++row)
+   {
+      const auto commit = mRevCache->getCommitInfoByRow(row);
+
+      // The rows without details would be kept without them when the next load starts with the same commits.
+      if (!commit.isValid() || !commit.hasDetails())
          break;
 
-      emit signalLoadingStep(count++);
+      for (const auto type : { References::Type::LocalBranch, References::Type::RemoteBranches, References::Type::Tag })
+      {
+         for (const auto &name : mRevCache->getReferences(commit.sha(), type))
+            references.append({ commit.sha(), type, name });
+      }
+
+      commits.append(commit);
+   }
+
+   if (!commits.isEmpty())
+      WarmStartSnapshot(file).save(mLoadedWipParent, commits, references);
+}
+
+QByteArray GitRepoLoader::getDiskCacheKey(const QString &headSha, const QString &references) const
+{
+   // The history shown depends on the tips of all the references, so any change in them invalidates the cache.
+   if (!mDiskCacheEnabled || references.isEmpty() || headSha.isEmpty())
+      return QByteArray();
+
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+   hash.addData(headSha.toUtf8());
+   hash.addData(mShowAll ? QByteArray("--all") : mGitBase->getCurrentBranch().toUtf8());
+   hash.addData(references.toUtf8());
+   hash.addData(QByteArray::number(static_cast<int>(mHistoryOrder)));
+
+   return hash.result();
+}
+
+QStringList GitRepoLoader::getReferenceTips(const QString &headSha, const QString &references) const
+{
+   QStringList tips;
+
+   if (!headSha.isEmpty())
+      tips.append(headSha);
+
+   if (mShowAll)
+   {
+      const auto referencesList = references.split('\n', QString::SkipEmptyParts);
+
+      for (const auto &reference : referencesList)
+      {
+         const auto sha = reference.left(40);
+
+         if (!tips.contains(sha))
+            tips.append(sha);
+      }
+   }
+
+   return tips;
+}
+
+void GitRepoLoader::createBuilder()
+{
+   if (!mBuilder)
+   {
+      // The builder runs in the worker pool: its signals are received in this thread.
+      mBuilder = new RevisionsBuilder(mRevCache.data());
+      mBuilderQueue.reset(new WorkerQueue(mRevCache.data(), WorkerPool::Priority::Refresh));
+
+      connect(mBuilder, &RevisionsBuilder::signalCommitsBuilt, this, &GitRepoLoader::onCommitsBuilt);
+      connect(mBuilder, &RevisionsBuilder::signalBuildFinished, this, &GitRepoLoader::onBuildFinished);
+      connect(mBuilder, &RevisionsBuilder::signalBuildTimings, this, &GitRepoLoader::onBuildTimings);
+      connect(mBuilder, &RevisionsBuilder::signalDiskCacheMissed, this, &GitRepoLoader::requestRevisionsToGit);
+      connect(mBuilder, &RevisionsBuilder::signalCommitGraphMissed, this, &GitRepoLoader::runGitLog);
+      connect(mBuilder, &RevisionsBuilder::signalDeltaLanes, this, &GitRepoLoader::onDeltaLanes);
+      connect(mBuilder, &RevisionsBuilder::signalBuildCancelled, this, &GitRepoLoader::onBuildCancelled);
+   }
+}
+
+void GitRepoLoader::onCommitsBuilt(int generation, const QVector<CommitInfo *> &commits)
+{
+   TraceSpan span("loader", "GitRepoLoader::onCommitsBuilt");
+
+   if (generation != mGeneration)
+   {
+      QLog_Trace("Git", QString("Discarding {%1} commits of an old generation.").arg(commits.count()));
+
+      qDeleteAll(commits);
+      return;
+   }
+
+   mRevCache->insertCommits(commits);
+
+   mLoadedCommits += commits.count();
+
+   if (!mProgressTimer.isValid() || mProgressTimer.elapsed() >= PROGRESS_INTERVAL_MS)
+   {
+      mProgressTimer.restart();
+
+      emit signalLoadingProgress(mLoadedCommits);
+   }
+
+   // The views are notified periodically: updating them for every chunk would be more expensive than the parsing.
+   // When the history is being reloaded, the views keep showing the old one until the new generation is published.
+   if (mRevCache->isIncrementalLoad() && (!mChunkTimer.isValid() || mChunkTimer.elapsed() >= 250))
+   {
+      mChunkTimer.restart();
+
+      emit signalRevisionsChunkLoaded(mRevCache->count());
+   }
+}
+
+void GitRepoLoader::onBuildFinished(int generation, int totalCommits)
+{
+   TraceSpan span("loader", "GitRepoLoader::onBuildFinished");
+
+   if (generation != mGeneration)
+      return;
+
+   if (generation == mPageGeneration)
+      mMorePages = totalCommits >= mPageSize;
+
+   if (mPageLoad)
+   {
+      finishPage(mMorePages);
+      return;
    }
 
+   mRevCache->publishGeneration();
+
+   const auto previousWipParent = mLoadedWipParent;
+
+   mLoadedTips = mRequestedTips;
+   mLoadedWipParent = mRequestedWipParent;
+   mLoadedWorkingDir = mGitBase->getWorkingDir();
+   mLoadedShowAll = mShowAll;
+
    mLocked = false;
 
-   loadReferences();
+   QElapsedTimer referencesTimer;
+   referencesTimer.start();
+
+   // After a commit only the current branch moved.
+   if (mCommitDelta)
+      moveCurrentBranch(previousWipParent, mLoadedWipParent);
+   else
+      loadReferences();
+
+   mCommitDelta = false;
+
+   mTimings.referencesMs = referencesTimer.elapsed();
+
+   saveWarmStart();
 
+   mTimings.totalMs = mLoadingTimer.elapsed();
+
+   if (mTraceLoadStart >= 0)
+   {
+      const auto end = TraceRecorder::now();
+      TraceRecorder::instance().record("loader", "History load", mTraceLoadStart, end - mTraceLoadStart);
+   }
+
+   QLog_Info("Git",
+             QString("History loaded with {%1} commits. Timings: %2").arg(totalCommits).arg(mTimings.toString()));
+
+   emit signalLoadingProgress(totalCommits);
+   emit signalLoadingTimings(mTimings);
    emit signalLoadingFinished();
 }
 
+void GitRepoLoader::onBuildTimings(int generation, qint64 parseMs, qint64 lanesMs)
+{
+   if (generation == mGeneration)
+   {
+      mTimings.parseMs = parseMs;
+      mTimings.lanesMs = lanesMs;
+   }
+}
+
+void GitRepoLoader::startLoadingTimings()
+{
+   mTimings = LoadingTimings();
+   mLoadingTimer.start();
+   mTraceLoadStart = TraceRecorder::instance().isEnabled() ? TraceRecorder::now() : -1;
+   mProgressTimer.invalidate();
+   mLoadedCommits = 0;
+}
+
+void GitRepoLoader::cancelAll(bool keepPartialResults)
+{
+   emit cancelAllProcesses(QPrivateSignal());
+
+   if (mLocked && mBuilder)
+   {
+      const auto generation = mGeneration;
+
+      // A partial reload would replace a complete history, so the results are only kept for the first load.
+      keepPartialResults = keepPartialResults && mRevCache->isIncrementalLoad();
+
+      // The partial history can't be used as the base of a delta refresh.
+      mRequestedTips.clear();
+
+      mBuilderQueue->post(
+          [builder = mBuilder, generation, keepPartialResults]() { builder->cancel(generation, keepPartialResults); });
+
+      // The partial results are published when the builder finishes. Otherwise, everything that is still on its way
+      // belongs to an old generation from now on and a new load can start right away.
+      if (!keepPartialResults)
+      {
+         ++mGeneration;
+
+         mRevCache->discardGeneration();
+         mLocked = false;
+      }
+   }
+}
+
+void GitRepoLoader::onBuildCancelled(int generation)
+{
+   if (generation != mGeneration)
+      return;
+
+   // The commits of a page are already in the history: the next page continues from them.
+   if (mPageLoad)
+   {
+      finishPage(true);
+      return;
+   }
+
+   mRevCache->discardGeneration();
+   mLocked = false;
+}
+
+void GitRepoLoader::onDeltaLanes(int generation, const Lanes &lanes, const Lanes &expectedLanes)
+{
+   if (generation != mGeneration)
+      return;
+
+   QLog_Debug("Git", "The new revisions change the lanes of the history below them.");
+
+   mRevCache->setDeltaLanes(lanes, expectedLanes);
+}
+
 void GitRepoLoader::updateWipRevision()
 {
-   QLog_Debug("Git", QString("Executing updateWipRevision."));
+   TraceSpan span("loader", "GitRepoLoader::updateWipRevision");
 
-   mRevCache->setUntrackedFilesList(getUntrackedFiles());
+   QLog_Debug("Git", QString("Executing updateWipRevision."));
 
-   const auto ret = mGitBase->run("git rev-parse --revs-only HEAD");
+   const auto head = mGitBase->getLastCommit();
 
-   if (ret.success)
+   if (head.success)
    {
-      const auto parentSha = ret.output.toString().trimmed();
+      // A single status lists the changes against HEAD and the ones in the index. It doesn't refresh the index: that
+      // would be another change seen by the file watcher. With a file system monitor, the index keeps the point since
+      // which the monitor is asked, so it's refreshed from time to time. The untracked files can be many more than
+      // the changes and are listed afterwards in the background, the WIP keeps the last ones known meanwhile.
+      QStringList arguments { "status", "--porcelain=v2", "-z", "--untracked-files=no", "--no-renames" };
+
+      if (GitConfig(mGitBase).isFsmonitorEnabled()
+          && (!mIndexRefreshTimer.isValid() || mIndexRefreshTimer.elapsed() > INDEX_REFRESH_INTERVAL_MS))
+         mIndexRefreshTimer.start();
+      else
+         arguments.prepend("--no-optional-locks");
 
-      const auto ret3 = mGitBase->run(QString("git diff-index %1").arg(parentSha));
-      const auto diffIndex = ret3.success ? ret3.output.toString() : QString();
+      const auto status = mGitBase->run(arguments);
+      const auto parentSha = head.output.toString().trimmed();
 
-      const auto ret4 = mGitBase->run(QString("git diff-index --cached %1").arg(parentSha));
-      const auto diffIndexCached = ret4.success ? ret4.output.toString() : QString();
+      mRevCache->updateWipCommit(parentSha, status.success ? status.output.toByteArray() : QByteArray(), true);
 
-      mRevCache->updateWipCommit(parentSha, diffIndex, diffIndexCached);
+      requestUntrackedFiles(parentSha);
    }
 }
 
-QVector<QString> GitRepoLoader::getUntrackedFiles() const
+void GitRepoLoader::requestUntrackedFiles(const QString &parentSha)
 {
-   QLog_Debug("Git", QString("Executing getUntrackedFiles."));
+   // Only the list of the last update of the WIP matters.
+   if (mUntrackedRequest != 0)
+      mGitBase->cancel(mUntrackedRequest);
+
+   QStringList arguments { "ls-files", "--others", "--exclude-standard", "-z" };
+
+   if (mCollapseUntrackedDirs)
+      arguments.append("--directory");
+
+   // In a sparse checkout the directories out of the cone are not walked.
+   if (!mSparseCone.isEmpty())
+      arguments << "--" << GitSparseCheckout::getPathspecs(mSparseCone);
+
+   mUntrackedRequest = mGitBase->runAsync(
+       arguments, this,
+       [this, parentSha](const GitExecResult &ret) {
+          mUntrackedRequest = 0;
+
+          if (ret.success && mRevCache->updateWipUntrackedFiles(parentSha, ret.output.toByteArray()))
+             emit signalUntrackedFilesLoaded();
+       },
+       GitBase::Priority::Refresh);
+}
+
+bool GitRepoLoader::updateWipRevision(const QStringList &paths)
+{
+   TraceSpan span("loader", "GitRepoLoader::updateWipRevision");
+
+   if (paths.isEmpty() || paths.count() > MAX_PARTIAL_WIP_PATHS || paths.contains("."))
+      return false;
+
+   const auto head = mGitBase->getLastCommit();
+
+   if (!head.success)
+      return false;
+
+   QLog_Debug("Git", QString("Executing updateWipRevision for {%1} paths.").arg(paths.count()));
 
-   auto runCmd = QString("git ls-files --others");
-   const auto exFile = QString(".git/info/exclude");
-   const auto path = QString("%1/%2").arg(mGitBase->getWorkingDir(), exFile);
+   QStringList arguments { "--no-optional-locks", "status", "--porcelain=v2", "-z",
+                           mCollapseUntrackedDirs ? "--untracked-files=normal" : "--untracked-files=all",
+                           "--no-renames", "--" };
 
-   if (QFile::exists(path))
-      runCmd.append(QString(" --exclude-from=$%1$").arg(exFile));
+   for (const auto &path : paths)
+      arguments.append(QString(":(literal)%1").arg(path));
 
-   runCmd.append(QString(" --exclude-per-directory=$%1$").arg(".gitignore"));
+   const auto status = mGitBase->run(arguments);
 
-   return mGitBase->run(runCmd).output.toString().split('\n', QString::SkipEmptyParts).toVector();
+   return status.success
+       && mRevCache->patchWipCommit(head.output.toString().trimmed(), paths, status.output.toByteArray());
 }
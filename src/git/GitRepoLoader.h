@@ -24,42 +24,351 @@
  ***************************************************************************************/
 
 #include <GitExecResult.h>
+#include <References.h>
 
+#include <QHash>
 #include <QObject>
+#include <QScopedPointer>
 #include <QSharedPointer>
 #include <QVector>
+#include <QStringList>
+#include <QElapsedTimer>
 
 class GitBase;
 class RevisionsCache;
+class RevisionsBuilder;
+class CommitInfo;
+class Lanes;
+class WorkerQueue;
+
+/*!
+ \brief The LoadingTimings struct contains the time spent in every phase of the load of the repository history. A value
+ of -1 means that the phase didn't happen (e.g. there is no process when the history comes from the disk cache).
+*/
+struct LoadingTimings
+{
+   qint64 spawnMs = -1;
+   qint64 firstByteMs = -1;
+   qint64 readMs = -1;
+   qint64 parseMs = -1;
+   qint64 lanesMs = -1;
+   qint64 referencesMs = -1;
+   qint64 totalMs = -1;
+
+   QString toString() const;
+};
 
 class GitRepoLoader : public QObject
 {
    Q_OBJECT
 
 signals:
-   void signalLoadingStarted(int total);
-   void signalLoadingStep(int value);
+   /*!
+    \brief Signal triggered while the revisions are streamed from git. It's emitted periodically so the views can show
+    the history that is already available without waiting for the whole log.
+
+    \param totalCommits The number of commits stored in the cache, including the WIP commit.
+   */
+   void signalRevisionsChunkLoaded(int totalCommits);
    void signalLoadingFinished();
+   /*!
+    \brief Signal triggered while the history is being loaded. It's emitted at most once every PROGRESS_INTERVAL_MS.
+
+    \param loadedCommits The number of commits loaded so far.
+   */
+   void signalLoadingProgress(int loadedCommits);
+   /*!
+    \brief Signal triggered when the history is loaded with the time spent in every phase.
+
+    \param timings The timings of the load.
+   */
+   void signalLoadingTimings(const LoadingTimings &timings);
+   /*!
+    \brief Signal triggered when the untracked files, listed in the background after an update of the WIP, are in the
+    WIP commit.
+   */
+   void signalUntrackedFilesLoaded();
+   /*!
+    \brief Signal triggered when the references are updated without loading the history again.
+
+    \param shas The commits whose references changed.
+   */
+   void signalReferencesUpdated(const QStringList &shas);
+   /*!
+    \brief Signal triggered when HEAD moves to another commit of the history without loading it again (a checkout).
+    The WIP is on top of the new HEAD and the lanes of the graph are calculated again.
+   */
+   void signalHeadMoved();
+   /*!
+    \brief Signal triggered when a page of a partial history is added below the commits loaded, see
+    \ref loadNextPage.
+
+    \param moreRevisions True if there are more commits to load after it.
+   */
+   void signalPageLoaded(bool moreRevisions);
    void cancelAllProcesses(QPrivateSignal);
 
 public:
+   /*!
+    \brief The order the commits of the history are listed in.
+   */
+   enum class HistoryOrder
+   {
+      Date, // git log --date-order. With skewed committer clocks it can produce very wide graphs.
+      Topological, // git log --topo-order. It keeps the lines of development together.
+      FirstParent // Only the first parent of every merge, in topological order.
+   };
+
    explicit GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<RevisionsCache> cache,
                           QObject *parent = nullptr);
+   ~GitRepoLoader();
+   /*!
+    \brief Configures the repository and starts loading its history. See \ref configureRepository and
+    \ref loadRevisions.
+
+    \return True if the load started.
+   */
    bool loadRepository();
+   /*!
+    \brief Finds the root of the repository and its current branch, without loading anything else.
+
+    \return True if the working directory is a git repository.
+   */
+   bool configureRepository();
+   /*!
+    \brief Starts loading the history of a repository already configured. Only the new commits are loaded when the
+    history loaded can be extended. The load finishes with \ref signalLoadingFinished.
+
+    \return True if the load started, false if another one is running.
+   */
+   bool loadRevisions();
+   /*!
+    \brief Shows the first rows of the history stored when the repository was loaded the last time, without asking git.
+    The load that follows keeps them in place if the history still starts with them, otherwise it replaces them. It
+    does nothing if there is a history loaded already.
+
+    \return True if the rows were added to the cache. They are notified with \ref signalRevisionsChunkLoaded.
+   */
+   bool loadWarmStart();
+   /*!
+    \brief Tells if a load of the history is running.
+   */
+   bool isLoading() const { return mLocked; }
+   /*!
+    \brief Returns the timings of the last load of the history. They are -1 until a load finishes.
+   */
+   const LoadingTimings &timings() const { return mTimings; }
    void updateWipRevision();
-   void cancelAll();
+   /*!
+    \brief Updates the WIP only for some paths, asking git only about them.
+
+    \param paths The files or directories changed, relative to the root of the repository.
+    \return False if the WIP can't be updated partially (there are too many paths, or no WIP to update) and it needs
+    a complete update.
+   */
+   bool updateWipRevision(const QStringList &paths);
+   /*!
+    \brief Cancels the running processes and the load of the repository. It doesn't wait for the processes to finish.
+
+    \param keepPartialResults If true, the commits already loaded are kept and shown as the history.
+   */
+   void cancelAll(bool keepPartialResults = false);
+   /*!
+    \brief Applies to the cache the references added, removed or moved since they were loaded, without loading the
+    history again. It's only possible if all the references point to commits in the cache and HEAD didn't move, or it
+    moved to another commit of the history while all the branches are shown (a checkout): then the WIP is updated and
+    \ref signalHeadMoved is emitted.
+
+    \return True if the references are up to date, false if the history needs to be loaded again.
+   */
+   bool updateReferences();
+   /*!
+    \brief Adds the commit just created on top of the history loaded, without loading the history again: only the new
+    commit is read from git and its lanes are calculated on top of the current ones, the current branch moves to it and
+    the WIP is updated. The load finishes with \ref signalLoadingFinished.
+
+    \return True if the commit is being added, false if the history must be loaded again because HEAD is not a child
+    of the commit loaded as its parent (an amend, a merge...).
+   */
+   bool loadCommittedRevision();
+   /*!
+    \brief Replaces the commit loaded as the parent of the WIP by the one that amends it, without loading the history
+    again: the new commit takes its row and its lanes, the current branch moves to it and the WIP is updated. It's
+    done synchronously and finishes with \ref signalLoadingFinished.
+
+    \return True if the commit was replaced, false if the history must be loaded again because HEAD doesn't amend the
+    commit loaded or the commit amended is still reachable from another reference or commit.
+   */
+   bool loadAmendedRevision();
+   /*!
+    \brief Adds the commits a pull brought on top of the history loaded, without loading the history again. It's only
+    possible for a fast-forward: HEAD moved from the commit loaded as its parent to one of its descendants. Then only
+    the range of new commits is read from git and its lanes are calculated on top of the current ones. When HEAD
+    didn't move only the references are updated, see \ref updateReferences.
+
+    \param previousHeadSha The SHA of HEAD before the pull.
+    \return True if the history is being updated, false if it must be loaded again (a merge, a rebase...).
+   */
+   bool loadPulledRevisions(const QString &previousHeadSha);
+   /*!
+    \brief Loads the next page of a partial history, see \ref setHistoryPageSize. The commits are added below the
+    ones loaded, where the lanes of the last row continue, and the load finishes with \ref signalPageLoaded.
+
+    \return True if the page is being loaded, false if the whole history is loaded or git is loading data.
+   */
+   bool loadNextPage();
+   /*!
+    \brief Tells if the history loaded is partial and there are more commits to load with \ref loadNextPage.
+   */
+   bool hasMoreRevisions() const { return mMorePages; }
+   /*!
+    \brief Loads the history in pages of the given number of commits: the first load only reads the most recent ones
+    and the rest are read on demand. The history is not cached on disk nor read from the commit-graph then. It applies
+    from the next load.
+
+    \param pageSize The commits of every page, 0 to load the whole history.
+   */
+   void setHistoryPageSize(int pageSize) { mPageSize = pageSize; }
    void setShowAll(bool showAll = true) { mShowAll = showAll; }
    bool showsAll() const { return mShowAll; }
+   /*!
+    \brief Lists the untracked directories as a whole instead of every file inside them, like git ls-files
+    --directory.
+
+    \param collapse True to list the untracked directories, otherwise false.
+   */
+   void setCollapseUntrackedDirs(bool collapse) { mCollapseUntrackedDirs = collapse; }
+   /*!
+    \brief Enables the cache of the history on disk. Without it, the history is always asked to git and never saved.
+
+    \param enabled True to use the cache on disk, otherwise false.
+   */
+   void setDiskCacheEnabled(bool enabled) { mDiskCacheEnabled = enabled; }
+   /*!
+    \brief Sets the order of the history. It applies from the next load.
+
+    \param order The order of the commits.
+   */
+   void setHistoryOrder(HistoryOrder order) { mHistoryOrder = order; }
+   /*!
+    \brief Returns the order of the history given its name in the settings: "date", "topo" or "first-parent". Any other
+    name is the date order.
+
+    \param name The name of the order.
+   */
+   static HistoryOrder historyOrderFromString(const QString &name);
+   /*!
+    \brief Loads the topology of the history from the commit-graph of the repository, when it has one and the order is
+    not topological, instead of running git log. The authors and the logs are read later, only for the rows shown.
+
+    \param enabled True to load from the commit-graph, otherwise false.
+   */
+   void setCommitGraphLoading(bool enabled) { mCommitGraphLoading = enabled; }
+   /*!
+    \brief Makes git log read only the topology, the dates and the short logs of the history. The authors and the long
+    logs are read later, only for the rows shown. The history loaded this way is not stored in the disk cache.
+
+    \param enabled True to read the details of the commits later, otherwise false.
+   */
+   void setLazyCommitDetails(bool enabled) { mLazyCommitDetails = enabled; }
+
+   /*!
+    \brief The format of the commits given to git log, as CommitInfo parses them: the fields are separated by the
+    unit separator character (0x1f) and the commits by the NUL of -z.
+   */
+   static const QString GIT_LOG_FORMAT;
+   /*!
+    \brief The format of git log with the same fields as GIT_LOG_FORMAT but the authors and the long log empty.
+    CommitInfo parses the commits without their details.
+   */
+   static const QString GIT_LOG_TOPOLOGY_FORMAT;
+
+   static constexpr int PROGRESS_INTERVAL_MS = 100;
+   /*!
+    \brief How often the WIP update lets git write the index when a file system monitor is used, so the monitor and
+    the untracked cache are not asked about older and older changes.
+   */
+   static constexpr int INDEX_REFRESH_INTERVAL_MS = 60000;
+   /*!
+    \brief The maximum number of paths of a partial WIP update. With more, a complete update is as fast.
+   */
+   static constexpr int MAX_PARTIAL_WIP_PATHS = 100;
 
 private:
+   struct Reference
+   {
+      QString refName;
+      QString sha;
+      References::Type type = References::Type::LocalBranch;
+      QString name;
+      // The distances of a local branch to its upstream, if they were loaded with the reference.
+      bool hasTracking = false;
+      int aheadUpstream = 0;
+      int behindUpstream = 0;
+   };
+
    bool mShowAll = true;
    bool mLocked = false;
+   bool mCollapseUntrackedDirs = false;
+   bool mDiskCacheEnabled = true;
+   HistoryOrder mHistoryOrder = HistoryOrder::Date;
+   bool mCommitGraphLoading = false;
+   bool mLazyCommitDetails = false;
+   int mUntrackedRequest = 0;
+   bool mCommitDelta = false;
+   int mPageSize = 0;
+   // The generation that loads a page, either the first one of the history or the next one.
+   int mPageGeneration = -1;
+   bool mPageLoad = false;
+   int mPageFirstRow = 0;
+   bool mMorePages = false;
    QSharedPointer<GitBase> mGitBase;
    QSharedPointer<RevisionsCache> mRevCache;
+   RevisionsBuilder *mBuilder = nullptr;
+   QScopedPointer<WorkerQueue> mBuilderQueue;
+   int mGeneration = 0;
+   QElapsedTimer mChunkTimer;
+   QElapsedTimer mProgressTimer;
+   QElapsedTimer mLoadingTimer;
+   qint64 mTraceLoadStart = -1;
+   QElapsedTimer mIndexRefreshTimer;
+   LoadingTimings mTimings;
+   int mLoadedCommits = 0;
+   QStringList mRequestedTips;
+   QString mRequestedWipParent;
+   QStringList mLoadedTips;
+   QString mLoadedWipParent;
+   QString mLoadedWorkingDir;
+   // The directories checked out in a sparse checkout, empty if the whole work tree is.
+   QStringList mSparseCone;
+   bool mLoadedShowAll = true;
+   QHash<QString, Reference> mLoadedReferences;
 
-   bool configureRepoDirectory();
+   bool configureRepoDirectory(const GitExecResult &ret);
    void loadReferences();
+   static QVector<Reference> parseReferences(const QByteArray &records, bool tracking);
+   void loadLocalBranchesDistances(const QVector<Reference> &references);
+   void moveCurrentBranch(const QString &fromSha, const QString &toSha);
+   void finishPage(bool morePages);
    void requestRevisions();
-   void processRevision(const QByteArray &ba);
-   QVector<QString> getUntrackedFiles() const;
+   bool requestRevisionsDelta();
+   void createBuilder();
+   void requestRevisionsToGit(int generation);
+   void runGitLog(int generation);
+   void runLog(int generation, const QString &revisions, bool boundary);
+   QString getHistoryOrderArgs() const;
+   QString getObjectsDir() const;
+   QStringList getCommitGraphTips() const;
+   void requestUntrackedFiles(const QString &parentSha);
+   QString getDiskCacheFile() const;
+   QString getWarmStartFile() const;
+   void saveWarmStart() const;
+   QByteArray getDiskCacheKey(const QString &headSha, const QString &references) const;
+   QStringList getReferenceTips(const QString &headSha, const QString &references) const;
+   void onCommitsBuilt(int generation, const QVector<CommitInfo *> &commits);
+   void onBuildFinished(int generation, int totalCommits);
+   void onBuildTimings(int generation, qint64 parseMs, qint64 lanesMs);
+   void startLoadingTimings();
+   void onDeltaLanes(int generation, const Lanes &lanes, const Lanes &expectedLanes);
+   void onBuildCancelled(int generation);
 };
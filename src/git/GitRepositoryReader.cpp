@@ -0,0 +1,476 @@
+#include "GitRepositoryReader.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+constexpr int SHA_LENGTH = 40;
+constexpr int SHA_BYTES = 20;
+constexpr auto PACK_TAG_TYPE = 4;
+
+bool isSha(const QString &text)
+{
+   return text.size() == SHA_LENGTH
+       && std::all_of(text.cbegin(), text.cend(), [](QChar c) { return c.isDigit() || (c >= 'a' && c <= 'f'); });
+}
+
+QByteArray readFile(const QString &path)
+{
+   QFile file(path);
+
+   return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+/*!
+ \brief Inflates a zlib stream whose size is unknown or only estimated. qUncompress expects the size in the first four
+ bytes but it grows the buffer if it's not enough.
+*/
+QByteArray inflate(const QByteArray &compressed, quint32 sizeHint)
+{
+   QByteArray data(4, '\0');
+   qToBigEndian(qMax(sizeHint, 1u), reinterpret_cast<uchar *>(data.data()));
+   data.append(compressed);
+
+   return qUncompress(data);
+}
+
+/*!
+ \brief Finds the offset of an object in a pack looking for it in the index file, in the version 2 format.
+*/
+bool findInPackIndex(const QByteArray &index, const QByteArray &sha, quint64 &offset)
+{
+   constexpr auto fanoutStart = 8;
+   constexpr auto namesStart = fanoutStart + 256 * 4;
+
+   if (index.size() < namesStart || !index.startsWith("\377tOc") || qFromBigEndian<quint32>(index.constData() + 4) != 2)
+      return false;
+
+   const auto data = reinterpret_cast<const uchar *>(index.constData());
+   const auto firstByte = static_cast<uchar>(sha.at(0));
+   const auto count = qFromBigEndian<quint32>(data + fanoutStart + 255 * 4);
+   const auto offsetsStart = namesStart + static_cast<qint64>(count) * (SHA_BYTES + 4);
+   const auto largeOffsetsStart = offsetsStart + static_cast<qint64>(count) * 4;
+
+   if (index.size() < largeOffsetsStart)
+      return false;
+
+   auto low = firstByte == 0 ? 0u : qFromBigEndian<quint32>(data + fanoutStart + (firstByte - 1) * 4);
+   auto high = qFromBigEndian<quint32>(data + fanoutStart + firstByte * 4);
+
+   while (low < high)
+   {
+      const auto middle = low + (high - low) / 2;
+      const auto cmp = memcmp(data + namesStart + static_cast<qint64>(middle) * SHA_BYTES, sha.constData(), SHA_BYTES);
+
+      if (cmp < 0)
+         low = middle + 1;
+      else if (cmp > 0)
+         high = middle;
+      else
+      {
+         offset = qFromBigEndian<quint32>(data + offsetsStart + static_cast<qint64>(middle) * 4);
+
+         if (offset & 0x80000000)
+         {
+            const auto largeOffset = largeOffsetsStart + static_cast<qint64>(offset & 0x7fffffff) * 8;
+
+            if (index.size() < largeOffset + 8)
+               return false;
+
+            offset = qFromBigEndian<quint64>(data + largeOffset);
+         }
+
+         return true;
+      }
+   }
+
+   return false;
+}
+}
+
+GitRepositoryReader::GitRepositoryReader(const QString &workingDirectory)
+{
+   const QDir workingDir(workingDirectory);
+   const QFileInfo dotGit(workingDir.filePath(".git"));
+   QString gitDir;
+
+   if (dotGit.isDir())
+      gitDir = dotGit.absoluteFilePath();
+   else if (dotGit.isFile())
+   {
+      // Worktrees and submodules have a file that points to the git directory.
+      const auto contents = QString::fromUtf8(readFile(dotGit.absoluteFilePath())).trimmed();
+
+      if (contents.startsWith("gitdir: "))
+         gitDir = QDir::cleanPath(workingDir.absoluteFilePath(contents.mid(8)));
+   }
+
+   if (gitDir.isEmpty() || !QFileInfo::exists(QDir(gitDir).filePath("HEAD")))
+      return;
+
+   const auto commonDir = QString::fromUtf8(readFile(QDir(gitDir).filePath("commondir"))).trimmed();
+   mCommonDir = commonDir.isEmpty() ? gitDir : QDir::cleanPath(QDir(gitDir).absoluteFilePath(commonDir));
+
+   // The reftable format is not supported. The objects are only read by SHA-1.
+   const auto config = QString::fromUtf8(readFile(QDir(mCommonDir).filePath("config")));
+
+   if (QFileInfo::exists(QDir(mCommonDir).filePath("reftable")) || config.contains("refstorage", Qt::CaseInsensitive)
+       || config.contains("objectformat", Qt::CaseInsensitive))
+      return;
+
+   mGitDir = gitDir;
+}
+
+QString GitRepositoryReader::topSuperprojectDir() const
+{
+   const auto index = mCommonDir.indexOf("/.git/modules/");
+
+   return index == -1 ? QString() : mCommonDir.left(index);
+}
+
+bool GitRepositoryReader::readHead(QString &sha, QString &branch) const
+{
+   if (!isValid())
+      return false;
+
+   const auto head = QString::fromUtf8(readFile(QDir(mGitDir).filePath("HEAD"))).trimmed();
+
+   if (head.startsWith("ref: "))
+   {
+      const auto name = head.mid(5);
+      branch = name.startsWith("refs/heads/") ? name.mid(11) : name;
+
+      return resolve(name, sha);
+   }
+
+   branch = QString("HEAD");
+   sha = head;
+
+   return isSha(sha);
+}
+
+bool GitRepositoryReader::readReferences(bool dereference, QVector<Reference> &references) const
+{
+   if (!isValid())
+      return false;
+
+   QVector<Reference> packed;
+   QHash<QString, QString> peeled;
+
+   if (!readPackedRefs(packed, &peeled))
+      return false;
+
+   QVector<QString> looseNames;
+   readLooseRefs(QDir(mCommonDir).filePath("refs"), QString("refs"), looseNames);
+
+   QMap<QString, QString> shas;
+
+   for (const auto &reference : qAsConst(packed))
+      shas.insert(reference.name, reference.sha);
+
+   for (const auto &name : qAsConst(looseNames))
+   {
+      QString sha;
+
+      if (!resolve(name, sha))
+         return false;
+
+      // The loose reference is more recent than the packed one, so the peeled value of the later doesn't apply.
+      if (shas.value(name) != sha)
+         peeled.remove(name);
+
+      shas.insert(name, sha);
+   }
+
+   references.clear();
+   references.reserve(shas.count());
+
+   for (auto iter = shas.cbegin(); iter != shas.cend(); ++iter)
+   {
+      references.append({ iter.key(), iter.value() });
+
+      if (dereference)
+      {
+         auto peeledSha = peeled.value(iter.key());
+
+         if (peeledSha.isEmpty() && !peel(iter.value(), peeledSha))
+            return false;
+
+         if (peeledSha != iter.value())
+            references.append({ iter.key() + QString("^{}"), peeledSha });
+      }
+   }
+
+   return true;
+}
+
+bool GitRepositoryReader::readLooseObject(const QString &sha, QByteArray &type, QByteArray &contents) const
+{
+   if (!isValid() || !isSha(sha))
+      return false;
+
+   const auto compressed = readFile(QDir(mCommonDir).filePath(QString("objects/%1/%2").arg(sha.left(2), sha.mid(2))));
+
+   if (compressed.isEmpty())
+      return false;
+
+   const auto object = inflate(compressed, static_cast<quint32>(compressed.size()) * 4);
+   const auto headerEnd = object.indexOf('\0');
+
+   if (headerEnd == -1)
+      return false;
+
+   const auto header = object.left(headerEnd);
+   type = header.left(header.indexOf(' '));
+   contents = object.mid(headerEnd + 1);
+
+   return true;
+}
+
+int GitRepositoryReader::indexEntries() const
+{
+   if (!isValid())
+      return -1;
+
+   QFile file(QDir(mGitDir).filePath("index"));
+
+   if (!file.open(QIODevice::ReadOnly))
+      return -1;
+
+   // The header is the signature, the version and the number of entries, all of them in 4 bytes.
+   const auto header = file.read(12);
+
+   if (header.size() != 12 || !header.startsWith("DIRC"))
+      return -1;
+
+   return static_cast<int>(qFromBigEndian<quint32>(header.constData() + 8));
+}
+
+QString GitRepositoryReader::toShowRefOutput(const QVector<Reference> &references)
+{
+   QString output;
+
+   for (const auto &reference : references)
+      output.append(QString("%1 %2\n").arg(reference.sha, reference.name));
+
+   return output;
+}
+
+QByteArray GitRepositoryReader::toReferenceRecords(const QVector<Reference> &references)
+{
+   QByteArray records;
+
+   for (auto i = 0; i < references.count(); ++i)
+   {
+      const auto &reference = references.at(i);
+      const auto kind = reference.name.section('/', 0, 1);
+
+      if (kind != QString("refs/heads") && kind != QString("refs/remotes") && kind != QString("refs/tags"))
+         continue;
+
+      // The object an annotated tag points to follows the tag.
+      const auto &next = i + 1 < references.count() ? references.at(i + 1) : Reference();
+      const auto peeled = next.name == reference.name + QString("^{}") ? next.sha : QString();
+
+      records.append(reference.name.toUtf8()).append('\0');
+      records.append(kind.toUtf8()).append('\0');
+      records.append(reference.name.section('/', 2).toUtf8()).append('\0');
+      records.append(reference.sha.toLatin1()).append('\0');
+      records.append(peeled.toLatin1()).append('\0');
+      records.append('\n');
+   }
+
+   return records;
+}
+
+bool GitRepositoryReader::resolve(const QString &name, QString &sha, int depth) const
+{
+   if (depth > MAX_SYMBOLIC_REFS)
+      return false;
+
+   // HEAD and the other references that are not under refs/ belong to the work tree.
+   const auto directory = name.startsWith("refs/") ? mCommonDir : mGitDir;
+   const auto contents = QString::fromUtf8(readFile(QDir(directory).filePath(name))).trimmed();
+
+   if (contents.startsWith("ref: "))
+      return resolve(contents.mid(5), sha, depth + 1);
+
+   if (!contents.isEmpty())
+   {
+      sha = contents;
+
+      return isSha(sha);
+   }
+
+   QVector<Reference> packed;
+
+   if (!readPackedRefs(packed, nullptr))
+      return false;
+
+   const auto iter = std::find_if(packed.cbegin(), packed.cend(),
+                                  [name](const Reference &reference) { return reference.name == name; });
+
+   if (iter == packed.cend())
+      return false;
+
+   sha = iter->sha;
+
+   return true;
+}
+
+bool GitRepositoryReader::readPackedRefs(QVector<Reference> &references, QHash<QString, QString> *peeled) const
+{
+   QFile file(QDir(mCommonDir).filePath("packed-refs"));
+
+   if (!file.exists())
+      return true;
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   const auto lines = QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+   auto fullyPeeled = false;
+   auto tagsPeeled = false;
+
+   for (const auto &line : lines)
+   {
+      if (line.startsWith('#'))
+      {
+         const auto traits = line.split(' ');
+         fullyPeeled = traits.contains("fully-peeled");
+         tagsPeeled = fullyPeeled || traits.contains("peeled");
+      }
+      else if (line.startsWith('^'))
+      {
+         if (references.isEmpty() || !isSha(line.mid(1)))
+            return false;
+
+         if (peeled)
+            peeled->insert(references.constLast().name, line.mid(1));
+      }
+      else
+      {
+         const auto separator = line.indexOf(' ');
+         const auto sha = line.left(separator);
+         const auto name = line.mid(separator + 1);
+
+         if (separator == -1 || !isSha(sha))
+            return false;
+
+         references.append({ name, sha });
+
+         // With the peeled traits, a reference without a peeled line is not a tag so it peels to itself.
+         if (peeled && (fullyPeeled || (tagsPeeled && name.startsWith("refs/tags/"))))
+            peeled->insert(name, sha);
+      }
+   }
+
+   return true;
+}
+
+void GitRepositoryReader::readLooseRefs(const QString &directory, const QString &prefix, QVector<QString> &names) const
+{
+   QDirIterator iter(directory, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+
+   while (iter.hasNext())
+   {
+      iter.next();
+
+      const auto name = QString("%1/%2").arg(prefix, QDir(directory).relativeFilePath(iter.filePath()));
+
+      // The lock files are references being written by git.
+      if (!name.endsWith(".lock"))
+         names.append(name);
+   }
+}
+
+bool GitRepositoryReader::peel(const QString &sha, QString &peeledSha) const
+{
+   auto current = sha;
+
+   for (auto depth = 0; depth <= MAX_SYMBOLIC_REFS; ++depth)
+   {
+      QByteArray type;
+      QByteArray contents;
+
+      if (!readLooseObject(current, type, contents))
+      {
+         // Only the type is needed from the packs unless the object is a tag. It's in the header of the entry.
+         const auto packDir = QDir(mCommonDir).filePath("objects/pack");
+         const auto rawSha = QByteArray::fromHex(current.toLatin1());
+         auto found = false;
+
+         for (const auto &indexName : QDir(packDir).entryList({ "*.idx" }, QDir::Files))
+         {
+            quint64 offset = 0;
+
+            if (!findInPackIndex(readFile(QDir(packDir).filePath(indexName)), rawSha, offset))
+               continue;
+
+            QFile pack(QDir(packDir).filePath(indexName.chopped(4) + QString(".pack")));
+
+            if (!pack.open(QIODevice::ReadOnly) || !pack.seek(static_cast<qint64>(offset)))
+               return false;
+
+            auto header = pack.read(16);
+
+            if (header.isEmpty())
+               return false;
+
+            auto byte = static_cast<uchar>(header.at(0));
+            const auto packType = (byte >> 4) & 7;
+            quint64 size = byte & 0x0f;
+            auto position = 1;
+
+            for (auto shift = 4; (byte & 0x80) && position < header.size(); shift += 7)
+            {
+               byte = static_cast<uchar>(header.at(position++));
+               size |= static_cast<quint64>(byte & 0x7f) << shift;
+            }
+
+            if (packType != PACK_TAG_TYPE)
+            {
+               // The objects stored as deltas don't say their type, they are never tags in practice but it's unsure.
+               if (packType >= 6)
+                  return false;
+
+               peeledSha = current;
+
+               return true;
+            }
+
+            pack.seek(static_cast<qint64>(offset) + position);
+            contents = inflate(pack.read(static_cast<qint64>(size) + 1024), static_cast<quint32>(size));
+            type = "tag";
+            found = true;
+
+            break;
+         }
+
+         if (!found)
+            return false;
+      }
+
+      if (type != "tag")
+      {
+         peeledSha = current;
+
+         return true;
+      }
+
+      if (!contents.startsWith("object "))
+         return false;
+
+      current = QString::fromLatin1(contents.mid(7, SHA_LENGTH));
+   }
+
+   return false;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/*!
+ \brief The GitRepositoryReader reads the metadata of a repository directly from its files, without starting a git
+ process: the git directory, HEAD and the references, loose or packed, and the loose objects. It only reads: all the
+ changes are done by git.
+
+ It doesn't support everything git does (for instance the reftable format or the objects in packs), so every method
+ tells if it could answer. When it can't, the caller asks git.
+
+ \class GitRepositoryReader GitRepositoryReader.h "GitRepositoryReader.h"
+*/
+class GitRepositoryReader
+{
+public:
+   /*!
+    \brief A reference and the commit or object it points to.
+   */
+   struct Reference
+   {
+      QString name;
+      QString sha;
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param workingDirectory The root of the work tree of the repository.
+   */
+   explicit GitRepositoryReader(const QString &workingDirectory);
+
+   /*!
+    \brief Tells if the repository can be read. It can't if its git directory is not found or if it uses a format
+    that is not supported.
+   */
+   bool isValid() const { return !mGitDir.isEmpty(); }
+   /*!
+    \brief Returns the absolute path of the git directory, like git rev-parse --absolute-git-dir.
+   */
+   QString gitDir() const { return mGitDir; }
+   /*!
+    \brief Returns the absolute path of the directory shared by all the work trees: the references and the objects
+    are there. It's the git directory unless this is a linked work tree.
+   */
+   QString commonDir() const { return mCommonDir; }
+   /*!
+    \brief Returns the work tree of the outermost superproject if this is a submodule, otherwise an empty string.
+    The git directories of the submodules are inside the one of their superproject, in .git/modules.
+   */
+   QString topSuperprojectDir() const;
+   /*!
+    \brief Reads HEAD.
+
+    \param sha The commit HEAD points to.
+    \param branch The branch checked out, or "HEAD" if it's detached, like git rev-parse --abbrev-ref HEAD.
+    \return True if HEAD could be read and it points to a commit.
+   */
+   bool readHead(QString &sha, QString &branch) const;
+   /*!
+    \brief Lists the references under refs/, sorted by name, like git show-ref.
+
+    \param dereference If true, an annotated tag is followed by the object it points to, with "^{}" appended to the
+    name, like git show-ref -d.
+    \param references The references.
+    \return True if all the references could be read.
+   */
+   bool readReferences(bool dereference, QVector<Reference> &references) const;
+   /*!
+    \brief Reads a loose object.
+
+    \param sha The object.
+    \param type The type of the object.
+    \param contents The contents of the object.
+    \return True if the object exists as a loose object.
+   */
+   bool readLooseObject(const QString &sha, QByteArray &type, QByteArray &contents) const;
+   /*!
+    \brief Returns the number of entries of the index, read from its header, or -1 if it can't be read.
+   */
+   int indexEntries() const;
+
+   /*!
+    \brief Formats the references like the output of git show-ref.
+
+    \param references The references.
+    \return The text.
+   */
+   static QString toShowRefOutput(const QVector<Reference> &references);
+   /*!
+    \brief Formats the branches, the remote branches and the tags like GitBase::getReferenceRecords, without the
+    upstream of the branches.
+
+    \param references The references, dereferenced.
+    \return The records.
+   */
+   static QByteArray toReferenceRecords(const QVector<Reference> &references);
+
+private:
+   static constexpr int MAX_SYMBOLIC_REFS = 5;
+
+   QString mGitDir;
+   QString mCommonDir;
+
+   bool resolve(const QString &name, QString &sha, int depth = 0) const;
+   bool readPackedRefs(QVector<Reference> &references, QHash<QString, QString> *peeled) const;
+   void readLooseRefs(const QString &directory, const QString &prefix, QVector<QString> &names) const;
+   bool peel(const QString &sha, QString &peeledSha) const;
+};
@@ -1,6 +1,5 @@
 #include "GitRequestorProcess.h"
 
-#include <QTemporaryFile>
 GitRequestorProcess::GitRequestorProcess(const QString &workingDir)
    : AGitProcess(workingDir)
 {
@@ -8,32 +7,33 @@ GitRequestorProcess::GitRequestorProcess(const QString &workingDir)
 
 GitExecResult GitRequestorProcess::run(const QString &command)
 {
-   auto ret = false;
+   const auto processStarted = execute(command);
 
-   // Create temporary file
-   mTempFile = new QTemporaryFile(this);
+   return { processStarted, "" };
+}
 
-   if (mTempFile->open()) // to read the file name
+void GitRequestorProcess::onReadyStandardOutput()
+{
+   if (!mCanceling)
    {
-      setStandardOutputFile(mTempFile->fileName());
-      mTempFile->close();
+      const auto ba = readOutput();
 
-      ret = execute(command);
+      if (!ba.isEmpty())
+         emit procDataReady(ba);
    }
-
-   return { ret, "" };
 }
 
 void GitRequestorProcess::onFinished(int, QProcess::ExitStatus)
 {
-   bool ok = mTempFile && (mTempFile->isOpen() || (mTempFile->exists() && mTempFile->open()));
-
-   if (ok)
+   if (!mCanceling)
    {
-      const auto ba = mTempFile->readAll();
+      const auto ba = readOutput();
 
-      if (ba.size() != 0 && !mCanceling)
+      if (!ba.isEmpty())
          emit procDataReady(ba);
+
+      emit procTimings(mSpawnMs, mFirstByteMs, mTimer.elapsed());
+      emit procDataFinished();
    }
 
    deleteLater();
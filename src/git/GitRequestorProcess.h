@@ -25,19 +25,32 @@
 
 #include <AGitProcess.h>
 
-class QTemporaryFile;
-
+/*!
+ \brief The GitRequestorProcess streams the standard output of long running commands (like git log) through the
+ procDataReady signal as soon as the data arrives. The output is not accumulated internally so the memory footprint
+ remains constant no matter how big the output is. When the process finishes the procDataFinished signal is emitted.
+*/
 class GitRequestorProcess : public AGitProcess
 {
    Q_OBJECT
 
+signals:
+   void procDataFinished();
+   /*!
+    \brief Signal triggered when the process finishes, before procDataFinished. All the times are measured since the
+    process was started.
+
+    \param spawnMs The time needed to start the process.
+    \param firstByteMs The time until the first data was received.
+    \param finishedMs The time until the process finished.
+   */
+   void procTimings(qint64 spawnMs, qint64 firstByteMs, qint64 finishedMs);
+
 public:
    explicit GitRequestorProcess(const QString &workingDir);
    GitExecResult run(const QString &command) override;
 
 private:
+   void onReadyStandardOutput() override;
    void onFinished(int, QProcess::ExitStatus exitStatus) override;
-
-private:
-   QTemporaryFile *mTempFile = nullptr;
 };
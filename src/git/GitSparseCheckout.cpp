@@ -0,0 +1,90 @@
+#include "GitSparseCheckout.h"
+
+#include <GitBase.h>
+
+#include <QSet>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+GitSparseCheckout::GitSparseCheckout(const QSharedPointer<GitBase> &gitBase)
+   : mGitBase(gitBase)
+{
+}
+
+QStringList GitSparseCheckout::getConeDirectories() const
+{
+   // Without the cone mode the patterns are like the ones of .gitignore and they can't be turned into directories.
+   const auto config = mGitBase->getConfig();
+
+   if (!config->boolValue("core.sparseCheckout") || !config->boolValue("core.sparseCheckoutCone"))
+      return QStringList();
+
+   const auto ret = mGitBase->runCached("git sparse-checkout list");
+
+   if (!ret.success)
+      return QStringList();
+
+   QStringList cone;
+
+   for (auto directory : ret.output.toString().split('\n', QString::SkipEmptyParts))
+   {
+      while (directory.endsWith('/'))
+         directory.chop(1);
+
+      if (!directory.isEmpty())
+         cone.append(directory);
+   }
+
+   QLog_Debug("Git", QString("The work tree is a sparse checkout of {%1} directories.").arg(cone.count()));
+
+   return cone;
+}
+
+bool GitSparseCheckout::isInCone(const QStringList &cone, const QString &directory)
+{
+   if (cone.isEmpty() || directory.isEmpty() || directory == ".")
+      return true;
+
+   for (const auto &coneDirectory : cone)
+   {
+      const auto inside = directory.startsWith(coneDirectory)
+          && (directory.size() == coneDirectory.size() || directory.at(coneDirectory.size()) == '/');
+      const auto parent = coneDirectory.startsWith(directory) && coneDirectory.size() > directory.size()
+          && coneDirectory.at(directory.size()) == '/';
+
+      if (inside || parent)
+         return true;
+   }
+
+   return false;
+}
+
+QStringList GitSparseCheckout::getPathspecs(const QStringList &cone)
+{
+   if (cone.isEmpty())
+      return QStringList();
+
+   // The files of a directory, without the ones of its subdirectories.
+   QStringList pathspecs { ":(glob)*" };
+   QSet<QString> parents;
+
+   for (const auto &directory : cone)
+   {
+      pathspecs.append(QString("%1/").arg(directory));
+
+      for (auto slash = directory.indexOf('/'); slash != -1; slash = directory.indexOf('/', slash + 1))
+      {
+         const auto parent = directory.left(slash);
+
+         if (!parents.contains(parent))
+         {
+            parents.insert(parent);
+            pathspecs.append(QString(":(glob)%1/*").arg(parent));
+         }
+      }
+   }
+
+   return pathspecs;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QSharedPointer>
+#include <QStringList>
+
+class GitBase;
+
+/*!
+ \brief Reads the sparse checkout of the work tree. In cone mode only some directories are checked out, plus the
+ files of the root and of the parents of those directories: the rest of the work doesn't need to look outside them.
+*/
+class GitSparseCheckout
+{
+public:
+   explicit GitSparseCheckout(const QSharedPointer<GitBase> &gitBase);
+
+   /*!
+    \brief Returns the directories of the cone, relative to the work tree.
+
+    \return The directories, or an empty list if the work tree is not a sparse checkout in cone mode.
+   */
+   QStringList getConeDirectories() const;
+
+   /*!
+    \brief Tells if a directory of the work tree has files checked out: it's in one of the directories of the cone or
+    it's one of their parents, the root included.
+
+    \param cone The directories of the cone. If empty, every directory is checked out.
+    \param directory The directory, relative to the work tree. The root is an empty string or ".".
+    \return True if the directory has files checked out, otherwise false.
+   */
+   static bool isInCone(const QStringList &cone, const QString &directory);
+
+   /*!
+    \brief Returns the pathspecs that restrict a git command to the files checked out: the directories of the cone and
+    the files directly in the root and in their parents.
+
+    \param cone The directories of the cone.
+    \return The pathspecs, or an empty list if the cone is empty.
+   */
+   static QStringList getPathspecs(const QStringList &cone);
+
+private:
+   QSharedPointer<GitBase> mGitBase;
+};
@@ -16,18 +16,56 @@ QVector<QString> GitStashes::getStashes()
 
    const auto ret = mGitBase->run("git stash list");
 
+   return ret.success ? parseStashes(ret.output.toString()) : QVector<QString>();
+}
+
+int GitStashes::getStashes(QObject *context, const GitBase::ResultCallback &callback) const
+{
+   QLog_Debug("Git", QString("Executing getStashes asynchronously"));
+
+   return mGitBase->runAsync("git stash list", context, callback, GitBase::Priority::Refresh);
+}
+
+QVector<QString> GitStashes::parseStashes(const QString &output)
+{
    QVector<QString> stashes;
+   const auto tagsTmp = output.split("\n");
+
+   for (const auto &tag : tagsTmp)
+      if (tag != "\n" && !tag.isEmpty())
+         stashes.append(tag);
+
+   return stashes;
+}
+
+int GitStashes::getStashCommits(const QVector<QString> &stashIds, QObject *context,
+                                const GitBase::ResultCallback &callback) const
+{
+   QLog_Debug("Git", QString("Executing getStashCommits: {%1} stashes").arg(stashIds.count()));
+
+   // The commits are listed in the order of the stashes, without walking their history.
+   QStringList arguments { "rev-list", "--no-walk=unsorted", "--parents" };
+
+   for (const auto &stashId : stashIds)
+      arguments.append(stashId);
 
-   if (ret.success)
+   return mGitBase->runAsync(arguments, context, callback, GitBase::Priority::Background);
+}
+
+QVector<QPair<QString, QString>> GitStashes::parseStashCommits(const QString &output)
+{
+   QVector<QPair<QString, QString>> commits;
+   const auto lines = output.split("\n", QString::SkipEmptyParts);
+
+   for (const auto &line : lines)
    {
-      const auto tagsTmp = ret.output.toString().split("\n");
+      const auto shas = line.split(' ', QString::SkipEmptyParts);
 
-      for (const auto &tag : tagsTmp)
-         if (tag != "\n" && !tag.isEmpty())
-            stashes.append(tag);
+      if (!shas.isEmpty())
+         commits.append(qMakePair(shas.constFirst(), shas.value(1)));
    }
 
-   return stashes;
+   return commits;
 }
 
 GitExecResult GitStashes::pop() const
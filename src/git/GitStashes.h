@@ -23,11 +23,12 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitBase.h>
 #include <GitExecResult.h>
 
+#include <QPair>
 #include <QSharedPointer>
-
-class GitBase;
+#include <QVector>
 
 class GitStashes
 {
@@ -35,6 +36,38 @@ public:
    GitStashes(const QSharedPointer<GitBase> &gitBase);
 
    QVector<QString> getStashes();
+   /*!
+    \brief Lists the stashes without blocking. See GitBase::runAsync.
+
+    \param context The object the callback belongs to.
+    \param callback The function that receives the output of git stash list. See \ref parseStashes.
+    \return The id of the request, to cancel it with GitBase::cancel.
+   */
+   int getStashes(QObject *context, const GitBase::ResultCallback &callback) const;
+   /*!
+    \brief Returns the stashes in the output of git stash list.
+
+    \param output The output of \ref getStashes.
+    \return The stashes, one per line of the output.
+   */
+   static QVector<QString> parseStashes(const QString &output);
+   /*!
+    \brief Resolves the commits of the stashes and their first parents without blocking.
+
+    \param stashIds The ids of the stashes, like stash@{0}.
+    \param context The object the callback belongs to.
+    \param callback The function that receives the output. See \ref parseStashCommits.
+    \return The id of the request.
+   */
+   int getStashCommits(const QVector<QString> &stashIds, QObject *context,
+                       const GitBase::ResultCallback &callback) const;
+   /*!
+    \brief Returns the commits listed by \ref getStashCommits, in the order of the stashes.
+
+    \param output The output of \ref getStashCommits.
+    \return The pairs of commit of the stash and its first parent.
+   */
+   static QVector<QPair<QString, QString>> parseStashCommits(const QString &output);
    GitExecResult pop() const;
    GitExecResult stash();
    GitExecResult stashBranch(const QString &stashId, const QString &branchName);
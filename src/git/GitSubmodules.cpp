@@ -10,19 +10,32 @@ GitSubmodules::GitSubmodules(const QSharedPointer<GitBase> &gitBase)
 {
 }
 
+static const char *SUBMODULES_COMMAND = "git config --file .gitmodules --name-only --get-regexp path";
+
 QVector<QString> GitSubmodules::getSubmodules()
 {
    QLog_Debug("Git", QString("Executing getSubmodules"));
 
+   const auto ret = mGitBase->runCached(SUBMODULES_COMMAND);
+
+   return ret.success ? parseSubmodules(ret.output.toString()) : QVector<QString>();
+}
+
+int GitSubmodules::getSubmodules(QObject *context, const GitBase::ResultCallback &callback) const
+{
+   QLog_Debug("Git", QString("Executing getSubmodules asynchronously"));
+
+   return mGitBase->runAsync(SUBMODULES_COMMAND, context, callback, GitBase::Priority::Refresh);
+}
+
+QVector<QString> GitSubmodules::parseSubmodules(const QString &output)
+{
    QVector<QString> submodulesList;
-   const auto ret = mGitBase->run("git config --file .gitmodules --name-only --get-regexp path");
-   if (ret.success)
-   {
-      const auto submodules = ret.output.toString().split('\n');
-      for (const auto &submodule : submodules)
-         if (!submodule.isEmpty() && submodule != "\n")
-            submodulesList.append(submodule.split('.').at(1));
-   }
+   const auto submodules = output.split('\n');
+
+   for (const auto &submodule : submodules)
+      if (!submodule.isEmpty() && submodule != "\n")
+         submodulesList.append(submodule.split('.').at(1));
 
    return submodulesList;
 }
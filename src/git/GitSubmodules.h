@@ -23,17 +23,31 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitBase.h>
 #include <GitExecResult.h>
 
 #include <QSharedPointer>
 
-class GitBase;
-
 class GitSubmodules
 {
 public:
    GitSubmodules(const QSharedPointer<GitBase> &gitBase);
    QVector<QString> getSubmodules();
+   /*!
+    \brief Lists the submodules without blocking. See GitBase::runAsync.
+
+    \param context The object the callback belongs to.
+    \param callback The function that receives the output of git config. See \ref parseSubmodules.
+    \return The id of the request, to cancel it with GitBase::cancel.
+   */
+   int getSubmodules(QObject *context, const GitBase::ResultCallback &callback) const;
+   /*!
+    \brief Returns the names of the submodules in the output of \ref getSubmodules.
+
+    \param output The names of the path keys of .gitmodules, one per line.
+    \return The names of the submodules.
+   */
+   static QVector<QString> parseSubmodules(const QString &output);
    bool submoduleAdd(const QString &url, const QString &name);
    bool submoduleUpdate(const QString &submodule);
    bool submoduleRemove(const QString &submodule);
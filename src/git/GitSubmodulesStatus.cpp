@@ -0,0 +1,156 @@
+#include "GitSubmodulesStatus.h"
+
+#include <GitBase.h>
+#include <GitRepositoryReader.h>
+
+#include <QDir>
+#include <QFileInfo>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+GitSubmodulesStatus::GitSubmodulesStatus(const QSharedPointer<GitBase> &gitBase, QObject *parent)
+   : QObject(parent)
+   , mGitBase(gitBase)
+{
+}
+
+GitSubmodulesStatus::~GitSubmodulesStatus()
+{
+   cancel();
+}
+
+void GitSubmodulesStatus::scan(const QVector<QString> &submodules)
+{
+   cancel();
+
+   if (submodules.isEmpty())
+      return;
+
+   QLog_Debug("Git", QString("Checking the status of {%1} submodules").arg(submodules.count()));
+
+   QStringList arguments { "ls-files", "--stage", "--" };
+
+   for (const auto &submodule : submodules)
+      arguments.append(submodule);
+
+   // The commits the submodules should be at are the ones in the index, like git submodule status shows.
+   const auto request = mGitBase->runAsync(
+       arguments, this,
+       [this, submodules](const GitExecResult &result) {
+          QHash<QString, QString> recordedShas;
+
+          if (result.success)
+          {
+             const auto lines = result.output.toString().split('\n', QString::SkipEmptyParts);
+
+             for (const auto &line : lines)
+             {
+                if (line.startsWith("160000 "))
+                   recordedShas.insert(line.section('\t', 1), line.section(' ', 1, 1));
+             }
+          }
+
+          check(submodules, recordedShas);
+       },
+       GitBase::Priority::Background);
+
+   mRequests.append(request);
+}
+
+void GitSubmodulesStatus::cancel()
+{
+   for (const auto request : qAsConst(mRequests))
+      mGitBase->cancel(request);
+
+   mRequests.clear();
+}
+
+bool GitSubmodulesStatus::status(const QString &submodule, Status &status) const
+{
+   const auto iter = mStatus.constFind(submodule);
+
+   if (iter == mStatus.cend())
+      return false;
+
+   status = iter.value();
+
+   return true;
+}
+
+void GitSubmodulesStatus::check(const QVector<QString> &submodules, const QHash<QString, QString> &recordedShas)
+{
+   mRequests.clear();
+
+   for (const auto &submodule : submodules)
+   {
+      Status status;
+      QString head;
+      QString index;
+
+      if (!readSubmodule(submodule, head, index))
+      {
+         mChanges.remove(submodule);
+         setStatus(submodule, status);
+         continue;
+      }
+
+      status.initialized = true;
+      status.outOfDate = recordedShas.value(submodule) != head;
+
+      const auto changes = mChanges.constFind(submodule);
+
+      if (changes != mChanges.cend() && changes->head == head
+          && changes->indexModified == QFileInfo(index).lastModified())
+      {
+         status.modified = changes->modified;
+         setStatus(submodule, status);
+         continue;
+      }
+
+      const QStringList arguments { "-C", submodule, "status", "--porcelain", "--untracked-files=no" };
+
+      mRequests.append(mGitBase->runAsync(
+          arguments, this,
+          [this, submodule, status, head, index](const GitExecResult &result) mutable {
+             if (!result.success)
+             {
+                QLog_Warning("Git", QString("The status of the submodule {%1} couldn't be read").arg(submodule));
+                return;
+             }
+
+             status.modified = !result.output.toString().trimmed().isEmpty();
+
+             // git status can refresh the index, so its time is read once it finishes.
+             mChanges.insert(submodule, { head, QFileInfo(index).lastModified(), status.modified });
+
+             setStatus(submodule, status);
+          },
+          GitBase::Priority::Background));
+   }
+}
+
+void GitSubmodulesStatus::setStatus(const QString &submodule, const Status &status)
+{
+   if (const auto iter = mStatus.constFind(submodule); iter != mStatus.cend() && iter.value() == status)
+      return;
+
+   mStatus.insert(submodule, status);
+
+   emit signalStatusChanged(submodule);
+}
+
+bool GitSubmodulesStatus::readSubmodule(const QString &submodule, QString &head, QString &index) const
+{
+   // A submodule that is not initialized has no git directory.
+   const GitRepositoryReader reader(QDir(mGitBase->getWorkingDir()).filePath(submodule));
+   QString branch;
+
+   if (!reader.readHead(head, branch))
+      return false;
+
+   index = QDir(reader.gitDir()).filePath("index");
+
+   return true;
+}
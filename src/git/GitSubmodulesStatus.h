@@ -0,0 +1,112 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+class GitBase;
+
+/*!
+ \brief The GitSubmodulesStatus checks the state of the submodules of a repository: whether they are initialized, have
+ changes or are checked out at a different commit than the one the repository records. Every submodule with changes to
+ check gets its own git status, and they run concurrently through the scheduler of the GitBase, which bounds the number
+ of processes.
+
+ The changes of a submodule are remembered with its HEAD and the modification time of its index: the submodule is only
+ checked again once one of them changes. The commit it should be at and its HEAD are read from the files every time.
+
+ \class GitSubmodulesStatus GitSubmodulesStatus.h "GitSubmodulesStatus.h"
+*/
+class GitSubmodulesStatus : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the state of a submodule is known or changes.
+
+    \param submodule The path of the submodule.
+   */
+   void signalStatusChanged(const QString &submodule);
+
+public:
+   /*!
+    \brief The state of a submodule.
+   */
+   struct Status
+   {
+      bool initialized = false;
+      bool modified = false; /*!< The submodule has changes in its tracked files. */
+      bool outOfDate = false; /*!< HEAD of the submodule is not the commit recorded in the index of the repository. */
+
+      bool operator==(const Status &other) const
+      {
+         return initialized == other.initialized && modified == other.modified && outOfDate == other.outOfDate;
+      }
+      bool operator!=(const Status &other) const { return !(*this == other); }
+   };
+
+   explicit GitSubmodulesStatus(const QSharedPointer<GitBase> &gitBase, QObject *parent = nullptr);
+   ~GitSubmodulesStatus();
+
+   /*!
+    \brief Checks the state of the submodules. The check in progress, if any, is cancelled.
+
+    \param submodules The paths of the submodules, relative to the repository.
+   */
+   void scan(const QVector<QString> &submodules);
+   /*!
+    \brief Cancels the check in progress, if any.
+   */
+   void cancel();
+   /*!
+    \brief Returns the last state known of a submodule.
+
+    \param submodule The path of the submodule.
+    \param status The state.
+    \return True if the state of the submodule is known.
+   */
+   bool status(const QString &submodule, Status &status) const;
+
+private:
+   struct Changes
+   {
+      QString head;
+      QDateTime indexModified;
+      bool modified = false;
+   };
+
+   QSharedPointer<GitBase> mGitBase;
+   QHash<QString, Changes> mChanges;
+   QHash<QString, Status> mStatus;
+   QVector<int> mRequests;
+
+   void check(const QVector<QString> &submodules, const QHash<QString, QString> &recordedShas);
+   void setStatus(const QString &submodule, const Status &status);
+   bool readSubmodule(const QString &submodule, QString &head, QString &index) const;
+};
@@ -10,11 +10,41 @@ GitSyncProcess::GitSyncProcess(const QString &workingDir)
 
 GitExecResult GitSyncProcess::run(const QString &command)
 {
-   const auto processStarted = execute(command);
+   launch(command);
 
-   if (processStarted)
+   return waitForResult();
+}
+
+GitExecResult GitSyncProcess::run(const QStringList &arguments, const QByteArray &input)
+{
+   mLaunched = execute("git", arguments, input);
+
+   if (mLaunched && !mReplayPending)
+   {
+      // The input is written while waiting for the result, so git can read it as it produces its output.
+      write(input);
+      closeWriteChannel();
+   }
+
+   return waitForResult();
+}
+
+bool GitSyncProcess::launch(const QString &command)
+{
+   mLaunched = execute(command);
+
+   return mLaunched;
+}
+
+GitExecResult GitSyncProcess::waitForResult()
+{
+   if (mReplayPending)
+      waitForReplay();
+   else if (mLaunched)
       waitForFinished(10000);
 
+   mLaunched = false;
+
    close();
 
    return { !mRealError, mRunOutput };
@@ -31,4 +31,30 @@ public:
    GitSyncProcess(const QString &workingDir);
 
    GitExecResult run(const QString &command) override;
+   /*!
+    \brief Runs git with the given arguments and waits for it to finish. The arguments are passed as they are, so the
+    paths need no quoting.
+
+    \param arguments The arguments of git.
+    \param input The data written to the standard input of git, that is closed afterwards.
+    \return The result of the execution.
+   */
+   GitExecResult run(const QStringList &arguments, const QByteArray &input = QByteArray());
+
+   /*!
+    \brief Starts the command without waiting for it to finish. This allows to run several processes at the same time.
+
+    \param command The command to execute.
+    \return True if the process started, otherwise false.
+   */
+   bool launch(const QString &command);
+   /*!
+    \brief Waits until the process started with launch finishes.
+
+    \return The result of the execution.
+   */
+   GitExecResult waitForResult();
+
+private:
+   bool mLaunched = false;
 };
@@ -30,21 +30,32 @@ QVector<QString> GitTags::getTags() const
    return tags;
 }
 
-QVector<QString> GitTags::getLocalTags() const
+int GitTags::getRemoteTags(QObject *context, const GitBase::ResultCallback &callback) const
 {
-   QLog_Debug("Git", QString("Executing getLocalTags"));
+   QLog_Debug("Git", QString("Executing getRemoteTags asynchronously"));
 
-   const auto ret = mGitBase->run("git push --tags --dry-run");
+   return mGitBase->runAsync("git ls-remote --tags origin", context, callback, GitBase::Priority::Background);
+}
 
-   QVector<QString> tags;
+QSet<QString> GitTags::parseRemoteTags(const QString &output)
+{
+   QSet<QString> tags;
+   const auto lines = output.split('\n', QString::SkipEmptyParts);
 
-   if (ret.success)
+   // Every line is the SHA and the reference. The annotated tags have a second line for their commit, ended by ^{}.
+   for (const auto &line : lines)
    {
-      const auto tagsTmp = ret.output.toString().split("\n");
+      const auto reference = line.section('\t', 1).trimmed();
 
-      for (const auto &tag : tagsTmp)
-         if (tag != "\n" && !tag.isEmpty() && tag.contains("[new tag]"))
-            tags.append(tag.split(" -> ").last());
+      if (!reference.startsWith("refs/tags/"))
+         continue;
+
+      auto name = reference.mid(10);
+
+      if (name.endsWith("^{}"))
+         name.chop(3);
+
+      tags.insert(name);
    }
 
    return tags;
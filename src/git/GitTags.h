@@ -23,21 +23,36 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitBase.h>
 #include <GitExecResult.h>
 
+#include <QSet>
 #include <QVector>
 #include <QString>
 #include <QSharedPointer>
 
-class GitBase;
-
 class GitTags
 {
 public:
    explicit GitTags(const QSharedPointer<GitBase> &gitBase);
 
    QVector<QString> getTags() const;
-   QVector<QString> getLocalTags() const;
+   /*!
+    \brief Lists the tags of origin without blocking. It needs the network, so it goes after the rest of the commands.
+    See GitBase::runAsync.
+
+    \param context The object the callback belongs to.
+    \param callback The function that receives the output of git ls-remote. See \ref parseRemoteTags.
+    \return The id of the request, to cancel it with GitBase::cancel.
+   */
+   int getRemoteTags(QObject *context, const GitBase::ResultCallback &callback) const;
+   /*!
+    \brief Returns the names of the tags in the output of git ls-remote --tags.
+
+    \param output The output of \ref getRemoteTags.
+    \return The names of the tags.
+   */
+   static QSet<QString> parseRemoteTags(const QString &output);
    GitExecResult addTag(const QString &tagName, const QString &tagMessage, const QString &sha);
    GitExecResult removeTag(const QString &tagName, bool remote);
    GitExecResult pushTag(const QString &tagName);
@@ -0,0 +1,267 @@
+#include "GitWatcher.h"
+
+#include <GitBase.h>
+#include <GitRepositoryReader.h>
+#include <GitSparseCheckout.h>
+#include <GitWatcherHub.h>
+#include <TraceRecorder.h>
+
+#include <QDir>
+#include <QTimer>
+
+#ifndef Q_OS_LINUX
+#   include <QFileInfo>
+#endif
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+// The files of the git directory that hold the state of the repository. The rest change with every command.
+const QStringList STATE_FILES { "HEAD", "packed-refs", "MERGE_HEAD", "CHERRY_PICK_HEAD", "REVERT_HEAD", "REBASE_HEAD" };
+}
+
+GitWatcher::GitWatcher(const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mGit(git)
+   , mWorkingTreeTimer(new QTimer(this))
+   , mStateTimer(new QTimer(this))
+{
+   mWorkingTreeTimer->setSingleShot(true);
+   mWorkingTreeTimer->setInterval(QUIET_PERIOD_MS);
+   connect(mWorkingTreeTimer, &QTimer::timeout, this, &GitWatcher::notifyWorkingTreeChanges);
+
+   mStateTimer->setSingleShot(true);
+   mStateTimer->setInterval(QUIET_PERIOD_MS);
+   connect(mStateTimer, &QTimer::timeout, this, [this]() {
+      mStateWait.invalidate();
+      emit signalRepositoryStateChanged();
+   });
+}
+
+GitWatcher::~GitWatcher()
+{
+   stop();
+}
+
+void GitWatcher::start()
+{
+   stop();
+
+   mWorkingDir = QDir::cleanPath(mGit->getWorkingDir());
+   mGitDir = QDir::cleanPath(mGit->getGitDir());
+
+   if (mWorkingDir.isEmpty() || mGitDir.isEmpty())
+      return;
+
+   const GitRepositoryReader reader(mWorkingDir);
+   mRefsDir = QDir(reader.isValid() ? reader.commonDir() : mGitDir).filePath("refs");
+
+#ifdef Q_OS_LINUX
+   // The git directory itself is not watched recursively: the events say which of its files changed.
+   watchDirectory(mGitDir);
+#else
+   // Without the names of the files changed, the git directory can't be watched as a whole.
+   for (const auto &file : { QString("index"), QString("HEAD"), QString("packed-refs") })
+   {
+      if (QFileInfo::exists(QDir(mGitDir).filePath(file)))
+         GitWatcherHub::instance().watch(this, QDir(mGitDir).filePath(file));
+   }
+#endif
+
+   loadIgnoredDirs();
+
+   // In a sparse checkout only the directories of the cone and their parents have files.
+   mSparseCone = GitSparseCheckout(mGit).getConeDirectories();
+
+   QLog_Info("UI", QString("Setting the file watcher for dir {%1}").arg(mWorkingDir));
+
+   watchTree(mRefsDir);
+   watchTree(mWorkingDir);
+
+   QLog_Debug("UI",
+              QString("Watching %1 paths, %2 for all the repositories.")
+                  .arg(watchCount())
+                  .arg(GitWatcherHub::instance().totalWatchCount()));
+}
+
+int GitWatcher::watchCount() const
+{
+   return GitWatcherHub::instance().watchCount(this);
+}
+
+void GitWatcher::stop()
+{
+   mWorkingTreeTimer->stop();
+   mStateTimer->stop();
+   mWorkingTreeWait.invalidate();
+   mStateWait.invalidate();
+   mChangedPaths.clear();
+   mIndexChanged = false;
+   mIgnoredDirs.clear();
+   mSparseCone.clear();
+   mWatchLimitReached = false;
+
+   GitWatcherHub::instance().unwatchAll(this);
+}
+
+void GitWatcher::loadIgnoredDirs()
+{
+   // The ignored directories are listed as a whole, without their contents.
+   const auto ret = mGit->run({ "ls-files", "--others", "--ignored", "--exclude-standard", "--directory", "-z" });
+
+   if (!ret.success)
+      return;
+
+   const auto entries = QString::fromUtf8(ret.output.toByteArray()).split(QChar('\0'), QString::SkipEmptyParts);
+
+   for (const auto &entry : entries)
+   {
+      if (entry.endsWith('/'))
+         mIgnoredDirs.insert(QDir::cleanPath(QDir(mWorkingDir).filePath(entry)));
+   }
+}
+
+void GitWatcher::watchTree(const QString &dir)
+{
+   if (isOutOfSparseCone(dir) || !watchDirectory(dir))
+      return;
+
+   const auto subdirs = QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+
+   for (const auto &subdir : subdirs)
+   {
+      const auto path = QDir(dir).filePath(subdir);
+
+      // The git directories are not part of the work tree, neither the one of the repository nor the nested ones.
+      if (subdir != ".git" && path != mGitDir && !isIgnored(path))
+         watchTree(path);
+   }
+}
+
+bool GitWatcher::watchDirectory(const QString &dir)
+{
+   if (mWatchLimitReached)
+      return false;
+
+   auto &hub = GitWatcherHub::instance();
+
+   if (hub.watch(this, dir))
+      return true;
+
+   mWatchLimitReached = hub.isLimitReached();
+
+   return false;
+}
+
+bool GitWatcher::isIgnored(const QString &dir) const
+{
+   return mIgnoredDirs.contains(dir);
+}
+
+bool GitWatcher::isOutOfSparseCone(const QString &dir) const
+{
+   if (mSparseCone.isEmpty() || !dir.startsWith(mWorkingDir) || dir.startsWith(mRefsDir) || dir.startsWith(mGitDir))
+      return false;
+
+   return !GitSparseCheckout::isInCone(mSparseCone, QDir(mWorkingDir).relativeFilePath(dir));
+}
+
+void GitWatcher::handleEvent(const QString &dir, const QString &fileName, bool newDirectory)
+{
+   ++mEvents;
+
+   if (newDirectory && dir != mGitDir && fileName != ".git")
+   {
+      const auto path = QDir(dir).filePath(fileName);
+
+      // The new directories are only asked to git one by one: a build creates its output in one of them.
+      if (!path.startsWith(mRefsDir) && mGit->run({ "check-ignore", "-q", "--", path }).success)
+         mIgnoredDirs.insert(path);
+      else
+         watchTree(path);
+   }
+
+   notifyChange(dir, fileName);
+}
+
+void GitWatcher::notifyChange(const QString &dir, const QString &fileName)
+{
+   if (dir == mGitDir)
+   {
+      if (fileName == "index")
+      {
+         mIndexChanged = true;
+         restartTimer(mWorkingTreeTimer, mWorkingTreeWait);
+      }
+      else if (STATE_FILES.contains(fileName))
+         restartTimer(mStateTimer, mStateWait);
+   }
+   else if (dir == mRefsDir || dir.startsWith(mRefsDir + '/'))
+   {
+      if (!fileName.endsWith(".lock"))
+         restartTimer(mStateTimer, mStateWait);
+   }
+   else if (!fileName.endsWith(".autosave") && !fileName.endsWith(".tmp") && !fileName.endsWith(".user"))
+   {
+      const auto path = fileName.isEmpty() ? dir : QDir(dir).filePath(fileName);
+      mChangedPaths.insert(QDir(mWorkingDir).relativeFilePath(path));
+
+      restartTimer(mWorkingTreeTimer, mWorkingTreeWait);
+   }
+}
+
+void GitWatcher::notifyWorkingTreeChanges()
+{
+   TraceSpan span("watcher", "GitWatcher::notifyWorkingTreeChanges");
+
+   mWorkingTreeWait.invalidate();
+
+   auto paths = mChangedPaths.values();
+   const auto indexChanged = mIndexChanged;
+   mChangedPaths.clear();
+   mIndexChanged = false;
+
+   if (mPaused)
+   {
+      emit signalWorkingTreeChanged({});
+      return;
+   }
+
+   // The ignored files that change in the directories watched (the objects of a build, for instance) don't affect
+   // the WIP. The changes in the index have no path and are always notified.
+   if (!paths.isEmpty())
+   {
+      QByteArray input;
+
+      for (const auto &path : qAsConst(paths))
+         input.append(path.toUtf8()).append('\0');
+
+      const auto ret = mGit->run({ "check-ignore", "--stdin", "-z" }, input);
+      const auto ignored = QString::fromUtf8(ret.output.toByteArray()).split(QChar('\0'), QString::SkipEmptyParts);
+
+      for (const auto &path : ignored)
+         paths.removeAll(path);
+
+      if (paths.isEmpty() && !indexChanged)
+      {
+         QLog_Trace("UI", QString("Only ignored files changed, the WIP is not updated."));
+         return;
+      }
+   }
+
+   emit signalWorkingTreeChanged(indexChanged ? QStringList() : paths);
+}
+
+void GitWatcher::restartTimer(QTimer *timer, QElapsedTimer &wait)
+{
+   if (!wait.isValid())
+      wait.start();
+
+   // The timer is postponed with every change, but not beyond the maximum wait since the first one.
+   const auto remaining = MAX_WAIT_MS - static_cast<int>(wait.elapsed());
+
+   timer->start(qBound(0, remaining, QUIET_PERIOD_MS));
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+
+class GitBase;
+class QTimer;
+
+/*!
+ \brief The GitWatcher watches a repository for the changes made outside GitQlient. It notifies two kinds of changes:
+ the ones in the work tree and the index, that only affect the WIP, and the ones in the state of the repository (HEAD,
+ the references or a merge in progress), that need to reload the history.
+
+ The directories that git ignores are not watched, and neither is the git directory except for the files that hold
+ its state. On Linux the work tree is watched with inotify directly, adding the directories as they are created; in
+ the rest of the platforms it uses a QFileSystemWatcher with the same directories. The watches are held by the
+ GitWatcherHub, that shares them with the watchers of the submodules and sends every change to the repository that
+ owns it.
+
+ The changes are coalesced: they are notified once they stop for QUIET_PERIOD_MS, or after MAX_WAIT_MS if they never
+ stop, so a build or a checkout only sends a few notifications. The files changed in the meantime are collected, and
+ if git ignores all of them nothing is notified.
+
+ \class GitWatcher GitWatcher.h "GitWatcher.h"
+*/
+class GitWatcher : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when files of the work tree or the index change.
+
+    \param paths The files and directories changed since the last notification, relative to the work tree. When the
+    platform doesn't tell which files changed, they are the directories that contain them. It's empty if the changes
+    can't be limited to some paths, for instance when the index changed.
+   */
+   void signalWorkingTreeChanged(const QStringList &paths);
+   /*!
+    \brief Signal triggered when HEAD, the references or the state of a merge change.
+   */
+   void signalRepositoryStateChanged();
+
+public:
+   /*!
+    \brief The time without changes before they are notified.
+   */
+   static constexpr int QUIET_PERIOD_MS = 300;
+   /*!
+    \brief The maximum time a change waits to be notified while more changes arrive.
+   */
+   static constexpr int MAX_WAIT_MS = 2000;
+
+   /*!
+    \brief Default constructor.
+
+    \param git The git object of the repository.
+    \param parent The parent object if needed.
+   */
+   explicit GitWatcher(const QSharedPointer<GitBase> &git, QObject *parent = nullptr);
+   /*!
+    \brief Destructor. Stops watching.
+   */
+   ~GitWatcher() override;
+
+   /*!
+    \brief Starts watching the repository. If it was watching already, it starts again.
+   */
+   void start();
+   /*!
+    \brief Returns the number of directories and files watched.
+   */
+   int watchCount() const;
+   /*!
+    \brief Returns the number of file system events received since the watcher was created.
+   */
+   qint64 eventCount() const { return mEvents; }
+   /*!
+    \brief Pauses or resumes the filtering of the changes. While paused, the changes are still notified but without
+    asking git which of them are ignored, so the list of paths of signalWorkingTreeChanged is always empty.
+
+    \param paused True to pause the filtering, otherwise false.
+   */
+   void setPaused(bool paused) { mPaused = paused; }
+
+private:
+   QSharedPointer<GitBase> mGit;
+   QString mWorkingDir;
+   QString mGitDir;
+   QString mRefsDir;
+   QSet<QString> mIgnoredDirs;
+   QStringList mSparseCone;
+   QTimer *mWorkingTreeTimer = nullptr;
+   QTimer *mStateTimer = nullptr;
+   QElapsedTimer mWorkingTreeWait;
+   QElapsedTimer mStateWait;
+   QSet<QString> mChangedPaths;
+   bool mIndexChanged = false;
+   bool mWatchLimitReached = false;
+   bool mPaused = false;
+   qint64 mEvents = 0;
+
+   void stop();
+   void loadIgnoredDirs();
+   void watchTree(const QString &dir);
+   bool watchDirectory(const QString &dir);
+   bool isIgnored(const QString &dir) const;
+   bool isOutOfSparseCone(const QString &dir) const;
+   void handleEvent(const QString &dir, const QString &fileName, bool newDirectory);
+   void notifyChange(const QString &dir, const QString &fileName);
+   void notifyWorkingTreeChanges();
+   static void restartTimer(QTimer *timer, QElapsedTimer &wait);
+
+   friend class GitWatcherHub;
+};
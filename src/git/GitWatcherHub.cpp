@@ -0,0 +1,228 @@
+#include "GitWatcherHub.h"
+
+#include <GitWatcher.h>
+
+#include <QDir>
+
+#ifdef Q_OS_LINUX
+#   include <QSocketNotifier>
+
+#   include <cerrno>
+#   include <cstring>
+#   include <sys/inotify.h>
+#   include <unistd.h>
+#else
+#   include <QFileInfo>
+#   include <QFileSystemWatcher>
+#endif
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+#ifdef Q_OS_LINUX
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+#endif
+
+bool isInside(const QString &path, const QString &dir)
+{
+   return path == dir || path.startsWith(dir + '/');
+}
+}
+
+GitWatcherHub &GitWatcherHub::instance()
+{
+   static GitWatcherHub hub;
+
+   return hub;
+}
+
+GitWatcherHub::GitWatcherHub()
+{
+#ifdef Q_OS_LINUX
+   mInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+   if (mInotify == -1)
+   {
+      const auto error = QString::fromLocal8Bit(strerror(errno));
+      QLog_Error("UI", QString("The file watcher couldn't be created: %1").arg(error));
+      return;
+   }
+
+   mNotifier = new QSocketNotifier(mInotify, QSocketNotifier::Read, this);
+   connect(mNotifier, &QSocketNotifier::activated, this, &GitWatcherHub::readEvents);
+#else
+   mWatcher = new QFileSystemWatcher(this);
+   connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &dir) {
+      const auto path = QDir::cleanPath(dir);
+      dispatch(path, path, QString(), false);
+   });
+   connect(mWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &file) {
+      const QFileInfo info(file);
+
+      // Git replaces the files instead of writing them, so the watch goes away with the old file.
+      if (info.exists() && !mWatcher->files().contains(file))
+         mWatcher->addPath(file);
+
+      dispatch(QDir::cleanPath(file), info.absolutePath(), info.fileName(), false);
+   });
+#endif
+}
+
+GitWatcherHub::~GitWatcherHub()
+{
+#ifdef Q_OS_LINUX
+   delete mNotifier;
+
+   if (mInotify != -1)
+      close(mInotify);
+#endif
+}
+
+bool GitWatcherHub::watch(GitWatcher *watcher, const QString &path)
+{
+   auto &subscribers = mSubscribers[path];
+
+   if (subscribers.isEmpty() && !addWatch(path))
+   {
+      mSubscribers.remove(path);
+      return false;
+   }
+
+   if (!subscribers.contains(watcher))
+      subscribers.append(watcher);
+
+   mPaths[watcher].insert(path);
+
+   return true;
+}
+
+void GitWatcherHub::unwatchAll(GitWatcher *watcher)
+{
+   const auto paths = mPaths.take(watcher);
+
+   for (const auto &path : paths)
+   {
+      auto &subscribers = mSubscribers[path];
+      subscribers.removeAll(watcher);
+
+      if (subscribers.isEmpty())
+      {
+         mSubscribers.remove(path);
+         removeWatch(path);
+      }
+   }
+
+   if (!paths.isEmpty())
+      QLog_Debug("UI", QString("Watching %1 paths for all the repositories.").arg(totalWatchCount()));
+}
+
+bool GitWatcherHub::addWatch(const QString &path)
+{
+#ifdef Q_OS_LINUX
+   if (mInotify == -1)
+      return false;
+
+   const auto watch = inotify_add_watch(mInotify, QFile::encodeName(path).constData(), WATCH_MASK);
+
+   if (watch == -1)
+   {
+      if (errno == ENOSPC && !mLimitReached)
+         QLog_Warning("UI", QString("The limit of inotify watches was reached at {%1}.").arg(path));
+
+      mLimitReached = errno == ENOSPC;
+
+      return false;
+   }
+
+   mLimitReached = false;
+   mWatches.insert(watch, path);
+   mDescriptors.insert(path, watch);
+
+   return true;
+#else
+   return mWatcher->addPath(path);
+#endif
+}
+
+void GitWatcherHub::removeWatch(const QString &path)
+{
+#ifdef Q_OS_LINUX
+   if (const auto watch = mDescriptors.take(path); mWatches.remove(watch) > 0)
+      inotify_rm_watch(mInotify, watch);
+#else
+   mWatcher->removePath(path);
+#endif
+
+   mLimitReached = false;
+}
+
+void GitWatcherHub::dispatch(const QString &watched, const QString &dir, const QString &fileName, bool newDirectory)
+{
+   const auto subscribers = mSubscribers.value(watched);
+
+   if (subscribers.isEmpty())
+      return;
+
+   // The owner is the repository with the deepest work tree that contains the path. Its git directory is only watched
+   // by itself, so it's the owner too.
+   auto owner = subscribers.first();
+
+   for (const auto watcher : subscribers)
+   {
+      if (isInside(dir, watcher->mWorkingDir)
+          && (!isInside(dir, owner->mWorkingDir) || watcher->mWorkingDir.count() > owner->mWorkingDir.count()))
+         owner = watcher;
+   }
+
+   owner->handleEvent(dir, fileName, newDirectory);
+
+   for (const auto watcher : subscribers)
+   {
+      if (watcher != owner)
+         watcher->notifyChange(owner->mWorkingDir, QString());
+   }
+}
+
+#ifdef Q_OS_LINUX
+void GitWatcherHub::readEvents()
+{
+   alignas(inotify_event) char buffer[4096];
+   ssize_t length = 0;
+
+   while ((length = read(mInotify, buffer, sizeof(buffer))) > 0)
+   {
+      for (auto ptr = buffer; ptr < buffer + length;)
+      {
+         const auto event = reinterpret_cast<const inotify_event *>(ptr);
+         ptr += sizeof(inotify_event) + event->len;
+
+         if (event->mask & IN_IGNORED)
+         {
+            // The directory is gone: none of the watchers watches it anymore.
+            if (const auto dir = mWatches.take(event->wd); !dir.isEmpty())
+            {
+               mDescriptors.remove(dir);
+
+               for (const auto watcher : mSubscribers.take(dir))
+                  mPaths[watcher].remove(dir);
+            }
+
+            continue;
+         }
+
+         const auto dir = mWatches.value(event->wd);
+
+         if (dir.isEmpty())
+            continue;
+
+         const auto fileName = event->len > 0 ? QFile::decodeName(event->name) : QString();
+         const auto newDirectory = (event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO));
+
+         dispatch(dir, dir, fileName, newDirectory);
+      }
+   }
+}
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+class GitWatcher;
+class QFileSystemWatcher;
+class QSocketNotifier;
+
+/*!
+ \brief The GitWatcherHub holds the watches of the files and directories of all the GitWatchers, so a directory watched
+ by several of them, like the ones of a submodule that is open in its own tab and inside its superproject, is watched
+ only once. On Linux there is a single inotify instance for the application; in the rest of the platforms, a single
+ QFileSystemWatcher.
+
+ The changes in a path are sent to the watcher of the repository that owns it: the one whose work tree is the deepest
+ that contains the path. The rest of the watchers of the path, the ones of the superprojects, are only told that the
+ work tree of that repository changed.
+
+ \class GitWatcherHub GitWatcherHub.h "GitWatcherHub.h"
+*/
+class GitWatcherHub : public QObject
+{
+   Q_OBJECT
+
+public:
+   /*!
+    \brief Returns the hub of the application.
+   */
+   static GitWatcherHub &instance();
+
+   /*!
+    \brief Watches a directory, or a file on the platforms that don't use inotify, for a watcher.
+
+    \param watcher The watcher.
+    \param path The absolute path.
+    \return True if the path is watched, otherwise false.
+   */
+   bool watch(GitWatcher *watcher, const QString &path);
+   /*!
+    \brief Stops watching all the paths of a watcher. The paths that no other watcher needs are not watched anymore.
+
+    \param watcher The watcher.
+   */
+   void unwatchAll(GitWatcher *watcher);
+   /*!
+    \brief Returns the number of paths watched for a watcher.
+   */
+   int watchCount(const GitWatcher *watcher) const { return mPaths.value(watcher).count(); }
+   /*!
+    \brief Returns the number of paths watched for all the watchers.
+   */
+   int totalWatchCount() const { return mSubscribers.count(); }
+   /*!
+    \brief Tells if the last path couldn't be watched because the system limit of watches was reached.
+   */
+   bool isLimitReached() const { return mLimitReached; }
+
+private:
+   QHash<QString, QVector<GitWatcher *>> mSubscribers;
+   QHash<const GitWatcher *, QSet<QString>> mPaths;
+   bool mLimitReached = false;
+#ifdef Q_OS_LINUX
+   int mInotify = -1;
+   QSocketNotifier *mNotifier = nullptr;
+   QHash<int, QString> mWatches;
+   QHash<QString, int> mDescriptors;
+#else
+   QFileSystemWatcher *mWatcher = nullptr;
+#endif
+
+   GitWatcherHub();
+   ~GitWatcherHub() override;
+
+   bool addWatch(const QString &path);
+   void removeWatch(const QString &path);
+   void dispatch(const QString &watched, const QString &dir, const QString &fileName, bool newDirectory);
+#ifdef Q_OS_LINUX
+   void readEvents();
+#endif
+};
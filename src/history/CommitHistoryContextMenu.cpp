@@ -11,6 +11,7 @@
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
 #include <PullDlg.h>
+#include <ProgressDlg.h>
 
 #include <QMessageBox>
 #include <QApplication>
@@ -108,6 +109,16 @@ void CommitHistoryContextMenu::createIndividualShaMenu()
          connect(copyShaAction, &QAction::triggered, this,
                  [this]() { QApplication::clipboard()->setText(mShas.first()); });
 
+         const auto commit = mCache->getCommitInfo(sha);
+         const auto authorId = commit.authorId();
+         const auto filterByAuthorAction
+             = addAction(QString("Show only commits by %1 (%2)")
+                             .arg(commit.authorName(), QString::number(mCache->getAuthorCommitsCount(authorId))));
+         connect(filterByAuthorAction, &QAction::triggered, this,
+                 [this, authorId]() { emit signalFilterByAuthor(authorId); });
+
+         addContainingReferencesMenu(sha);
+
          addSeparator();
 
          const auto resetSoftAction = addAction("Reset - Soft");
@@ -182,7 +193,16 @@ void CommitHistoryContextMenu::createTag()
 void CommitHistoryContextMenu::exportAsPatch()
 {
    QScopedPointer<GitPatches> git(new GitPatches(mGit));
-   const auto ret = git->exportPatch(mShas);
+   // The dialog deletes itself when it's closed.
+   const auto progressDlg = new ProgressDlg(tr("Exporting patches..."), QString(), 0, mShas.count(), false, false);
+   progressDlg->show();
+
+   const auto ret = git->exportPatch(mShas, [progressDlg](int exported, int total) {
+      progressDlg->setMaximum(total);
+      progressDlg->setValue(exported);
+   });
+
+   progressDlg->close();
 
    if (ret.success)
    {
@@ -256,7 +276,7 @@ void CommitHistoryContextMenu::checkoutCommit()
    const auto ret = git->checkoutCommit(sha);
 
    if (ret.success)
-      emit signalRepositoryUpdated();
+      emit signalCheckedOut();
    else
       QMessageBox::critical(this, tr("Checkout error"), ret.output.toString());
 }
@@ -396,9 +416,8 @@ void CommitHistoryContextMenu::addBranchActions(const QString &sha)
 {
    auto isCommitInCurrentBranch = false;
    const auto currentBranch = mGit->getCurrentBranch();
-   const auto commitInfo = mCache->getCommitInfo(sha);
-   const auto remoteBranches = commitInfo.getReferences(References::Type::RemoteBranches);
-   const auto localBranches = commitInfo.getReferences(References::Type::LocalBranch);
+   const auto remoteBranches = mCache->getReferences(sha, References::Type::RemoteBranches);
+   const auto localBranches = mCache->getReferences(sha, References::Type::LocalBranch);
    auto branches = localBranches;
 
    for (const auto &branch : remoteBranches)
@@ -449,3 +468,41 @@ void CommitHistoryContextMenu::addBranchActions(const QString &sha)
       connect(cherryPickAction, &QAction::triggered, this, &CommitHistoryContextMenu::cherryPickCommit);
    }
 }
+
+void CommitHistoryContextMenu::addContainingReferencesMenu(const QString &sha)
+{
+   // Only a few names are listed: the rest are counted.
+   static constexpr int MAX_NAMES_PER_TYPE = 20;
+
+   const auto containingMenu = addMenu(tr("Branches and tags containing it"));
+
+   connect(containingMenu, &QMenu::aboutToShow, this, [this, containingMenu, sha]() {
+      if (!containingMenu->isEmpty())
+         return;
+
+      const auto containing = mCache->getContainingReferences(sha);
+
+      const auto addNames = [this, containingMenu](const QString &title, const QStringList &names) {
+         if (names.isEmpty())
+            return;
+
+         containingMenu->addSection(QString("%1 (%2)").arg(title, QString::number(names.count())));
+
+         for (const auto &name : names.mid(0, MAX_NAMES_PER_TYPE))
+         {
+            const auto action = containingMenu->addAction(name);
+            connect(action, &QAction::triggered, this, [name]() { QApplication::clipboard()->setText(name); });
+         }
+
+         if (const auto more = names.count() - MAX_NAMES_PER_TYPE; more > 0)
+            containingMenu->addAction(tr("... and %1 more").arg(more))->setEnabled(false);
+      };
+
+      addNames(tr("Local branches"), containing.localBranches);
+      addNames(tr("Remote branches"), containing.remoteBranches);
+      addNames(tr("Tags"), containing.tags);
+
+      if (containingMenu->isEmpty())
+         containingMenu->addAction(tr("No branch or tag loaded contains it"))->setEnabled(false);
+   });
+}
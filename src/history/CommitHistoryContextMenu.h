@@ -43,6 +43,10 @@ signals:
     \brief Signal triggered when some action in the context menu things the main UI needs an update.
    */
    void signalRepositoryUpdated();
+   /*!
+    \brief Signal triggered when a commit is checked out.
+   */
+   void signalCheckedOut();
    /*!
     \brief Signal triggered when the user wants to open the diff of a commit compared to its parent.
 
@@ -78,6 +82,12 @@ signals:
     * \brief signalPullConflict Signal triggered when trying to pull and a conflict happens.
     */
    void signalPullConflict();
+   /*!
+    \brief Signal triggered when the user wants to see only the commits of an author.
+
+    \param authorId The id of the author in the IdentityTable.
+   */
+   void signalFilterByAuthor(int authorId);
 
 public:
    /*!
@@ -180,4 +190,10 @@ private:
     \param sha The SHA of the current commit.
    */
    void addBranchActions(const QString &sha);
+   /*!
+    \brief Adds the menu with the branches and tags that contain the commit. They are found when the menu is opened.
+
+    \param sha The SHA of the current commit.
+   */
+   void addContainingReferencesMenu(const QString &sha);
 };
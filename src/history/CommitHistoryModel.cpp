@@ -1,18 +1,41 @@
 #include "CommitHistoryModel.h"
 
 #include <CommitHistoryColumns.h>
-#include <CommitInfo.h>
+#include <CommitView.h>
+#include <DateFormatter.h>
 #include <RevisionsCache.h>
 #include <GitBase.h>
+#include <GitCommitDetails.h>
+#include <FrameStatistics.h>
+#include <SubgraphLanes.h>
 
 #include <QDateTime>
 
+#include <algorithm>
+
+static const int PREFETCH_ROWS = 64;
+static const int MAX_CACHED_TOOLTIPS = 512;
+
 CommitHistoryModel::CommitHistoryModel(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                                        QObject *p)
    : QAbstractItemModel(p)
    , mCache(cache)
    , mGit(git)
+   , mSubgraphLanes(new SubgraphLanes(cache, this))
+   , mCommitDetails(new GitCommitDetails(git, cache, this))
+   , mToolTips(MAX_CACHED_TOOLTIPS)
 {
+   connect(mSubgraphLanes, &SubgraphLanes::signalLanesReady, this, [this]() {
+      const auto graph = static_cast<int>(CommitHistoryColumns::GRAPH);
+
+      if (mFiltering && !mFilteredRows.isEmpty())
+         emit dataChanged(index(0, graph), index(mFilteredRows.count() - 1, graph));
+   });
+   connect(mCommitDetails, &GitCommitDetails::signalDetailsLoaded, this, [this]() {
+      mToolTips.clear();
+      materializeRows(true);
+   });
+
    mColumns.insert(CommitHistoryColumns::ID, "Id");
    mColumns.insert(CommitHistoryColumns::GRAPH, "Graph");
    mColumns.insert(CommitHistoryColumns::SHA, "Sha");
@@ -23,7 +46,10 @@ CommitHistoryModel::CommitHistoryModel(const QSharedPointer<RevisionsCache> &cac
 
 int CommitHistoryModel::rowCount(const QModelIndex &parent) const
 {
-   return !parent.isValid() ? mCache->count() : 0;
+   if (parent.isValid())
+      return 0;
+
+   return mFiltering ? mFilteredRows.count() : mRowCount;
 }
 
 bool CommitHistoryModel::hasChildren(const QModelIndex &parent) const
@@ -36,20 +62,267 @@ QString CommitHistoryModel::sha(int row) const
    return index(row, static_cast<int>(CommitHistoryColumns::SHA)).data().toString();
 }
 
+void CommitHistoryModel::filterBySha(const QStringList &shaList)
+{
+   filter(HistoryFilter::shas(shaList));
+}
+
+void CommitHistoryModel::filter(const HistoryFilter &filter)
+{
+   beginResetModel();
+   mFiltering = true;
+   mFilter = filter;
+   updateFilteredRows();
+   mMaterializedRows.clear();
+   materializeRows(false);
+   endResetModel();
+}
+
+void CommitHistoryModel::clearFilter()
+{
+   beginResetModel();
+   mFiltering = false;
+   mFilter = HistoryFilter();
+   mFilteredRows.clear();
+   mSubgraphLanes->clear();
+   mMaterializedRows.clear();
+   materializeRows(false);
+   endResetModel();
+}
+
+QVector<Lane> CommitHistoryModel::subgraphLanes(int row) const
+{
+   return mFiltering ? mSubgraphLanes->lanes(row) : QVector<Lane>();
+}
+
+int CommitHistoryModel::rowFromSource(int sourceRow) const
+{
+   if (!mFiltering)
+      return sourceRow;
+
+   const auto iter = std::lower_bound(mFilteredRows.constBegin(), mFilteredRows.constEnd(), sourceRow);
+
+   return iter != mFilteredRows.constEnd() && *iter == sourceRow ? static_cast<int>(iter - mFilteredRows.constBegin())
+                                                                 : -1;
+}
+
+void CommitHistoryModel::updateFilteredRows()
+{
+   const auto rows = mFilterResults.evaluate(mFilter, *mCache);
+   const auto count = std::min(rows.size(), mRowCount);
+
+   mFilteredRows.clear();
+   mFilteredRows.reserve(rows.count(true));
+
+   for (auto row = 0; row < count; ++row)
+   {
+      if (rows.testBit(row))
+         mFilteredRows.append(row);
+   }
+
+   mSubgraphLanes->rebuild(mFilteredRows);
+}
+
 void CommitHistoryModel::clear()
 {
    beginResetModel();
+   mRowCount = 0;
+   mFilteredRows.clear();
+   mMaterializedRows.clear();
+   mToolTips.clear();
    endResetModel();
    emit headerDataChanged(Qt::Horizontal, 0, 5);
 }
 
 void CommitHistoryModel::onNewRevisions(int totalCommits)
 {
+   // The references and the author counts shown in the tool tips are loaded again with the revisions.
+   mToolTips.clear();
+
+   const auto shift = mRowCount > 0 ? mCache->rowsShiftSince(mGeneration) : -1;
+
+   mGeneration = mCache->generation();
+
+   if (!mFiltering && shift >= 0 && mRowCount + shift <= totalCommits)
+   {
+      // The new commits go below the WIP, that is always the first row.
+      if (shift > 0)
+      {
+         beginInsertRows(QModelIndex(), 1, shift);
+         mRowCount += shift;
+         endInsertRows();
+      }
+
+      if (totalCommits > mRowCount)
+      {
+         beginInsertRows(QModelIndex(), mRowCount, totalCommits - 1);
+         mRowCount = totalCommits;
+         endInsertRows();
+      }
+
+      // The references of the old commits are loaded again and the WIP might have changed.
+      mMaterializedRows.clear();
+      materializeRows(false);
+
+      if (mRowCount > 0)
+         emit dataChanged(index(0, 0), index(mRowCount - 1, columnCount() - 1));
+
+      return;
+   }
+
    beginResetModel();
+   mRowCount = totalCommits;
+
+   if (mFiltering)
+      updateFilteredRows();
+
+   mMaterializedRows.clear();
+   materializeRows(false);
    endResetModel();
+}
+
+void CommitHistoryModel::onRevisionsChunkLoaded(int totalCommits)
+{
+   mToolTips.clear();
+
+   // The filtered rows move when the history is reloaded, so they are resolved again.
+   if (mFiltering)
+   {
+      onNewRevisions(totalCommits);
+      return;
+   }
 
-   beginInsertRows(QModelIndex(), 0, totalCommits - 2);
-   endInsertRows();
+   if (totalCommits > mRowCount)
+   {
+      beginInsertRows(QModelIndex(), mRowCount, totalCommits - 1);
+      mRowCount = totalCommits;
+      endInsertRows();
+   }
+
+   // The chunks only append rows, so only the rows whose display data really changed are notified.
+   materializeRows(true);
+}
+
+void CommitHistoryModel::onReferencesUpdated(const QStringList &shas)
+{
+   // The tool tips show the references too.
+   mToolTips.clear();
+
+   for (const auto &sha : shas)
+   {
+      if (const auto row = rowFromSource(mCache->getCommitPos(sha)); row != -1)
+         emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+   }
+}
+
+void CommitHistoryModel::onLanesChanged()
+{
+   if (rowCount() > 0)
+      emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+}
+
+void CommitHistoryModel::setHasMoreRevisions(bool moreRevisions)
+{
+   mMoreRevisions = moreRevisions;
+   mFetchingMore = false;
+}
+
+bool CommitHistoryModel::canFetchMore(const QModelIndex &parent) const
+{
+   return !parent.isValid() && mMoreRevisions && !mFetchingMore && !mFiltering;
+}
+
+void CommitHistoryModel::fetchMore(const QModelIndex &parent)
+{
+   if (canFetchMore(parent))
+   {
+      mFetchingMore = true;
+
+      emit signalMoreRevisionsRequested();
+   }
+}
+
+void CommitHistoryModel::setVisibleRows(int first, int last)
+{
+   mVisibleFirstRow = first;
+   mVisibleLastRow = last;
+
+   materializeRows(false);
+
+   // The view only asks for more rows once it reaches the last one: the next page is loaded before that.
+   if (mVisibleLastRow + PREFETCH_ROWS >= mRowCount)
+      fetchMore(QModelIndex());
+}
+
+void CommitHistoryModel::materializeRows(bool verify)
+{
+   const auto first = std::max(0, mVisibleFirstRow - PREFETCH_ROWS);
+   const auto last = std::min(rowCount() - 1, mVisibleLastRow + PREFETCH_ROWS);
+
+   if (last < first)
+   {
+      mFirstMaterializedRow = 0;
+      mMaterializedRows.clear();
+      return;
+   }
+
+   QVector<RowDisplayData> rows;
+   rows.reserve(last - first + 1);
+
+   QVector<QPair<int, int>> changedRanges;
+   QVector<ObjectId> missingDetails;
+
+   for (auto row = first; row <= last; ++row)
+   {
+      // The commits loaded without details only get their author and log once they are shown.
+      if (const auto commit = mCache->getCommitViewByRow(sourceRow(row)); commit.isValid() && !commit.hasDetails())
+         missingDetails.append(commit.id());
+
+      const auto previous = row - mFirstMaterializedRow;
+      const auto isKnown = previous >= 0 && previous < mMaterializedRows.count();
+
+      if (isKnown && !verify)
+      {
+         rows.append(mMaterializedRows.at(previous));
+         continue;
+      }
+
+      rows.append(buildRowDisplayData(row));
+
+      if (isKnown && !(rows.constLast() == mMaterializedRows.at(previous)))
+      {
+         if (!changedRanges.isEmpty() && changedRanges.constLast().second == row - 1)
+            changedRanges.last().second = row;
+         else
+            changedRanges.append(qMakePair(row, row));
+      }
+   }
+
+   mFirstMaterializedRow = first;
+   mMaterializedRows = rows;
+
+   for (const auto &range : qAsConst(changedRanges))
+      emit dataChanged(index(range.first, 0), index(range.second, columnCount() - 1));
+
+   if (!missingDetails.isEmpty())
+      mCommitDetails->request(missingDetails);
+}
+
+CommitHistoryModel::RowDisplayData CommitHistoryModel::buildRowDisplayData(int row) const
+{
+   RowDisplayData data;
+   const auto commit = mCache->getCommitViewByRow(sourceRow(row));
+
+   if (commit.isValid())
+   {
+      data.isValid = true;
+      data.sha = commit.sha();
+      data.shortLog = commit.shortLog();
+      data.author = commit.authorName();
+      data.date = DateFormatter::format(commit.secsSinceEpoch());
+   }
+
+   return data;
 }
 
 QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -62,7 +335,7 @@ QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation
 
 QModelIndex CommitHistoryModel::index(int row, int column, const QModelIndex &) const
 {
-   return row >= 0 && row < mCache->count() ? createIndex(row, column, nullptr) : QModelIndex();
+   return row >= 0 && row < rowCount() ? createIndex(row, column, nullptr) : QModelIndex();
 }
 
 QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
@@ -70,10 +343,12 @@ QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
    return QModelIndex();
 }
 
-QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
+QVariant CommitHistoryModel::getToolTipData(const CommitView &r) const
 {
+   if (r.isWip())
+      return QString();
+
    QString auxMessage;
-   const auto sha = r.sha();
 
    if (mGit->getCurrentBranch().isEmpty())
       auxMessage.append("<p>Status: <b>detached</b></p>");
@@ -93,32 +368,40 @@ QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
    if (!tags.isEmpty())
       auxMessage.append(QString("<p><b>Tags: </b>%1</p>").arg(tags.join(",")));
 
-   QDateTime d;
-   d.setSecsSinceEpoch(r.authorDate().toUInt());
+   // The walk is limited: the tool tip can't stop the UI when the commit is deep in a big history.
+   static constexpr int CONTAINING_MAX_ROWS = 50000;
+
+   const auto containing = mCache->getContainingReferences(r.sha(), CONTAINING_MAX_ROWS);
+   const auto branches = containing.localBranches.count() + containing.remoteBranches.count();
+
+   if (branches > 0 || !containing.tags.isEmpty())
+   {
+      auxMessage.append(QString("<p><b>Contained in: </b>%1%2 branches and %3 tags</p>")
+                            .arg(containing.complete ? QString() : tr("at least "), QString::number(branches),
+                                 QString::number(containing.tags.count())));
+   }
+
+   const auto d = QDateTime::fromSecsSinceEpoch(r.secsSinceEpoch());
+
+   const auto authorCommits = mCache->getAuthorCommitsCount(r.authorId());
 
-   return sha == CommitInfo::ZERO_SHA
-       ? QString()
-       : QString("<p>%1 - %2<p></p>%3</p>%4")
-             .arg(r.author().split("<").first(), d.toString(Qt::SystemLocaleShortDate), sha, auxMessage);
+   return QString("<p>%1 (%2 commits) - %3<p></p>%4</p>%5")
+       .arg(r.authorName(), QString::number(authorCommits), d.toString(Qt::SystemLocaleShortDate), r.sha(),
+            auxMessage);
 }
 
-QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) const
+QVariant CommitHistoryModel::getDisplayData(const CommitView &rev, int column) const
 {
    switch (static_cast<CommitHistoryColumns>(column))
    {
-      case CommitHistoryColumns::SHA: {
-         const auto sha = rev.sha();
-         return sha;
-      }
+      case CommitHistoryColumns::SHA:
+         return rev.sha();
       case CommitHistoryColumns::LOG:
          return rev.shortLog();
-      case CommitHistoryColumns::AUTHOR: {
-         const auto author = rev.author().split("<").first();
-         return author;
-      }
-      case CommitHistoryColumns::DATE: {
-         return QDateTime::fromSecsSinceEpoch(rev.authorDate().toUInt()).toString("dd MMM yyyy hh:mm");
-      }
+      case CommitHistoryColumns::AUTHOR:
+         return rev.authorName();
+      case CommitHistoryColumns::DATE:
+         return DateFormatter::format(rev.secsSinceEpoch());
       default:
          return QVariant();
    }
@@ -129,10 +412,62 @@ QVariant CommitHistoryModel::data(const QModelIndex &index, int role) const
    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
       return QVariant();
 
-   const auto r = mCache->getCommitInfoByRow(index.row());
+   if (mFrameStatistics)
+      mFrameStatistics->addDataCall();
+
+   if (role == Qt::DisplayRole)
+   {
+      const auto materialized = index.row() - mFirstMaterializedRow;
+
+      if (materialized >= 0 && materialized < mMaterializedRows.count())
+      {
+         const auto &data = mMaterializedRows.at(materialized);
+
+         if (!data.isValid)
+            return QVariant();
+
+         switch (static_cast<CommitHistoryColumns>(index.column()))
+         {
+            case CommitHistoryColumns::SHA:
+               return data.sha;
+            case CommitHistoryColumns::LOG:
+               return data.shortLog;
+            case CommitHistoryColumns::AUTHOR:
+               return data.author;
+            case CommitHistoryColumns::DATE:
+               return data.date;
+            default:
+               return QVariant();
+         }
+      }
+   }
+
+   const auto row = sourceRow(index.row());
 
    if (role == Qt::ToolTipRole)
-      return getToolTipData(r);
+   {
+      if (mToolTipsGeneration != mCache->generation())
+      {
+         mToolTips.clear();
+         mToolTipsGeneration = mCache->generation();
+      }
+
+      if (const auto toolTip = mToolTips.object(row))
+         return *toolTip;
+   }
+
+   const auto r = mCache->getCommitViewByRow(row);
+
+   if (!r.isValid())
+      return QVariant();
+
+   if (role == Qt::ToolTipRole)
+   {
+      const auto toolTip = getToolTipData(r).toString();
+      mToolTips.insert(row, new QString(toolTip));
+
+      return toolTip;
+   }
 
    if (role == Qt::DisplayRole)
       return getDisplayData(r, index.column());
@@ -23,12 +23,20 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <HistoryFilter.h>
+#include <Lane.h>
+
 #include <QAbstractItemModel>
+#include <QCache>
 #include <QSharedPointer>
+#include <QVector>
 
 class RevisionsCache;
 class GitBase;
-class CommitInfo;
+class CommitView;
+class FrameStatistics;
+class SubgraphLanes;
+class GitCommitDetails;
 enum class CommitHistoryColumns;
 
 /**
@@ -40,6 +48,13 @@ enum class CommitHistoryColumns;
 class CommitHistoryModel : public QAbstractItemModel
 {
    Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when the view needs the commits after the last row of a partial history.
+    */
+   void signalMoreRevisionsRequested();
+
 public:
    /**
     * @brief The default constructor.
@@ -63,6 +78,68 @@ public:
     * @return QString The SHA.
     */
    QString sha(int row) const;
+   /**
+    * @brief Filters the model so it only shows the commits of the given SHAs. The rows of the commits are resolved
+    * once against the cache and kept in a sorted vector, so the view doesn't need a proxy model.
+    *
+    * It is the same as filtering by HistoryFilter::shas.
+    *
+    * @param shaList The SHAs to show.
+    */
+   void filterBySha(const QStringList &shaList);
+   /**
+    * @brief Filters the model so it only shows the rows accepted by the filter. The filter is evaluated again when the
+    * history is reloaded. The results of the last filters are kept, so going back to a previous filter (e.g. selecting
+    * again the tab of a file) doesn't evaluate it again, and only the new rows are evaluated when the history grows.
+    *
+    * @param filter The filter to apply.
+    */
+   void filter(const HistoryFilter &filter);
+   /**
+    * @brief Removes the filter so the model shows the whole history again.
+    */
+   void clearFilter();
+   /**
+    * @brief Tells if the model is showing only a subset of the rows of the cache.
+    *
+    * @return bool True if the model is filtered. Otherwise, false.
+    */
+   bool hasActiveFilter() const { return mFiltering; }
+   /**
+    * @brief Returns the row in the cache of a row of the model.
+    *
+    * @param row The row of the model.
+    * @return int The row in the cache.
+    */
+   int sourceRow(int row) const { return mFiltering ? mFilteredRows.value(row, -1) : row; }
+   /**
+    * @brief Returns the row of the model that shows a row of the cache.
+    *
+    * @param sourceRow The row in the cache.
+    * @return int The row in the model or -1 if the filter doesn't show it.
+    */
+   int rowFromSource(int sourceRow) const;
+   /**
+    * @brief Returns the lanes of a row of the filtered history, calculated over the commits the filter shows.
+    *
+    * @param row The row of the model.
+    * @return QVector<Lane> The lanes, or an empty vector if they are not calculated yet or there is no filter.
+    */
+   QVector<Lane> subgraphLanes(int row) const;
+   /**
+    * @brief Tells the model which rows the view shows. The display data of those rows, plus a margin before and after
+    * them, is prepared once from the typed columns of the cache and kept until the rows scroll out of the margin.
+    *
+    * @param first The first visible row.
+    * @param last The last visible row.
+    */
+   void setVisibleRows(int first, int last);
+   /**
+    * @brief Sets the statistics where the calls to @ref data are counted.
+    *
+    * @param statistics The paint statistics of the view.
+    */
+   void setFrameStatistics(const QSharedPointer<FrameStatistics> &statistics) { mFrameStatistics = statistics; }
 
    /**
     * @brief Returns the data stored under the given \p role for the item referred to by the \p index
@@ -119,11 +196,52 @@ public:
     */
    int columnCount(const QModelIndex &) const override { return mColumns.count(); }
    /**
-    * @brief Resets the model when new revisions are available.
+    * @brief Updates the model when new revisions are available. When the new generation of the cache only adds
+    * commits on top of the history (below the WIP) or at the bottom of it, the rows are inserted so the selection and
+    * the scroll of the view are kept. Otherwise, or when filtering, the model is reset.
     *
     * @param totalCommits The total of new revisions.
     */
    void onNewRevisions(int totalCommits);
+   /**
+    * @brief Updates the model while the revisions are being loaded. The new rows are inserted incrementally and the
+    * rows that were already loaded are refreshed.
+    *
+    * @param totalCommits The total of revisions available in the cache.
+    */
+   void onRevisionsChunkLoaded(int totalCommits);
+   /**
+    * @brief Refreshes the rows of the commits whose references changed, without resetting the model.
+    *
+    * @param shas The commits whose references changed.
+    */
+   void onReferencesUpdated(const QStringList &shas);
+   /**
+    * @brief Refreshes all the rows when the lanes of the graph are calculated again, without resetting the model.
+    */
+   void onLanesChanged();
+   /**
+    * @brief Tells the model if the history loaded is partial, so the view can ask for the next commits through
+    * @ref fetchMore when it gets near the last row.
+    *
+    * @param moreRevisions True if there are more commits to load.
+    */
+   void setHasMoreRevisions(bool moreRevisions);
+   /**
+    * @brief Returns if there are more commits to load and they are not being loaded already. The filtered history
+    * doesn't load more commits.
+    *
+    * @param parent The parent index.
+    * @return bool True if more commits can be requested.
+    */
+   bool canFetchMore(const QModelIndex &parent) const override;
+   /**
+    * @brief Requests the next commits of the history through @ref signalMoreRevisionsRequested. The rows are added
+    * when they are loaded.
+    *
+    * @param parent The parent index.
+    */
+   void fetchMore(const QModelIndex &parent) override;
    /*!
     * \brief Gets the number of columns in the model.
     * \return The number of columns.
@@ -133,6 +251,62 @@ public:
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
+   int mRowCount = 0;
+   int mGeneration = 0;
+   bool mMoreRevisions = false;
+   bool mFetchingMore = false;
+   bool mFiltering = false;
+   HistoryFilter mFilter;
+   HistoryFilterCache mFilterResults;
+   QVector<int> mFilteredRows;
+   SubgraphLanes *mSubgraphLanes = nullptr;
+   GitCommitDetails *mCommitDetails = nullptr;
+   mutable QCache<int, QString> mToolTips;
+   mutable int mToolTipsGeneration = -1;
+   QSharedPointer<FrameStatistics> mFrameStatistics;
+
+   /**
+    * @brief The display data of a row, as returned by @ref data for the DisplayRole.
+    */
+   struct RowDisplayData
+   {
+      bool isValid = false;
+      QString sha;
+      QString shortLog;
+      QString author;
+      QString date;
+
+      bool operator==(const RowDisplayData &other) const
+      {
+         return isValid == other.isValid && sha == other.sha && shortLog == other.shortLog && author == other.author
+             && date == other.date;
+      }
+   };
+
+   int mVisibleFirstRow = 0;
+   int mVisibleLastRow = -1;
+   int mFirstMaterializedRow = 0;
+   QVector<RowDisplayData> mMaterializedRows;
+
+   /**
+    * @brief Prepares the display data of the visible rows and the prefetch margin.
+    *
+    * @param verify If true, the data of the rows that were already prepared is built again and dataChanged is emitted
+    * for the ranges that really changed. Otherwise, the rows that were already prepared are reused.
+    */
+   void materializeRows(bool verify);
+   /**
+    * @brief Builds the display data of a row of the model.
+    *
+    * @param row The row of the model.
+    * @return The display data.
+    */
+   RowDisplayData buildRowDisplayData(int row) const;
+
+   /**
+    * @brief Evaluates the filter to get the rows of the cache the model shows.
+    */
+   void updateFilteredRows();
 
    /**
     * @brief Returns the tool tip data.
@@ -140,7 +314,7 @@ private:
     * @param r The commit to generate the tooltip data.
     * @return QVariant The tool tip data.
     */
-   QVariant getToolTipData(const CommitInfo &r) const;
+   QVariant getToolTipData(const CommitView &r) const;
    /**
     * @brief Returns the data that will be display for every \p column.
     *
@@ -148,7 +322,7 @@ private:
     * @param column The column where the data will be shown.
     * @return QVariant The data to be shown.
     */
-   QVariant getDisplayData(const CommitInfo &rev, int column) const;
+   QVariant getDisplayData(const CommitView &rev, int column) const;
 
    QMap<CommitHistoryColumns, QString> mColumns;
 };
@@ -3,13 +3,26 @@
 #include <CommitHistoryModel.h>
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryContextMenu.h>
-#include <ShaFilterProxyModel.h>
+#include <DateScrollBar.h>
+#include <FrameStatistics.h>
+#include <HistoryOverview.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
+#include <HistoryFilter.h>
+#include <GitQlientSettings.h>
 
 #include <QHeaderView>
-#include <QSettings>
 #include <QDateTime>
+#include <QMenu>
+#include <QPainter>
+
+#ifndef QT_NO_OPENGL
+#   include <QOffscreenSurface>
+#   include <QOpenGLContext>
+#   include <QOpenGLWidget>
+#endif
+
+#include <algorithm>
 
 #include <QLogger.h>
 using namespace QLogger;
@@ -19,7 +32,24 @@ CommitHistoryView::CommitHistoryView(const QSharedPointer<RevisionsCache> &cache
    : QTreeView(parent)
    , mCache(cache)
    , mGit(git)
+   , mDateScrollBar(new DateScrollBar(this))
+   , mOverview(new HistoryOverview(this))
 {
+   setVerticalScrollBar(mDateScrollBar);
+
+   GitQlientSettings settings;
+
+   if (settings.value("acceleratedGraph", false).toBool())
+      setupAcceleratedViewport();
+
+   connect(mDateScrollBar, &QScrollBar::valueChanged, this, &CommitHistoryView::updateVisibleRows);
+   connect(mDateScrollBar, &QScrollBar::rangeChanged, this, &CommitHistoryView::updateVisibleRows);
+   connect(mDateScrollBar, &QScrollBar::rangeChanged, this,
+           [this]() { mOverview->setHeight(mDateScrollBar->height()); });
+   connect(mOverview, &HistoryOverview::signalImageReady, this, [this](const QImage &image) {
+      // The overview is drawn for the rows of the whole history.
+      mDateScrollBar->setOverview(mIsFiltering ? QImage() : image);
+   });
    setEnabled(false);
    setContextMenuPolicy(Qt::CustomContextMenu);
    setItemsExpandable(false);
@@ -39,6 +69,34 @@ void CommitHistoryView::setModel(QAbstractItemModel *model)
 
    mCommitHistoryModel = dynamic_cast<CommitHistoryModel *>(model);
    QTreeView::setModel(model);
+
+   connect(model, &QAbstractItemModel::modelReset, this, &CommitHistoryView::updateOverview);
+   connect(model, &QAbstractItemModel::rowsInserted, this, &CommitHistoryView::updateOverview);
+
+   GitQlientSettings settings;
+
+   if (settings.value("frameStatistics", false).toBool() && mCommitHistoryModel && !mFrameStatistics)
+   {
+      mFrameStatistics = QSharedPointer<FrameStatistics>::create(mCommitHistoryModel->columnCount());
+      mCommitHistoryModel->setFrameStatistics(mFrameStatistics);
+
+      // Scrolling moves the pixels of the viewport, so it's painted again to measure the full frames and to keep the
+      // statistics in their place.
+      connect(verticalScrollBar(), &QScrollBar::valueChanged, viewport(), qOverload<>(&QWidget::update));
+   }
+
+   // When new commits are inserted above the rows the user is looking at, the view keeps showing the same commits.
+   connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, [this](const QModelIndex &, int first) {
+      const auto top = indexAt(QPoint(0, 0));
+      mScrollAnchor = top.isValid() && top.row() > 0 && first <= top.row() ? QPersistentModelIndex(top)
+                                                                              : QPersistentModelIndex();
+   });
+   connect(model, &QAbstractItemModel::rowsInserted, this, [this]() {
+      if (mScrollAnchor.isValid())
+         scrollTo(mScrollAnchor, QAbstractItemView::PositionAtTop);
+
+      mScrollAnchor = QPersistentModelIndex();
+   });
    setupGeometry();
    connect(this->selectionModel(), &QItemSelectionModel::selectionChanged, this,
            [this](const QItemSelection &selected, const QItemSelection &) {
@@ -48,36 +106,90 @@ void CommitHistoryView::setModel(QAbstractItemModel *model)
            });
 }
 
-void CommitHistoryView::filterBySha(const QStringList &shaList)
+void CommitHistoryView::setupAcceleratedViewport()
 {
-   mIsFiltering = true;
+#ifndef QT_NO_OPENGL
+   // The delegate still paints with QPainter, the viewport only gives it the OpenGL paint engine instead of the raster
+   // one. A context that is created but can't be made current on a surface would leave the view blank, so the probe
+   // makes it current on an offscreen surface.
+   QOffscreenSurface surface;
+   surface.create();
 
-   if (mProxyModel)
-   {
-      mProxyModel->beginResetModel();
-      mProxyModel->setAcceptedSha(shaList);
-      mProxyModel->endResetModel();
-   }
-   else
+   QOpenGLContext context;
+
+   if (surface.isValid() && context.create() && context.makeCurrent(&surface))
    {
-      mProxyModel = new ShaFilterProxyModel(this);
-      mProxyModel->setSourceModel(mCommitHistoryModel);
-      mProxyModel->setAcceptedSha(shaList);
-      setModel(mProxyModel);
+      context.doneCurrent();
+
+      setViewport(new QOpenGLWidget());
+
+      QLog_Info("UI", "The history view is painted with OpenGL.");
+      return;
    }
+#endif
+
+   QLog_Warning("UI", "OpenGL is not available. The history view is painted by the CPU.");
+}
+
+void CommitHistoryView::filterBySha(const QStringList &shaList)
+{
+   mIsFiltering = true;
+   mIsFilteringByAuthor = false;
+
+   mCommitHistoryModel->filterBySha(shaList);
 
    setupGeometry();
 }
 
+void CommitHistoryView::filter(const HistoryFilter &filter)
+{
+   mIsFiltering = true;
+   mIsFilteringByAuthor = false;
+
+   mCommitHistoryModel->filter(filter);
+
+   setupGeometry();
+}
+
+void CommitHistoryView::filterByAuthor(int authorId)
+{
+   filter(HistoryFilter::authorId(authorId));
+
+   mIsFilteringByAuthor = true;
+
+   updateDateMarkers();
+}
+
+void CommitHistoryView::clearFilter()
+{
+   mIsFiltering = false;
+   mIsFilteringByAuthor = false;
+
+   mCommitHistoryModel->clearFilter();
+
+   setupGeometry();
+   updateDateMarkers();
+}
+
+int CommitHistoryView::sourceRow(int row) const
+{
+   return mCommitHistoryModel->sourceRow(row);
+}
+
+QVector<Lane> CommitHistoryView::subgraphLanes(int row) const
+{
+   return mCommitHistoryModel->subgraphLanes(row);
+}
+
 CommitHistoryView::~CommitHistoryView()
 {
-   QSettings s;
+   GitQlientSettings s;
    s.setValue(QString("%1").arg(objectName()), header()->saveState());
 }
 
 void CommitHistoryView::setupGeometry()
 {
-   QSettings s;
+   GitQlientSettings s;
    const auto previousState = s.value(QString("%1").arg(objectName()), QByteArray()).toByteArray();
 
    if (previousState.isEmpty())
@@ -120,13 +232,7 @@ void CommitHistoryView::focusOnCommit(const QString &goToSha)
 
    QLog_Info("UI", QString("Setting the focus on the commit {%1}").arg(mCurrentSha));
 
-   auto row = mCache->getCommitPos(mCurrentSha);
-
-   if (mIsFiltering)
-   {
-      const auto sourceIndex = mProxyModel->sourceModel()->index(row, 0);
-      row = mProxyModel->mapFromSource(sourceIndex).row();
-   }
+   const auto row = mCommitHistoryModel->rowFromSource(mCache->getCommitPos(mCurrentSha));
 
    clearSelection();
 
@@ -136,6 +242,110 @@ void CommitHistoryView::focusOnCommit(const QString &goToSha)
    scrollTo(currentIndex());
 }
 
+void CommitHistoryView::paintEvent(QPaintEvent *event)
+{
+   if (!mFrameStatistics)
+   {
+      QTreeView::paintEvent(event);
+      return;
+   }
+
+   mFrameStatistics->startFrame();
+
+   QTreeView::paintEvent(event);
+
+   const auto logStatistics = mFrameStatistics->finishFrame();
+
+   QStringList columnNames;
+
+   for (auto column = 0; column < mCommitHistoryModel->columnCount(); ++column)
+      columnNames.append(mCommitHistoryModel->headerData(column, Qt::Horizontal).toString());
+
+   const auto lines = mFrameStatistics->summary(columnNames);
+
+   if (logStatistics)
+      QLog_Info("UI", QString("Paint statistics of {%1}: %2").arg(objectName(), lines.join(". ")));
+
+   QPainter painter(viewport());
+   QFontMetrics fm(font());
+   auto width = 0;
+
+   for (const auto &line : lines)
+      width = std::max(width, fm.boundingRect(line).width());
+
+   const auto padding = 5;
+   const QRect overlay(viewport()->width() - width - 3 * padding, padding, width + 2 * padding,
+                       lines.count() * fm.height() + 2 * padding);
+
+   painter.fillRect(overlay, QColor(0, 0, 0, 180));
+   painter.setPen(Qt::white);
+   painter.setFont(font());
+   painter.drawText(overlay.adjusted(padding, padding, -padding, -padding), Qt::AlignLeft | Qt::AlignTop,
+                    lines.join('\n'));
+}
+
+void CommitHistoryView::updateOverview()
+{
+   if (mIsFiltering)
+   {
+      mDateScrollBar->setOverview(QImage());
+      return;
+   }
+
+   mOverview->setSnapshot(mCache->snapshot());
+   mOverview->setReferenceRows(mCache->getReferencedRows());
+}
+
+void CommitHistoryView::setHighlightedRows(const QVector<int> &rows)
+{
+   mOverview->setHighlightedRows(rows);
+}
+
+void CommitHistoryView::updateVisibleRows()
+{
+   if (!mCommitHistoryModel)
+      return;
+
+   const auto first = indexAt(QPoint(0, 0)).row();
+   auto last = indexAt(QPoint(0, viewport()->height() - 1)).row();
+
+   if (last == -1)
+      last = mCommitHistoryModel->rowCount() - 1;
+
+   mCommitHistoryModel->setVisibleRows(std::max(first, 0), last);
+}
+
+void CommitHistoryView::updateDateMarkers()
+{
+   // Months are too dense for histories of many years, so the marks go to the beginning of every year instead.
+   static constexpr int MAX_MONTH_MARKERS = 36;
+
+   QVector<QPair<int, QString>> markers;
+   const auto totalRows = mCache->count();
+
+   if (totalRows > 1 && !mIsFiltering)
+   {
+      const auto newest = QDateTime::fromSecsSinceEpoch(mCache->getCommitDateByRow(1)).date();
+      const auto oldest = QDateTime::fromSecsSinceEpoch(mCache->getCommitDateByRow(totalRows - 1)).date();
+      const auto months = (newest.year() - oldest.year()) * 12 + newest.month() - oldest.month();
+      const auto byYear = months > MAX_MONTH_MARKERS;
+      const auto step = byYear ? 12 : 1;
+      const auto first = byYear ? QDate(oldest.year(), 1, 1) : QDate(oldest.year(), oldest.month(), 1);
+
+      // Every period starts in the row of its newest commit, that is the one before the beginning of the next period.
+      for (auto period = byYear ? QDate(newest.year(), 1, 1) : QDate(newest.year(), newest.month(), 1);
+           period >= first; period = period.addMonths(-step))
+      {
+         const auto end = QDateTime(period.addMonths(step), QTime(0, 0)).toSecsSinceEpoch() - 1;
+         markers.append({ mCache->findRowByDate(end), period.toString(byYear ? "yyyy" : "MMM yyyy") });
+      }
+
+      std::reverse(markers.begin(), markers.end());
+   }
+
+   mDateScrollBar->setMarkers(markers, totalRows);
+}
+
 QModelIndexList CommitHistoryView::selectedIndexes() const
 {
    return QTreeView::selectedIndexes();
@@ -151,6 +361,7 @@ void CommitHistoryView::showContextMenu(const QPoint &pos)
       {
          const auto menu = new CommitHistoryContextMenu(mCache, mGit, shas, this);
          connect(menu, &CommitHistoryContextMenu::signalRepositoryUpdated, this, &CommitHistoryView::signalViewUpdated);
+         connect(menu, &CommitHistoryContextMenu::signalCheckedOut, this, &CommitHistoryView::signalCheckedOut);
          connect(menu, &CommitHistoryContextMenu::signalOpenDiff, this, &CommitHistoryView::signalOpenDiff);
          connect(menu, &CommitHistoryContextMenu::signalOpenCompareDiff, this,
                  &CommitHistoryView::signalOpenCompareDiff);
@@ -159,16 +370,24 @@ void CommitHistoryView::showContextMenu(const QPoint &pos)
          connect(menu, &CommitHistoryContextMenu::signalCherryPickConflict, this,
                  &CommitHistoryView::signalCherryPickConflict);
          connect(menu, &CommitHistoryContextMenu::signalPullConflict, this, &CommitHistoryView::signalPullConflict);
+         connect(menu, &CommitHistoryContextMenu::signalFilterByAuthor, this, &CommitHistoryView::filterByAuthor);
          menu->exec(viewport()->mapToGlobal(pos));
       }
       else
          QLog_Warning("UI", "SHAs selected belong to different branches. They need to share at least one branch.");
    }
+   else if (mIsFilteringByAuthor)
+   {
+      const auto menu = new QMenu(this);
+      menu->setAttribute(Qt::WA_DeleteOnClose);
+      connect(menu->addAction(tr("Show all the commits")), &QAction::triggered, this, &CommitHistoryView::clearFilter);
+      menu->exec(viewport()->mapToGlobal(pos));
+   }
 }
 
 void CommitHistoryView::saveHeaderState()
 {
-   QSettings s;
+   GitQlientSettings s;
    s.setValue(QString("%1").arg(objectName()), header()->saveState());
 }
 
@@ -187,9 +406,8 @@ QList<QString> CommitHistoryView::getSelectedShaList() const
 
       shas.insert(dt, sha);
 
-      const auto commit = mCache->getCommitInfo(sha);
-      auto branches = commit.getReferences(References::Type::LocalBranch)
-          + commit.getReferences(References::Type::RemoteBranches);
+      auto branches = mCache->getReferences(sha, References::Type::LocalBranch)
+          + mCache->getReferences(sha, References::Type::RemoteBranches);
 
       std::sort(branches.begin(), branches.end());
       godVector.append(branches.toVector());
@@ -23,12 +23,17 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <Lane.h>
+
 #include <QTreeView>
 
 class RevisionsCache;
 class GitBase;
 class CommitHistoryModel;
-class ShaFilterProxyModel;
+class HistoryFilter;
+class DateScrollBar;
+class FrameStatistics;
+class HistoryOverview;
 
 /**
  * @brief The CommitHistoryView is the class that represents the View in a MVC pattern. It shows the data provided by
@@ -45,6 +50,10 @@ signals:
     * @brief Signal triggered when some action in the context menu things the main UI needs an update.
     */
    void signalViewUpdated();
+   /**
+    * @brief Signal triggered when a commit is checked out from the context menu.
+    */
+   void signalCheckedOut();
    /*!
     \brief Signal triggered when the user wants to open the diff of a commit compared to its parent.
 
@@ -109,11 +118,27 @@ public:
     */
    QList<QString> getSelectedShaList() const;
    /**
-    * @brief If the view has a filter active this method tells the filter which SHAs are going to be shown.
+    * @brief If the view has a filter active this method tells the model which SHAs are going to be shown.
     *
     * @param shaList List of SHA to pass to the filter.
     */
    void filterBySha(const QStringList &shaList);
+   /**
+    * @brief Shows only the commits accepted by the filter.
+    *
+    * @param filter The filter to apply.
+    */
+   void filter(const HistoryFilter &filter);
+   /**
+    * @brief Shows only the commits of an author. The user can go back to the whole history from the context menu.
+    *
+    * @param authorId The id of the author in the IdentityTable.
+    */
+   void filterByAuthor(int authorId);
+   /**
+    * @brief Removes the filter of the view.
+    */
+   void clearFilter();
    /**
     * @brief Activates/deactivates filtering in the view.
     *
@@ -126,6 +151,20 @@ public:
     * @return bool Returns true if the widget is actively filtering. Otherwise, false.
     */
    bool hasActiveFilter() const { return mIsFiltering; }
+   /**
+    * @brief Returns the row in the cache of a row of the view, taking into account the active filter.
+    *
+    * @param row The row of the view.
+    * @return int The row in the cache.
+    */
+   int sourceRow(int row) const;
+   /**
+    * @brief Returns the lanes of a row calculated over the commits the active filter shows.
+    *
+    * @param row The row of the view.
+    * @return QVector<Lane> The lanes, or an empty vector if they are not available.
+    */
+   QVector<Lane> subgraphLanes(int row) const;
 
    /**
     * @brief Clears any selection or data in the view.
@@ -137,6 +176,25 @@ public:
     * @param goToSha The SHA to select.
     */
    void focusOnCommit(const QString &goToSha);
+   /**
+    * @brief Updates the marks of the scroll bar that tell where every month (or year, for long histories) starts. It
+    * is only meaningful when the view shows the whole history.
+    */
+   void updateDateMarkers();
+   /**
+    * @brief Tells the model which rows are visible so it prepares their display data.
+    */
+   void updateVisibleRows();
+   /**
+    * @brief Renders again the overview of the history shown in the scroll bar with the current rows and references.
+    */
+   void updateOverview();
+   /**
+    * @brief Highlights rows in the overview of the scroll bar, e.g. the matches of a search.
+    *
+    * @param rows The rows in the cache, sorted.
+    */
+   void setHighlightedRows(const QVector<int> &rows);
    /**
     * @brief Gets the current selected SHA.
     *
@@ -149,14 +207,33 @@ public:
     * @return QModelIndexList The list of selected indexes.
     */
    QModelIndexList selectedIndexes() const override;
+   /**
+    * @brief Returns the paint statistics of the view. They are only collected when the frameStatistics setting is
+    * enabled.
+    *
+    * @return FrameStatistics The statistics or nullptr if they are disabled.
+    */
+   FrameStatistics *frameStatistics() const { return mFrameStatistics.data(); }
+
+protected:
+   /**
+    * @brief Measures the frame when the paint statistics are enabled and draws them over the view.
+    *
+    * @param event The paint event.
+    */
+   void paintEvent(QPaintEvent *event) override;
 
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
    CommitHistoryModel *mCommitHistoryModel = nullptr;
-   ShaFilterProxyModel *mProxyModel = nullptr;
+   DateScrollBar *mDateScrollBar = nullptr;
+   HistoryOverview *mOverview = nullptr;
    bool mIsFiltering = false;
+   bool mIsFilteringByAuthor = false;
    QString mCurrentSha;
+   QPersistentModelIndex mScrollAnchor;
+   QSharedPointer<FrameStatistics> mFrameStatistics;
 
    /**
     * @brief Shows the context menu for the CommitHistoryView.
@@ -164,6 +241,11 @@ private:
     * @param p The point where the context menu will be shown.
     */
    void showContextMenu(const QPoint &p);
+   /**
+    * @brief Sets an OpenGL viewport, so the QPainter of the delegate uses the OpenGL paint engine. If no OpenGL
+    * context can be made current on an offscreen surface, the view keeps the raster viewport.
+    */
+   void setupAcceleratedViewport();
    /**
     * @brief Saves the state of the header (width of the columns, which columns, etc) when the widget is going to be
     * destroyed.
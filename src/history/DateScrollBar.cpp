@@ -0,0 +1,97 @@
+#include "DateScrollBar.h"
+
+#include <GitQlientStyles.h>
+
+#include <QPainter>
+#include <QStyleOptionSlider>
+#include <QHelpEvent>
+#include <QToolTip>
+
+DateScrollBar::DateScrollBar(QWidget *parent)
+   : QScrollBar(Qt::Vertical, parent)
+{
+}
+
+void DateScrollBar::setMarkers(const QVector<QPair<int, QString>> &markers, int totalRows)
+{
+   mMarkers = markers;
+   mTotalRows = totalRows;
+
+   update();
+}
+
+void DateScrollBar::setOverview(const QImage &image)
+{
+   mOverview = image;
+
+   update();
+}
+
+void DateScrollBar::paintEvent(QPaintEvent *event)
+{
+   QScrollBar::paintEvent(event);
+
+   const auto groove = grooveRect();
+
+   QPainter p(this);
+
+   if (!mOverview.isNull())
+   {
+      const auto markersWidth = groove.width() / 3;
+      p.drawImage(QRect(groove.left() + markersWidth, groove.top(), groove.width() - markersWidth, groove.height()),
+                  mOverview);
+   }
+
+   if (mMarkers.isEmpty() || mTotalRows <= 0)
+      return;
+
+   p.setPen(GitQlientStyles::getTextColor());
+
+   for (const auto &marker : qAsConst(mMarkers))
+   {
+      const auto y = markerY(marker.first, groove);
+      p.drawLine(groove.left(), y, groove.left() + groove.width() / 3, y);
+   }
+}
+
+bool DateScrollBar::event(QEvent *event)
+{
+   if (event->type() == QEvent::ToolTip && !mMarkers.isEmpty() && mTotalRows > 0)
+   {
+      const auto helpEvent = static_cast<QHelpEvent *>(event);
+      const auto groove = grooveRect();
+
+      // The label shown is the one of the period the mouse is over: the last mark above it.
+      QString label;
+
+      for (const auto &marker : qAsConst(mMarkers))
+      {
+         if (markerY(marker.first, groove) > helpEvent->pos().y())
+            break;
+
+         label = marker.second;
+      }
+
+      if (!label.isEmpty())
+         QToolTip::showText(helpEvent->globalPos(), label, this);
+      else
+         QToolTip::hideText();
+
+      return true;
+   }
+
+   return QScrollBar::event(event);
+}
+
+QRect DateScrollBar::grooveRect() const
+{
+   QStyleOptionSlider opt;
+   initStyleOption(&opt);
+
+   return style()->subControlRect(QStyle::CC_ScrollBar, &opt, QStyle::SC_ScrollBarGroove, this);
+}
+
+int DateScrollBar::markerY(int row, const QRect &groove) const
+{
+   return groove.top() + static_cast<int>(static_cast<double>(row) / mTotalRows * groove.height());
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QScrollBar>
+#include <QImage>
+#include <QVector>
+#include <QPair>
+
+/*!
+ \brief The DateScrollBar is a vertical scroll bar that draws a mark where every period of time (e.g. month or year)
+ starts in the history. The label of the period under the mouse is shown as tool tip.
+
+ \class DateScrollBar DateScrollBar.h "DateScrollBar.h"
+*/
+class DateScrollBar : public QScrollBar
+{
+   Q_OBJECT
+
+public:
+   explicit DateScrollBar(QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the marks to draw.
+
+    \param markers The pairs of row where a period starts and its label.
+    \param totalRows The total of rows of the view.
+   */
+   void setMarkers(const QVector<QPair<int, QString>> &markers, int totalRows);
+   /*!
+    \brief Sets the overview of the history drawn in the groove, next to the marks. It's scaled to the groove.
+
+    \param image The overview image. A null image removes the overview.
+   */
+   void setOverview(const QImage &image);
+
+protected:
+   void paintEvent(QPaintEvent *event) override;
+   bool event(QEvent *event) override;
+
+private:
+   QVector<QPair<int, QString>> mMarkers;
+   QImage mOverview;
+   int mTotalRows = 0;
+
+   QRect grooveRect() const;
+   int markerY(int row, const QRect &groove) const;
+};
@@ -0,0 +1,112 @@
+#include "FrameStatistics.h"
+
+#include <algorithm>
+
+FrameStatistics::FrameStatistics(int columns, int frames)
+   : mColumns(columns)
+   , mMaxFrames(frames)
+{
+   mFrames.reserve(mMaxFrames);
+   mCurrent.columnsNsecs.fill(0, mColumns);
+}
+
+void FrameStatistics::startFrame()
+{
+   mCurrent.nsecs = 0;
+   mCurrent.columnsNsecs.fill(0, mColumns);
+   mFrameTimer.start();
+}
+
+bool FrameStatistics::finishFrame()
+{
+   mCurrent.nsecs = mFrameTimer.nsecsElapsed();
+
+   if (mFrames.count() < mMaxFrames)
+      mFrames.append(mCurrent);
+   else
+      mFrames[mNextFrame] = mCurrent;
+
+   mNextFrame = (mNextFrame + 1) % mMaxFrames;
+
+   // The data calls done out of a frame (e.g. the tool tips) are counted in the next one.
+   mCurrent.dataCalls = 0;
+
+   if (++mNewFrames < mMaxFrames)
+      return false;
+
+   mNewFrames = 0;
+
+   return true;
+}
+
+void FrameStatistics::addCellPaint(int column, qint64 nsecs)
+{
+   if (column >= 0 && column < mColumns)
+      mCurrent.columnsNsecs[column] += nsecs;
+}
+
+QStringList FrameStatistics::summary(const QStringList &columnNames) const
+{
+   QStringList lines;
+
+   if (mFrames.isEmpty())
+      return lines;
+
+   QVector<qint64> values;
+   values.reserve(mFrames.count());
+
+   for (const auto &frame : mFrames)
+      values.append(frame.nsecs);
+
+   lines.append(QString("Frame (ms): %1").arg(percentiles(values, true)));
+
+   for (auto column = 0; column < mColumns; ++column)
+   {
+      values.clear();
+
+      for (const auto &frame : mFrames)
+         values.append(frame.columnsNsecs.at(column));
+
+      if (std::all_of(values.cbegin(), values.cend(), [](qint64 v) { return v == 0; }))
+         continue;
+
+      lines.append(QString("%1 (ms): %2").arg(columnNames.value(column), percentiles(values, true)));
+   }
+
+   values.clear();
+
+   for (const auto &frame : mFrames)
+      values.append(frame.dataCalls);
+
+   lines.append(QString("data() calls: %1").arg(percentiles(values, false)));
+
+   return lines;
+}
+
+QString FrameStatistics::frameTimes() const
+{
+   if (mFrames.isEmpty())
+      return QString();
+
+   QVector<qint64> values;
+   values.reserve(mFrames.count());
+
+   for (const auto &frame : mFrames)
+      values.append(frame.nsecs);
+
+   return percentiles(values, true);
+}
+
+QString FrameStatistics::percentiles(QVector<qint64> &values, bool toMsecs)
+{
+   std::sort(values.begin(), values.end());
+
+   const auto at = [&values, toMsecs](double percentile) {
+      const auto index = std::min(values.count() - 1, static_cast<int>(percentile * values.count()));
+      const auto value = values.at(index);
+
+      return toMsecs ? QString::number(value / 1e6, 'f', 2) : QString::number(value);
+   };
+
+   return QString("p50 %1, p95 %2, p99 %3").arg(at(0.50), at(0.95), at(0.99));
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief The FrameStatistics class measures how long the history view takes to paint. It keeps the last frames in a
+ * ring buffer: the total time of the frame, the time spent painting the cells of every column and the number of calls
+ * to the data() method of the model. The summary gives the percentiles 50, 95 and 99 of those values.
+ *
+ * @class FrameStatistics FrameStatistics.h "FrameStatistics.h"
+ */
+class FrameStatistics
+{
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param columns The number of columns of the view.
+    * @param frames The number of frames the percentiles are calculated with.
+    */
+   explicit FrameStatistics(int columns, int frames = 240);
+
+   /**
+    * @brief Starts measuring a frame.
+    */
+   void startFrame();
+   /**
+    * @brief Finishes the frame and stores its values.
+    *
+    * @return bool True every time the ring buffer has been filled with new frames, so the caller can log them.
+    */
+   bool finishFrame();
+   /**
+    * @brief Adds the time spent painting a cell to the current frame.
+    *
+    * @param column The column of the cell.
+    * @param nsecs The time in nanoseconds.
+    */
+   void addCellPaint(int column, qint64 nsecs);
+   /**
+    * @brief Counts a call to the data() method of the model in the current frame.
+    */
+   void addDataCall() { ++mCurrent.dataCalls; }
+   /**
+    * @brief Builds the summary of the stored frames: one text line for the frame time, one for every column and one
+    * for the data() calls.
+    *
+    * @param columnNames The names of the columns.
+    * @return QStringList The lines of the summary.
+    */
+   QStringList summary(const QStringList &columnNames) const;
+   /**
+    * @brief Returns the percentiles of the time of the stored frames, or an empty string if there are none.
+    *
+    * @return QString The formatted percentiles, in milliseconds.
+    */
+   QString frameTimes() const;
+
+private:
+   struct Frame
+   {
+      qint64 nsecs = 0;
+      QVector<qint64> columnsNsecs;
+      qint64 dataCalls = 0;
+   };
+
+   QVector<Frame> mFrames;
+   Frame mCurrent;
+   QElapsedTimer mFrameTimer;
+   int mColumns = 0;
+   int mMaxFrames = 0;
+   int mNextFrame = 0;
+   int mNewFrames = 0;
+
+   /**
+    * @brief Formats the percentiles of a list of values.
+    *
+    * @param values The values. They are sorted by the method.
+    * @param toMsecs True if the values are nanoseconds that are shown as milliseconds.
+    * @return QString The formatted percentiles.
+    */
+   static QString percentiles(QVector<qint64> &values, bool toMsecs);
+};
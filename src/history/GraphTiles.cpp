@@ -0,0 +1,140 @@
+#include "GraphTiles.h"
+
+#include <CommitView.h>
+#include <Lane.h>
+#include <ResourceBudget.h>
+#include <RevisionsCache.h>
+#include <WorkerPool.h>
+
+#include <QPainter>
+
+#include <algorithm>
+
+namespace
+{
+// During a fast scroll most of the tiles requested are not visible anymore when they are rendered.
+const int MAX_PENDING_TILES = 4;
+}
+
+GraphTiles::GraphTiles(const QSharedPointer<RevisionsCache> &cache, QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+   , mWorker(new WorkerQueue(mCache.data(), WorkerPool::Priority::Interactive, true))
+   , mTiles(BUDGET_KB)
+{
+   // The cost is measured in KB. The tiles are only used in the GUI thread.
+   mBudgetId = ResourceBudget::instance().addCache(
+       QString("Graph tiles"), BUDGET_KB * qint64(1024), [this]() { return mTiles.totalCost() * qint64(1024); },
+       [this](qint64 bytes) {
+          QMetaObject::invokeMethod(
+              this, [this, bytes]() { mTiles.setMaxCost(static_cast<int>(std::max(bytes / 1024, qint64(1)))); },
+              Qt::QueuedConnection);
+       });
+}
+
+GraphTiles::~GraphTiles()
+{
+   ResourceBudget::instance().removeCache(mBudgetId);
+
+   mWorker.reset();
+}
+
+bool GraphTiles::paintRow(QPainter *p, const QRect &rect, int row, const RepositoryViewDelegate::GraphPalette &palette)
+{
+   const auto dpr = p->device()->devicePixelRatioF();
+
+   if (palette != mPalette || !qFuzzyCompare(dpr, mDpr) || mCache->generation() != mGeneration)
+   {
+      clear();
+
+      mPalette = palette;
+      mDpr = dpr;
+      mGeneration = mCache->generation();
+   }
+
+   const auto tileIndex = row / TILE_ROWS;
+   const auto firstRow = tileIndex * TILE_ROWS;
+   const auto tile = mTiles.object(tileIndex);
+
+   // The last tile is rendered again when more rows are loaded.
+   const auto totalRows = std::min(TILE_ROWS, mCache->count() - firstRow);
+
+   if ((!tile || tile->rows < totalRows) && !mPendingTiles.contains(tileIndex)
+       && mPendingTiles.count() < MAX_PENDING_TILES)
+   {
+      requestTile(tileIndex);
+   }
+
+   if (!tile || row - firstRow >= tile->rows)
+      return false;
+
+   const auto width = std::min(static_cast<qreal>(rect.width()), tile->image.width() / mDpr);
+   const QRectF source(0, (row - firstRow) * ROW_HEIGHT * mDpr, width * mDpr, ROW_HEIGHT * mDpr);
+
+   p->drawImage(QRectF(rect.x(), rect.y(), width, ROW_HEIGHT), tile->image, source);
+
+   return true;
+}
+
+void GraphTiles::clear()
+{
+   ++mEpoch;
+
+   mTiles.clear();
+   mPendingTiles.clear();
+}
+
+void GraphTiles::requestTile(int tile)
+{
+   const auto firstRow = tile * TILE_ROWS;
+   const auto lastRow = std::min(firstRow + TILE_ROWS, mCache->count());
+   QVector<QVector<Lane>> rows;
+   auto wipRow = -1;
+
+   rows.reserve(lastRow - firstRow);
+
+   // The lanes are calculated in the GUI thread. The rows repeated share their data, so copying them is cheap.
+   for (auto row = firstRow; row < lastRow; ++row)
+   {
+      const auto commit = mCache->getCommitViewByRow(row);
+
+      if (!commit.isValid())
+         break;
+
+      if (commit.isWip())
+         wipRow = row - firstRow;
+
+      rows.append(commit.lanes());
+   }
+
+   if (rows.isEmpty())
+      return;
+
+   mPendingTiles.insert(tile);
+
+   const auto epoch = mEpoch;
+   const auto palette = mPalette;
+   const auto dpr = mDpr;
+
+   mWorker->post([this, epoch, tile, rows, wipRow, palette, dpr]() {
+      const auto image = RepositoryViewDelegate::renderGraphTile(rows, wipRow, palette, dpr);
+      const auto count = rows.count();
+
+      QMetaObject::invokeMethod(
+          this, [this, epoch, tile, count, image]() { onTileRendered(epoch, tile, count, image); },
+          Qt::QueuedConnection);
+   });
+}
+
+void GraphTiles::onTileRendered(int epoch, int tile, int rows, const QImage &image)
+{
+   if (epoch != mEpoch)
+      return;
+
+   mPendingTiles.remove(tile);
+
+   // The cost is measured in KB like the budget.
+   mTiles.insert(tile, new Tile { image, rows }, static_cast<int>(image.sizeInBytes() / 1024) + 1);
+
+   emit signalTileReady();
+}
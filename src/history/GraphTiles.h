@@ -0,0 +1,120 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RepositoryViewDelegate.h>
+
+#include <QCache>
+#include <QObject>
+#include <QScopedPointer>
+#include <QSet>
+#include <QSharedPointer>
+
+class RevisionsCache;
+class WorkerQueue;
+
+/**
+ * @brief The GraphTiles class renders the graph column of the history in tiles of TILE_ROWS rows. The tiles are
+ * rendered offscreen in the workers from the lanes of the rows and kept in a cache with a memory budget, the least
+ * recently used first out. Painting the graph of a row is then a blit of its part of the tile.
+ *
+ * A tile that is not rendered yet is requested and the row is painted as usual meanwhile. The tiles are discarded when
+ * the lanes change: a new generation of the history, a new origin of the lanes or other colors.
+ *
+ * @class GraphTiles GraphTiles.h "GraphTiles.h"
+ */
+class GraphTiles : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when a tile is rendered, so the rows it covers are painted again.
+    */
+   void signalTileReady();
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param cache The cache of the repository.
+    * @param parent The parent object.
+    */
+   explicit GraphTiles(const QSharedPointer<RevisionsCache> &cache, QObject *parent = nullptr);
+   /**
+    * @brief Destructor. It waits for the tile being rendered, if any.
+    */
+   ~GraphTiles() override;
+
+   /**
+    * @brief Paints the graph of a row from its tile.
+    *
+    * @param p The painter device.
+    * @param rect The rectangle of the cell.
+    * @param row The row in the cache.
+    * @param palette The colors of the graph.
+    * @return True if the tile was rendered, otherwise false and the tile is requested.
+    */
+   bool paintRow(QPainter *p, const QRect &rect, int row, const RepositoryViewDelegate::GraphPalette &palette);
+   /**
+    * @brief Discards all the tiles, also the ones being rendered.
+    */
+   void clear();
+
+   static constexpr int TILE_ROWS = 256;
+   static constexpr int BUDGET_KB = 48 * 1024;
+
+private:
+   struct Tile
+   {
+      QImage image;
+      int rows = 0;
+   };
+
+   QSharedPointer<RevisionsCache> mCache;
+   QScopedPointer<WorkerQueue> mWorker;
+   QCache<int, Tile> mTiles;
+   QSet<int> mPendingTiles;
+   RepositoryViewDelegate::GraphPalette mPalette;
+   qreal mDpr = 1.0;
+   int mGeneration = -1;
+   int mEpoch = 0;
+   int mBudgetId = 0;
+
+   /**
+    * @brief Takes the lanes of the rows of a tile and renders it in a worker.
+    *
+    * @param tile The index of the tile.
+    */
+   void requestTile(int tile);
+   /**
+    * @brief Stores a rendered tile unless the tiles were discarded after it was requested.
+    *
+    * @param epoch The value of the epoch when the tile was requested.
+    * @param tile The index of the tile.
+    * @param rows The rows of the tile.
+    * @param image The image of the tile.
+    */
+   void onTileRendered(int epoch, int tile, int rows, const QImage &image);
+};
@@ -5,12 +5,18 @@ HEADERS += \
     $$PWD/CommitHistoryContextMenu.h \
     $$PWD/CommitHistoryModel.h \
     $$PWD/CommitHistoryView.h \
-    $$PWD/RepositoryViewDelegate.h \
-    $$PWD/ShaFilterProxyModel.h
+    $$PWD/DateScrollBar.h \
+    $$PWD/FrameStatistics.h \
+    $$PWD/GraphTiles.h \
+    $$PWD/HistoryOverview.h \
+    $$PWD/RepositoryViewDelegate.h
 
 SOURCES += \
     $$PWD/CommitHistoryContextMenu.cpp \
     $$PWD/CommitHistoryModel.cpp \
     $$PWD/CommitHistoryView.cpp \
-    $$PWD/RepositoryViewDelegate.cpp \
-    $$PWD/ShaFilterProxyModel.cpp
+    $$PWD/DateScrollBar.cpp \
+    $$PWD/FrameStatistics.cpp \
+    $$PWD/GraphTiles.cpp \
+    $$PWD/HistoryOverview.cpp \
+    $$PWD/RepositoryViewDelegate.cpp
@@ -0,0 +1,190 @@
+#include "HistoryOverview.h"
+
+#include <CommitInfo.h>
+#include <GitQlientStyles.h>
+
+#include <QPainter>
+#include <QRunnable>
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+class RenderTask : public QRunnable
+{
+public:
+   explicit RenderTask(std::function<void()> task)
+      : mTask(std::move(task))
+   {
+   }
+
+   void run() override { mTask(); }
+
+private:
+   std::function<void()> mTask;
+};
+}
+
+HistoryOverview::HistoryOverview(QObject *parent)
+   : QObject(parent)
+{
+   mPool.setMaxThreadCount(1);
+}
+
+HistoryOverview::~HistoryOverview()
+{
+   mPool.waitForDone();
+}
+
+void HistoryOverview::setSnapshot(const RevisionsSnapshot &snapshot)
+{
+   // The rows of another generation moved, so they are counted again.
+   if (snapshot.generation() != mGeneration || snapshot.count() < mCountedRows)
+   {
+      mGeneration = snapshot.generation();
+      mCountedRows = 0;
+      mMergeBuckets.clear();
+   }
+
+   mSnapshot = snapshot;
+
+   scheduleRender();
+}
+
+void HistoryOverview::setReferenceRows(const QVector<int> &rows)
+{
+   mReferenceRows = rows;
+
+   scheduleRender();
+}
+
+void HistoryOverview::setHighlightedRows(const QVector<int> &rows)
+{
+   mHighlightedRows = rows;
+
+   scheduleRender();
+}
+
+void HistoryOverview::setHeight(int height)
+{
+   if (height == mHeight)
+      return;
+
+   mHeight = height;
+
+   scheduleRender();
+}
+
+void HistoryOverview::scheduleRender()
+{
+   if (mRunning)
+   {
+      mPending = true;
+      return;
+   }
+
+   if (mHeight <= 0 || mSnapshot.count() == 0)
+      return;
+
+   mRunning = true;
+   mPending = false;
+
+   const auto snapshot = mSnapshot;
+   const auto generation = mGeneration;
+   const auto countedRows = mCountedRows;
+   const auto buckets = mMergeBuckets;
+   const auto referenceRows = mReferenceRows;
+   const auto highlightedRows = mHighlightedRows;
+   const auto height = mHeight;
+   const Colors colors { GitQlientStyles::getTextColor(), GitQlientStyles::getTagColor(),
+                         GitQlientStyles::getOrange() };
+
+   mPool.start(new RenderTask(
+       [this, snapshot, generation, countedRows, buckets, referenceRows, highlightedRows, height, colors]() mutable {
+          const auto total = snapshot.count();
+
+          // The last bucket might be incomplete, so it's counted again from its first row.
+          const auto firstBucket = countedRows / BUCKET_SIZE;
+          buckets.resize((total + BUCKET_SIZE - 1) / BUCKET_SIZE);
+          std::fill(buckets.begin() + firstBucket, buckets.end(), 0);
+
+          for (auto row = firstBucket * BUCKET_SIZE; row < total; ++row)
+          {
+             if (const auto commit = snapshot.commit(row); commit && commit->parentsCount() > 1)
+                ++buckets[row / BUCKET_SIZE];
+          }
+
+          const auto image = render(buckets, referenceRows, highlightedRows, total, height, colors);
+
+          QMetaObject::invokeMethod(
+              this, [this, generation, total, buckets, image]() { onRendered(generation, total, buckets, image); },
+              Qt::QueuedConnection);
+       }));
+}
+
+void HistoryOverview::onRendered(int generation, int countedRows, const QVector<int> &buckets, const QImage &image)
+{
+   mRunning = false;
+
+   if (generation == mGeneration && countedRows > mCountedRows)
+   {
+      mCountedRows = countedRows;
+      mMergeBuckets = buckets;
+   }
+
+   if (mPending)
+      scheduleRender();
+
+   emit signalImageReady(image);
+}
+
+QImage HistoryOverview::render(const QVector<int> &buckets, const QVector<int> &referenceRows,
+                               const QVector<int> &highlightedRows, int totalRows, int height, const Colors &colors)
+{
+   QImage image(IMAGE_WIDTH, height, QImage::Format_ARGB32_Premultiplied);
+   image.fill(Qt::transparent);
+
+   if (totalRows <= 0)
+      return image;
+
+   // Every row of pixels covers the same amount of rows of the history, so the buckets are summed per pixel.
+   QVector<int> merges(height, 0);
+
+   for (auto bucket = 0; bucket < buckets.count(); ++bucket)
+      merges[std::min(height - 1, static_cast<int>(static_cast<qint64>(bucket) * BUCKET_SIZE * height / totalRows))]
+          += buckets.at(bucket);
+
+   const auto maxMerges = *std::max_element(merges.cbegin(), merges.cend());
+
+   QPainter painter(&image);
+   auto mergeColor = colors.merges;
+
+   for (auto y = 0; maxMerges > 0 && y < height; ++y)
+   {
+      if (merges.at(y) == 0)
+         continue;
+
+      mergeColor.setAlphaF(0.2 + 0.8 * merges.at(y) / maxMerges);
+      painter.fillRect(0, y, 2, 1, mergeColor);
+   }
+
+   const auto paintRows = [&painter, totalRows, height](const QVector<int> &rows, int x, const QColor &color) {
+      auto lastY = -1;
+
+      for (const auto row : rows)
+      {
+         const auto y = std::min(height - 1, static_cast<int>(static_cast<qint64>(row) * height / totalRows));
+
+         if (y != lastY)
+            painter.fillRect(x, y, 2, 1, color);
+
+         lastY = y;
+      }
+   };
+
+   paintRows(referenceRows, 2, colors.references);
+   paintRows(highlightedRows, 4, colors.highlights);
+
+   return image;
+}
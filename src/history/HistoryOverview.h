@@ -0,0 +1,144 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RevisionsSnapshot.h>
+
+#include <QObject>
+#include <QImage>
+#include <QThreadPool>
+#include <QVector>
+
+/**
+ * @brief The HistoryOverview class renders the overview of the whole history that is shown in the scroll bar of the
+ * CommitHistoryView: how dense the merges are, where the references are and where the matches of a search are.
+ *
+ * The merges are counted per bucket of rows from a snapshot of the history and the image is rendered from the buckets
+ * and the rows of the references and the matches. Both things run in a worker thread. When the history grows in the
+ * same generation only the new rows are counted, so the GUI thread never touches the data of every row.
+ *
+ * @class HistoryOverview HistoryOverview.h "HistoryOverview.h"
+ */
+class HistoryOverview : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when a new overview image is available.
+    *
+    * @param image The image. Its height is the height set with @ref setHeight and every row of pixels covers the same
+    * amount of rows of the history.
+    */
+   void signalImageReady(const QImage &image);
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param parent The parent object.
+    */
+   explicit HistoryOverview(QObject *parent = nullptr);
+   /**
+    * @brief Destructor. It waits for the worker to finish.
+    */
+   ~HistoryOverview() override;
+
+   /**
+    * @brief Sets the history to render. The merges of the rows that weren't counted yet are counted.
+    *
+    * @param snapshot The snapshot of the history.
+    */
+   void setSnapshot(const RevisionsSnapshot &snapshot);
+   /**
+    * @brief Sets the rows of the commits that have references.
+    *
+    * @param rows The rows in the cache, sorted.
+    */
+   void setReferenceRows(const QVector<int> &rows);
+   /**
+    * @brief Sets the rows that are highlighted, e.g. the matches of a search.
+    *
+    * @param rows The rows in the cache, sorted.
+    */
+   void setHighlightedRows(const QVector<int> &rows);
+   /**
+    * @brief Sets the height of the image in pixels.
+    *
+    * @param height The height.
+    */
+   void setHeight(int height);
+
+private:
+   static constexpr int BUCKET_SIZE = 256;
+   static constexpr int IMAGE_WIDTH = 6;
+
+   /**
+    * @brief The colors of the image. They are read in the GUI thread since the styles read the settings.
+    */
+   struct Colors
+   {
+      QColor merges;
+      QColor references;
+      QColor highlights;
+   };
+
+   QThreadPool mPool;
+   RevisionsSnapshot mSnapshot;
+   QVector<int> mMergeBuckets;
+   QVector<int> mReferenceRows;
+   QVector<int> mHighlightedRows;
+   int mGeneration = -1;
+   int mCountedRows = 0;
+   int mHeight = 0;
+   bool mRunning = false;
+   bool mPending = false;
+
+   /**
+    * @brief Starts the worker if it's idle. Otherwise, it runs again when the current task finishes.
+    */
+   void scheduleRender();
+   /**
+    * @brief Stores the buckets counted by the worker and notifies the image.
+    *
+    * @param generation The generation of the snapshot the worker used.
+    * @param countedRows The rows counted in the buckets.
+    * @param buckets The merges per bucket of rows.
+    * @param image The rendered image.
+    */
+   void onRendered(int generation, int countedRows, const QVector<int> &buckets, const QImage &image);
+   /**
+    * @brief Renders the image. It runs in the worker.
+    *
+    * @param buckets The merges per bucket of rows.
+    * @param referenceRows The rows with references.
+    * @param highlightedRows The highlighted rows.
+    * @param totalRows The rows of the history.
+    * @param height The height of the image.
+    * @param colors The colors of the image.
+    * @return The image.
+    */
+   static QImage render(const QVector<int> &buckets, const QVector<int> &referenceRows,
+                        const QVector<int> &highlightedRows, int totalRows, int height, const Colors &colors);
+};
@@ -4,28 +4,126 @@
 #include <GitLocal.h>
 #include <Lane.h>
 #include <LaneType.h>
-#include <CommitInfo.h>
+#include <CommitView.h>
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryView.h>
 #include <CommitHistoryModel.h>
+#include <FrameStatistics.h>
+#include <GraphTiles.h>
 #include <RevisionsCache.h>
 #include <GitBase.h>
+#include <GitQlientSettings.h>
 
-#include <QSortFilterProxyModel>
+#include <QElapsedTimer>
+#include <QEvent>
 #include <QPainter>
+#include <QtMath>
+
+#include <algorithm>
 
 static const int MIN_VIEW_WIDTH_PX = 480;
+static const int MAX_LANE_GLYPHS = 2048;
+static const int MAX_CACHED_CELLS = 2048;
+static const int MAX_BADGE_STRIPS = 512;
+static const int BADGE_SPACING = 5;
+static const int BADGE_TEXT_PADDING = 3;
+
+namespace
+{
+/**
+ * @brief Adds the time spent painting a cell to the statistics of the view when it goes out of scope.
+ */
+class CellPaintTimer
+{
+public:
+   CellPaintTimer(FrameStatistics *statistics, int column)
+      : mStatistics(statistics)
+      , mColumn(column)
+   {
+      if (mStatistics)
+         mTimer.start();
+   }
+
+   ~CellPaintTimer()
+   {
+      if (mStatistics)
+         mStatistics->addCellPaint(mColumn, mTimer.nsecsElapsed());
+   }
+
+private:
+   FrameStatistics *mStatistics = nullptr;
+   int mColumn = 0;
+   QElapsedTimer mTimer;
+};
+}
 
 RepositoryViewDelegate::RepositoryViewDelegate(const QSharedPointer<RevisionsCache> &cache,
                                                const QSharedPointer<GitBase> &git, CommitHistoryView *view)
    : mCache(cache)
    , mGit(git)
    , mView(view)
+   , mRowCache(MAX_CACHED_CELLS)
+   , mBadgeStrips(MAX_BADGE_STRIPS)
 {
+   GitQlientSettings settings;
+   mMaxLanes = settings.repositoryValue(mGit->getWorkingDir(), "graphMaxLanes", 0).toInt();
+
+   // The graph is blitted from tiles rendered in the workers instead of being painted row by row with the glyphs.
+   if (settings.value("graphTiles", false).toBool())
+   {
+      mGraphTiles = new GraphTiles(mCache, this);
+      connect(mGraphTiles, &GraphTiles::signalTileReady, mView->viewport(), qOverload<>(&QWidget::update));
+   }
+
+   mView->installEventFilter(this);
+
+   if (const auto model = mView->model())
+   {
+      connect(model, &QAbstractItemModel::modelReset, this, &RepositoryViewDelegate::clearRowCache);
+      connect(model, &QAbstractItemModel::dataChanged, this, &RepositoryViewDelegate::clearRowCache);
+
+      if (mGraphTiles)
+      {
+         connect(model, &QAbstractItemModel::modelReset, mGraphTiles, &GraphTiles::clear);
+
+         // The lanes of all the rows change together, e.g. when HEAD moves.
+         connect(model, &QAbstractItemModel::dataChanged, mGraphTiles,
+                 [this, model](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                    if (topLeft.row() == 0 && bottomRight.row() == model->rowCount() - 1)
+                       mGraphTiles->clear();
+                 });
+      }
+   }
+}
+
+bool RepositoryViewDelegate::eventFilter(QObject *watched, QEvent *event)
+{
+   if (watched != mView)
+      return QStyledItemDelegate::eventFilter(watched, event);
+
+   switch (event->type())
+   {
+      case QEvent::StyleChange:
+      case QEvent::PaletteChange:
+      case QEvent::ScreenChangeInternal:
+         clearLaneGlyphs();
+         clearRowCache();
+         break;
+      case QEvent::FontChange:
+      case QEvent::Resize:
+         clearRowCache();
+         break;
+      default:
+         break;
+   }
+
+   return false;
 }
 
 void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index) const
 {
+   CellPaintTimer timer(mView->frameStatistics(), index.column());
+
    p->setRenderHints(QPainter::Antialiasing);
 
    QStyleOptionViewItem newOpt(opt);
@@ -36,38 +134,83 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
    else if (newOpt.state & QStyle::State_MouseOver)
       p->fillRect(newOpt.rect, GitQlientStyles::getGraphHoverColor());
 
-   const auto row = mView->hasActiveFilter()
-       ? dynamic_cast<QSortFilterProxyModel *>(mView->model())->mapToSource(index).row()
-       : index.row();
+   const auto row = mView->sourceRow(index.row());
+   const auto commit = mCache->getCommitViewByRow(row);
 
-   const auto commit = mCache->getCommitInfoByRow(row);
-
-   if (commit.sha().isEmpty())
+   if (!commit.isValid())
       return;
 
    if (index.column() == static_cast<int>(CommitHistoryColumns::GRAPH))
-      paintGraph(p, newOpt, commit);
-   else if (index.column() == static_cast<int>(CommitHistoryColumns::LOG))
-      paintLog(p, newOpt, commit, index.data().toString());
+   {
+      // The lanes of the whole history are meaningless when most of its rows are hidden.
+      if (mView->hasActiveFilter())
+         paintGraph(p, newOpt, mView->subgraphLanes(index.row()), commit.isWip());
+      else if (!mGraphTiles || !mGraphTiles->paintRow(p, newOpt.rect, row, graphPalette()))
+         paintGraph(p, newOpt, commit.lanes(), commit.isWip());
+
+      return;
+   }
+
+   if (index.column() == static_cast<int>(CommitHistoryColumns::SHA))
+   {
+      newOpt.font.setPointSize(10);
+      newOpt.font.setFamily("Ubuntu Mono");
+   }
+
+   const auto renderData = getCellRenderData(newOpt, index, row, commit);
+
+   if (index.column() == static_cast<int>(CommitHistoryColumns::LOG))
+      paintLog(p, newOpt, *renderData);
    else
    {
       p->setPen(GitQlientStyles::getTextColor());
-      newOpt.rect.setX(newOpt.rect.x() + 10);
+      newOpt.rect.setX(newOpt.rect.x() + renderData->textOffset);
+      p->setFont(newOpt.font);
+      p->drawText(newOpt.rect, renderData->text, QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
+   }
+}
 
-      auto text = index.data().toString();
+const RepositoryViewDelegate::CellRenderData *
+RepositoryViewDelegate::getCellRenderData(const QStyleOptionViewItem &opt, const QModelIndex &index, int row,
+                                          const CommitView &commit) const
+{
+   const auto width = opt.rect.width();
+   const auto key = (static_cast<quint64>(static_cast<quint32>(row)) << 32)
+       | (static_cast<quint64>(index.column() & 0xFF) << 24) | static_cast<quint64>(width & 0xFFFFFF);
 
-      if (index.column() == static_cast<int>(CommitHistoryColumns::SHA))
+   if (const auto cached = mRowCache.object(key))
+      return cached;
+
+   const auto data = new CellRenderData();
+   auto text = index.data().toString();
+
+   if (index.column() == static_cast<int>(CommitHistoryColumns::LOG))
+   {
+      auto offset = 0;
+
+      if (commit.hasReferences() && !mView->hasActiveFilter())
       {
-         newOpt.font.setPointSize(10);
-         newOpt.font.setFamily("Ubuntu Mono");
-         text = text.left(8);
+         const auto strip = getBadgeStrip(opt, commit);
+         data->badges = strip->pixmap;
+         offset = strip->width;
       }
 
-      QFontMetrics fm(newOpt.font);
-      p->setFont(newOpt.font);
-      p->drawText(newOpt.rect, fm.elidedText(text, Qt::ElideRight, newOpt.rect.width()),
-                  QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
+      data->textOffset = offset + 5;
+   }
+   else
+   {
+      data->textOffset = 10;
+
+      if (index.column() == static_cast<int>(CommitHistoryColumns::SHA))
+         text = text.left(8);
    }
+
+   QFontMetrics fm(opt.font);
+   data->text = fm.elidedText(text, Qt::ElideRight, width - data->textOffset);
+
+   mRowCache.insert(key, data);
+
+   return data;
 }
 
 QSize RepositoryViewDelegate::sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const
@@ -77,7 +220,45 @@ QSize RepositoryViewDelegate::sizeHint(const QStyleOptionViewItem &, const QMode
 
 void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2,
                                             const QColor &col, const QColor &activeCol, const QColor &mergeColor,
-                                            bool isWip) const
+                                            bool isWip, const QColor &background) const
+{
+   LaneGlyphKey key;
+   key.type = static_cast<int>(lane.getType());
+   key.laneHeadPresent = laneHeadPresent && lane.equals(LaneType::MERGE_FORK_L);
+   key.isWip = isWip;
+   key.color = col.rgba();
+   key.activeColor = activeCol.rgba();
+   key.mergeColor = mergeColor.rgba();
+   key.background = background.rgba();
+   key.dpr = p->device()->devicePixelRatioF();
+
+   auto glyph = mLaneGlyphs.constFind(key);
+
+   if (glyph == mLaneGlyphs.constEnd())
+   {
+      if (mLaneGlyphs.count() >= MAX_LANE_GLYPHS)
+         mLaneGlyphs.clear();
+
+      // The strokes of a lane reach into its neighbours, so the glyph is three lanes wide with the lane in the middle.
+      QPixmap pixmap(qCeil(3 * LANE_WIDTH * key.dpr), qCeil(ROW_HEIGHT * key.dpr));
+      pixmap.setDevicePixelRatio(key.dpr);
+      pixmap.fill(Qt::transparent);
+
+      QPainter glyphPainter(&pixmap);
+      glyphPainter.setRenderHints(QPainter::Antialiasing);
+      drawGraphLane(&glyphPainter, lane, key.laneHeadPresent, LANE_WIDTH, 2 * LANE_WIDTH, col, activeCol, mergeColor,
+                    isWip, background);
+      glyphPainter.end();
+
+      glyph = mLaneGlyphs.insert(key, pixmap);
+   }
+
+   p->drawPixmap(x1 - LANE_WIDTH, 0, glyph.value());
+}
+
+void RepositoryViewDelegate::drawGraphLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2,
+                                           const QColor &col, const QColor &activeCol, const QColor &mergeColor,
+                                           bool isWip, const QColor &background)
 {
    const auto padding = 2;
    x1 += padding;
@@ -92,10 +273,9 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
    const auto angleHeightUp = 2 * h;
    const auto angleHeightDown = 2 * -h;
 
-   static QPen lanePen(GitQlientStyles::getTextColor(), 2); // fast path here
+   QPen lanePen(col, 2);
 
    // arc
-   lanePen.setBrush(col);
    p->setPen(lanePen);
 
    switch (lane.getType())
@@ -175,7 +355,7 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
       case LaneType::ACTIVE: {
          isCommit = true;
          p->setPen(QPen(col, 2));
-         p->setBrush(QColor(isWip ? col : GitQlientStyles::getBackgroundColor()));
+         p->setBrush(isWip ? col : background);
          p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
       }
       break;
@@ -210,11 +390,11 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
    }
 }
 
-QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
-                                             const QColor &defaultColor, bool &isSet) const
+QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const QVector<Lane> &lanes, int currentLaneIndex,
+                                             const QColor &defaultColor, const GraphPalette &palette,
+                                             bool &isSet)
 {
-   auto mergeColor
-       = GitQlientStyles::getBranchColorAt((commit.getLanesCount() - 1) % GitQlientStyles::getTotalBranchColors());
+   auto mergeColor = palette.branchColor(lanes.count() - 1);
 
    switch (currentLane.getType())
    {
@@ -231,9 +411,9 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
       case LaneType::JOIN_L:
          for (auto laneCount = 0; laneCount < currentLaneIndex; ++laneCount)
          {
-            if (commit.getLane(laneCount).equals(LaneType::JOIN_L))
+            if (lanes.at(laneCount).equals(LaneType::JOIN_L))
             {
-               mergeColor = GitQlientStyles::getBranchColorAt(laneCount % GitQlientStyles::getTotalBranchColors());
+               mergeColor = palette.branchColor(laneCount);
                isSet = true;
                break;
             }
@@ -246,96 +426,174 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
    return mergeColor;
 }
 
-void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit) const
+void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const QVector<Lane> &lanes,
+                                        bool isWip) const
 {
    p->save();
    p->setClipRect(opt.rect, Qt::IntersectClip);
    p->translate(opt.rect.topLeft());
 
-   if (mView->hasActiveFilter())
+   drawGraph(p, lanes, isWip, graphPalette(),
+             [this](QPainter *painter, const Lane &lane, bool laneHeadPresent, int x1, int x2, const QColor &col,
+                    const QColor &activeCol, const QColor &mergeColor, bool wip, const QColor &background) {
+                paintGraphLane(painter, lane, laneHeadPresent, x1, x2, col, activeCol, mergeColor, wip, background);
+             });
+
+   p->restore();
+}
+
+RepositoryViewDelegate::GraphPalette RepositoryViewDelegate::graphPalette() const
+{
+   GraphPalette palette;
+   palette.branchColors = GitQlientStyles::getBranchColors();
+   palette.background = GitQlientStyles::getBackgroundColor();
+   palette.textColor = GitQlientStyles::getTextColor();
+   palette.pendingLocalChanges = mCache->pendingLocalChanges();
+   palette.maxLanes = mMaxLanes;
+
+   return palette;
+}
+
+void RepositoryViewDelegate::drawGraph(QPainter *p, const QVector<Lane> &lanes, bool isWip,
+                                       const GraphPalette &palette, const LanePainter &paintLane)
+{
+   // While the lanes of a filtered history are calculated, the rows only show the commit.
+   if (lanes.isEmpty())
    {
-      const auto activeColor = GitQlientStyles::getBranchColorAt(0);
-      paintGraphLane(p, LaneType::ACTIVE, false, 0, LANE_WIDTH, activeColor, activeColor, activeColor, false);
+      const auto activeColor = palette.branchColor(0);
+      paintLane(p, LaneType::ACTIVE, false, 0, LANE_WIDTH, activeColor, activeColor, activeColor, false,
+                palette.background);
+      return;
    }
-   else
+
+   const auto laneNum = lanes.count();
+   auto activeLane = -1;
+
+   for (auto i = 0; i < laneNum && activeLane == -1; ++i)
    {
-      const auto laneNum = commit.getLanesCount();
-      const auto activeLane = commit.getActiveLane();
-      const auto activeColor = GitQlientStyles::getBranchColorAt(activeLane % GitQlientStyles::getTotalBranchColors());
-      const auto isWip = commit.sha() == CommitInfo::ZERO_SHA;
-      auto x1 = 0;
-      auto isSet = false;
-      auto laneHeadPresent = false;
-      auto mergeColor = GitQlientStyles::getBranchColorAt((laneNum - 1) % GitQlientStyles::getTotalBranchColors());
-
-      for (auto i = laneNum - 1, x2 = LANE_WIDTH * laneNum; i >= 0; --i, x2 -= LANE_WIDTH)
-      {
-         x1 = x2 - LANE_WIDTH;
+      if (lanes.at(i).isActive())
+         activeLane = i;
+   }
 
-         auto currentLane = commit.getLane(i);
+   const auto activeColor = palette.branchColor(activeLane);
+   auto x1 = 0;
+   auto isSet = false;
+   auto laneHeadPresent = false;
+   auto mergeColor = palette.branchColor(laneNum - 1);
 
-         if (!laneHeadPresent && i < laneNum - 1)
-         {
-            auto prevLane = commit.getLane(i + 1);
-            laneHeadPresent
-                = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
-         }
+   // The lanes beyond the maximum are not painted, but they still decide the merge color of the visible ones.
+   const auto visibleLanes = visibleLanesCount(laneNum, palette.maxLanes);
 
-         if (!currentLane.equals(LaneType::EMPTY))
-         {
-            auto color = activeColor;
+   for (auto i = laneNum - 1, x2 = LANE_WIDTH * laneNum; i >= 0; --i, x2 -= LANE_WIDTH)
+   {
+      x1 = x2 - LANE_WIDTH;
+
+      auto currentLane = lanes.at(i);
 
-            if (i != activeLane)
-               color = GitQlientStyles::getBranchColorAt(i % GitQlientStyles::getTotalBranchColors());
-            else if (isWip && !mCache->pendingLocalChanges())
-               color = QColor("#D89000");
+      if (!laneHeadPresent && i < laneNum - 1)
+      {
+         auto prevLane = lanes.at(i + 1);
+         laneHeadPresent = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
+      }
 
-            if (!isSet)
-               mergeColor = getMergeColor(currentLane, commit, i, color, isSet);
+      if (!currentLane.equals(LaneType::EMPTY))
+      {
+         auto color = activeColor;
 
-            paintGraphLane(p, currentLane, laneHeadPresent, x1, x2, color, activeColor, mergeColor, isWip);
+         if (i != activeLane)
+            color = palette.branchColor(i);
+         else if (isWip && !palette.pendingLocalChanges)
+            color = QColor("#D89000");
 
-            if (mView->hasActiveFilter())
-               break;
-         }
+         if (!isSet)
+            mergeColor = getMergeColor(currentLane, lanes, i, color, palette, isSet);
+
+         if (i >= visibleLanes)
+            continue;
+
+         paintLane(p, currentLane, laneHeadPresent, x1, x2, color, activeColor, mergeColor, isWip, palette.background);
       }
    }
-   p->restore();
+
+   if (visibleLanes < laneNum)
+      paintCollapsedLanes(p, LANE_WIDTH * visibleLanes, activeLane >= visibleLanes, activeColor, palette.textColor);
 }
 
-void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit,
-                                      const QString &text) const
+int RepositoryViewDelegate::visibleLanesCount(int lanes, int maxLanes)
 {
-   const auto sha = commit.sha();
+   return maxLanes > 0 && lanes > maxLanes + 1 ? maxLanes : lanes;
+}
 
-   if (sha.isEmpty())
-      return;
+QImage RepositoryViewDelegate::renderGraphTile(const QVector<QVector<Lane>> &rows, int wipRow,
+                                               const GraphPalette &palette, qreal dpr)
+{
+   auto columns = 1;
 
-   auto offset = 0;
+   for (const auto &lanes : rows)
+   {
+      const auto visibleLanes = visibleLanesCount(lanes.count(), palette.maxLanes);
+      columns = std::max(columns, visibleLanes < lanes.count() ? visibleLanes + 1 : visibleLanes);
+   }
 
-   if (commit.hasReferences() && !mView->hasActiveFilter())
+   // The strokes of the last lane reach into the next one.
+   QImage image(qCeil((columns + 1) * LANE_WIDTH * dpr), qCeil(rows.count() * ROW_HEIGHT * dpr),
+                QImage::Format_ARGB32_Premultiplied);
+   image.setDevicePixelRatio(dpr);
+   image.fill(Qt::transparent);
+
+   QPainter p(&image);
+   p.setRenderHints(QPainter::Antialiasing);
+
+   // The glyphs are pixmaps of the GUI thread, so the lanes are drawn directly like the first time a glyph is cached.
+   for (auto row = 0; row < rows.count(); ++row)
    {
-      offset = 5;
-      paintTagBranch(p, opt, offset, sha);
+      p.save();
+      p.translate(0, row * ROW_HEIGHT);
+      p.setClipRect(QRect(0, 0, (columns + 1) * LANE_WIDTH, ROW_HEIGHT));
+      drawGraph(&p, rows.at(row), row == wipRow, palette, &RepositoryViewDelegate::drawGraphLane);
+      p.restore();
    }
 
-   auto newOpt = opt;
-   newOpt.rect.setX(opt.rect.x() + offset + 5);
+   p.end();
+
+   return image;
+}
+
+void RepositoryViewDelegate::paintCollapsedLanes(QPainter *p, int x1, bool hasCommit, const QColor &commitColor,
+                                                 const QColor &textColor)
+{
+   const auto m = x1 + 2 + LANE_WIDTH / 2;
+   const auto h = ROW_HEIGHT / 2;
+
+   // A dotted line is continuous across the rows, so the collapsed lanes look like one column.
+   p->setPen(QPen(textColor, 2, Qt::DotLine));
+   p->drawLine(m, 0, m, ROW_HEIGHT);
+
+   if (hasCommit)
+   {
+      p->setPen(QPen(commitColor, 2));
+      p->setBrush(commitColor);
+      p->drawEllipse(QPoint(m, h), 4, 4);
+   }
+}
 
-   QFontMetrics fm(newOpt.font);
+void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, const CellRenderData &data) const
+{
+   if (!data.badges.isNull())
+      p->drawPixmap(opt.rect.topLeft(), data.badges);
+
+   auto newOpt = opt;
+   newOpt.rect.setX(opt.rect.x() + data.textOffset);
 
    p->setFont(newOpt.font);
    p->setPen(GitQlientStyles::getTextColor());
-   p->drawText(newOpt.rect, fm.elidedText(text, Qt::ElideRight, newOpt.rect.width()),
-               QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
+   p->drawText(newOpt.rect, data.text, QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
 }
 
-void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewItem o, int &startPoint,
-                                            const QString &sha) const
+QMap<QString, QColor> RepositoryViewDelegate::getReferenceMarks(const CommitView &commit,
+                                                               const QString &currentBranch) const
 {
    QMap<QString, QColor> markValues;
-   const auto currentBranch = mGit->getCurrentBranch();
-   const auto commit = mCache->getCommitInfo(sha);
 
    if ((currentBranch.isEmpty() || currentBranch == "HEAD"))
    {
@@ -360,38 +618,92 @@ void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewI
          markValues.insert(tag, GitQlientStyles::getTagColor());
    }
 
-   const auto showMinimal = o.rect.width() <= MIN_VIEW_WIDTH_PX;
-   const int mark_spacing = 5; // Space between markers in pixels
+   return markValues;
+}
+
+const RepositoryViewDelegate::BadgeStrip *RepositoryViewDelegate::getBadgeStrip(const QStyleOptionViewItem &opt,
+                                                                               const CommitView &commit) const
+{
+   const auto currentBranch = mGit->getCurrentBranch();
+   const auto markValues = getReferenceMarks(commit, currentBranch);
+   const auto showMinimal = opt.rect.width() <= MIN_VIEW_WIDTH_PX;
+   const auto dpr = mView->devicePixelRatioF();
    const auto mapEnd = markValues.constEnd();
 
+   auto key = QString("%1|%2|%3|%4").arg(opt.font.key(), QString::number(dpr), QString::number(showMinimal),
+                                         currentBranch);
+
+   for (auto mapIt = markValues.constBegin(); mapIt != mapEnd; ++mapIt)
+      key.append(QString("\n%1|%2").arg(mapIt.key(), mapIt.value().name()));
+
+   if (const auto cached = mBadgeStrips.object(key))
+      return cached;
+
+   auto font = opt.font;
+   QVector<RefBadge> badges;
+   badges.reserve(markValues.count());
+
+   const auto strip = new BadgeStrip();
+   strip->width = 5;
+
    for (auto mapIt = markValues.constBegin(); mapIt != mapEnd; ++mapIt)
    {
-      const auto isCurrentSpot = mapIt.key() == "detached" || mapIt.key() == currentBranch;
-      o.font.setBold(isCurrentSpot);
+      RefBadge badge;
+      badge.isCurrent = mapIt.key() == "detached" || mapIt.key() == currentBranch;
+      badge.text = showMinimal ? QString(". . .") : mapIt.key();
+      badge.color = mapIt.value();
+
+      font.setBold(badge.isCurrent);
+
+      const auto textBoundingRect = QFontMetrics(font).boundingRect(badge.text);
+      badge.width = textBoundingRect.width() + 2 * BADGE_TEXT_PADDING;
+      badge.textHeight = textBoundingRect.height();
+
+      badges.append(badge);
+      strip->width += badge.width + BADGE_SPACING;
+   }
 
-      const auto nameToDisplay = showMinimal ? QString(". . .") : mapIt.key();
-      QFontMetrics fm(o.font);
-      const auto textBoundingRect = fm.boundingRect(nameToDisplay);
-      const int textPadding = 3;
-      const auto rectWidth = textBoundingRect.width() + 2 * textPadding;
+   strip->pixmap = QPixmap(qCeil(strip->width * dpr), qCeil(ROW_HEIGHT * dpr));
+   strip->pixmap.setDevicePixelRatio(dpr);
+   strip->pixmap.fill(Qt::transparent);
+
+   auto stripOpt = opt;
+   stripOpt.rect = QRect(0, 0, strip->width, ROW_HEIGHT);
+
+   QPainter painter(&strip->pixmap);
+   paintTagBranch(&painter, stripOpt, badges);
+   painter.end();
+
+   mBadgeStrips.insert(key, strip);
+
+   return strip;
+}
+
+void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewItem o,
+                                            const QVector<RefBadge> &badges) const
+{
+   auto startPoint = 5;
+
+   for (const auto &badge : badges)
+   {
+      o.font.setBold(badge.isCurrent);
 
       painter->save();
       painter->setRenderHint(QPainter::Antialiasing);
-      painter->setPen(QPen(mapIt.value(), 2));
+      painter->setPen(QPen(badge.color, 2));
       QPainterPath path;
-      path.addRoundedRect(QRectF(o.rect.x() + startPoint, o.rect.y() + 4, rectWidth, ROW_HEIGHT - 8), 1, 1);
-      painter->fillPath(path, mapIt.value());
+      path.addRoundedRect(QRectF(o.rect.x() + startPoint, o.rect.y() + 4, badge.width, ROW_HEIGHT - 8), 1, 1);
+      painter->fillPath(path, badge.color);
       painter->drawPath(path);
 
       // TODO: Fix this with a nicer way
-      painter->setPen(QColor(mapIt.value() == QColor("#dec3c3") ? QString("#000000") : QString("#FFFFFF")));
+      painter->setPen(QColor(badge.color == QColor("#dec3c3") ? QString("#000000") : QString("#FFFFFF")));
 
-      const auto fontRect = textBoundingRect.height();
-      const auto y = o.rect.y() + ROW_HEIGHT - (ROW_HEIGHT - fontRect) + 2;
+      const auto y = o.rect.y() + ROW_HEIGHT - (ROW_HEIGHT - badge.textHeight) + 2;
       painter->setFont(o.font);
-      painter->drawText(o.rect.x() + startPoint + textPadding, y, nameToDisplay);
+      painter->drawText(o.rect.x() + startPoint + BADGE_TEXT_PADDING, y, badge.text);
       painter->restore();
 
-      startPoint += rectWidth + mark_spacing;
+      startPoint += badge.width + BADGE_SPACING;
    }
 }
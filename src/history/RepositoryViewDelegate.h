@@ -23,13 +23,23 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitQlientStyles.h>
+
 #include <QStyledItemDelegate>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QPixmap>
+
+#include <functional>
 
 class CommitHistoryView;
 class RevisionsCache;
 class GitBase;
 class Lane;
-class CommitInfo;
+class CommitView;
+class GraphTiles;
 
 const int ROW_HEIGHT = 25;
 const int LANE_WIDTH = 3 * ROW_HEIGHT / 4;
@@ -70,28 +80,198 @@ public:
     */
    QSize sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const override;
 
+   /**
+    * @brief Discards the cached lane glyphs and reference badges so they are rendered again with the current style.
+    */
+   void clearLaneGlyphs()
+   {
+      mLaneGlyphs.clear();
+      mBadgeStrips.clear();
+   }
+
+   /**
+    * @brief Discards the text and references prepared for the rows. Called when the model is reset or the rows
+    * change.
+    */
+   void clearRowCache() { mRowCache.clear(); }
+
+   /**
+    * @brief The colors and options the graph is painted with. They are read in the GUI thread since the styles read the
+    * settings, so the tiles can be rendered in a worker.
+    */
+   struct GraphPalette
+   {
+      decltype(GitQlientStyles::getBranchColors()) branchColors;
+      QColor background;
+      QColor textColor;
+      bool pendingLocalChanges = false;
+      int maxLanes = 0;
+
+      QColor branchColor(int index) const
+      {
+         return index >= 0 ? branchColors.at(static_cast<size_t>(index) % branchColors.size()) : QColor();
+      }
+
+      bool operator==(const GraphPalette &other) const
+      {
+         return branchColors == other.branchColors && background == other.background && textColor == other.textColor
+             && pendingLocalChanges == other.pendingLocalChanges && maxLanes == other.maxLanes;
+      }
+      bool operator!=(const GraphPalette &other) const { return !(*this == other); }
+   };
+
+   /**
+    * @brief Renders the graph of consecutive rows in an image, one row under the other. It can run in any thread.
+    *
+    * @param rows The lanes of every row.
+    * @param wipRow The index in @p rows of the WIP commit, or -1 if it's not one of them.
+    * @param palette The colors of the graph.
+    * @param dpr The device pixel ratio of the image.
+    * @return The image, transparent where there are no lanes.
+    */
+   static QImage renderGraphTile(const QVector<QVector<Lane>> &rows, int wipRow, const GraphPalette &palette,
+                                 qreal dpr);
+
+protected:
+   /**
+    * @brief Watches the view to discard the lane glyphs when the style or the screen change.
+    *
+    * @param watched The object that receives the event.
+    * @param event The event.
+    * @return Returns the result of the base class for the editors and false for the view.
+    */
+   bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
+   /**
+    * @brief Identifies a lane glyph: everything that changes the pixels painted for one lane of one row.
+    */
+   struct LaneGlyphKey
+   {
+      int type = 0;
+      bool laneHeadPresent = false;
+      bool isWip = false;
+      QRgb color = 0;
+      QRgb activeColor = 0;
+      QRgb mergeColor = 0;
+      QRgb background = 0;
+      qreal dpr = 1.0;
+
+      bool operator==(const LaneGlyphKey &other) const
+      {
+         return type == other.type && laneHeadPresent == other.laneHeadPresent && isWip == other.isWip
+             && color == other.color && activeColor == other.activeColor && mergeColor == other.mergeColor
+             && background == other.background && qFuzzyCompare(dpr, other.dpr);
+      }
+
+      friend uint qHash(const LaneGlyphKey &key, uint seed = 0)
+      {
+         return qHash(key.color, seed) ^ qHash(key.mergeColor, seed) ^ qHash(key.activeColor ^ key.background, seed)
+             ^ static_cast<uint>(key.type | key.laneHeadPresent << 8 | key.isWip << 9)
+             ^ static_cast<uint>(key.dpr * 4);
+      }
+   };
+
+   /**
+    * @brief A reference painted as a badge in the log column.
+    */
+   struct RefBadge
+   {
+      QString text;
+      QColor color;
+      bool isCurrent = false;
+      int width = 0;
+      int textHeight = 0;
+   };
+
+   /**
+    * @brief What is painted in a cell of a text column, already elided for the width of the column.
+    */
+   struct CellRenderData
+   {
+      QString text;
+      QPixmap badges;
+      int textOffset = 0;
+   };
+
+   /**
+    * @brief The badges of a set of references, painted once in a pixmap that starts at the left of the log column.
+    */
+   struct BadgeStrip
+   {
+      QPixmap pixmap;
+      int width = 0;
+   };
+
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
    CommitHistoryView *mView = nullptr;
    int diffTargetRow = -1;
+   mutable QHash<LaneGlyphKey, QPixmap> mLaneGlyphs;
+   mutable QCache<quint64, CellRenderData> mRowCache;
+   mutable QCache<QString, BadgeStrip> mBadgeStrips;
+   int mMaxLanes = 0;
+   GraphTiles *mGraphTiles = nullptr;
+
+   using LanePainter = std::function<void(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2,
+                                          const QColor &col, const QColor &activeCol, const QColor &mergeColor,
+                                          bool isWip, const QColor &background)>;
+
+   /**
+    * @brief Gets the render data of a cell, preparing it the first time the cell is painted with its current width.
+    *
+    * @param o The style options of the item, with the font of the column.
+    * @param index The index with the item data.
+    * @param row The row of the commit in the cache.
+    * @param commit The commit painted in the row.
+    * @return The render data, owned by the row cache.
+    */
+   const CellRenderData *getCellRenderData(const QStyleOptionViewItem &o, const QModelIndex &index, int row,
+                                           const CommitView &commit) const;
 
    /**
     * @brief Paints the log column. This method is in charge of painting the commit message as well as tags or branches.
     *
     * @param p The painter device.
     * @param o The style options of the item.
-    * @param i The index with the item data.
+    * @param data The render data of the cell.
     */
-   void paintLog(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit, const QString &text) const;
+   void paintLog(QPainter *p, const QStyleOptionViewItem &o, const CellRenderData &data) const;
    /**
     * @brief Method that sets up the configuration to paint the lane for the commit graph representation.
     *
     * @param p The painter device.
     * @param o The style options of the item.
-    * @param index The index with the item data.
+    * @param lanes The lanes of the row. If it's empty only the commit is painted.
+    * @param isWip True if the row is the WIP commit.
+    */
+   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const QVector<Lane> &lanes, bool isWip) const;
+   /**
+    * @brief Reads the colors and options of the graph.
+    *
+    * @return The palette.
+    */
+   GraphPalette graphPalette() const;
+   /**
+    * @brief Draws the lanes of a row with its origin at the top left of the row. It's shared by the rows painted one
+    * by one, with the cached glyphs, and the tiles rendered in the workers.
+    *
+    * @param p The painter device.
+    * @param lanes The lanes of the row. If it's empty only the commit is painted.
+    * @param isWip True if the row is the WIP commit.
+    * @param palette The colors of the graph.
+    * @param paintLane The function that paints every lane.
     */
-   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit) const;
+   static void drawGraph(QPainter *p, const QVector<Lane> &lanes, bool isWip, const GraphPalette &palette,
+                         const LanePainter &paintLane);
+   /**
+    * @brief Returns how many lanes are painted given the maximum set in the settings.
+    *
+    * @param lanes The lanes of the row.
+    * @param maxLanes The maximum, 0 if there is none.
+    * @return The lanes painted. If they are less than @p lanes, there is a column for the collapsed ones after them.
+    */
+   static int visibleLanesCount(int lanes, int maxLanes);
 
    /**
     * @brief Specialization method called by @ref paintGrapth that does the actual lane painting.
@@ -105,20 +285,63 @@ private:
     * @param activeCol Color of the active lane
     * @param mergeColor Color of the lane where the merge comes from in case the commit is a end-merge point.
     * @param isWip Tells the method if it's the WIP commit so it's painted differently.
+    * @param background The background color of the graph, used to fill the circle of the active lane.
     */
    void paintGraphLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, int x2, const QColor &col,
-                       const QColor &activeCol, const QColor &mergeColor, bool isWip = false) const;
+                       const QColor &activeCol, const QColor &mergeColor, bool isWip,
+                       const QColor &background) const;
+
+   /**
+    * @brief Paints the column that summarizes the lanes beyond the maximum number of lanes set in the settings.
+    *
+    * @param p The painter device.
+    * @param x1 X coordinate where the column starts.
+    * @param hasCommit Tells if the commit of the row is in one of the collapsed lanes.
+    * @param commitColor Color of the commit mark when @p hasCommit is true.
+    * @param textColor Color of the column.
+    */
+   static void paintCollapsedLanes(QPainter *p, int x1, bool hasCommit, const QColor &commitColor,
+                                   const QColor &textColor);
+
+   /**
+    * @brief Draws the arcs, lines and circle of a lane. The result is cached in a pixmap by @ref paintGraphLane, so
+    * this is only called the first time a combination of lane type and colors is painted.
+    *
+    * The parameters are the same as the ones of @ref paintGraphLane.
+    */
+   static void drawGraphLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2, const QColor &col,
+                             const QColor &activeCol, const QColor &mergeColor, bool isWip,
+                             const QColor &background);
+
+   /**
+    * @brief Gets the references of a commit that are painted as badges: local branches, remote branches and tags. It
+    * can also be the detached mark.
+    *
+    * @param commit The commit whose references are painted.
+    * @param currentBranch The current branch, painted in bold and with its own color.
+    * @return The name of every reference with its color, in the order they are painted.
+    */
+   QMap<QString, QColor> getReferenceMarks(const CommitView &commit, const QString &currentBranch) const;
+
+   /**
+    * @brief Gets the badges of the references of a commit. They are measured and painted once for every set of
+    * references, font and device pixel ratio and then kept in a cache, so painting them is a blit.
+    *
+    * @param opt The style options of the item.
+    * @param commit The commit whose references are painted.
+    * @return The strip of badges, owned by the cache.
+    */
+   const BadgeStrip *getBadgeStrip(const QStyleOptionViewItem &opt, const CommitView &commit) const;
 
    /**
-    * @brief Specialized method that paints a tag in the commit message column.
+    * @brief Specialized method that paints the reference badges in the commit message column.
     *
     * @param painter The painter device.
     * @param opt The style options of the item.
-    * @param startPoint The starting X coordinate for the tag.
-    * @param sha The SHA reference to paint. It can be local branch, remote branch, tag or it could be detached.
+    * @param badges The badges to paint.
     */
-   void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, int &startPoint, const QString &sha) const;
+   void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, const QVector<RefBadge> &badges) const;
 
-   QColor getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
-                        const QColor &defaultColor, bool &isSet) const;
+   static QColor getMergeColor(const Lane &currentLane, const QVector<Lane> &lanes, int currentLaneIndex,
+                               const QColor &defaultColor, const GraphPalette &palette, bool &isSet);
 };